@@ -0,0 +1,1341 @@
+#include "FrustumCulling.h"
+#include "BoundingVolumeHierarchy.h"
+#include "TransformFeedbackReference.h"
+#include "PixelConversion.h"
+#include "ImageDecoder.h"
+#include "ReferenceRasterizer.h"
+#include "MeshShaderEmulator.h"
+#include "MatrixMath.h"
+#include "ThreadPool.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Checks that the SIMD kernels of the portable CPU modules produce the same results as their scalar kernels,
+// and that the bounding volume hierarchy finds the same objects as the linear culling and a brute-force ray cast.
+// The image decoder is checked against BMP, TGA and DDS files that are built in memory together with their expected pixels.
+// The reference rasterizer is checked against known coverage of the fill rule, the sample patterns and the w <= 0 rejection,
+// and its conservative model against known coverage, inner coverage and invocation ranges.
+// The mesh shader emulator must produce the same outputs on the calling thread and on the thread pool.
+// With --benchmark, it measures the throughput of every supported kernel instead, like the startup benchmarks of the Direct3D 12 tests.
+
+// Not a multiple of the SIMD width or of FRUSTUM_CULLING_CHUNK_SIZE, so the tail loops are checked as well
+static constexpr uint32_t CULLING_TEST_OBJECT_COUNT = 100003U;
+static constexpr uint32_t BVH_TEST_RAY_COUNT = 4096U;
+static constexpr size_t TFB_REFERENCE_TEST_VERTEX_COUNT = 4099U;
+static constexpr uint32_t PIXEL_CONVERSION_TEST_MAX_WIDTH = 80U;
+static constexpr uint32_t PIXEL_CONVERSION_TEST_ROW_COUNT = 5U;
+// More amplification groups than threads, so the mesh groups of several amplification groups run concurrently
+static constexpr uint32_t MESH_EMULATOR_TEST_AMPLIFICATION_GROUP_COUNT = 8U;
+
+// A fixed count, so the parallel paths are checked on machines with a single core as well
+static constexpr uint32_t TEST_THREAD_COUNT = 4U;
+
+static constexpr uint32_t CULLING_BENCHMARK_OBJECT_COUNT = 256U * 1024U;
+static constexpr uint32_t FRUSTUM_CULLING_BENCHMARK_ITERATION_COUNT = 32U;
+static constexpr uint32_t BVH_BENCHMARK_ITERATION_COUNT = 8U;
+static constexpr uint32_t BVH_BENCHMARK_RAY_COUNT = 64U * 1024U;
+static constexpr size_t TFB_REFERENCE_BENCHMARK_VERTEX_COUNT = 1024U * 1024U;
+static constexpr uint32_t TFB_REFERENCE_BENCHMARK_ITERATION_COUNT = 32U;
+static constexpr uint32_t PIXEL_CONVERSION_BENCHMARK_SIZE = 2048U;
+static constexpr uint32_t PIXEL_CONVERSION_BENCHMARK_ITERATION_COUNT = 8U;
+
+static constexpr FrustumCullingKernel s_frustumCullingKernels[] = { FrustumCullingKernel::Scalar, FrustumCullingKernel::SSE, FrustumCullingKernel::AVX2 };
+
+static constexpr TfbReferenceKernel s_tfbReferenceKernels[] = { TfbReferenceKernel::Scalar, TfbReferenceKernel::SSE, TfbReferenceKernel::AVX };
+
+static constexpr PixelConversionKernel s_pixelConversionKernels[] = {
+    PixelConversionKernel::Scalar, PixelConversionKernel::SSE, PixelConversionKernel::AVX2, PixelConversionKernel::NEON
+};
+
+static constexpr PixelConversion s_pixelConversions[] = {
+    PixelConversion::BGR8ToRGBA8, PixelConversion::BGRA8ToRGBA8, PixelConversion::BGRX8ToRGBA8,
+    PixelConversion::RGBA8ToRGBA8, PixelConversion::RGBA16ToRGBA8, PixelConversion::RGBA16ToSRGBA8
+};
+
+static uint32_t s_randomSeed = 0x12345678U;
+
+static auto NextRandom() -> uint32_t
+{
+    s_randomSeed = s_randomSeed * 1664525U + 1013904223U;
+    return s_randomSeed >> 8;
+}
+
+// [0, 1)
+static auto NextRandomFloat() -> float
+{
+    return float(NextRandom()) / float(1U << 24);
+}
+
+// The view transform of ProjectionTest.cpp at its initial position, looking at the boxes around the triangle
+static auto GetTestMVPMatrix(bool orthographic) -> Matrix4x4
+{
+    const float rotateAxis[3] = { 1.0f, 0.0f, 0.0f };
+    const Matrix4x4 rotateMatrix = GetRotationMatrix(GetQuaternionFromAxisAngle(rotateAxis, 30.0f));
+    const Matrix4x4 translateMatrix = GetTranslationMatrix(0.0f, 0.0f, -6.0f);
+    const Matrix4x4 projectionMatrix = orthographic ? GetOrthoMatrix(-1.0f, 1.0f, -1.0f, 1.0f, 1.0f, 9.0f) : GetFrustumMatrix(-1.0f, 1.0f, -1.0f, 1.0f, 1.0f, 9.0f);
+
+    return MultiplyMatrix4x4(rotateMatrix, MultiplyMatrix4x4(translateMatrix, projectionMatrix));
+}
+
+// Random boxes in a cube twice the size of the view volume
+static auto CreateCullingObjects(uint32_t objectCount) -> FrustumCullingObjects
+{
+    FrustumCullingObjects objects;
+    for (uint32_t i = 0U; i < objectCount; ++i)
+    {
+        const float center[3] = { -8.0f + 16.0f * NextRandomFloat(), -8.0f + 16.0f * NextRandomFloat(), -8.0f + 16.0f * NextRandomFloat() };
+        const float halfSize = 0.02f + 0.1f * NextRandomFloat();
+        const float boundsMin[3] = { center[0] - halfSize, center[1] - halfSize, center[2] - halfSize };
+        const float boundsMax[3] = { center[0] + halfSize, center[1] + halfSize, center[2] + halfSize };
+        AddFrustumCullingObject(objects, boundsMin, boundsMax);
+    }
+
+    return objects;
+}
+
+// The camera sits at the origin of the view space. One ray per cell of a square grid on the near plane of glFrustum(-1.0, 1.0, -1.0, 1.0, 1.0, 9.0).
+static auto CreateBvhRays(uint32_t rayCount) -> std::vector<BvhRay>
+{
+    const float rotateAxis[3] = { 1.0f, 0.0f, 0.0f };
+    const Matrix4x4 inverseRotateMatrix = TransposeMatrix4x4(GetRotationMatrix(GetQuaternionFromAxisAngle(rotateAxis, 30.0f)));
+    float eye[4] = { 0.0f, 0.0f, 6.0f, 1.0f };
+    TransformVector(eye, inverseRotateMatrix, eye);
+
+    uint32_t gridSize = 1U;
+    while (gridSize * gridSize < rayCount) {
+        ++gridSize;
+    }
+
+    std::vector<BvhRay> rays(rayCount);
+    for (uint32_t i = 0U; i < rayCount; ++i)
+    {
+        float direction[4] = {
+            -1.0f + 2.0f * (float(i % gridSize) + 0.5f) / float(gridSize),
+            -1.0f + 2.0f * (float(i / gridSize) + 0.5f) / float(gridSize),
+            -1.0f,
+            0.0f
+        };
+        TransformVector(direction, inverseRotateMatrix, direction);
+
+        rays[i] = BvhRay{
+            .origin { eye[0], eye[1], eye[2] },
+            .direction { direction[0], direction[1], direction[2] },
+            .maxDistance = 9.0f
+        };
+    }
+
+    return rays;
+}
+
+// The slab test of BoundingVolumeHierarchy.cpp against every object, so the distances are bit-identical to the ones of IntersectBvhRay
+static auto IntersectObjectsRay(const FrustumCullingObjects& objects, const BvhRay& ray) -> BvhRayHit
+{
+    const float inverseDirection[3] = { 1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2] };
+
+    BvhRayHit hit{ .objectIndex = UINT32_MAX, .distance = ray.maxDistance };
+    for (size_t objectIndex = 0; objectIndex < objects.minX.size(); ++objectIndex)
+    {
+        const float boundsMin[3] = { objects.minX[objectIndex], objects.minY[objectIndex], objects.minZ[objectIndex] };
+        const float boundsMax[3] = { objects.maxX[objectIndex], objects.maxY[objectIndex], objects.maxZ[objectIndex] };
+
+        float entry = 0.0f;
+        float exit = ray.maxDistance;
+        for (int i = 0; i < 3; ++i)
+        {
+            const float t0 = (boundsMin[i] - ray.origin[i]) * inverseDirection[i];
+            const float t1 = (boundsMax[i] - ray.origin[i]) * inverseDirection[i];
+            entry = (std::max)(entry, (std::min)(t0, t1));
+            exit = (std::min)(exit, (std::max)(t0, t1));
+        }
+
+        if (entry <= exit && (entry < hit.distance || hit.objectIndex == UINT32_MAX))
+        {
+            hit.objectIndex = uint32_t(objectIndex);
+            hit.distance = entry;
+        }
+    }
+
+    return hit;
+}
+
+static auto TestFrustumCulling(ThreadPool* threadPool) -> bool
+{
+    const FrustumCullingObjects objects = CreateCullingObjects(CULLING_TEST_OBJECT_COUNT);
+
+    bool success = true;
+    for (const bool orthographic : { false, true })
+    {
+        const FrustumPlanes planes = GetFrustumPlanes(GetTestMVPMatrix(orthographic), false);
+
+        std::vector<uint32_t> scalarVisibleIndices;
+        CullFrustumObjects(FrustumCullingKernel::Scalar, planes, objects, nullptr, scalarVisibleIndices);
+
+        for (const FrustumCullingKernel kernel : s_frustumCullingKernels)
+        {
+            if (!IsFrustumCullingKernelSupported(kernel))
+            {
+                printf("Frustum culling %s kernel: not supported\n", GetFrustumCullingKernelName(kernel));
+                continue;
+            }
+
+            for (ThreadPool* const pool : { (ThreadPool*)nullptr, threadPool })
+            {
+                std::vector<uint32_t> visibleIndices;
+                CullFrustumObjects(kernel, planes, objects, pool, visibleIndices);
+                const bool identical = visibleIndices == scalarVisibleIndices;
+                success = success && identical;
+
+                printf("Frustum culling %s kernel, %s projection, %u thread(s): %zu of %u visible, %s\n", GetFrustumCullingKernelName(kernel),
+                        orthographic ? "orthographic" : "perspective", pool == nullptr ? 1U : GetThreadPoolThreadCount(pool),
+                        visibleIndices.size(), CULLING_TEST_OBJECT_COUNT, identical ? "same as scalar" : "DIFFERS from scalar");
+            }
+        }
+    }
+
+    return success;
+}
+
+static auto TestBvh(ThreadPool* threadPool) -> bool
+{
+    const FrustumCullingObjects objects = CreateCullingObjects(CULLING_TEST_OBJECT_COUNT);
+    const FrustumPlanes planes = GetFrustumPlanes(GetTestMVPMatrix(false), false);
+
+    std::vector<uint32_t> linearVisibleIndices;
+    CullFrustumObjects(FrustumCullingKernel::Scalar, planes, objects, nullptr, linearVisibleIndices);
+
+    const std::vector<BvhRay> rays = CreateBvhRays(BVH_TEST_RAY_COUNT);
+
+    bool success = true;
+    for (ThreadPool* const pool : { (ThreadPool*)nullptr, threadPool })
+    {
+        const Bvh bvh = BuildBvh(objects, pool);
+
+        std::vector<uint32_t> bvhVisibleIndices;
+        CullBvhFrustum(bvh, objects, planes, bvhVisibleIndices);
+        std::sort(bvhVisibleIndices.begin(), bvhVisibleIndices.end());
+        const bool identical = bvhVisibleIndices == linearVisibleIndices;
+
+        // Equally distant boxes may be reported in a different order, so only the distances are compared
+        uint32_t hitCount = 0U;
+        uint32_t rayMismatchCount = 0U;
+        for (const BvhRay& ray : rays)
+        {
+            const BvhRayHit bvhHit = IntersectBvhRay(bvh, objects, ray);
+            const BvhRayHit linearHit = IntersectObjectsRay(objects, ray);
+            hitCount += bvhHit.objectIndex != UINT32_MAX ? 1U : 0U;
+            if ((bvhHit.objectIndex == UINT32_MAX) != (linearHit.objectIndex == UINT32_MAX) || bvhHit.distance != linearHit.distance) {
+                ++rayMismatchCount;
+            }
+        }
+        success = success && identical && rayMismatchCount == 0U;
+
+        printf("BVH built with %u thread(s): %zu nodes, %zu visible, %s, %u of %u rays hit a box, %u ray mismatches\n",
+                pool == nullptr ? 1U : GetThreadPoolThreadCount(pool), bvh.nodes.size(), bvhVisibleIndices.size(),
+                identical ? "same as linear culling" : "DIFFERS from linear culling", hitCount, BVH_TEST_RAY_COUNT, rayMismatchCount);
+    }
+
+    return success;
+}
+
+static auto CreateTfbReferenceVertices(size_t vertexCount) -> std::vector<TfbReferenceVertex>
+{
+    std::vector<TfbReferenceVertex> vertices(vertexCount);
+    for (TfbReferenceVertex& vertex : vertices)
+    {
+        for (float& component : vertex.position) {
+            component = -1.0f + 2.0f * NextRandomFloat();
+        }
+        for (float& component : vertex.color) {
+            component = NextRandomFloat();
+        }
+        vertex.position[3] = 1.0f;
+    }
+
+    return vertices;
+}
+
+static auto TestTfbReference() -> bool
+{
+    const std::vector<TfbReferenceVertex> vertices = CreateTfbReferenceVertices(TFB_REFERENCE_TEST_VERTEX_COUNT);
+    const std::vector<TfbReferenceVertexBlock> src = PackTfbReferenceVertices(vertices.data(), vertices.size());
+
+    bool success = true;
+    for (const float rotAngle : { 0.0f, 30.0f, 217.5f })
+    {
+        std::vector<TfbReferenceVertexBlock> scalarOutput(src.size());
+        TransformTfbReferenceVertices(TfbReferenceKernel::Scalar, rotAngle, src.data(), scalarOutput.data(), src.size());
+
+        for (const TfbReferenceKernel kernel : s_tfbReferenceKernels)
+        {
+            if (!IsTfbReferenceKernelSupported(kernel))
+            {
+                printf("Transform feedback CPU reference %s kernel: not supported\n", GetTfbReferenceKernelName(kernel));
+                continue;
+            }
+
+            std::vector<TfbReferenceVertexBlock> output(src.size());
+            TransformTfbReferenceVertices(kernel, rotAngle, src.data(), output.data(), src.size());
+            const bool identical = memcmp(output.data(), scalarOutput.data(), src.size() * sizeof(TfbReferenceVertexBlock)) == 0;
+            success = success && identical;
+
+            printf("Transform feedback CPU reference %s kernel, %.1f degrees: %s\n", GetTfbReferenceKernelName(kernel), rotAngle,
+                    identical ? "bit-identical to scalar" : "DIFFERS from scalar");
+        }
+    }
+
+    return success;
+}
+
+// Every width up to PIXEL_CONVERSION_TEST_MAX_WIDTH covers the vector loops and their tails.
+// The rows are flipped and the destination is misaligned every other pass, so the streaming stores fall back on some rows.
+static auto TestPixelConversion() -> bool
+{
+    bool success = true;
+    for (const PixelConversion conversion : s_pixelConversions)
+    {
+        const uint32_t sourcePixelSize = GetPixelConversionSourcePixelSize(conversion);
+
+        for (const PixelConversionKernel kernel : s_pixelConversionKernels)
+        {
+            if (kernel == PixelConversionKernel::Scalar) continue;
+
+            if (!IsPixelConversionKernelSupported(kernel))
+            {
+                printf("%s %s kernel: not supported\n", GetPixelConversionName(conversion), GetPixelConversionKernelName(kernel));
+                continue;
+            }
+
+            uint32_t mismatchCount = 0U;
+            for (uint32_t width = 1U; width <= PIXEL_CONVERSION_TEST_MAX_WIDTH; ++width)
+            {
+                const size_t sourceRowStride = size_t(width) * sourcePixelSize;
+                std::vector<uint8_t> source(sourceRowStride * PIXEL_CONVERSION_TEST_ROW_COUNT);
+                for (uint8_t& value : source) {
+                    value = uint8_t(NextRandom());
+                }
+                const uint8_t* const lastSourceRow = source.data() + sourceRowStride * (PIXEL_CONVERSION_TEST_ROW_COUNT - 1U);
+
+                const size_t destinationRowPitch = (size_t(width) * 4U + 255U) & ~size_t(255U);
+                for (const bool premultiplyAlpha : { false, true })
+                {
+                    for (const bool streamingStores : { false, true })
+                    {
+                        for (const size_t destinationOffset : { size_t(0), size_t(4) })
+                        {
+                            std::vector<uint8_t> expected(destinationRowPitch * PIXEL_CONVERSION_TEST_ROW_COUNT + destinationOffset);
+                            std::vector<uint8_t> actual(expected.size());
+
+                            const PixelConversionOptions scalarOptions{ .kernel = PixelConversionKernel::Scalar, .premultiplyAlpha = premultiplyAlpha, .streamingStores = false };
+                            const PixelConversionOptions options{ .kernel = kernel, .premultiplyAlpha = premultiplyAlpha, .streamingStores = streamingStores };
+                            ConvertPixelRows(conversion, scalarOptions, lastSourceRow, -ptrdiff_t(sourceRowStride), expected.data() + destinationOffset,
+                                            destinationRowPitch, width, PIXEL_CONVERSION_TEST_ROW_COUNT);
+                            ConvertPixelRows(conversion, options, lastSourceRow, -ptrdiff_t(sourceRowStride), actual.data() + destinationOffset,
+                                            destinationRowPitch, width, PIXEL_CONVERSION_TEST_ROW_COUNT);
+
+                            if (expected != actual) {
+                                ++mismatchCount;
+                            }
+                        }
+                    }
+                }
+            }
+            success = success && mismatchCount == 0U;
+
+            printf("%s %s kernel: %s\n", GetPixelConversionName(conversion), GetPixelConversionKernelName(kernel),
+                    mismatchCount == 0U ? "same bytes as scalar" : "DIFFERS from scalar");
+        }
+    }
+
+    return success;
+}
+
+// An image file built in memory, and the subresources that DecodeImageSubresource() must write for it,
+// top row first with tightly packed rows, the mip levels of every array slice one after the other
+struct TestImage
+{
+    std::string name;
+    std::vector<uint8_t> file;
+    ImageFileFormat fileFormat;
+    ImagePixelFormat pixelFormat;
+    ImageEncoding encoding;
+    bool sRGB;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipLevelCount;
+    uint32_t arraySize;
+    bool cubeMap;
+    std::vector<std::vector<uint8_t>> subresources;
+};
+
+static auto AppendU16(std::vector<uint8_t>& file, uint32_t value) -> void
+{
+    file.push_back(uint8_t(value));
+    file.push_back(uint8_t(value >> 8));
+}
+
+static auto AppendU32(std::vector<uint8_t>& file, uint32_t value) -> void
+{
+    AppendU16(file, value & 0xffffU);
+    AppendU16(file, value >> 16);
+}
+
+static auto WriteU32(std::vector<uint8_t>& file, size_t offset, uint32_t value) -> void
+{
+    for (uint32_t i = 0U; i < 4U; ++i) {
+        file[offset + i] = uint8_t(value >> (i * 8U));
+    }
+}
+
+// A different byte for every channel of the first pixels of every subresource
+static auto GetTestImageByte(uint32_t x, uint32_t y, uint32_t channel, uint32_t subresource) -> uint8_t
+{
+    return uint8_t(x * 37U + y * 91U + channel * 53U + subresource * 17U + 1U);
+}
+
+// 5 x 3 pixels, so the 8-bit and 24-bit rows are padded. The 8-bit palette indices run past the 12 palette entries.
+static auto CreateTestBmp(uint32_t bitCount, bool topDown) -> TestImage
+{
+    constexpr uint32_t width = 5U, height = 3U, paletteSize = 12U;
+    const uint32_t sourceRowPitch = (width * bitCount + 31U) / 32U * 4U;
+    const uint32_t dataOffset = 14U + 40U + (bitCount == 8U ? paletteSize * 4U : 0U);
+
+    TestImage image{
+        .name = std::string(topDown ? "top-down " : "bottom-up ") + std::to_string(bitCount) + "-bit BMP",
+        .file = { 'B', 'M' }, .fileFormat = ImageFileFormat::BMP,
+        .pixelFormat = ImagePixelFormat::B8G8R8X8,
+        .encoding = bitCount == 8U ? ImageEncoding::Palette8 : (bitCount == 24U ? ImageEncoding::BGR24 : ImageEncoding::Direct),
+        .sRGB = false, .width = width, .height = height, .mipLevelCount = 1U, .arraySize = 1U, .cubeMap = false,
+        .subresources = { std::vector<uint8_t>(width * height * 4U) }
+    };
+
+    std::vector<uint8_t>& file = image.file;
+    AppendU32(file, dataOffset + sourceRowPitch * height);
+    AppendU32(file, 0U);
+    AppendU32(file, dataOffset);
+
+    // BITMAPINFOHEADER with BI_RGB
+    AppendU32(file, 40U);
+    AppendU32(file, width);
+    AppendU32(file, topDown ? 0U - height : height);
+    AppendU16(file, 1U);
+    AppendU16(file, bitCount);
+    for (uint32_t i = 0U; i < 4U; ++i) {
+        AppendU32(file, 0U);
+    }
+    AppendU32(file, bitCount == 8U ? paletteSize : 0U);
+    AppendU32(file, 0U);
+
+    // BGRX palette entries
+    const size_t paletteOffset = file.size();
+    if (bitCount == 8U)
+    {
+        for (uint32_t i = 0U; i < paletteSize; ++i)
+        {
+            for (uint32_t channel = 0U; channel < 3U; ++channel) {
+                file.push_back(GetTestImageByte(i, 0U, channel, 0U));
+            }
+            file.push_back(0U);
+        }
+    }
+
+    file.resize(dataOffset + size_t(sourceRowPitch) * height);
+    for (uint32_t y = 0U; y < height; ++y)
+    {
+        uint8_t* const storedRow = file.data() + dataOffset + size_t(sourceRowPitch) * (topDown ? y : height - 1U - y);
+        for (uint32_t x = 0U; x < width; ++x)
+        {
+            uint8_t* const decoded = image.subresources[0].data() + size_t(y * width + x) * 4U;
+            if (bitCount == 8U)
+            {
+                // Out of range indices are black
+                const uint32_t index = (y * width + x) % (paletteSize + 2U);
+                storedRow[x] = uint8_t(index);
+                for (uint32_t channel = 0U; channel < 3U; ++channel) {
+                    decoded[channel] = index < paletteSize ? file[paletteOffset + index * 4U + channel] : 0U;
+                }
+                decoded[3] = 0xffU;
+            }
+            else
+            {
+                const uint32_t pixelSize = bitCount / 8U;
+                for (uint32_t channel = 0U; channel < pixelSize; ++channel) {
+                    storedRow[x * pixelSize + channel] = decoded[channel] = GetTestImageByte(x, y, channel, 0U);
+                }
+                // The unused fourth byte of 32-bit pixels is copied as it is
+                if (pixelSize == 3U) {
+                    decoded[3] = 0xffU;
+                }
+            }
+        }
+    }
+
+    return image;
+}
+
+// 5 x 3 pixels of 1, 3 or 4 bytes after a 3-byte image ID. The first pixels all differ and the later ones repeat in threes,
+// so the run-length encoding has raw packets, run packets and packets that cross rows.
+static auto CreateTestTga(uint32_t pixelSize, bool runLength, bool topDown) -> TestImage
+{
+    constexpr uint32_t width = 5U, height = 3U, idLength = 3U;
+    const uint32_t decodedPixelSize = pixelSize == 1U ? 1U : 4U;
+
+    TestImage image{
+        .name = std::string(topDown ? "top-down " : "bottom-up ") + (runLength ? "run-length encoded " : "raw ") + std::to_string(pixelSize * 8U) + "-bit TGA",
+        .file = { }, .fileFormat = ImageFileFormat::TGA,
+        .pixelFormat = pixelSize == 1U ? ImagePixelFormat::R8 : (pixelSize == 4U ? ImagePixelFormat::B8G8R8A8 : ImagePixelFormat::B8G8R8X8),
+        .encoding = runLength ? ImageEncoding::RunLength : (pixelSize == 3U ? ImageEncoding::BGR24 : ImageEncoding::Direct),
+        .sRGB = false, .width = width, .height = height, .mipLevelCount = 1U, .arraySize = 1U, .cubeMap = false,
+        .subresources = { std::vector<uint8_t>(width * height * decodedPixelSize) }
+    };
+
+    std::vector<uint8_t>& file = image.file;
+    file.push_back(uint8_t(idLength));
+    file.push_back(0U);
+    file.push_back(uint8_t((pixelSize == 1U ? 3U : 2U) + (runLength ? 8U : 0U)));
+    file.resize(file.size() + 5U + 4U);         // no color map, origin
+    AppendU16(file, width);
+    AppendU16(file, height);
+    file.push_back(uint8_t(pixelSize * 8U));
+    file.push_back(uint8_t((pixelSize == 4U ? 8U : 0U) | (topDown ? 0x20U : 0U)));
+    file.insert(file.end(), { 'I', 'D', '!' });
+
+    // The pixels in storage order
+    std::vector<uint8_t> storedPixels;
+    for (uint32_t storedRow = 0U; storedRow < height; ++storedRow)
+    {
+        const uint32_t y = topDown ? storedRow : height - 1U - storedRow;
+        for (uint32_t x = 0U; x < width; ++x)
+        {
+            const uint32_t index = y * width + x;
+            const uint32_t value = index < 4U ? index + 10U : index / 3U;
+            uint8_t* const decoded = image.subresources[0].data() + size_t(index) * decodedPixelSize;
+            for (uint32_t channel = 0U; channel < pixelSize; ++channel) {
+                storedPixels.push_back(decoded[channel] = GetTestImageByte(value, 0U, channel, 0U));
+            }
+            if (pixelSize == 3U) {
+                decoded[3] = 0xffU;
+            }
+        }
+    }
+
+    if (!runLength)
+    {
+        file.insert(file.end(), storedPixels.begin(), storedPixels.end());
+        return image;
+    }
+
+    const size_t pixelCount = storedPixels.size() / pixelSize;
+    auto const samePixels = [&](size_t a, size_t b) {
+        return memcmp(&storedPixels[a * pixelSize], &storedPixels[b * pixelSize], pixelSize) == 0;
+    };
+    for (size_t i = 0; i < pixelCount; )
+    {
+        size_t count = 1U;
+        if (i + 1U < pixelCount && samePixels(i, i + 1U))
+        {
+            while (i + count < pixelCount && count < 128U && samePixels(i, i + count)) {
+                ++count;
+            }
+            file.push_back(uint8_t(0x80U | (count - 1U)));
+            file.insert(file.end(), storedPixels.begin() + i * pixelSize, storedPixels.begin() + (i + 1U) * pixelSize);
+        }
+        else
+        {
+            while (i + count < pixelCount && count < 128U && !(i + count + 1U < pixelCount && samePixels(i + count, i + count + 1U))) {
+                ++count;
+            }
+            file.push_back(uint8_t(count - 1U));
+            file.insert(file.end(), storedPixels.begin() + i * pixelSize, storedPixels.begin() + (i + count) * pixelSize);
+        }
+        i += count;
+    }
+
+    return image;
+}
+
+// DDS_HEADER with its DDS_PIXELFORMAT
+static auto AppendDDSHeader(std::vector<uint8_t>& file, uint32_t width, uint32_t height, uint32_t mipLevelCount,
+                            uint32_t pixelFormatFlags, uint32_t fourCC, uint32_t bitCount, const uint32_t masks[4], uint32_t caps2) -> void
+{
+    file.insert(file.end(), { 'D', 'D', 'S', ' ' });
+    AppendU32(file, 124U);
+    AppendU32(file, 0x1U | 0x2U | 0x4U | 0x1000U | 0x20000U);     // caps, height, width, pixel format, mip map count
+    AppendU32(file, height);
+    AppendU32(file, width);
+    AppendU32(file, 0U);
+    AppendU32(file, 0U);
+    AppendU32(file, mipLevelCount);
+    file.resize(file.size() + 11U * 4U);
+
+    AppendU32(file, 32U);
+    AppendU32(file, pixelFormatFlags);
+    AppendU32(file, fourCC);
+    AppendU32(file, bitCount);
+    for (uint32_t i = 0U; i < 4U; ++i) {
+        AppendU32(file, masks[i]);
+    }
+
+    AppendU32(file, 0x1000U);
+    AppendU32(file, caps2);
+    file.resize(file.size() + 3U * 4U);
+}
+
+// Appends every subresource with tightly packed rows. BGR24 files store 3 of the 4 decoded bytes of every pixel.
+static auto AppendDDSSubresources(TestImage& image, bool bgr24) -> void
+{
+    ImageInfo info{ };
+    info.pixelFormat = image.pixelFormat;
+    info.width = image.width;
+    info.height = image.height;
+
+    for (uint32_t slice = 0U; slice < image.arraySize; ++slice)
+    {
+        for (uint32_t mip = 0U; mip < image.mipLevelCount; ++mip)
+        {
+            const ImageSubresourceLayout layout = GetImageSubresourceLayout(info, mip);
+            const uint32_t subresource = slice * image.mipLevelCount + mip;
+
+            std::vector<uint8_t> decoded(layout.rowSize * layout.rowCount);
+            for (uint32_t row = 0U; row < layout.rowCount; ++row)
+            {
+                for (uint32_t i = 0U; i < layout.rowSize; ++i)
+                {
+                    uint8_t& value = decoded[layout.rowSize * row + i];
+                    value = bgr24 && i % 4U == 3U ? 0xffU : GetTestImageByte(i / 4U, row, i % 4U, subresource);
+                    if (!bgr24 || i % 4U != 3U) {
+                        image.file.push_back(value);
+                    }
+                }
+            }
+            image.subresources.push_back(decoded);
+        }
+    }
+}
+
+// 6 x 5 pixels with 3 mip levels, stored as 24-bit pixels in a file without the DX10 header
+static auto CreateTestDdsMipChain() -> TestImage
+{
+    TestImage image{
+        .name = "DDS BGR24 with 3 mip levels", .file = { }, .fileFormat = ImageFileFormat::DDS, .pixelFormat = ImagePixelFormat::B8G8R8X8,
+        .encoding = ImageEncoding::BGR24, .sRGB = false, .width = 6U, .height = 5U, .mipLevelCount = 3U, .arraySize = 1U, .cubeMap = false,
+        .subresources = { }
+    };
+    const uint32_t masks[4]{ 0x00ff0000U, 0x0000ff00U, 0x000000ffU, 0U };
+    AppendDDSHeader(image.file, image.width, image.height, image.mipLevelCount, 0x40U, 0U, 24U, masks, 0U);
+    AppendDDSSubresources(image, true);
+    return image;
+}
+
+// 8 x 8 BC1 faces with 2 mip levels, the second of a single block
+static auto CreateTestDdsCubeMap() -> TestImage
+{
+    TestImage image{
+        .name = "DDS BC1 cube map with 2 mip levels", .file = { }, .fileFormat = ImageFileFormat::DDS, .pixelFormat = ImagePixelFormat::BC1,
+        .encoding = ImageEncoding::Direct, .sRGB = false, .width = 8U, .height = 8U, .mipLevelCount = 2U, .arraySize = 6U, .cubeMap = true,
+        .subresources = { }
+    };
+    const uint32_t masks[4]{ };
+    AppendDDSHeader(image.file, image.width, image.height, image.mipLevelCount, 0x4U, uint32_t('D') | uint32_t('X') << 8 | uint32_t('T') << 16 | uint32_t('1') << 24,
+                    0U, masks, 0x200U | 0xfc00U);
+    AppendDDSSubresources(image, false);
+    return image;
+}
+
+// 4 x 2 DXGI_FORMAT_R8G8B8A8_UNORM_SRGB pixels with 3 mip levels in a DX10 array of 3 slices
+static auto CreateTestDdsArray() -> TestImage
+{
+    TestImage image{
+        .name = "DDS DX10 sRGB array of 3 slices with 3 mip levels", .file = { }, .fileFormat = ImageFileFormat::DDS,
+        .pixelFormat = ImagePixelFormat::R8G8B8A8, .encoding = ImageEncoding::Direct, .sRGB = true, .width = 4U, .height = 2U,
+        .mipLevelCount = 3U, .arraySize = 3U, .cubeMap = false, .subresources = { }
+    };
+    const uint32_t masks[4]{ };
+    AppendDDSHeader(image.file, image.width, image.height, image.mipLevelCount, 0x4U, uint32_t('D') | uint32_t('X') << 8 | uint32_t('1') << 16 | uint32_t('0') << 24,
+                    0U, masks, 0U);
+
+    // DDS_HEADER_DXT10
+    AppendU32(image.file, 29U);
+    AppendU32(image.file, 3U);
+    AppendU32(image.file, 0U);
+    AppendU32(image.file, image.arraySize);
+    AppendU32(image.file, 0U);
+
+    AppendDDSSubresources(image, false);
+    return image;
+}
+
+// The R8G8B8A8 pixels that ConvertImageSubresource() must write for decoded B8G8R8X8, B8G8R8A8 or R8G8B8A8 rows
+static auto GetTestImageRGBA8Pixels(ImagePixelFormat pixelFormat, const std::vector<uint8_t>& decoded) -> std::vector<uint8_t>
+{
+    std::vector<uint8_t> pixels(decoded);
+    if (pixelFormat == ImagePixelFormat::R8G8B8A8) return pixels;
+
+    for (size_t i = 0; i < pixels.size(); i += 4U)
+    {
+        std::swap(pixels[i], pixels[i + 2U]);
+        if (pixelFormat == ImagePixelFormat::B8G8R8X8) {
+            pixels[i + 3U] = 0xffU;
+        }
+    }
+    return pixels;
+}
+
+// Parses the header, decodes every subresource into rows with a larger pitch than needed, reads the in-place rows,
+// and converts every subresource to R8G8B8A8 with every supported kernel
+static auto CheckTestImage(const TestImage& image) -> bool
+{
+    ImageInfo info;
+    if (!ParseImageHeader(image.file.data(), image.file.size(), info))
+    {
+        printf("Image decoder, %s: header REJECTED\n", image.name.c_str());
+        return false;
+    }
+
+    bool success = info.fileFormat == image.fileFormat && info.pixelFormat == image.pixelFormat && info.encoding == image.encoding &&
+                    info.sRGB == image.sRGB && info.width == image.width && info.height == image.height &&
+                    info.mipLevelCount == image.mipLevelCount && info.arraySize == image.arraySize && info.cubeMap == image.cubeMap;
+
+    PixelConversion conversion;
+    const bool convertible = GetImageRGBA8Conversion(info, false, conversion);
+
+    uint32_t mismatchCount = 0U;
+    for (uint32_t slice = 0U; slice < info.arraySize; ++slice)
+    {
+        for (uint32_t mip = 0U; mip < info.mipLevelCount; ++mip)
+        {
+            const ImageSubresourceLayout layout = GetImageSubresourceLayout(info, mip);
+            const std::vector<uint8_t>& expected = image.subresources[slice * info.mipLevelCount + mip];
+
+            // The padding at the end of every row must stay untouched
+            const size_t rowPitch = layout.rowSize + 8U;
+            std::vector<uint8_t> decoded(rowPitch * layout.rowCount, 0xcdU);
+            bool decodedAsExpected = DecodeImageSubresource(info, image.file.data(), mip, slice, decoded.data(), rowPitch);
+            for (uint32_t row = 0U; row < layout.rowCount && decodedAsExpected; ++row)
+            {
+                decodedAsExpected = memcmp(decoded.data() + rowPitch * row, expected.data() + layout.rowSize * row, layout.rowSize) == 0 &&
+                                    std::all_of(decoded.begin() + rowPitch * row + layout.rowSize, decoded.begin() + rowPitch * (row + 1U),
+                                                [](uint8_t value) { return value == 0xcdU; });
+            }
+            mismatchCount += decodedAsExpected ? 0U : 1U;
+
+            ImageRowSpan rows;
+            if (GetImageSubresourceRows(info, image.file.data(), mip, slice, rows) != (info.encoding == ImageEncoding::Direct)) {
+                ++mismatchCount;
+            }
+            else if (info.encoding == ImageEncoding::Direct)
+            {
+                for (uint32_t row = 0U; row < rows.rowCount; ++row)
+                {
+                    if (rows.rowCount != layout.rowCount || rows.rowSize != layout.rowSize ||
+                        memcmp(rows.firstRow + rows.rowStride * ptrdiff_t(row), expected.data() + layout.rowSize * row, layout.rowSize) != 0)
+                    {
+                        ++mismatchCount;
+                        break;
+                    }
+                }
+            }
+
+            if (!convertible) continue;
+
+            const std::vector<uint8_t> expectedPixels = GetTestImageRGBA8Pixels(info.pixelFormat, expected);
+            for (const PixelConversionKernel kernel : s_pixelConversionKernels)
+            {
+                if (!IsPixelConversionKernelSupported(kernel)) continue;
+
+                const PixelConversionOptions options{ .kernel = kernel, .premultiplyAlpha = false, .streamingStores = false };
+                std::vector<uint8_t> pixels(expectedPixels.size());
+                if (!ConvertImageSubresource(info, image.file.data(), mip, slice, conversion, options, pixels.data(), size_t(layout.width) * 4U) ||
+                    pixels != expectedPixels)
+                {
+                    ++mismatchCount;
+                }
+            }
+        }
+    }
+
+    // Subresources that do not exist and too small row pitches
+    const ImageSubresourceLayout firstLayout = GetImageSubresourceLayout(info, 0U);
+    std::vector<uint8_t> destination(firstLayout.rowSize * firstLayout.rowCount);
+    if (DecodeImageSubresource(info, image.file.data(), info.mipLevelCount, 0U, destination.data(), firstLayout.rowSize) ||
+        DecodeImageSubresource(info, image.file.data(), 0U, info.arraySize, destination.data(), firstLayout.rowSize) ||
+        DecodeImageSubresource(info, image.file.data(), 0U, 0U, destination.data(), firstLayout.rowSize - 1U))
+    {
+        ++mismatchCount;
+    }
+    success = success && mismatchCount == 0U;
+
+    printf("Image decoder, %s: %s %ux%u, %u mip level(s), %u slice(s), %u mismatched subresource reads, %s\n", image.name.c_str(),
+            GetImagePixelFormatName(info.pixelFormat), info.width, info.height, info.mipLevelCount, info.arraySize, mismatchCount,
+            success ? "as expected" : "MISMATCH");
+    return success;
+}
+
+static auto TestImageDecoder() -> bool
+{
+    std::vector<TestImage> images;
+    for (const uint32_t bitCount : { 8U, 24U, 32U })
+    {
+        for (const bool topDown : { false, true }) {
+            images.push_back(CreateTestBmp(bitCount, topDown));
+        }
+    }
+    for (const uint32_t pixelSize : { 1U, 3U, 4U })
+    {
+        for (const bool runLength : { false, true })
+        {
+            for (const bool topDown : { false, true }) {
+                images.push_back(CreateTestTga(pixelSize, runLength, topDown));
+            }
+        }
+    }
+    images.push_back(CreateTestDdsMipChain());
+    images.push_back(CreateTestDdsCubeMap());
+    images.push_back(CreateTestDdsArray());
+
+    bool success = true;
+    for (const TestImage& image : images) {
+        success = CheckTestImage(image) && success;
+    }
+
+    // The header of a run-length encoded file only tells where the packets start, so cutting them short fails in the decoder.
+    // The top-down 32-bit file ends with a run packet of 5 bytes, the bottom-up one with a raw packet of 6 pixels.
+    struct TruncatedImage
+    {
+        bool topDown;
+        size_t removedSize;
+        const char* name;
+    };
+    static constexpr TruncatedImage truncatedImages[]{
+        { true, 1U, "run-length encoded TGA cut inside a run packet" },
+        { true, 5U, "run-length encoded TGA without its last packet" },
+        { false, 1U, "run-length encoded TGA cut inside a raw packet" }
+    };
+    for (const TruncatedImage& truncatedImage : truncatedImages)
+    {
+        TestImage image = CreateTestTga(4U, true, truncatedImage.topDown);
+        image.file.resize(image.file.size() - truncatedImage.removedSize);
+
+        ImageInfo info;
+        std::vector<uint8_t> destination(image.subresources[0].size());
+        const PixelConversionOptions options{ .kernel = PixelConversionKernel::Scalar, .premultiplyAlpha = false, .streamingStores = false };
+        const bool rejected = ParseImageHeader(image.file.data(), image.file.size(), info) &&
+                                !DecodeImageSubresource(info, image.file.data(), 0U, 0U, destination.data(), size_t(info.width) * 4U) &&
+                                !ConvertImageSubresource(info, image.file.data(), 0U, 0U, PixelConversion::BGRA8ToRGBA8, options, destination.data(), size_t(info.width) * 4U);
+        success = success && rejected;
+
+        printf("Image decoder, %s: %s\n", truncatedImage.name, rejected ? "rejected" : "NOT REJECTED");
+    }
+
+    return success;
+}
+
+// Files that ParseImageHeader() must reject, each made from a valid test image with one field broken
+static auto TestImageHeaderRejects() -> bool
+{
+    struct RejectedImage
+    {
+        const char* name;
+        std::vector<uint8_t> file;
+    };
+    std::vector<RejectedImage> rejectedImages;
+
+    auto const addRejected = [&rejectedImages](const char* name, const TestImage& image, auto modify) {
+        rejectedImages.push_back(RejectedImage{ .name = name, .file = image.file });
+        modify(rejectedImages.back().file);
+    };
+
+    const TestImage bmp8 = CreateTestBmp(8U, false);
+    const TestImage bmp32 = CreateTestBmp(32U, false);
+    addRejected("BMP without its last byte", bmp32, [](std::vector<uint8_t>& file) { file.pop_back(); });
+    addRejected("16-bit BMP", bmp32, [](std::vector<uint8_t>& file) { file[28] = 16U; });
+    addRejected("BMP with a width of 0", bmp32, [](std::vector<uint8_t>& file) { WriteU32(file, 18U, 0U); });
+    addRejected("BMP with a height of INT32_MIN", bmp32, [](std::vector<uint8_t>& file) { WriteU32(file, 22U, 0x80000000U); });
+    addRejected("BMP wider than 65536 pixels", bmp32, [](std::vector<uint8_t>& file) { WriteU32(file, 18U, 65537U); });
+    addRejected("run-length encoded BMP", bmp8, [](std::vector<uint8_t>& file) { WriteU32(file, 30U, 1U); });
+    addRejected("8-bit BMP with 300 palette entries", bmp8, [](std::vector<uint8_t>& file) { WriteU32(file, 46U, 300U); });
+    addRejected("32-bit BMP with 10-bit bit field masks", bmp32, [](std::vector<uint8_t>& file) {
+        WriteU32(file, 30U, 3U);
+        WriteU32(file, 54U, 0x3ff00000U);
+        WriteU32(file, 58U, 0x000ffc00U);
+        WriteU32(file, 62U, 0x000003ffU);
+    });
+
+    const TestImage tga24 = CreateTestTga(3U, false, false);
+    const TestImage tga32RunLength = CreateTestTga(4U, true, true);
+    addRejected("TGA without its last byte", tga24, [](std::vector<uint8_t>& file) { file.pop_back(); });
+    addRejected("color-mapped TGA", tga24, [](std::vector<uint8_t>& file) { file[2] = 1U; });
+    addRejected("right-to-left TGA", tga24, [](std::vector<uint8_t>& file) { file[17] |= 0x10U; });
+    addRejected("16-bit TGA", tga24, [](std::vector<uint8_t>& file) { file[16] = 16U; });
+    addRejected("24-bit TGA with 8 alpha bits", tga24, [](std::vector<uint8_t>& file) { file[17] |= 8U; });
+    addRejected("TGA with a height of 0", tga24, [](std::vector<uint8_t>& file) { file[14] = file[15] = 0U; });
+    addRejected("run-length encoded TGA without packets", tga32RunLength, [](std::vector<uint8_t>& file) { file.resize(18U + 3U); });
+
+    const TestImage ddsMipChain = CreateTestDdsMipChain();
+    const TestImage ddsCubeMap = CreateTestDdsCubeMap();
+    const TestImage ddsArray = CreateTestDdsArray();
+    addRejected("DDS without its last byte", ddsArray, [](std::vector<uint8_t>& file) { file.pop_back(); });
+    addRejected("DDS with a header size of 100", ddsMipChain, [](std::vector<uint8_t>& file) { WriteU32(file, 4U, 100U); });
+    addRejected("DDS volume texture", ddsMipChain, [](std::vector<uint8_t>& file) { WriteU32(file, 112U, 0x200000U); });
+    addRejected("DDS with more mip levels than a full chain", ddsMipChain, [](std::vector<uint8_t>& file) { WriteU32(file, 28U, 4U); });
+    addRejected("16-bit DDS", ddsMipChain, [](std::vector<uint8_t>& file) { WriteU32(file, 88U, 16U); });
+    addRejected("DDS cube map without its -Z face", ddsCubeMap, [](std::vector<uint8_t>& file) { WriteU32(file, 112U, 0x200U | 0x7c00U); });
+    addRejected("DX10 DDS with an array size of 0", ddsArray, [](std::vector<uint8_t>& file) { WriteU32(file, 128U + 12U, 0U); });
+    addRejected("DX10 DDS 3D texture", ddsArray, [](std::vector<uint8_t>& file) { WriteU32(file, 128U + 4U, 4U); });
+    addRejected("DX10 DDS in DXGI_FORMAT_R32G32B32A32_TYPELESS", ddsArray, [](std::vector<uint8_t>& file) { WriteU32(file, 128U, 1U); });
+    addRejected("DX10 DDS without its DX10 header", ddsArray, [](std::vector<uint8_t>& file) { file.resize(128U + 19U); });
+
+    bool success = true;
+    for (const RejectedImage& image : rejectedImages)
+    {
+        ImageInfo info;
+        const bool rejected = !ParseImageHeader(image.file.data(), image.file.size(), info) && info.fileFormat == ImageFileFormat::Unknown;
+        success = success && rejected;
+
+        printf("Image header, %s: %s\n", image.name, rejected ? "rejected" : "NOT REJECTED");
+    }
+
+    ImageInfo info;
+    const uint8_t emptyFile[1]{ };
+    if (ParseImageHeader(nullptr, 0U, info) || ParseImageHeader(emptyFile, 0U, info))
+    {
+        printf("Image header, empty file: NOT REJECTED\n");
+        success = false;
+    }
+
+    return success;
+}
+
+// The reference rasterizer is checked on a square viewport with vertices given in pixel coordinates,
+// so that the edges pass exactly through pixel centers and sample positions
+static constexpr uint32_t REFERENCE_RASTER_TEST_SIZE = 16U;
+
+static constexpr ReferenceRasterViewport s_referenceRasterTestViewport{
+    .topLeftX = 0.0f,
+    .topLeftY = 0.0f,
+    .width = float(REFERENCE_RASTER_TEST_SIZE),
+    .height = float(REFERENCE_RASTER_TEST_SIZE),
+    .minDepth = 0.0f,
+    .maxDepth = 1.0f
+};
+
+static auto AppendReferenceRasterVertex(std::vector<float>& positions, float x, float y, float w) -> void
+{
+    const float halfSize = float(REFERENCE_RASTER_TEST_SIZE) * 0.5f;
+    positions.push_back((x / halfSize - 1.0f) * w);
+    positions.push_back((1.0f - y / halfSize) * w);
+    positions.push_back(0.5f * w);
+    positions.push_back(w);
+}
+
+// Draws the triangle list without depth test into a new target
+static auto DrawReferenceRasterTestTriangles(const std::vector<float>& positions, uint32_t sampleCount) -> ReferenceRasterTarget
+{
+    const ReferenceRasterState state{
+        .sampleCount = sampleCount,
+        .depthClipEnable = true,
+        .depthEnable = false,
+        .depthWriteEnable = false
+    };
+
+    ReferenceRasterTarget target = CreateReferenceRasterTarget(REFERENCE_RASTER_TEST_SIZE, REFERENCE_RASTER_TEST_SIZE, sampleCount, 1.0f);
+    ReferenceRasterDrawTriangleList(target, s_referenceRasterTestViewport, state, positions.data(), 4U * sizeof(float), uint32_t(positions.size() / 4U), 0);
+    return target;
+}
+
+// Counts the pixels whose coverage differs from `expectedCoverage`, which returns the expected coverage count of pixel (x, y)
+template <typename ExpectedCoverage>
+static auto CountReferenceRasterCoverageMismatches(const ReferenceRasterTarget& target, ExpectedCoverage expectedCoverage) -> uint32_t
+{
+    uint32_t mismatchCount = 0U;
+    for (uint32_t y = 0U; y < target.height; ++y)
+    {
+        for (uint32_t x = 0U; x < target.width; ++x)
+        {
+            if (target.coverageCount[y * target.width + x] != expectedCoverage(x, y)) {
+                ++mismatchCount;
+            }
+        }
+    }
+    return mismatchCount;
+}
+
+static auto TestReferenceRasterizer() -> bool
+{
+    bool success = true;
+
+    // Top-left rule: the edges of the square [4.5, 12.5) x [4.5, 12.5) pass through pixel centers.
+    // The left and top edges own them, the right and bottom edges do not, so exactly 8 x 8 pixels are covered.
+    {
+        std::vector<float> positions;
+        AppendReferenceRasterVertex(positions, 4.5f, 4.5f, 1.0f);
+        AppendReferenceRasterVertex(positions, 12.5f, 4.5f, 1.0f);
+        AppendReferenceRasterVertex(positions, 12.5f, 12.5f, 1.0f);
+        AppendReferenceRasterVertex(positions, 4.5f, 4.5f, 1.0f);
+        AppendReferenceRasterVertex(positions, 12.5f, 12.5f, 1.0f);
+        AppendReferenceRasterVertex(positions, 4.5f, 12.5f, 1.0f);
+
+        const ReferenceRasterTarget target = DrawReferenceRasterTestTriangles(positions, 1U);
+        const uint32_t mismatchCount = CountReferenceRasterCoverageMismatches(target, [](uint32_t x, uint32_t y) {
+            return x >= 4U && x < 12U && y >= 4U && y < 12U ? 1U : 0U;
+        });
+        const bool passed = mismatchCount == 0U && target.invocationCount == 64U;
+        success = success && passed;
+
+        printf("Reference rasterizer, top-left rule: %llu invocations, %u pixel(s) with another coverage, %s\n", (unsigned long long)target.invocationCount,
+                mismatchCount, passed ? "matched" : "MISMATCHED");
+    }
+
+    // Shared edges: a fan of 4 triangles around the pixel center (8.5, 8.5) covers the same square.
+    // Every pixel center on a shared edge, and the shared vertex itself, belongs to exactly one triangle.
+    {
+        const float corners[][2] = { { 4.5f, 4.5f }, { 12.5f, 4.5f }, { 12.5f, 12.5f }, { 4.5f, 12.5f } };
+        std::vector<float> positions;
+        for (size_t i = 0; i < std::size(corners); ++i)
+        {
+            const float* nextCorner = corners[(i + 1U) % std::size(corners)];
+            AppendReferenceRasterVertex(positions, 8.5f, 8.5f, 1.0f);
+            AppendReferenceRasterVertex(positions, corners[i][0], corners[i][1], 1.0f);
+            AppendReferenceRasterVertex(positions, nextCorner[0], nextCorner[1], 1.0f);
+        }
+
+        const ReferenceRasterTarget target = DrawReferenceRasterTestTriangles(positions, 1U);
+        const uint32_t mismatchCount = CountReferenceRasterCoverageMismatches(target, [](uint32_t x, uint32_t y) {
+            return x >= 4U && x < 12U && y >= 4U && y < 12U ? 1U : 0U;
+        });
+        const bool passed = mismatchCount == 0U && target.invocationCount == 64U;
+        success = success && passed;
+
+        printf("Reference rasterizer, shared edges: %llu invocations, %u pixel(s) with another coverage, %s\n", (unsigned long long)target.invocationCount,
+                mismatchCount, passed ? "matched" : "MISMATCHED");
+    }
+
+    // Sample patterns: the D3D12 standard 4x pattern, then a vertical edge through the pixel centers of column 8.
+    // In that column, exactly the samples left of the center are covered.
+    {
+        static constexpr int8_t standardPattern4x[4][2] = { { -2, -6 }, { 6, -2 }, { -6, 2 }, { 2, 6 } };
+        const int8_t(*const samplePositions4x)[2] = GetReferenceRasterSamplePositions(4U);
+        bool patternMatched = true;
+        for (uint32_t s = 0U; s < 4U; ++s) {
+            patternMatched = patternMatched && samplePositions4x[s][0] == standardPattern4x[s][0] && samplePositions4x[s][1] == standardPattern4x[s][1];
+        }
+        success = success && patternMatched;
+
+        printf("Reference rasterizer, 4x sample pattern: %s\n", patternMatched ? "standard" : "NOT STANDARD");
+
+        std::vector<float> positions;
+        AppendReferenceRasterVertex(positions, 8.5f, -16.0f, 1.0f);
+        AppendReferenceRasterVertex(positions, 8.5f, 32.0f, 1.0f);
+        AppendReferenceRasterVertex(positions, -24.0f, 8.0f, 1.0f);
+
+        for (const uint32_t sampleCount : { 2U, 4U, 8U })
+        {
+            const ReferenceRasterTarget target = DrawReferenceRasterTestTriangles(positions, sampleCount);
+            const int8_t(*const samplePositions)[2] = GetReferenceRasterSamplePositions(sampleCount);
+
+            uint32_t mismatchCount = 0U;
+            for (uint32_t y = 4U; y < 12U; ++y)
+            {
+                for (uint32_t x = 7U; x <= 9U; ++x)
+                {
+                    for (uint32_t s = 0U; s < sampleCount; ++s)
+                    {
+                        const bool expected = x < 8U || (x == 8U && samplePositions[s][0] < 0);
+                        const bool covered = target.primitiveIDs[(y * REFERENCE_RASTER_TEST_SIZE + x) * sampleCount + s] >= 0;
+                        if (covered != expected) {
+                            ++mismatchCount;
+                        }
+                    }
+                }
+            }
+            success = success && mismatchCount == 0U;
+
+            printf("Reference rasterizer, %ux MSAA edge through pixel centers: %u sample(s) with another coverage, %s\n", sampleCount,
+                    mismatchCount, mismatchCount == 0U ? "matched" : "MISMATCHED");
+        }
+    }
+
+    // Triangles with a vertex at w <= 0 are rejected, while the next triangle of the same draw is still rasterized
+    {
+        std::vector<float> positions;
+        AppendReferenceRasterVertex(positions, -16.0f, -16.0f, 1.0f);
+        AppendReferenceRasterVertex(positions, 32.0f, -16.0f, 0.0f);
+        AppendReferenceRasterVertex(positions, 8.0f, 32.0f, 1.0f);
+        AppendReferenceRasterVertex(positions, -16.0f, -16.0f, 1.0f);
+        AppendReferenceRasterVertex(positions, 32.0f, -16.0f, 1.0f);
+        AppendReferenceRasterVertex(positions, 8.0f, 32.0f, -1.0f);
+        AppendReferenceRasterVertex(positions, 4.5f, 4.5f, 1.0f);
+        AppendReferenceRasterVertex(positions, 12.5f, 4.5f, 1.0f);
+        AppendReferenceRasterVertex(positions, 4.5f, 12.5f, 1.0f);
+
+        const ReferenceRasterTarget target = DrawReferenceRasterTestTriangles(positions, 1U);
+        uint32_t mismatchCount = 0U;
+        for (uint32_t pixelIndex = 0U; pixelIndex < REFERENCE_RASTER_TEST_SIZE * REFERENCE_RASTER_TEST_SIZE; ++pixelIndex)
+        {
+            const int32_t primitiveID = target.primitiveIDs[pixelIndex];
+            if (primitiveID != -1 && primitiveID != 2) {
+                ++mismatchCount;
+            }
+        }
+        // The remaining triangle covers the upper left half of the square, 8 + 7 + ... + 1 pixels
+        const bool passed = mismatchCount == 0U && target.invocationCount == 36U;
+        success = success && passed;
+
+        printf("Reference rasterizer, w <= 0: %llu invocations, %u pixel(s) covered by a rejected triangle, %s\n",
+                (unsigned long long)target.invocationCount, mismatchCount, passed ? "rejected" : "NOT REJECTED");
+    }
+
+    return success;
+}
+
+// Known answers of the conservative rasterization model, on the same viewport as TestReferenceRasterizer()
+static auto TestReferenceConservativeRasterizer() -> bool
+{
+    bool success = true;
+
+    // A degenerate triangle on the horizontal line y = 8.5 from x = 4.5 to x = 11.5: tier 1 culls it,
+    // tier 2 keeps it as a segment that touches the 8 pixels (4, 8) to (11, 8)
+    {
+        std::vector<float> positions;
+        AppendReferenceRasterVertex(positions, 4.5f, 8.5f, 1.0f);
+        AppendReferenceRasterVertex(positions, 8.0f, 8.5f, 1.0f);
+        AppendReferenceRasterVertex(positions, 11.5f, 8.5f, 1.0f);
+
+        for (const uint32_t tier : { 1U, 2U })
+        {
+            const ReferenceConservativeRasterResult result = ReferenceRasterConservativeTriangleList(REFERENCE_RASTER_TEST_SIZE, REFERENCE_RASTER_TEST_SIZE,
+                                                                    s_referenceRasterTestViewport, tier, positions.data(), 4U * sizeof(float), 3U);
+
+            uint32_t mismatchCount = 0U;
+            for (uint32_t y = 0U; y < REFERENCE_RASTER_TEST_SIZE; ++y)
+            {
+                for (uint32_t x = 0U; x < REFERENCE_RASTER_TEST_SIZE; ++x)
+                {
+                    const uint32_t expected = tier >= 2U && y == 8U && x >= 4U && x < 12U ? 1U : 0U;
+                    const size_t pixelIndex = size_t(y) * REFERENCE_RASTER_TEST_SIZE + x;
+                    if (result.coverageCount[pixelIndex] != expected || result.uncertainCount[pixelIndex] != 0U || result.innerCoverageCount[pixelIndex] != 0U) {
+                        ++mismatchCount;
+                    }
+                }
+            }
+            const uint64_t expectedInvocationCount = tier >= 2U ? 8U : 0U;
+            const bool passed = mismatchCount == 0U && result.minInvocationCount == expectedInvocationCount && result.maxInvocationCount == expectedInvocationCount;
+            success = success && passed;
+
+            printf("Conservative rasterizer, degenerate triangle at tier %u: %s, %llu invocations, %u pixel(s) with another coverage, %s\n", tier,
+                    result.maxInvocationCount == 0U ? "culled" : "kept", (unsigned long long)result.maxInvocationCount, mismatchCount, passed ? "matched" : "MISMATCHED");
+        }
+    }
+
+    // The triangle (2, 2), (14, 2), (2, 14) at tier 3. The pixels (x, y) with x, y >= 2 overlap it for x + y <= 15
+    // and lie fully inside it for x + y <= 14. Within the uncertainty region, the pixels with x, y in [1, 14] and x + y <= 16 may be invoked too.
+    {
+        std::vector<float> positions;
+        AppendReferenceRasterVertex(positions, 2.0f, 2.0f, 1.0f);
+        AppendReferenceRasterVertex(positions, 14.0f, 2.0f, 1.0f);
+        AppendReferenceRasterVertex(positions, 2.0f, 14.0f, 1.0f);
+
+        const ReferenceConservativeRasterResult result = ReferenceRasterConservativeTriangleList(REFERENCE_RASTER_TEST_SIZE, REFERENCE_RASTER_TEST_SIZE,
+                                                                s_referenceRasterTestViewport, 3U, positions.data(), 4U * sizeof(float), 3U);
+
+        uint32_t mismatchCount = 0U;
+        for (uint32_t y = 0U; y < REFERENCE_RASTER_TEST_SIZE; ++y)
+        {
+            for (uint32_t x = 0U; x < REFERENCE_RASTER_TEST_SIZE; ++x)
+            {
+                const bool covered = x >= 2U && y >= 2U && x + y <= 15U;
+                const bool inner = x >= 2U && y >= 2U && x + y <= 14U;
+                const bool uncertain = !covered && x >= 1U && y >= 1U && x <= 14U && y <= 14U && x + y <= 16U;
+                const size_t pixelIndex = size_t(y) * REFERENCE_RASTER_TEST_SIZE + x;
+                if (result.coverageCount[pixelIndex] != (covered ? 1U : 0U) || result.innerCoverageCount[pixelIndex] != (inner ? 1U : 0U) ||
+                    result.uncertainCount[pixelIndex] != (uncertain ? 1U : 0U)) {
+                    ++mismatchCount;
+                }
+            }
+        }
+        const bool passed = mismatchCount == 0U && result.minInvocationCount == 78U && result.maxInvocationCount == 118U && result.innerInvocationCount == 66U;
+        success = success && passed;
+
+        printf("Conservative rasterizer, triangle at tier 3: %llu to %llu invocations, %llu inner, %u pixel(s) with another coverage, %s\n",
+                (unsigned long long)result.minInvocationCount, (unsigned long long)result.maxInvocationCount, (unsigned long long)result.innerInvocationCount,
+                mismatchCount, passed ? "matched" : "MISMATCHED");
+    }
+
+    return success;
+}
+
+// The port of ms.amplification.hlsl and ms.mesh.hlsl on the calling thread and on the thread pool.
+// Every amplification group launches 4 mesh groups of 256 vertices and 254 triangles with the 1x1 shading rate.
+static auto TestMeshShaderEmulator(ThreadPool* threadPool) -> bool
+{
+    const MeshEmulatorPipelineDesc desc = CreateAmplificationMeshShaderPort();
+    const MeshEmulatorResult singleThreadResult = EmulateDispatchMesh(desc, nullptr, MESH_EMULATOR_TEST_AMPLIFICATION_GROUP_COUNT, 1U, 1U);
+
+    bool success = true;
+    for (ThreadPool* const pool : { (ThreadPool*)nullptr, threadPool })
+    {
+        const MeshEmulatorResult result = pool == nullptr ? singleThreadResult : EmulateDispatchMesh(desc, pool, MESH_EMULATOR_TEST_AMPLIFICATION_GROUP_COUNT, 1U, 1U);
+
+        uint32_t sizeMismatchCount = 0U;
+        uint32_t outputMismatchCount = 0U;
+        for (size_t i = 0; i < result.meshGroups.size(); ++i)
+        {
+            const MeshEmulatorGroupOutput& output = result.meshGroups[i];
+            const bool sizesMatched = output.vertexCount == 256U && output.primitiveCount == 254U && output.vertices.size() == 256U * 2U * 4U &&
+                                    output.indices.size() == 254U * 3U && output.primitiveAttributes.size() == 254U &&
+                                    std::all_of(output.primitiveAttributes.begin(), output.primitiveAttributes.end(), [](uint32_t shadingRate) { return shadingRate == 0U; });
+            if (!sizesMatched) {
+                ++sizeMismatchCount;
+            }
+
+            const MeshEmulatorGroupOutput& expected = singleThreadResult.meshGroups[i];
+            if (output.amplificationGroupIndex != expected.amplificationGroupIndex || !std::equal(output.groupID, output.groupID + 3, expected.groupID) ||
+                output.vertices != expected.vertices || output.indices != expected.indices || output.primitiveAttributes != expected.primitiveAttributes) {
+                ++outputMismatchCount;
+            }
+        }
+
+        const uint32_t meshGroupCount = MESH_EMULATOR_TEST_AMPLIFICATION_GROUP_COUNT * 4U;
+        const bool passed = result.errorCount == 0U && result.amplificationGroupCount == MESH_EMULATOR_TEST_AMPLIFICATION_GROUP_COUNT &&
+                            result.meshGroups.size() == meshGroupCount && result.vertexCount == meshGroupCount * 256U &&
+                            result.primitiveCount == meshGroupCount * 254U && sizeMismatchCount == 0U && outputMismatchCount == 0U;
+        success = success && passed;
+
+        printf("Mesh shader emulator, %u thread(s): %zu mesh groups, %llu vertices, %llu primitives, %u error(s), %u group(s) with unexpected sizes, %s\n",
+                pool == nullptr ? 1U : GetThreadPoolThreadCount(pool), result.meshGroups.size(), (unsigned long long)result.vertexCount,
+                (unsigned long long)result.primitiveCount, result.errorCount, sizeMismatchCount,
+                outputMismatchCount == 0U ? "same as single-threaded" : "DIFFERS from single-threaded");
+    }
+
+    return success;
+}
+
+static auto RunFrustumCullingBenchmark(ThreadPool* threadPool) -> void
+{
+    const FrustumCullingObjects objects = CreateCullingObjects(CULLING_BENCHMARK_OBJECT_COUNT);
+    const FrustumPlanes planes = GetFrustumPlanes(GetTestMVPMatrix(false), false);
+
+    for (const FrustumCullingKernel kernel : s_frustumCullingKernels)
+    {
+        if (!IsFrustumCullingKernelSupported(kernel)) continue;
+
+        for (ThreadPool* const pool : { (ThreadPool*)nullptr, threadPool })
+        {
+            const double objectsPerMillisecond = MeasureFrustumCullingThroughput(kernel, planes, objects, pool, FRUSTUM_CULLING_BENCHMARK_ITERATION_COUNT);
+            printf("Frustum culling %s kernel, %u thread(s): %.0f objects/ms\n", GetFrustumCullingKernelName(kernel),
+                    pool == nullptr ? 1U : GetThreadPoolThreadCount(pool), objectsPerMillisecond);
+        }
+    }
+}
+
+static auto RunBvhBenchmark(ThreadPool* threadPool) -> void
+{
+    const FrustumCullingObjects objects = CreateCullingObjects(CULLING_BENCHMARK_OBJECT_COUNT);
+    const FrustumPlanes planes = GetFrustumPlanes(GetTestMVPMatrix(false), false);
+    const std::vector<BvhRay> rays = CreateBvhRays(BVH_BENCHMARK_RAY_COUNT);
+
+    for (ThreadPool* const pool : { (ThreadPool*)nullptr, threadPool })
+    {
+        const BvhThroughput throughput = MeasureBvhThroughput(objects, planes, rays, pool, BVH_BENCHMARK_ITERATION_COUNT);
+        printf("BVH %u thread(s): build %.0f objects/ms, refit %.0f objects/ms, frustum culling %.0f objects/ms, %.0f rays/ms\n",
+                pool == nullptr ? 1U : GetThreadPoolThreadCount(pool), throughput.buildObjectsPerMillisecond, throughput.refitObjectsPerMillisecond,
+                throughput.cullObjectsPerMillisecond, throughput.raysPerMillisecond);
+    }
+}
+
+static auto RunTfbReferenceBenchmark() -> void
+{
+    const std::vector<TfbReferenceVertex> vertices = CreateTfbReferenceVertices(TFB_REFERENCE_BENCHMARK_VERTEX_COUNT);
+
+    for (const TfbReferenceKernel kernel : s_tfbReferenceKernels)
+    {
+        if (!IsTfbReferenceKernelSupported(kernel)) continue;
+
+        const double verticesPerSecond = MeasureTfbReferenceThroughput(kernel, vertices.data(), vertices.size(), TFB_REFERENCE_BENCHMARK_ITERATION_COUNT);
+        printf("Transform feedback CPU reference %s kernel: %.1f M vertices/s, %.2f GB/s\n", GetTfbReferenceKernelName(kernel),
+                verticesPerSecond / 1.0e6, verticesPerSecond * 2.0 * sizeof(TfbReferenceVertex) / (1024.0 * 1024.0 * 1024.0));
+    }
+}
+
+static auto RunPixelConversionBenchmark() -> void
+{
+    for (const PixelConversion conversion : s_pixelConversions)
+    {
+        for (const PixelConversionKernel kernel : s_pixelConversionKernels)
+        {
+            if (!IsPixelConversionKernelSupported(kernel)) continue;
+
+            for (const bool streamingStores : { false, true })
+            {
+                const PixelConversionOptions options{ .kernel = kernel, .premultiplyAlpha = false, .streamingStores = streamingStores };
+                const double megabytesPerSecond = MeasurePixelConversionThroughput(conversion, options, PIXEL_CONVERSION_BENCHMARK_SIZE,
+                                                                                    PIXEL_CONVERSION_BENCHMARK_SIZE, PIXEL_CONVERSION_BENCHMARK_ITERATION_COUNT);
+                printf("%s %s kernel%s: %.0f MB/s\n", GetPixelConversionName(conversion), GetPixelConversionKernelName(kernel),
+                        streamingStores ? ", streaming stores" : "", megabytesPerSecond);
+            }
+        }
+    }
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    const bool benchmark = argc > 1 && strcmp(argv[1], "--benchmark") == 0;
+
+    ThreadPool* threadPool = CreateThreadPool(benchmark ? 0U : TEST_THREAD_COUNT);
+
+    bool success = true;
+    if (benchmark)
+    {
+        RunFrustumCullingBenchmark(threadPool);
+        RunBvhBenchmark(threadPool);
+        RunTfbReferenceBenchmark();
+        RunPixelConversionBenchmark();
+    }
+    else
+    {
+        if (!TestFrustumCulling(threadPool)) {
+            fprintf(stderr, "Frustum culling test failed!\n");
+            success = false;
+        }
+        if (!TestBvh(threadPool)) {
+            fprintf(stderr, "BVH test failed!\n");
+            success = false;
+        }
+        if (!TestTfbReference()) {
+            fprintf(stderr, "Transform feedback CPU reference test failed!\n");
+            success = false;
+        }
+        if (!TestPixelConversion()) {
+            fprintf(stderr, "Pixel conversion test failed!\n");
+            success = false;
+        }
+        if (!TestImageDecoder()) {
+            fprintf(stderr, "Image decoder test failed!\n");
+            success = false;
+        }
+        if (!TestImageHeaderRejects()) {
+            fprintf(stderr, "Image header reject test failed!\n");
+            success = false;
+        }
+        if (!TestReferenceRasterizer()) {
+            fprintf(stderr, "Reference rasterizer test failed!\n");
+            success = false;
+        }
+        if (!TestReferenceConservativeRasterizer()) {
+            fprintf(stderr, "Conservative rasterizer test failed!\n");
+            success = false;
+        }
+        if (!TestMeshShaderEmulator(threadPool)) {
+            fprintf(stderr, "Mesh shader emulator test failed!\n");
+            success = false;
+        }
+    }
+
+    DestroyThreadPool(threadPool);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,511 @@
+#include "BoundingVolumeHierarchy.h"
+
+#include <cmath>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+// BVH_MAX_SAH_DEPTH + log2(UINT32_MAX) levels at most
+static constexpr uint32_t BVH_TRAVERSAL_STACK_SIZE = 128U;
+
+struct BvhBounds
+{
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+static auto GetEmptyBounds() -> BvhBounds
+{
+    constexpr float maxValue = std::numeric_limits<float>::max();
+    return BvhBounds{ .boundsMin { maxValue, maxValue, maxValue }, .boundsMax { -maxValue, -maxValue, -maxValue } };
+}
+
+static auto GrowBounds(BvhBounds& bounds, const float boundsMin[3], const float boundsMax[3]) -> void
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        // Written so that compilers emit minss and maxss instead of branches, which mispredict on unsorted bounds
+        bounds.boundsMin[i] = boundsMin[i] < bounds.boundsMin[i] ? boundsMin[i] : bounds.boundsMin[i];
+        bounds.boundsMax[i] = boundsMax[i] > bounds.boundsMax[i] ? boundsMax[i] : bounds.boundsMax[i];
+    }
+}
+
+// Half of the surface area, which is all the heuristic needs
+static auto GetHalfArea(const BvhBounds& bounds) -> float
+{
+    const float dx = bounds.boundsMax[0] - bounds.boundsMin[0];
+    const float dy = bounds.boundsMax[1] - bounds.boundsMin[1];
+    const float dz = bounds.boundsMax[2] - bounds.boundsMin[2];
+    return dx * dy + dy * dz + dz * dx;
+}
+
+struct BvhBuildTask
+{
+    uint32_t first;
+    uint32_t count;
+    uint32_t nodeIndex;
+    uint32_t depth;
+};
+
+// The bounds are copied next to the object index, so the build reads and partitions one contiguous array
+// instead of gathering from the structure of arrays
+struct BvhBuildPrimitive
+{
+    BvhBounds bounds;
+    float centroid[3];      // doubled, min + max
+    uint32_t objectIndex;
+};
+
+// A subtree of n objects needs at most 2n - 1 nodes. The subtree of the primitives [first, first + n)
+// owns the node slots [nodeIndex, nodeIndex + 2n - 1): the first child gets the slots right after its parent
+// and the second child the slots after those of the first one. So disjoint subtrees can be built in parallel,
+// and the unused slots are squeezed out afterwards without changing the depth-first order.
+struct BvhBuildContext
+{
+    std::vector<BvhBuildPrimitive> primitives;
+    std::vector<BvhNode> nodes;
+    uint32_t parallelDepth;                 // UINT32_MAX for a serial build
+};
+
+static auto BuildBvhNode(BvhBuildContext& context, const BvhBuildTask& task, std::vector<BvhBuildTask>* parallelTasks) -> void
+{
+    if (parallelTasks != nullptr && task.depth == context.parallelDepth)
+    {
+        parallelTasks->push_back(task);
+        return;
+    }
+
+    BvhBuildPrimitive* const primitives = &context.primitives[task.first];
+
+    BvhBounds bounds = GetEmptyBounds();
+    BvhBounds centroidBounds = GetEmptyBounds();
+    for (uint32_t i = 0U; i < task.count; ++i)
+    {
+        GrowBounds(bounds, primitives[i].bounds.boundsMin, primitives[i].bounds.boundsMax);
+        GrowBounds(centroidBounds, primitives[i].centroid, primitives[i].centroid);
+    }
+
+    BvhNode& node = context.nodes[task.nodeIndex];
+    std::copy(bounds.boundsMin, bounds.boundsMin + 3, node.boundsMin);
+    std::copy(bounds.boundsMax, bounds.boundsMax + 3, node.boundsMax);
+
+    // Bin the centroids along all 3 axes in one pass, then find the cheapest split between two bins
+    int bestAxis = -1;
+    uint32_t bestBin = 0U;
+    float bestCost = std::numeric_limits<float>::max();
+
+    // Small nodes get one bin per object at most, which keeps the sweeps cheap near the leaves
+    const uint32_t binCount = (std::min)(task.count, BVH_BIN_COUNT);
+    float binScales[3]{ };
+    auto const getBin = [&centroidBounds, &binScales, binCount](const BvhBuildPrimitive& primitive, int axis) -> uint32_t {
+        return (std::min)(uint32_t((primitive.centroid[axis] - centroidBounds.boundsMin[axis]) * binScales[axis]), binCount - 1U);
+    };
+
+    if (task.count > 1U && task.depth < BVH_MAX_SAH_DEPTH)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float extent = centroidBounds.boundsMax[axis] - centroidBounds.boundsMin[axis];
+            binScales[axis] = extent > 0.0f ? float(binCount) / extent : 0.0f;
+        }
+
+        BvhBounds binBounds[3][BVH_BIN_COUNT];
+        uint32_t binCounts[3][BVH_BIN_COUNT]{ };
+        for (int axis = 0; axis < 3; ++axis) {
+            std::fill(binBounds[axis], binBounds[axis] + binCount, GetEmptyBounds());
+        }
+
+        for (uint32_t i = 0U; i < task.count; ++i)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const uint32_t bin = getBin(primitives[i], axis);
+                GrowBounds(binBounds[axis][bin], primitives[i].bounds.boundsMin, primitives[i].bounds.boundsMax);
+                ++binCounts[axis][bin];
+            }
+        }
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            // All the centroids are in one bin
+            if (binScales[axis] == 0.0f) continue;
+
+            // Sweep from the right to get the cost of the right side of every split
+            float rightCosts[BVH_BIN_COUNT]{ };
+            BvhBounds rightBounds = GetEmptyBounds();
+            uint32_t rightCount = 0U;
+            for (uint32_t bin = binCount - 1U; bin > 0U; --bin)
+            {
+                GrowBounds(rightBounds, binBounds[axis][bin].boundsMin, binBounds[axis][bin].boundsMax);
+                rightCount += binCounts[axis][bin];
+                rightCosts[bin - 1U] = rightCount == 0U ? 0.0f : GetHalfArea(rightBounds) * float(rightCount);
+            }
+
+            // Split after bin
+            BvhBounds leftBounds = GetEmptyBounds();
+            uint32_t leftCount = 0U;
+            for (uint32_t bin = 0U; bin + 1U < binCount; ++bin)
+            {
+                GrowBounds(leftBounds, binBounds[axis][bin].boundsMin, binBounds[axis][bin].boundsMax);
+                leftCount += binCounts[axis][bin];
+                if (leftCount == 0U || leftCount == task.count) continue;
+
+                const float cost = GetHalfArea(leftBounds) * float(leftCount) + rightCosts[bin];
+                if (cost < bestCost)
+                {
+                    bestAxis = axis;
+                    bestBin = bin;
+                    bestCost = cost;
+                }
+            }
+        }
+    }
+
+    // A traversal step costs as much as a box test
+    const float nodeArea = GetHalfArea(bounds);
+    const bool splitPays = bestAxis >= 0 && nodeArea + bestCost < nodeArea * float(task.count);
+    if (task.count <= 1U || (task.count <= BVH_MAX_LEAF_SIZE && !splitPays))
+    {
+        node.offset = task.first;
+        node.objectCount = task.count;
+        return;
+    }
+
+    uint32_t leftCount = task.count / 2U;
+    if (bestAxis >= 0)
+    {
+        BvhBuildPrimitive* const middle = std::partition(primitives, primitives + task.count, [&getBin, bestAxis, bestBin](const BvhBuildPrimitive& primitive) {
+            return getBin(primitive, bestAxis) <= bestBin;
+        });
+        leftCount = uint32_t(middle - primitives);
+    }
+    else
+    {
+        // Too deep or all the centroids coincide: split at the object median along the longest axis
+        int axis = 0;
+        for (int i = 1; i < 3; ++i)
+        {
+            if (centroidBounds.boundsMax[i] - centroidBounds.boundsMin[i] > centroidBounds.boundsMax[axis] - centroidBounds.boundsMin[axis]) {
+                axis = i;
+            }
+        }
+
+        std::nth_element(primitives, primitives + leftCount, primitives + task.count, [axis](const BvhBuildPrimitive& a, const BvhBuildPrimitive& b) {
+            return a.centroid[axis] < b.centroid[axis];
+        });
+    }
+
+    node.offset = task.nodeIndex + 2U * leftCount;
+    node.objectCount = 0U;
+
+    BuildBvhNode(context, BvhBuildTask{ .first = task.first, .count = leftCount, .nodeIndex = task.nodeIndex + 1U, .depth = task.depth + 1U }, parallelTasks);
+    BuildBvhNode(context, BvhBuildTask{ .first = task.first + leftCount, .count = task.count - leftCount, .nodeIndex = node.offset, .depth = task.depth + 1U },
+                parallelTasks);
+}
+
+// Copies the nodes reachable from nodeIndex depth-first into compactNodes
+// @return the index of the node in compactNodes
+static auto CompactBvhNodes(const std::vector<BvhNode>& nodes, uint32_t nodeIndex, std::vector<BvhNode>& compactNodes) -> uint32_t
+{
+    const uint32_t compactIndex = uint32_t(compactNodes.size());
+    compactNodes.push_back(nodes[nodeIndex]);
+
+    if (nodes[nodeIndex].objectCount == 0U)
+    {
+        CompactBvhNodes(nodes, nodeIndex + 1U, compactNodes);
+        const uint32_t secondChild = CompactBvhNodes(nodes, nodes[nodeIndex].offset, compactNodes);
+        compactNodes[compactIndex].offset = secondChild;
+    }
+    return compactIndex;
+}
+
+auto BuildBvh(const FrustumCullingObjects& objects, ThreadPool* threadPool) -> Bvh
+{
+    const uint32_t objectCount = uint32_t(objects.minX.size());
+    if (objectCount == 0U) return Bvh{ };
+
+    BvhBuildContext context{ };
+    context.primitives.resize(objectCount);
+    for (uint32_t i = 0U; i < objectCount; ++i)
+    {
+        context.primitives[i] = BvhBuildPrimitive{
+            .bounds {
+                .boundsMin { objects.minX[i], objects.minY[i], objects.minZ[i] },
+                .boundsMax { objects.maxX[i], objects.maxY[i], objects.maxZ[i] }
+            },
+            .centroid { objects.minX[i] + objects.maxX[i], objects.minY[i] + objects.maxY[i], objects.minZ[i] + objects.maxZ[i] },
+            .objectIndex = i
+        };
+    }
+
+    context.nodes.resize(size_t(objectCount) * 2U - 1U);
+
+    const BvhBuildTask rootTask{ .first = 0U, .count = objectCount, .nodeIndex = 0U, .depth = 0U };
+
+    // About 4 subtrees per thread, so that unbalanced splits still keep every thread busy
+    const uint32_t threadCount = threadPool == nullptr ? 1U : GetThreadPoolThreadCount(threadPool);
+    if (threadCount > 1U && objectCount > FRUSTUM_CULLING_CHUNK_SIZE)
+    {
+        context.parallelDepth = 0U;
+        while ((1U << context.parallelDepth) < threadCount * 4U) {
+            ++context.parallelDepth;
+        }
+
+        std::vector<BvhBuildTask> parallelTasks;
+        BuildBvhNode(context, rootTask, &parallelTasks);
+        ThreadPoolParallelFor(threadPool, uint32_t(parallelTasks.size()), [&context, &parallelTasks](uint32_t taskIndex) {
+            BuildBvhNode(context, parallelTasks[taskIndex], nullptr);
+        });
+    }
+    else
+    {
+        context.parallelDepth = UINT32_MAX;
+        BuildBvhNode(context, rootTask, nullptr);
+    }
+
+    Bvh bvh;
+    bvh.nodes.reserve(context.nodes.size());
+    CompactBvhNodes(context.nodes, 0U, bvh.nodes);
+    bvh.nodes.shrink_to_fit();
+
+    bvh.objectIndices.resize(objectCount);
+    for (uint32_t i = 0U; i < objectCount; ++i) {
+        bvh.objectIndices[i] = context.primitives[i].objectIndex;
+    }
+    return bvh;
+}
+
+auto RefitBvh(Bvh& bvh, const FrustumCullingObjects& objects) -> void
+{
+    // Children always follow their parent, so a reverse sweep visits them first
+    for (size_t nodeIndex = bvh.nodes.size(); nodeIndex-- > 0;)
+    {
+        BvhNode& node = bvh.nodes[nodeIndex];
+        BvhBounds bounds = GetEmptyBounds();
+
+        if (node.objectCount == 0U)
+        {
+            const BvhNode& firstChild = bvh.nodes[nodeIndex + 1U];
+            const BvhNode& secondChild = bvh.nodes[node.offset];
+            GrowBounds(bounds, firstChild.boundsMin, firstChild.boundsMax);
+            GrowBounds(bounds, secondChild.boundsMin, secondChild.boundsMax);
+        }
+        else
+        {
+            for (uint32_t i = 0U; i < node.objectCount; ++i)
+            {
+                const uint32_t objectIndex = bvh.objectIndices[node.offset + i];
+                const float boundsMin[3] = { objects.minX[objectIndex], objects.minY[objectIndex], objects.minZ[objectIndex] };
+                const float boundsMax[3] = { objects.maxX[objectIndex], objects.maxY[objectIndex], objects.maxZ[objectIndex] };
+                GrowBounds(bounds, boundsMin, boundsMax);
+            }
+        }
+
+        std::copy(bounds.boundsMin, bounds.boundsMin + 3, node.boundsMin);
+        std::copy(bounds.boundsMax, bounds.boundsMax + 3, node.boundsMax);
+    }
+}
+
+auto CullBvhFrustum(const Bvh& bvh, const FrustumCullingObjects& objects, const FrustumPlanes& planes, std::vector<uint32_t>& visibleIndices) -> void
+{
+    visibleIndices.clear();
+    if (bvh.nodes.empty()) return;
+
+    // The same test as the kernels of FrustumCulling: the corner farthest along the plane normal decides
+    auto const getFarthestDistance = [](const float plane[4], const float boundsMin[3], const float boundsMax[3]) -> float {
+        const float x = plane[0] >= 0.0f ? boundsMax[0] : boundsMin[0];
+        const float y = plane[1] >= 0.0f ? boundsMax[1] : boundsMin[1];
+        const float z = plane[2] >= 0.0f ? boundsMax[2] : boundsMin[2];
+        return plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+    };
+    auto const getNearestDistance = [](const float plane[4], const float boundsMin[3], const float boundsMax[3]) -> float {
+        const float x = plane[0] >= 0.0f ? boundsMin[0] : boundsMax[0];
+        const float y = plane[1] >= 0.0f ? boundsMin[1] : boundsMax[1];
+        const float z = plane[2] >= 0.0f ? boundsMin[2] : boundsMax[2];
+        return plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+    };
+
+    // Bit p of the plane mask is set while plane p still has to be tested
+    std::pair<uint32_t, uint32_t> stack[BVH_TRAVERSAL_STACK_SIZE];
+    uint32_t stackSize = 0U;
+    stack[stackSize++] = { 0U, 0x3fU };
+
+    while (stackSize > 0U)
+    {
+        const auto [nodeIndex, parentPlaneMask] = stack[--stackSize];
+        const BvhNode& node = bvh.nodes[nodeIndex];
+
+        uint32_t planeMask = parentPlaneMask;
+        bool outside = false;
+        for (uint32_t p = 0U; p < 6U && !outside; ++p)
+        {
+            if ((planeMask & (1U << p)) == 0U) continue;
+
+            outside = getFarthestDistance(planes.planes[p], node.boundsMin, node.boundsMax) < 0.0f;
+            if (getNearestDistance(planes.planes[p], node.boundsMin, node.boundsMax) >= 0.0f) {
+                planeMask &= ~(1U << p);
+            }
+        }
+        if (outside) continue;
+
+        if (node.objectCount == 0U)
+        {
+            stack[stackSize++] = { node.offset, planeMask };
+            stack[stackSize++] = { nodeIndex + 1U, planeMask };
+            continue;
+        }
+
+        for (uint32_t i = 0U; i < node.objectCount; ++i)
+        {
+            const uint32_t objectIndex = bvh.objectIndices[node.offset + i];
+            const float boundsMin[3] = { objects.minX[objectIndex], objects.minY[objectIndex], objects.minZ[objectIndex] };
+            const float boundsMax[3] = { objects.maxX[objectIndex], objects.maxY[objectIndex], objects.maxZ[objectIndex] };
+
+            bool objectOutside = false;
+            for (uint32_t p = 0U; p < 6U; ++p)
+            {
+                if ((planeMask & (1U << p)) != 0U) {
+                    objectOutside |= getFarthestDistance(planes.planes[p], boundsMin, boundsMax) < 0.0f;
+                }
+            }
+            if (!objectOutside) {
+                visibleIndices.push_back(objectIndex);
+            }
+        }
+    }
+}
+
+// Slab test. A zero direction component gives infinite reciprocals, which works unless the origin lies exactly on a slab plane.
+// @return the entry distance, or infinity if the box is missed within maxDistance
+static auto IntersectRayBounds(const float origin[3], const float inverseDirection[3], float maxDistance, const float boundsMin[3], const float boundsMax[3]) -> float
+{
+    float entry = 0.0f;
+    float exit = maxDistance;
+    for (int i = 0; i < 3; ++i)
+    {
+        const float t0 = (boundsMin[i] - origin[i]) * inverseDirection[i];
+        const float t1 = (boundsMax[i] - origin[i]) * inverseDirection[i];
+        entry = (std::max)(entry, (std::min)(t0, t1));
+        exit = (std::min)(exit, (std::max)(t0, t1));
+    }
+    return entry <= exit ? entry : std::numeric_limits<float>::infinity();
+}
+
+auto IntersectBvhRay(const Bvh& bvh, const FrustumCullingObjects& objects, const BvhRay& ray) -> BvhRayHit
+{
+    BvhRayHit hit{ .objectIndex = UINT32_MAX, .distance = ray.maxDistance };
+    if (bvh.nodes.empty()) return hit;
+
+    const float inverseDirection[3] = { 1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2] };
+
+    if (IntersectRayBounds(ray.origin, inverseDirection, hit.distance, bvh.nodes[0].boundsMin, bvh.nodes[0].boundsMax) > hit.distance) return hit;
+
+    // Node indices with their entry distances
+    std::pair<uint32_t, float> stack[BVH_TRAVERSAL_STACK_SIZE];
+    uint32_t stackSize = 0U;
+    stack[stackSize++] = { 0U, 0.0f };
+
+    while (stackSize > 0U)
+    {
+        const auto [nodeIndex, entry] = stack[--stackSize];
+        if (entry > hit.distance) continue;     // a nearer hit was found after the node had been pushed
+
+        const BvhNode& node = bvh.nodes[nodeIndex];
+        if (node.objectCount == 0U)
+        {
+            // Visit the nearer child first
+            const BvhNode& firstChild = bvh.nodes[nodeIndex + 1U];
+            const BvhNode& secondChild = bvh.nodes[node.offset];
+            std::pair<uint32_t, float> nearChild{ nodeIndex + 1U, IntersectRayBounds(ray.origin, inverseDirection, hit.distance, firstChild.boundsMin, firstChild.boundsMax) };
+            std::pair<uint32_t, float> farChild{ node.offset, IntersectRayBounds(ray.origin, inverseDirection, hit.distance, secondChild.boundsMin, secondChild.boundsMax) };
+            if (farChild.second < nearChild.second) {
+                std::swap(nearChild, farChild);
+            }
+
+            if (farChild.second <= hit.distance) {
+                stack[stackSize++] = farChild;
+            }
+            if (nearChild.second <= hit.distance) {
+                stack[stackSize++] = nearChild;
+            }
+            continue;
+        }
+
+        for (uint32_t i = 0U; i < node.objectCount; ++i)
+        {
+            const uint32_t objectIndex = bvh.objectIndices[node.offset + i];
+            const float boundsMin[3] = { objects.minX[objectIndex], objects.minY[objectIndex], objects.minZ[objectIndex] };
+            const float boundsMax[3] = { objects.maxX[objectIndex], objects.maxY[objectIndex], objects.maxZ[objectIndex] };
+
+            const float distance = IntersectRayBounds(ray.origin, inverseDirection, hit.distance, boundsMin, boundsMax);
+            if (distance < hit.distance || (distance == hit.distance && hit.objectIndex == UINT32_MAX))
+            {
+                hit.objectIndex = objectIndex;
+                hit.distance = distance;
+            }
+        }
+    }
+
+    return hit;
+}
+
+auto MeasureBvhThroughput(const FrustumCullingObjects& objects, const FrustumPlanes& planes, const std::vector<BvhRay>& rays,
+                        ThreadPool* threadPool, uint32_t iterationCount) -> BvhThroughput
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    const double objectCount = double(objects.minX.size()) * iterationCount;
+    auto const perMillisecond = [](double count, const Milliseconds& milliseconds) -> double {
+        return milliseconds.count() > 0.0 ? count / milliseconds.count() : 0.0;
+    };
+
+    BvhThroughput throughput{ };
+
+    // Warm up the caches and the allocator
+    Bvh bvh = BuildBvh(objects, threadPool);
+
+    auto beginTime = std::chrono::steady_clock::now();
+    for (uint32_t i = 0U; i < iterationCount; ++i) {
+        bvh = BuildBvh(objects, threadPool);
+    }
+    throughput.buildObjectsPerMillisecond = perMillisecond(objectCount, std::chrono::steady_clock::now() - beginTime);
+
+    beginTime = std::chrono::steady_clock::now();
+    for (uint32_t i = 0U; i < iterationCount; ++i) {
+        RefitBvh(bvh, objects);
+    }
+    throughput.refitObjectsPerMillisecond = perMillisecond(objectCount, std::chrono::steady_clock::now() - beginTime);
+
+    std::vector<uint32_t> visibleIndices;
+    CullBvhFrustum(bvh, objects, planes, visibleIndices);
+
+    beginTime = std::chrono::steady_clock::now();
+    for (uint32_t i = 0U; i < iterationCount; ++i) {
+        CullBvhFrustum(bvh, objects, planes, visibleIndices);
+    }
+    throughput.cullObjectsPerMillisecond = perMillisecond(objectCount, std::chrono::steady_clock::now() - beginTime);
+
+    // Rays are independent, so they are spread over the thread pool
+    const uint32_t rayCount = uint32_t(rays.size());
+    const uint32_t rayTaskCount = (rayCount + 1023U) / 1024U;
+    std::vector<uint32_t> taskHitCounts(rayTaskCount);
+    auto const intersectRays = [&](uint32_t taskIndex) {
+        const uint32_t end = (std::min)(taskIndex * 1024U + 1024U, rayCount);
+        uint32_t hitCount = 0U;
+        for (uint32_t rayIndex = taskIndex * 1024U; rayIndex < end; ++rayIndex) {
+            hitCount += IntersectBvhRay(bvh, objects, rays[rayIndex]).objectIndex != UINT32_MAX ? 1U : 0U;
+        }
+
+        // Keeps the compiler from dropping the intersections
+        taskHitCounts[taskIndex] = hitCount;
+    };
+
+    beginTime = std::chrono::steady_clock::now();
+    for (uint32_t i = 0U; i < iterationCount; ++i) {
+        ThreadPoolParallelFor(threadPool, rayTaskCount, intersectRays);
+    }
+    throughput.raysPerMillisecond = perMillisecond(double(rayCount) * iterationCount, std::chrono::steady_clock::now() - beginTime);
+
+    return throughput;
+}
+
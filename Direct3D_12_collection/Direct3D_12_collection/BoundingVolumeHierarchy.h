@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "FrustumCulling.h"
+#include "ThreadPool.h"
+
+// Bounding volume hierarchy over the bounding boxes of FrustumCulling for frustum culling and ray picking of large scenes.
+// Nodes are split with a binned surface area heuristic and stored depth-first in one array, so the first child of a node
+// is the next node and a traversal mostly walks forward through memory.
+// The objects keep their indices: moving objects only need a refit of the node bounds, not a rebuild.
+
+static constexpr uint32_t BVH_MAX_LEAF_SIZE = 4U;
+static constexpr uint32_t BVH_BIN_COUNT = 16U;
+
+// Nodes deeper than this are split at the object median, which bounds the traversal stack
+static constexpr uint32_t BVH_MAX_SAH_DEPTH = 64U;
+
+// 32 bytes, two nodes per cache line
+struct BvhNode
+{
+    float boundsMin[3];
+    uint32_t offset;        // leaf: first element in Bvh::objectIndices, interior node: index of the second child
+    float boundsMax[3];
+    uint32_t objectCount;   // 0 for interior nodes
+};
+
+struct Bvh
+{
+    std::vector<BvhNode> nodes;             // nodes[0] is the root
+    std::vector<uint32_t> objectIndices;    // the objects of the leaves, indices into FrustumCullingObjects
+};
+
+struct BvhRay
+{
+    float origin[3];
+    float direction[3];     // need not be normalized; the hit distance is in units of its length
+    float maxDistance;
+};
+
+struct BvhRayHit
+{
+    uint32_t objectIndex;   // UINT32_MAX if no box is hit
+    float distance;         // 0 if the origin is inside the box
+};
+
+// Subtrees are built in parallel below the top levels of the hierarchy. threadPool may be nullptr.
+extern auto BuildBvh(const FrustumCullingObjects& objects, ThreadPool* threadPool) -> Bvh;
+
+// Recomputes the node bounds from the current object bounds. The objects must be the ones the hierarchy was built from.
+// The quality of the hierarchy degrades as the objects move away from their positions at build time.
+extern auto RefitBvh(Bvh& bvh, const FrustumCullingObjects& objects) -> void;
+
+// Finds the same objects as CullFrustumObjects, in the order of the leaves instead of increasing order.
+// Planes that a node lies completely inside of are not tested again for its descendants.
+extern auto CullBvhFrustum(const Bvh& bvh, const FrustumCullingObjects& objects, const FrustumPlanes& planes, std::vector<uint32_t>& visibleIndices) -> void;
+
+// @return the nearest box hit within ray.maxDistance
+extern auto IntersectBvhRay(const Bvh& bvh, const FrustumCullingObjects& objects, const BvhRay& ray) -> BvhRayHit;
+
+struct BvhThroughput
+{
+    double buildObjectsPerMillisecond;
+    double refitObjectsPerMillisecond;
+    double cullObjectsPerMillisecond;
+    double raysPerMillisecond;
+};
+
+// Builds, refits, culls and intersects the rays iterationCount times each
+extern auto MeasureBvhThroughput(const FrustumCullingObjects& objects, const FrustumPlanes& planes, const std::vector<BvhRay>& rays,
+                                ThreadPool* threadPool, uint32_t iterationCount) -> BvhThroughput;
+
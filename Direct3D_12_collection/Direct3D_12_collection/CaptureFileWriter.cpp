@@ -0,0 +1,116 @@
+#include "CaptureFileWriter.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+struct CaptureFileWriterBlock
+{
+    const void* data;
+    size_t size;
+    std::function<void()> onWritten;
+};
+
+struct CaptureFileWriter
+{
+    FILE* file;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable queueCondition;
+
+    // Protected by `mutex`
+    std::deque<CaptureFileWriterBlock> blocks;
+    bool quit;
+
+    // Only accessed by the writer thread until it has been joined
+    CaptureFileWriterStats stats;
+};
+
+static auto CaptureFileWriterMain(CaptureFileWriter* writer) -> void
+{
+    while (true)
+    {
+        CaptureFileWriterBlock block{ };
+        {
+            std::unique_lock<std::mutex> lock(writer->mutex);
+            writer->queueCondition.wait(lock, [writer] { return writer->quit || !writer->blocks.empty(); });
+            if (writer->blocks.empty()) return;
+
+            block = std::move(writer->blocks.front());
+        }
+
+        const auto beginTime = std::chrono::steady_clock::now();
+        const size_t writtenSize = fwrite(block.data, 1U, block.size, writer->file);
+        writer->stats.busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - beginTime).count();
+
+        if (writtenSize == block.size)
+        {
+            ++writer->stats.blockCount;
+            writer->stats.byteCount += block.size;
+        }
+        else {
+            ++writer->stats.errorCount;
+        }
+
+        if (block.onWritten) {
+            block.onWritten();
+        }
+
+        // The block leaves the queue only after it has been written, so the pending count includes the block in progress
+        std::lock_guard<std::mutex> lock(writer->mutex);
+        writer->blocks.pop_front();
+    }
+}
+
+auto CreateCaptureFileWriter(const char* path) -> CaptureFileWriter*
+{
+    // SDL checks turn the fopen deprecation warning of MSVC into an error
+#if defined(_MSC_VER)
+    FILE* file = nullptr;
+    if (fopen_s(&file, path, "wb") != 0) return nullptr;
+#else
+    FILE* file = fopen(path, "wb");
+#endif
+    if (file == nullptr) return nullptr;
+
+    CaptureFileWriter* writer = new CaptureFileWriter{ };
+    writer->file = file;
+    writer->thread = std::thread(CaptureFileWriterMain, writer);
+    return writer;
+}
+
+auto CaptureFileWriterAppend(CaptureFileWriter* writer, const void* data, size_t size, std::function<void()> onWritten) -> void
+{
+    {
+        std::lock_guard<std::mutex> lock(writer->mutex);
+        writer->blocks.push_back(CaptureFileWriterBlock{ .data = data, .size = size, .onWritten = std::move(onWritten) });
+    }
+    writer->queueCondition.notify_one();
+}
+
+auto GetCaptureFileWriterPendingBlockCount(CaptureFileWriter* writer) -> size_t
+{
+    std::lock_guard<std::mutex> lock(writer->mutex);
+    return writer->blocks.size();
+}
+
+auto DestroyCaptureFileWriter(CaptureFileWriter* writer) -> CaptureFileWriterStats
+{
+    {
+        std::lock_guard<std::mutex> lock(writer->mutex);
+        writer->quit = true;
+    }
+    writer->queueCondition.notify_one();
+    writer->thread.join();
+
+    if (fclose(writer->file) != 0) {
+        ++writer->stats.errorCount;
+    }
+
+    const CaptureFileWriterStats stats = writer->stats;
+    delete writer;
+    return stats;
+}
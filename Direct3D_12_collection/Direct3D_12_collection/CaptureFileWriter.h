@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Appends blocks of memory to a binary file on a background thread, in the order in which they are queued.
+// The caller keeps a block alive until its onWritten callback has run, so GPU read back buffers can be written
+// straight from their mapped memory and recycled afterwards without a copy on the render thread.
+
+struct CaptureFileWriter;
+
+struct CaptureFileWriterStats
+{
+    uint64_t blockCount;
+    uint64_t byteCount;
+    double busySeconds;         // time spent in fwrite on the writer thread
+    uint32_t errorCount;        // blocks that were not written completely
+};
+
+// @return nullptr if the file cannot be created
+extern auto CreateCaptureFileWriter(const char* path) -> CaptureFileWriter*;
+
+// Queues a block. onWritten is called on the writer thread after the block has been written, or failed to be written,
+// and may be empty.
+extern auto CaptureFileWriterAppend(CaptureFileWriter* writer, const void* data, size_t size, std::function<void()> onWritten) -> void;
+
+// @return the number of queued blocks that have not been written yet
+extern auto GetCaptureFileWriterPendingBlockCount(CaptureFileWriter* writer) -> size_t;
+
+// Writes all queued blocks, closes the file and destroys the writer.
+extern auto DestroyCaptureFileWriter(CaptureFileWriter* writer) -> CaptureFileWriterStats;
@@ -1,4 +1,5 @@
 #include "common.h"
+#include "ReferenceRasterizer.h"
 
 #define TEST_UNCERTAINTY_REGION     0
 #define TEST_EARLY_DEPTH_CULLING    0
@@ -7,6 +8,12 @@
 #define OUTPUT_DEPTH_TEXTURE        0
 #define TEST_PRIMITIVE_POINT        0
 
+// Predict the pixel shader invocations with the CPU conservative rasterization model.
+// Only the default single triangle configuration is modeled.
+#define PREDICT_WITH_CONSERVATIVE_RASTER_MODEL  (1 && !TEST_UNCERTAINTY_REGION && !TEST_EARLY_DEPTH_CULLING && !TEST_VARIABLE_SHADING_RATE && !TEST_PRIMITIVE_POINT)
+// Keep consistent with ENABLE_CONSERVATIVE_RASTERIZATION_MODE in cr.frag.hlsl, which counts SV_InnerCoverage invocations in uavOutput[1]
+#define SHADER_OUTPUTS_INNER_COVERAGE_COUNT     0
+
 static constexpr D3D12_FILL_MODE USE_FILL_MODE = D3D12_FILL_MODE_SOLID;
 static constexpr D3D12_CONSERVATIVE_RASTERIZATION_MODE USE_CONSERVATIVE_RASTERIZATION_MODE = TEST_PRIMITIVE_POINT != 0 ? D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF : D3D12_CONSERVATIVE_RASTERIZATION_MODE_ON;
 static constexpr D3D_PRIMITIVE_TOPOLOGY RENDER_TEXTURE_USE_PRIMITIVE_TOPOLOGY = TEST_PRIMITIVE_POINT  != 0 ? D3D_PRIMITIVE_TOPOLOGY_POINTLIST : D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
@@ -30,6 +37,54 @@ static constexpr UINT TEXTURE_SAMPLE_COUNT = 1U;
 static constexpr bool MSAA_RENDER_TARGET_NEED_RESOLVE = true && TEXTURE_SAMPLE_COUNT > 1U;
 static constexpr UINT uavBufferSize = 64U;
 
+#if PREDICT_WITH_CONSERVATIVE_RASTER_MODEL
+static D3D12_CONSERVATIVE_RASTERIZATION_TIER s_conservativeRasterTier = D3D12_CONSERVATIVE_RASTERIZATION_TIER_NOT_SUPPORTED;
+static ReferenceConservativeRasterResult s_conservativeRasterPrediction;
+static uint64_t s_standardRasterInvocationCount = 0U;
+
+// Transforms the triangle list like cr.vert.hlsl does, then runs both the conservative model and the standard reference rasterizer.
+static auto PredictConservativeRasterization(const float* vertexData, size_t vertexStride, UINT vertexCount, float rotAngle, float zOffset) -> void
+{
+    const float rotRadian = rotAngle * float(M_PI) / 180.0f;
+    const float cosValue = std::cos(rotRadian);
+    const float sinValue = std::sin(rotRadian);
+
+    std::vector<float> clipPositions(size_t(vertexCount) * 4U);
+    for (UINT i = 0U; i < vertexCount; ++i)
+    {
+        const float* position = (const float*)((const uint8_t*)vertexData + vertexStride * i);
+        // glRotate(rotAngle, 1.0, 0.0, 0.0) -> glTranslate(0.0, 0.0, zOffset) -> glOrtho(-1.0, 1.0, -1.0, 1.0, 1.0, 3.0)
+        const float y = position[1] * cosValue - position[2] * sinValue;
+        const float z = position[1] * sinValue + position[2] * cosValue + zOffset * position[3];
+        clipPositions[i * 4U + 0U] = position[0];
+        clipPositions[i * 4U + 1U] = y;
+        clipPositions[i * 4U + 2U] = -z - 2.0f * position[3];
+        clipPositions[i * 4U + 3U] = position[3];
+    }
+
+    const ReferenceRasterViewport viewport{
+        .topLeftX = 0.0f,
+        .topLeftY = 0.0f,
+        .width = float(TEXTURE_SIZE),
+        .height = float(TEXTURE_SIZE),
+        .minDepth = 0.0f,
+        .maxDepth = 1.0f
+    };
+
+    s_conservativeRasterPrediction = ReferenceRasterConservativeTriangleList(TEXTURE_SIZE, TEXTURE_SIZE, viewport, UINT(s_conservativeRasterTier),
+                                                                            clipPositions.data(), 4U * sizeof(float), vertexCount);
+
+    const ReferenceRasterState state{
+        .sampleCount = TEXTURE_SAMPLE_COUNT,
+        .depthClipEnable = true,
+        .depthEnable = false,
+        .depthWriteEnable = false
+    };
+    ReferenceRasterTarget target = CreateReferenceRasterTarget(TEXTURE_SIZE, TEXTURE_SIZE, TEXTURE_SAMPLE_COUNT, 1.0f);
+    s_standardRasterInvocationCount = ReferenceRasterDrawTriangleList(target, viewport, state, clipPositions.data(), 4U * sizeof(float), vertexCount, 0);
+}
+#endif
+
 enum CBV_SRV_UAV_SLOT_ID
 {
     CBV_DRAW_INDEX_SLOT,
@@ -1079,6 +1134,20 @@ static auto CreateVertexBufferForRenderTexture(ID3D12Device* d3d_device, ID3D12R
     pTranslations->zOffsetFront = -2.333f;    // -1.8 is the neareast plane for frustum perspective projection
     pTranslations->zOffsetBack = -2.8f;     // -2.0 is the near clipping plane and -2.333 is the far clipping plane for orthogonal projection
 
+#if PREDICT_WITH_CONSERVATIVE_RASTER_MODEL
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options{ };
+    hRes = d3d_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options));
+    if (FAILED(hRes)) {
+        fprintf(stderr, "CheckFeatureSupport for `D3D12_FEATURE_D3D12_OPTIONS` failed: %ld\n", hRes);
+    }
+    else {
+        s_conservativeRasterTier = options.ConservativeRasterizationTier;
+    }
+
+    // The bundle draws the 3 vertices as one triangle with draw index 0, which selects zOffsetFront
+    PredictConservativeRasterization(triangleVertices[0].position, sizeof(triangleVertices[0]), 3U, pTranslations->rotAngle, pTranslations->zOffsetFront);
+#endif
+
     constantBuffer->Unmap(0, nullptr);
 
     // Execute the command list to complete the copy operation
@@ -1860,6 +1929,28 @@ auto CreateConservativeRasterizationTestAssets(ID3D12Device* d3d_device, ID3D12C
         printf("Current pixel shader invocation count: %u\n", hostMemPtr[0]);
         printf("Current Occlusion Query result: %llu\n", queryPtr[4]);
 
+#if PREDICT_WITH_CONSERVATIVE_RASTER_MODEL
+        if (USE_CONSERVATIVE_RASTERIZATION_MODE == D3D12_CONSERVATIVE_RASTERIZATION_MODE_ON && s_conservativeRasterTier != D3D12_CONSERVATIVE_RASTERIZATION_TIER_NOT_SUPPORTED)
+        {
+            const auto& prediction = s_conservativeRasterPrediction;
+            const unsigned long long measuredCount = hostMemPtr[0];
+            const bool inRange = measuredCount >= prediction.minInvocationCount && measuredCount <= prediction.maxInvocationCount;
+
+            printf("Conservative rasterization tier %d model (uncertainty region: %u/256 pixel):\n", int(s_conservativeRasterTier), prediction.uncertaintyInSubpixels);
+            printf("    predicted pixel shader invocations: %llu ~ %llu, measured: %llu (%s)\n",
+                    (unsigned long long)prediction.minInvocationCount, (unsigned long long)prediction.maxInvocationCount, measuredCount, inRange ? "within range" : "OUT OF RANGE");
+            printf("    predicted inner coverage invocations: %llu\n", (unsigned long long)prediction.innerInvocationCount);
+#if SHADER_OUTPUTS_INNER_COVERAGE_COUNT
+            printf("    measured inner coverage invocations: %u\n", hostMemPtr[1]);
+#endif
+            if (s_standardRasterInvocationCount > 0U)
+            {
+                printf("    standard rasterization invocations: %llu, conservative rasterization overhead: %.1f%%\n",
+                        (unsigned long long)s_standardRasterInvocationCount, double(measuredCount) * 100.0 / double(s_standardRasterInvocationCount) - 100.0);
+            }
+        }
+#endif
+
         readbackDevHostBuffer->Unmap(0, nullptr);
 
 #if OUTPUT_DEPTH_TEXTURE && TEST_EARLY_DEPTH_CULLING
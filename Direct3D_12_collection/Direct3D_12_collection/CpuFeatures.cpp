@@ -0,0 +1,67 @@
+#include "CpuFeatures.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#define CPU_FEATURES_USE_CPUID      1
+#define CPU_FEATURES_USE_BUILTIN    0
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define CPU_FEATURES_USE_CPUID      0
+#define CPU_FEATURES_USE_BUILTIN    1
+#else
+#define CPU_FEATURES_USE_CPUID      0
+#define CPU_FEATURES_USE_BUILTIN    0
+#endif
+
+auto IsSSE41SupportedByCPU() -> bool
+{
+    static const bool supported = [] {
+#if CPU_FEATURES_USE_CPUID
+        int cpuInfo[4]{ };
+        __cpuid(cpuInfo, 1);
+        return (cpuInfo[2] & (1 << 19)) != 0;
+#elif CPU_FEATURES_USE_BUILTIN
+        return __builtin_cpu_supports("sse4.1") != 0;
+#else
+        return false;
+#endif
+    }();
+    return supported;
+}
+
+auto IsAVXSupportedByCPU() -> bool
+{
+    static const bool supported = [] {
+#if CPU_FEATURES_USE_CPUID
+        int cpuInfo[4]{ };
+        __cpuid(cpuInfo, 1);
+        const bool osxsave = (cpuInfo[2] & (1 << 27)) != 0;
+        const bool avx = (cpuInfo[2] & (1 << 28)) != 0;
+
+        // The OS must save the YMM registers
+        return osxsave && avx && (_xgetbv(0) & 0x6U) == 0x6U;
+#elif CPU_FEATURES_USE_BUILTIN
+        return __builtin_cpu_supports("avx") != 0;
+#else
+        return false;
+#endif
+    }();
+    return supported;
+}
+
+auto IsAVX2SupportedByCPU() -> bool
+{
+    static const bool supported = [] {
+#if CPU_FEATURES_USE_CPUID
+        if (!IsAVXSupportedByCPU()) return false;
+
+        int cpuInfo[4]{ };
+        __cpuidex(cpuInfo, 7, 0);
+        return (cpuInfo[1] & (1 << 5)) != 0;
+#elif CPU_FEATURES_USE_BUILTIN
+        return __builtin_cpu_supports("avx2") != 0;
+#else
+        return false;
+#endif
+    }();
+    return supported;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// Run-time detection of the x86 instruction set extensions that the SIMD kernels of the CPU modules use
+// beyond the SSE2 baseline of x64. The CPU is only queried on the first call.
+// On other architectures, every extension is reported as unsupported.
+
+extern auto IsSSE41SupportedByCPU() -> bool;
+
+// Checks the OS support for the YMM registers as well
+extern auto IsAVXSupportedByCPU() -> bool;
+
+// Implies AVX support
+extern auto IsAVX2SupportedByCPU() -> bool;
@@ -1,8 +1,16 @@
 #include "common.h"
+#include "HiZPyramid.h"
 
 
 #define BIND_DEPTH_STENCIL_AS_SRV   0
 #define OUTPUT_DEPTH_TEXTURE        0
+// Build a Hi-Z pyramid from the rendered depth texture and cull test objects against it.
+// USE_MSAA in hiz_build.comp.hlsl must be 1 when the depth texture is multisampled and not resolved.
+#define TEST_HI_Z_CULLING           1
+// Render a deferred lighting scene with one screen-space rectangle per light, using the depth bounds test when supported.
+// DEFERRED_LIGHTING_BENCHMARK renders the light pass both without and with depth bounds and compares them.
+#define TEST_DEFERRED_LIGHTING      1
+#define DEFERRED_LIGHTING_BENCHMARK 1
 
 static constexpr UINT TEXTURE_SIZE = WINDOW_WIDTH / 8;
 static constexpr UINT TEXTURE_SAMPLE_COUNT = 1U;
@@ -17,6 +25,41 @@ enum CBV_SRV_UAV_SLOT_ID
     CBV_SRV_UAV_SLOT_COUNT
 };
 
+#if TEST_HI_Z_CULLING
+enum HI_Z_SLOT_ID
+{
+    HI_Z_SRV_DEPTH_TEXTURE_SLOT,
+    HI_Z_SRV_OBJECT_BOUNDS_SLOT,
+    HI_Z_UAV_PYRAMID_SLOT,
+    HI_Z_UAV_CULL_OUTPUT_SLOT,
+    HI_Z_SLOT_COUNT
+};
+
+static constexpr UINT HI_Z_ROOT_CONSTANT_COUNT = 8U;
+#endif
+
+#if TEST_DEFERRED_LIGHTING
+enum DEFERRED_SLOT_ID
+{
+    DEFERRED_SRV_ALBEDO_SLOT,
+    DEFERRED_SRV_NORMAL_SLOT,
+    DEFERRED_SRV_DEPTH_SLOT,
+    DEFERRED_SRV_LIGHTS_SLOT,
+    DEFERRED_UAV_COUNTER_SLOT,
+    DEFERRED_SLOT_COUNT
+};
+
+static constexpr UINT DEFERRED_LIGHTING_TARGET_SIZE = WINDOW_WIDTH;
+static constexpr UINT DEFERRED_LIGHT_COUNT = 4096U;
+static constexpr DXGI_FORMAT DEFERRED_ALBEDO_FORMAT = DXGI_FORMAT_R8G8B8A8_UNORM;
+static constexpr DXGI_FORMAT DEFERRED_NORMAL_FORMAT = DXGI_FORMAT_R16G16B16A16_FLOAT;
+static constexpr DXGI_FORMAT DEFERRED_LIGHT_ACCUMULATION_FORMAT = DXGI_FORMAT_R16G16B16A16_FLOAT;
+
+// Must match the projection in deferred_gbuffer.vert.hlsl and deferred_light.frag.hlsl
+static constexpr float DEFERRED_NEAR_PLANE = 1.0f;
+static constexpr float DEFERRED_FAR_PLANE = 9.0f;
+#endif
+
 static auto CreateRootSignature(ID3D12Device* d3d_device) -> ID3D12RootSignature*
 {
     ID3D12RootSignature* rootSignature = nullptr;
@@ -1355,83 +1398,1661 @@ static auto PopulateComputeCommandList(ID3D12Device* d3d_device, ID3D12PipelineS
 }
 #endif
 
-auto CreateDepthBoundTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue *commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
-                                    std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12DescriptorHeap*, ID3D12DescriptorHeap*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, bool>
+#if TEST_HI_Z_CULLING
+static auto CreateRootSignatureForHiZ(ID3D12Device* d3d_device) -> ID3D12RootSignature*
 {
     ID3D12RootSignature* rootSignature = nullptr;
-    ID3D12PipelineState* pipelineState = nullptr;
-    ID3D12PipelineState* computePipelineState = nullptr;
+
+    const D3D12_DESCRIPTOR_RANGE descRanges[]{
+        // t0 (for depth texture), t1 (for object bounds)
+        {
+            .RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV,
+            .NumDescriptors = 2,
+            .BaseShaderRegister = 0,
+            .RegisterSpace = 0,
+            .OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND
+        },
+        // u0 (for Hi-Z pyramid), u1 (for culling output)
+        {
+            .RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV,
+            .NumDescriptors = 2,
+            .BaseShaderRegister = 0,
+            .RegisterSpace = 0,
+            .OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND
+        }
+    };
+
+    const D3D12_ROOT_PARAMETER rootParameters[]{
+        // t0, t1
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE,
+            .DescriptorTable {
+                .NumDescriptorRanges = 1,
+                .pDescriptorRanges = &descRanges[0]
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        // u0, u1
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE,
+            .DescriptorTable {
+                .NumDescriptorRanges = 1,
+                .pDescriptorRanges = &descRanges[1]
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        // b0 (for the level layout of the build pass and the object count of the culling pass)
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+            .Constants {
+                .ShaderRegister = 0,
+                .RegisterSpace = 0,
+                .Num32BitValues = HI_Z_ROOT_CONSTANT_COUNT
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        }
+    };
+
+    // Create a root signature.
+    const D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc{
+        .NumParameters = (UINT)std::size(rootParameters),
+        .pParameters = rootParameters,
+        .NumStaticSamplers = 0,
+        .pStaticSamplers = nullptr,
+        .Flags = D3D12_ROOT_SIGNATURE_FLAG_DENY_VERTEX_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_PIXEL_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_AMPLIFICATION_SHADER_ROOT_ACCESS | D3D12_ROOT_SIGNATURE_FLAG_DENY_MESH_SHADER_ROOT_ACCESS
+    };
+
+    ID3DBlob* signature = nullptr;
+    ID3DBlob* error = nullptr;
+    HRESULT hRes = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error);
+    do
+    {
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "D3D12SerializeRootSignature for Hi-Z failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateRootSignature for Hi-Z failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (signature != nullptr) {
+        signature->Release();
+    }
+    if (error != nullptr) {
+        error->Release();
+    }
+
+    if (FAILED(hRes)) return nullptr;
+
+    return rootSignature;
+}
+
+// @return [buildPipelineState, cullPipelineState]
+static auto CreatePipelineStateObjectsForHiZ(ID3D12Device* d3d_device, ID3D12RootSignature* rootSignature) -> std::pair<ID3D12PipelineState*, ID3D12PipelineState*>
+{
+    ID3D12PipelineState* buildPipelineState = nullptr;
+    ID3D12PipelineState* cullPipelineState = nullptr;
+
+    D3D12_SHADER_BYTECODE buildShaderObj = CreateCompiledShaderObjectFromPath("cso/hiz_build.comp.cso");
+    D3D12_SHADER_BYTECODE cullShaderObj = CreateCompiledShaderObjectFromPath("cso/hiz_cull.comp.cso");
+
+    do
+    {
+        if (buildShaderObj.pShaderBytecode == nullptr || buildShaderObj.BytecodeLength == 0) break;
+        if (cullShaderObj.pShaderBytecode == nullptr || cullShaderObj.BytecodeLength == 0) break;
+
+        D3D12_COMPUTE_PIPELINE_STATE_DESC computeDesc{
+            .pRootSignature = rootSignature,
+            .CS = buildShaderObj,
+            .NodeMask = 0,
+            .CachedPSO { nullptr, 0U },
+            .Flags = D3D12_PIPELINE_STATE_FLAG_NONE
+        };
+        HRESULT hRes = d3d_device->CreateComputePipelineState(&computeDesc, IID_PPV_ARGS(&buildPipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateComputePipelineState for Hi-Z build PSO failed: %ld\n", hRes);
+            break;
+        }
+
+        computeDesc.CS = cullShaderObj;
+        hRes = d3d_device->CreateComputePipelineState(&computeDesc, IID_PPV_ARGS(&cullPipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateComputePipelineState for Hi-Z culling PSO failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (buildShaderObj.pShaderBytecode != nullptr) {
+        free((void*)buildShaderObj.pShaderBytecode);
+    }
+    if (cullShaderObj.pShaderBytecode != nullptr) {
+        free((void*)cullShaderObj.pShaderBytecode);
+    }
+
+    return std::make_pair(buildPipelineState, cullPipelineState);
+}
+
+// One object of 2, 4 or 6 pixels per 8 x 8 pixel cell, alternately in front of and behind the rendered point block,
+// plus a large object straddling the block and an object outside the render target
+static auto CreateHiZTestObjects() -> std::vector<HiZObjectBounds>
+{
+    constexpr UINT cellSize = 8U;
+    constexpr UINT cellCount = TEXTURE_SIZE / cellSize;
+
+    std::vector<HiZObjectBounds> objects;
+    objects.reserve(cellCount * cellCount + 2U);
+
+    for (UINT cy = 0; cy < cellCount; ++cy)
+    {
+        for (UINT cx = 0; cx < cellCount; ++cx)
+        {
+            const float size = float(2U + ((cx + cy) % 3U) * 2U);
+            const float depth = ((cx + cy) & 1U) != 0U ? 0.9f : 0.1f;
+            const float minX = float(cx * cellSize + 1U);
+            const float minY = float(cy * cellSize + 1U);
+            objects.push_back({ .minX = minX, .minY = minY, .maxX = minX + size, .maxY = minY + size, .minDepth = depth, .maxDepth = depth + 0.05f });
+        }
+    }
+
+    objects.push_back({ .minX = 22.0f, .minY = 22.0f, .maxX = 42.0f, .maxY = 42.0f, .minDepth = 0.9f, .maxDepth = 0.95f });
+    objects.push_back({ .minX = -16.0f, .minY = 4.0f, .maxX = -2.0f, .maxY = 12.0f, .minDepth = 0.1f, .maxDepth = 0.2f });
+
+    return objects;
+}
+
+// Builds the Hi-Z pyramid from the depth texture rendered by this test, culls the test objects against it on the GPU,
+// and validates both the pyramid and the visibility against the CPU reference.
+// depthTexture must be in D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE state, and it is restored to this state.
+static auto RunHiZOcclusionCulling(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator,
+                                    ID3D12Resource* depthTexture) -> bool
+{
+    if (depthTexture == nullptr) return false;
+
+    const std::vector<HiZObjectBounds> objects = CreateHiZTestObjects();
+    const UINT objectCount = UINT(objects.size());
+    const HiZPyramid pyramidLayout = CreateHiZPyramidLayout(TEXTURE_SIZE, TEXTURE_SIZE);
+
+    const UINT pyramidSize = pyramidLayout.texelCount * UINT(2U * sizeof(float));
+    const UINT cullOutputElementCount = GetHiZCullOutputElementCount(objectCount);
+    const UINT cullOutputSize = cullOutputElementCount * UINT(sizeof(UINT));
+    const UINT objectBufferSize = objectCount * UINT(sizeof(HiZObjectBounds));
+
+    ID3D12RootSignature* rootSignature = nullptr;
+    ID3D12PipelineState* buildPipelineState = nullptr;
+    ID3D12PipelineState* cullPipelineState = nullptr;
     ID3D12GraphicsCommandList* commandList = nullptr;
-    ID3D12GraphicsCommandList* commandBundle = nullptr;
-    ID3D12GraphicsCommandList* computeCommandList = nullptr;
-    ID3D12GraphicsCommandList* computeCommandBundle = nullptr;
-    ID3D12DescriptorHeap* rtvDescriptorHeap = nullptr;
-    ID3D12DescriptorHeap* dsvDescriptorHeap = nullptr;
-    ID3D12DescriptorHeap* cbv_uavDescriptorHeap = nullptr;
+    ID3D12DescriptorHeap* descriptorHeap = nullptr;
     ID3D12Resource* uploadDevHostBuffer = nullptr;
-    ID3D12Resource* vertexBuffer = nullptr;
-    ID3D12Resource* rtTexture = nullptr;
-    ID3D12Resource* dsTexture = nullptr;
-    ID3D12Resource* resolvedRTTexture = nullptr;
-    ID3D12Resource* resolvedDSTexture = nullptr;
-    ID3D12Resource* uavBuffer = nullptr;
-    ID3D12Resource* uavCompOutBuffer = nullptr;
+    ID3D12Resource* objectBuffer = nullptr;
+    ID3D12Resource* hiZBuffer = nullptr;
     ID3D12Resource* readbackDevHostBuffer = nullptr;
-    ID3D12Resource* readBackTextureHostBuffer = nullptr;
     bool success = false;
 
-    auto result = std::make_tuple(rootSignature, pipelineState, commandList, commandBundle, cbv_uavDescriptorHeap, rtvDescriptorHeap, uploadDevHostBuffer, vertexBuffer, rtTexture, success);
+    do
+    {
+        rootSignature = CreateRootSignatureForHiZ(d3d_device);
+        if (rootSignature == nullptr) break;
 
-    rootSignature = CreateRootSignature(d3d_device);
-    if (rootSignature == nullptr) return result;
+        auto const pipelineResult = CreatePipelineStateObjectsForHiZ(d3d_device, rootSignature);
+        buildPipelineState = pipelineResult.first;
+        cullPipelineState = pipelineResult.second;
+        if (buildPipelineState == nullptr || cullPipelineState == nullptr) break;
 
-    auto const rtTexRes = CreateRenderTargetViewForTexture(d3d_device);
-    rtvDescriptorHeap = std::get<0>(rtTexRes);
-    dsvDescriptorHeap = std::get<1>(rtTexRes);
-    rtTexture = std::get<2>(rtTexRes);
-    dsTexture = std::get<3>(rtTexRes);
-    resolvedRTTexture = std::get<4>(rtTexRes);
-    resolvedDSTexture = std::get<5>(rtTexRes);
+        HRESULT hRes = commandAllocator->Reset();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Reset command allocator for Hi-Z failed: %ld\n", hRes);
+            break;
+        }
 
-    auto const pipelineResult = CreatePipelineStateObjectForRenderTexture(d3d_device, commandAllocator, commandBundleAllocator, rootSignature);
-    pipelineState = std::get<0>(pipelineResult);
-    commandList = std::get<1>(pipelineResult);
-    commandBundle = std::get<2>(pipelineResult);
-    cbv_uavDescriptorHeap = std::get<3>(pipelineResult);
+        hRes = d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator, buildPipelineState, IID_PPV_ARGS(&commandList));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommandList for Hi-Z failed: %ld\n", hRes);
+            break;
+        }
 
-    auto const renderVertexBufferResult = CreateVertexBufferForRenderTexture(d3d_device, rootSignature, commandQueue, commandList, commandBundle, cbv_uavDescriptorHeap);
-    uploadDevHostBuffer = std::get<0>(renderVertexBufferResult);
-    vertexBuffer = std::get<1>(renderVertexBufferResult);
-    uavBuffer = std::get<2>(renderVertexBufferResult);
-    readbackDevHostBuffer = std::get<3>(renderVertexBufferResult);
-    readBackTextureHostBuffer = std::get<4>(renderVertexBufferResult);
-    uavCompOutBuffer = std::get<5>(renderVertexBufferResult);
+        const D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc{
+            .Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+            .NumDescriptors = HI_Z_SLOT_COUNT,
+            .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE,
+            .NodeMask = 0
+        };
+        hRes = d3d_device->CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(&descriptorHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateDescriptorHeap for Hi-Z failed: %ld\n", hRes);
+            break;
+        }
 
-    do
-    {
-        if (!ResetCommandAllocatorAndList(commandAllocator, commandList, pipelineState)) break;
+        const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+            .Type = D3D12_HEAP_TYPE_DEFAULT,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
 
-        if (!PopulateCommandList(commandBundle, commandList, rtvDescriptorHeap, dsvDescriptorHeap, cbv_uavDescriptorHeap,
-                                rtTexture, dsTexture, resolvedRTTexture, resolvedDSTexture, uavBuffer, readbackDevHostBuffer)) break;
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = defaultHeapProperties;
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
 
-        // Execute the command list.
-        ID3D12CommandList* const ppCommandLists[] = { (ID3D12CommandList*)commandList };
-        commandQueue->ExecuteCommandLists((UINT)std::size(ppCommandLists), ppCommandLists);
+        D3D12_HEAP_PROPERTIES readbackHeapProperties = defaultHeapProperties;
+        readbackHeapProperties.Type = D3D12_HEAP_TYPE_READBACK;
 
-        if (!WaitForPreviousFrame(commandQueue)) break;
+        D3D12_RESOURCE_DESC bufferDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0,
+            .Width = objectBufferSize,
+            .Height = 1U,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {.Count = 1U, .Quality = 0 },
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE
+        };
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&objectBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for Hi-Z object buffer failed: %ld\n", hRes);
+            break;
+        }
 
-        // Read back the pixel shader invocation count
-        unsigned* hostMemPtr = nullptr;
-        HRESULT hRes = readbackDevHostBuffer->Map(0, nullptr, (void**)&hostMemPtr);
+        // The object bounds and the zero-initialized culling output
+        bufferDesc.Width = objectBufferSize + cullOutputSize;
+        hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadDevHostBuffer));
         if (FAILED(hRes))
         {
-            fprintf(stderr, "Map read back buffer failed: %ld\n", hRes);
+            fprintf(stderr, "CreateCommittedResource for Hi-Z upload buffer failed: %ld\n", hRes);
             break;
         }
 
-        printf("Current pixel shader invocation count: %u\n", *hostMemPtr);
+        // The pyramid followed by the culling output, so that both can be read back with one copy
+        bufferDesc.Width = pyramidSize + cullOutputSize;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&hiZBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for Hi-Z buffer failed: %ld\n", hRes);
+            break;
+        }
 
-        readbackDevHostBuffer->Unmap(0, nullptr);
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&readbackDevHostBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for Hi-Z read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        void* hostMemPtr = nullptr;
+        hRes = uploadDevHostBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map Hi-Z upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        memcpy(hostMemPtr, objects.data(), objectBufferSize);
+        memset((void*)(uintptr_t(hostMemPtr) + objectBufferSize), 0, cullOutputSize);
+        uploadDevHostBuffer->Unmap(0, nullptr);
+
+        // Create the descriptors in the order of the descriptor tables: t0, t1, u0, u1
+        constexpr bool isMSAA = !MSAA_RENDER_TARGET_NEED_RESOLVE && TEXTURE_SAMPLE_COUNT > 1;
+        const UINT descriptorIncrSize = d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        const D3D12_CPU_DESCRIPTOR_HANDLE cpuDescHandleStart = descriptorHeap->GetCPUDescriptorHandleForHeapStart();
+        D3D12_CPU_DESCRIPTOR_HANDLE cpuDescHandle = cpuDescHandleStart;
+
+        const D3D12_SHADER_RESOURCE_VIEW_DESC depthSRVDesc{
+            .Format = DXGI_FORMAT_R32_FLOAT,
+            .ViewDimension = isMSAA ? D3D12_SRV_DIMENSION_TEXTURE2DMS : D3D12_SRV_DIMENSION_TEXTURE2D,
+            .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+            .Texture2D {
+                .MostDetailedMip = 0,
+                .MipLevels = 1,
+                .PlaneSlice = 0,
+                .ResourceMinLODClamp = 0.0f
+            }
+        };
+        cpuDescHandle.ptr = cpuDescHandleStart.ptr + HI_Z_SRV_DEPTH_TEXTURE_SLOT * descriptorIncrSize;
+        d3d_device->CreateShaderResourceView(depthTexture, &depthSRVDesc, cpuDescHandle);
+
+        const D3D12_SHADER_RESOURCE_VIEW_DESC objectSRVDesc{
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .ViewDimension = D3D12_SRV_DIMENSION_BUFFER,
+            .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+            .Buffer {
+                .FirstElement = 0,
+                .NumElements = objectCount,
+                .StructureByteStride = UINT(sizeof(HiZObjectBounds)),
+                .Flags = D3D12_BUFFER_SRV_FLAG_NONE
+            }
+        };
+        cpuDescHandle.ptr = cpuDescHandleStart.ptr + HI_Z_SRV_OBJECT_BOUNDS_SLOT * descriptorIncrSize;
+        d3d_device->CreateShaderResourceView(objectBuffer, &objectSRVDesc, cpuDescHandle);
+
+        const D3D12_UNORDERED_ACCESS_VIEW_DESC pyramidUAVDesc{
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .ViewDimension = D3D12_UAV_DIMENSION_BUFFER,
+            .Buffer {
+                .FirstElement = 0,
+                .NumElements = pyramidLayout.texelCount,
+                .StructureByteStride = UINT(2U * sizeof(float)),
+                .CounterOffsetInBytes = 0,
+                .Flags = D3D12_BUFFER_UAV_FLAG_NONE
+            }
+        };
+        cpuDescHandle.ptr = cpuDescHandleStart.ptr + HI_Z_UAV_PYRAMID_SLOT * descriptorIncrSize;
+        d3d_device->CreateUnorderedAccessView(hiZBuffer, nullptr, &pyramidUAVDesc, cpuDescHandle);
+
+        const D3D12_UNORDERED_ACCESS_VIEW_DESC cullOutputUAVDesc{
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .ViewDimension = D3D12_UAV_DIMENSION_BUFFER,
+            .Buffer {
+                .FirstElement = pyramidSize / UINT(sizeof(UINT)),
+                .NumElements = cullOutputElementCount,
+                .StructureByteStride = UINT(sizeof(UINT)),
+                .CounterOffsetInBytes = 0,
+                .Flags = D3D12_BUFFER_UAV_FLAG_NONE
+            }
+        };
+        cpuDescHandle.ptr = cpuDescHandleStart.ptr + HI_Z_UAV_CULL_OUTPUT_SLOT * descriptorIncrSize;
+        d3d_device->CreateUnorderedAccessView(hiZBuffer, nullptr, &cullOutputUAVDesc, cpuDescHandle);
+
+        // Upload the object bounds and clear the culling output
+        WriteToDeviceResourceAndSync(commandList, objectBuffer, uploadDevHostBuffer, 0U, 0U, objectBufferSize);
+        WriteToDeviceResourceAndSync(commandList, hiZBuffer, uploadDevHostBuffer, pyramidSize, objectBufferSize, cullOutputSize);
+
+        const D3D12_RESOURCE_BARRIER beginBarriers[]{
+            {
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = hiZBuffer,
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_GENERIC_READ,
+                    .StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+                }
+            },
+            // The depth texture is read in compute shaders
+            {
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = depthTexture,
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+                    .StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE
+                }
+            }
+        };
+        commandList->ResourceBarrier(UINT(std::size(beginBarriers)), beginBarriers);
+
+        D3D12_GPU_DESCRIPTOR_HANDLE srvGPUDescHandle = descriptorHeap->GetGPUDescriptorHandleForHeapStart();
+        D3D12_GPU_DESCRIPTOR_HANDLE uavGPUDescHandle = srvGPUDescHandle;
+        srvGPUDescHandle.ptr += HI_Z_SRV_DEPTH_TEXTURE_SLOT * descriptorIncrSize;
+        uavGPUDescHandle.ptr += HI_Z_UAV_PYRAMID_SLOT * descriptorIncrSize;
+
+        ID3D12DescriptorHeap* const descHeaps[]{ descriptorHeap };
+        commandList->SetDescriptorHeaps(UINT(std::size(descHeaps)), descHeaps);
+        commandList->SetComputeRootSignature(rootSignature);
+        commandList->SetComputeRootDescriptorTable(0, srvGPUDescHandle);    // rootParameters[0]
+        commandList->SetComputeRootDescriptorTable(1, uavGPUDescHandle);    // rootParameters[1]
+
+        const D3D12_RESOURCE_BARRIER uavBarrier{
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_UAV,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .UAV { .pResource = hiZBuffer }
+        };
+
+        // Build pass: one dispatch per level, each level reads the previous one
+        for (UINT level = 0; level < pyramidLayout.levelCount; ++level)
+        {
+            const HiZPyramidLevel& dst = pyramidLayout.levels[level];
+            const HiZPyramidLevel& src = pyramidLayout.levels[level == 0 ? 0 : level - 1];
+            const UINT levelConstants[HI_Z_ROOT_CONSTANT_COUNT]{ level, src.offset, src.width, src.height, dst.offset, dst.width, dst.height, 0U };
+
+            if (level > 0) {
+                commandList->ResourceBarrier(1U, &uavBarrier);
+            }
+            commandList->SetComputeRoot32BitConstants(2U, HI_Z_ROOT_CONSTANT_COUNT, levelConstants, 0U);   // rootParameters[2]
+            commandList->Dispatch((dst.width + HI_Z_BUILD_GROUP_SIZE - 1U) / HI_Z_BUILD_GROUP_SIZE, (dst.height + HI_Z_BUILD_GROUP_SIZE - 1U) / HI_Z_BUILD_GROUP_SIZE, 1U);
+        }
+        commandList->ResourceBarrier(1U, &uavBarrier);
+
+        // Culling pass
+        const UINT cullConstants[HI_Z_ROOT_CONSTANT_COUNT]{ objectCount, pyramidLayout.levelCount, TEXTURE_SIZE, TEXTURE_SIZE, 0U, 0U, 0U, 0U };
+        commandList->SetPipelineState(cullPipelineState);
+        commandList->SetComputeRoot32BitConstants(2U, HI_Z_ROOT_CONSTANT_COUNT, cullConstants, 0U);        // rootParameters[2]
+        commandList->Dispatch((objectCount + HI_Z_CULL_GROUP_SIZE - 1U) / HI_Z_CULL_GROUP_SIZE, 1U, 1U);
+
+        const D3D12_RESOURCE_BARRIER endBarrier{
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .Transition {
+                .pResource = depthTexture,
+                .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                .StateBefore = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,
+                .StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+            }
+        };
+        commandList->ResourceBarrier(1U, &endBarrier);
+
+        SyncAndReadFromDeviceResource(commandList, pyramidSize + cullOutputSize, readbackDevHostBuffer, hiZBuffer);
+
+        hRes = commandList->Close();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Close Hi-Z command list failed: %ld\n", hRes);
+            break;
+        }
+
+        ID3D12CommandList* const ppCommandLists[] = { (ID3D12CommandList*)commandList };
+        commandQueue->ExecuteCommandLists((UINT)std::size(ppCommandLists), ppCommandLists);
+
+        if (!WaitForPreviousFrame(commandQueue)) break;
+
+        hRes = readbackDevHostBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map Hi-Z read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        const float* gpuMinMaxDepths = (const float*)hostMemPtr;
+        const UINT* gpuCullOutput = (const UINT*)(uintptr_t(hostMemPtr) + pyramidSize);
+
+        // CPU reference: rebuild the upper levels from the GPU level 0, which is a plain copy of the depth texture
+        HiZPyramid cpuPyramid = pyramidLayout;
+        memcpy(cpuPyramid.minMaxDepths.data(), gpuMinMaxDepths, size_t(pyramidLayout.levels[0].width) * pyramidLayout.levels[0].height * 2U * sizeof(float));
+        BuildHiZPyramidLevels(cpuPyramid);
+
+        UINT pyramidMismatchCount = 0;
+        for (UINT i = 0; i < pyramidLayout.texelCount * 2U; ++i)
+        {
+            if (gpuMinMaxDepths[i] != cpuPyramid.minMaxDepths[i]) {
+                ++pyramidMismatchCount;
+            }
+        }
+
+        UINT cpuCounts[HI_Z_CULL_UNOCCLUDED + 1]{ };
+        UINT visibilityMismatchCount = 0;
+        for (UINT i = 0; i < objectCount; ++i)
+        {
+            const HiZCullResult cpuResult = HiZCullObject(cpuPyramid, objects[i]);
+            ++cpuCounts[cpuResult];
+
+            const bool cpuVisible = cpuResult == HI_Z_CULL_VISIBLE || cpuResult == HI_Z_CULL_UNOCCLUDED;
+            const bool gpuVisible = (gpuCullOutput[HI_Z_CULL_OUTPUT_VISIBILITY_BITS_INDEX + i / 32U] & (1U << (i % 32U))) != 0U;
+            if (cpuVisible != gpuVisible) {
+                ++visibilityMismatchCount;
+            }
+        }
+
+        const UINT gpuVisibleCount = gpuCullOutput[HI_Z_CULL_OUTPUT_VISIBLE_COUNT_INDEX];
+        const UINT gpuUnoccludedCount = gpuCullOutput[HI_Z_CULL_OUTPUT_UNOCCLUDED_COUNT_INDEX];
+        const UINT cpuVisibleCount = cpuCounts[HI_Z_CULL_VISIBLE] + cpuCounts[HI_Z_CULL_UNOCCLUDED];
+
+        printf("Hi-Z pyramid: %u levels, %u texels, %u mismatches against the CPU reference\n", pyramidLayout.levelCount, pyramidLayout.texelCount, pyramidMismatchCount);
+        printf("Hi-Z culling: %u of %u objects visible (%u unoccluded), CPU reference: %u visible (%u unoccluded, %u occluded, %u outside), %u visibility mismatches\n",
+                gpuVisibleCount, objectCount, gpuUnoccludedCount, cpuVisibleCount, cpuCounts[HI_Z_CULL_UNOCCLUDED],
+                cpuCounts[HI_Z_CULL_OCCLUDED], cpuCounts[HI_Z_CULL_OUTSIDE], visibilityMismatchCount);
+
+        readbackDevHostBuffer->Unmap(0, nullptr);
+
+        success = pyramidMismatchCount == 0 && visibilityMismatchCount == 0 && gpuVisibleCount == cpuVisibleCount && gpuUnoccludedCount == cpuCounts[HI_Z_CULL_UNOCCLUDED];
+    }
+    while (false);
+
+    if (rootSignature != nullptr) {
+        rootSignature->Release();
+    }
+    if (buildPipelineState != nullptr) {
+        buildPipelineState->Release();
+    }
+    if (cullPipelineState != nullptr) {
+        cullPipelineState->Release();
+    }
+    if (commandList != nullptr) {
+        commandList->Release();
+    }
+    if (descriptorHeap != nullptr) {
+        descriptorHeap->Release();
+    }
+    if (uploadDevHostBuffer != nullptr) {
+        uploadDevHostBuffer->Release();
+    }
+    if (objectBuffer != nullptr) {
+        objectBuffer->Release();
+    }
+    if (hiZBuffer != nullptr) {
+        hiZBuffer->Release();
+    }
+    if (readbackDevHostBuffer != nullptr) {
+        readbackDevHostBuffer->Release();
+    }
+
+    return success;
+}
+#endif
+
+#if TEST_DEFERRED_LIGHTING
+struct DeferredVertex
+{
+    float position[4];      // view-space position
+    float normal[4];
+    float color[4];
+};
+
+// The same layout as `LightInfo` in deferred_light.vert.hlsl and deferred_light.frag.hlsl
+struct DeferredLightInfo
+{
+    float position[3];      // view-space position
+    float radius;
+    float color[3];
+    float paddings;
+    float rect[4];          // NDC bounding rectangle [minX, minY, maxX, maxY]
+};
+
+// Window depth of the view-space z (z < 0) with the projection of deferred_gbuffer.vert.hlsl
+static auto GetDeferredLightingDepth(float viewZ) -> float
+{
+    return DEFERRED_FAR_PLANE / (DEFERRED_FAR_PLANE - DEFERRED_NEAR_PLANE) * (1.0f + DEFERRED_NEAR_PLANE / viewZ);
+}
+
+// A floor, a back wall and two pillars in view space
+static auto CreateDeferredLightingScene() -> std::vector<DeferredVertex>
+{
+    std::vector<DeferredVertex> vertices;
+
+    auto const addQuad = [&vertices](const float (&corners)[4][3], const float (&normal)[3], const float (&color)[3]) {
+        constexpr int cornerIndices[] = { 0, 1, 2, 0, 2, 3 };
+        for (int index : cornerIndices)
+        {
+            vertices.push_back({
+                .position { corners[index][0], corners[index][1], corners[index][2], 1.0f },
+                .normal { normal[0], normal[1], normal[2], 0.0f },
+                .color { color[0], color[1], color[2], 1.0f }
+            });
+        }
+    };
+
+    addQuad({ { -9.0f, -1.0f, -1.0f }, { 9.0f, -1.0f, -1.0f }, { 9.0f, -1.0f, -9.0f }, { -9.0f, -1.0f, -9.0f } }, { 0.0f, 1.0f, 0.0f }, { 0.6f, 0.6f, 0.6f });
+    addQuad({ { -9.0f, -9.0f, -8.5f }, { 9.0f, -9.0f, -8.5f }, { 9.0f, 9.0f, -8.5f }, { -9.0f, 9.0f, -8.5f } }, { 0.0f, 0.0f, 1.0f }, { 0.7f, 0.65f, 0.5f });
+    addQuad({ { -1.2f, -1.0f, -3.0f }, { -0.6f, -1.0f, -3.0f }, { -0.6f, 1.5f, -3.0f }, { -1.2f, 1.5f, -3.0f } }, { 0.0f, 0.0f, 1.0f }, { 0.8f, 0.2f, 0.2f });
+    addQuad({ { 0.4f, -1.0f, -5.5f }, { 1.4f, -1.0f, -5.5f }, { 1.4f, 2.5f, -5.5f }, { 0.4f, 2.5f, -5.5f } }, { 0.0f, 0.0f, 1.0f }, { 0.2f, 0.4f, 0.8f });
+
+    return vertices;
+}
+
+// Computes the screen-space rectangle and the depth bounds of the light sphere.
+// @return false if the light sphere is outside the view frustum
+static auto ComputeDeferredLightVolume(DeferredLightInfo& light, float& minDepth, float& maxDepth) -> bool
+{
+    const float nearZ = light.position[2] + light.radius;
+    const float farZ = light.position[2] - light.radius;
+    if (farZ > -DEFERRED_NEAR_PLANE || nearZ < -DEFERRED_FAR_PLANE) return false;
+
+    minDepth = GetDeferredLightingDepth((std::min)(nearZ, -DEFERRED_NEAR_PLANE));
+    maxDepth = GetDeferredLightingDepth((std::max)(farZ, -DEFERRED_FAR_PLANE));
+
+    float rect[4] = { -1.0f, -1.0f, 1.0f, 1.0f };
+
+    // The bounding box of the sphere is in front of the near plane, so project its corners.
+    // Otherwise the light may cover the whole screen.
+    if (nearZ <= -DEFERRED_NEAR_PLANE)
+    {
+        rect[0] = rect[1] = INFINITY;
+        rect[2] = rect[3] = -INFINITY;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const float x = light.position[0] + ((corner & 1) != 0 ? light.radius : -light.radius);
+            const float y = light.position[1] + ((corner & 2) != 0 ? light.radius : -light.radius);
+            const float z = (corner & 4) != 0 ? nearZ : farZ;
+            rect[0] = (std::min)(rect[0], x / -z);
+            rect[1] = (std::min)(rect[1], y / -z);
+            rect[2] = (std::max)(rect[2], x / -z);
+            rect[3] = (std::max)(rect[3], y / -z);
+        }
+
+        rect[0] = (std::max)(rect[0], -1.0f);
+        rect[1] = (std::max)(rect[1], -1.0f);
+        rect[2] = (std::min)(rect[2], 1.0f);
+        rect[3] = (std::min)(rect[3], 1.0f);
+        if (rect[0] >= rect[2] || rect[1] >= rect[3]) return false;
+    }
+
+    memcpy(light.rect, rect, sizeof(rect));
+    return true;
+}
+
+static auto CreateRootSignatureForDeferredLighting(ID3D12Device* d3d_device) -> ID3D12RootSignature*
+{
+    ID3D12RootSignature* rootSignature = nullptr;
+
+    const D3D12_DESCRIPTOR_RANGE descRanges[]{
+        // t0 (for albedo), t1 (for normal), t2 (for depth), t3 (for lights)
+        {
+            .RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV,
+            .NumDescriptors = 4,
+            .BaseShaderRegister = 0,
+            .RegisterSpace = 0,
+            .OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND
+        },
+        // u0 (for pixel shader invocation counters)
+        {
+            .RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV,
+            .NumDescriptors = 1,
+            .BaseShaderRegister = 0,
+            .RegisterSpace = 0,
+            .OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND
+        }
+    };
+
+    const D3D12_ROOT_PARAMETER rootParameters[]{
+        // t0 ~ t3
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE,
+            .DescriptorTable {
+                .NumDescriptorRanges = 1,
+                .pDescriptorRanges = &descRanges[0]
+            },
+            // The light buffer is accessed in a vertex shader and a pixel shader
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        // u0
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE,
+            .DescriptorTable {
+                .NumDescriptorRanges = 1,
+                .pDescriptorRanges = &descRanges[1]
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL
+        },
+        // b0 (for the light index and the counter index)
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+            .Constants {
+                .ShaderRegister = 0,
+                .RegisterSpace = 0,
+                .Num32BitValues = 2
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        }
+    };
+
+    // Create a root signature.
+    const D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc{
+        .NumParameters = (UINT)std::size(rootParameters),
+        .pParameters = rootParameters,
+        .NumStaticSamplers = 0,
+        .pStaticSamplers = nullptr,
+        .Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_AMPLIFICATION_SHADER_ROOT_ACCESS | D3D12_ROOT_SIGNATURE_FLAG_DENY_MESH_SHADER_ROOT_ACCESS
+    };
+
+    ID3DBlob* signature = nullptr;
+    ID3DBlob* error = nullptr;
+    HRESULT hRes = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error);
+    do
+    {
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "D3D12SerializeRootSignature for deferred lighting failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateRootSignature for deferred lighting failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (signature != nullptr) {
+        signature->Release();
+    }
+    if (error != nullptr) {
+        error->Release();
+    }
+
+    if (FAILED(hRes)) return nullptr;
+
+    return rootSignature;
+}
+
+// @return [gBufferPipelineState, lightPipelineState]
+static auto CreatePipelineStateObjectsForDeferredLighting(ID3D12Device2* d3d_device, ID3D12RootSignature* rootSignature, bool supportDepthBounds) ->
+                                                        std::pair<ID3D12PipelineState*, ID3D12PipelineState*>
+{
+    ID3D12PipelineState* gBufferPipelineState = nullptr;
+    ID3D12PipelineState* lightPipelineState = nullptr;
+
+    D3D12_SHADER_BYTECODE gBufferVertexShaderObj = CreateCompiledShaderObjectFromPath("cso/deferred_gbuffer.vert.cso");
+    D3D12_SHADER_BYTECODE gBufferPixelShaderObj = CreateCompiledShaderObjectFromPath("cso/deferred_gbuffer.frag.cso");
+    D3D12_SHADER_BYTECODE lightVertexShaderObj = CreateCompiledShaderObjectFromPath("cso/deferred_light.vert.cso");
+    D3D12_SHADER_BYTECODE lightPixelShaderObj = CreateCompiledShaderObjectFromPath("cso/deferred_light.frag.cso");
+
+    do
+    {
+        if (gBufferVertexShaderObj.pShaderBytecode == nullptr || gBufferVertexShaderObj.BytecodeLength == 0) break;
+        if (gBufferPixelShaderObj.pShaderBytecode == nullptr || gBufferPixelShaderObj.BytecodeLength == 0) break;
+        if (lightVertexShaderObj.pShaderBytecode == nullptr || lightVertexShaderObj.BytecodeLength == 0) break;
+        if (lightPixelShaderObj.pShaderBytecode == nullptr || lightPixelShaderObj.BytecodeLength == 0) break;
+
+        const D3D12_INPUT_ELEMENT_DESC inputElementDescs[]{
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "NORMAL", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        const D3D12_RENDER_TARGET_BLEND_DESC opaqueBlendDesc{
+            .BlendEnable = FALSE,
+            .LogicOpEnable = FALSE,
+            .SrcBlend = D3D12_BLEND_ONE,
+            .DestBlend = D3D12_BLEND_ZERO,
+            .BlendOp = D3D12_BLEND_OP_ADD,
+            .SrcBlendAlpha = D3D12_BLEND_ONE,
+            .DestBlendAlpha = D3D12_BLEND_ZERO,
+            .BlendOpAlpha = D3D12_BLEND_OP_ADD,
+            .LogicOp = D3D12_LOGIC_OP_NOOP,
+            .RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL
+        };
+
+        const D3D12_RASTERIZER_DESC rasterizerDesc{
+            .FillMode = D3D12_FILL_MODE_SOLID,
+            .CullMode = D3D12_CULL_MODE_NONE,
+            .FrontCounterClockwise = FALSE,
+            .DepthBias = 0,
+            .DepthBiasClamp = 0.0f,
+            .SlopeScaledDepthBias = 0.0f,
+            .DepthClipEnable = TRUE,
+            .MultisampleEnable = FALSE,
+            .AntialiasedLineEnable = FALSE,
+            .ForcedSampleCount = 0,
+            .ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF
+        };
+
+        // G-buffer pass: albedo and view-space normal
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC gBufferPSODesc{
+            .pRootSignature = rootSignature,
+            .VS = gBufferVertexShaderObj,
+            .PS = gBufferPixelShaderObj,
+            .BlendState {
+                .AlphaToCoverageEnable = FALSE,
+                .IndependentBlendEnable = FALSE,
+                .RenderTarget { opaqueBlendDesc, opaqueBlendDesc }
+            },
+            .SampleMask = UINT32_MAX,
+            .RasterizerState = rasterizerDesc,
+            .DepthStencilState {
+                .DepthEnable = TRUE,
+                .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL,
+                .DepthFunc = D3D12_COMPARISON_FUNC_LESS,
+                .StencilEnable = FALSE,
+                .StencilReadMask = 0,
+                .StencilWriteMask = 0,
+                .FrontFace { },
+                .BackFace { }
+            },
+            .InputLayout {
+                .pInputElementDescs = inputElementDescs,
+                .NumElements = (UINT)std::size(inputElementDescs)
+            },
+            .IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED,
+            .PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+            .NumRenderTargets = 2,
+            .RTVFormats { DEFERRED_ALBEDO_FORMAT, DEFERRED_NORMAL_FORMAT },
+            .DSVFormat = DXGI_FORMAT_D32_FLOAT,
+            .SampleDesc {
+                .Count = 1,
+                .Quality = 0
+            },
+            .NodeMask = 0,
+            .CachedPSO { },
+            .Flags = D3D12_PIPELINE_STATE_FLAG_NONE
+        };
+
+        HRESULT hRes = d3d_device->CreateGraphicsPipelineState(&gBufferPSODesc, IID_PPV_ARGS(&gBufferPipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateGraphicsPipelineState for G-buffer PSO failed: %ld\n", hRes);
+            break;
+        }
+
+        // Light pass: additive blending into the light accumulation target.
+        // The depth bounds test needs D3D12_DEPTH_STENCIL_DESC1, which is only available in a pipeline state stream.
+        struct {
+            RootSignatureSubobject rootSignatureSubobject;
+            ShaderByteCodeSubobject vsShaderSubobject;
+            ShaderByteCodeSubobject psShaderSubobject;
+            BlendStateSubobject blendStateSubobject;
+            SampleMaskSubobject sampleMaskSubobject;
+            RasterizerStateSubobject raterizerStateSubobject;
+            DepthStencil1Subobject depthStencilSubobject;
+            PrimitiveTopologyTypeSubobject primitiveTopologySubobject;
+            RenderTargetFormatsSubobject renderTargetFormatsSubobject;
+            DepthStencilViewFormat depthStencilViewFormatSubobject;
+            SampleDescSubobject sampleDescSubobject;
+        } psoStream {
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_ROOT_SIGNATURE, rootSignature },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_VS, lightVertexShaderObj },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PS, lightPixelShaderObj },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_BLEND, {
+                    .AlphaToCoverageEnable = FALSE,
+                    .IndependentBlendEnable = FALSE,
+                    .RenderTarget {
+                        // RenderTarget[0]
+                        {
+                            .BlendEnable = TRUE,
+                            .LogicOpEnable = FALSE,
+                            .SrcBlend = D3D12_BLEND_ONE,
+                            .DestBlend = D3D12_BLEND_ONE,
+                            .BlendOp = D3D12_BLEND_OP_ADD,
+                            .SrcBlendAlpha = D3D12_BLEND_ONE,
+                            .DestBlendAlpha = D3D12_BLEND_ZERO,
+                            .BlendOpAlpha = D3D12_BLEND_OP_ADD,
+                            .LogicOp = D3D12_LOGIC_OP_NOOP,
+                            .RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL
+                        }
+                    }
+                }
+            },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_MASK, UINT32_MAX },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RASTERIZER, rasterizerDesc },
+            // The depth test always passes, only the depth bounds test rejects pixels. The depth buffer is read-only.
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL1, {
+                    .DepthEnable = TRUE,
+                    .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO,
+                    .DepthFunc = D3D12_COMPARISON_FUNC_ALWAYS,
+                    .StencilEnable = FALSE,
+                    .StencilReadMask = 0,
+                    .StencilWriteMask = 0,
+                    .FrontFace { },
+                    .BackFace { },
+                    .DepthBoundsTestEnable = supportDepthBounds
+                }
+            },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PRIMITIVE_TOPOLOGY, D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RENDER_TARGET_FORMATS, {
+                    .RTFormats {
+                        // RTVFormats[0]
+                        { DEFERRED_LIGHT_ACCUMULATION_FORMAT }
+                    },
+                    .NumRenderTargets = 1
+                }
+            },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL_FORMAT, DXGI_FORMAT_D32_FLOAT },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_DESC, {
+                    .Count = 1,
+                    .Quality = 0
+                }
+            }
+        };
+
+        const D3D12_PIPELINE_STATE_STREAM_DESC streamDesc{
+            .SizeInBytes = sizeof(psoStream),
+            .pPipelineStateSubobjectStream = &psoStream
+        };
+
+        hRes = d3d_device->CreatePipelineState(&streamDesc, IID_PPV_ARGS(&lightPipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreatePipelineState for light PSO failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (gBufferVertexShaderObj.pShaderBytecode != nullptr) {
+        free((void*)gBufferVertexShaderObj.pShaderBytecode);
+    }
+    if (gBufferPixelShaderObj.pShaderBytecode != nullptr) {
+        free((void*)gBufferPixelShaderObj.pShaderBytecode);
+    }
+    if (lightVertexShaderObj.pShaderBytecode != nullptr) {
+        free((void*)lightVertexShaderObj.pShaderBytecode);
+    }
+    if (lightPixelShaderObj.pShaderBytecode != nullptr) {
+        free((void*)lightPixelShaderObj.pShaderBytecode);
+    }
+
+    return std::make_pair(gBufferPipelineState, lightPipelineState);
+}
+
+// Renders the G-buffer of the deferred lighting scene, then draws one screen-space rectangle per light.
+// With depth bounds, each light draw only shades the pixels whose G-buffer depth is inside the light's depth range.
+// In benchmark mode, the light pass is rendered without and with depth bounds and the invocation counts and GPU time are compared.
+static auto RunDeferredLightingBenchmark(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, bool supportDepthBounds) -> bool
+{
+    const std::vector<DeferredVertex> sceneVertices = CreateDeferredLightingScene();
+    const UINT vertexBufferSize = UINT(sceneVertices.size() * sizeof(sceneVertices[0]));
+
+    // Random lights around the scene surfaces
+    std::vector<DeferredLightInfo> lights;
+    std::vector<std::pair<float, float>> lightDepthBounds;
+    lights.reserve(DEFERRED_LIGHT_COUNT);
+    lightDepthBounds.reserve(DEFERRED_LIGHT_COUNT);
+
+    uint32_t randomSeed = 0x12345678U;
+    auto const nextRandom = [&randomSeed]() -> float {
+        randomSeed = randomSeed * 1664525U + 1013904223U;
+        return float(randomSeed >> 8) / float(1U << 24);
+    };
+
+    UINT culledLightCount = 0;
+    for (UINT i = 0; i < DEFERRED_LIGHT_COUNT; ++i)
+    {
+        DeferredLightInfo light{
+            .position { -4.0f + 8.0f * nextRandom(), -1.0f + 3.5f * nextRandom(), -1.5f - 7.0f * nextRandom() },
+            .radius = 0.2f + 0.4f * nextRandom(),
+            .color { 0.2f + 0.8f * nextRandom(), 0.2f + 0.8f * nextRandom(), 0.2f + 0.8f * nextRandom() },
+            .paddings = 0.0f,
+            .rect { }
+        };
+
+        float minDepth = 0.0f, maxDepth = 1.0f;
+        if (!ComputeDeferredLightVolume(light, minDepth, maxDepth))
+        {
+            ++culledLightCount;
+            continue;
+        }
+
+        lights.push_back(light);
+        lightDepthBounds.push_back(std::make_pair(minDepth, maxDepth));
+    }
+
+    const UINT lightCount = UINT(lights.size());
+    const UINT lightBufferSize = lightCount * UINT(sizeof(DeferredLightInfo));
+
+    // counters[0]: invocations without depth bounds, counters[1]: invocations with depth bounds
+    constexpr UINT counterBufferSize = 4U * sizeof(UINT);
+    constexpr UINT timestampCount = 4U;
+
+    ID3D12RootSignature* rootSignature = nullptr;
+    ID3D12PipelineState* gBufferPipelineState = nullptr;
+    ID3D12PipelineState* lightPipelineState = nullptr;
+    ID3D12GraphicsCommandList* commandList = nullptr;
+    ID3D12DescriptorHeap* rtvDescriptorHeap = nullptr;
+    ID3D12DescriptorHeap* dsvDescriptorHeap = nullptr;
+    ID3D12DescriptorHeap* descriptorHeap = nullptr;
+    ID3D12QueryHeap* queryHeap = nullptr;
+    ID3D12Resource* albedoTexture = nullptr;
+    ID3D12Resource* normalTexture = nullptr;
+    ID3D12Resource* lightAccumulationTexture = nullptr;
+    ID3D12Resource* depthTexture = nullptr;
+    ID3D12Resource* uploadDevHostBuffer = nullptr;
+    ID3D12Resource* vertexBuffer = nullptr;
+    ID3D12Resource* lightBuffer = nullptr;
+    ID3D12Resource* counterBuffer = nullptr;
+    ID3D12Resource* readbackDevHostBuffer = nullptr;
+    bool success = false;
+
+    do
+    {
+        if (lightCount == 0) break;
+
+        rootSignature = CreateRootSignatureForDeferredLighting(d3d_device);
+        if (rootSignature == nullptr) break;
+
+        auto const pipelineResult = CreatePipelineStateObjectsForDeferredLighting((ID3D12Device2*)d3d_device, rootSignature, supportDepthBounds);
+        gBufferPipelineState = pipelineResult.first;
+        lightPipelineState = pipelineResult.second;
+        if (gBufferPipelineState == nullptr || lightPipelineState == nullptr) break;
+
+        HRESULT hRes = commandAllocator->Reset();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Reset command allocator for deferred lighting failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator, gBufferPipelineState, IID_PPV_ARGS(&commandList));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommandList for deferred lighting failed: %ld\n", hRes);
+            break;
+        }
+
+        // RTVs: albedo, normal, light accumulation
+        const D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc{
+            .Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV,
+            .NumDescriptors = 3,
+            .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
+            .NodeMask = 0
+        };
+        hRes = d3d_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&rtvDescriptorHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateDescriptorHeap for deferred lighting render target views failed: %ld\n", hRes);
+            break;
+        }
+
+        // DSVs: writable for the G-buffer pass, read-only for the light pass
+        const D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc{
+            .Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV,
+            .NumDescriptors = 2,
+            .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
+            .NodeMask = 0
+        };
+        hRes = d3d_device->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&dsvDescriptorHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateDescriptorHeap for deferred lighting depth stencil views failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc{
+            .Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+            .NumDescriptors = DEFERRED_SLOT_COUNT,
+            .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE,
+            .NodeMask = 0
+        };
+        hRes = d3d_device->CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(&descriptorHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateDescriptorHeap for deferred lighting failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_QUERY_HEAP_DESC queryHeapDesc{
+            .Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP,
+            .Count = timestampCount,
+            .NodeMask = 0U
+        };
+        hRes = d3d_device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&queryHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateQueryHeap for deferred lighting failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+            .Type = D3D12_HEAP_TYPE_DEFAULT,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
+
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = defaultHeapProperties;
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_HEAP_PROPERTIES readbackHeapProperties = defaultHeapProperties;
+        readbackHeapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+        D3D12_RESOURCE_DESC textureDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
+            .Alignment = 0,
+            .Width = DEFERRED_LIGHTING_TARGET_SIZE,
+            .Height = DEFERRED_LIGHTING_TARGET_SIZE,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DEFERRED_ALBEDO_FORMAT,
+            .SampleDesc {.Count = 1U, .Quality = 0U },
+            .Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN,
+            .Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET
+        };
+
+        D3D12_CLEAR_VALUE clearValue{
+            .Format = DEFERRED_ALBEDO_FORMAT,
+            .Color { 0.0f, 0.0f, 0.0f, 0.0f }
+        };
+
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, D3D12_RESOURCE_STATE_RENDER_TARGET,
+                                                &clearValue, IID_PPV_ARGS(&albedoTexture));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for albedo texture failed: %ld\n", hRes);
+            break;
+        }
+
+        textureDesc.Format = clearValue.Format = DEFERRED_NORMAL_FORMAT;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, D3D12_RESOURCE_STATE_RENDER_TARGET,
+                                                &clearValue, IID_PPV_ARGS(&normalTexture));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for normal texture failed: %ld\n", hRes);
+            break;
+        }
+
+        textureDesc.Format = clearValue.Format = DEFERRED_LIGHT_ACCUMULATION_FORMAT;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, D3D12_RESOURCE_STATE_RENDER_TARGET,
+                                                &clearValue, IID_PPV_ARGS(&lightAccumulationTexture));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for light accumulation texture failed: %ld\n", hRes);
+            break;
+        }
+
+        textureDesc.Format = DXGI_FORMAT_D32_FLOAT;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+        const D3D12_CLEAR_VALUE depthClearValue{
+            .Format = DXGI_FORMAT_D32_FLOAT,
+            .DepthStencil { .Depth = 1.0f, .Stencil = 0U }
+        };
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, D3D12_RESOURCE_STATE_DEPTH_WRITE,
+                                                &depthClearValue, IID_PPV_ARGS(&depthTexture));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for deferred lighting depth texture failed: %ld\n", hRes);
+            break;
+        }
+
+        D3D12_RESOURCE_DESC bufferDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0,
+            .Width = vertexBufferSize,
+            .Height = 1U,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {.Count = 1U, .Quality = 0 },
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE
+        };
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&vertexBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for deferred lighting vertex buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = lightBufferSize;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&lightBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for light buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        // Scene vertices, lights and the zero-initialized counters
+        bufferDesc.Width = vertexBufferSize + lightBufferSize + counterBufferSize;
+        hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadDevHostBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for deferred lighting upload buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = counterBufferSize;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&counterBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for deferred lighting counter buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        // The counters followed by the timestamps
+        bufferDesc.Width = counterBufferSize + timestampCount * sizeof(UINT64);
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&readbackDevHostBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for deferred lighting read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        void* hostMemPtr = nullptr;
+        hRes = uploadDevHostBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map deferred lighting upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        memcpy(hostMemPtr, sceneVertices.data(), vertexBufferSize);
+        memcpy((void*)(uintptr_t(hostMemPtr) + vertexBufferSize), lights.data(), lightBufferSize);
+        memset((void*)(uintptr_t(hostMemPtr) + vertexBufferSize + lightBufferSize), 0, counterBufferSize);
+        uploadDevHostBuffer->Unmap(0, nullptr);
+
+        // Create the views
+        const UINT rtvDescriptorSize = d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandles[3]{ rtvDescriptorHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandles[1].ptr = rtvHandles[0].ptr + rtvDescriptorSize;
+        rtvHandles[2].ptr = rtvHandles[1].ptr + rtvDescriptorSize;
+        d3d_device->CreateRenderTargetView(albedoTexture, nullptr, rtvHandles[0]);
+        d3d_device->CreateRenderTargetView(normalTexture, nullptr, rtvHandles[1]);
+        d3d_device->CreateRenderTargetView(lightAccumulationTexture, nullptr, rtvHandles[2]);
+
+        D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc{
+            .Format = DXGI_FORMAT_D32_FLOAT,
+            .ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D,
+            .Flags = D3D12_DSV_FLAG_NONE,
+            .Texture2D { .MipSlice = 0 }
+        };
+        D3D12_CPU_DESCRIPTOR_HANDLE dsvHandles[2]{ dsvDescriptorHeap->GetCPUDescriptorHandleForHeapStart() };
+        dsvHandles[1].ptr = dsvHandles[0].ptr + d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
+        d3d_device->CreateDepthStencilView(depthTexture, &dsvDesc, dsvHandles[0]);
+        dsvDesc.Flags = D3D12_DSV_FLAG_READ_ONLY_DEPTH;
+        d3d_device->CreateDepthStencilView(depthTexture, &dsvDesc, dsvHandles[1]);
+
+        const UINT descriptorIncrSize = d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        const D3D12_CPU_DESCRIPTOR_HANDLE cpuDescHandleStart = descriptorHeap->GetCPUDescriptorHandleForHeapStart();
+        D3D12_CPU_DESCRIPTOR_HANDLE cpuDescHandle = cpuDescHandleStart;
+
+        D3D12_SHADER_RESOURCE_VIEW_DESC textureSRVDesc{
+            .Format = DEFERRED_ALBEDO_FORMAT,
+            .ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D,
+            .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+            .Texture2D {
+                .MostDetailedMip = 0,
+                .MipLevels = 1,
+                .PlaneSlice = 0,
+                .ResourceMinLODClamp = 0.0f
+            }
+        };
+        cpuDescHandle.ptr = cpuDescHandleStart.ptr + DEFERRED_SRV_ALBEDO_SLOT * descriptorIncrSize;
+        d3d_device->CreateShaderResourceView(albedoTexture, &textureSRVDesc, cpuDescHandle);
+
+        textureSRVDesc.Format = DEFERRED_NORMAL_FORMAT;
+        cpuDescHandle.ptr = cpuDescHandleStart.ptr + DEFERRED_SRV_NORMAL_SLOT * descriptorIncrSize;
+        d3d_device->CreateShaderResourceView(normalTexture, &textureSRVDesc, cpuDescHandle);
+
+        textureSRVDesc.Format = DXGI_FORMAT_R32_FLOAT;
+        cpuDescHandle.ptr = cpuDescHandleStart.ptr + DEFERRED_SRV_DEPTH_SLOT * descriptorIncrSize;
+        d3d_device->CreateShaderResourceView(depthTexture, &textureSRVDesc, cpuDescHandle);
+
+        const D3D12_SHADER_RESOURCE_VIEW_DESC lightSRVDesc{
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .ViewDimension = D3D12_SRV_DIMENSION_BUFFER,
+            .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+            .Buffer {
+                .FirstElement = 0,
+                .NumElements = lightCount,
+                .StructureByteStride = UINT(sizeof(DeferredLightInfo)),
+                .Flags = D3D12_BUFFER_SRV_FLAG_NONE
+            }
+        };
+        cpuDescHandle.ptr = cpuDescHandleStart.ptr + DEFERRED_SRV_LIGHTS_SLOT * descriptorIncrSize;
+        d3d_device->CreateShaderResourceView(lightBuffer, &lightSRVDesc, cpuDescHandle);
+
+        const D3D12_UNORDERED_ACCESS_VIEW_DESC counterUAVDesc{
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .ViewDimension = D3D12_UAV_DIMENSION_BUFFER,
+            .Buffer {
+                .FirstElement = 0,
+                .NumElements = counterBufferSize / UINT(sizeof(UINT)),
+                .StructureByteStride = UINT(sizeof(UINT)),
+                .CounterOffsetInBytes = 0,
+                .Flags = D3D12_BUFFER_UAV_FLAG_NONE
+            }
+        };
+        cpuDescHandle.ptr = cpuDescHandleStart.ptr + DEFERRED_UAV_COUNTER_SLOT * descriptorIncrSize;
+        d3d_device->CreateUnorderedAccessView(counterBuffer, nullptr, &counterUAVDesc, cpuDescHandle);
+
+        // Upload the scene, the lights and clear the counters
+        WriteToDeviceResourceAndSync(commandList, vertexBuffer, uploadDevHostBuffer, 0U, 0U, vertexBufferSize);
+        WriteToDeviceResourceAndSync(commandList, lightBuffer, uploadDevHostBuffer, 0U, vertexBufferSize, lightBufferSize);
+        WriteToDeviceResourceAndSync(commandList, counterBuffer, uploadDevHostBuffer, 0U, vertexBufferSize + lightBufferSize, counterBufferSize);
+
+        const D3D12_RESOURCE_BARRIER counterBarrier{
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .Transition {
+                .pResource = counterBuffer,
+                .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                .StateBefore = D3D12_RESOURCE_STATE_GENERIC_READ,
+                .StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+            }
+        };
+        commandList->ResourceBarrier(1U, &counterBarrier);
+
+        const D3D12_VIEWPORT viewPort{
+            .TopLeftX = 0.0f,
+            .TopLeftY = 0.0f,
+            .Width = FLOAT(DEFERRED_LIGHTING_TARGET_SIZE),
+            .Height = FLOAT(DEFERRED_LIGHTING_TARGET_SIZE),
+            .MinDepth = 0.0f,
+            .MaxDepth = 1.0f
+        };
+        commandList->RSSetViewports(1, &viewPort);
+
+        const D3D12_RECT scissorRect{
+            .left = 0,
+            .top = 0,
+            .right = LONG(DEFERRED_LIGHTING_TARGET_SIZE),
+            .bottom = LONG(DEFERRED_LIGHTING_TARGET_SIZE)
+        };
+        commandList->RSSetScissorRects(1, &scissorRect);
+
+        ID3D12DescriptorHeap* const descHeaps[]{ descriptorHeap };
+        commandList->SetDescriptorHeaps(UINT(std::size(descHeaps)), descHeaps);
+        commandList->SetGraphicsRootSignature(rootSignature);
+
+        D3D12_GPU_DESCRIPTOR_HANDLE srvGPUDescHandle = descriptorHeap->GetGPUDescriptorHandleForHeapStart();
+        D3D12_GPU_DESCRIPTOR_HANDLE uavGPUDescHandle = srvGPUDescHandle;
+        srvGPUDescHandle.ptr += DEFERRED_SRV_ALBEDO_SLOT * descriptorIncrSize;
+        uavGPUDescHandle.ptr += DEFERRED_UAV_COUNTER_SLOT * descriptorIncrSize;
+        commandList->SetGraphicsRootDescriptorTable(0, srvGPUDescHandle);   // rootParameters[0]
+        commandList->SetGraphicsRootDescriptorTable(1, uavGPUDescHandle);   // rootParameters[1]
+
+        // G-buffer pass
+        const float clearColor[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        commandList->OMSetRenderTargets(2, rtvHandles, FALSE, &dsvHandles[0]);
+        commandList->ClearRenderTargetView(rtvHandles[0], clearColor, 0, nullptr);
+        commandList->ClearRenderTargetView(rtvHandles[1], clearColor, 0, nullptr);
+        commandList->ClearDepthStencilView(dsvHandles[0], D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+
+        const D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
+            .BufferLocation = vertexBuffer->GetGPUVirtualAddress(),
+            .SizeInBytes = vertexBufferSize,
+            .StrideInBytes = UINT(sizeof(DeferredVertex))
+        };
+        commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+        commandList->DrawInstanced(UINT(sceneVertices.size()), 1U, 0U, 0U);
+
+        const D3D12_RESOURCE_BARRIER gBufferBarriers[]{
+            {
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = albedoTexture,
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET,
+                    .StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+                }
+            },
+            {
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = normalTexture,
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET,
+                    .StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+                }
+            },
+            // The depth buffer is bound as a read-only DSV for the depth bounds test and read as an SRV at the same time
+            {
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = depthTexture,
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_DEPTH_WRITE,
+                    .StateAfter = D3D12_RESOURCE_STATE_DEPTH_READ | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+                }
+            }
+        };
+        commandList->ResourceBarrier(UINT(std::size(gBufferBarriers)), gBufferBarriers);
+
+        // Light passes: [0] without depth bounds, [1] with depth bounds
+        commandList->SetPipelineState(lightPipelineState);
+        commandList->OMSetRenderTargets(1, &rtvHandles[2], FALSE, &dsvHandles[1]);
+        commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+
+        bool passEnabled[2] = { DEFERRED_LIGHTING_BENCHMARK != 0 || !supportDepthBounds, supportDepthBounds };
+        for (UINT pass = 0; pass < 2U; ++pass)
+        {
+            if (!passEnabled[pass]) continue;
+
+            const bool useDepthBounds = pass == 1U;
+
+            commandList->ClearRenderTargetView(rtvHandles[2], clearColor, 0, nullptr);
+            commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, pass * 2U);
+
+            if (supportDepthBounds && !useDepthBounds) {
+                ((ID3D12GraphicsCommandList1*)commandList)->OMSetDepthBounds(0.0f, 1.0f);
+            }
+
+            commandList->SetGraphicsRoot32BitConstant(2U, pass, 1U);      // rootParameters[2]: counter index
+            for (UINT lightIndex = 0; lightIndex < lightCount; ++lightIndex)
+            {
+                if (useDepthBounds) {
+                    ((ID3D12GraphicsCommandList1*)commandList)->OMSetDepthBounds(lightDepthBounds[lightIndex].first, lightDepthBounds[lightIndex].second);
+                }
+                commandList->SetGraphicsRoot32BitConstant(2U, lightIndex, 0U);  // rootParameters[2]: light index
+                commandList->DrawInstanced(4U, 1U, 0U, 0U);
+            }
+
+            commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, pass * 2U + 1U);
+        }
+
+        // Read back the counters and the timestamps
+        const D3D12_RESOURCE_BARRIER copyBarrier{
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .Transition {
+                .pResource = counterBuffer,
+                .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                .StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+                .StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE
+            }
+        };
+        commandList->ResourceBarrier(1U, &copyBarrier);
+        commandList->CopyBufferRegion(readbackDevHostBuffer, 0U, counterBuffer, 0U, counterBufferSize);
+        commandList->ResolveQueryData(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0U, timestampCount, readbackDevHostBuffer, counterBufferSize);
+
+        hRes = commandList->Close();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Close deferred lighting command list failed: %ld\n", hRes);
+            break;
+        }
+
+        ID3D12CommandList* const ppCommandLists[] = { (ID3D12CommandList*)commandList };
+        commandQueue->ExecuteCommandLists((UINT)std::size(ppCommandLists), ppCommandLists);
+
+        if (!WaitForPreviousFrame(commandQueue)) break;
+
+        UINT64 timestampFrequency = 0;
+        hRes = commandQueue->GetTimestampFrequency(&timestampFrequency);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "GetTimestampFrequency failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = readbackDevHostBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map deferred lighting read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        const UINT* counters = (const UINT*)hostMemPtr;
+        const UINT64* timestamps = (const UINT64*)(uintptr_t(hostMemPtr) + counterBufferSize);
+
+        printf("Deferred lighting: %u lights drawn, %u lights outside the view frustum, depth bounds test %s\n",
+                lightCount, culledLightCount, supportDepthBounds ? "supported" : "NOT supported");
+
+        double passTimes[2]{ };
+        for (UINT pass = 0; pass < 2U; ++pass)
+        {
+            if (!passEnabled[pass]) continue;
+
+            passTimes[pass] = double(timestamps[pass * 2U + 1U] - timestamps[pass * 2U]) * 1000.0 / double(timestampFrequency);
+            printf("    light pass %s depth bounds: %u pixel shader invocations, %.3f ms\n", pass == 1U ? "with" : "without", counters[pass], passTimes[pass]);
+        }
+
+        if (passEnabled[0] && passEnabled[1] && counters[0] > 0U && passTimes[1] > 0.0)
+        {
+            printf("    depth bounds rejected %.1f%% of the invocations, speedup: %.2fx\n",
+                    100.0 - double(counters[1]) * 100.0 / double(counters[0]), passTimes[0] / passTimes[1]);
+        }
+
+        readbackDevHostBuffer->Unmap(0, nullptr);
+
+        success = true;
+    }
+    while (false);
+
+    if (rootSignature != nullptr) {
+        rootSignature->Release();
+    }
+    if (gBufferPipelineState != nullptr) {
+        gBufferPipelineState->Release();
+    }
+    if (lightPipelineState != nullptr) {
+        lightPipelineState->Release();
+    }
+    if (commandList != nullptr) {
+        commandList->Release();
+    }
+    if (rtvDescriptorHeap != nullptr) {
+        rtvDescriptorHeap->Release();
+    }
+    if (dsvDescriptorHeap != nullptr) {
+        dsvDescriptorHeap->Release();
+    }
+    if (descriptorHeap != nullptr) {
+        descriptorHeap->Release();
+    }
+    if (queryHeap != nullptr) {
+        queryHeap->Release();
+    }
+    if (albedoTexture != nullptr) {
+        albedoTexture->Release();
+    }
+    if (normalTexture != nullptr) {
+        normalTexture->Release();
+    }
+    if (lightAccumulationTexture != nullptr) {
+        lightAccumulationTexture->Release();
+    }
+    if (depthTexture != nullptr) {
+        depthTexture->Release();
+    }
+    if (uploadDevHostBuffer != nullptr) {
+        uploadDevHostBuffer->Release();
+    }
+    if (vertexBuffer != nullptr) {
+        vertexBuffer->Release();
+    }
+    if (lightBuffer != nullptr) {
+        lightBuffer->Release();
+    }
+    if (counterBuffer != nullptr) {
+        counterBuffer->Release();
+    }
+    if (readbackDevHostBuffer != nullptr) {
+        readbackDevHostBuffer->Release();
+    }
+
+    return success;
+}
+#endif
+
+auto CreateDepthBoundTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue *commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator,
+                                bool supportDepthBounds) ->
+                                    std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12DescriptorHeap*, ID3D12DescriptorHeap*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, bool>
+{
+    ID3D12RootSignature* rootSignature = nullptr;
+    ID3D12PipelineState* pipelineState = nullptr;
+    ID3D12PipelineState* computePipelineState = nullptr;
+    ID3D12GraphicsCommandList* commandList = nullptr;
+    ID3D12GraphicsCommandList* commandBundle = nullptr;
+    ID3D12GraphicsCommandList* computeCommandList = nullptr;
+    ID3D12GraphicsCommandList* computeCommandBundle = nullptr;
+    ID3D12DescriptorHeap* rtvDescriptorHeap = nullptr;
+    ID3D12DescriptorHeap* dsvDescriptorHeap = nullptr;
+    ID3D12DescriptorHeap* cbv_uavDescriptorHeap = nullptr;
+    ID3D12Resource* uploadDevHostBuffer = nullptr;
+    ID3D12Resource* vertexBuffer = nullptr;
+    ID3D12Resource* rtTexture = nullptr;
+    ID3D12Resource* dsTexture = nullptr;
+    ID3D12Resource* resolvedRTTexture = nullptr;
+    ID3D12Resource* resolvedDSTexture = nullptr;
+    ID3D12Resource* uavBuffer = nullptr;
+    ID3D12Resource* uavCompOutBuffer = nullptr;
+    ID3D12Resource* readbackDevHostBuffer = nullptr;
+    ID3D12Resource* readBackTextureHostBuffer = nullptr;
+    bool success = false;
+
+    auto result = std::make_tuple(rootSignature, pipelineState, commandList, commandBundle, cbv_uavDescriptorHeap, rtvDescriptorHeap, uploadDevHostBuffer, vertexBuffer, rtTexture, success);
+
+    rootSignature = CreateRootSignature(d3d_device);
+    if (rootSignature == nullptr) return result;
+
+    auto const rtTexRes = CreateRenderTargetViewForTexture(d3d_device);
+    rtvDescriptorHeap = std::get<0>(rtTexRes);
+    dsvDescriptorHeap = std::get<1>(rtTexRes);
+    rtTexture = std::get<2>(rtTexRes);
+    dsTexture = std::get<3>(rtTexRes);
+    resolvedRTTexture = std::get<4>(rtTexRes);
+    resolvedDSTexture = std::get<5>(rtTexRes);
+
+    auto const pipelineResult = CreatePipelineStateObjectForRenderTexture(d3d_device, commandAllocator, commandBundleAllocator, rootSignature);
+    pipelineState = std::get<0>(pipelineResult);
+    commandList = std::get<1>(pipelineResult);
+    commandBundle = std::get<2>(pipelineResult);
+    cbv_uavDescriptorHeap = std::get<3>(pipelineResult);
+
+    auto const renderVertexBufferResult = CreateVertexBufferForRenderTexture(d3d_device, rootSignature, commandQueue, commandList, commandBundle, cbv_uavDescriptorHeap);
+    uploadDevHostBuffer = std::get<0>(renderVertexBufferResult);
+    vertexBuffer = std::get<1>(renderVertexBufferResult);
+    uavBuffer = std::get<2>(renderVertexBufferResult);
+    readbackDevHostBuffer = std::get<3>(renderVertexBufferResult);
+    readBackTextureHostBuffer = std::get<4>(renderVertexBufferResult);
+    uavCompOutBuffer = std::get<5>(renderVertexBufferResult);
+
+    do
+    {
+        if (!ResetCommandAllocatorAndList(commandAllocator, commandList, pipelineState)) break;
+
+        if (!PopulateCommandList(commandBundle, commandList, rtvDescriptorHeap, dsvDescriptorHeap, cbv_uavDescriptorHeap,
+                                rtTexture, dsTexture, resolvedRTTexture, resolvedDSTexture, uavBuffer, readbackDevHostBuffer)) break;
+
+        // Execute the command list.
+        ID3D12CommandList* const ppCommandLists[] = { (ID3D12CommandList*)commandList };
+        commandQueue->ExecuteCommandLists((UINT)std::size(ppCommandLists), ppCommandLists);
+
+        if (!WaitForPreviousFrame(commandQueue)) break;
+
+        // Read back the pixel shader invocation count
+        unsigned* hostMemPtr = nullptr;
+        HRESULT hRes = readbackDevHostBuffer->Map(0, nullptr, (void**)&hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        printf("Current pixel shader invocation count: %u\n", *hostMemPtr);
+
+        readbackDevHostBuffer->Unmap(0, nullptr);
+
+#if TEST_HI_Z_CULLING
+        if (!RunHiZOcclusionCulling(d3d_device, commandQueue, commandAllocator, MSAA_RENDER_TARGET_NEED_RESOLVE ? resolvedDSTexture : dsTexture)) {
+            fprintf(stderr, "Hi-Z occlusion culling does not match the CPU reference!\n");
+        }
+#endif
+
+#if TEST_DEFERRED_LIGHTING
+        if (!RunDeferredLightingBenchmark(d3d_device, commandQueue, commandAllocator, supportDepthBounds)) {
+            fprintf(stderr, "Deferred lighting benchmark failed!\n");
+        }
+#endif
 
 #if OUTPUT_DEPTH_TEXTURE
         auto const result = CreatePipelineStateObjectForCompute(d3d_device, rootSignature, commandAllocator, commandBundleAllocator);
@@ -44,6 +44,7 @@ static bool s_needSetDescriptorHeapInDirectCommandList = false;
 static auto (*s_renderPostProcessFunc)() -> void = nullptr;
 static auto (*s_translateCallbackFunc)(const TranslationType&) -> void = nullptr;
 static auto (*s_fetchTranslationSetFunc)() -> CommonTranslationSet = nullptr;
+static auto (*s_writeConstantBufferFunc)(void*) -> void = nullptr;
 static auto (*s_executeIndirectCallFunc)(ID3D12GraphicsCommandList*, ID3D12CommandSignature*, ID3D12Resource*, ID3D12Resource*, UINT) -> void = nullptr;
 static UINT s_currCommandSignatureCount = 0U;
 
@@ -67,6 +68,10 @@ static float s_rotateAngle = 0.0f;
 static UINT s_render_width = 0U, s_render_height = 0U;
 static bool s_useMultiViewports = false;
 
+// Geometry Shader Test: s_commandBundles[0 ... s_viewportArrayPathCount - 1] render the same scene through different paths
+static const char* s_viewportArrayPathNames[3] { };
+static UINT s_viewportArrayPathCount = 0U;
+
 auto WriteToDeviceResourceAndSync(
     _In_ ID3D12GraphicsCommandList* pCmdList,
     _In_ ID3D12Resource* pDestinationResource,
@@ -168,6 +173,57 @@ auto WriteToDeviceTextureAndSync(
     pCmdList->ResourceBarrier(1, &endCopyBarrier);
 }
 
+auto WriteToDeviceTextureSubresourcesAndSync(
+    _In_ ID3D12GraphicsCommandList* pCmdList,
+    _In_ ID3D12Resource* pDestinationResource,
+    _In_ ID3D12Resource* pIntermediate,
+    UINT firstSubresource,
+    UINT subresourceCount,
+    _In_reads_(subresourceCount) const D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprints[]) -> void
+{
+    const D3D12_RESOURCE_BARRIER beginCopyBarrier = {
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .Transition {
+                .pResource = pDestinationResource,
+                .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                .StateBefore = D3D12_RESOURCE_STATE_COMMON,
+                .StateAfter = D3D12_RESOURCE_STATE_COPY_DEST
+            }
+    };
+    pCmdList->ResourceBarrier(1, &beginCopyBarrier);
+
+    // All the copies are recorded between one pair of barriers
+    for (UINT i = 0; i < subresourceCount; ++i)
+    {
+        const D3D12_TEXTURE_COPY_LOCATION dstLocation{
+            .pResource = pDestinationResource,
+            .Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+            .SubresourceIndex = firstSubresource + i
+        };
+
+        const D3D12_TEXTURE_COPY_LOCATION srcLocation{
+            .pResource = pIntermediate,
+            .Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+            .PlacedFootprint = footprints[i]
+        };
+
+        pCmdList->CopyTextureRegion(&dstLocation, 0U, 0U, 0U, &srcLocation, nullptr);
+    }
+
+    const D3D12_RESOURCE_BARRIER endCopyBarrier = {
+        .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+        .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+        .Transition {
+            .pResource = pDestinationResource,
+            .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+            .StateBefore = D3D12_RESOURCE_STATE_COPY_DEST,
+            .StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ
+        }
+    };
+    pCmdList->ResourceBarrier(1, &endCopyBarrier);
+}
+
 auto SyncAndReadFromDeviceResource(
     _In_ ID3D12GraphicsCommandList* pCmdList,
     size_t dataSize,
@@ -201,6 +257,224 @@ auto SyncAndReadFromDeviceResource(
     pCmdList->ResourceBarrier(1, &endCopyBarrier);
 }
 
+auto CreateOffscreenBenchmarkTarget(ID3D12Device* d3d_device, ID3D12CommandAllocator* commandAllocator, ID3D12PipelineState* initialPipelineState,
+                                    UINT width, UINT height, const FLOAT clearColor[4], UINT timestampCount, const char* benchmarkName,
+                                    OffscreenBenchmarkTarget& target) -> bool
+{
+    target = OffscreenBenchmarkTarget{ .width = width, .height = height, .timestampCount = timestampCount };
+
+    HRESULT hRes = commandAllocator->Reset();
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "Reset command allocator for %s failed: %ld\n", benchmarkName, hRes);
+        return false;
+    }
+
+    hRes = d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator, initialPipelineState, IID_PPV_ARGS(&target.commandList));
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CreateCommandList for %s failed: %ld\n", benchmarkName, hRes);
+        return false;
+    }
+
+    const D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc{
+        .Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV,
+        .NumDescriptors = 1,
+        .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
+        .NodeMask = 0
+    };
+    hRes = d3d_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&target.rtvDescriptorHeap));
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CreateDescriptorHeap for %s render target view failed: %ld\n", benchmarkName, hRes);
+        return false;
+    }
+
+    const D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc{
+        .Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV,
+        .NumDescriptors = 1,
+        .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
+        .NodeMask = 0
+    };
+    hRes = d3d_device->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&target.dsvDescriptorHeap));
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CreateDescriptorHeap for %s depth stencil view failed: %ld\n", benchmarkName, hRes);
+        return false;
+    }
+
+    const D3D12_QUERY_HEAP_DESC queryHeapDesc{
+        .Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP,
+        .Count = timestampCount,
+        .NodeMask = 0U
+    };
+    hRes = d3d_device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&target.queryHeap));
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CreateQueryHeap for %s failed: %ld\n", benchmarkName, hRes);
+        return false;
+    }
+
+    const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+        .Type = D3D12_HEAP_TYPE_DEFAULT,
+        .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+        .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+        .CreationNodeMask = 1,
+        .VisibleNodeMask = 1
+    };
+
+    D3D12_HEAP_PROPERTIES readbackHeapProperties = defaultHeapProperties;
+    readbackHeapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+    D3D12_RESOURCE_DESC textureDesc{
+        .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
+        .Alignment = 0,
+        .Width = width,
+        .Height = height,
+        .DepthOrArraySize = 1,
+        .MipLevels = 1,
+        .Format = RENDER_TARGET_BUFFER_FOMRAT,
+        .SampleDesc {.Count = 1U, .Quality = 0U },
+        .Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN,
+        .Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET
+    };
+
+    D3D12_CLEAR_VALUE clearValue{ .Format = RENDER_TARGET_BUFFER_FOMRAT };
+    std::copy(clearColor, clearColor + 4, clearValue.Color);
+
+    hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, D3D12_RESOURCE_STATE_RENDER_TARGET,
+                                            &clearValue, IID_PPV_ARGS(&target.renderTargetTexture));
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CreateCommittedResource for %s render target failed: %ld\n", benchmarkName, hRes);
+        return false;
+    }
+
+    textureDesc.Format = DXGI_FORMAT_D32_FLOAT;
+    textureDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL | D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
+    const D3D12_CLEAR_VALUE depthClearValue{
+        .Format = DXGI_FORMAT_D32_FLOAT,
+        .DepthStencil { .Depth = 1.0f, .Stencil = 0U }
+    };
+    hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, D3D12_RESOURCE_STATE_DEPTH_WRITE,
+                                            &depthClearValue, IID_PPV_ARGS(&target.depthTexture));
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CreateCommittedResource for %s depth texture failed: %ld\n", benchmarkName, hRes);
+        return false;
+    }
+
+    const D3D12_RESOURCE_DESC bufferDesc{
+        .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+        .Alignment = 0,
+        .Width = timestampCount * sizeof(UINT64),
+        .Height = 1U,
+        .DepthOrArraySize = 1,
+        .MipLevels = 1,
+        .Format = DXGI_FORMAT_UNKNOWN,
+        .SampleDesc {.Count = 1U, .Quality = 0 },
+        .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+        .Flags = D3D12_RESOURCE_FLAG_NONE
+    };
+    hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                            D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&target.timestampReadbackBuffer));
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CreateCommittedResource for %s timestamp read back buffer failed: %ld\n", benchmarkName, hRes);
+        return false;
+    }
+
+    target.rtvHandle = target.rtvDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
+    d3d_device->CreateRenderTargetView(target.renderTargetTexture, nullptr, target.rtvHandle);
+
+    const D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc{
+        .Format = DXGI_FORMAT_D32_FLOAT,
+        .ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D,
+        .Flags = D3D12_DSV_FLAG_NONE,
+        .Texture2D { .MipSlice = 0 }
+    };
+    target.dsvHandle = target.dsvDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
+    d3d_device->CreateDepthStencilView(target.depthTexture, &dsvDesc, target.dsvHandle);
+
+    return true;
+}
+
+auto SetOffscreenBenchmarkTarget(const OffscreenBenchmarkTarget& target) -> void
+{
+    const D3D12_VIEWPORT viewPort{
+        .TopLeftX = 0.0f,
+        .TopLeftY = 0.0f,
+        .Width = FLOAT(target.width),
+        .Height = FLOAT(target.height),
+        .MinDepth = 0.0f,
+        .MaxDepth = 1.0f
+    };
+    target.commandList->RSSetViewports(1, &viewPort);
+
+    const D3D12_RECT scissorRect{
+        .left = 0,
+        .top = 0,
+        .right = LONG(target.width),
+        .bottom = LONG(target.height)
+    };
+    target.commandList->RSSetScissorRects(1, &scissorRect);
+
+    target.commandList->OMSetRenderTargets(1, &target.rtvHandle, FALSE, &target.dsvHandle);
+}
+
+auto ExecuteOffscreenBenchmark(ID3D12CommandQueue* commandQueue, const OffscreenBenchmarkTarget& target, const char* benchmarkName, UINT64& timestampFrequency) -> bool
+{
+    target.commandList->ResolveQueryData(target.queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0U, target.timestampCount, target.timestampReadbackBuffer, 0U);
+
+    HRESULT hRes = target.commandList->Close();
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "Close %s command list failed: %ld\n", benchmarkName, hRes);
+        return false;
+    }
+
+    ID3D12CommandList* const ppCommandLists[] = { (ID3D12CommandList*)target.commandList };
+    commandQueue->ExecuteCommandLists((UINT)std::size(ppCommandLists), ppCommandLists);
+
+    if (!WaitForPreviousFrame(commandQueue)) return false;
+
+    hRes = commandQueue->GetTimestampFrequency(&timestampFrequency);
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "GetTimestampFrequency failed: %ld\n", hRes);
+        return false;
+    }
+
+    return true;
+}
+
+auto ReleaseOffscreenBenchmarkTarget(OffscreenBenchmarkTarget& target) -> void
+{
+    if (target.commandList != nullptr) {
+        target.commandList->Release();
+    }
+    if (target.rtvDescriptorHeap != nullptr) {
+        target.rtvDescriptorHeap->Release();
+    }
+    if (target.dsvDescriptorHeap != nullptr) {
+        target.dsvDescriptorHeap->Release();
+    }
+    if (target.queryHeap != nullptr) {
+        target.queryHeap->Release();
+    }
+    if (target.renderTargetTexture != nullptr) {
+        target.renderTargetTexture->Release();
+    }
+    if (target.depthTexture != nullptr) {
+        target.depthTexture->Release();
+    }
+    if (target.timestampReadbackBuffer != nullptr) {
+        target.timestampReadbackBuffer->Release();
+    }
+
+    target = OffscreenBenchmarkTarget{ };
+}
+
 static auto TransWStrToString(char dstBuf[], const WCHAR srcBuf[]) -> void
 {
     if (dstBuf == nullptr || srcBuf == nullptr) return;
@@ -1370,8 +1644,8 @@ static auto PopulateCommandList() -> bool
             return false;
         }
 
-        if (s_fetchTranslationSetFunc != nullptr) {
-            *(CommonTranslationSet*)hostMemPtr = s_fetchTranslationSetFunc();
+        if (s_writeConstantBufferFunc != nullptr) {
+            s_writeConstantBufferFunc(hostMemPtr);
         }
         else {
             *hostMemPtr = s_rotateAngle;
@@ -1399,7 +1673,7 @@ static auto PopulateCommandList() -> bool
         }
     }
 
-    if (needRotate && s_fetchTranslationSetFunc == nullptr)
+    if (needRotate && s_writeConstantBufferFunc == nullptr)
     {
         if (++s_rotateAngle >= 360.0f) {
             s_rotateAngle = 0.0f;
@@ -1799,6 +2073,16 @@ static auto CALLBACK WndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
         case VK_RETURN:
             s_needRotate = !s_needRotate;
             break;
+
+        case 'V':
+            // Geometry Shader Test: render the next path
+            if (s_viewportArrayPathCount > 1U)
+            {
+                std::rotate(s_commandBundles, s_commandBundles + 1, s_commandBundles + s_viewportArrayPathCount);
+                std::rotate(s_viewportArrayPathNames, s_viewportArrayPathNames + 1, s_viewportArrayPathNames + s_viewportArrayPathCount);
+                SetWindowTextA(hWnd, s_viewportArrayPathNames[0]);
+            }
+            break;
         }
 
         if (displayParams && s_fetchTranslationSetFunc != nullptr)
@@ -1884,6 +2168,11 @@ static auto RegisterFetchTranslationSetCallback(auto (*pCallbackFunc)() -> Commo
     s_fetchTranslationSetFunc = pCallbackFunc;
 }
 
+static auto RegisterWriteConstantBufferCallback(auto (*pCallbackFunc)(void* hostMemPtr) -> void) -> void
+{
+    s_writeConstantBufferFunc = pCallbackFunc;
+}
+
 auto main(int argc, const char* argv[]) -> int
 {
     if (!CreateD3D12Device()) return 1;
@@ -2019,6 +2308,7 @@ auto main(int argc, const char* argv[]) -> int
 
             RegisterTranslateCallback(&ProjectionTestTranslateProcess);
             RegisterFetchTranslationSetCallback(&ProjectionTestFetchTranslationSet);
+            RegisterWriteConstantBufferCallback(&ProjectionTestWriteConstantBuffer);
         }
         else if (selectedRenderModeIndex == 4)
         {
@@ -2108,7 +2398,7 @@ auto main(int argc, const char* argv[]) -> int
         else if (selectedRenderModeIndex == 8)
         {
             // Depth Bound Test
-            auto externalAssets = CreateDepthBoundTestAssets(s_device, s_commandQueue, s_commandAllocator, s_commandBundleAllocator);
+            auto externalAssets = CreateDepthBoundTestAssets(s_device, s_commandQueue, s_commandAllocator, s_commandBundleAllocator, s_supportDepthTestBound);
             s_rootSignature = std::get<0>(externalAssets);
             s_pipelineStates[0] = std::get<1>(externalAssets);
             s_commandList = std::get<2>(externalAssets);
@@ -2144,7 +2434,7 @@ auto main(int argc, const char* argv[]) -> int
         else if (selectedRenderModeIndex == 10)
         {
             // Geometry Shader Test
-            auto externalAssets = CreateGeometryShaderTestAssets(s_device, s_commandQueue, s_commandAllocator, s_commandBundleAllocator);
+            auto externalAssets = CreateGeometryShaderTestAssets(s_device, s_commandQueue, s_commandAllocator, s_commandBundleAllocator, s_supportMeshShader);
 
             s_rootSignature = std::get<0>(externalAssets);
             s_pipelineStates[0] = std::get<1>(externalAssets);
@@ -2153,7 +2443,26 @@ auto main(int argc, const char* argv[]) -> int
             s_devHostBuffer = std::get<4>(externalAssets);
             s_vertexBuffer = std::get<5>(externalAssets);
 
-            if (!std::get<6>(externalAssets)) break;
+            s_pipelineStates[1] = std::get<6>(externalAssets);
+            s_pipelineStates[2] = std::get<8>(externalAssets);
+
+            // The first available path of the instanced vertex shader, mesh shader and geometry shader paths is rendered. 'V' cycles through them.
+            ID3D12GraphicsCommandList* const pathBundles[] = { std::get<7>(externalAssets), std::get<9>(externalAssets), s_commandBundles[0] };
+            const char* const pathNames[] = {
+                "SV_ViewportArrayIndex from the instanced vertex shader",
+                "SV_ViewportArrayIndex from the mesh shader",
+                "SV_ViewportArrayIndex from the geometry shader"
+            };
+            for (size_t i = 0; i < std::size(pathBundles); ++i)
+            {
+                if (pathBundles[i] == nullptr) continue;
+
+                s_commandBundles[s_viewportArrayPathCount] = pathBundles[i];
+                s_viewportArrayPathNames[s_viewportArrayPathCount] = pathNames[i];
+                ++s_viewportArrayPathCount;
+            }
+
+            if (!std::get<10>(externalAssets)) break;
 
             s_useMultiViewports = true;
         }
@@ -2179,7 +2488,7 @@ auto main(int argc, const char* argv[]) -> int
         {
             // Basic Mesh Shader & Only Mesh Shader
             auto const execMode = MeshShaderExecMode(selectedRenderModeIndex - optionalItemsBegin);
-            auto externalAssets = CreateMeshShaderTestAssets(execMode, s_device, s_commandAllocator, s_commandBundleAllocator);
+            auto externalAssets = CreateMeshShaderTestAssets(execMode, s_device, s_commandQueue, s_commandAllocator, s_commandBundleAllocator);
 
             s_rootSignature = std::get<0>(externalAssets);
             if (s_rootSignature == nullptr) break;
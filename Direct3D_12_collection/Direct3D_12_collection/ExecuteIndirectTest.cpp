@@ -1,5 +1,27 @@
 #include "common.h"
 
+#include <vector>
+
+// Compare one ExecuteIndirect() per command signature with per-object CPU calls for thousands of heterogeneous objects
+#define RUN_MULTI_DRAW_INDIRECT_BENCHMARK   1
+
+static constexpr UINT MULTI_DRAW_OBJECT_COUNT = 4096U;
+static constexpr UINT MULTI_DRAW_MESH_COUNT = 4U;
+static constexpr UINT MULTI_DRAW_ITERATION_COUNT = 8U;
+
+// Sort the 64-bit state keys of the draws on the GPU and submit one ExecuteIndirect() per state bucket instead of per-draw state changes
+#define RUN_DRAW_SORT_BENCHMARK             1
+
+static constexpr UINT DRAW_SORT_DRAW_COUNT = 64U * 1024U;
+static constexpr UINT DRAW_SORT_PIPELINE_COUNT = 2U;            // opaque, additive
+static constexpr UINT DRAW_SORT_SIGNATURE_COUNT = 2U;           // draw, draw indexed
+static constexpr UINT DRAW_SORT_BUCKET_COUNT = DRAW_SORT_PIPELINE_COUNT * DRAW_SORT_SIGNATURE_COUNT;
+static constexpr UINT DRAW_SORT_MATERIAL_COUNT = 64U;           // mesh and color
+static constexpr UINT DRAW_SORT_KEY_BIT_COUNT = 48U;            // the key bits above are always 0
+static constexpr UINT DRAW_SORT_DIGIT_BIT_COUNT = 4U;
+static constexpr UINT DRAW_SORT_DIGIT_COUNT = 1U << DRAW_SORT_DIGIT_BIT_COUNT;
+static constexpr UINT DRAW_SORT_GROUP_SIZE = 256U;
+static constexpr UINT DRAW_SORT_ITERATION_COUNT = 4U;
 
 enum CBV_SRV_UAV_SLOT_ID
 {
@@ -20,6 +42,92 @@ struct IndirectArgumentBufferType
     unsigned paddings[3];
 };
 
+// Objects culled by exec_indirect.comp.hlsl: the 6 visible commands of this test followed by off-screen replicas
+static constexpr UINT EXECUTE_INDIRECT_OBJECT_COUNT = 128U * 1024U;
+
+// Capacity of each command type region in the indirect argument buffer
+static constexpr UINT EXECUTE_INDIRECT_MAX_COMMAND_COUNT = EXECUTE_INDIRECT_OBJECT_COUNT;
+
+// Must be the same as [numthreads(128, 1, 1)] in exec_indirect.comp.hlsl
+static constexpr UINT EXECUTE_INDIRECT_CULLING_GROUP_SIZE = 128U;
+
+// The same as COMMAND_TYPE_* in exec_indirect.comp.hlsl and the index passed to ExecuteIndirectCallbackHandler
+enum EXECUTE_INDIRECT_COMMAND_TYPE
+{
+    EXECUTE_INDIRECT_COMMAND_DRAW,
+    EXECUTE_INDIRECT_COMMAND_DRAW_INDEXED,
+    EXECUTE_INDIRECT_COMMAND_DISPATCH_MESH,
+
+    EXECUTE_INDIRECT_COMMAND_TYPE_COUNT
+};
+
+// The same layout as ExecuteIndirectObject in exec_indirect.comp.hlsl (48 bytes)
+struct ExecuteIndirectObject
+{
+    float boundingSphere[4];        // center xyz in the view space of exec_indirect_draw.vert.hlsl, radius
+    unsigned commandType;           // EXECUTE_INDIRECT_COMMAND_TYPE
+    unsigned arguments[5];          // the leading members of IndirectArgumentBufferType
+    unsigned paddings[2];
+};
+
+// The same layout as CBCulling in exec_indirect.comp.hlsl, passed as root constants
+struct ExecuteIndirectCullingConstants
+{
+    float frustumPlanes[6][4];
+    unsigned objectCount;
+    unsigned maxCommandCount;
+};
+
+// The commands that the compute shader used to write serially, with the bounds of the geometry that they draw,
+// followed by replicas that lie outside of the view volume of glOrtho(-1.0, 1.0, -1.0, 1.0, 1.0, 9.0)
+static auto CreateExecuteIndirectObjects() -> std::vector<ExecuteIndirectObject>
+{
+    std::vector<ExecuteIndirectObject> objects;
+    objects.reserve(EXECUTE_INDIRECT_OBJECT_COUNT);
+
+    // 4 draw commands: the squares of half size 0.25 translated by 0.65 along -x, +y, +x, -y
+    const float squareOffsets[4][2] = { { -0.65f, 0.0f }, { 0.0f, 0.65f }, { 0.65f, 0.0f }, { 0.0f, -0.65f } };
+    for (unsigned i = 0U; i < 4U; ++i)
+    {
+        objects.push_back(ExecuteIndirectObject{
+            .boundingSphere { squareOffsets[i][0], squareOffsets[i][1], -7.0f, 0.3536f },
+            .commandType = EXECUTE_INDIRECT_COMMAND_DRAW,
+            .arguments { 4U, 1U, i * 4U, 0U, 0U }
+        });
+    }
+
+    // 1 draw index command: the circle of radius 0.25
+    objects.push_back(ExecuteIndirectObject{
+        .boundingSphere { 0.0f, 0.0f, -7.0f, 0.25f },
+        .commandType = EXECUTE_INDIRECT_COMMAND_DRAW_INDEXED,
+        .arguments { 360U * 2U, 1U, 0U, 0U, 0U }
+    });
+
+    // 1 dispatch mesh command: ms.mesh.hlsl draws around (0, 0, -2.3)
+    objects.push_back(ExecuteIndirectObject{
+        .boundingSphere { 0.0f, 0.0f, -2.3f, 1.0f },
+        .commandType = EXECUTE_INDIRECT_COMMAND_DISPATCH_MESH,
+        .arguments { 1U, 1U, 1U, 0U, 0U }
+    });
+
+    // Replicas on a grid in the plane z = -7. The ones that would overlap the view volume are moved behind the far plane.
+    const size_t sourceObjectCount = objects.size();
+    const UINT gridSize = UINT(std::ceil(std::sqrt(double(EXECUTE_INDIRECT_OBJECT_COUNT))));
+    for (UINT i = UINT(sourceObjectCount); i < EXECUTE_INDIRECT_OBJECT_COUNT; ++i)
+    {
+        ExecuteIndirectObject replica = objects[i % sourceObjectCount];
+        replica.boundingSphere[0] = (float(i % gridSize) - float(gridSize) * 0.5f) * 0.25f;
+        replica.boundingSphere[1] = (float(i / gridSize) - float(gridSize) * 0.5f) * 0.25f;
+        replica.boundingSphere[2] = -7.0f;
+        if (std::abs(replica.boundingSphere[0]) < 2.5f && std::abs(replica.boundingSphere[1]) < 2.5f) {
+            replica.boundingSphere[2] = -12.0f;
+        }
+        objects.push_back(replica);
+    }
+
+    return objects;
+}
+
 static auto CreateRootSignature(ID3D12Device* d3d_device) -> ID3D12RootSignature*
 {
     ID3D12RootSignature* rootSignature = nullptr;
@@ -81,6 +189,25 @@ static auto CreateRootSignature(ID3D12Device* d3d_device) -> ID3D12RootSignature
             },
             // This constant buffer will just be accessed in a vertex shader
             .ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX
+        },
+        {
+            // t0 (objects of the buffer-filling compute shader)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV,
+            .Descriptor {
+                .ShaderRegister = 0U,
+                .RegisterSpace = 0U
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        {
+            // b1 (culling constants of the buffer-filling compute shader)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+            .Constants {
+                .ShaderRegister = 1U,
+                .RegisterSpace = 0U,
+                .Num32BitValues = UINT(sizeof(ExecuteIndirectCullingConstants) / sizeof(UINT))
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
         }
     };
 
@@ -605,7 +732,7 @@ static auto CreateComputeBuffersForArgumentFilling(ID3D12Device* d3d_device, ID3
     ID3D12Resource* indirectArgumentBuffer = nullptr;
     ID3D12Resource* indirectCountBuffer = nullptr;
 
-    auto result = std::make_pair(indirectArgumentBuffer, indirectCountBuffer);
+    auto const result = std::make_pair(indirectArgumentBuffer, indirectCountBuffer);
 
     // ======== Create indirectArgumentBuffer and indirectCountBuffer ========
 
@@ -617,15 +744,16 @@ static auto CreateComputeBuffersForArgumentFilling(ID3D12Device* d3d_device, ID3
         .VisibleNodeMask = 1
     };
 
-    constexpr UINT indirectArgumentBuffer_elemCount = 6U;
-    constexpr UINT indirectCountBuffer_elemCount = 3U;
+    // One region of EXECUTE_INDIRECT_MAX_COMMAND_COUNT commands and one count per command type
+    constexpr UINT indirectArgumentBuffer_elemCount = EXECUTE_INDIRECT_COMMAND_TYPE_COUNT * EXECUTE_INDIRECT_MAX_COMMAND_COUNT;
+    constexpr UINT indirectCountBuffer_elemCount = EXECUTE_INDIRECT_COMMAND_TYPE_COUNT;
     constexpr UINT indirectArgumentBuffer_elemSize = (UINT)sizeof(IndirectArgumentBufferType);
     constexpr UINT indirectCountBuffer_elemSize = (UINT)sizeof(UINT);
 
     D3D12_RESOURCE_DESC uavResourceDesc{
         .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
         .Alignment = 0,
-        .Width = indirectArgumentBuffer_elemCount * indirectArgumentBuffer_elemSize,
+        .Width = UINT64(indirectArgumentBuffer_elemCount) * indirectArgumentBuffer_elemSize,
         .Height = 1U,
         .DepthOrArraySize = 1,
         .MipLevels = 1,
@@ -651,11 +779,10 @@ static auto CreateComputeBuffersForArgumentFilling(ID3D12Device* d3d_device, ID3
     if (FAILED(hRes))
     {
         fprintf(stderr, "CreateCommittedResource for indirectCountBuffer failed: %ld\n", hRes);
+        indirectArgumentBuffer->Release();
         return result;
     }
 
-    result = std::make_pair(indirectArgumentBuffer, indirectCountBuffer);
-
     // ======== Create Unordered Access Buffer Views ========
 
     const UINT descriptorIncrSize = d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
@@ -689,64 +816,252 @@ static auto CreateComputeBuffersForArgumentFilling(ID3D12Device* d3d_device, ID3
     indirectArgumentBufferGPUDescHandle.ptr += INDIRECT_ARGUMENT_BUFFER_UAV_SLOT * descriptorIncrSize;
     indirectCountBufferGPUDescHandle.ptr += INDIRECT_COUNT_BUFFER_UAV_SLOT * descriptorIncrSize;
 
-    // ======== Populate Execution Commands ========
+    // ======== Upload the objects and clear the counts ========
 
-    ID3D12DescriptorHeap* const descHeaps[]{ descriptorHeap };
-    commandList->SetDescriptorHeaps(UINT(std::size(descHeaps)), descHeaps);
+    const std::vector<ExecuteIndirectObject> objects = CreateExecuteIndirectObjects();
+    const size_t objectBufferSize = objects.size() * sizeof(ExecuteIndirectObject);
+    constexpr UINT timestampCount = 2U;
 
-    commandBundle->SetDescriptorHeaps(UINT(std::size(descHeaps)), descHeaps);
-    commandBundle->SetComputeRootSignature(computeRootSignature);
-    commandBundle->SetComputeRootDescriptorTable(0, indirectArgumentBufferGPUDescHandle);
-    commandBundle->SetComputeRootDescriptorTable(1, indirectCountBufferGPUDescHandle);
-    commandBundle->Dispatch(1U, 1U, 1U);
+    ID3D12Resource* objectBuffer = nullptr;
+    ID3D12Resource* uploadDevHostBuffer = nullptr;
+    ID3D12Resource* countReadbackBuffer = nullptr;
+    ID3D12Resource* timestampReadbackBuffer = nullptr;
+    ID3D12QueryHeap* queryHeap = nullptr;
+    bool success = false;
 
-    hRes = commandBundle->Close();
-    if (FAILED(hRes))
+    do
     {
-        fprintf(stderr, "Close compute command bundle failed: %ld\n", hRes);
-        return result;
-    }
+        const D3D12_HEAP_PROPERTIES uploadHeapProperties{
+            .Type = D3D12_HEAP_TYPE_UPLOAD,     // for host visible memory which is used to upload data from host to device
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
 
-    commandList->ExecuteBundle(commandBundle);
+        const D3D12_HEAP_PROPERTIES readbackHeapProperties{
+            .Type = D3D12_HEAP_TYPE_READBACK,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
 
-    const D3D12_RESOURCE_BARRIER uavBarriers[] = {
+        D3D12_RESOURCE_DESC bufferDesc = uavResourceDesc;
+        bufferDesc.Width = objectBufferSize;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&objectBuffer));
+        if (FAILED(hRes))
         {
-            .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
-            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
-            .Transition {
-                .pResource = indirectArgumentBuffer,
-                .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
-                .StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
-                .StateAfter = D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT
-            }
-        },
+            fprintf(stderr, "CreateCommittedResource for objectBuffer failed: %ld\n", hRes);
+            break;
+        }
+
+        // [objects][zero counts]
+        bufferDesc.Width = objectBufferSize + indirectCountBuffer_elemCount * indirectCountBuffer_elemSize;
+        hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadDevHostBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for object upload buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = indirectCountBuffer_elemCount * indirectCountBuffer_elemSize;
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&countReadbackBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for count read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = timestampCount * sizeof(UINT64);
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&timestampReadbackBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for timestamp read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_QUERY_HEAP_DESC queryHeapDesc{
+            .Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP,
+            .Count = timestampCount,
+            .NodeMask = 0U
+        };
+        hRes = d3d_device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&queryHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateQueryHeap for argument filling failed: %ld\n", hRes);
+            break;
+        }
+
+        void* hostMemPtr = nullptr;
+        hRes = uploadDevHostBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
         {
+            fprintf(stderr, "Map object upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        memcpy(hostMemPtr, objects.data(), objectBufferSize);
+        memset((void*)(uintptr_t(hostMemPtr) + objectBufferSize), 0, indirectCountBuffer_elemCount * indirectCountBuffer_elemSize);
+        uploadDevHostBuffer->Unmap(0, nullptr);
+
+        WriteToDeviceResourceAndSync(commandList, objectBuffer, uploadDevHostBuffer, 0U, 0U, objectBufferSize);
+        WriteToDeviceResourceAndSync(commandList, indirectCountBuffer, uploadDevHostBuffer, 0U, objectBufferSize, indirectCountBuffer_elemCount * indirectCountBuffer_elemSize);
+
+        const D3D12_RESOURCE_BARRIER countBarrier{
             .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
             .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
             .Transition {
                 .pResource = indirectCountBuffer,
                 .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
-                .StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
-                .StateAfter = D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT
+                .StateBefore = D3D12_RESOURCE_STATE_GENERIC_READ,
+                .StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS
             }
+        };
+        commandList->ResourceBarrier(1U, &countBarrier);
+
+        // ======== Populate Execution Commands ========
+
+        // glOrtho(-1.0, 1.0, -1.0, 1.0, 1.0, 9.0) of exec_indirect_draw.vert.hlsl in view space: -1 <= x, y <= 1, -9 <= z <= -1
+        const ExecuteIndirectCullingConstants cullingConstants{
+            .frustumPlanes {
+                { 1.0f, 0.0f, 0.0f, 1.0f },     // left
+                { -1.0f, 0.0f, 0.0f, 1.0f },    // right
+                { 0.0f, 1.0f, 0.0f, 1.0f },     // bottom
+                { 0.0f, -1.0f, 0.0f, 1.0f },    // top
+                { 0.0f, 0.0f, -1.0f, -1.0f },   // near
+                { 0.0f, 0.0f, 1.0f, 9.0f }      // far
+            },
+            .objectCount = UINT(objects.size()),
+            .maxCommandCount = EXECUTE_INDIRECT_MAX_COMMAND_COUNT
+        };
+
+        ID3D12DescriptorHeap* const descHeaps[]{ descriptorHeap };
+        commandList->SetDescriptorHeaps(UINT(std::size(descHeaps)), descHeaps);
+
+        commandBundle->SetDescriptorHeaps(UINT(std::size(descHeaps)), descHeaps);
+        commandBundle->SetComputeRootSignature(computeRootSignature);
+        commandBundle->SetComputeRootDescriptorTable(0, indirectArgumentBufferGPUDescHandle);
+        commandBundle->SetComputeRootDescriptorTable(1, indirectCountBufferGPUDescHandle);
+        commandBundle->SetComputeRootShaderResourceView(3, objectBuffer->GetGPUVirtualAddress());
+        commandBundle->SetComputeRoot32BitConstants(4, UINT(sizeof(cullingConstants) / sizeof(UINT)), &cullingConstants, 0);
+        commandBundle->Dispatch((UINT(objects.size()) + EXECUTE_INDIRECT_CULLING_GROUP_SIZE - 1U) / EXECUTE_INDIRECT_CULLING_GROUP_SIZE, 1U, 1U);
+
+        hRes = commandBundle->Close();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Close compute command bundle failed: %ld\n", hRes);
+            break;
         }
-    };
-    commandList->ResourceBarrier(UINT(std::size(uavBarriers)), uavBarriers);
 
-    hRes = commandList->Close();
-    if (FAILED(hRes))
-    {
-        fprintf(stderr, "Close compute command bundle failed: %ld\n", hRes);
-        return result;
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0U);
+        commandList->ExecuteBundle(commandBundle);
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 1U);
+
+        SyncAndReadFromDeviceResource(commandList, indirectCountBuffer_elemCount * indirectCountBuffer_elemSize, countReadbackBuffer, indirectCountBuffer);
+        commandList->ResolveQueryData(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0U, timestampCount, timestampReadbackBuffer, 0U);
+
+        const D3D12_RESOURCE_BARRIER uavBarriers[] = {
+            {
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = indirectArgumentBuffer,
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+                    .StateAfter = D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT
+                }
+            },
+            {
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = indirectCountBuffer,
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+                    .StateAfter = D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT
+                }
+            }
+        };
+        commandList->ResourceBarrier(UINT(std::size(uavBarriers)), uavBarriers);
+
+        hRes = commandList->Close();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Close compute command bundle failed: %ld\n", hRes);
+            break;
+        }
+
+        ID3D12CommandList* const computeCommandLists[] = { (ID3D12CommandList*)commandList };
+        commandQueue->ExecuteCommandLists((UINT)std::size(computeCommandLists), computeCommandLists);
+
+        // Wait for all the above commands completing the execution
+        if (!WaitForPreviousFrame(commandQueue)) break;
+
+        UINT64 timestampFrequency = 0;
+        hRes = commandQueue->GetTimestampFrequency(&timestampFrequency);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "GetTimestampFrequency failed: %ld\n", hRes);
+            break;
+        }
+
+        const UINT* counts = nullptr;
+        hRes = countReadbackBuffer->Map(0, nullptr, (void**)&counts);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map count read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        const UINT64* timestamps = nullptr;
+        hRes = timestampReadbackBuffer->Map(0, nullptr, (void**)&timestamps);
+        if (FAILED(hRes))
+        {
+            countReadbackBuffer->Unmap(0, nullptr);
+            fprintf(stderr, "Map timestamp read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        printf("Culled %zu objects into %u draw, %u draw indexed and %u dispatch mesh commands in %.3f ms\n",
+                objects.size(), counts[EXECUTE_INDIRECT_COMMAND_DRAW], counts[EXECUTE_INDIRECT_COMMAND_DRAW_INDEXED], counts[EXECUTE_INDIRECT_COMMAND_DISPATCH_MESH],
+                double(timestamps[1] - timestamps[0]) * 1000.0 / double(timestampFrequency));
+
+        timestampReadbackBuffer->Unmap(0, nullptr);
+        countReadbackBuffer->Unmap(0, nullptr);
+
+        success = true;
     }
+    while (false);
 
-    ID3D12CommandList* const computeCommandLists[] = { (ID3D12CommandList*)commandList };
-    commandQueue->ExecuteCommandLists((UINT)std::size(computeCommandLists), computeCommandLists);
+    if (objectBuffer != nullptr) {
+        objectBuffer->Release();
+    }
+    if (uploadDevHostBuffer != nullptr) {
+        uploadDevHostBuffer->Release();
+    }
+    if (countReadbackBuffer != nullptr) {
+        countReadbackBuffer->Release();
+    }
+    if (timestampReadbackBuffer != nullptr) {
+        timestampReadbackBuffer->Release();
+    }
+    if (queryHeap != nullptr) {
+        queryHeap->Release();
+    }
 
-    // Wait for all the above commands completing the execution
-    WaitForPreviousFrame(commandQueue);
+    if (!success)
+    {
+        indirectArgumentBuffer->Release();
+        indirectCountBuffer->Release();
+        return result;
+    }
 
-    return result;
+    return std::make_pair(indirectArgumentBuffer, indirectCountBuffer);
 }
 
 // @return std::make_tuple(commandSignature, uploadDevHostBuffer, vertexBuffer, rotateConstantBuffer, vertexBufferView)
@@ -1155,148 +1470,1815 @@ static auto ExecuteDataCopyCommandsAndWait(ID3D12CommandQueue* commandQueue, ID3
     return true;
 }
 
-auto CreateExecuteIndirectTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue *commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator, bool supportMeshShader) ->
-                                    std::tuple<ID3D12RootSignature*, std::array<ID3D12PipelineState*, 3>, ID3D12GraphicsCommandList*, std::array<ID3D12GraphicsCommandList*, 3>, ID3D12DescriptorHeap*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, std::array<ID3D12CommandSignature*, 3>, bool>
+#if RUN_MULTI_DRAW_INDIRECT_BENCHMARK || RUN_DRAW_SORT_BENCHMARK
+// Tightly packed argument stream of one command signature: the arguments of each command follow each other
+// without padding, in the order of argumentDescs
+struct IndirectArgumentStream
 {
-    ID3D12RootSignature* rootSignature = nullptr;
-    ID3D12PipelineState* computePipelineStateForArgumentBufferFilling = nullptr;
-    ID3D12PipelineState* pipelineState = nullptr;
-    ID3D12PipelineState* pipelineStateIndexed = nullptr;
-    ID3D12PipelineState* pipelineStateMeshShader = nullptr;
-    ID3D12GraphicsCommandList* commandList = nullptr;
-    ID3D12GraphicsCommandList* commandBundle = nullptr;
-    ID3D12GraphicsCommandList* commandBundleIndexed = nullptr;
-    ID3D12GraphicsCommandList* commandBundleMeshShader = nullptr;
-    ID3D12DescriptorHeap* descriptorHeap = nullptr;
-    ID3D12CommandSignature* drawCommandsSignature = nullptr;
-    ID3D12CommandSignature* drawIndexedCommandSignature = nullptr;
-    ID3D12CommandSignature* meshShaderCommandSignature = nullptr;
-    ID3D12Resource* indirectArgumentBuffer = nullptr;
-    ID3D12Resource* indirectCountBuffer = nullptr;
-    ID3D12Resource* uploadDevHostBuffer = nullptr;
-    ID3D12Resource* vertexBuffer = nullptr;
-    ID3D12Resource* indexBuffer = nullptr;
-    ID3D12Resource* rotateConstantBuffer = nullptr;
-    D3D12_VERTEX_BUFFER_VIEW vertexBufferView{ };
-
-    bool success = false;
+    std::vector<D3D12_INDIRECT_ARGUMENT_DESC> argumentDescs;
+    std::vector<UINT> argumentOffsets;      // in bytes, within one command
+    UINT byteStride;
+    UINT commandCount;
+    std::vector<uint8_t> data;
+};
 
-    auto const result = std::make_tuple(rootSignature, pipelineState, commandList, std::array<ID3D12GraphicsCommandList*, 3>(), descriptorHeap, uploadDevHostBuffer, vertexBuffer, indexBuffer, rotateConstantBuffer, indirectArgumentBuffer, indirectCountBuffer, std::array<ID3D12CommandSignature*, 3>(), success);
+static auto GetIndirectArgumentByteSize(const D3D12_INDIRECT_ARGUMENT_DESC& argumentDesc) -> UINT
+{
+    switch (argumentDesc.Type)
+    {
+    case D3D12_INDIRECT_ARGUMENT_TYPE_DRAW:
+        return UINT(sizeof(D3D12_DRAW_ARGUMENTS));
 
-    success = true;
+    case D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED:
+        return UINT(sizeof(D3D12_DRAW_INDEXED_ARGUMENTS));
 
-    rootSignature = CreateRootSignature(d3d_device);
-    if (rootSignature == nullptr) {
-        success = false;
-    }
+    case D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH:
+        return UINT(sizeof(D3D12_DISPATCH_ARGUMENTS));
 
-    auto const computePipelineResult = CreatePipelineStateObjectForArgBufferCompute(d3d_device, commandAllocator, commandBundleAllocator, rootSignature);
-    computePipelineStateForArgumentBufferFilling = std::get<0>(computePipelineResult);
-    commandList = std::get<1>(computePipelineResult);
-    commandBundle = std::get<2>(computePipelineResult);
-    descriptorHeap = std::get<3>(computePipelineResult);
-    if (computePipelineStateForArgumentBufferFilling == nullptr || descriptorHeap == nullptr) {
-        success = false;
-    }
+    case D3D12_INDIRECT_ARGUMENT_TYPE_VERTEX_BUFFER_VIEW:
+        return UINT(sizeof(D3D12_VERTEX_BUFFER_VIEW));
 
-    auto const computeBuffersResult = CreateComputeBuffersForArgumentFilling(d3d_device, rootSignature, commandQueue, commandList, commandBundle, descriptorHeap);
-    indirectArgumentBuffer = computeBuffersResult.first;
-    indirectCountBuffer = computeBuffersResult.second;
-    if (commandList == nullptr || commandBundle == nullptr) {
-        success = false;
-    }
+    case D3D12_INDIRECT_ARGUMENT_TYPE_INDEX_BUFFER_VIEW:
+        return UINT(sizeof(D3D12_INDEX_BUFFER_VIEW));
 
-    if (computePipelineStateForArgumentBufferFilling != nullptr) {
-        computePipelineStateForArgumentBufferFilling->Release();
-    }
-    if (commandList != nullptr) {
-        commandList->Release();
-    }
-    if (commandBundle != nullptr) {
-        commandBundle->Release();
-    }
+    case D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT:
+        return argumentDesc.Constant.Num32BitValuesToSet * UINT(sizeof(UINT));
 
-    auto const graphicsPipelineResult = CreatePipelineStateObjectDraw(d3d_device, commandAllocator, commandBundleAllocator, rootSignature);
-    pipelineState = std::get<0>(graphicsPipelineResult);
-    commandList = std::get<1>(graphicsPipelineResult);
-    commandBundle = std::get<2>(graphicsPipelineResult);
-    if (commandList == nullptr || commandBundle == nullptr) {
-        success = false;
-    }
+    case D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT_BUFFER_VIEW:
+    case D3D12_INDIRECT_ARGUMENT_TYPE_SHADER_RESOURCE_VIEW:
+    case D3D12_INDIRECT_ARGUMENT_TYPE_UNORDERED_ACCESS_VIEW:
+        return UINT(sizeof(D3D12_GPU_VIRTUAL_ADDRESS));
 
-    auto const vertexBufferResult = CreateVertexBuffer(d3d_device, rootSignature, commandList, commandBundle, descriptorHeap);
-    drawCommandsSignature = std::get<0>(vertexBufferResult);
-    uploadDevHostBuffer = std::get<1>(vertexBufferResult);
-    vertexBuffer = std::get<2>(vertexBufferResult);
-    rotateConstantBuffer = std::get<3>(vertexBufferResult);
-    vertexBufferView = std::get<4>(vertexBufferResult);
-    if (uploadDevHostBuffer == nullptr || vertexBuffer == nullptr || rotateConstantBuffer == nullptr) {
-        success = false;
-    }
+    case D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH_MESH:
+        return UINT(sizeof(D3D12_DISPATCH_MESH_ARGUMENTS));
 
-    auto const indexedPipelineState = CreatePipelineStateObjectDrawIndexed(d3d_device, commandBundleAllocator, rootSignature);
-    pipelineStateIndexed = indexedPipelineState.first;
-    commandBundleIndexed = indexedPipelineState.second;
-    if (pipelineStateIndexed == nullptr || commandBundleIndexed == nullptr) {
-        success = false;
+    default:
+        return 0U;
     }
+}
 
-    auto const indexedVertexBufferResult = CreateVertexBufferIndexed(d3d_device, rootSignature, commandList, commandBundleIndexed, descriptorHeap, vertexBufferView, uploadDevHostBuffer);
-    drawIndexedCommandSignature = indexedVertexBufferResult.first;
-    indexBuffer = indexedVertexBufferResult.second;
+static auto CreateIndirectArgumentStream(const D3D12_INDIRECT_ARGUMENT_DESC argumentDescs[], UINT argumentCount, UINT commandCount) -> IndirectArgumentStream
+{
+    IndirectArgumentStream stream{
+        .argumentDescs { argumentDescs, argumentDescs + argumentCount },
+        .argumentOffsets { },
+        .byteStride = 0U,
+        .commandCount = commandCount
+    };
 
-    if (supportMeshShader)
+    // Every argument size is a multiple of 4 bytes, which is the alignment that ExecuteIndirect requires
+    for (const D3D12_INDIRECT_ARGUMENT_DESC& argumentDesc : stream.argumentDescs)
     {
-        auto const meshShaderPipelineState = CreatePipelineStateObjectForMeshShader((ID3D12Device2*)d3d_device, rootSignature, commandBundleAllocator);
-        pipelineStateMeshShader = meshShaderPipelineState.first;
-        commandBundleMeshShader = meshShaderPipelineState.second;
-        if (pipelineStateMeshShader == nullptr || commandBundleMeshShader == nullptr) {
-            success = false;
-        }
-
-        meshShaderCommandSignature = CreateCommandSignatureForMeshShader(d3d_device, rootSignature, commandBundleMeshShader);
-        if (meshShaderCommandSignature == nullptr) {
-            success = false;
-        }
-    }
-
-    if (!ExecuteDataCopyCommandsAndWait(commandQueue, commandList)) {
-        success = false;
+        stream.argumentOffsets.push_back(stream.byteStride);
+        stream.byteStride += GetIndirectArgumentByteSize(argumentDesc);
     }
 
-    std::array< ID3D12PipelineState*, 3> pipelineStateArray{ pipelineState, pipelineStateIndexed, pipelineStateMeshShader };
-    std::array<ID3D12GraphicsCommandList*, 3> commandBundleArray { commandBundle, commandBundleIndexed, commandBundleMeshShader };
-    std::array<ID3D12CommandSignature*, 3> commandSignatureArray{ drawCommandsSignature, drawIndexedCommandSignature, meshShaderCommandSignature };
-
-    return std::make_tuple(rootSignature, pipelineStateArray, commandList, commandBundleArray, descriptorHeap, uploadDevHostBuffer, vertexBuffer, indexBuffer, rotateConstantBuffer, indirectArgumentBuffer, indirectCountBuffer, commandSignatureArray, success);
+    stream.data.assign(size_t(stream.byteStride) * commandCount, 0U);
+    return stream;
 }
 
-auto ExecuteIndirectCallbackHandler(ID3D12GraphicsCommandList* commandList, ID3D12CommandSignature* commandSignature, ID3D12Resource* indirectArgumentBuffer, ID3D12Resource* indirectCountBuffer, UINT index) -> void
+// @param argument one of the D3D12_*_ARGUMENTS, D3D12_*_BUFFER_VIEW structures or the root constants, as selected by argumentIndex
+static auto WriteIndirectArgument(IndirectArgumentStream& stream, UINT commandIndex, UINT argumentIndex, const void* argument) -> void
 {
-    constexpr UINT64 secondCommandsOffset = UINT64(4U * sizeof(IndirectArgumentBufferType));
-    constexpr UINT64 thirdCommandsOffset = UINT64(secondCommandsOffset + 1U * sizeof(IndirectArgumentBufferType));
+    memcpy(&stream.data[size_t(commandIndex) * stream.byteStride + stream.argumentOffsets[argumentIndex]], argument,
+            GetIndirectArgumentByteSize(stream.argumentDescs[argumentIndex]));
+}
 
-    UINT maxCommandCount = 1U;
-    UINT64 argumentBufferOffset = 0U, countBufferOffset = 0U;
+// @param rootSignature required when the stream changes root arguments
+static auto CreateCommandSignatureForStream(ID3D12Device* d3d_device, ID3D12RootSignature* rootSignature, const IndirectArgumentStream& stream) -> ID3D12CommandSignature*
+{
+    const D3D12_COMMAND_SIGNATURE_DESC commandSignatureDesc{
+        .ByteStride = stream.byteStride,
+        .NumArgumentDescs = UINT(stream.argumentDescs.size()),
+        .pArgumentDescs = stream.argumentDescs.data(),
+        .NodeMask = 0U
+    };
 
-    switch (index)
+    ID3D12CommandSignature* commandSignature = nullptr;
+    const HRESULT hRes = d3d_device->CreateCommandSignature(&commandSignatureDesc, rootSignature, IID_PPV_ARGS(&commandSignature));
+    if (FAILED(hRes))
     {
-    case 0U:
-    default:
-        maxCommandCount = 4U;
-        break;
+        fprintf(stderr, "CreateCommandSignature for argument stream failed: %ld\n", hRes);
+        return nullptr;
+    }
 
-    case 1U:
-        argumentBufferOffset = secondCommandsOffset;
-        countBufferOffset = 4U;
-        break;
+    return commandSignature;
+}
 
-    case 2U:
-        argumentBufferOffset = thirdCommandsOffset;
-        countBufferOffset = 8U;
-        break;
+// The same layout as CBObject in multi_draw.vert.hlsl
+struct MultiDrawObjectConstants
+{
+    float offset[2];
+    float scale;
+    UINT color;         // RGBA8
+};
+
+// Commands of the non-indexed signature: root constants, vertex buffer view, draw
+static constexpr D3D12_INDIRECT_ARGUMENT_DESC MULTI_DRAW_ARGUMENT_DESCS[]{
+    {
+        .Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT,
+        .Constant {
+            .RootParameterIndex = 0U,
+            .DestOffsetIn32BitValues = 0U,
+            .Num32BitValuesToSet = UINT(sizeof(MultiDrawObjectConstants) / sizeof(UINT))
+        }
+    },
+    {
+        .Type = D3D12_INDIRECT_ARGUMENT_TYPE_VERTEX_BUFFER_VIEW,
+        .VertexBuffer { .Slot = 0U }
+    },
+    {
+        .Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW
+    }
+};
+
+// Commands of the indexed signature: root constants, vertex buffer view, index buffer view, draw indexed
+static constexpr D3D12_INDIRECT_ARGUMENT_DESC MULTI_DRAW_INDEXED_ARGUMENT_DESCS[]{
+    MULTI_DRAW_ARGUMENT_DESCS[0],
+    MULTI_DRAW_ARGUMENT_DESCS[1],
+    {
+        .Type = D3D12_INDIRECT_ARGUMENT_TYPE_INDEX_BUFFER_VIEW
+    },
+    {
+        .Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED
+    }
+};
+
+static auto CreateRootSignatureForMultiDraw(ID3D12Device* d3d_device) -> ID3D12RootSignature*
+{
+    ID3D12RootSignature* rootSignature = nullptr;
+
+    const D3D12_ROOT_PARAMETER rootParameters[]{
+        {
+            // b0 (per-object constants)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+            .Constants {
+                .ShaderRegister = 0U,
+                .RegisterSpace = 0U,
+                .Num32BitValues = UINT(sizeof(MultiDrawObjectConstants) / sizeof(UINT))
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX
+        }
+    };
+
+    const D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {
+        .NumParameters = UINT(std::size(rootParameters)),
+        .pParameters = rootParameters,
+        .NumStaticSamplers = 0,
+        .pStaticSamplers = nullptr,
+        .Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT
+    };
+
+    ID3DBlob* signature = nullptr;
+    ID3DBlob* error = nullptr;
+    HRESULT hRes = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error);
+    do
+    {
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "D3D12SerializeRootSignature for multi-draw failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateRootSignature for multi-draw failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (signature != nullptr) {
+        signature->Release();
+    }
+    if (error != nullptr) {
+        error->Release();
+    }
+
+    if (FAILED(hRes)) return nullptr;
+
+    return rootSignature;
+}
+
+// @param additiveBlend whether the render target color is added to instead of overwritten
+static auto CreatePipelineStateForMultiDraw(ID3D12Device* d3d_device, ID3D12RootSignature* rootSignature, bool additiveBlend) -> ID3D12PipelineState*
+{
+    D3D12_SHADER_BYTECODE vertexShaderObj = CreateCompiledShaderObjectFromPath("cso/multi_draw.vert.cso");
+    D3D12_SHADER_BYTECODE pixelShaderObj = CreateCompiledShaderObjectFromPath("cso/basic.frag.cso");
+
+    ID3D12PipelineState* pipelineState = nullptr;
+
+    do
+    {
+        if (vertexShaderObj.pShaderBytecode == nullptr || vertexShaderObj.BytecodeLength == 0) break;
+        if (pixelShaderObj.pShaderBytecode == nullptr || pixelShaderObj.BytecodeLength == 0) break;
+
+        const D3D12_INPUT_ELEMENT_DESC inputElementDescs[]{
+            { "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc{
+            .pRootSignature = rootSignature,
+            .VS = vertexShaderObj,
+            .PS = pixelShaderObj,
+            .BlendState {
+                .AlphaToCoverageEnable = FALSE,
+                .IndependentBlendEnable = FALSE,
+                .RenderTarget {
+                    // RenderTarget[0]
+                    {
+                        .BlendEnable = additiveBlend ? TRUE : FALSE,
+                        .LogicOpEnable = FALSE,
+                        .SrcBlend = D3D12_BLEND_ONE,
+                        .DestBlend = additiveBlend ? D3D12_BLEND_ONE : D3D12_BLEND_ZERO,
+                        .BlendOp = D3D12_BLEND_OP_ADD,
+                        .SrcBlendAlpha = D3D12_BLEND_ONE,
+                        .DestBlendAlpha = D3D12_BLEND_ZERO,
+                        .BlendOpAlpha = D3D12_BLEND_OP_ADD,
+                        .LogicOp = D3D12_LOGIC_OP_NOOP,
+                        .RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL
+                    }
+                }
+            },
+            .SampleMask = UINT32_MAX,
+            .RasterizerState {
+                .FillMode = D3D12_FILL_MODE_SOLID,
+                .CullMode = D3D12_CULL_MODE_NONE,
+                .FrontCounterClockwise = FALSE,
+                .DepthBias = 0,
+                .DepthBiasClamp = 0.0f,
+                .SlopeScaledDepthBias = 0.0f,
+                .DepthClipEnable = TRUE,
+                .MultisampleEnable = FALSE,
+                .AntialiasedLineEnable = FALSE,
+                .ForcedSampleCount = 0,
+                .ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF
+            },
+            .DepthStencilState {
+                .DepthEnable = FALSE,
+                .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO,
+                .DepthFunc = D3D12_COMPARISON_FUNC_ALWAYS,
+                .StencilEnable = FALSE,
+                .StencilReadMask = 0,
+                .StencilWriteMask = 0,
+                .FrontFace { },
+                .BackFace { }
+            },
+            .InputLayout {
+                .pInputElementDescs = inputElementDescs,
+                .NumElements = (UINT)std::size(inputElementDescs)
+            },
+            .IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED,
+            .PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+            .NumRenderTargets = 1,
+            .RTVFormats {
+                // RTVFormats[0]
+                { RENDER_TARGET_BUFFER_FOMRAT }
+            },
+            .DSVFormat = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {
+                .Count = 1,
+                .Quality = 0
+            },
+            .NodeMask = 0,
+            .CachedPSO { },
+            .Flags = D3D12_PIPELINE_STATE_FLAG_NONE
+        };
+
+        const HRESULT hRes = d3d_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateGraphicsPipelineState for multi-draw failed: %ld\n", hRes);
+            pipelineState = nullptr;
+            break;
+        }
+    }
+    while (false);
+
+    if (vertexShaderObj.pShaderBytecode != nullptr) {
+        free((void*)vertexShaderObj.pShaderBytecode);
+    }
+    if (pixelShaderObj.pShaderBytecode != nullptr) {
+        free((void*)pixelShaderObj.pShaderBytecode);
+    }
+
+    return pipelineState;
+}
+
+// Geometry of the multi-draw benchmark: 2 non-indexed meshes and 2 indexed meshes with their own vertex and index buffer views
+struct MultiDrawMesh
+{
+    std::vector<float> positions;       // xy, triangle list
+    std::vector<uint16_t> indices;      // empty for non-indexed meshes
+};
+
+static auto CreateMultiDrawMeshes() -> std::vector<MultiDrawMesh>
+{
+    std::vector<MultiDrawMesh> meshes(MULTI_DRAW_MESH_COUNT);
+
+    // Triangle
+    meshes[0].positions = { -1.0f, -1.0f, 0.0f, 1.0f, 1.0f, -1.0f };
+
+    // Quad
+    meshes[1].positions = { -1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+
+    // Hexagon and 32-sided circle as indexed triangle fans
+    const uint16_t segmentCounts[2] = { 6U, 32U };
+    for (int i = 0; i < 2; ++i)
+    {
+        MultiDrawMesh& mesh = meshes[2 + i];
+        mesh.positions = { 0.0f, 0.0f };
+        for (uint16_t segment = 0U; segment < segmentCounts[i]; ++segment)
+        {
+            const double angle = 2.0 * M_PI * double(segment) / double(segmentCounts[i]);
+            mesh.positions.insert(mesh.positions.end(), { (float)cos(angle), (float)sin(angle) });
+            mesh.indices.insert(mesh.indices.end(), { 0U, uint16_t(1U + segment), uint16_t(1U + (segment + 1U) % segmentCounts[i]) });
+        }
+    }
+
+    return meshes;
+}
+
+// Geometry buffer sections: the positions and the 4-byte aligned indices of every mesh
+// @return the size of the geometry in bytes
+static auto GetMultiDrawGeometryLayout(const std::vector<MultiDrawMesh>& meshes, std::vector<size_t>& positionOffsets, std::vector<size_t>& indexOffsets) -> size_t
+{
+    positionOffsets.resize(meshes.size());
+    indexOffsets.resize(meshes.size());
+
+    size_t geometrySize = 0;
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        positionOffsets[i] = geometrySize;
+        geometrySize += meshes[i].positions.size() * sizeof(float);
+        indexOffsets[i] = geometrySize;
+        geometrySize += (meshes[i].indices.size() * sizeof(uint16_t) + 3U) & ~size_t(3U);
+    }
+
+    return geometrySize;
+}
+
+static auto WriteMultiDrawGeometry(const std::vector<MultiDrawMesh>& meshes, const std::vector<size_t>& positionOffsets, const std::vector<size_t>& indexOffsets,
+                                    uint8_t* hostMemPtr) -> void
+{
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        memcpy(hostMemPtr + positionOffsets[i], meshes[i].positions.data(), meshes[i].positions.size() * sizeof(float));
+        memcpy(hostMemPtr + indexOffsets[i], meshes[i].indices.data(), meshes[i].indices.size() * sizeof(uint16_t));
+    }
+}
+
+// @param geometryAddress GPU virtual address of the geometry written by WriteMultiDrawGeometry
+static auto CreateMultiDrawBufferViews(const std::vector<MultiDrawMesh>& meshes, const std::vector<size_t>& positionOffsets, const std::vector<size_t>& indexOffsets,
+                                        D3D12_GPU_VIRTUAL_ADDRESS geometryAddress, std::vector<D3D12_VERTEX_BUFFER_VIEW>& vertexBufferViews,
+                                        std::vector<D3D12_INDEX_BUFFER_VIEW>& indexBufferViews) -> void
+{
+    vertexBufferViews.resize(meshes.size());
+    indexBufferViews.resize(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        vertexBufferViews[i] = D3D12_VERTEX_BUFFER_VIEW{
+            .BufferLocation = geometryAddress + positionOffsets[i],
+            .SizeInBytes = UINT(meshes[i].positions.size() * sizeof(float)),
+            .StrideInBytes = UINT(sizeof(float) * 2U)
+        };
+        indexBufferViews[i] = D3D12_INDEX_BUFFER_VIEW{
+            .BufferLocation = geometryAddress + indexOffsets[i],
+            .SizeInBytes = UINT(meshes[i].indices.size() * sizeof(uint16_t)),
+            .Format = DXGI_FORMAT_R16_UINT
+        };
+    }
+}
+
+#endif
+
+#if RUN_MULTI_DRAW_INDIRECT_BENCHMARK
+// Draws MULTI_DRAW_OBJECT_COUNT heterogeneous objects, each with its own root constants, vertex buffer and optionally index buffer,
+// once with one ExecuteIndirect() per command signature and once with per-object CPU calls, and reports the GPU and CPU recording time of both.
+static auto RunMultiDrawIndirectBenchmark(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator) -> bool
+{
+    enum MULTI_DRAW_MODE
+    {
+        MULTI_DRAW_MODE_EXECUTE_INDIRECT,
+        MULTI_DRAW_MODE_CPU_CALLS,
+
+        MULTI_DRAW_MODE_COUNT
+    };
+
+    const std::vector<MultiDrawMesh> meshes = CreateMultiDrawMeshes();
+
+    // Objects on a grid, the mesh of each object cycles through all meshes
+    const UINT gridSize = UINT(std::ceil(std::sqrt(double(MULTI_DRAW_OBJECT_COUNT))));
+    std::vector<MultiDrawObjectConstants> objectConstants(MULTI_DRAW_OBJECT_COUNT);
+    std::vector<UINT> objectMeshes(MULTI_DRAW_OBJECT_COUNT);
+    UINT indexedObjectCount = 0U;
+    for (UINT i = 0; i < MULTI_DRAW_OBJECT_COUNT; ++i)
+    {
+        const UINT hash = i * 2654435761U;
+        objectConstants[i] = MultiDrawObjectConstants{
+            .offset { (float(i % gridSize) + 0.5f) * 2.0f / float(gridSize) - 1.0f, (float(i / gridSize) + 0.5f) * 2.0f / float(gridSize) - 1.0f },
+            .scale = 0.8f / float(gridSize),
+            .color = (hash & 0x00ffffffU) | 0xff000000U
+        };
+        objectMeshes[i] = (i * 7U + i / gridSize) % MULTI_DRAW_MESH_COUNT;
+        if (!meshes[objectMeshes[i]].indices.empty()) {
+            ++indexedObjectCount;
+        }
+    }
+
+    std::vector<size_t> positionOffsets, indexOffsets;
+    const size_t geometryBufferSize = GetMultiDrawGeometryLayout(meshes, positionOffsets, indexOffsets);
+
+    IndirectArgumentStream drawStream = CreateIndirectArgumentStream(MULTI_DRAW_ARGUMENT_DESCS, UINT(std::size(MULTI_DRAW_ARGUMENT_DESCS)), MULTI_DRAW_OBJECT_COUNT - indexedObjectCount);
+    IndirectArgumentStream drawIndexedStream = CreateIndirectArgumentStream(MULTI_DRAW_INDEXED_ARGUMENT_DESCS, UINT(std::size(MULTI_DRAW_INDEXED_ARGUMENT_DESCS)), indexedObjectCount);
+
+    // Argument buffer: [geometry][draw stream][draw indexed stream]
+    const size_t drawStreamOffset = (geometryBufferSize + CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U) & ~size_t(CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U);
+    const size_t drawIndexedStreamOffset = drawStreamOffset + ((drawStream.data.size() + CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U) & ~size_t(CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U));
+    const size_t deviceBufferSize = drawIndexedStreamOffset + drawIndexedStream.data.size();
+
+    constexpr UINT timestampCount = MULTI_DRAW_MODE_COUNT * 2U;
+
+    ID3D12RootSignature* rootSignature = nullptr;
+    ID3D12PipelineState* pipelineState = nullptr;
+    ID3D12CommandSignature* drawCommandSignature = nullptr;
+    ID3D12CommandSignature* drawIndexedCommandSignature = nullptr;
+    ID3D12GraphicsCommandList* commandList = nullptr;
+    ID3D12DescriptorHeap* rtvDescriptorHeap = nullptr;
+    ID3D12QueryHeap* queryHeap = nullptr;
+    ID3D12Resource* renderTargetTexture = nullptr;
+    ID3D12Resource* uploadDevHostBuffer = nullptr;
+    ID3D12Resource* deviceBuffer = nullptr;
+    ID3D12Resource* timestampReadbackBuffer = nullptr;
+    bool success = false;
+
+    do
+    {
+        rootSignature = CreateRootSignatureForMultiDraw(d3d_device);
+        if (rootSignature == nullptr) break;
+
+        pipelineState = CreatePipelineStateForMultiDraw(d3d_device, rootSignature, false);
+        if (pipelineState == nullptr) break;
+
+        drawCommandSignature = CreateCommandSignatureForStream(d3d_device, rootSignature, drawStream);
+        if (drawCommandSignature == nullptr) break;
+
+        drawIndexedCommandSignature = CreateCommandSignatureForStream(d3d_device, rootSignature, drawIndexedStream);
+        if (drawIndexedCommandSignature == nullptr) break;
+
+        HRESULT hRes = commandAllocator->Reset();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Reset command allocator for multi-draw failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator, pipelineState, IID_PPV_ARGS(&commandList));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommandList for multi-draw failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc{
+            .Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV,
+            .NumDescriptors = 1,
+            .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
+            .NodeMask = 0
+        };
+        hRes = d3d_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&rtvDescriptorHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateDescriptorHeap for multi-draw render target view failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_QUERY_HEAP_DESC queryHeapDesc{
+            .Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP,
+            .Count = timestampCount,
+            .NodeMask = 0U
+        };
+        hRes = d3d_device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&queryHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateQueryHeap for multi-draw failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+            .Type = D3D12_HEAP_TYPE_DEFAULT,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
+
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = defaultHeapProperties;
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_HEAP_PROPERTIES readbackHeapProperties = defaultHeapProperties;
+        readbackHeapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+        const D3D12_RESOURCE_DESC textureDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
+            .Alignment = 0,
+            .Width = WINDOW_WIDTH,
+            .Height = WINDOW_WIDTH,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = RENDER_TARGET_BUFFER_FOMRAT,
+            .SampleDesc {.Count = 1U, .Quality = 0U },
+            .Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN,
+            .Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET
+        };
+
+        const D3D12_CLEAR_VALUE clearValue{
+            .Format = RENDER_TARGET_BUFFER_FOMRAT,
+            .Color { 0.5f, 0.6f, 0.5f, 1.0f }
+        };
+
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, D3D12_RESOURCE_STATE_RENDER_TARGET,
+                                                &clearValue, IID_PPV_ARGS(&renderTargetTexture));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for multi-draw render target failed: %ld\n", hRes);
+            break;
+        }
+
+        D3D12_RESOURCE_DESC bufferDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0,
+            .Width = deviceBufferSize,
+            .Height = 1U,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {.Count = 1U, .Quality = 0 },
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE
+        };
+        hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadDevHostBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for multi-draw upload buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&deviceBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for multi-draw device buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = timestampCount * sizeof(UINT64);
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&timestampReadbackBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for multi-draw timestamp read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        // The buffer views that the commands carry point into the device buffer
+        std::vector<D3D12_VERTEX_BUFFER_VIEW> vertexBufferViews;
+        std::vector<D3D12_INDEX_BUFFER_VIEW> indexBufferViews;
+        CreateMultiDrawBufferViews(meshes, positionOffsets, indexOffsets, deviceBuffer->GetGPUVirtualAddress(), vertexBufferViews, indexBufferViews);
+
+        UINT drawCommandIndex = 0U, drawIndexedCommandIndex = 0U;
+        for (UINT i = 0; i < MULTI_DRAW_OBJECT_COUNT; ++i)
+        {
+            const UINT meshIndex = objectMeshes[i];
+            if (meshes[meshIndex].indices.empty())
+            {
+                const D3D12_DRAW_ARGUMENTS drawArguments{
+                    .VertexCountPerInstance = UINT(meshes[meshIndex].positions.size() / 2U),
+                    .InstanceCount = 1U,
+                    .StartVertexLocation = 0U,
+                    .StartInstanceLocation = 0U
+                };
+                WriteIndirectArgument(drawStream, drawCommandIndex, 0U, &objectConstants[i]);
+                WriteIndirectArgument(drawStream, drawCommandIndex, 1U, &vertexBufferViews[meshIndex]);
+                WriteIndirectArgument(drawStream, drawCommandIndex, 2U, &drawArguments);
+                ++drawCommandIndex;
+            }
+            else
+            {
+                const D3D12_DRAW_INDEXED_ARGUMENTS drawIndexedArguments{
+                    .IndexCountPerInstance = UINT(meshes[meshIndex].indices.size()),
+                    .InstanceCount = 1U,
+                    .StartIndexLocation = 0U,
+                    .BaseVertexLocation = 0,
+                    .StartInstanceLocation = 0U
+                };
+                WriteIndirectArgument(drawIndexedStream, drawIndexedCommandIndex, 0U, &objectConstants[i]);
+                WriteIndirectArgument(drawIndexedStream, drawIndexedCommandIndex, 1U, &vertexBufferViews[meshIndex]);
+                WriteIndirectArgument(drawIndexedStream, drawIndexedCommandIndex, 2U, &indexBufferViews[meshIndex]);
+                WriteIndirectArgument(drawIndexedStream, drawIndexedCommandIndex, 3U, &drawIndexedArguments);
+                ++drawIndexedCommandIndex;
+            }
+        }
+
+        uint8_t* hostMemPtr = nullptr;
+        hRes = uploadDevHostBuffer->Map(0, nullptr, (void**)&hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map multi-draw upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        WriteMultiDrawGeometry(meshes, positionOffsets, indexOffsets, hostMemPtr);
+        memcpy(hostMemPtr + drawStreamOffset, drawStream.data.data(), drawStream.data.size());
+        memcpy(hostMemPtr + drawIndexedStreamOffset, drawIndexedStream.data.data(), drawIndexedStream.data.size());
+        uploadDevHostBuffer->Unmap(0, nullptr);
+
+        // GENERIC_READ covers the vertex buffer, index buffer and indirect argument uses of the device buffer
+        WriteToDeviceResourceAndSync(commandList, deviceBuffer, uploadDevHostBuffer, 0U, 0U, deviceBufferSize);
+
+        const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = rtvDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
+        d3d_device->CreateRenderTargetView(renderTargetTexture, nullptr, rtvHandle);
+
+        const D3D12_VIEWPORT viewPort{
+            .TopLeftX = 0.0f,
+            .TopLeftY = 0.0f,
+            .Width = FLOAT(WINDOW_WIDTH),
+            .Height = FLOAT(WINDOW_WIDTH),
+            .MinDepth = 0.0f,
+            .MaxDepth = 1.0f
+        };
+        commandList->RSSetViewports(1, &viewPort);
+
+        const D3D12_RECT scissorRect{
+            .left = 0,
+            .top = 0,
+            .right = LONG(WINDOW_WIDTH),
+            .bottom = LONG(WINDOW_WIDTH)
+        };
+        commandList->RSSetScissorRects(1, &scissorRect);
+
+        commandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+        commandList->SetGraphicsRootSignature(rootSignature);
+        commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+        LARGE_INTEGER frequency{ };
+        QueryPerformanceFrequency(&frequency);
+        double recordingTimes[MULTI_DRAW_MODE_COUNT]{ };
+
+        for (UINT mode = 0; mode < MULTI_DRAW_MODE_COUNT; ++mode)
+        {
+            commandList->ClearRenderTargetView(rtvHandle, clearValue.Color, 0, nullptr);
+            commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, mode * 2U);
+
+            LARGE_INTEGER beginTime{ }, endTime{ };
+            QueryPerformanceCounter(&beginTime);
+
+            for (UINT iteration = 0; iteration < MULTI_DRAW_ITERATION_COUNT; ++iteration)
+            {
+                if (mode == MULTI_DRAW_MODE_EXECUTE_INDIRECT)
+                {
+                    commandList->ExecuteIndirect(drawCommandSignature, drawStream.commandCount, deviceBuffer, drawStreamOffset, nullptr, 0U);
+                    commandList->ExecuteIndirect(drawIndexedCommandSignature, drawIndexedStream.commandCount, deviceBuffer, drawIndexedStreamOffset, nullptr, 0U);
+                    continue;
+                }
+
+                // The same commands in the same order as the two argument streams
+                for (int indexed = 0; indexed < 2; ++indexed)
+                {
+                    for (UINT i = 0; i < MULTI_DRAW_OBJECT_COUNT; ++i)
+                    {
+                        const UINT meshIndex = objectMeshes[i];
+                        if (meshes[meshIndex].indices.empty() == (indexed != 0)) continue;
+
+                        commandList->SetGraphicsRoot32BitConstants(0, UINT(sizeof(MultiDrawObjectConstants) / sizeof(UINT)), &objectConstants[i], 0);
+                        commandList->IASetVertexBuffers(0, 1, &vertexBufferViews[meshIndex]);
+                        if (indexed == 0) {
+                            commandList->DrawInstanced(UINT(meshes[meshIndex].positions.size() / 2U), 1U, 0U, 0U);
+                        }
+                        else
+                        {
+                            commandList->IASetIndexBuffer(&indexBufferViews[meshIndex]);
+                            commandList->DrawIndexedInstanced(UINT(meshes[meshIndex].indices.size()), 1U, 0U, 0, 0U);
+                        }
+                    }
+                }
+            }
+
+            QueryPerformanceCounter(&endTime);
+            recordingTimes[mode] = double(endTime.QuadPart - beginTime.QuadPart) * 1000.0 / double(frequency.QuadPart);
+
+            commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, mode * 2U + 1U);
+        }
+
+        commandList->ResolveQueryData(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0U, timestampCount, timestampReadbackBuffer, 0U);
+
+        hRes = commandList->Close();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Close multi-draw command list failed: %ld\n", hRes);
+            break;
+        }
+
+        ID3D12CommandList* const ppCommandLists[] = { (ID3D12CommandList*)commandList };
+        commandQueue->ExecuteCommandLists((UINT)std::size(ppCommandLists), ppCommandLists);
+
+        if (!WaitForPreviousFrame(commandQueue)) break;
+
+        UINT64 timestampFrequency = 0;
+        hRes = commandQueue->GetTimestampFrequency(&timestampFrequency);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "GetTimestampFrequency failed: %ld\n", hRes);
+            break;
+        }
+
+        const UINT64* timestamps = nullptr;
+        hRes = timestampReadbackBuffer->Map(0, nullptr, (void**)&timestamps);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map multi-draw timestamp read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        printf("Multi-draw indirect: %u objects (%u draws with a %u-byte stride, %u indexed draws with a %u-byte stride), %u iterations\n",
+                MULTI_DRAW_OBJECT_COUNT, drawStream.commandCount, drawStream.byteStride, drawIndexedStream.commandCount, drawIndexedStream.byteStride,
+                MULTI_DRAW_ITERATION_COUNT);
+        const char* const modeNames[MULTI_DRAW_MODE_COUNT] = { "ExecuteIndirect", "per-object CPU calls" };
+        for (UINT mode = 0; mode < MULTI_DRAW_MODE_COUNT; ++mode)
+        {
+            printf("    %-20s GPU: %.3f ms, CPU recording: %.3f ms per iteration\n", modeNames[mode],
+                    double(timestamps[mode * 2U + 1U] - timestamps[mode * 2U]) * 1000.0 / double(timestampFrequency) / MULTI_DRAW_ITERATION_COUNT,
+                    recordingTimes[mode] / MULTI_DRAW_ITERATION_COUNT);
+        }
+
+        timestampReadbackBuffer->Unmap(0, nullptr);
+
+        success = true;
+    }
+    while (false);
+
+    if (rootSignature != nullptr) {
+        rootSignature->Release();
+    }
+    if (pipelineState != nullptr) {
+        pipelineState->Release();
+    }
+    if (drawCommandSignature != nullptr) {
+        drawCommandSignature->Release();
+    }
+    if (drawIndexedCommandSignature != nullptr) {
+        drawIndexedCommandSignature->Release();
+    }
+    if (commandList != nullptr) {
+        commandList->Release();
+    }
+    if (rtvDescriptorHeap != nullptr) {
+        rtvDescriptorHeap->Release();
+    }
+    if (queryHeap != nullptr) {
+        queryHeap->Release();
+    }
+    if (renderTargetTexture != nullptr) {
+        renderTargetTexture->Release();
+    }
+    if (uploadDevHostBuffer != nullptr) {
+        uploadDevHostBuffer->Release();
+    }
+    if (deviceBuffer != nullptr) {
+        deviceBuffer->Release();
+    }
+    if (timestampReadbackBuffer != nullptr) {
+        timestampReadbackBuffer->Release();
+    }
+
+    return success;
+}
+#endif
+
+#if RUN_DRAW_SORT_BENCHMARK
+// The same layout as CBSort in the draw_sort_*.comp.hlsl shaders
+struct DrawSortConstants
+{
+    UINT drawCount;
+    UINT blockCount;            // number of DRAW_SORT_GROUP_SIZE element blocks
+    UINT shift;                 // bit offset of the radix digit in the key
+    UINT bucketRegionSize;      // in bytes
+    UINT commandStrides[DRAW_SORT_SIGNATURE_COUNT];
+};
+
+enum DRAW_SORT_KERNEL_ID
+{
+    DRAW_SORT_KERNEL_COUNT_DIGITS,
+    DRAW_SORT_KERNEL_SCAN_DIGITS,
+    DRAW_SORT_KERNEL_SCATTER,
+    DRAW_SORT_KERNEL_REORDER_ARGUMENTS,
+
+    DRAW_SORT_KERNEL_COUNT
+};
+
+// 64-bit draw key with the most expensive state change in the most significant field:
+// pipeline in bits 44-47, command signature in bits 40-43, material in bits 32-39 and depth in bits 0-31.
+// depth is not negative, so its IEEE 754 bits sort like its value and the draws of a bucket go front to back.
+static auto MakeDrawSortKey(UINT pipeline, UINT signature, UINT material, float depth) -> uint64_t
+{
+    UINT depthBits = 0U;
+    memcpy(&depthBits, &depth, sizeof(depthBits));
+    return (uint64_t(pipeline) << 44) | (uint64_t(signature) << 40) | (uint64_t(material) << 32) | depthBits;
+}
+
+static auto GetDrawSortBucket(uint64_t key) -> UINT
+{
+    return UINT(key >> 44 & 0xfU) * DRAW_SORT_SIGNATURE_COUNT + UINT(key >> 40 & 0xfU);
+}
+
+// CPU reference of the GPU radix sort, which is stable as well
+// @return the draw indices in key order
+static auto SortDrawKeysOnCPU(const std::vector<uint64_t>& keys) -> std::vector<UINT>
+{
+    std::vector<UINT> order(keys.size());
+    for (UINT i = 0; i < UINT(keys.size()); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&keys](UINT a, UINT b) { return keys[a] < keys[b]; });
+    return order;
+}
+
+// @return the number of SetPipelineState() calls and of vertex/index buffer rebinds for a material change when the draws are submitted in this order
+static auto CountDrawStateChanges(const std::vector<UINT>& order, const std::vector<uint64_t>& keys) -> std::pair<UINT, UINT>
+{
+    UINT pipelineChanges = 0U, materialChanges = 0U;
+    uint64_t previousKey = UINT64_MAX;
+    for (const UINT drawIndex : order)
+    {
+        const uint64_t key = keys[drawIndex];
+        if ((key >> 44) != (previousKey >> 44)) {
+            ++pipelineChanges;
+        }
+        if ((key >> 32) != (previousKey >> 32)) {
+            ++materialChanges;
+        }
+        previousKey = key;
+    }
+    return std::make_pair(pipelineChanges, materialChanges);
+}
+
+static auto CreateRootSignatureForDrawSort(ID3D12Device* d3d_device) -> ID3D12RootSignature*
+{
+    ID3D12RootSignature* rootSignature = nullptr;
+
+    const D3D12_ROOT_PARAMETER rootParameters[]{
+        {
+            // b0 (sort constants)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+            .Constants {
+                .ShaderRegister = 0U,
+                .RegisterSpace = 0U,
+                .Num32BitValues = UINT(sizeof(DrawSortConstants) / sizeof(UINT))
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        {
+            // u0 (source elements)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV,
+            .Descriptor {.ShaderRegister = 0U, .RegisterSpace = 0U },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        {
+            // u1 (destination elements)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV,
+            .Descriptor {.ShaderRegister = 1U, .RegisterSpace = 0U },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        {
+            // u2 (block digit histograms)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV,
+            .Descriptor {.ShaderRegister = 2U, .RegisterSpace = 0U },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        {
+            // u3 (bucket counts)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV,
+            .Descriptor {.ShaderRegister = 3U, .RegisterSpace = 0U },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        {
+            // t0 (source arguments)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV,
+            .Descriptor {.ShaderRegister = 0U, .RegisterSpace = 0U },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        {
+            // u4 (sorted arguments)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV,
+            .Descriptor {.ShaderRegister = 4U, .RegisterSpace = 0U },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        }
+    };
+
+    const D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {
+        .NumParameters = UINT(std::size(rootParameters)),
+        .pParameters = rootParameters,
+        .NumStaticSamplers = 0,
+        .pStaticSamplers = nullptr,
+        .Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE
+    };
+
+    ID3DBlob* signature = nullptr;
+    ID3DBlob* error = nullptr;
+    HRESULT hRes = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error);
+    do
+    {
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "D3D12SerializeRootSignature for draw sort failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateRootSignature for draw sort failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (signature != nullptr) {
+        signature->Release();
+    }
+    if (error != nullptr) {
+        error->Release();
+    }
+
+    if (FAILED(hRes)) return nullptr;
+
+    return rootSignature;
+}
+
+static auto CreateComputePipelineStateForDrawSort(ID3D12Device* d3d_device, ID3D12RootSignature* rootSignature, const char* shaderPath) -> ID3D12PipelineState*
+{
+    D3D12_SHADER_BYTECODE computeShaderObj = CreateCompiledShaderObjectFromPath(shaderPath);
+    if (computeShaderObj.pShaderBytecode == nullptr || computeShaderObj.BytecodeLength == 0) return nullptr;
+
+    const D3D12_COMPUTE_PIPELINE_STATE_DESC computePipelineStateDesc{
+        .pRootSignature = rootSignature,
+        .CS = computeShaderObj,
+        .NodeMask = 0,
+        .CachedPSO { },
+        .Flags = D3D12_PIPELINE_STATE_FLAG_NONE
+    };
+
+    ID3D12PipelineState* pipelineState = nullptr;
+    const HRESULT hRes = d3d_device->CreateComputePipelineState(&computePipelineStateDesc, IID_PPV_ARGS(&pipelineState));
+    free((void*)computeShaderObj.pShaderBytecode);
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CreateComputePipelineState for %s failed: %ld\n", shaderPath, hRes);
+        return nullptr;
+    }
+
+    return pipelineState;
+}
+
+// Generates DRAW_SORT_DRAW_COUNT draws in random state order, sorts their 64-bit state keys on the GPU with a 4-bit LSD radix sort
+// and moves their arguments into one region per state bucket. The unsorted draws are submitted with per-draw CPU calls that only
+// change the state when it differs from the previous draw, the sorted draws with one ExecuteIndirect() per bucket whose count is in
+// the count buffer. The GPU order is validated against a CPU stable sort, and the state changes and GPU times of both paths are reported.
+static auto RunDrawSortBenchmark(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator) -> bool
+{
+    enum DRAW_SORT_TIMESTAMP_ID
+    {
+        DRAW_SORT_TIMESTAMP_SORT_BEGIN,
+        DRAW_SORT_TIMESTAMP_SORT_END,
+        DRAW_SORT_TIMESTAMP_UNSORTED_BEGIN,
+        DRAW_SORT_TIMESTAMP_UNSORTED_END,
+        DRAW_SORT_TIMESTAMP_SORTED_BEGIN,
+        DRAW_SORT_TIMESTAMP_SORTED_END,
+
+        DRAW_SORT_TIMESTAMP_COUNT
+    };
+
+    const char* const kernelPaths[DRAW_SORT_KERNEL_COUNT]{
+        "cso/draw_sort_count.comp.cso",
+        "cso/draw_sort_scan.comp.cso",
+        "cso/draw_sort_scatter.comp.cso",
+        "cso/draw_sort_reorder.comp.cso"
+    };
+
+    const std::vector<MultiDrawMesh> meshes = CreateMultiDrawMeshes();
+    const UINT materialsPerMesh = DRAW_SORT_MATERIAL_COUNT / UINT(meshes.size());
+
+    // Random draws: every material uses one mesh and one color
+    std::vector<MultiDrawObjectConstants> drawConstants(DRAW_SORT_DRAW_COUNT);
+    std::vector<uint64_t> keys(DRAW_SORT_DRAW_COUNT);
+    UINT randomState = 0x12345678U;
+    auto const nextRandom = [&randomState]() -> UINT {
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 17;
+        randomState ^= randomState << 5;
+        return randomState;
+    };
+
+    for (UINT i = 0; i < DRAW_SORT_DRAW_COUNT; ++i)
+    {
+        const UINT pipeline = nextRandom() % DRAW_SORT_PIPELINE_COUNT;
+        const UINT material = nextRandom() % DRAW_SORT_MATERIAL_COUNT;
+        const UINT signature = meshes[material / materialsPerMesh].indices.empty() ? 0U : 1U;
+        const float depth = float(nextRandom() >> 8) / float(1U << 24);
+        const UINT colorHash = (material % materialsPerMesh + 1U) * 2654435761U;
+
+        drawConstants[i] = MultiDrawObjectConstants{
+            .offset { float(nextRandom() >> 8) / float(1U << 23) - 1.0f, float(nextRandom() >> 8) / float(1U << 23) - 1.0f },
+            .scale = 0.02f,
+            .color = pipeline == 0U ? (colorHash & 0x00ffffffU) | 0xff000000U : (colorHash & 0x001f1f1fU) | 0xff000000U
+        };
+        keys[i] = MakeDrawSortKey(pipeline, signature, material, depth);
+    }
+
+    LARGE_INTEGER frequency{ };
+    QueryPerformanceFrequency(&frequency);
+
+    LARGE_INTEGER beginTime{ }, endTime{ };
+    QueryPerformanceCounter(&beginTime);
+    const std::vector<UINT> referenceOrder = SortDrawKeysOnCPU(keys);
+    QueryPerformanceCounter(&endTime);
+    const double cpuSortTime = double(endTime.QuadPart - beginTime.QuadPart) * 1000.0 / double(frequency.QuadPart);
+
+    UINT referenceBucketCounts[DRAW_SORT_BUCKET_COUNT]{ };
+    for (const uint64_t key : keys) {
+        ++referenceBucketCounts[GetDrawSortBucket(key)];
+    }
+
+    std::vector<UINT> submissionOrder(DRAW_SORT_DRAW_COUNT);
+    for (UINT i = 0; i < DRAW_SORT_DRAW_COUNT; ++i) {
+        submissionOrder[i] = i;
+    }
+    const auto unsortedStateChanges = CountDrawStateChanges(submissionOrder, keys);
+    const auto sortedStateChanges = CountDrawStateChanges(referenceOrder, keys);
+
+    // Source arguments of every draw in the format of its command signature, behind the geometry
+    std::vector<size_t> positionOffsets, indexOffsets;
+    const size_t geometryBufferSize = GetMultiDrawGeometryLayout(meshes, positionOffsets, indexOffsets);
+
+    UINT indexedDrawCount = 0U;
+    for (const uint64_t key : keys) {
+        indexedDrawCount += UINT(key >> 40 & 0xfU);
+    }
+
+    IndirectArgumentStream drawStream = CreateIndirectArgumentStream(MULTI_DRAW_ARGUMENT_DESCS, UINT(std::size(MULTI_DRAW_ARGUMENT_DESCS)), DRAW_SORT_DRAW_COUNT - indexedDrawCount);
+    IndirectArgumentStream drawIndexedStream = CreateIndirectArgumentStream(MULTI_DRAW_INDEXED_ARGUMENT_DESCS, UINT(std::size(MULTI_DRAW_INDEXED_ARGUMENT_DESCS)), indexedDrawCount);
+    IndirectArgumentStream* const streams[DRAW_SORT_SIGNATURE_COUNT]{ &drawStream, &drawIndexedStream };
+
+    const size_t drawStreamOffset = (geometryBufferSize + CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U) & ~size_t(CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U);
+    const size_t drawIndexedStreamOffset = drawStreamOffset + ((drawStream.data.size() + CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U) & ~size_t(CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U));
+    const size_t deviceBufferSize = drawIndexedStreamOffset + drawIndexedStream.data.size();
+    const size_t streamOffsets[DRAW_SORT_SIGNATURE_COUNT]{ drawStreamOffset, drawIndexedStreamOffset };
+
+    const UINT blockCount = (DRAW_SORT_DRAW_COUNT + DRAW_SORT_GROUP_SIZE - 1U) / DRAW_SORT_GROUP_SIZE;
+    const size_t elementBufferSize = size_t(DRAW_SORT_DRAW_COUNT) * sizeof(UINT) * 4U;
+    const size_t histogramBufferSize = size_t(blockCount) * DRAW_SORT_DIGIT_COUNT * sizeof(UINT);
+    const size_t bucketCountBufferSize = DRAW_SORT_BUCKET_COUNT * sizeof(UINT);
+
+    // Every bucket region can hold all draws
+    const UINT bucketRegionSize = DRAW_SORT_DRAW_COUNT * (std::max)(drawStream.byteStride, drawIndexedStream.byteStride);
+
+    // Upload buffer: [geometry and source arguments][elements][zero bucket counts]
+    const size_t uploadElementOffset = (deviceBufferSize + 15U) & ~size_t(15U);
+    const size_t uploadCountOffset = uploadElementOffset + elementBufferSize;
+    const size_t uploadBufferSize = uploadCountOffset + bucketCountBufferSize;
+
+    ID3D12RootSignature* rootSignature = nullptr;
+    ID3D12RootSignature* sortRootSignature = nullptr;
+    ID3D12PipelineState* pipelineStates[DRAW_SORT_PIPELINE_COUNT]{ };
+    ID3D12PipelineState* sortPipelineStates[DRAW_SORT_KERNEL_COUNT]{ };
+    ID3D12CommandSignature* commandSignatures[DRAW_SORT_SIGNATURE_COUNT]{ };
+    ID3D12GraphicsCommandList* commandList = nullptr;
+    ID3D12DescriptorHeap* rtvDescriptorHeap = nullptr;
+    ID3D12QueryHeap* queryHeap = nullptr;
+    ID3D12Resource* renderTargetTexture = nullptr;
+    ID3D12Resource* uploadDevHostBuffer = nullptr;
+    ID3D12Resource* deviceBuffer = nullptr;
+    ID3D12Resource* elementBuffers[2]{ };
+    ID3D12Resource* histogramBuffer = nullptr;
+    ID3D12Resource* bucketCountBuffer = nullptr;
+    ID3D12Resource* sortedArgumentBuffer = nullptr;
+    ID3D12Resource* elementReadbackBuffer = nullptr;
+    ID3D12Resource* countReadbackBuffer = nullptr;
+    ID3D12Resource* timestampReadbackBuffer = nullptr;
+    bool success = false;
+
+    do
+    {
+        rootSignature = CreateRootSignatureForMultiDraw(d3d_device);
+        if (rootSignature == nullptr) break;
+
+        sortRootSignature = CreateRootSignatureForDrawSort(d3d_device);
+        if (sortRootSignature == nullptr) break;
+
+        bool pipelinesCreated = true;
+        for (UINT i = 0; i < DRAW_SORT_PIPELINE_COUNT; ++i)
+        {
+            pipelineStates[i] = CreatePipelineStateForMultiDraw(d3d_device, rootSignature, i != 0U);
+            pipelinesCreated = pipelinesCreated && pipelineStates[i] != nullptr;
+        }
+        for (UINT i = 0; i < DRAW_SORT_KERNEL_COUNT; ++i)
+        {
+            sortPipelineStates[i] = CreateComputePipelineStateForDrawSort(d3d_device, sortRootSignature, kernelPaths[i]);
+            pipelinesCreated = pipelinesCreated && sortPipelineStates[i] != nullptr;
+        }
+        for (UINT i = 0; i < DRAW_SORT_SIGNATURE_COUNT; ++i)
+        {
+            commandSignatures[i] = CreateCommandSignatureForStream(d3d_device, rootSignature, *streams[i]);
+            pipelinesCreated = pipelinesCreated && commandSignatures[i] != nullptr;
+        }
+        if (!pipelinesCreated) break;
+
+        HRESULT hRes = commandAllocator->Reset();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Reset command allocator for draw sort failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator, nullptr, IID_PPV_ARGS(&commandList));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommandList for draw sort failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc{
+            .Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV,
+            .NumDescriptors = 1,
+            .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
+            .NodeMask = 0
+        };
+        hRes = d3d_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&rtvDescriptorHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateDescriptorHeap for draw sort render target view failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_QUERY_HEAP_DESC queryHeapDesc{
+            .Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP,
+            .Count = DRAW_SORT_TIMESTAMP_COUNT,
+            .NodeMask = 0U
+        };
+        hRes = d3d_device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&queryHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateQueryHeap for draw sort failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+            .Type = D3D12_HEAP_TYPE_DEFAULT,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
+
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = defaultHeapProperties;
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_HEAP_PROPERTIES readbackHeapProperties = defaultHeapProperties;
+        readbackHeapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+        const D3D12_RESOURCE_DESC textureDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
+            .Alignment = 0,
+            .Width = WINDOW_WIDTH,
+            .Height = WINDOW_WIDTH,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = RENDER_TARGET_BUFFER_FOMRAT,
+            .SampleDesc {.Count = 1U, .Quality = 0U },
+            .Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN,
+            .Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET
+        };
+
+        const D3D12_CLEAR_VALUE clearValue{
+            .Format = RENDER_TARGET_BUFFER_FOMRAT,
+            .Color { 0.0f, 0.0f, 0.0f, 1.0f }
+        };
+
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, D3D12_RESOURCE_STATE_RENDER_TARGET,
+                                                &clearValue, IID_PPV_ARGS(&renderTargetTexture));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for draw sort render target failed: %ld\n", hRes);
+            break;
+        }
+
+        D3D12_RESOURCE_DESC bufferDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0,
+            .Width = uploadBufferSize,
+            .Height = 1U,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {.Count = 1U, .Quality = 0 },
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE
+        };
+        hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadDevHostBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for draw sort upload buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = deviceBufferSize;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&deviceBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for draw sort device buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = elementBufferSize;
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&elementReadbackBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for draw sort element read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = bucketCountBufferSize;
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&countReadbackBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for draw sort count read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = DRAW_SORT_TIMESTAMP_COUNT * sizeof(UINT64);
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&timestampReadbackBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for draw sort timestamp read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        // Buffers written by the sort kernels
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        const std::pair<ID3D12Resource**, size_t> uavBuffers[]{
+            { &elementBuffers[0], elementBufferSize },
+            { &elementBuffers[1], elementBufferSize },
+            { &histogramBuffer, histogramBufferSize },
+            { &bucketCountBuffer, bucketCountBufferSize },
+            { &sortedArgumentBuffer, size_t(bucketRegionSize) * DRAW_SORT_BUCKET_COUNT }
+        };
+        for (const auto& uavBuffer : uavBuffers)
+        {
+            bufferDesc.Width = uavBuffer.second;
+            hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                    D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(uavBuffer.first));
+            if (FAILED(hRes)) break;
+        }
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for draw sort UAV buffers failed: %ld\n", hRes);
+            break;
+        }
+
+        // Source arguments and sort elements
+        std::vector<D3D12_VERTEX_BUFFER_VIEW> vertexBufferViews;
+        std::vector<D3D12_INDEX_BUFFER_VIEW> indexBufferViews;
+        CreateMultiDrawBufferViews(meshes, positionOffsets, indexOffsets, deviceBuffer->GetGPUVirtualAddress(), vertexBufferViews, indexBufferViews);
+
+        std::vector<UINT> elements(size_t(DRAW_SORT_DRAW_COUNT) * 4U);
+        UINT commandCounts[DRAW_SORT_SIGNATURE_COUNT]{ };
+        for (UINT i = 0; i < DRAW_SORT_DRAW_COUNT; ++i)
+        {
+            const UINT meshIndex = UINT(keys[i] >> 32 & 0xffU) / materialsPerMesh;
+            const UINT signature = UINT(keys[i] >> 40 & 0xfU);
+            const UINT commandIndex = commandCounts[signature]++;
+            IndirectArgumentStream& stream = *streams[signature];
+
+            WriteIndirectArgument(stream, commandIndex, 0U, &drawConstants[i]);
+            WriteIndirectArgument(stream, commandIndex, 1U, &vertexBufferViews[meshIndex]);
+            if (signature == 0U)
+            {
+                const D3D12_DRAW_ARGUMENTS drawArguments{
+                    .VertexCountPerInstance = UINT(meshes[meshIndex].positions.size() / 2U),
+                    .InstanceCount = 1U,
+                    .StartVertexLocation = 0U,
+                    .StartInstanceLocation = 0U
+                };
+                WriteIndirectArgument(stream, commandIndex, 2U, &drawArguments);
+            }
+            else
+            {
+                const D3D12_DRAW_INDEXED_ARGUMENTS drawIndexedArguments{
+                    .IndexCountPerInstance = UINT(meshes[meshIndex].indices.size()),
+                    .InstanceCount = 1U,
+                    .StartIndexLocation = 0U,
+                    .BaseVertexLocation = 0,
+                    .StartInstanceLocation = 0U
+                };
+                WriteIndirectArgument(stream, commandIndex, 2U, &indexBufferViews[meshIndex]);
+                WriteIndirectArgument(stream, commandIndex, 3U, &drawIndexedArguments);
+            }
+
+            elements[i * 4U + 0U] = UINT(keys[i]);
+            elements[i * 4U + 1U] = UINT(keys[i] >> 32);
+            elements[i * 4U + 2U] = i;
+            elements[i * 4U + 3U] = UINT(streamOffsets[signature] + size_t(commandIndex) * stream.byteStride);
+        }
+
+        uint8_t* hostMemPtr = nullptr;
+        hRes = uploadDevHostBuffer->Map(0, nullptr, (void**)&hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map draw sort upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        WriteMultiDrawGeometry(meshes, positionOffsets, indexOffsets, hostMemPtr);
+        memcpy(hostMemPtr + drawStreamOffset, drawStream.data.data(), drawStream.data.size());
+        memcpy(hostMemPtr + drawIndexedStreamOffset, drawIndexedStream.data.data(), drawIndexedStream.data.size());
+        memcpy(hostMemPtr + uploadElementOffset, elements.data(), elementBufferSize);
+        memset(hostMemPtr + uploadCountOffset, 0, bucketCountBufferSize);
+        uploadDevHostBuffer->Unmap(0, nullptr);
+
+        // GENERIC_READ covers the vertex buffer, index buffer and shader resource uses of the device buffer
+        WriteToDeviceResourceAndSync(commandList, deviceBuffer, uploadDevHostBuffer, 0U, 0U, deviceBufferSize);
+        WriteToDeviceResourceAndSync(commandList, elementBuffers[0], uploadDevHostBuffer, 0U, uploadElementOffset, elementBufferSize);
+        WriteToDeviceResourceAndSync(commandList, bucketCountBuffer, uploadDevHostBuffer, 0U, uploadCountOffset, bucketCountBufferSize);
+
+        D3D12_RESOURCE_BARRIER barriers[]{
+            {
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = elementBuffers[0],
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_GENERIC_READ,
+                    .StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+                }
+            },
+            {
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = bucketCountBuffer,
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_GENERIC_READ,
+                    .StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+                }
+            }
+        };
+        commandList->ResourceBarrier(UINT(std::size(barriers)), barriers);
+
+        // ======== Sort ========
+
+        const D3D12_RESOURCE_BARRIER uavBarrier{
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_UAV,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .UAV {.pResource = nullptr }
+        };
+
+        DrawSortConstants sortConstants{
+            .drawCount = DRAW_SORT_DRAW_COUNT,
+            .blockCount = blockCount,
+            .shift = 0U,
+            .bucketRegionSize = bucketRegionSize,
+            .commandStrides { drawStream.byteStride, drawIndexedStream.byteStride }
+        };
+
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, DRAW_SORT_TIMESTAMP_SORT_BEGIN);
+
+        commandList->SetComputeRootSignature(sortRootSignature);
+        commandList->SetComputeRootUnorderedAccessView(3, histogramBuffer->GetGPUVirtualAddress());
+        commandList->SetComputeRootUnorderedAccessView(4, bucketCountBuffer->GetGPUVirtualAddress());
+        commandList->SetComputeRootShaderResourceView(5, deviceBuffer->GetGPUVirtualAddress());
+        commandList->SetComputeRootUnorderedAccessView(6, sortedArgumentBuffer->GetGPUVirtualAddress());
+
+        // An even number of passes leaves the sorted elements in elementBuffers[0]
+        static_assert(DRAW_SORT_KEY_BIT_COUNT % (DRAW_SORT_DIGIT_BIT_COUNT * 2U) == 0U);
+        for (UINT pass = 0; pass < DRAW_SORT_KEY_BIT_COUNT / DRAW_SORT_DIGIT_BIT_COUNT; ++pass)
+        {
+            sortConstants.shift = pass * DRAW_SORT_DIGIT_BIT_COUNT;
+            commandList->SetComputeRoot32BitConstants(0, UINT(sizeof(sortConstants) / sizeof(UINT)), &sortConstants, 0);
+            commandList->SetComputeRootUnorderedAccessView(1, elementBuffers[pass % 2U]->GetGPUVirtualAddress());
+            commandList->SetComputeRootUnorderedAccessView(2, elementBuffers[(pass + 1U) % 2U]->GetGPUVirtualAddress());
+
+            commandList->SetPipelineState(sortPipelineStates[DRAW_SORT_KERNEL_COUNT_DIGITS]);
+            commandList->Dispatch(blockCount, 1U, 1U);
+            commandList->ResourceBarrier(1U, &uavBarrier);
+
+            commandList->SetPipelineState(sortPipelineStates[DRAW_SORT_KERNEL_SCAN_DIGITS]);
+            commandList->Dispatch(1U, 1U, 1U);
+            commandList->ResourceBarrier(1U, &uavBarrier);
+
+            commandList->SetPipelineState(sortPipelineStates[DRAW_SORT_KERNEL_SCATTER]);
+            commandList->Dispatch(blockCount, 1U, 1U);
+            commandList->ResourceBarrier(1U, &uavBarrier);
+        }
+
+        commandList->SetComputeRootUnorderedAccessView(1, elementBuffers[0]->GetGPUVirtualAddress());
+        commandList->SetPipelineState(sortPipelineStates[DRAW_SORT_KERNEL_REORDER_ARGUMENTS]);
+        commandList->Dispatch(blockCount, 1U, 1U);
+
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, DRAW_SORT_TIMESTAMP_SORT_END);
+
+        SyncAndReadFromDeviceResource(commandList, elementBufferSize, elementReadbackBuffer, elementBuffers[0]);
+        SyncAndReadFromDeviceResource(commandList, bucketCountBufferSize, countReadbackBuffer, bucketCountBuffer);
+
+        barriers[0].Transition.pResource = sortedArgumentBuffer;
+        barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT;
+        barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT;
+        commandList->ResourceBarrier(UINT(std::size(barriers)), barriers);
+
+        // ======== Draw ========
+
+        const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = rtvDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
+        d3d_device->CreateRenderTargetView(renderTargetTexture, nullptr, rtvHandle);
+
+        const D3D12_VIEWPORT viewPort{
+            .TopLeftX = 0.0f,
+            .TopLeftY = 0.0f,
+            .Width = FLOAT(WINDOW_WIDTH),
+            .Height = FLOAT(WINDOW_WIDTH),
+            .MinDepth = 0.0f,
+            .MaxDepth = 1.0f
+        };
+        commandList->RSSetViewports(1, &viewPort);
+
+        const D3D12_RECT scissorRect{
+            .left = 0,
+            .top = 0,
+            .right = LONG(WINDOW_WIDTH),
+            .bottom = LONG(WINDOW_WIDTH)
+        };
+        commandList->RSSetScissorRects(1, &scissorRect);
+
+        commandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+        commandList->SetGraphicsRootSignature(rootSignature);
+        commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+        // Unsorted: the state is only set when it differs from the previous draw
+        commandList->ClearRenderTargetView(rtvHandle, clearValue.Color, 0, nullptr);
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, DRAW_SORT_TIMESTAMP_UNSORTED_BEGIN);
+
+        QueryPerformanceCounter(&beginTime);
+        for (UINT iteration = 0; iteration < DRAW_SORT_ITERATION_COUNT; ++iteration)
+        {
+            uint64_t previousKey = UINT64_MAX;
+            for (UINT i = 0; i < DRAW_SORT_DRAW_COUNT; ++i)
+            {
+                const uint64_t key = keys[i];
+                const UINT meshIndex = UINT(key >> 32 & 0xffU) / materialsPerMesh;
+                if ((key >> 44) != (previousKey >> 44)) {
+                    commandList->SetPipelineState(pipelineStates[key >> 44 & 0xfU]);
+                }
+                if ((key >> 32) != (previousKey >> 32))
+                {
+                    commandList->IASetVertexBuffers(0, 1, &vertexBufferViews[meshIndex]);
+                    if (!meshes[meshIndex].indices.empty()) {
+                        commandList->IASetIndexBuffer(&indexBufferViews[meshIndex]);
+                    }
+                }
+                previousKey = key;
+
+                commandList->SetGraphicsRoot32BitConstants(0, UINT(sizeof(MultiDrawObjectConstants) / sizeof(UINT)), &drawConstants[i], 0);
+                if (meshes[meshIndex].indices.empty()) {
+                    commandList->DrawInstanced(UINT(meshes[meshIndex].positions.size() / 2U), 1U, 0U, 0U);
+                }
+                else {
+                    commandList->DrawIndexedInstanced(UINT(meshes[meshIndex].indices.size()), 1U, 0U, 0, 0U);
+                }
+            }
+        }
+        QueryPerformanceCounter(&endTime);
+        const double unsortedRecordingTime = double(endTime.QuadPart - beginTime.QuadPart) * 1000.0 / double(frequency.QuadPart);
+
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, DRAW_SORT_TIMESTAMP_UNSORTED_END);
+
+        // Sorted: one ExecuteIndirect() per bucket. The command count of every bucket comes from the count buffer.
+        commandList->ClearRenderTargetView(rtvHandle, clearValue.Color, 0, nullptr);
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, DRAW_SORT_TIMESTAMP_SORTED_BEGIN);
+
+        QueryPerformanceCounter(&beginTime);
+        for (UINT iteration = 0; iteration < DRAW_SORT_ITERATION_COUNT; ++iteration)
+        {
+            for (UINT bucket = 0; bucket < DRAW_SORT_BUCKET_COUNT; ++bucket)
+            {
+                commandList->SetPipelineState(pipelineStates[bucket / DRAW_SORT_SIGNATURE_COUNT]);
+                commandList->ExecuteIndirect(commandSignatures[bucket % DRAW_SORT_SIGNATURE_COUNT], DRAW_SORT_DRAW_COUNT, sortedArgumentBuffer,
+                                            UINT64(bucket) * bucketRegionSize, bucketCountBuffer, UINT64(bucket) * sizeof(UINT));
+            }
+        }
+        QueryPerformanceCounter(&endTime);
+        const double sortedRecordingTime = double(endTime.QuadPart - beginTime.QuadPart) * 1000.0 / double(frequency.QuadPart);
+
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, DRAW_SORT_TIMESTAMP_SORTED_END);
+
+        commandList->ResolveQueryData(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0U, DRAW_SORT_TIMESTAMP_COUNT, timestampReadbackBuffer, 0U);
+
+        hRes = commandList->Close();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Close draw sort command list failed: %ld\n", hRes);
+            break;
+        }
+
+        ID3D12CommandList* const ppCommandLists[] = { (ID3D12CommandList*)commandList };
+        commandQueue->ExecuteCommandLists((UINT)std::size(ppCommandLists), ppCommandLists);
+
+        if (!WaitForPreviousFrame(commandQueue)) break;
+
+        UINT64 timestampFrequency = 0;
+        hRes = commandQueue->GetTimestampFrequency(&timestampFrequency);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "GetTimestampFrequency failed: %ld\n", hRes);
+            break;
+        }
+
+        // ======== Validate and report ========
+
+        const UINT* sortedElements = nullptr;
+        hRes = elementReadbackBuffer->Map(0, nullptr, (void**)&sortedElements);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map draw sort element read back buffer failed: %ld\n", hRes);
+            break;
+        }
+        UINT mismatchCount = 0U;
+        for (UINT i = 0; i < DRAW_SORT_DRAW_COUNT; ++i)
+        {
+            if (sortedElements[i * 4U + 2U] != referenceOrder[i]) {
+                ++mismatchCount;
+            }
+        }
+        elementReadbackBuffer->Unmap(0, nullptr);
+
+        const UINT* bucketCounts = nullptr;
+        hRes = countReadbackBuffer->Map(0, nullptr, (void**)&bucketCounts);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map draw sort count read back buffer failed: %ld\n", hRes);
+            break;
+        }
+        UINT executeIndirectCount = 0U;
+        for (UINT bucket = 0; bucket < DRAW_SORT_BUCKET_COUNT; ++bucket)
+        {
+            if (bucketCounts[bucket] != referenceBucketCounts[bucket]) {
+                ++mismatchCount;
+            }
+            if (bucketCounts[bucket] != 0U) {
+                ++executeIndirectCount;
+            }
+        }
+        countReadbackBuffer->Unmap(0, nullptr);
+
+        const UINT64* timestamps = nullptr;
+        hRes = timestampReadbackBuffer->Map(0, nullptr, (void**)&timestamps);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map draw sort timestamp read back buffer failed: %ld\n", hRes);
+            break;
+        }
+        auto const elapsedTime = [timestamps, timestampFrequency](UINT beginIndex) -> double {
+            return double(timestamps[beginIndex + 1U] - timestamps[beginIndex]) * 1000.0 / double(timestampFrequency);
+        };
+        const double sortTime = elapsedTime(DRAW_SORT_TIMESTAMP_SORT_BEGIN);
+        const double unsortedTime = elapsedTime(DRAW_SORT_TIMESTAMP_UNSORTED_BEGIN) / DRAW_SORT_ITERATION_COUNT;
+        const double sortedTime = elapsedTime(DRAW_SORT_TIMESTAMP_SORTED_BEGIN) / DRAW_SORT_ITERATION_COUNT;
+        timestampReadbackBuffer->Unmap(0, nullptr);
+
+        printf("Draw sort: %u draws, %u radix passes in %.3f ms on the GPU (CPU stable sort: %.3f ms), %s\n",
+                DRAW_SORT_DRAW_COUNT, DRAW_SORT_KEY_BIT_COUNT / DRAW_SORT_DIGIT_BIT_COUNT, sortTime, cpuSortTime,
+                mismatchCount == 0U ? "matches the CPU reference" : "DOES NOT match the CPU reference!");
+        printf("    state changes unsorted: %u pipeline, %u material; sorted: %u pipeline, %u material\n",
+                unsortedStateChanges.first, unsortedStateChanges.second, sortedStateChanges.first, sortedStateChanges.second);
+        printf("    unsorted per-draw calls: GPU %.3f ms, CPU recording %.3f ms per iteration\n", unsortedTime, unsortedRecordingTime / DRAW_SORT_ITERATION_COUNT);
+        printf("    sorted, %u non-empty ExecuteIndirect buckets: GPU %.3f ms, CPU recording %.3f ms per iteration\n",
+                executeIndirectCount, sortedTime, sortedRecordingTime / DRAW_SORT_ITERATION_COUNT);
+        printf("    GPU time saved per frame including the sort: %.3f ms\n", unsortedTime - sortedTime - sortTime);
+
+        success = mismatchCount == 0U;
+    }
+    while (false);
+
+    if (rootSignature != nullptr) {
+        rootSignature->Release();
+    }
+    if (sortRootSignature != nullptr) {
+        sortRootSignature->Release();
+    }
+    for (ID3D12PipelineState* pipelineState : pipelineStates)
+    {
+        if (pipelineState != nullptr) {
+            pipelineState->Release();
+        }
+    }
+    for (ID3D12PipelineState* pipelineState : sortPipelineStates)
+    {
+        if (pipelineState != nullptr) {
+            pipelineState->Release();
+        }
+    }
+    for (ID3D12CommandSignature* commandSignature : commandSignatures)
+    {
+        if (commandSignature != nullptr) {
+            commandSignature->Release();
+        }
+    }
+    if (commandList != nullptr) {
+        commandList->Release();
+    }
+    if (rtvDescriptorHeap != nullptr) {
+        rtvDescriptorHeap->Release();
+    }
+    if (queryHeap != nullptr) {
+        queryHeap->Release();
+    }
+    if (renderTargetTexture != nullptr) {
+        renderTargetTexture->Release();
+    }
+    if (uploadDevHostBuffer != nullptr) {
+        uploadDevHostBuffer->Release();
+    }
+    if (deviceBuffer != nullptr) {
+        deviceBuffer->Release();
+    }
+    for (ID3D12Resource* elementBuffer : elementBuffers)
+    {
+        if (elementBuffer != nullptr) {
+            elementBuffer->Release();
+        }
+    }
+    if (histogramBuffer != nullptr) {
+        histogramBuffer->Release();
+    }
+    if (bucketCountBuffer != nullptr) {
+        bucketCountBuffer->Release();
     }
+    if (sortedArgumentBuffer != nullptr) {
+        sortedArgumentBuffer->Release();
+    }
+    if (elementReadbackBuffer != nullptr) {
+        elementReadbackBuffer->Release();
+    }
+    if (countReadbackBuffer != nullptr) {
+        countReadbackBuffer->Release();
+    }
+    if (timestampReadbackBuffer != nullptr) {
+        timestampReadbackBuffer->Release();
+    }
+
+    return success;
+}
+#endif
+
+auto CreateExecuteIndirectTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue *commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator, bool supportMeshShader) ->
+                                    std::tuple<ID3D12RootSignature*, std::array<ID3D12PipelineState*, 3>, ID3D12GraphicsCommandList*, std::array<ID3D12GraphicsCommandList*, 3>, ID3D12DescriptorHeap*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, std::array<ID3D12CommandSignature*, 3>, bool>
+{
+    ID3D12RootSignature* rootSignature = nullptr;
+    ID3D12PipelineState* computePipelineStateForArgumentBufferFilling = nullptr;
+    ID3D12PipelineState* pipelineState = nullptr;
+    ID3D12PipelineState* pipelineStateIndexed = nullptr;
+    ID3D12PipelineState* pipelineStateMeshShader = nullptr;
+    ID3D12GraphicsCommandList* commandList = nullptr;
+    ID3D12GraphicsCommandList* commandBundle = nullptr;
+    ID3D12GraphicsCommandList* commandBundleIndexed = nullptr;
+    ID3D12GraphicsCommandList* commandBundleMeshShader = nullptr;
+    ID3D12DescriptorHeap* descriptorHeap = nullptr;
+    ID3D12CommandSignature* drawCommandsSignature = nullptr;
+    ID3D12CommandSignature* drawIndexedCommandSignature = nullptr;
+    ID3D12CommandSignature* meshShaderCommandSignature = nullptr;
+    ID3D12Resource* indirectArgumentBuffer = nullptr;
+    ID3D12Resource* indirectCountBuffer = nullptr;
+    ID3D12Resource* uploadDevHostBuffer = nullptr;
+    ID3D12Resource* vertexBuffer = nullptr;
+    ID3D12Resource* indexBuffer = nullptr;
+    ID3D12Resource* rotateConstantBuffer = nullptr;
+    D3D12_VERTEX_BUFFER_VIEW vertexBufferView{ };
+
+    bool success = false;
+
+    auto const result = std::make_tuple(rootSignature, pipelineState, commandList, std::array<ID3D12GraphicsCommandList*, 3>(), descriptorHeap, uploadDevHostBuffer, vertexBuffer, indexBuffer, rotateConstantBuffer, indirectArgumentBuffer, indirectCountBuffer, std::array<ID3D12CommandSignature*, 3>(), success);
+
+    success = true;
+
+#if RUN_MULTI_DRAW_INDIRECT_BENCHMARK
+    // It resets commandAllocator, so it runs before the command lists of this test are created.
+    if (!RunMultiDrawIndirectBenchmark(d3d_device, commandQueue, commandAllocator)) {
+        fprintf(stderr, "Multi-draw indirect benchmark failed!\n");
+    }
+#endif
+
+#if RUN_DRAW_SORT_BENCHMARK
+    if (!RunDrawSortBenchmark(d3d_device, commandQueue, commandAllocator)) {
+        fprintf(stderr, "Draw sort benchmark failed!\n");
+    }
+#endif
+
+    rootSignature = CreateRootSignature(d3d_device);
+    if (rootSignature == nullptr) {
+        success = false;
+    }
+
+    auto const computePipelineResult = CreatePipelineStateObjectForArgBufferCompute(d3d_device, commandAllocator, commandBundleAllocator, rootSignature);
+    computePipelineStateForArgumentBufferFilling = std::get<0>(computePipelineResult);
+    commandList = std::get<1>(computePipelineResult);
+    commandBundle = std::get<2>(computePipelineResult);
+    descriptorHeap = std::get<3>(computePipelineResult);
+    if (computePipelineStateForArgumentBufferFilling == nullptr || descriptorHeap == nullptr) {
+        success = false;
+    }
+
+    auto const computeBuffersResult = CreateComputeBuffersForArgumentFilling(d3d_device, rootSignature, commandQueue, commandList, commandBundle, descriptorHeap);
+    indirectArgumentBuffer = computeBuffersResult.first;
+    indirectCountBuffer = computeBuffersResult.second;
+    if (commandList == nullptr || commandBundle == nullptr || indirectArgumentBuffer == nullptr || indirectCountBuffer == nullptr) {
+        success = false;
+    }
+
+    if (computePipelineStateForArgumentBufferFilling != nullptr) {
+        computePipelineStateForArgumentBufferFilling->Release();
+    }
+    if (commandList != nullptr) {
+        commandList->Release();
+    }
+    if (commandBundle != nullptr) {
+        commandBundle->Release();
+    }
+
+    auto const graphicsPipelineResult = CreatePipelineStateObjectDraw(d3d_device, commandAllocator, commandBundleAllocator, rootSignature);
+    pipelineState = std::get<0>(graphicsPipelineResult);
+    commandList = std::get<1>(graphicsPipelineResult);
+    commandBundle = std::get<2>(graphicsPipelineResult);
+    if (commandList == nullptr || commandBundle == nullptr) {
+        success = false;
+    }
+
+    auto const vertexBufferResult = CreateVertexBuffer(d3d_device, rootSignature, commandList, commandBundle, descriptorHeap);
+    drawCommandsSignature = std::get<0>(vertexBufferResult);
+    uploadDevHostBuffer = std::get<1>(vertexBufferResult);
+    vertexBuffer = std::get<2>(vertexBufferResult);
+    rotateConstantBuffer = std::get<3>(vertexBufferResult);
+    vertexBufferView = std::get<4>(vertexBufferResult);
+    if (uploadDevHostBuffer == nullptr || vertexBuffer == nullptr || rotateConstantBuffer == nullptr) {
+        success = false;
+    }
+
+    auto const indexedPipelineState = CreatePipelineStateObjectDrawIndexed(d3d_device, commandBundleAllocator, rootSignature);
+    pipelineStateIndexed = indexedPipelineState.first;
+    commandBundleIndexed = indexedPipelineState.second;
+    if (pipelineStateIndexed == nullptr || commandBundleIndexed == nullptr) {
+        success = false;
+    }
+
+    auto const indexedVertexBufferResult = CreateVertexBufferIndexed(d3d_device, rootSignature, commandList, commandBundleIndexed, descriptorHeap, vertexBufferView, uploadDevHostBuffer);
+    drawIndexedCommandSignature = indexedVertexBufferResult.first;
+    indexBuffer = indexedVertexBufferResult.second;
+
+    if (supportMeshShader)
+    {
+        auto const meshShaderPipelineState = CreatePipelineStateObjectForMeshShader((ID3D12Device2*)d3d_device, rootSignature, commandBundleAllocator);
+        pipelineStateMeshShader = meshShaderPipelineState.first;
+        commandBundleMeshShader = meshShaderPipelineState.second;
+        if (pipelineStateMeshShader == nullptr || commandBundleMeshShader == nullptr) {
+            success = false;
+        }
+
+        meshShaderCommandSignature = CreateCommandSignatureForMeshShader(d3d_device, rootSignature, commandBundleMeshShader);
+        if (meshShaderCommandSignature == nullptr) {
+            success = false;
+        }
+    }
+
+    if (!ExecuteDataCopyCommandsAndWait(commandQueue, commandList)) {
+        success = false;
+    }
+
+    std::array< ID3D12PipelineState*, 3> pipelineStateArray{ pipelineState, pipelineStateIndexed, pipelineStateMeshShader };
+    std::array<ID3D12GraphicsCommandList*, 3> commandBundleArray { commandBundle, commandBundleIndexed, commandBundleMeshShader };
+    std::array<ID3D12CommandSignature*, 3> commandSignatureArray{ drawCommandsSignature, drawIndexedCommandSignature, meshShaderCommandSignature };
+
+    return std::make_tuple(rootSignature, pipelineStateArray, commandList, commandBundleArray, descriptorHeap, uploadDevHostBuffer, vertexBuffer, indexBuffer, rotateConstantBuffer, indirectArgumentBuffer, indirectCountBuffer, commandSignatureArray, success);
+}
+
+// @param index EXECUTE_INDIRECT_COMMAND_TYPE. The GPU-written count of each command type selects how many commands of its region are executed.
+auto ExecuteIndirectCallbackHandler(ID3D12GraphicsCommandList* commandList, ID3D12CommandSignature* commandSignature, ID3D12Resource* indirectArgumentBuffer, ID3D12Resource* indirectCountBuffer, UINT index) -> void
+{
+    const UINT64 argumentBufferOffset = UINT64(index) * EXECUTE_INDIRECT_MAX_COMMAND_COUNT * sizeof(IndirectArgumentBufferType);
+    const UINT64 countBufferOffset = UINT64(index) * sizeof(UINT);
 
-    commandList->ExecuteIndirect(commandSignature, maxCommandCount, indirectArgumentBuffer, argumentBufferOffset, indirectCountBuffer, countBufferOffset);
+    commandList->ExecuteIndirect(commandSignature, EXECUTE_INDIRECT_MAX_COMMAND_COUNT, indirectArgumentBuffer, argumentBufferOffset, indirectCountBuffer, countBufferOffset);
 }
 
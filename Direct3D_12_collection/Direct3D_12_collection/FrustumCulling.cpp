@@ -0,0 +1,326 @@
+#include "FrustumCulling.h"
+#include "CpuFeatures.h"
+
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#include <emmintrin.h>
+#define FRUSTUM_CULLING_USE_SSE     1
+#else
+#define FRUSTUM_CULLING_USE_SSE     0
+#endif
+
+// MSVC accepts AVX2 intrinsics in any function, GCC and Clang only in functions compiled for the AVX2 target.
+// The CPU and the OS support are checked at run time either way.
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#define FRUSTUM_CULLING_USE_AVX2    1
+#define FRUSTUM_CULLING_AVX2_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define FRUSTUM_CULLING_USE_AVX2    1
+#define FRUSTUM_CULLING_AVX2_TARGET     __attribute__((target("avx2")))
+#else
+#define FRUSTUM_CULLING_USE_AVX2    0
+#endif
+
+// One plane with the coordinate arrays of the box corner that is the farthest along its normal.
+// The box is outside of the plane when that corner is.
+struct CullingPlane
+{
+    const float* x;
+    const float* y;
+    const float* z;
+    float a, b, c, d;
+};
+
+using CullingPlanes = std::array<CullingPlane, 6>;
+
+static auto GetCullingPlanes(const FrustumPlanes& planes, const FrustumCullingObjects& objects) -> CullingPlanes
+{
+    CullingPlanes result;
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        const float* plane = planes.planes[i];
+        result[i] = CullingPlane{
+            .x = plane[0] >= 0.0f ? objects.maxX.data() : objects.minX.data(),
+            .y = plane[1] >= 0.0f ? objects.maxY.data() : objects.minY.data(),
+            .z = plane[2] >= 0.0f ? objects.maxZ.data() : objects.minZ.data(),
+            .a = plane[0], .b = plane[1], .c = plane[2], .d = plane[3]
+        };
+    }
+    return result;
+}
+
+// Every kernel computes ((a * x + b * y) + c * z) + d for each plane, and writes the visible indices of [begin, end) to visibleIndices.
+// @return the number of visible objects
+static auto CullObjectsScalar(const CullingPlanes& planes, uint32_t begin, uint32_t end, uint32_t* visibleIndices) -> uint32_t
+{
+    uint32_t visibleCount = 0U;
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        bool outside = false;
+        for (const CullingPlane& plane : planes) {
+            outside |= plane.a * plane.x[i] + plane.b * plane.y[i] + plane.c * plane.z[i] + plane.d < 0.0f;
+        }
+
+        // Branchless compaction
+        visibleIndices[visibleCount] = i;
+        visibleCount += outside ? 0U : 1U;
+    }
+    return visibleCount;
+}
+
+// compactLanes[mask] lists the set bits of mask in increasing order
+template <size_t LANE_COUNT>
+static constexpr auto GetCompactLaneTable() -> std::array<std::array<uint32_t, LANE_COUNT>, size_t(1) << LANE_COUNT>
+{
+    std::array<std::array<uint32_t, LANE_COUNT>, size_t(1) << LANE_COUNT> table{ };
+    for (size_t mask = 0; mask < table.size(); ++mask)
+    {
+        uint32_t count = 0U;
+        for (uint32_t lane = 0U; lane < LANE_COUNT; ++lane)
+        {
+            if ((mask & (size_t(1) << lane)) != 0) {
+                table[mask][count++] = lane;
+            }
+        }
+    }
+    return table;
+}
+
+#if FRUSTUM_CULLING_USE_SSE
+alignas(16) static constexpr auto s_compactLanes4 = GetCompactLaneTable<4>();
+
+static auto CullObjectsSSE(const CullingPlanes& planes, uint32_t begin, uint32_t end, uint32_t* visibleIndices) -> uint32_t
+{
+    __m128 coefficients[6][4];
+    for (size_t p = 0; p < planes.size(); ++p)
+    {
+        coefficients[p][0] = _mm_set1_ps(planes[p].a);
+        coefficients[p][1] = _mm_set1_ps(planes[p].b);
+        coefficients[p][2] = _mm_set1_ps(planes[p].c);
+        coefficients[p][3] = _mm_set1_ps(planes[p].d);
+    }
+
+    const __m128 zero = _mm_setzero_ps();
+    uint32_t visibleCount = 0U;
+    uint32_t i = begin;
+
+    // The full 4-index store may write past the visible indices, but never past visibleIndices[i - begin + 3]
+    for (; i + 4U <= end; i += 4U)
+    {
+        __m128 outside = zero;
+        for (size_t p = 0; p < planes.size(); ++p)
+        {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(coefficients[p][0], _mm_loadu_ps(&planes[p].x[i])), _mm_mul_ps(coefficients[p][1], _mm_loadu_ps(&planes[p].y[i])));
+            distance = _mm_add_ps(distance, _mm_mul_ps(coefficients[p][2], _mm_loadu_ps(&planes[p].z[i])));
+            distance = _mm_add_ps(distance, coefficients[p][3]);
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, zero));
+        }
+
+        const uint32_t visibleMask = uint32_t(~_mm_movemask_ps(outside)) & 0xfU;
+        const __m128i lanes = _mm_load_si128((const __m128i*)s_compactLanes4[visibleMask].data());
+        _mm_storeu_si128((__m128i*)&visibleIndices[visibleCount], _mm_add_epi32(lanes, _mm_set1_epi32(int(i))));
+        visibleCount += uint32_t(std::popcount(visibleMask));
+    }
+
+    return visibleCount + CullObjectsScalar(planes, i, end, &visibleIndices[visibleCount]);
+}
+#endif
+
+#if FRUSTUM_CULLING_USE_AVX2
+alignas(32) static constexpr auto s_compactLanes8 = GetCompactLaneTable<8>();
+
+FRUSTUM_CULLING_AVX2_TARGET
+static auto CullObjectsAVX2(const CullingPlanes& planes, uint32_t begin, uint32_t end, uint32_t* visibleIndices) -> uint32_t
+{
+    __m256 coefficients[6][4];
+    for (size_t p = 0; p < planes.size(); ++p)
+    {
+        coefficients[p][0] = _mm256_set1_ps(planes[p].a);
+        coefficients[p][1] = _mm256_set1_ps(planes[p].b);
+        coefficients[p][2] = _mm256_set1_ps(planes[p].c);
+        coefficients[p][3] = _mm256_set1_ps(planes[p].d);
+    }
+
+    const __m256 zero = _mm256_setzero_ps();
+    uint32_t visibleCount = 0U;
+    uint32_t i = begin;
+
+    // The full 8-index store may write past the visible indices, but never past visibleIndices[i - begin + 7]
+    for (; i + 8U <= end; i += 8U)
+    {
+        __m256 outside = zero;
+        for (size_t p = 0; p < planes.size(); ++p)
+        {
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(coefficients[p][0], _mm256_loadu_ps(&planes[p].x[i])),
+                                            _mm256_mul_ps(coefficients[p][1], _mm256_loadu_ps(&planes[p].y[i])));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(coefficients[p][2], _mm256_loadu_ps(&planes[p].z[i])));
+            distance = _mm256_add_ps(distance, coefficients[p][3]);
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, zero, _CMP_LT_OQ));
+        }
+
+        const uint32_t visibleMask = uint32_t(~_mm256_movemask_ps(outside)) & 0xffU;
+        const __m256i lanes = _mm256_load_si256((const __m256i*)s_compactLanes8[visibleMask].data());
+        _mm256_storeu_si256((__m256i*)&visibleIndices[visibleCount], _mm256_add_epi32(lanes, _mm256_set1_epi32(int(i))));
+        visibleCount += uint32_t(std::popcount(visibleMask));
+    }
+
+    return visibleCount + CullObjectsScalar(planes, i, end, &visibleIndices[visibleCount]);
+}
+#endif
+
+auto IsFrustumCullingKernelSupported(FrustumCullingKernel kernel) -> bool
+{
+    switch (kernel)
+    {
+    case FrustumCullingKernel::Scalar:
+        return true;
+
+    case FrustumCullingKernel::SSE:
+        return FRUSTUM_CULLING_USE_SSE != 0;
+
+    case FrustumCullingKernel::AVX2:
+        return FRUSTUM_CULLING_USE_AVX2 != 0 && IsAVX2SupportedByCPU();
+
+    default:
+        return false;
+    }
+}
+
+auto GetFrustumCullingKernelName(FrustumCullingKernel kernel) -> const char*
+{
+    switch (kernel)
+    {
+    case FrustumCullingKernel::Scalar:
+        return "scalar";
+
+    case FrustumCullingKernel::SSE:
+        return "SSE";
+
+    case FrustumCullingKernel::AVX2:
+        return "AVX2";
+
+    default:
+        return "unknown";
+    }
+}
+
+auto AddFrustumCullingObject(FrustumCullingObjects& objects, const float boundsMin[3], const float boundsMax[3]) -> void
+{
+    objects.minX.push_back(boundsMin[0]);
+    objects.minY.push_back(boundsMin[1]);
+    objects.minZ.push_back(boundsMin[2]);
+    objects.maxX.push_back(boundsMax[0]);
+    objects.maxY.push_back(boundsMax[1]);
+    objects.maxZ.push_back(boundsMax[2]);
+}
+
+// The clip space position is (x', y', z', w') = mul(v, transform), so each clip coordinate is v dotted with a column of the transform.
+// -w' <= x' <= w' gives the left and right planes, and so on.
+auto GetFrustumPlanes(const Matrix4x4& transform, bool zeroToOneDepth) -> FrustumPlanes
+{
+    FrustumPlanes result;
+    for (int i = 0; i < 4; ++i)
+    {
+        const float x = transform.m[i][0];
+        const float y = transform.m[i][1];
+        const float z = transform.m[i][2];
+        const float w = transform.m[i][3];
+
+        result.planes[0][i] = w + x;    // left
+        result.planes[1][i] = w - x;    // right
+        result.planes[2][i] = w + y;    // bottom
+        result.planes[3][i] = w - y;    // top
+        result.planes[4][i] = zeroToOneDepth ? z : w + z;   // near, or far for the reversed-Z projections
+        result.planes[5][i] = w - z;    // far, or near for the reversed-Z projections
+    }
+    return result;
+}
+
+auto CullFrustumObjects(FrustumCullingKernel kernel, const FrustumPlanes& planes, const FrustumCullingObjects& objects, ThreadPool* threadPool,
+                        std::vector<uint32_t>& visibleIndices) -> void
+{
+    if (!IsFrustumCullingKernelSupported(kernel)) {
+        kernel = FrustumCullingKernel::Scalar;
+    }
+
+    auto cullObjects = &CullObjectsScalar;
+    switch (kernel)
+    {
+#if FRUSTUM_CULLING_USE_SSE
+    case FrustumCullingKernel::SSE:
+        cullObjects = &CullObjectsSSE;
+        break;
+#endif
+
+#if FRUSTUM_CULLING_USE_AVX2
+    case FrustumCullingKernel::AVX2:
+        cullObjects = &CullObjectsAVX2;
+        break;
+#endif
+
+    case FrustumCullingKernel::Scalar:
+    default:
+        break;
+    }
+
+    const CullingPlanes cullingPlanes = GetCullingPlanes(planes, objects);
+    const uint32_t objectCount = uint32_t(objects.minX.size());
+    const uint32_t chunkCount = (objectCount + FRUSTUM_CULLING_CHUNK_SIZE - 1U) / FRUSTUM_CULLING_CHUNK_SIZE;
+
+    // Every chunk writes its visible indices to the beginning of its own range, which the SIMD stores never overrun
+    visibleIndices.resize(objectCount);
+    std::vector<uint32_t> chunkVisibleCounts(chunkCount);
+
+    auto const cullChunk = [&](uint32_t chunkIndex) {
+        const uint32_t begin = chunkIndex * FRUSTUM_CULLING_CHUNK_SIZE;
+        const uint32_t end = (std::min)(begin + FRUSTUM_CULLING_CHUNK_SIZE, objectCount);
+        chunkVisibleCounts[chunkIndex] = cullObjects(cullingPlanes, begin, end, &visibleIndices[begin]);
+    };
+
+    if (threadPool != nullptr && chunkCount > 1U) {
+        ThreadPoolParallelFor(threadPool, chunkCount, cullChunk);
+    }
+    else
+    {
+        for (uint32_t chunkIndex = 0U; chunkIndex < chunkCount; ++chunkIndex) {
+            cullChunk(chunkIndex);
+        }
+    }
+
+    // Close the gaps between the chunks
+    uint32_t visibleCount = 0U;
+    for (uint32_t chunkIndex = 0U; chunkIndex < chunkCount; ++chunkIndex)
+    {
+        const uint32_t begin = chunkIndex * FRUSTUM_CULLING_CHUNK_SIZE;
+        if (visibleCount != begin) {
+            memmove(&visibleIndices[visibleCount], &visibleIndices[begin], chunkVisibleCounts[chunkIndex] * sizeof(uint32_t));
+        }
+        visibleCount += chunkVisibleCounts[chunkIndex];
+    }
+    visibleIndices.resize(visibleCount);
+}
+
+auto MeasureFrustumCullingThroughput(FrustumCullingKernel kernel, const FrustumPlanes& planes, const FrustumCullingObjects& objects, ThreadPool* threadPool,
+                                    uint32_t iterationCount) -> double
+{
+    std::vector<uint32_t> visibleIndices;
+
+    // Warm up the caches and the page mapping of visibleIndices
+    CullFrustumObjects(kernel, planes, objects, threadPool, visibleIndices);
+
+    const auto beginTime = std::chrono::steady_clock::now();
+    for (uint32_t i = 0U; i < iterationCount; ++i) {
+        CullFrustumObjects(kernel, planes, objects, threadPool, visibleIndices);
+    }
+    const std::chrono::duration<double, std::milli> milliseconds = std::chrono::steady_clock::now() - beginTime;
+
+    return milliseconds.count() > 0.0 ? double(objects.minX.size()) * iterationCount / milliseconds.count() : 0.0;
+}
+
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MatrixMath.h"
+#include "ThreadPool.h"
+
+// Frustum culling of large sets of axis-aligned bounding boxes on the CPU.
+// The boxes are stored as structure of arrays, so the SSE and AVX2 kernels test 4 or 8 boxes against a plane with one load per coordinate.
+// The visible indices are written compactly in increasing order, ready to be uploaded as per-instance data
+// or counted into the InstanceCount of indirect draw arguments.
+
+// The objects of one ThreadPool task
+static constexpr uint32_t FRUSTUM_CULLING_CHUNK_SIZE = 16U * 1024U;
+
+enum class FrustumCullingKernel
+{
+    Scalar,
+    SSE,
+    AVX2
+};
+
+// Bounding boxes as structure of arrays. All the arrays must have the same size.
+struct FrustumCullingObjects
+{
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+};
+
+// Plane equations a * x + b * y + c * z + d >= 0 for the inside of the frustum, not normalized.
+// Order: left, right, bottom, top, near, far
+struct FrustumPlanes
+{
+    float planes[6][4];
+};
+
+// The AVX2 kernel is only supported when both the compiler and the CPU support AVX2
+extern auto IsFrustumCullingKernelSupported(FrustumCullingKernel kernel) -> bool;
+
+extern auto GetFrustumCullingKernelName(FrustumCullingKernel kernel) -> const char*;
+
+extern auto AddFrustumCullingObject(FrustumCullingObjects& objects, const float boundsMin[3], const float boundsMax[3]) -> void;
+
+// Extracts the planes of the view volume of a row-vector transform, e.g. the matrices of MatrixMath.
+// The planes are in the space the matrix transforms from.
+// @param zeroToOneDepth true for the Direct3D [0, w] clip space z, e.g. the reversed-Z projections, false for the OpenGL [-w, w] one
+extern auto GetFrustumPlanes(const Matrix4x4& transform, bool zeroToOneDepth) -> FrustumPlanes;
+
+// A box is culled when it lies completely on the outside of one of the planes. The test is conservative:
+// a few boxes near the edges of the frustum that are outside of it but not outside of a single plane are kept.
+// Every kernel returns the same indices. An unsupported kernel falls back to the scalar one.
+// @param threadPool may be nullptr
+// @param visibleIndices receives the indices of the visible objects in increasing order
+extern auto CullFrustumObjects(FrustumCullingKernel kernel, const FrustumPlanes& planes, const FrustumCullingObjects& objects, ThreadPool* threadPool,
+                                std::vector<uint32_t>& visibleIndices) -> void;
+
+// Culls the objects iterationCount times with one kernel
+// @return objects per millisecond
+extern auto MeasureFrustumCullingThroughput(FrustumCullingKernel kernel, const FrustumPlanes& planes, const FrustumCullingObjects& objects, ThreadPool* threadPool,
+                                            uint32_t iterationCount) -> double;
+
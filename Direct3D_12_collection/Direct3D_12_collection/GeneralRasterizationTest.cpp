@@ -1,15 +1,26 @@
 #include "common.h"
+#include "ReferenceRasterizer.h"
 
 #define BIND_DEPTH_STENCIL_AS_SRV   0
 #define OUTPUT_DEPTH_TEXTURE        0
 #define DO_BASIC_PRIMITIVE_TEST     0
 
+// Compare the rendered result with the CPU reference rasterizer.
+// The point list of DO_BASIC_PRIMITIVE_TEST is not modeled, so the validation is skipped in that mode.
+#define VALIDATE_WITH_REFERENCE_RASTERIZER  (1 && !DO_BASIC_PRIMITIVE_TEST)
+
 static constexpr UINT TEXTURE_SIZE = WINDOW_WIDTH / 16;
 static constexpr float PER_PIXEL_WIDTH = 2.0f / float(TEXTURE_SIZE);
 static constexpr float HALF_PIXEL_WIDTH = PER_PIXEL_WIDTH * 0.5f;
 static constexpr UINT TEXTURE_SAMPLE_COUNT = 1U;
 static constexpr bool MSAA_RENDER_TARGET_NEED_RESOLVE = true && TEXTURE_SAMPLE_COUNT > 1U;
-static constexpr UINT uavBufferSize = 64U;
+// The UAV buffer begins with the total pixel shader invocation count (the occlusion query result is resolved behind it on read back),
+// followed by the per-pixel invocation counts from UAV_PER_PIXEL_COUNT_OFFSET on. Keep consistent with raster.frag.hlsl.
+static constexpr UINT UAV_PER_PIXEL_COUNT_OFFSET = 16U;
+static constexpr UINT uavBufferSize = (UAV_PER_PIXEL_COUNT_OFFSET + TEXTURE_SIZE * TEXTURE_SIZE) * UINT(sizeof(unsigned));
+static constexpr UINT RENDER_TARGET_READBACK_ROW_PITCH = (TEXTURE_SIZE * 4U + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1U) & ~(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1U);
+// The single-sampled depth texture is read back behind the render target texels with the same row pitch
+static constexpr UINT DEPTH_READBACK_OFFSET = RENDER_TARGET_READBACK_ROW_PITCH * TEXTURE_SIZE;
 
 enum CBV_SRV_UAV_SLOT_ID
 {
@@ -20,6 +31,80 @@ enum CBV_SRV_UAV_SLOT_ID
     SLOT_COUNT
 };
 
+#if VALIDATE_WITH_REFERENCE_RASTERIZER
+static ReferenceRasterTarget s_referenceRasterTarget;
+// Expected R8G8B8A8_UNORM texels of the (resolved) render target
+static std::vector<uint32_t> s_referenceRasterColors;
+
+static inline auto PackUnormColor(const float color[4]) -> uint32_t
+{
+    uint32_t result = 0U;
+    for (int i = 0; i < 4; ++i) {
+        result |= uint32_t(std::lround(std::clamp(color[i], 0.0f, 1.0f) * 255.0f)) << (i * 8);
+    }
+    return result;
+}
+
+// Transforms the vertices exactly like raster.vert.hlsl does and rasterizes them with the CPU reference rasterizer.
+// Each vertex contains a float4 position followed by a float4 color. The color is flat shaded from the first vertex of each triangle.
+static auto RasterizeWithReferenceRasterizer(const float* vertexData, size_t vertexStride, UINT vertexCount, float rotAngle, float zOffset, const float clearColor[4]) -> void
+{
+    const float rotRadian = rotAngle * float(M_PI) / 180.0f;
+    const float cosValue = std::cos(rotRadian);
+    const float sinValue = std::sin(rotRadian);
+
+    std::vector<float> clipPositions(size_t(vertexCount) * 4U);
+    for (UINT i = 0U; i < vertexCount; ++i)
+    {
+        const float* position = (const float*)((const uint8_t*)vertexData + vertexStride * i);
+        // glRotate(rotAngle, 1.0, 0.0, 0.0) -> glTranslate(0.0, 0.0, zOffset) -> glOrtho(-1.0, 1.0, -1.0, 1.0, 1.0, 3.0)
+        const float y = position[1] * cosValue - position[2] * sinValue;
+        const float z = position[1] * sinValue + position[2] * cosValue + zOffset * position[3];
+        clipPositions[i * 4U + 0U] = position[0];
+        clipPositions[i * 4U + 1U] = y;
+        clipPositions[i * 4U + 2U] = -z - 2.0f * position[3];
+        clipPositions[i * 4U + 3U] = position[3];
+    }
+
+    // D3D12 only accepts viewport depth ranges within [0, 1]
+    const ReferenceRasterViewport viewport{
+        .topLeftX = 0.0f,
+        .topLeftY = 0.0f,
+        .width = float(TEXTURE_SIZE),
+        .height = float(TEXTURE_SIZE),
+        .minDepth = 0.0f,
+        .maxDepth = 1.0f
+    };
+    // Keep consistent with the rasterizer state and the depth stencil state of CreatePipelineStateObjectForRenderTexture
+    const ReferenceRasterState state{
+        .sampleCount = TEXTURE_SAMPLE_COUNT,
+        .depthClipEnable = true,
+        .depthEnable = true,
+        .depthWriteEnable = true
+    };
+
+    s_referenceRasterTarget = CreateReferenceRasterTarget(TEXTURE_SIZE, TEXTURE_SIZE, TEXTURE_SAMPLE_COUNT, 1.0f);
+    ReferenceRasterDrawTriangleList(s_referenceRasterTarget, viewport, state, clipPositions.data(), 4U * sizeof(float), vertexCount, 0);
+
+    // The multisampled render target is resolved by averaging the samples
+    const uint32_t sampleCount = s_referenceRasterTarget.sampleCount;
+    s_referenceRasterColors.assign(size_t(TEXTURE_SIZE) * TEXTURE_SIZE, 0U);
+    for (size_t pixelIndex = 0; pixelIndex < s_referenceRasterColors.size(); ++pixelIndex)
+    {
+        float resolvedColor[4]{ };
+        for (uint32_t s = 0U; s < sampleCount; ++s)
+        {
+            const int32_t primID = s_referenceRasterTarget.primitiveIDs[pixelIndex * sampleCount + s];
+            const float* color = primID < 0 ? clearColor : (const float*)((const uint8_t*)vertexData + vertexStride * size_t(primID) * 3U) + 4;
+            for (int i = 0; i < 4; ++i) {
+                resolvedColor[i] += color[i] / float(sampleCount);
+            }
+        }
+        s_referenceRasterColors[pixelIndex] = PackUnormColor(resolvedColor);
+    }
+}
+#endif
+
 static auto CreateRootSignature(ID3D12Device* d3d_device, bool isForRenderTexture) -> ID3D12RootSignature*
 {
     ID3D12RootSignature* rootSignature = nullptr;
@@ -238,6 +323,57 @@ static auto CreateRenderTargetViewForTexture(ID3D12Device* d3d_device) -> std::t
         const UINT rtvDescriptorSize = d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
         rtvHandle.ptr += rtvDescriptorSize;
 
+#if VALIDATE_WITH_REFERENCE_RASTERIZER
+        // The depth stencil texture is read back and compared with the depth buffer of the reference rasterizer
+        const D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc{
+            .Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV,
+            .NumDescriptors = 1,
+            .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
+            .NodeMask = 0
+        };
+        hRes = d3d_device->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&dsvDescriptorHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateDescriptorHeap for depth stencil view failed: %ld\n", hRes);
+            break;
+        }
+
+        // Typeless so that it can also be copied and viewed as R32_FLOAT
+        const D3D12_RESOURCE_DESC dsResourceDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
+            .Alignment = 0,
+            .Width = TEXTURE_SIZE,
+            .Height = TEXTURE_SIZE,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_R32_TYPELESS,
+            .SampleDesc {.Count = TEXTURE_SAMPLE_COUNT, .Quality = 0U },
+            .Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN,
+            .Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL
+        };
+
+        const D3D12_CLEAR_VALUE dsOptClearValue{
+            .Format = DXGI_FORMAT_D32_FLOAT,
+            .DepthStencil { .Depth = 1.0f, .Stencil = 0U }
+        };
+
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &dsResourceDesc, D3D12_RESOURCE_STATE_DEPTH_READ,
+                                                    &dsOptClearValue, IID_PPV_ARGS(&dsTexture));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for depth stencil texture failed: %ld!\n", hRes);
+            break;
+        }
+
+        const D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc{
+            .Format = DXGI_FORMAT_D32_FLOAT,
+            .ViewDimension = TEXTURE_SAMPLE_COUNT > 1U ? D3D12_DSV_DIMENSION_TEXTURE2DMS : D3D12_DSV_DIMENSION_TEXTURE2D,
+            .Flags = D3D12_DSV_FLAG_NONE,
+            .Texture2D { .MipSlice = 0 }
+        };
+        d3d_device->CreateDepthStencilView(dsTexture, &dsvDesc, dsvDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
+#endif
+
         return std::make_tuple(rtvDescriptorHeap, dsvDescriptorHeap, rtTexture, dsTexture, resolvedRTTexture, resolvedDSTexutre);
     }
     while (false);
@@ -326,7 +462,7 @@ static auto CreatePipelineStateObjectForRenderTexture(ID3D12Device* d3d_device,
                 .ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF
             },
             .DepthStencilState {
-                .DepthEnable = FALSE,
+                .DepthEnable = VALIDATE_WITH_REFERENCE_RASTERIZER != 0,
                 .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL,
                 .DepthFunc = D3D12_COMPARISON_FUNC_LESS,        // D3D12_COMPARISON_FUNC_NEVER
                 .StencilEnable = FALSE,
@@ -346,7 +482,7 @@ static auto CreatePipelineStateObjectForRenderTexture(ID3D12Device* d3d_device,
                 // RTVFormats[0]
                 { RENDER_TARGET_BUFFER_FOMRAT }
             },
-            .DSVFormat = DXGI_FORMAT_UNKNOWN,
+            .DSVFormat = VALIDATE_WITH_REFERENCE_RASTERIZER ? DXGI_FORMAT_D32_FLOAT : DXGI_FORMAT_UNKNOWN,
             .SampleDesc {
                 .Count = TEXTURE_SAMPLE_COUNT,
                 .Quality = 0U
@@ -843,10 +979,11 @@ static auto CreateVertexBufferForRenderTexture(ID3D12Device* d3d_device, ID3D12R
         return result;
     }
 
+    // This buffer is shared by the depth texture output and the render target and depth read back for the reference rasterizer validation
     const D3D12_RESOURCE_DESC readbackTextureResourceDesc{
         .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
         .Alignment = 0,
-        .Width = uavCompOutResourceDesc.Width,
+        .Width = (std::max)(uavCompOutResourceDesc.Width, UINT64(DEPTH_READBACK_OFFSET) + UINT64(RENDER_TARGET_READBACK_ROW_PITCH) * TEXTURE_SIZE),
         .Height = 1U,
         .DepthOrArraySize = 1U,
         .MipLevels = 1U,
@@ -940,6 +1077,13 @@ static auto CreateVertexBufferForRenderTexture(ID3D12Device* d3d_device, ID3D12R
     pTranslations->zOffsetFront = -2.333f;    // -1.8 is the neareast plane for frustum perspective projection
     pTranslations->zOffsetBack = -2.8f;     // -2.0 is the near clipping plane and -2.333 is the far clipping plane for orthogonal projection
 
+#if VALIDATE_WITH_REFERENCE_RASTERIZER
+    // The bundle is drawn with draw index 0, which selects zOffsetFront
+    const float referenceClearColor[] = { 0.5f, 0.6f, 0.5f, 1.0f };
+    RasterizeWithReferenceRasterizer(triangleVertices[0].position, sizeof(triangleVertices[0]), UINT(std::size(triangleVertices)),
+                                    pTranslations->rotAngle, pTranslations->zOffsetFront, referenceClearColor);
+#endif
+
     constantBuffer->Unmap(0, nullptr);
 
     // Execute the command list to complete the copy operation
@@ -1171,7 +1315,7 @@ static auto PopulateCommandList(ID3D12GraphicsCommandList* commandBundle, ID3D12
                                 ID3D12DescriptorHeap* rtvDescriptorHeap, ID3D12DescriptorHeap* dsvDescriptorHeap,
                                 ID3D12DescriptorHeap* cbv_uavDescriptorHeap, ID3D12QueryHeap* queryHeap,
                                 ID3D12Resource* renderTarget, ID3D12Resource* dsTexture, ID3D12Resource* resolvedRTTexture, ID3D12Resource* resolvedDSTexture,
-                                ID3D12Resource* uavBuffer, ID3D12Resource* readbackDevHostBuffer) -> bool
+                                ID3D12Resource* uavBuffer, ID3D12Resource* readbackDevHostBuffer, ID3D12Resource* readBackTextureHostBuffer) -> bool
 {
     // Record commands to the command list
     // Set necessary state.
@@ -1184,7 +1328,7 @@ static auto PopulateCommandList(ID3D12GraphicsCommandList* commandBundle, ID3D12
         .Width = FLOAT(viewportWidth),
         .Height = FLOAT(viewportHeight),
         .MinDepth = 0.0f,
-        .MaxDepth = 3.0f
+        .MaxDepth = 1.0f
     };
     commandList->RSSetViewports(1, &viewPort);
 
@@ -1302,7 +1446,7 @@ static auto PopulateCommandList(ID3D12GraphicsCommandList* commandBundle, ID3D12
                 }
             }
         };
-        commandList->ResourceBarrier((UINT)std::size(storeBarriers) - UINT(dsTexture == nullptr) * 2U, storeBarriers);
+        commandList->ResourceBarrier((UINT)std::size(storeBarriers) - UINT(dsTexture == nullptr) - UINT(resolvedDSTexture == nullptr), storeBarriers);
 
         // Resolve MSAA render target and depth stencil texture to resovled textures
         commandList->ResolveSubresource(resolvedRTTexture, 0, renderTarget, 0, RENDER_TARGET_BUFFER_FOMRAT);
@@ -1334,7 +1478,7 @@ static auto PopulateCommandList(ID3D12GraphicsCommandList* commandBundle, ID3D12
                 }
             }
         };
-        commandList->ResourceBarrier((UINT)std::size(resolvedBarriers) - UINT(dsTexture == nullptr), resolvedBarriers);
+        commandList->ResourceBarrier((UINT)std::size(resolvedBarriers) - UINT(resolvedDSTexture == nullptr), resolvedBarriers);
     }
     else
     {
@@ -1365,6 +1509,90 @@ static auto PopulateCommandList(ID3D12GraphicsCommandList* commandBundle, ID3D12
         commandList->ResourceBarrier((UINT)std::size(storeBarriers) - UINT(dsTexture == nullptr), storeBarriers);
     }
 
+#if VALIDATE_WITH_REFERENCE_RASTERIZER
+    // Copy the single-sampled (or resolved) render target into the read-back buffer
+    if (TEXTURE_SAMPLE_COUNT == 1U || MSAA_RENDER_TARGET_NEED_RESOLVE)
+    {
+        ID3D12Resource* const srcTexture = MSAA_RENDER_TARGET_NEED_RESOLVE ? resolvedRTTexture : renderTarget;
+
+        D3D12_RESOURCE_BARRIER copyBarrier{
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .Transition {
+                .pResource = srcTexture,
+                .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                .StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+                .StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE
+            }
+        };
+        commandList->ResourceBarrier(1U, &copyBarrier);
+
+        const D3D12_TEXTURE_COPY_LOCATION dstLocation{
+            .pResource = readBackTextureHostBuffer,
+            .Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+            .PlacedFootprint {
+                .Offset = 0U,
+                .Footprint {
+                    .Format = RENDER_TARGET_BUFFER_FOMRAT,
+                    .Width = TEXTURE_SIZE,
+                    .Height = TEXTURE_SIZE,
+                    .Depth = 1U,
+                    .RowPitch = RENDER_TARGET_READBACK_ROW_PITCH
+                }
+            }
+        };
+        const D3D12_TEXTURE_COPY_LOCATION srcLocation{
+            .pResource = srcTexture,
+            .Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+            .SubresourceIndex = 0U
+        };
+        commandList->CopyTextureRegion(&dstLocation, 0U, 0U, 0U, &srcLocation, nullptr);
+
+        std::swap(copyBarrier.Transition.StateBefore, copyBarrier.Transition.StateAfter);
+        commandList->ResourceBarrier(1U, &copyBarrier);
+    }
+
+    // Copy the depth stencil texture behind the render target texels. A multisampled depth stencil texture cannot be copied to a buffer.
+    if (dsTexture != nullptr && TEXTURE_SAMPLE_COUNT == 1U)
+    {
+        D3D12_RESOURCE_BARRIER copyBarrier{
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .Transition {
+                .pResource = dsTexture,
+                .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                .StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+                .StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE
+            }
+        };
+        commandList->ResourceBarrier(1U, &copyBarrier);
+
+        const D3D12_TEXTURE_COPY_LOCATION dstLocation{
+            .pResource = readBackTextureHostBuffer,
+            .Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+            .PlacedFootprint {
+                .Offset = DEPTH_READBACK_OFFSET,
+                .Footprint {
+                    .Format = DXGI_FORMAT_R32_TYPELESS,
+                    .Width = TEXTURE_SIZE,
+                    .Height = TEXTURE_SIZE,
+                    .Depth = 1U,
+                    .RowPitch = RENDER_TARGET_READBACK_ROW_PITCH
+                }
+            }
+        };
+        const D3D12_TEXTURE_COPY_LOCATION srcLocation{
+            .pResource = dsTexture,
+            .Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+            .SubresourceIndex = 0U
+        };
+        commandList->CopyTextureRegion(&dstLocation, 0U, 0U, 0U, &srcLocation, nullptr);
+
+        std::swap(copyBarrier.Transition.StateBefore, copyBarrier.Transition.StateAfter);
+        commandList->ResourceBarrier(1U, &copyBarrier);
+    }
+#endif
+
     SyncAndReadFromDeviceResource(commandList, uavBufferSize, readbackDevHostBuffer, uavBuffer);
 
     // Resolve the Query Data
@@ -1704,7 +1932,7 @@ auto CreateGeneralRasterizationTestAssets(ID3D12Device* d3d_device, ID3D12Comman
         if (!ResetCommandAllocatorAndList(commandAllocator, commandList, pipelineState)) break;
 
         if (!PopulateCommandList(commandBundle, pointCommandBundle, commandList, rtvDescriptorHeap, dsvDescriptorHeap, cbv_uavDescriptorHeap, queryHeap,
-                                rtTexture, dsTexture, resolvedRTTexture, resolvedDSTexture, uavBuffer, readbackDevHostBuffer)) break;
+                                rtTexture, dsTexture, resolvedRTTexture, resolvedDSTexture, uavBuffer, readbackDevHostBuffer, readBackTextureHostBuffer)) break;
 
         // Execute the command list.
         ID3D12CommandList* const ppCommandLists[] = { (ID3D12CommandList*)commandList };
@@ -1726,8 +1954,108 @@ auto CreateGeneralRasterizationTestAssets(ID3D12Device* d3d_device, ID3D12Comman
         printf("Current pixel shader invocation count: %u\n", hostMemPtr[0]);
         printf("Current Occlusion Query result: %llu\n", queryPtr[4]);
 
+#if VALIDATE_WITH_REFERENCE_RASTERIZER
+        const unsigned long long referenceInvocationCount = s_referenceRasterTarget.invocationCount;
+        printf("Reference rasterizer pixel shader invocation count: %llu (%s)\n", referenceInvocationCount,
+                referenceInvocationCount == hostMemPtr[0] ? "matched" : "MISMATCHED");
+
+        // The triangles do not overlap, so every primitive covering a pixel passes the depth test and invokes the pixel shader once.
+        // A sample covered twice on a shared edge is rejected by the depth test and shows up as a mismatch.
+        UINT coverageMismatchCount = 0U;
+        for (UINT pixelIndex = 0U; pixelIndex < TEXTURE_SIZE * TEXTURE_SIZE; ++pixelIndex)
+        {
+            const unsigned coverage = hostMemPtr[UAV_PER_PIXEL_COUNT_OFFSET + pixelIndex];
+            const uint32_t expected = s_referenceRasterTarget.coverageCount[pixelIndex];
+            if (coverage == expected) continue;
+
+            if (coverageMismatchCount < 8U) {
+                printf("Pixel (%u, %u) coverage mismatched: expected %u, got %u\n", pixelIndex % TEXTURE_SIZE, pixelIndex / TEXTURE_SIZE, expected, coverage);
+            }
+            ++coverageMismatchCount;
+        }
+        printf("Reference rasterizer coverage comparison: %u of %u pixels mismatched\n", coverageMismatchCount, TEXTURE_SIZE * TEXTURE_SIZE);
+#endif
+
         readbackDevHostBuffer->Unmap(0, nullptr);
 
+#if VALIDATE_WITH_REFERENCE_RASTERIZER
+        if (TEXTURE_SAMPLE_COUNT == 1U || MSAA_RENDER_TARGET_NEED_RESOLVE)
+        {
+            const uint8_t* texelRowPtr = nullptr;
+            hRes = readBackTextureHostBuffer->Map(0, nullptr, (void**)&texelRowPtr);
+            if (FAILED(hRes))
+            {
+                fprintf(stderr, "Map read back buffer failed: %ld\n", hRes);
+                break;
+            }
+
+            // Allow 1 ULP difference per channel for the resolve operation
+            UINT mismatchCount = 0U;
+            for (UINT row = 0U; row < TEXTURE_SIZE; ++row, texelRowPtr += RENDER_TARGET_READBACK_ROW_PITCH)
+            {
+                for (UINT col = 0U; col < TEXTURE_SIZE; ++col)
+                {
+                    uint32_t texel;
+                    memcpy(&texel, texelRowPtr + col * sizeof(texel), sizeof(texel));
+                    const uint32_t expected = s_referenceRasterColors[row * TEXTURE_SIZE + col];
+
+                    bool matched = true;
+                    for (int i = 0; i < 32; i += 8) {
+                        matched = matched && std::abs(int((texel >> i) & 0xffU) - int((expected >> i) & 0xffU)) <= 1;
+                    }
+                    if (matched) continue;
+
+                    if (mismatchCount < 8U) {
+                        printf("Pixel (%u, %u) mismatched: expected 0x%08X, got 0x%08X\n", col, row, expected, texel);
+                    }
+                    ++mismatchCount;
+                }
+            }
+
+            readBackTextureHostBuffer->Unmap(0, nullptr);
+
+            printf("Reference rasterizer comparison: %u of %u pixels mismatched\n", mismatchCount, TEXTURE_SIZE * TEXTURE_SIZE);
+        }
+
+        if (dsTexture != nullptr && TEXTURE_SAMPLE_COUNT == 1U)
+        {
+            const uint8_t* depthRowPtr = nullptr;
+            hRes = readBackTextureHostBuffer->Map(0, nullptr, (void**)&depthRowPtr);
+            if (FAILED(hRes))
+            {
+                fprintf(stderr, "Map read back buffer failed: %ld\n", hRes);
+                break;
+            }
+            depthRowPtr += DEPTH_READBACK_OFFSET;
+
+            // Compare the only sample of each pixel with the reference depth buffer, allowing a small error of the depth plane interpolation
+            constexpr float depthTolerance = 1.0f / 65536.0f;
+            UINT depthMismatchCount = 0U;
+            for (UINT row = 0U; row < TEXTURE_SIZE; ++row, depthRowPtr += RENDER_TARGET_READBACK_ROW_PITCH)
+            {
+                for (UINT col = 0U; col < TEXTURE_SIZE; ++col)
+                {
+                    float depth;
+                    memcpy(&depth, depthRowPtr + col * sizeof(depth), sizeof(depth));
+                    const float expected = s_referenceRasterTarget.depth[row * TEXTURE_SIZE + col];
+                    if (std::abs(depth - expected) <= depthTolerance) continue;
+
+                    if (depthMismatchCount < 8U) {
+                        printf("Pixel (%u, %u) depth mismatched: expected %f, got %f\n", col, row, expected, depth);
+                    }
+                    ++depthMismatchCount;
+                }
+            }
+
+            readBackTextureHostBuffer->Unmap(0, nullptr);
+
+            printf("Reference rasterizer depth comparison: %u of %u samples mismatched\n", depthMismatchCount, TEXTURE_SIZE * TEXTURE_SIZE);
+        }
+        else {
+            puts("Reference rasterizer depth comparison skipped: a multisampled depth stencil texture cannot be read back by copy");
+        }
+#endif
+
 #if OUTPUT_DEPTH_TEXTURE
         computeRootSignature = CreateRootSignatureForCompute(d3d_device);
         if (computeRootSignature != nullptr)
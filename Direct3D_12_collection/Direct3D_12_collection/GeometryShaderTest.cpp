@@ -1,20 +1,65 @@
 #include "common.h"
 
+// Render the same scene through the geometry shader, the instanced vertex shader and the mesh shader paths and compare their GPU time
+#define RUN_VIEWPORT_ARRAY_BENCHMARK    1
+
+static constexpr UINT GS_TEST_POINT_COUNT = 4U;
+static constexpr UINT GS_TEST_SQUARES_PER_POINT = 4U;
+
+// Must be the same as POINTS_PER_GROUP in gs_test_expand.mesh.hlsl
+static constexpr UINT GS_TEST_MESH_POINTS_PER_GROUP = 16U;
+
+#if RUN_VIEWPORT_ARRAY_BENCHMARK
+// A small target keeps the benchmark bound by the geometry work instead of the pixel fill rate
+static constexpr UINT VIEWPORT_ARRAY_BENCHMARK_TARGET_SIZE = 64U;
+static constexpr UINT VIEWPORT_ARRAY_BENCHMARK_SCENE_COUNT = 16384U;    // copies of the 4 points per draw
+static constexpr UINT VIEWPORT_ARRAY_BENCHMARK_ITERATION_COUNT = 16U;   // draws per path
+#endif
+
+struct PointVertex
+{
+    float position[4];
+    float color[4];
+};
+
+static constexpr PointVertex s_pointVertices[GS_TEST_POINT_COUNT]{
+    // Direct3D是以左手作为前面背面顶点排列的依据
+    {.position { 0.0f, 0.0f, 0.0f, 1.0f }, .color { 0.9f, 0.1f, 0.1f, 1.0f } },     // for top-left primitives
+    {.position { 0.0f, 0.0f, 0.0f, 1.0f }, .color { 0.1f, 0.9f, 0.1f, 1.0f } },     // for top-right primitives
+    {.position { 0.0f, 0.0f, 0.0f, 1.0f }, .color { 0.1f, 0.1f, 0.9f, 1.0f } },     // for bottom-left primitives
+    {.position { 0.0f, 0.0f, 0.0f, 1.0f }, .color { 0.9f, 0.9f, 0.1f, 1.0f } }      // for bottom-right primitives
+};
 
 static auto CreateRootSignature(ID3D12Device* d3d_device) -> ID3D12RootSignature*
 {
     ID3D12RootSignature* rootSignature = nullptr;
 
+    // The parameters are only used by the mesh shader path. The other paths read the points through the input assembler.
+    const D3D12_ROOT_PARAMETER rootParameters[]{
+        // b0: pointCount
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+            .Constants { .ShaderRegister = 0, .RegisterSpace = 0, .Num32BitValues = 1 },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_MESH
+        },
+        // t0: points
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV,
+            .Descriptor { .ShaderRegister = 0, .RegisterSpace = 0 },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_MESH
+        }
+    };
+
     // Create a root signature.
     const D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc {
-        .NumParameters = 0U,
-        .pParameters = nullptr,
+        .NumParameters = (UINT)std::size(rootParameters),
+        .pParameters = rootParameters,
         .NumStaticSamplers = 0U,
         .pStaticSamplers = nullptr,
         .Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT |
                     D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS |
                     D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS |
-                    D3D12_ROOT_SIGNATURE_FLAG_DENY_AMPLIFICATION_SHADER_ROOT_ACCESS | D3D12_ROOT_SIGNATURE_FLAG_DENY_MESH_SHADER_ROOT_ACCESS
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_AMPLIFICATION_SHADER_ROOT_ACCESS
     };
 
     ID3DBlob* signature = nullptr;
@@ -191,18 +236,6 @@ static auto CreatePipelineStateObject(ID3D12Device* d3d_device, ID3D12CommandAll
 static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* rootSignature, ID3D12CommandQueue *commandQueue, ID3D12GraphicsCommandList* commandList,
                                             ID3D12GraphicsCommandList* commandBundleList) -> std::pair<ID3D12Resource*, ID3D12Resource*>
 {
-    const struct Vertex
-    {
-        float position[4];
-        float color[4];
-    } pointVertices[]{
-        // Direct3D是以左手作为前面背面顶点排列的依据
-        {.position { 0.0f, 0.0f, 0.0f, 1.0f }, .color { 0.9f, 0.1f, 0.1f, 1.0f } },     // for top-left primitives
-        {.position { 0.0f, 0.0f, 0.0f, 1.0f }, .color { 0.1f, 0.9f, 0.1f, 1.0f } },     // for top-right primitives
-        {.position { 0.0f, 0.0f, 0.0f, 1.0f }, .color { 0.1f, 0.1f, 0.9f, 1.0f } },     // for bottom-left primitives
-        {.position { 0.0f, 0.0f, 0.0f, 1.0f }, .color { 0.9f, 0.9f, 0.1f, 1.0f } }      // for bottom-right primitives
-    };
-
     const D3D12_HEAP_PROPERTIES defaultHeapProperties{
         .Type = D3D12_HEAP_TYPE_DEFAULT,    // default heap type for device visible memory
         .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
@@ -222,7 +255,7 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
     const D3D12_RESOURCE_DESC vbResourceDesc{
         .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
         .Alignment = 0,
-        .Width = sizeof(pointVertices),
+        .Width = sizeof(s_pointVertices),
         .Height = 1U,
         .DepthOrArraySize = 1,
         .MipLevels = 1,
@@ -264,10 +297,10 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
         return result;
     }
 
-    memcpy(hostMemPtr, pointVertices, sizeof(pointVertices));
+    memcpy(hostMemPtr, s_pointVertices, sizeof(s_pointVertices));
     uploadDevHostBuffer->Unmap(0, nullptr);
 
-    WriteToDeviceResourceAndSync(commandList, vertexBuffer, uploadDevHostBuffer, 0U, 0U, sizeof(pointVertices));
+    WriteToDeviceResourceAndSync(commandList, vertexBuffer, uploadDevHostBuffer, 0U, 0U, sizeof(s_pointVertices));
 
     hRes = commandList->Close();
     if (FAILED(hRes))
@@ -283,8 +316,8 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
     // Initialize the vertex buffer view.
     const D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
         .BufferLocation = vertexBuffer->GetGPUVirtualAddress(),
-        .SizeInBytes = (uint32_t)sizeof(pointVertices),
-        .StrideInBytes = sizeof(pointVertices[0])
+        .SizeInBytes = (uint32_t)sizeof(s_pointVertices),
+        .StrideInBytes = sizeof(s_pointVertices[0])
     };
 
     // Record commands to the command list bundle.
@@ -292,7 +325,7 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
     //commandBundleList->SetDescriptorHeaps(UINT(std::size(descHeaps)), descHeaps);
     commandBundleList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_POINTLIST);
     commandBundleList->IASetVertexBuffers(0U, 1U, &vertexBufferView);
-    commandBundleList->DrawInstanced(4U, 1U, 0U, 0U);
+    commandBundleList->DrawInstanced(GS_TEST_POINT_COUNT, 1U, 0U, 0U);
 
     // End of the record
     hRes = commandBundleList->Close();
@@ -310,8 +343,617 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
     return std::make_pair(uploadDevHostBuffer, vertexBuffer);
 }
 
-auto CreateGeometryShaderTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue *commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
-                                    std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12Resource*, ID3D12Resource*, bool>
+// Writing SV_ViewportArrayIndex from the vertex shader without a geometry shader emulation in the driver
+static auto SupportsViewportIndexFromVertexShader(ID3D12Device* d3d_device) -> bool
+{
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options{ };
+    const HRESULT hRes = d3d_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options));
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CheckFeatureSupport for `D3D12_FEATURE_D3D12_OPTIONS` failed: %ld\n", hRes);
+        return false;
+    }
+
+    return options.VPAndRTArrayIndexFromAnyShaderFeedingRasterizerSupportedWithoutGSEmulation != FALSE;
+}
+
+// The pipeline of gs_test_instanced.vs.hlsl: each point feeds GS_TEST_SQUARES_PER_POINT instances of a 4-vertex triangle strip.
+// Apart from the shaders, the input classification and the primitive topology type, the states are the same as CreatePipelineStateObject.
+static auto CreateInstancedPipelineStateObject(ID3D12Device* d3d_device, ID3D12RootSignature* rootSignature) -> ID3D12PipelineState*
+{
+    ID3D12PipelineState* pipelineState = nullptr;
+
+    D3D12_SHADER_BYTECODE vertexShaderObj = CreateCompiledShaderObjectFromPath("cso/gs_test_instanced.vs.cso");
+    D3D12_SHADER_BYTECODE pixelShaderObj = CreateCompiledShaderObjectFromPath("cso/gs_test.ps.cso");
+
+    do
+    {
+        if (vertexShaderObj.pShaderBytecode == nullptr || vertexShaderObj.BytecodeLength == 0) break;
+        if (pixelShaderObj.pShaderBytecode == nullptr || pixelShaderObj.BytecodeLength == 0) break;
+
+        // Every point is fetched once per square
+        const D3D12_INPUT_ELEMENT_DESC inputElementDescs[]{
+            { "POSITION", 0U, DXGI_FORMAT_R32G32B32A32_FLOAT, 0U, 0U, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, GS_TEST_SQUARES_PER_POINT },
+            { "COLOR", 0U, DXGI_FORMAT_R32G32B32A32_FLOAT, 0U, 16U, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, GS_TEST_SQUARES_PER_POINT }
+        };
+
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc{
+            .pRootSignature = rootSignature,
+            .VS = vertexShaderObj,
+            .PS = pixelShaderObj,
+            .DS = nullptr,
+            .HS = nullptr,
+            .GS = nullptr,
+            .StreamOutput { },
+            .BlendState {
+                .AlphaToCoverageEnable = FALSE,
+                .IndependentBlendEnable = FALSE,
+                .RenderTarget {
+                    // RenderTarget[0]
+                    {
+                        .BlendEnable = FALSE,
+                        .LogicOpEnable = FALSE,
+                        .SrcBlend = D3D12_BLEND_SRC_ALPHA,
+                        .DestBlend = D3D12_BLEND_INV_SRC_ALPHA,
+                        .BlendOp = D3D12_BLEND_OP_ADD,
+                        .SrcBlendAlpha = D3D12_BLEND_ONE,
+                        .DestBlendAlpha = D3D12_BLEND_ZERO,
+                        .BlendOpAlpha = D3D12_BLEND_OP_ADD,
+                        .LogicOp = D3D12_LOGIC_OP_NOOP,
+                        .RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL
+                    }
+                }
+            },
+            .SampleMask = UINT32_MAX,
+            .RasterizerState {
+                .FillMode = D3D12_FILL_MODE_SOLID,
+                .CullMode = D3D12_CULL_MODE_BACK,
+                .FrontCounterClockwise = FALSE,
+                .DepthBias = 0,
+                .DepthBiasClamp = 0.0f,
+                .SlopeScaledDepthBias = 0.0f,
+                .DepthClipEnable = TRUE,
+                .MultisampleEnable = FALSE,
+                .AntialiasedLineEnable = FALSE,
+                .ForcedSampleCount = 0,
+                .ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF
+            },
+            .DepthStencilState {
+                .DepthEnable = FALSE,
+                .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO,
+                .DepthFunc = D3D12_COMPARISON_FUNC_NEVER,
+                .StencilEnable = FALSE,
+                .StencilReadMask = 0,
+                .StencilWriteMask = 0,
+                .FrontFace { },
+                .BackFace { }
+            },
+            .InputLayout {
+                .pInputElementDescs = inputElementDescs,
+                .NumElements = (UINT)std::size(inputElementDescs)
+            },
+            .IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED,
+            .PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+            .NumRenderTargets = 1U,
+            .RTVFormats {
+                // RTVFormats[0]
+                { RENDER_TARGET_BUFFER_FOMRAT }
+            },
+            .DSVFormat = DXGI_FORMAT_D32_FLOAT,
+            .SampleDesc {
+                .Count = 1,
+                .Quality = 0
+            },
+            .NodeMask = 0U,
+            .CachedPSO { },
+            .Flags = D3D12_PIPELINE_STATE_FLAG_NONE
+        };
+
+        const HRESULT hRes = d3d_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateGraphicsPipelineState for instanced viewport PSO failed: %ld\n", hRes);
+            pipelineState = nullptr;
+            break;
+        }
+    }
+    while (false);
+
+    if (vertexShaderObj.pShaderBytecode != nullptr) {
+        free((void*)vertexShaderObj.pShaderBytecode);
+    }
+    if (pixelShaderObj.pShaderBytecode != nullptr) {
+        free((void*)pixelShaderObj.pShaderBytecode);
+    }
+
+    return pipelineState;
+}
+
+// Records the instanced path of the same scene as the bundle of CreateVertexBuffer
+static auto CreateInstancedCommandBundle(ID3D12Device* d3d_device, ID3D12CommandAllocator* commandBundleAllocator, ID3D12RootSignature* rootSignature,
+                                        ID3D12PipelineState* pipelineState, ID3D12Resource* vertexBuffer) -> ID3D12GraphicsCommandList*
+{
+    ID3D12GraphicsCommandList* commandBundleList = nullptr;
+
+    HRESULT hRes = d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_BUNDLE, commandBundleAllocator, pipelineState, IID_PPV_ARGS(&commandBundleList));
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CreateCommandList for instanced viewport command bundle failed: %ld\n", hRes);
+        return nullptr;
+    }
+
+    const D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
+        .BufferLocation = vertexBuffer->GetGPUVirtualAddress(),
+        .SizeInBytes = (uint32_t)sizeof(s_pointVertices),
+        .StrideInBytes = sizeof(s_pointVertices[0])
+    };
+
+    commandBundleList->SetGraphicsRootSignature(rootSignature);
+    commandBundleList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    commandBundleList->IASetVertexBuffers(0U, 1U, &vertexBufferView);
+    commandBundleList->DrawInstanced(4U, GS_TEST_POINT_COUNT * GS_TEST_SQUARES_PER_POINT, 0U, 0U);
+
+    hRes = commandBundleList->Close();
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "Close instanced viewport command bundle failed: %ld\n", hRes);
+        commandBundleList->Release();
+        return nullptr;
+    }
+
+    return commandBundleList;
+}
+
+// The pipeline of gs_test_expand.mesh.hlsl with the same states as CreatePipelineStateObject
+static auto CreateMeshExpansionPipelineStateObject(ID3D12Device2* d3d_device, ID3D12RootSignature* rootSignature) -> ID3D12PipelineState*
+{
+    D3D12_SHADER_BYTECODE meshShaderObj = CreateCompiledShaderObjectFromPath("cso/gs_test_expand.mesh.cso");
+    D3D12_SHADER_BYTECODE pixelShaderObj = CreateCompiledShaderObjectFromPath("cso/gs_test.ps.cso");
+
+    ID3D12PipelineState* pipelineState = nullptr;
+
+    do
+    {
+        if (meshShaderObj.pShaderBytecode == nullptr || meshShaderObj.BytecodeLength == 0) break;
+        if (pixelShaderObj.pShaderBytecode == nullptr || pixelShaderObj.BytecodeLength == 0) break;
+
+        struct {
+            RootSignatureSubobject rootSignatureSubobject;
+            ShaderByteCodeSubobject msShaderSubobject;
+            ShaderByteCodeSubobject psShaderSubobject;
+            BlendStateSubobject blendStateSubobject;
+            SampleMaskSubobject sampleMaskSubobject;
+            RasterizerStateSubobject raterizerStateSubobject;
+            DepthStencilSubobject depthStencilSubobject;
+            PrimitiveTopologyTypeSubobject primitiveTopologySubobject;
+            RenderTargetFormatsSubobject renderTargetFormatsSubobject;
+            DepthStencilViewFormat depthStencilViewFormatSubobject;
+            SampleDescSubobject sampleDescSubobject;
+            NodeMaskSubobject nodeMaskSubobject;
+            FlagsSubobject flagsSubobject;
+        } psoStream {
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_ROOT_SIGNATURE, rootSignature },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_MS, meshShaderObj },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PS, pixelShaderObj },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_BLEND, {
+                    .AlphaToCoverageEnable = FALSE,
+                    .IndependentBlendEnable = FALSE,
+                    .RenderTarget {
+                        {
+                            .BlendEnable = FALSE,
+                            .LogicOpEnable = FALSE,
+                            .SrcBlend = D3D12_BLEND_SRC_ALPHA,
+                            .DestBlend = D3D12_BLEND_INV_SRC_ALPHA,
+                            .BlendOp = D3D12_BLEND_OP_ADD,
+                            .SrcBlendAlpha = D3D12_BLEND_ONE,
+                            .DestBlendAlpha = D3D12_BLEND_ZERO,
+                            .BlendOpAlpha = D3D12_BLEND_OP_ADD,
+                            .LogicOp = D3D12_LOGIC_OP_NOOP,
+                            .RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL
+                        }
+                    }
+                }
+            },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_MASK, UINT32_MAX },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RASTERIZER, {
+                        .FillMode = D3D12_FILL_MODE_SOLID,
+                        .CullMode = D3D12_CULL_MODE_BACK,
+                        .FrontCounterClockwise = FALSE,
+                        .DepthBias = 0,
+                        .DepthBiasClamp = 0.0f,
+                        .SlopeScaledDepthBias = 0.0f,
+                        .DepthClipEnable = TRUE,
+                        .MultisampleEnable = FALSE,
+                        .AntialiasedLineEnable = FALSE,
+                        .ForcedSampleCount = 0,
+                        .ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF
+                    }
+            },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL, {
+                        .DepthEnable = FALSE,
+                        .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO,
+                        .DepthFunc = D3D12_COMPARISON_FUNC_NEVER,
+                        .StencilEnable = FALSE,
+                        .StencilReadMask = 0,
+                        .StencilWriteMask = 0,
+                        .FrontFace { },
+                        .BackFace { }
+                    }
+            },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PRIMITIVE_TOPOLOGY, D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RENDER_TARGET_FORMATS, {
+                    .RTFormats { RENDER_TARGET_BUFFER_FOMRAT },
+                    .NumRenderTargets = 1
+                }
+            },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL_FORMAT, DXGI_FORMAT_D32_FLOAT },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_DESC, { .Count = 1, .Quality = 0 } },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_NODE_MASK, 0 },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_FLAGS, D3D12_PIPELINE_STATE_FLAG_NONE }
+        };
+
+        const D3D12_PIPELINE_STATE_STREAM_DESC streamDesc{
+            .SizeInBytes = sizeof(psoStream),
+            .pPipelineStateSubobjectStream = &psoStream
+        };
+
+        const HRESULT hRes = d3d_device->CreatePipelineState(&streamDesc, IID_PPV_ARGS(&pipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreatePipelineState for mesh shader expansion failed: %ld\n", hRes);
+            pipelineState = nullptr;
+            break;
+        }
+    }
+    while (false);
+
+    if (meshShaderObj.pShaderBytecode != nullptr) {
+        free((void*)meshShaderObj.pShaderBytecode);
+    }
+    if (pixelShaderObj.pShaderBytecode != nullptr) {
+        free((void*)pixelShaderObj.pShaderBytecode);
+    }
+
+    return pipelineState;
+}
+
+// Binds pointCount points of pointBuffer to the mesh shader expansion and launches one group per GS_TEST_MESH_POINTS_PER_GROUP points
+static auto RecordMeshExpansion(ID3D12GraphicsCommandList6* commandList, ID3D12Resource* pointBuffer, UINT pointCount) -> void
+{
+    commandList->SetGraphicsRoot32BitConstant(0, pointCount, 0);                            // rootParameters[0]
+    commandList->SetGraphicsRootShaderResourceView(1, pointBuffer->GetGPUVirtualAddress()); // rootParameters[1]
+    commandList->DispatchMesh((pointCount + GS_TEST_MESH_POINTS_PER_GROUP - 1U) / GS_TEST_MESH_POINTS_PER_GROUP, 1U, 1U);
+}
+
+// Records the mesh shader path of the same scene as the bundle of CreateVertexBuffer
+static auto CreateMeshExpansionCommandBundle(ID3D12Device* d3d_device, ID3D12CommandAllocator* commandBundleAllocator, ID3D12RootSignature* rootSignature,
+                                            ID3D12PipelineState* pipelineState, ID3D12Resource* vertexBuffer) -> ID3D12GraphicsCommandList*
+{
+    ID3D12GraphicsCommandList* commandBundleList = nullptr;
+
+    HRESULT hRes = d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_BUNDLE, commandBundleAllocator, pipelineState, IID_PPV_ARGS(&commandBundleList));
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CreateCommandList for mesh shader expansion command bundle failed: %ld\n", hRes);
+        return nullptr;
+    }
+
+    // The vertex buffer is in the GENERIC_READ state, which includes NON_PIXEL_SHADER_RESOURCE
+    commandBundleList->SetGraphicsRootSignature(rootSignature);
+    RecordMeshExpansion((ID3D12GraphicsCommandList6*)commandBundleList, vertexBuffer, GS_TEST_POINT_COUNT);
+
+    hRes = commandBundleList->Close();
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "Close mesh shader expansion command bundle failed: %ld\n", hRes);
+        commandBundleList->Release();
+        return nullptr;
+    }
+
+    return commandBundleList;
+}
+
+#if RUN_VIEWPORT_ARRAY_BENCHMARK
+// Renders VIEWPORT_ARRAY_BENCHMARK_SCENE_COUNT copies of the test scene into 4 viewports, VIEWPORT_ARRAY_BENCHMARK_ITERATION_COUNT times,
+// through the geometry shader path and the available instanced vertex shader and mesh shader paths (nullptr pipeline states are skipped),
+// reports the GPU time and expanded primitive rate of each path and checks that they produce the same image as the geometry shader path.
+static auto RunViewportArrayBenchmark(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12RootSignature* rootSignature,
+                                    ID3D12PipelineState* geometryShaderPipelineState, ID3D12PipelineState* instancedPipelineState, ID3D12PipelineState* meshPipelineState) -> bool
+{
+    enum VIEWPORT_ARRAY_PATH_ID
+    {
+        VIEWPORT_ARRAY_PATH_GEOMETRY_SHADER,
+        VIEWPORT_ARRAY_PATH_INSTANCED_VERTEX_SHADER,
+        VIEWPORT_ARRAY_PATH_MESH_SHADER,
+
+        VIEWPORT_ARRAY_PATH_COUNT
+    };
+
+    const char* const pathNames[VIEWPORT_ARRAY_PATH_COUNT] = { "VS + GS", "instanced VS", "MS" };
+    ID3D12PipelineState* const pipelineStates[VIEWPORT_ARRAY_PATH_COUNT] = { geometryShaderPipelineState, instancedPipelineState, meshPipelineState };
+
+    constexpr UINT targetSize = VIEWPORT_ARRAY_BENCHMARK_TARGET_SIZE;
+    constexpr UINT pointCount = GS_TEST_POINT_COUNT * VIEWPORT_ARRAY_BENCHMARK_SCENE_COUNT;
+    constexpr UINT64 triangleCount = UINT64(pointCount) * GS_TEST_SQUARES_PER_POINT * 2U;
+    constexpr UINT sceneBufferSize = pointCount * UINT(sizeof(PointVertex));
+
+    // The read back buffer holds one image per path
+    constexpr UINT imageRowPitch = (targetSize * 4U + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1U) & ~(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1U);
+    constexpr UINT imageSize = imageRowPitch * targetSize;
+    constexpr UINT timestampCount = VIEWPORT_ARRAY_PATH_COUNT * 2U;
+    constexpr UINT readbackBufferSize = imageSize * VIEWPORT_ARRAY_PATH_COUNT;
+
+    OffscreenBenchmarkTarget target{ };
+    ID3D12Resource* uploadDevHostBuffer = nullptr;
+    ID3D12Resource* sceneVertexBuffer = nullptr;
+    ID3D12Resource* readbackBuffer = nullptr;
+    bool success = false;
+
+    do
+    {
+        constexpr FLOAT clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        if (!CreateOffscreenBenchmarkTarget(d3d_device, commandAllocator, nullptr, targetSize, targetSize, clearColor, timestampCount,
+                                            "viewport array benchmark", target)) break;
+
+        ID3D12GraphicsCommandList* const commandList = target.commandList;
+
+        const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+            .Type = D3D12_HEAP_TYPE_DEFAULT,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
+
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = defaultHeapProperties;
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_HEAP_PROPERTIES readbackHeapProperties = defaultHeapProperties;
+        readbackHeapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+        D3D12_RESOURCE_DESC bufferDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0,
+            .Width = sceneBufferSize,
+            .Height = 1U,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {.Count = 1U, .Quality = 0 },
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE
+        };
+        HRESULT hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadDevHostBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for viewport array benchmark upload buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&sceneVertexBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for viewport array benchmark vertex buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = readbackBufferSize;
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&readbackBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for viewport array benchmark read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        // The scene: copies of the 4 test points
+        PointVertex* hostMemPtr = nullptr;
+        hRes = uploadDevHostBuffer->Map(0, nullptr, (void**)&hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map viewport array benchmark upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        for (UINT i = 0; i < VIEWPORT_ARRAY_BENCHMARK_SCENE_COUNT; ++i) {
+            memcpy(&hostMemPtr[i * GS_TEST_POINT_COUNT], s_pointVertices, sizeof(s_pointVertices));
+        }
+        uploadDevHostBuffer->Unmap(0, nullptr);
+
+        WriteToDeviceResourceAndSync(commandList, sceneVertexBuffer, uploadDevHostBuffer, 0U, 0U, sceneBufferSize);
+
+        // One quadrant of the target per viewport
+        constexpr float halfTargetSize = float(targetSize) * 0.5f;
+        D3D12_VIEWPORT viewPorts[GS_TEST_POINT_COUNT]{ };
+        D3D12_RECT scissorRects[GS_TEST_POINT_COUNT]{ };
+        for (UINT i = 0; i < GS_TEST_POINT_COUNT; ++i)
+        {
+            viewPorts[i] = D3D12_VIEWPORT{
+                .TopLeftX = float(i % 2U) * halfTargetSize,
+                .TopLeftY = float(i / 2U) * halfTargetSize,
+                .Width = halfTargetSize,
+                .Height = halfTargetSize,
+                .MinDepth = 0.0f,
+                .MaxDepth = 1.0f
+            };
+            scissorRects[i] = D3D12_RECT{
+                .left = 0L,
+                .top = 0L,
+                .right = LONG(targetSize),
+                .bottom = LONG(targetSize)
+            };
+        }
+        commandList->RSSetViewports(GS_TEST_POINT_COUNT, viewPorts);
+        commandList->RSSetScissorRects(GS_TEST_POINT_COUNT, scissorRects);
+        commandList->OMSetRenderTargets(1, &target.rtvHandle, FALSE, &target.dsvHandle);
+        commandList->SetGraphicsRootSignature(rootSignature);
+
+        for (UINT path = 0; path < VIEWPORT_ARRAY_PATH_COUNT; ++path)
+        {
+            if (pipelineStates[path] == nullptr) continue;
+
+            commandList->ClearRenderTargetView(target.rtvHandle, clearColor, 0, nullptr);
+            commandList->EndQuery(target.queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, path * 2U);
+            commandList->SetPipelineState(pipelineStates[path]);
+
+            if (path == VIEWPORT_ARRAY_PATH_GEOMETRY_SHADER)
+            {
+                // SV_PrimitiveID restarts from 0 in every instance, so every instance is one copy of the scene
+                const D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
+                    .BufferLocation = sceneVertexBuffer->GetGPUVirtualAddress(),
+                    .SizeInBytes = (uint32_t)sizeof(s_pointVertices),
+                    .StrideInBytes = sizeof(s_pointVertices[0])
+                };
+
+                commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_POINTLIST);
+                commandList->IASetVertexBuffers(0U, 1U, &vertexBufferView);
+
+                for (UINT iteration = 0; iteration < VIEWPORT_ARRAY_BENCHMARK_ITERATION_COUNT; ++iteration) {
+                    commandList->DrawInstanced(GS_TEST_POINT_COUNT, VIEWPORT_ARRAY_BENCHMARK_SCENE_COUNT, 0U, 0U);
+                }
+            }
+            else if (path == VIEWPORT_ARRAY_PATH_INSTANCED_VERTEX_SHADER)
+            {
+                const D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
+                    .BufferLocation = sceneVertexBuffer->GetGPUVirtualAddress(),
+                    .SizeInBytes = sceneBufferSize,
+                    .StrideInBytes = sizeof(PointVertex)
+                };
+
+                commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+                commandList->IASetVertexBuffers(0U, 1U, &vertexBufferView);
+
+                for (UINT iteration = 0; iteration < VIEWPORT_ARRAY_BENCHMARK_ITERATION_COUNT; ++iteration) {
+                    commandList->DrawInstanced(4U, pointCount * GS_TEST_SQUARES_PER_POINT, 0U, 0U);
+                }
+            }
+            else
+            {
+                for (UINT iteration = 0; iteration < VIEWPORT_ARRAY_BENCHMARK_ITERATION_COUNT; ++iteration) {
+                    RecordMeshExpansion((ID3D12GraphicsCommandList6*)commandList, sceneVertexBuffer, pointCount);
+                }
+            }
+
+            commandList->EndQuery(target.queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, path * 2U + 1U);
+
+            D3D12_RESOURCE_BARRIER copyBarrier{
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = target.renderTargetTexture,
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET,
+                    .StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE
+                }
+            };
+            commandList->ResourceBarrier(1U, &copyBarrier);
+
+            const D3D12_TEXTURE_COPY_LOCATION dstLocation{
+                .pResource = readbackBuffer,
+                .Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+                .PlacedFootprint {
+                    .Offset = UINT64(path) * imageSize,
+                    .Footprint {
+                        .Format = RENDER_TARGET_BUFFER_FOMRAT,
+                        .Width = targetSize,
+                        .Height = targetSize,
+                        .Depth = 1U,
+                        .RowPitch = imageRowPitch
+                    }
+                }
+            };
+            const D3D12_TEXTURE_COPY_LOCATION srcLocation{
+                .pResource = target.renderTargetTexture,
+                .Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+                .SubresourceIndex = 0U
+            };
+            commandList->CopyTextureRegion(&dstLocation, 0U, 0U, 0U, &srcLocation, nullptr);
+
+            std::swap(copyBarrier.Transition.StateBefore, copyBarrier.Transition.StateAfter);
+            commandList->ResourceBarrier(1U, &copyBarrier);
+        }
+
+        UINT64 timestampFrequency = 0;
+        if (!ExecuteOffscreenBenchmark(commandQueue, target, "viewport array benchmark", timestampFrequency)) break;
+
+        const uint8_t* readbackData = nullptr;
+        hRes = readbackBuffer->Map(0, nullptr, (void**)&readbackData);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map viewport array benchmark read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        const UINT64* timestamps = nullptr;
+        hRes = target.timestampReadbackBuffer->Map(0, nullptr, (void**)&timestamps);
+        if (FAILED(hRes))
+        {
+            readbackBuffer->Unmap(0, nullptr);
+            fprintf(stderr, "Map viewport array benchmark timestamp read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        const double geometryShaderTime = double(timestamps[1] - timestamps[0]) / double(timestampFrequency) / VIEWPORT_ARRAY_BENCHMARK_ITERATION_COUNT;
+        bool allImagesMatch = true;
+
+        printf("Viewport array benchmark: %u points expanded into %llu triangles in %u viewports of %ux%u, %u iterations\n",
+                pointCount, triangleCount, GS_TEST_POINT_COUNT, targetSize / 2U, targetSize / 2U, VIEWPORT_ARRAY_BENCHMARK_ITERATION_COUNT);
+        for (UINT path = 0; path < VIEWPORT_ARRAY_PATH_COUNT; ++path)
+        {
+            if (pipelineStates[path] == nullptr) continue;
+
+            const double gpuTime = double(timestamps[path * 2U + 1U] - timestamps[path * 2U]) / double(timestampFrequency) / VIEWPORT_ARRAY_BENCHMARK_ITERATION_COUNT;
+            printf("    %-14s GPU: %.3f ms, %.1f M expanded triangles/s", pathNames[path], gpuTime * 1000.0,
+                    gpuTime > 0.0 ? double(triangleCount) / gpuTime / 1000000.0 : 0.0);
+
+            // Compared with the geometry shader baseline
+            if (path != VIEWPORT_ARRAY_PATH_GEOMETRY_SHADER)
+            {
+                UINT mismatchedRowCount = 0U;
+                for (UINT row = 0; row < targetSize; ++row)
+                {
+                    if (memcmp(&readbackData[row * imageRowPitch], &readbackData[path * imageSize + row * imageRowPitch], targetSize * 4U) != 0) {
+                        ++mismatchedRowCount;
+                    }
+                }
+                allImagesMatch = allImagesMatch && mismatchedRowCount == 0U;
+
+                printf(", %.2fx the GS path, image %s", gpuTime > 0.0 ? geometryShaderTime / gpuTime : 0.0, mismatchedRowCount == 0U ? "matches" : "MISMATCH");
+            }
+            printf("\n");
+        }
+
+        target.timestampReadbackBuffer->Unmap(0, nullptr);
+        readbackBuffer->Unmap(0, nullptr);
+
+        success = allImagesMatch;
+    }
+    while (false);
+
+    ReleaseOffscreenBenchmarkTarget(target);
+    if (uploadDevHostBuffer != nullptr) {
+        uploadDevHostBuffer->Release();
+    }
+    if (sceneVertexBuffer != nullptr) {
+        sceneVertexBuffer->Release();
+    }
+    if (readbackBuffer != nullptr) {
+        readbackBuffer->Release();
+    }
+
+    return success;
+}
+#endif
+
+// @return [rootSignature, pipelineState, commandList, commandBundle, uploadDevHostBuffer, vertexBuffer,
+//          instancedPipelineState, instancedCommandBundle, meshPipelineState, meshCommandBundle, success]
+// The instanced pipeline state and bundle are nullptr when the device cannot write SV_ViewportArrayIndex from the vertex shader,
+// the mesh pipeline state and bundle are nullptr without mesh shader support.
+auto CreateGeometryShaderTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue *commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator,
+                                    bool supportMeshShader) ->
+                                    std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12Resource*, ID3D12Resource*,
+                                                ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, bool>
 {
     ID3D12RootSignature* rootSignature = nullptr;
     ID3D12PipelineState* pipelineState = nullptr;
@@ -319,9 +961,14 @@ auto CreateGeometryShaderTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue
     ID3D12GraphicsCommandList* commandBundle = nullptr;
     ID3D12Resource* uploadDevHostBuffer = nullptr;
     ID3D12Resource* vertexBuffer = nullptr;
+    ID3D12PipelineState* instancedPipelineState = nullptr;
+    ID3D12GraphicsCommandList* instancedCommandBundle = nullptr;
+    ID3D12PipelineState* meshPipelineState = nullptr;
+    ID3D12GraphicsCommandList* meshCommandBundle = nullptr;
     bool success = false;
 
-    auto const result = std::make_tuple(rootSignature, pipelineState, commandList, commandBundle, uploadDevHostBuffer, vertexBuffer, success);
+    auto const result = std::make_tuple(rootSignature, pipelineState, commandList, commandBundle, uploadDevHostBuffer, vertexBuffer,
+                                        instancedPipelineState, instancedCommandBundle, meshPipelineState, meshCommandBundle, success);
 
     rootSignature = CreateRootSignature(d3d_device);
     if (rootSignature == nullptr) return result;
@@ -342,9 +989,40 @@ auto CreateGeometryShaderTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue
         if (uploadDevHostBuffer == nullptr || vertexBuffer == nullptr) break;
 
         success = true;
+
+        // The geometry shader path stays the fallback when the other paths are not available
+        if (SupportsViewportIndexFromVertexShader(d3d_device))
+        {
+            instancedPipelineState = CreateInstancedPipelineStateObject(d3d_device, rootSignature);
+            if (instancedPipelineState != nullptr) {
+                instancedCommandBundle = CreateInstancedCommandBundle(d3d_device, commandBundleAllocator, rootSignature, instancedPipelineState, vertexBuffer);
+            }
+        }
+        else {
+            puts("Current device cannot write SV_ViewportArrayIndex from the vertex shader, so the instanced vertex shader path is not available.");
+        }
+
+        if (supportMeshShader)
+        {
+            meshPipelineState = CreateMeshExpansionPipelineStateObject((ID3D12Device2*)d3d_device, rootSignature);
+            if (meshPipelineState != nullptr) {
+                meshCommandBundle = CreateMeshExpansionCommandBundle(d3d_device, commandBundleAllocator, rootSignature, meshPipelineState, vertexBuffer);
+            }
+        }
+
+        if (instancedCommandBundle != nullptr || meshCommandBundle != nullptr) {
+            puts("Press 'V' to switch between the instanced vertex shader, mesh shader and geometry shader paths.");
+        }
+
+#if RUN_VIEWPORT_ARRAY_BENCHMARK
+        if (!RunViewportArrayBenchmark(d3d_device, commandQueue, commandAllocator, rootSignature, pipelineState, instancedPipelineState, meshPipelineState)) {
+            fprintf(stderr, "Viewport array benchmark failed!\n");
+        }
+#endif
     }
     while (false);
 
-    return std::make_tuple(rootSignature, pipelineState, commandList, commandBundle, uploadDevHostBuffer, vertexBuffer, success);
+    return std::make_tuple(rootSignature, pipelineState, commandList, commandBundle, uploadDevHostBuffer, vertexBuffer,
+                            instancedPipelineState, instancedCommandBundle, meshPipelineState, meshCommandBundle, success);
 }
 
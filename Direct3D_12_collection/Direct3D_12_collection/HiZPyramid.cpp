@@ -0,0 +1,137 @@
+#include "HiZPyramid.h"
+
+#include <cmath>
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+auto CreateHiZPyramidLayout(uint32_t width, uint32_t height) -> HiZPyramid
+{
+    HiZPyramid pyramid{ };
+
+    uint32_t offset = 0U;
+    for (uint32_t level = 0U; level < HI_Z_MAX_LEVEL_COUNT; ++level)
+    {
+        const uint32_t levelWidth = std::max(1U, width >> level);
+        const uint32_t levelHeight = std::max(1U, height >> level);
+
+        pyramid.levels[level] = { .offset = offset, .width = levelWidth, .height = levelHeight };
+        offset += levelWidth * levelHeight;
+        pyramid.levelCount = level + 1U;
+
+        if (levelWidth == 1U && levelHeight == 1U) break;
+    }
+
+    pyramid.texelCount = offset;
+    pyramid.minMaxDepths.resize(size_t(offset) * 2U);
+
+    return pyramid;
+}
+
+// Source texel range [first, last] of the destination texel `dst` on one axis
+static auto GetHiZSourceRange(uint32_t dst, uint32_t dstSize, uint32_t srcSize) -> std::pair<uint32_t, uint32_t>
+{
+    const uint32_t first = std::min(dst * 2U, srcSize - 1U);
+    uint32_t last = std::min(dst * 2U + 1U, srcSize - 1U);
+    if (dst == dstSize - 1U) {
+        last = srcSize - 1U;
+    }
+    return std::make_pair(first, last);
+}
+
+auto BuildHiZPyramidLevels(HiZPyramid& pyramid) -> void
+{
+    float* const minMaxDepths = pyramid.minMaxDepths.data();
+
+    for (uint32_t level = 1U; level < pyramid.levelCount; ++level)
+    {
+        const HiZPyramidLevel& src = pyramid.levels[level - 1U];
+        const HiZPyramidLevel& dst = pyramid.levels[level];
+
+        for (uint32_t y = 0U; y < dst.height; ++y)
+        {
+            const auto [srcY0, srcY1] = GetHiZSourceRange(y, dst.height, src.height);
+
+            for (uint32_t x = 0U; x < dst.width; ++x)
+            {
+                const auto [srcX0, srcX1] = GetHiZSourceRange(x, dst.width, src.width);
+
+                float minDepth = INFINITY;
+                float maxDepth = -INFINITY;
+                for (uint32_t sy = srcY0; sy <= srcY1; ++sy)
+                {
+                    for (uint32_t sx = srcX0; sx <= srcX1; ++sx)
+                    {
+                        const float* texel = &minMaxDepths[(size_t(src.offset) + sy * src.width + sx) * 2U];
+                        minDepth = std::min(minDepth, texel[0]);
+                        maxDepth = std::max(maxDepth, texel[1]);
+                    }
+                }
+
+                float* dstTexel = &minMaxDepths[(size_t(dst.offset) + y * dst.width + x) * 2U];
+                dstTexel[0] = minDepth;
+                dstTexel[1] = maxDepth;
+            }
+        }
+    }
+}
+
+auto BuildHiZPyramid(const float* depths, uint32_t width, uint32_t height) -> HiZPyramid
+{
+    HiZPyramid pyramid = CreateHiZPyramidLayout(width, height);
+
+    const size_t texelCount = size_t(width) * height;
+    for (size_t i = 0; i < texelCount; ++i)
+    {
+        pyramid.minMaxDepths[i * 2U + 0U] = depths[i];
+        pyramid.minMaxDepths[i * 2U + 1U] = depths[i];
+    }
+
+    BuildHiZPyramidLevels(pyramid);
+
+    return pyramid;
+}
+
+auto HiZCullObject(const HiZPyramid& pyramid, const HiZObjectBounds& bounds) -> HiZCullResult
+{
+    const int baseWidth = int(pyramid.levels[0].width);
+    const int baseHeight = int(pyramid.levels[0].height);
+
+    // Pixels whose centers may be touched by the rectangle, clamped to the depth buffer
+    const int pixelX0 = std::max(int(std::floor(bounds.minX)), 0);
+    const int pixelY0 = std::max(int(std::floor(bounds.minY)), 0);
+    const int pixelX1 = std::min(int(std::ceil(bounds.maxX)) - 1, baseWidth - 1);
+    const int pixelY1 = std::min(int(std::ceil(bounds.maxY)) - 1, baseHeight - 1);
+    if (pixelX1 < pixelX0 || pixelY1 < pixelY0) return HI_Z_CULL_OUTSIDE;
+
+    // Select the level on which the rectangle spans at most 2 x 2 texels
+    const uint32_t extent = uint32_t(std::max(pixelX1 - pixelX0, pixelY1 - pixelY0) + 1);
+    const uint32_t level = std::min(uint32_t(std::bit_width(extent - 1U)), pyramid.levelCount - 1U);
+    const HiZPyramidLevel& footprint = pyramid.levels[level];
+
+    const uint32_t texelX0 = std::min(uint32_t(pixelX0) >> level, footprint.width - 1U);
+    const uint32_t texelY0 = std::min(uint32_t(pixelY0) >> level, footprint.height - 1U);
+    const uint32_t texelX1 = std::min(uint32_t(pixelX1) >> level, footprint.width - 1U);
+    const uint32_t texelY1 = std::min(uint32_t(pixelY1) >> level, footprint.height - 1U);
+
+    float occluderMinDepth = INFINITY;
+    float occluderMaxDepth = -INFINITY;
+    for (uint32_t y = texelY0; y <= texelY1; ++y)
+    {
+        for (uint32_t x = texelX0; x <= texelX1; ++x)
+        {
+            const float* texel = &pyramid.minMaxDepths[(size_t(footprint.offset) + y * footprint.width + x) * 2U];
+            occluderMinDepth = std::min(occluderMinDepth, texel[0]);
+            occluderMaxDepth = std::max(occluderMaxDepth, texel[1]);
+        }
+    }
+
+    if (bounds.minDepth > occluderMaxDepth) return HI_Z_CULL_OCCLUDED;
+    if (bounds.maxDepth < occluderMinDepth) return HI_Z_CULL_UNOCCLUDED;
+    return HI_Z_CULL_VISIBLE;
+}
+
+auto GetHiZCullOutputElementCount(uint32_t objectCount) -> uint32_t
+{
+    return HI_Z_CULL_OUTPUT_VISIBILITY_BITS_INDEX + (objectCount + 31U) / 32U + objectCount;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical depth (Hi-Z) pyramid shared by hiz_build.comp.hlsl, hiz_cull.comp.hlsl and the CPU reference.
+// Every texel stores a (min depth, max depth) pair. Level 0 has the size of the depth buffer and level n has
+// max(1, size >> n) texels on each axis. When the source level has an odd width or height,
+// the last texel column or row of the destination level also folds in the remaining source texels,
+// so pixel (x, y) is always covered by texel (min(x >> n, width - 1), min(y >> n, height - 1)) of level n.
+// All levels are packed into one buffer, level 0 first.
+
+static constexpr uint32_t HI_Z_MAX_LEVEL_COUNT = 16U;
+static constexpr uint32_t HI_Z_BUILD_GROUP_SIZE = 8U;       // [numthreads(8, 8, 1)] in hiz_build.comp.hlsl
+static constexpr uint32_t HI_Z_CULL_GROUP_SIZE = 64U;       // [numthreads(64, 1, 1)] in hiz_cull.comp.hlsl
+
+// Layout of the culling output buffer in uint elements:
+// [visible count][unoccluded count][visibility bits, one bit per object][compacted visible object indices]
+// The visible count can be used directly as the count buffer of ExecuteIndirect with the compacted indices.
+static constexpr uint32_t HI_Z_CULL_OUTPUT_VISIBLE_COUNT_INDEX = 0U;
+static constexpr uint32_t HI_Z_CULL_OUTPUT_UNOCCLUDED_COUNT_INDEX = 1U;
+static constexpr uint32_t HI_Z_CULL_OUTPUT_VISIBILITY_BITS_INDEX = 2U;
+
+// The same layout as `ObjectBounds` in hiz_cull.comp.hlsl
+struct HiZObjectBounds
+{
+    float minX;         // screen-space bounding rectangle in pixels, [minX, maxX) x [minY, maxY)
+    float minY;
+    float maxX;
+    float maxY;
+    float minDepth;     // the nearest depth of the object
+    float maxDepth;     // the farthest depth of the object
+    float paddings[2];
+};
+
+struct HiZPyramidLevel
+{
+    uint32_t offset;    // in texels from the start of the pyramid
+    uint32_t width;
+    uint32_t height;
+};
+
+struct HiZPyramid
+{
+    uint32_t levelCount;
+    uint32_t texelCount;
+    HiZPyramidLevel levels[HI_Z_MAX_LEVEL_COUNT];
+
+    // (min, max) pairs of all levels
+    std::vector<float> minMaxDepths;
+};
+
+enum HiZCullResult
+{
+    HI_Z_CULL_OUTSIDE,          // the rectangle does not intersect the depth buffer
+    HI_Z_CULL_OCCLUDED,         // the object is behind the farthest occluder depth in its footprint
+    HI_Z_CULL_VISIBLE,          // the object may be visible
+    HI_Z_CULL_UNOCCLUDED        // the object is in front of the nearest occluder depth in its footprint
+};
+
+// @return the pyramid with the level layout of a width x height depth buffer, depths are not initialized
+extern auto CreateHiZPyramidLayout(uint32_t width, uint32_t height) -> HiZPyramid;
+
+// depths point to width x height tightly packed depth values.
+// D3D12_COMPARISON_FUNC_LESS is assumed, so smaller depth values are nearer.
+extern auto BuildHiZPyramid(const float* depths, uint32_t width, uint32_t height) -> HiZPyramid;
+
+// Rebuilds level 1 and above from the level 0 already stored in the pyramid
+extern auto BuildHiZPyramidLevels(HiZPyramid& pyramid) -> void;
+
+extern auto HiZCullObject(const HiZPyramid& pyramid, const HiZObjectBounds& bounds) -> HiZCullResult;
+
+// @return the number of uint elements of the culling output buffer
+extern auto GetHiZCullOutputElementCount(uint32_t objectCount) -> uint32_t;
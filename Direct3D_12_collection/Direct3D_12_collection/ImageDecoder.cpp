@@ -0,0 +1,733 @@
+#include "ImageDecoder.h"
+
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+
+// Larger images are rejected, so that the sizes of the subresources can not overflow
+static constexpr uint32_t IMAGE_MAX_DIMENSION = 1U << 16;
+
+static constexpr size_t BMP_FILE_HEADER_SIZE = 14U;
+static constexpr size_t TGA_HEADER_SIZE = 18U;
+static constexpr size_t DDS_HEADER_SIZE = 4U + 124U;        // magic and DDS_HEADER
+static constexpr size_t DDS_DX10_HEADER_SIZE = 20U;
+
+static constexpr uint32_t BMP_COMPRESSION_RGB = 0U;
+static constexpr uint32_t BMP_COMPRESSION_BITFIELDS = 3U;
+static constexpr uint32_t BMP_COMPRESSION_ALPHABITFIELDS = 6U;
+
+static constexpr uint32_t DDS_FLAG_MIPMAPCOUNT = 0x20000U;
+static constexpr uint32_t DDS_PIXEL_FORMAT_FOURCC = 0x4U;
+static constexpr uint32_t DDS_PIXEL_FORMAT_RGB = 0x40U;
+static constexpr uint32_t DDS_PIXEL_FORMAT_LUMINANCE = 0x20000U;
+static constexpr uint32_t DDS_CAPS2_CUBEMAP = 0x200U;
+static constexpr uint32_t DDS_CAPS2_CUBEMAP_ALL_FACES = 0xfc00U;
+static constexpr uint32_t DDS_CAPS2_VOLUME = 0x200000U;
+static constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3U;
+static constexpr uint32_t DDS_MISC_TEXTURECUBE = 0x4U;
+
+static constexpr auto MakeFourCC(char a, char b, char c, char d) -> uint32_t
+{
+    return uint32_t(uint8_t(a)) | uint32_t(uint8_t(b)) << 8 | uint32_t(uint8_t(c)) << 16 | uint32_t(uint8_t(d)) << 24;
+}
+
+static auto ReadU16(const uint8_t* p) -> uint32_t
+{
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8;
+}
+
+static auto ReadU32(const uint8_t* p) -> uint32_t
+{
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+auto GetImagePixelFormatName(ImagePixelFormat pixelFormat) -> const char*
+{
+    switch (pixelFormat)
+    {
+    case ImagePixelFormat::R8:
+        return "R8";
+    case ImagePixelFormat::R8G8B8A8:
+        return "R8G8B8A8";
+    case ImagePixelFormat::B8G8R8A8:
+        return "B8G8R8A8";
+    case ImagePixelFormat::B8G8R8X8:
+        return "B8G8R8X8";
+    case ImagePixelFormat::R16G16B16A16:
+        return "R16G16B16A16";
+    case ImagePixelFormat::R16G16B16A16Float:
+        return "R16G16B16A16 float";
+    case ImagePixelFormat::R32G32B32A32Float:
+        return "R32G32B32A32 float";
+    case ImagePixelFormat::BC1:
+        return "BC1";
+    case ImagePixelFormat::BC2:
+        return "BC2";
+    case ImagePixelFormat::BC3:
+        return "BC3";
+    case ImagePixelFormat::BC4:
+        return "BC4";
+    case ImagePixelFormat::BC5:
+        return "BC5";
+    case ImagePixelFormat::BC6HUnsignedFloat:
+        return "BC6H unsigned float";
+    case ImagePixelFormat::BC6HSignedFloat:
+        return "BC6H signed float";
+    case ImagePixelFormat::BC7:
+        return "BC7";
+    case ImagePixelFormat::Unknown:
+    default:
+        return "Unknown";
+    }
+}
+
+auto GetImagePixelFormatElementSize(ImagePixelFormat pixelFormat) -> uint32_t
+{
+    switch (pixelFormat)
+    {
+    case ImagePixelFormat::R8:
+        return 1U;
+    case ImagePixelFormat::R8G8B8A8:
+    case ImagePixelFormat::B8G8R8A8:
+    case ImagePixelFormat::B8G8R8X8:
+        return 4U;
+    case ImagePixelFormat::R16G16B16A16:
+    case ImagePixelFormat::R16G16B16A16Float:
+    case ImagePixelFormat::BC1:
+    case ImagePixelFormat::BC4:
+        return 8U;
+    case ImagePixelFormat::R32G32B32A32Float:
+    case ImagePixelFormat::BC2:
+    case ImagePixelFormat::BC3:
+    case ImagePixelFormat::BC5:
+    case ImagePixelFormat::BC6HUnsignedFloat:
+    case ImagePixelFormat::BC6HSignedFloat:
+    case ImagePixelFormat::BC7:
+        return 16U;
+    case ImagePixelFormat::Unknown:
+    default:
+        return 0U;
+    }
+}
+
+auto IsImagePixelFormatBlockCompressed(ImagePixelFormat pixelFormat) -> bool
+{
+    return pixelFormat >= ImagePixelFormat::BC1 && pixelFormat <= ImagePixelFormat::BC7;
+}
+
+auto GetImageSubresourceLayout(const ImageInfo& info, uint32_t mipLevel) -> ImageSubresourceLayout
+{
+    const uint32_t width = (std::max)(info.width >> (std::min)(mipLevel, 31U), 1U);
+    const uint32_t height = (std::max)(info.height >> (std::min)(mipLevel, 31U), 1U);
+    const uint32_t elementSize = GetImagePixelFormatElementSize(info.pixelFormat);
+
+    if (IsImagePixelFormatBlockCompressed(info.pixelFormat)) {
+        return ImageSubresourceLayout{ .width = width, .height = height, .rowCount = (height + 3U) / 4U, .rowSize = size_t((width + 3U) / 4U) * elementSize };
+    }
+    return ImageSubresourceLayout{ .width = width, .height = height, .rowCount = height, .rowSize = size_t(width) * elementSize };
+}
+
+// The rows of a subresource as stored in the file, in storage order
+struct ImageSourceRows
+{
+    size_t offset;
+    size_t rowPitch;
+    uint32_t rowCount;
+};
+
+// DDS files store the mip levels of every array slice one after the other, with tightly packed rows
+static auto GetImageSourceRows(const ImageInfo& info, uint32_t mipLevel, uint32_t arraySlice) -> ImageSourceRows
+{
+    if (info.fileFormat != ImageFileFormat::DDS) {
+        return ImageSourceRows{ .offset = info.dataOffset, .rowPitch = info.sourceRowPitch, .rowCount = info.height };
+    }
+
+    auto const sourceRowPitch = [&info](const ImageSubresourceLayout& layout) -> size_t {
+        return info.encoding == ImageEncoding::BGR24 ? size_t(layout.width) * info.sourcePixelSize : layout.rowSize;
+    };
+
+    size_t sliceSize = 0;
+    size_t mipOffset = 0;
+    for (uint32_t mip = 0U; mip < info.mipLevelCount; ++mip)
+    {
+        const ImageSubresourceLayout layout = GetImageSubresourceLayout(info, mip);
+        if (mip == mipLevel) {
+            mipOffset = sliceSize;
+        }
+        sliceSize += sourceRowPitch(layout) * layout.rowCount;
+    }
+
+    const ImageSubresourceLayout layout = GetImageSubresourceLayout(info, mipLevel);
+    return ImageSourceRows{ .offset = info.dataOffset + sliceSize * arraySlice + mipOffset, .rowPitch = sourceRowPitch(layout), .rowCount = layout.rowCount };
+}
+
+static auto ParseBMPHeader(const uint8_t* data, size_t size, ImageInfo& info) -> bool
+{
+    if (size < BMP_FILE_HEADER_SIZE + 40U || data[0] != 'B' || data[1] != 'M') return false;
+
+    // BITMAPINFOHEADER and its V4 and V5 extensions
+    const uint8_t* header = data + BMP_FILE_HEADER_SIZE;
+    const uint32_t headerSize = ReadU32(header);
+    const int32_t width = int32_t(ReadU32(header + 4));
+    const int32_t height = int32_t(ReadU32(header + 8));
+    const uint32_t bitCount = ReadU16(header + 14);
+    const uint32_t compression = ReadU32(header + 16);
+    const uint32_t colorsUsed = ReadU32(header + 32);
+    if (headerSize < 40U || BMP_FILE_HEADER_SIZE + headerSize > size) return false;
+    if (width <= 0 || height == 0 || height == INT32_MIN) return false;
+    if (uint32_t(width) > IMAGE_MAX_DIMENSION || (height < 0 ? 0U - uint32_t(height) : uint32_t(height)) > IMAGE_MAX_DIMENSION) return false;
+
+    info.fileFormat = ImageFileFormat::BMP;
+    info.width = uint32_t(width);
+    info.height = uint32_t(height < 0 ? -height : height);
+    info.bottomUp = height > 0;
+    info.dataOffset = ReadU32(data + 10);
+    info.sourceRowPitch = (size_t(info.width) * bitCount + 31U) / 32U * 4U;
+
+    if (bitCount == 8U && compression == BMP_COMPRESSION_RGB)
+    {
+        info.pixelFormat = ImagePixelFormat::B8G8R8X8;
+        info.encoding = ImageEncoding::Palette8;
+        info.sourcePixelSize = 1U;
+        info.paletteOffset = BMP_FILE_HEADER_SIZE + headerSize;
+        info.paletteSize = colorsUsed == 0U ? 256U : colorsUsed;
+        if (info.paletteSize > 256U || info.paletteOffset + size_t(info.paletteSize) * 4U > size) return false;
+    }
+    else if (bitCount == 24U && compression == BMP_COMPRESSION_RGB)
+    {
+        info.pixelFormat = ImagePixelFormat::B8G8R8X8;
+        info.encoding = ImageEncoding::BGR24;
+        info.sourcePixelSize = 3U;
+    }
+    else if (bitCount == 32U && compression == BMP_COMPRESSION_RGB)
+    {
+        // The fourth byte is unused
+        info.pixelFormat = ImagePixelFormat::B8G8R8X8;
+        info.encoding = ImageEncoding::Direct;
+    }
+    else if (bitCount == 32U && (compression == BMP_COMPRESSION_BITFIELDS || compression == BMP_COMPRESSION_ALPHABITFIELDS))
+    {
+        // The masks follow a BITMAPINFOHEADER, and are part of the V4 and V5 headers
+        const size_t maskOffset = BMP_FILE_HEADER_SIZE + 40U;
+        const bool hasAlphaMask = compression == BMP_COMPRESSION_ALPHABITFIELDS || headerSize >= 56U;
+        if (maskOffset + (hasAlphaMask ? 16U : 12U) > size) return false;
+
+        const uint32_t redMask = ReadU32(data + maskOffset);
+        const uint32_t greenMask = ReadU32(data + maskOffset + 4U);
+        const uint32_t blueMask = ReadU32(data + maskOffset + 8U);
+        const uint32_t alphaMask = hasAlphaMask ? ReadU32(data + maskOffset + 12U) : 0U;
+
+        if (redMask == 0x00ff0000U && greenMask == 0x0000ff00U && blueMask == 0x000000ffU) {
+            info.pixelFormat = alphaMask == 0xff000000U ? ImagePixelFormat::B8G8R8A8 : ImagePixelFormat::B8G8R8X8;
+        }
+        else if (redMask == 0x000000ffU && greenMask == 0x0000ff00U && blueMask == 0x00ff0000U && alphaMask == 0xff000000U) {
+            info.pixelFormat = ImagePixelFormat::R8G8B8A8;
+        }
+        else return false;
+
+        info.encoding = ImageEncoding::Direct;
+    }
+    else return false;
+
+    return info.dataOffset <= size && info.sourceRowPitch * info.height <= size - info.dataOffset;
+}
+
+// TGA files have no magic number, so the header is only accepted when every field has a supported value
+static auto ParseTGAHeader(const uint8_t* data, size_t size, ImageInfo& info) -> bool
+{
+    if (size < TGA_HEADER_SIZE) return false;
+
+    const uint32_t idLength = data[0];
+    const uint32_t colorMapType = data[1];
+    const uint32_t imageType = data[2];
+    const uint32_t colorMapLength = ReadU16(data + 5);
+    const uint32_t colorMapEntrySize = data[7];
+    const uint32_t width = ReadU16(data + 12);
+    const uint32_t height = ReadU16(data + 14);
+    const uint32_t pixelDepth = data[16];
+    const uint32_t descriptor = data[17];
+
+    // A color map of a true-color or grayscale image is only skipped
+    if (colorMapType > 1U || width == 0U || height == 0U) return false;
+    if ((descriptor & 0xd0U) != 0U) return false;       // right-to-left and interleaved images
+    if (colorMapType == 1U && colorMapEntrySize != 15U && colorMapEntrySize != 16U && colorMapEntrySize != 24U && colorMapEntrySize != 32U) return false;
+
+    const bool grayscale = imageType == 3U || imageType == 11U;
+    const bool trueColor = imageType == 2U || imageType == 10U;
+    if (!(grayscale && pixelDepth == 8U) && !(trueColor && (pixelDepth == 24U || pixelDepth == 32U))) return false;
+
+    const uint32_t alphaBits = descriptor & 0xfU;
+    if (alphaBits != 0U && !(pixelDepth == 32U && alphaBits == 8U)) return false;
+
+    info.fileFormat = ImageFileFormat::TGA;
+    info.width = width;
+    info.height = height;
+    info.bottomUp = (descriptor & 0x20U) == 0U;
+    info.dataOffset = TGA_HEADER_SIZE + idLength + size_t(colorMapType) * colorMapLength * ((colorMapEntrySize + 7U) / 8U);
+    info.sourcePixelSize = pixelDepth / 8U;
+    info.sourceRowPitch = size_t(width) * info.sourcePixelSize;
+    info.pixelFormat = grayscale ? ImagePixelFormat::R8 : (alphaBits == 8U ? ImagePixelFormat::B8G8R8A8 : ImagePixelFormat::B8G8R8X8);
+
+    if (imageType >= 9U)
+    {
+        // The size of the compressed data is only known after decoding it
+        info.encoding = ImageEncoding::RunLength;
+        return info.dataOffset < size;
+    }
+
+    info.encoding = pixelDepth == 24U ? ImageEncoding::BGR24 : ImageEncoding::Direct;
+    return info.dataOffset <= size && info.sourceRowPitch * info.height <= size - info.dataOffset;
+}
+
+static auto GetDXGIPixelFormat(uint32_t dxgiFormat, bool* sRGB) -> ImagePixelFormat
+{
+    struct DXGIFormatEntry
+    {
+        uint32_t dxgiFormat;
+        ImagePixelFormat pixelFormat;
+        bool sRGB;
+    };
+
+    // The numeric values of DXGI_FORMAT
+    static constexpr DXGIFormatEntry dxgiFormats[]{
+        { 2U, ImagePixelFormat::R32G32B32A32Float, false },
+        { 10U, ImagePixelFormat::R16G16B16A16Float, false },
+        { 11U, ImagePixelFormat::R16G16B16A16, false },
+        { 28U, ImagePixelFormat::R8G8B8A8, false },
+        { 29U, ImagePixelFormat::R8G8B8A8, true },
+        { 61U, ImagePixelFormat::R8, false },
+        { 71U, ImagePixelFormat::BC1, false },
+        { 72U, ImagePixelFormat::BC1, true },
+        { 74U, ImagePixelFormat::BC2, false },
+        { 75U, ImagePixelFormat::BC2, true },
+        { 77U, ImagePixelFormat::BC3, false },
+        { 78U, ImagePixelFormat::BC3, true },
+        { 80U, ImagePixelFormat::BC4, false },
+        { 83U, ImagePixelFormat::BC5, false },
+        { 87U, ImagePixelFormat::B8G8R8A8, false },
+        { 88U, ImagePixelFormat::B8G8R8X8, false },
+        { 91U, ImagePixelFormat::B8G8R8A8, true },
+        { 93U, ImagePixelFormat::B8G8R8X8, true },
+        { 95U, ImagePixelFormat::BC6HUnsignedFloat, false },
+        { 96U, ImagePixelFormat::BC6HSignedFloat, false },
+        { 98U, ImagePixelFormat::BC7, false },
+        { 99U, ImagePixelFormat::BC7, true }
+    };
+
+    for (const DXGIFormatEntry& entry : dxgiFormats)
+    {
+        if (entry.dxgiFormat == dxgiFormat)
+        {
+            *sRGB = entry.sRGB;
+            return entry.pixelFormat;
+        }
+    }
+    return ImagePixelFormat::Unknown;
+}
+
+// The DDS_PIXELFORMAT of files without the DX10 header
+static auto GetLegacyDDSPixelFormat(const uint8_t* pixelFormat, ImageEncoding* encoding) -> ImagePixelFormat
+{
+    const uint32_t flags = ReadU32(pixelFormat + 4);
+    const uint32_t fourCC = ReadU32(pixelFormat + 8);
+    const uint32_t bitCount = ReadU32(pixelFormat + 12);
+    const uint32_t redMask = ReadU32(pixelFormat + 16);
+    const uint32_t greenMask = ReadU32(pixelFormat + 20);
+    const uint32_t blueMask = ReadU32(pixelFormat + 24);
+    const uint32_t alphaMask = ReadU32(pixelFormat + 28);
+
+    *encoding = ImageEncoding::Direct;
+
+    if ((flags & DDS_PIXEL_FORMAT_FOURCC) != 0U)
+    {
+        switch (fourCC)
+        {
+        case MakeFourCC('D', 'X', 'T', '1'):
+            return ImagePixelFormat::BC1;
+        case MakeFourCC('D', 'X', 'T', '2'):
+        case MakeFourCC('D', 'X', 'T', '3'):
+            return ImagePixelFormat::BC2;
+        case MakeFourCC('D', 'X', 'T', '4'):
+        case MakeFourCC('D', 'X', 'T', '5'):
+            return ImagePixelFormat::BC3;
+        case MakeFourCC('A', 'T', 'I', '1'):
+        case MakeFourCC('B', 'C', '4', 'U'):
+            return ImagePixelFormat::BC4;
+        case MakeFourCC('A', 'T', 'I', '2'):
+        case MakeFourCC('B', 'C', '5', 'U'):
+            return ImagePixelFormat::BC5;
+        // D3DFORMAT values
+        case 36U:
+            return ImagePixelFormat::R16G16B16A16;
+        case 113U:
+            return ImagePixelFormat::R16G16B16A16Float;
+        case 116U:
+            return ImagePixelFormat::R32G32B32A32Float;
+        default:
+            return ImagePixelFormat::Unknown;
+        }
+    }
+
+    if ((flags & DDS_PIXEL_FORMAT_RGB) != 0U)
+    {
+        if (bitCount == 32U && redMask == 0x000000ffU && greenMask == 0x0000ff00U && blueMask == 0x00ff0000U && alphaMask == 0xff000000U) {
+            return ImagePixelFormat::R8G8B8A8;
+        }
+        if (bitCount == 32U && redMask == 0x00ff0000U && greenMask == 0x0000ff00U && blueMask == 0x000000ffU) {
+            return alphaMask == 0xff000000U ? ImagePixelFormat::B8G8R8A8 : ImagePixelFormat::B8G8R8X8;
+        }
+        if (bitCount == 24U && redMask == 0x00ff0000U && greenMask == 0x0000ff00U && blueMask == 0x000000ffU)
+        {
+            *encoding = ImageEncoding::BGR24;
+            return ImagePixelFormat::B8G8R8X8;
+        }
+        return ImagePixelFormat::Unknown;
+    }
+
+    if ((flags & DDS_PIXEL_FORMAT_LUMINANCE) != 0U && bitCount == 8U && redMask == 0xffU) {
+        return ImagePixelFormat::R8;
+    }
+
+    return ImagePixelFormat::Unknown;
+}
+
+static auto ParseDDSHeader(const uint8_t* data, size_t size, ImageInfo& info) -> bool
+{
+    if (size < DDS_HEADER_SIZE || ReadU32(data) != MakeFourCC('D', 'D', 'S', ' ') || ReadU32(data + 4) != 124U) return false;
+
+    const uint32_t flags = ReadU32(data + 8);
+    const uint32_t height = ReadU32(data + 12);
+    const uint32_t width = ReadU32(data + 16);
+    const uint32_t mipMapCount = ReadU32(data + 28);
+    const uint8_t* pixelFormat = data + 76;
+    const uint32_t caps2 = ReadU32(data + 112);
+    if ((caps2 & DDS_CAPS2_VOLUME) != 0U) return false;
+
+    info.fileFormat = ImageFileFormat::DDS;
+    info.width = width;
+    info.height = height;
+    info.mipLevelCount = (flags & DDS_FLAG_MIPMAPCOUNT) != 0U && mipMapCount > 0U ? mipMapCount : 1U;
+    info.bottomUp = false;
+
+    if ((ReadU32(pixelFormat + 4) & DDS_PIXEL_FORMAT_FOURCC) != 0U && ReadU32(pixelFormat + 8) == MakeFourCC('D', 'X', '1', '0'))
+    {
+        if (size < DDS_HEADER_SIZE + DDS_DX10_HEADER_SIZE) return false;
+
+        const uint8_t* dx10Header = data + DDS_HEADER_SIZE;
+        if (ReadU32(dx10Header + 4) != DDS_DIMENSION_TEXTURE2D) return false;
+
+        info.pixelFormat = GetDXGIPixelFormat(ReadU32(dx10Header), &info.sRGB);
+        info.encoding = ImageEncoding::Direct;
+        info.cubeMap = (ReadU32(dx10Header + 8) & DDS_MISC_TEXTURECUBE) != 0U;
+        info.arraySize = ReadU32(dx10Header + 12);
+        if (info.arraySize == 0U || info.arraySize > IMAGE_MAX_DIMENSION) return false;
+        if (info.cubeMap) {
+            info.arraySize *= 6U;
+        }
+        info.dataOffset = DDS_HEADER_SIZE + DDS_DX10_HEADER_SIZE;
+    }
+    else
+    {
+        info.pixelFormat = GetLegacyDDSPixelFormat(pixelFormat, &info.encoding);
+        info.sourcePixelSize = info.encoding == ImageEncoding::BGR24 ? 3U : 0U;
+        info.cubeMap = (caps2 & DDS_CAPS2_CUBEMAP) != 0U;
+        if (info.cubeMap && (caps2 & DDS_CAPS2_CUBEMAP_ALL_FACES) != DDS_CAPS2_CUBEMAP_ALL_FACES) return false;
+        info.arraySize = info.cubeMap ? 6U : 1U;
+        info.dataOffset = DDS_HEADER_SIZE;
+    }
+
+    if (info.pixelFormat == ImagePixelFormat::Unknown || width == 0U || height == 0U || width > IMAGE_MAX_DIMENSION || height > IMAGE_MAX_DIMENSION) return false;
+
+    // At most a full mip chain down to 1 x 1
+    uint32_t maxMipLevelCount = 1U;
+    while (((width | height) >> maxMipLevelCount) != 0U) {
+        ++maxMipLevelCount;
+    }
+    if (info.mipLevelCount > maxMipLevelCount) return false;
+
+    // The end of the last subresource
+    const ImageSourceRows lastRows = GetImageSourceRows(info, info.mipLevelCount - 1U, info.arraySize - 1U);
+    return lastRows.offset <= size && lastRows.rowPitch * lastRows.rowCount <= size - lastRows.offset;
+}
+
+auto ParseImageHeader(const uint8_t* data, size_t size, ImageInfo& info) -> bool
+{
+    info = ImageInfo{
+        .fileFormat = ImageFileFormat::Unknown,
+        .pixelFormat = ImagePixelFormat::Unknown,
+        .sRGB = false,
+        .width = 0U,
+        .height = 0U,
+        .mipLevelCount = 1U,
+        .arraySize = 1U,
+        .cubeMap = false,
+        .encoding = ImageEncoding::Direct,
+        .fileSize = size,
+        .dataOffset = 0U,
+        .sourceRowPitch = 0U,
+        .sourcePixelSize = 0U,
+        .bottomUp = false,
+        .paletteOffset = 0U,
+        .paletteSize = 0U
+    };
+    if (data == nullptr) return false;
+
+    bool parsed = false;
+    if (size >= 4U && ReadU32(data) == MakeFourCC('D', 'D', 'S', ' ')) {
+        parsed = ParseDDSHeader(data, size, info);
+    }
+    else if (size >= 2U && data[0] == 'B' && data[1] == 'M') {
+        parsed = ParseBMPHeader(data, size, info);
+    }
+    else {
+        parsed = ParseTGAHeader(data, size, info);
+    }
+
+    if (!parsed || info.width > IMAGE_MAX_DIMENSION || info.height > IMAGE_MAX_DIMENSION)
+    {
+        info.fileFormat = ImageFileFormat::Unknown;
+        info.pixelFormat = ImagePixelFormat::Unknown;
+        return false;
+    }
+    return true;
+}
+
+auto GetImageSubresourceRows(const ImageInfo& info, const uint8_t* data, uint32_t mipLevel, uint32_t arraySlice, ImageRowSpan& rows) -> bool
+{
+    if (info.encoding != ImageEncoding::Direct || mipLevel >= info.mipLevelCount || arraySlice >= info.arraySize) return false;
+
+    const ImageSourceRows sourceRows = GetImageSourceRows(info, mipLevel, arraySlice);
+    const uint8_t* firstStoredRow = data + sourceRows.offset;
+    rows = ImageRowSpan{
+        .firstRow = info.bottomUp ? firstStoredRow + sourceRows.rowPitch * (sourceRows.rowCount - 1U) : firstStoredRow,
+        .rowStride = info.bottomUp ? -ptrdiff_t(sourceRows.rowPitch) : ptrdiff_t(sourceRows.rowPitch),
+        .rowCount = sourceRows.rowCount,
+        .rowSize = GetImageSubresourceLayout(info, mipLevel).rowSize
+    };
+    return true;
+}
+
+static auto ExpandBGR24Row(const uint8_t* source, uint8_t* destination, uint32_t width) -> void
+{
+    for (uint32_t x = 0U; x < width; ++x)
+    {
+        destination[x * 4U] = source[x * 3U];
+        destination[x * 4U + 1U] = source[x * 3U + 1U];
+        destination[x * 4U + 2U] = source[x * 3U + 2U];
+        destination[x * 4U + 3U] = 0xffU;
+    }
+}
+
+// Out of range indices are black
+static auto ExpandPalette8Row(const uint8_t* source, const uint8_t* palette, uint32_t paletteSize, uint8_t* destination, uint32_t width) -> void
+{
+    for (uint32_t x = 0U; x < width; ++x)
+    {
+        const uint32_t index = source[x];
+        if (index < paletteSize)
+        {
+            destination[x * 4U] = palette[index * 4U];
+            destination[x * 4U + 1U] = palette[index * 4U + 1U];
+            destination[x * 4U + 2U] = palette[index * 4U + 2U];
+        }
+        else {
+            destination[x * 4U] = destination[x * 4U + 1U] = destination[x * 4U + 2U] = 0U;
+        }
+        destination[x * 4U + 3U] = 0xffU;
+    }
+}
+
+// Packets may cross rows. A packet header with the high bit set repeats the following pixel, otherwise that many raw pixels follow.
+static auto DecodeTGARunLength(const ImageInfo& info, const uint8_t* data, uint8_t* destination, size_t destinationRowPitch) -> bool
+{
+    const uint32_t pixelSize = info.sourcePixelSize;
+    const uint32_t outputSize = pixelSize == 1U ? 1U : 4U;
+    const uint8_t* source = data + info.dataOffset;
+    const uint8_t* const sourceEnd = data + info.fileSize;
+
+    uint32_t x = 0U, storedRow = 0U;
+    uint8_t* row = destination + destinationRowPitch * (info.bottomUp ? info.height - 1U : 0U);
+
+    auto const writePixel = [&](const uint8_t* pixel) {
+        uint8_t* out = row + size_t(x) * outputSize;
+        if (pixelSize == 1U) {
+            out[0] = pixel[0];
+        }
+        else
+        {
+            out[0] = pixel[0];
+            out[1] = pixel[1];
+            out[2] = pixel[2];
+            out[3] = pixelSize == 4U ? pixel[3] : 0xffU;
+        }
+
+        if (++x == info.width)
+        {
+            x = 0U;
+            if (++storedRow < info.height) {
+                row = destination + destinationRowPitch * (info.bottomUp ? info.height - 1U - storedRow : storedRow);
+            }
+        }
+    };
+
+    while (storedRow < info.height)
+    {
+        if (source >= sourceEnd) return false;
+        const uint32_t packetHeader = *source++;
+        const uint32_t count = (packetHeader & 0x7fU) + 1U;
+
+        if ((packetHeader & 0x80U) != 0U)
+        {
+            if (size_t(sourceEnd - source) < pixelSize) return false;
+            for (uint32_t i = 0U; i < count && storedRow < info.height; ++i) {
+                writePixel(source);
+            }
+            source += pixelSize;
+        }
+        else
+        {
+            if (size_t(sourceEnd - source) < size_t(count) * pixelSize) return false;
+            for (uint32_t i = 0U; i < count && storedRow < info.height; ++i) {
+                writePixel(source + size_t(i) * pixelSize);
+            }
+            source += size_t(count) * pixelSize;
+        }
+    }
+
+    return true;
+}
+
+auto DecodeImageSubresource(const ImageInfo& info, const uint8_t* data, uint32_t mipLevel, uint32_t arraySlice,
+                            void* destination, size_t destinationRowPitch) -> bool
+{
+    if (mipLevel >= info.mipLevelCount || arraySlice >= info.arraySize || info.pixelFormat == ImagePixelFormat::Unknown) return false;
+
+    const ImageSubresourceLayout layout = GetImageSubresourceLayout(info, mipLevel);
+    if (destinationRowPitch < layout.rowSize) return false;
+
+    uint8_t* const destinationRows = (uint8_t*)destination;
+    if (info.encoding == ImageEncoding::RunLength) return DecodeTGARunLength(info, data, destinationRows, destinationRowPitch);
+
+    const ImageSourceRows sourceRows = GetImageSourceRows(info, mipLevel, arraySlice);
+    for (uint32_t row = 0U; row < layout.rowCount; ++row)
+    {
+        const uint8_t* source = data + sourceRows.offset + sourceRows.rowPitch * (info.bottomUp ? layout.rowCount - 1U - row : row);
+        uint8_t* target = destinationRows + destinationRowPitch * row;
+
+        switch (info.encoding)
+        {
+        case ImageEncoding::Direct:
+            memcpy(target, source, layout.rowSize);
+            break;
+        case ImageEncoding::BGR24:
+            ExpandBGR24Row(source, target, layout.width);
+            break;
+        case ImageEncoding::Palette8:
+            ExpandPalette8Row(source, data + info.paletteOffset, info.paletteSize, target, layout.width);
+            break;
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto GetImageRGBA8Conversion(const ImageInfo& info, bool sRGBEncode, PixelConversion& conversion) -> bool
+{
+    switch (info.pixelFormat)
+    {
+    case ImagePixelFormat::R8G8B8A8:
+        conversion = PixelConversion::RGBA8ToRGBA8;
+        return true;
+
+    case ImagePixelFormat::B8G8R8A8:
+        conversion = PixelConversion::BGRA8ToRGBA8;
+        return true;
+
+    case ImagePixelFormat::B8G8R8X8:
+        // 24-bit pixels are converted straight from the file
+        conversion = info.encoding == ImageEncoding::BGR24 ? PixelConversion::BGR8ToRGBA8 : PixelConversion::BGRX8ToRGBA8;
+        return true;
+
+    case ImagePixelFormat::R16G16B16A16:
+        conversion = sRGBEncode ? PixelConversion::RGBA16ToSRGBA8 : PixelConversion::RGBA16ToRGBA8;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+auto ConvertImageSubresource(const ImageInfo& info, const uint8_t* data, uint32_t mipLevel, uint32_t arraySlice,
+                                PixelConversion conversion, const PixelConversionOptions& options, void* destination, size_t destinationRowPitch) -> bool
+{
+    if (mipLevel >= info.mipLevelCount || arraySlice >= info.arraySize) return false;
+
+    PixelConversion expectedConversion;
+    if (!GetImageRGBA8Conversion(info, conversion == PixelConversion::RGBA16ToSRGBA8, expectedConversion) || conversion != expectedConversion) return false;
+
+    const ImageSubresourceLayout layout = GetImageSubresourceLayout(info, mipLevel);
+    if (destinationRowPitch < size_t(layout.width) * 4U) return false;
+
+    // Run-length encoded pixels can only be decoded from the first packet on, so the whole image is decoded before it is converted
+    if (info.encoding == ImageEncoding::RunLength)
+    {
+        std::vector<uint8_t> decodedRows(layout.rowSize * layout.rowCount);
+        if (!DecodeTGARunLength(info, data, decodedRows.data(), layout.rowSize)) return false;
+
+        ConvertPixelRows(conversion, options, decodedRows.data(), ptrdiff_t(layout.rowSize), destination, destinationRowPitch, layout.width, layout.rowCount);
+        return true;
+    }
+
+    const ImageSourceRows sourceRows = GetImageSourceRows(info, mipLevel, arraySlice);
+    const uint8_t* firstStoredRow = data + sourceRows.offset;
+
+    if (info.encoding == ImageEncoding::Palette8)
+    {
+        std::vector<uint8_t> expandedRow(layout.rowSize);
+        for (uint32_t row = 0U; row < layout.rowCount; ++row)
+        {
+            const uint8_t* source = firstStoredRow + sourceRows.rowPitch * (info.bottomUp ? layout.rowCount - 1U - row : row);
+            ExpandPalette8Row(source, data + info.paletteOffset, info.paletteSize, expandedRow.data(), layout.width);
+            ConvertPixelRows(conversion, options, expandedRow.data(), 0, (uint8_t*)destination + destinationRowPitch * row, destinationRowPitch, layout.width, 1U);
+        }
+        return true;
+    }
+
+    const uint8_t* firstRow = info.bottomUp ? firstStoredRow + sourceRows.rowPitch * (layout.rowCount - 1U) : firstStoredRow;
+    const ptrdiff_t rowStride = info.bottomUp ? -ptrdiff_t(sourceRows.rowPitch) : ptrdiff_t(sourceRows.rowPitch);
+    ConvertPixelRows(conversion, options, firstRow, rowStride, destination, destinationRowPitch, layout.width, layout.rowCount);
+    return true;
+}
+
+auto MeasureImageDecodeThroughput(const ImageInfo& info, const uint8_t* data, uint32_t iterationCount) -> double
+{
+    size_t maxSubresourceSize = 0;
+    size_t decodedSize = 0;
+    for (uint32_t mip = 0U; mip < info.mipLevelCount; ++mip)
+    {
+        const ImageSubresourceLayout layout = GetImageSubresourceLayout(info, mip);
+        maxSubresourceSize = (std::max)(maxSubresourceSize, layout.rowSize * layout.rowCount);
+        decodedSize += layout.rowSize * layout.rowCount * info.arraySize;
+    }
+    if (decodedSize == 0U || iterationCount == 0U) return 0.0;
+
+    std::vector<uint8_t> destination(maxSubresourceSize);
+
+    const auto beginTime = std::chrono::steady_clock::now();
+    for (uint32_t iteration = 0U; iteration < iterationCount; ++iteration)
+    {
+        for (uint32_t slice = 0U; slice < info.arraySize; ++slice)
+        {
+            for (uint32_t mip = 0U; mip < info.mipLevelCount; ++mip)
+            {
+                if (!DecodeImageSubresource(info, data, mip, slice, destination.data(), GetImageSubresourceLayout(info, mip).rowSize)) return 0.0;
+            }
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - beginTime).count();
+
+    return seconds > 0.0 ? double(decodedSize) * double(iterationCount) / seconds / 1000000.0 : 0.0;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "PixelConversion.h"
+
+// Decoder for BMP, TGA and DDS image files that are already in memory, e.g. a memory-mapped file.
+// Parsing only reads the header. Subresources whose rows are stored in a GPU-compatible layout are exposed as spans
+// of rows inside the file without any copy; the other ones (24-bit, palette and run-length encoded pixels) are decoded
+// straight into caller-provided memory such as a mapped upload heap, one row pitch per row and top row first.
+// 8-bit BGR(A) and 16-bit images can also be converted to R8G8B8A8 on the way, with the kernels of PixelConversion.
+
+enum class ImageFileFormat
+{
+    Unknown,
+    BMP,
+    TGA,
+    DDS
+};
+
+// The layout of the decoded rows. Each format has a matching DXGI format.
+enum class ImagePixelFormat
+{
+    Unknown,
+    R8,
+    R8G8B8A8,
+    B8G8R8A8,
+    B8G8R8X8,
+    R16G16B16A16,
+    R16G16B16A16Float,
+    R32G32B32A32Float,
+    BC1,
+    BC2,
+    BC3,
+    BC4,
+    BC5,
+    BC6HUnsignedFloat,
+    BC6HSignedFloat,
+    BC7
+};
+
+// How the pixels are stored in the file
+enum class ImageEncoding
+{
+    Direct,             // the rows have the layout of the pixel format
+    BGR24,              // 3 bytes per pixel in BMP, TGA and DDS files, expanded to B8G8R8X8
+    Palette8,           // BMP palette indices, expanded to B8G8R8X8
+    RunLength           // TGA run-length encoded packets of 1, 3 or 4 byte pixels
+};
+
+struct ImageInfo
+{
+    ImageFileFormat fileFormat;
+    ImagePixelFormat pixelFormat;
+    bool sRGB;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipLevelCount;
+    uint32_t arraySize;         // 6 faces per cube
+    bool cubeMap;
+
+    // Layout of the pixel data in the file
+    ImageEncoding encoding;
+    size_t fileSize;
+    size_t dataOffset;          // of the first subresource
+    size_t sourceRowPitch;      // in bytes, of the single subresource of BMP and TGA files
+    uint32_t sourcePixelSize;   // in bytes, for BGR24, Palette8 and RunLength
+    bool bottomUp;              // the bottom row is stored first
+    size_t paletteOffset;       // BGRX entries of Palette8
+    uint32_t paletteSize;
+};
+
+// The rows of one subresource. For block-compressed formats a row is a row of 4 x 4 blocks.
+struct ImageSubresourceLayout
+{
+    uint32_t width;             // in pixels
+    uint32_t height;
+    uint32_t rowCount;
+    size_t rowSize;             // in bytes
+};
+
+// Rows inside the file, top row first. rowStride is negative for bottom-up files.
+struct ImageRowSpan
+{
+    const uint8_t* firstRow;
+    ptrdiff_t rowStride;
+    uint32_t rowCount;
+    size_t rowSize;
+};
+
+extern auto GetImagePixelFormatName(ImagePixelFormat pixelFormat) -> const char*;
+
+// @return the size of one pixel, or of one 4 x 4 block for block-compressed formats, in bytes. 0 for ImagePixelFormat::Unknown.
+extern auto GetImagePixelFormatElementSize(ImagePixelFormat pixelFormat) -> uint32_t;
+
+extern auto IsImagePixelFormatBlockCompressed(ImagePixelFormat pixelFormat) -> bool;
+
+// Supported: uncompressed 8-bit palette, 24-bit and 32-bit BMP files (BI_RGB and BI_BITFIELDS with byte masks),
+// uncompressed and run-length encoded 8-bit grayscale, 24-bit and 32-bit TGA files,
+// and 2D, array and cube DDS textures with mip levels in the formats of ImagePixelFormat, with or without the DX10 header.
+// All the subresources that are read in place are checked against the file size.
+// @return false if the file is not a supported image
+extern auto ParseImageHeader(const uint8_t* data, size_t size, ImageInfo& info) -> bool;
+
+extern auto GetImageSubresourceLayout(const ImageInfo& info, uint32_t mipLevel) -> ImageSubresourceLayout;
+
+// @return false if the subresource does not exist or has to be decoded because info.encoding is not ImageEncoding::Direct
+extern auto GetImageSubresourceRows(const ImageInfo& info, const uint8_t* data, uint32_t mipLevel, uint32_t arraySlice, ImageRowSpan& rows) -> bool;
+
+// Writes the rows of one subresource top row first, destinationRowPitch bytes apart.
+// @param destinationRowPitch at least GetImageSubresourceLayout(info, mipLevel).rowSize
+// @return false if the subresource does not exist or the encoded data is truncated
+extern auto DecodeImageSubresource(const ImageInfo& info, const uint8_t* data, uint32_t mipLevel, uint32_t arraySlice,
+                                    void* destination, size_t destinationRowPitch) -> bool;
+
+// The conversion of the decoded pixels of info to R8G8B8A8
+// @param sRGBEncode encode R16G16B16A16 images with the sRGB transfer function, which keeps more of their precision in 8 bits than a linear conversion
+// @return false for R8, float and block-compressed pixel formats
+extern auto GetImageRGBA8Conversion(const ImageInfo& info, bool sRGBEncode, PixelConversion& conversion) -> bool;
+
+// Like DecodeImageSubresource(), but the pixels are converted to R8G8B8A8 by conversion, which must come from GetImageRGBA8Conversion().
+// Rows stored in the file as 24-bit, 32-bit or 16-bit per channel pixels are read, flipped and converted in one pass.
+// Palette and run-length encoded pixels are expanded into a temporary buffer first.
+// @param destinationRowPitch at least GetImageSubresourceLayout(info, mipLevel).width * 4
+extern auto ConvertImageSubresource(const ImageInfo& info, const uint8_t* data, uint32_t mipLevel, uint32_t arraySlice,
+                                    PixelConversion conversion, const PixelConversionOptions& options, void* destination, size_t destinationRowPitch) -> bool;
+
+// Decodes every subresource iterationCount times into tightly packed rows
+// @return decoded megabytes (10^6 bytes) per second
+extern auto MeasureImageDecodeThroughput(const ImageInfo& info, const uint8_t* data, uint32_t iterationCount) -> double;
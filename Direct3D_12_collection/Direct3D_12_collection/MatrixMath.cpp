@@ -0,0 +1,233 @@
+#include "MatrixMath.h"
+
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define MATRIX_MATH_USE_SSE     1
+#else
+#define MATRIX_MATH_USE_SSE     0
+#endif
+
+static auto Dot3(const float a[3], const float b[3]) -> float
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static auto Cross3(const float a[3], const float b[3], float out[3]) -> void
+{
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static auto Normalize3(float v[3]) -> void
+{
+    const float length = std::sqrt(Dot3(v, v));
+    if (length > 0.0f)
+    {
+        v[0] /= length;
+        v[1] /= length;
+        v[2] /= length;
+    }
+}
+
+auto GetIdentityMatrix() -> Matrix4x4
+{
+    return Matrix4x4{ .m {
+        { 1.0f, 0.0f, 0.0f, 0.0f },
+        { 0.0f, 1.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 1.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f }
+    } };
+}
+
+// Both paths compute ((v[0] * m[0][c] + v[1] * m[1][c]) + v[2] * m[2][c]) + v[3] * m[3][c] for the output component c
+auto TransformVector(const float v[4], const Matrix4x4& m, float out[4]) -> void
+{
+#if MATRIX_MATH_USE_SSE
+    __m128 sum = _mm_mul_ps(_mm_set1_ps(v[0]), _mm_load_ps(m.m[0]));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(v[1]), _mm_load_ps(m.m[1])));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(v[2]), _mm_load_ps(m.m[2])));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(v[3]), _mm_load_ps(m.m[3])));
+    _mm_storeu_ps(out, sum);
+#else
+    const float x = v[0], y = v[1], z = v[2], w = v[3];
+    for (int c = 0; c < 4; ++c) {
+        out[c] = x * m.m[0][c] + y * m.m[1][c] + z * m.m[2][c] + w * m.m[3][c];
+    }
+#endif
+}
+
+auto MultiplyMatrix4x4(const Matrix4x4& a, const Matrix4x4& b) -> Matrix4x4
+{
+    // Each row of the product is the row of a transformed by b
+    Matrix4x4 result;
+    for (int row = 0; row < 4; ++row) {
+        TransformVector(a.m[row], b, result.m[row]);
+    }
+    return result;
+}
+
+auto TransposeMatrix4x4(const Matrix4x4& m) -> Matrix4x4
+{
+    Matrix4x4 result;
+#if MATRIX_MATH_USE_SSE
+    __m128 row0 = _mm_load_ps(m.m[0]);
+    __m128 row1 = _mm_load_ps(m.m[1]);
+    __m128 row2 = _mm_load_ps(m.m[2]);
+    __m128 row3 = _mm_load_ps(m.m[3]);
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+    _mm_store_ps(result.m[0], row0);
+    _mm_store_ps(result.m[1], row1);
+    _mm_store_ps(result.m[2], row2);
+    _mm_store_ps(result.m[3], row3);
+#else
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column) {
+            result.m[row][column] = m.m[column][row];
+        }
+    }
+#endif
+    return result;
+}
+
+auto GetTranslationMatrix(float x, float y, float z) -> Matrix4x4
+{
+    Matrix4x4 result = GetIdentityMatrix();
+    result.m[3][0] = x;
+    result.m[3][1] = y;
+    result.m[3][2] = z;
+    return result;
+}
+
+auto GetScaleMatrix(float x, float y, float z) -> Matrix4x4
+{
+    Matrix4x4 result = GetIdentityMatrix();
+    result.m[0][0] = x;
+    result.m[1][1] = y;
+    result.m[2][2] = z;
+    return result;
+}
+
+auto GetQuaternionFromAxisAngle(const float axis[3], float angle) -> Quaternion
+{
+    float normalizedAxis[3] = { axis[0], axis[1], axis[2] };
+    Normalize3(normalizedAxis);
+
+    // radians(angle) / 2
+    const float halfRadian = angle * (3.14159265358979323846f / 360.0f);
+    const float s = std::sin(halfRadian);
+
+    return Quaternion{
+        .x = normalizedAxis[0] * s,
+        .y = normalizedAxis[1] * s,
+        .z = normalizedAxis[2] * s,
+        .w = std::cos(halfRadian)
+    };
+}
+
+auto MultiplyQuaternions(const Quaternion& a, const Quaternion& b) -> Quaternion
+{
+    return Quaternion{
+        .x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        .y = a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        .z = a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        .w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+    };
+}
+
+auto NormalizeQuaternion(const Quaternion& q) -> Quaternion
+{
+    const float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    if (length == 0.0f) return Quaternion{ .x = 0.0f, .y = 0.0f, .z = 0.0f, .w = 1.0f };
+
+    return Quaternion{ .x = q.x / length, .y = q.y / length, .z = q.z / length, .w = q.w / length };
+}
+
+// The transpose of the column vector rotation matrix, which matches glRotate for the quaternion of GetQuaternionFromAxisAngle
+auto GetRotationMatrix(const Quaternion& q) -> Matrix4x4
+{
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    return Matrix4x4{ .m {
+        { 1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f },     // row 0
+        { 2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f },     // row 1
+        { 2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f },     // row 2
+        { 0.0f, 0.0f, 0.0f, 1.0f }                                                 // row 3
+    } };
+}
+
+auto GetLookAtMatrix(const float eye[3], const float target[3], const float up[3]) -> Matrix4x4
+{
+    float forward[3] = { target[0] - eye[0], target[1] - eye[1], target[2] - eye[2] };
+    Normalize3(forward);
+
+    float side[3];
+    Cross3(forward, up, side);
+    Normalize3(side);
+
+    float cameraUp[3];
+    Cross3(side, forward, cameraUp);
+
+    // The camera axes are the columns, and the eye is moved to the origin
+    return Matrix4x4{ .m {
+        { side[0], cameraUp[0], -forward[0], 0.0f },                            // row 0
+        { side[1], cameraUp[1], -forward[1], 0.0f },                            // row 1
+        { side[2], cameraUp[2], -forward[2], 0.0f },                            // row 2
+        { -Dot3(side, eye), -Dot3(cameraUp, eye), Dot3(forward, eye), 1.0f }    // row 3
+    } };
+}
+
+auto GetOrthoMatrix(float left, float right, float bottom, float top, float zNear, float zFar) -> Matrix4x4
+{
+    return Matrix4x4{ .m {
+        { 2.0f / (right - left), 0.0f, 0.0f, 0.0f },
+        { 0.0f, 2.0f / (top - bottom), 0.0f, 0.0f },
+        { 0.0f, 0.0f, -2.0f / (zFar - zNear), 0.0f },
+        { -(right + left) / (right - left), -(top + bottom) / (top - bottom), -(zFar + zNear) / (zFar - zNear), 1.0f }
+    } };
+}
+
+auto GetFrustumMatrix(float left, float right, float bottom, float top, float zNear, float zFar) -> Matrix4x4
+{
+    return Matrix4x4{ .m {
+        { 2.0f * zNear / (right - left), 0.0f, 0.0f, 0.0f },
+        { 0.0f, 2.0f * zNear / (top - bottom), 0.0f, 0.0f },
+        { (right + left) / (right - left), (top + bottom) / (top - bottom), -(zFar + zNear) / (zFar - zNear), -1.0f },
+        { 0.0f, 0.0f, -2.0f * zFar * zNear / (zFar - zNear), 0.0f }
+    } };
+}
+
+auto GetReversedZOrthoMatrix(float left, float right, float bottom, float top, float zNear, float zFar) -> Matrix4x4
+{
+    Matrix4x4 result = GetOrthoMatrix(left, right, bottom, top, zNear, zFar);
+
+    // z' = (z + zFar) / (zFar - zNear)
+    result.m[2][2] = 1.0f / (zFar - zNear);
+    result.m[3][2] = zFar / (zFar - zNear);
+    return result;
+}
+
+auto GetReversedZFrustumMatrix(float left, float right, float bottom, float top, float zNear, float zFar) -> Matrix4x4
+{
+    Matrix4x4 result = GetFrustumMatrix(left, right, bottom, top, zNear, zFar);
+
+    // z' = (zNear * z + zFar * zNear) / (zFar - zNear), w' = -z
+    result.m[2][2] = zNear / (zFar - zNear);
+    result.m[3][2] = zFar * zNear / (zFar - zNear);
+    return result;
+}
+
+auto GetReversedZInfiniteFrustumMatrix(float left, float right, float bottom, float top, float zNear) -> Matrix4x4
+{
+    // The depth is zNear / -z
+    Matrix4x4 result = GetFrustumMatrix(left, right, bottom, top, zNear, 2.0f * zNear);
+    result.m[2][2] = 0.0f;
+    result.m[3][2] = zNear;
+    return result;
+}
+
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+// Small 4x4 matrix and quaternion library for computing transforms on the CPU.
+// Matrices are row-major and transform row vectors, like mul(float4, row_major float4x4) in HLSL,
+// so a Matrix4x4 can be copied into a constant buffer member declared as row_major float4x4 as it is.
+// The products are computed with SSE when the compiler targets it, with the same operation order as the scalar fallback.
+
+struct alignas(16) Matrix4x4
+{
+    float m[4][4];
+};
+
+// x, y, z is the vector part and w is the scalar part
+struct Quaternion
+{
+    float x, y, z, w;
+};
+
+extern auto GetIdentityMatrix() -> Matrix4x4;
+
+// @return a * b, i.e. mul(a, b) of HLSL. Transforming by the result transforms by a first and then by b.
+extern auto MultiplyMatrix4x4(const Matrix4x4& a, const Matrix4x4& b) -> Matrix4x4;
+
+// out = mul(v, m) of HLSL. v and out may be the same array.
+extern auto TransformVector(const float v[4], const Matrix4x4& m, float out[4]) -> void;
+
+extern auto TransposeMatrix4x4(const Matrix4x4& m) -> Matrix4x4;
+
+// glTranslate(x, y, z)
+extern auto GetTranslationMatrix(float x, float y, float z) -> Matrix4x4;
+
+// glScale(x, y, z)
+extern auto GetScaleMatrix(float x, float y, float z) -> Matrix4x4;
+
+// @param axis need not be normalized
+// @param angle in degrees, counter-clockwise when looking from the positive axis towards the origin, like glRotate
+extern auto GetQuaternionFromAxisAngle(const float axis[3], float angle) -> Quaternion;
+
+// @return the rotation by b followed by the rotation by a, i.e. the Hamilton product a * b
+extern auto MultiplyQuaternions(const Quaternion& a, const Quaternion& b) -> Quaternion;
+
+extern auto NormalizeQuaternion(const Quaternion& q) -> Quaternion;
+
+// @param q must be normalized
+extern auto GetRotationMatrix(const Quaternion& q) -> Matrix4x4;
+
+// gluLookAt(eye, target, up). The camera looks down its negative z axis.
+extern auto GetLookAtMatrix(const float eye[3], const float target[3], const float up[3]) -> Matrix4x4;
+
+// glOrtho(left, right, bottom, top, zNear, zFar). The clip space z of the view volume is [-w, w].
+extern auto GetOrthoMatrix(float left, float right, float bottom, float top, float zNear, float zFar) -> Matrix4x4;
+
+// glFrustum(left, right, bottom, top, zNear, zFar). The clip space z of the view volume is [-w, w].
+extern auto GetFrustumMatrix(float left, float right, float bottom, float top, float zNear, float zFar) -> Matrix4x4;
+
+// Reversed-Z variants of the Direct3D [0, w] clip space z: zNear is mapped to 1 and zFar to 0, which spreads the float depth
+// precision evenly over the distance. They must be used with a depth buffer cleared to 0 and D3D12_COMPARISON_FUNC_GREATER.
+extern auto GetReversedZOrthoMatrix(float left, float right, float bottom, float top, float zNear, float zFar) -> Matrix4x4;
+
+extern auto GetReversedZFrustumMatrix(float left, float right, float bottom, float top, float zNear, float zFar) -> Matrix4x4;
+
+// The limit of GetReversedZFrustumMatrix as zFar goes to infinity
+extern auto GetReversedZInfiniteFrustumMatrix(float left, float right, float bottom, float top, float zNear) -> Matrix4x4;
+
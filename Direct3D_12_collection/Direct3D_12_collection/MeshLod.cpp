@@ -0,0 +1,385 @@
+#include "MeshLod.h"
+
+#include <cmath>
+#include <algorithm>
+
+// A pass collapses the cheapest edges whose vertices have not been touched by another collapse of the same pass,
+// so the adjacency is only rebuilt once per pass. Meshes that need more passes than this are not simplified further.
+static constexpr uint32_t MESH_LOD_MAX_PASS_COUNT = 64U;
+
+// Collapses that turn the normal of a remaining triangle by more than about 75 degrees are rejected
+static constexpr double MESH_LOD_MIN_NORMAL_COSINE = 0.25;
+
+// Symmetric 4x4 matrix of the sum of the squared distances to the planes of the triangles around a vertex,
+// weighted by the areas of the triangles
+struct MeshLodQuadric
+{
+    double a00, a01, a02, a11, a12, a22;
+    double b0, b1, b2;
+    double c;
+    double weight;
+};
+
+struct MeshLodCollapse
+{
+    double cost;
+    uint32_t from;
+    uint32_t to;
+};
+
+static auto AddQuadric(MeshLodQuadric& q, const MeshLodQuadric& other) -> void
+{
+    q.a00 += other.a00; q.a01 += other.a01; q.a02 += other.a02;
+    q.a11 += other.a11; q.a12 += other.a12; q.a22 += other.a22;
+    q.b0 += other.b0; q.b1 += other.b1; q.b2 += other.b2;
+    q.c += other.c;
+    q.weight += other.weight;
+}
+
+// @return the mean squared distance of the point to the planes of the quadric
+static auto EvaluateQuadric(const MeshLodQuadric& q, const double p[3]) -> double
+{
+    if (q.weight <= 0.0) return 0.0;
+
+    const double x = p[0], y = p[1], z = p[2];
+    const double distanceSquared = q.a00 * x * x + q.a11 * y * y + q.a22 * z * z + 2.0 * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z) +
+                                    2.0 * (q.b0 * x + q.b1 * y + q.b2 * z) + q.c;
+    return std::max(distanceSquared, 0.0) / q.weight;
+}
+
+static auto CrossTriangle(const double p0[3], const double p1[3], const double p2[3], double normal[3]) -> void
+{
+    const double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+    const double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+    normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+// Incident triangles of every vertex in compressed rows
+struct MeshLodAdjacency
+{
+    std::vector<uint32_t> offsets;      // vertexCount + 1
+    std::vector<uint32_t> triangles;
+};
+
+static auto BuildAdjacency(const std::vector<uint32_t>& indices, uint32_t vertexCount, MeshLodAdjacency& adjacency) -> void
+{
+    adjacency.offsets.assign(size_t(vertexCount) + 1U, 0U);
+    for (const uint32_t index : indices) {
+        ++adjacency.offsets[index + 1U];
+    }
+    for (uint32_t vertex = 0U; vertex < vertexCount; ++vertex) {
+        adjacency.offsets[vertex + 1U] += adjacency.offsets[vertex];
+    }
+
+    adjacency.triangles.resize(indices.size());
+    std::vector<uint32_t> cursors(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        adjacency.triangles[cursors[indices[i]]++] = uint32_t(i / 3U);
+    }
+}
+
+// A vertex is on an open edge when the edges leaving it in its triangles are not exactly the reverse of the edges arriving at it.
+// This also catches non-manifold vertices.
+static auto FindOpenEdgeVertices(const std::vector<uint32_t>& indices, const MeshLodAdjacency& adjacency, uint32_t vertexCount) -> std::vector<uint8_t>
+{
+    std::vector<uint8_t> locked(vertexCount, 0U);
+    std::vector<uint32_t> outgoing, incoming;
+    for (uint32_t vertex = 0U; vertex < vertexCount; ++vertex)
+    {
+        outgoing.clear();
+        incoming.clear();
+        for (uint32_t i = adjacency.offsets[vertex]; i < adjacency.offsets[vertex + 1U]; ++i)
+        {
+            const uint32_t* triangle = &indices[size_t(adjacency.triangles[i]) * 3U];
+            const uint32_t corner = triangle[0] == vertex ? 0U : (triangle[1] == vertex ? 1U : 2U);
+            outgoing.push_back(triangle[(corner + 1U) % 3U]);
+            incoming.push_back(triangle[(corner + 2U) % 3U]);
+        }
+
+        std::sort(outgoing.begin(), outgoing.end());
+        std::sort(incoming.begin(), incoming.end());
+        locked[vertex] = outgoing != incoming || std::adjacent_find(outgoing.begin(), outgoing.end()) != outgoing.end() ? 1U : 0U;
+    }
+    return locked;
+}
+
+class MeshLodSimplifier
+{
+public:
+
+    MeshLodSimplifier(const MeshletSourceMesh& mesh) :
+        m_vertexCount(mesh.vertexCount),
+        m_positions(size_t(mesh.vertexCount) * 3U),
+        m_indices(mesh.indices, mesh.indices + mesh.indexCount),
+        m_quadrics(mesh.vertexCount, MeshLodQuadric{ }),
+        m_touched(mesh.vertexCount, 0U),
+        m_maxError(0.0)
+    {
+        for (uint32_t vertex = 0U; vertex < m_vertexCount; ++vertex)
+        {
+            const float* position = (const float*)((const uint8_t*)mesh.positions + size_t(vertex) * mesh.positionStride);
+            for (uint32_t i = 0U; i < 3U; ++i) {
+                m_positions[size_t(vertex) * 3U + i] = double(position[i]);
+            }
+        }
+
+        for (size_t i = 0; i + 2U < m_indices.size(); i += 3U)
+        {
+            double normal[3];
+            CrossTriangle(Position(m_indices[i]), Position(m_indices[i + 1U]), Position(m_indices[i + 2U]), normal);
+            const double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            if (length <= 0.0) continue;
+
+            const double area = length * 0.5;
+            const double n[3] = { normal[0] / length, normal[1] / length, normal[2] / length };
+            const double* p0 = Position(m_indices[i]);
+            const double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+            const MeshLodQuadric plane{
+                .a00 = area * n[0] * n[0], .a01 = area * n[0] * n[1], .a02 = area * n[0] * n[2],
+                .a11 = area * n[1] * n[1], .a12 = area * n[1] * n[2], .a22 = area * n[2] * n[2],
+                .b0 = area * n[0] * d, .b1 = area * n[1] * d, .b2 = area * n[2] * d,
+                .c = area * d * d,
+                .weight = area
+            };
+            for (size_t corner = 0; corner < 3U; ++corner) {
+                AddQuadric(m_quadrics[m_indices[i + corner]], plane);
+            }
+        }
+
+        MeshLodAdjacency adjacency;
+        BuildAdjacency(m_indices, m_vertexCount, adjacency);
+        m_locked = FindOpenEdgeVertices(m_indices, adjacency, m_vertexCount);
+    }
+
+    // Simplifies the current triangles down to at most targetTriangleCount, or as far as possible
+    auto Simplify(size_t targetTriangleCount) -> void
+    {
+        for (uint32_t pass = 0U; pass < MESH_LOD_MAX_PASS_COUNT && m_indices.size() / 3U > targetTriangleCount; ++pass)
+        {
+            BuildAdjacency(m_indices, m_vertexCount, m_adjacency);
+            if (!CollapseEdges(targetTriangleCount)) break;
+        }
+    }
+
+    auto GetIndices() const -> const std::vector<uint32_t>& { return m_indices; }
+
+    auto GetMaxError() const -> double { return m_maxError; }
+
+private:
+
+    auto Position(uint32_t vertex) const -> const double* { return &m_positions[size_t(vertex) * 3U]; }
+
+    auto Triangle(uint32_t triangle) -> uint32_t* { return &m_indices[size_t(triangle) * 3U]; }
+
+    auto GetCollapseCost(uint32_t from, uint32_t to) const -> double
+    {
+        MeshLodQuadric q = m_quadrics[from];
+        AddQuadric(q, m_quadrics[to]);
+        return EvaluateQuadric(q, Position(to));
+    }
+
+    // Collapsing must neither pinch the surface (the two vertices share exactly the third vertices of the triangles of their edge)
+    // nor flip or fold a triangle around from
+    auto CanCollapse(uint32_t from, uint32_t to) -> bool
+    {
+        m_fromNeighbors.clear();
+        m_toNeighbors.clear();
+        uint32_t edgeTriangleCount = 0U;
+        for (uint32_t i = m_adjacency.offsets[from]; i < m_adjacency.offsets[from + 1U]; ++i)
+        {
+            const uint32_t* triangle = Triangle(m_adjacency.triangles[i]);
+            const uint32_t corner = triangle[0] == from ? 0U : (triangle[1] == from ? 1U : 2U);
+            const uint32_t next = triangle[(corner + 1U) % 3U];
+            const uint32_t previous = triangle[(corner + 2U) % 3U];
+            m_fromNeighbors.insert(m_fromNeighbors.end(), { next, previous });
+
+            if (next == to || previous == to)
+            {
+                ++edgeTriangleCount;
+                continue;
+            }
+
+            double oldNormal[3], newNormal[3];
+            CrossTriangle(Position(from), Position(next), Position(previous), oldNormal);
+            CrossTriangle(Position(to), Position(next), Position(previous), newNormal);
+            const double dot = oldNormal[0] * newNormal[0] + oldNormal[1] * newNormal[1] + oldNormal[2] * newNormal[2];
+            const double oldLengthSquared = oldNormal[0] * oldNormal[0] + oldNormal[1] * oldNormal[1] + oldNormal[2] * oldNormal[2];
+            const double newLengthSquared = newNormal[0] * newNormal[0] + newNormal[1] * newNormal[1] + newNormal[2] * newNormal[2];
+            if (oldLengthSquared > 0.0 && dot <= MESH_LOD_MIN_NORMAL_COSINE * std::sqrt(oldLengthSquared * newLengthSquared)) return false;
+        }
+
+        for (uint32_t i = m_adjacency.offsets[to]; i < m_adjacency.offsets[to + 1U]; ++i)
+        {
+            const uint32_t* triangle = Triangle(m_adjacency.triangles[i]);
+            for (uint32_t corner = 0U; corner < 3U; ++corner)
+            {
+                if (triangle[corner] != to) {
+                    m_toNeighbors.push_back(triangle[corner]);
+                }
+            }
+        }
+
+        std::sort(m_fromNeighbors.begin(), m_fromNeighbors.end());
+        m_fromNeighbors.erase(std::unique(m_fromNeighbors.begin(), m_fromNeighbors.end()), m_fromNeighbors.end());
+        std::sort(m_toNeighbors.begin(), m_toNeighbors.end());
+        m_toNeighbors.erase(std::unique(m_toNeighbors.begin(), m_toNeighbors.end()), m_toNeighbors.end());
+
+        uint32_t sharedNeighborCount = 0U;
+        for (auto a = m_fromNeighbors.begin(), b = m_toNeighbors.begin(); a != m_fromNeighbors.end() && b != m_toNeighbors.end(); )
+        {
+            if (*a < *b) ++a;
+            else if (*b < *a) ++b;
+            else
+            {
+                ++sharedNeighborCount;
+                ++a;
+                ++b;
+            }
+        }
+
+        return edgeTriangleCount > 0U && sharedNeighborCount == edgeTriangleCount;
+    }
+
+    // @return false if no edge could be collapsed
+    auto CollapseEdges(size_t targetTriangleCount) -> bool
+    {
+        m_collapses.clear();
+        for (size_t i = 0; i < m_indices.size(); ++i)
+        {
+            // Every edge of a closed mesh is visited twice, once in each direction
+            const uint32_t a = m_indices[i];
+            const uint32_t b = m_indices[i % 3U == 2U ? i - 2U : i + 1U];
+            if (a > b || (m_locked[a] != 0U && m_locked[b] != 0U)) continue;
+
+            const double costAB = m_locked[a] != 0U ? HUGE_VAL : GetCollapseCost(a, b);
+            const double costBA = m_locked[b] != 0U ? HUGE_VAL : GetCollapseCost(b, a);
+            m_collapses.push_back(costAB <= costBA ? MeshLodCollapse{ costAB, a, b } : MeshLodCollapse{ costBA, b, a });
+        }
+
+        // Each collapse removes two triangles
+        const size_t triangleCount = m_indices.size() / 3U;
+        const size_t wantedCollapseCount = std::min((triangleCount - targetTriangleCount + 1U) / 2U, m_collapses.size());
+        if (wantedCollapseCount == 0U) return false;
+
+        std::sort(m_collapses.begin(), m_collapses.end(), [](const MeshLodCollapse& x, const MeshLodCollapse& y) { return x.cost < y.cost; });
+
+        std::fill(m_touched.begin(), m_touched.end(), uint8_t(0U));
+        size_t removedTriangleCount = 0;
+        size_t collapseCount = 0;
+        for (const MeshLodCollapse& collapse : m_collapses)
+        {
+            if (triangleCount - removedTriangleCount <= targetTriangleCount) break;
+            if (m_touched[collapse.from] != 0U || m_touched[collapse.to] != 0U) continue;
+            if (!CanCollapse(collapse.from, collapse.to)) continue;
+
+            // The triangles around from are rewritten, so the collapses of their vertices have to wait for the next pass
+            for (uint32_t i = m_adjacency.offsets[collapse.from]; i < m_adjacency.offsets[collapse.from + 1U]; ++i)
+            {
+                uint32_t* triangle = Triangle(m_adjacency.triangles[i]);
+                for (uint32_t corner = 0U; corner < 3U; ++corner) {
+                    m_touched[triangle[corner]] = 1U;
+                }
+
+                const bool degenerate = triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to;
+                for (uint32_t corner = 0U; corner < 3U; ++corner)
+                {
+                    if (triangle[corner] == collapse.from) {
+                        triangle[corner] = collapse.to;
+                    }
+                }
+                if (degenerate) {
+                    ++removedTriangleCount;
+                }
+            }
+
+            AddQuadric(m_quadrics[collapse.to], m_quadrics[collapse.from]);
+            m_maxError = std::max(m_maxError, collapse.cost);
+            ++collapseCount;
+        }
+
+        // Remove the triangles that lost a vertex, keeping the order of the others for the post-transform vertex cache
+        size_t writeIndex = 0;
+        for (size_t i = 0; i < m_indices.size(); i += 3U)
+        {
+            const uint32_t i0 = m_indices[i], i1 = m_indices[i + 1U], i2 = m_indices[i + 2U];
+            if (i0 == i1 || i1 == i2 || i0 == i2) continue;
+
+            m_indices[writeIndex++] = i0;
+            m_indices[writeIndex++] = i1;
+            m_indices[writeIndex++] = i2;
+        }
+        m_indices.resize(writeIndex);
+
+        return collapseCount > 0U;
+    }
+
+    uint32_t m_vertexCount;
+    std::vector<double> m_positions;
+    std::vector<uint32_t> m_indices;
+    std::vector<MeshLodQuadric> m_quadrics;
+    std::vector<uint8_t> m_locked;
+    std::vector<uint8_t> m_touched;
+    MeshLodAdjacency m_adjacency;
+    std::vector<MeshLodCollapse> m_collapses;
+    std::vector<uint32_t> m_fromNeighbors;
+    std::vector<uint32_t> m_toNeighbors;
+    double m_maxError;      // squared
+};
+
+auto BuildMeshLodChain(const MeshletSourceMesh& mesh, uint32_t lodCount, float reductionRatio) -> MeshLodChain
+{
+    MeshLodChain chain;
+    if (lodCount == 0U || mesh.indexCount < 3U) return chain;
+
+    const uint32_t indexCount = mesh.indexCount - mesh.indexCount % 3U;
+    chain.indices.assign(mesh.indices, mesh.indices + indexCount);
+    chain.lods.push_back(MeshLod{ .indexOffset = 0U, .indexCount = indexCount, .geometricError = 0.0f });
+    if (lodCount == 1U || !(reductionRatio > 0.0f && reductionRatio < 1.0f)) return chain;
+
+    MeshLodSimplifier simplifier(MeshletSourceMesh{
+        .positions = mesh.positions,
+        .positionStride = mesh.positionStride,
+        .vertexCount = mesh.vertexCount,
+        .indices = mesh.indices,
+        .indexCount = indexCount
+    });
+
+    while (chain.lods.size() < lodCount)
+    {
+        const size_t previousTriangleCount = chain.lods.back().indexCount / 3U;
+        simplifier.Simplify(size_t(double(previousTriangleCount) * double(reductionRatio)));
+
+        const std::vector<uint32_t>& indices = simplifier.GetIndices();
+        if (double(indices.size() / 3U) > double(previousTriangleCount) * (1.0 - double(MESH_LOD_MIN_REDUCTION)) || indices.empty()) break;
+
+        // The errors only grow, so a coarser level never has a smaller error than a finer one
+        chain.lods.push_back(MeshLod{
+            .indexOffset = uint32_t(chain.indices.size()),
+            .indexCount = uint32_t(indices.size()),
+            .geometricError = float(std::sqrt(simplifier.GetMaxError()))
+        });
+        chain.indices.insert(chain.indices.end(), indices.begin(), indices.end());
+    }
+
+    return chain;
+}
+
+auto GetMeshLodScreenSpaceError(float geometricError, float distance, float projectionScale, float viewportHeight) -> float
+{
+    // Half the viewport height covers distance / projectionScale in object space
+    if (distance <= 0.0f) return HUGE_VALF;
+    return geometricError * projectionScale * viewportHeight * 0.5f / distance;
+}
+
+auto SelectMeshLod(const MeshLodChain& chain, float distance, float projectionScale, float viewportHeight, float maxPixelError) -> uint32_t
+{
+    uint32_t selected = 0U;
+    for (uint32_t lod = 1U; lod < uint32_t(chain.lods.size()); ++lod)
+    {
+        if (GetMeshLodScreenSpaceError(chain.lods[lod].geometricError, distance, projectionScale, viewportHeight) > maxPixelError) break;
+        selected = lod;
+    }
+    return selected;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Meshlet.h"
+
+// Discrete levels of detail of indexed triangle meshes, generated at load time by quadric error metric simplification.
+// The simplification only collapses edges onto existing vertices, so every level of detail is an index range into one
+// shared index buffer over the unchanged vertex buffer of the source mesh, and one DrawIndexedInstanced() per level
+// (or one indirect draw argument per level) renders it.
+// Vertices on open edges, including the duplicated vertices of texture seams, never move, so the levels have no cracks.
+
+// No more levels of detail are generated when a level removes fewer than this fraction of the triangles of the previous one
+static constexpr float MESH_LOD_MIN_REDUCTION = 0.05f;
+
+struct MeshLod
+{
+    uint32_t indexOffset;       // first element in MeshLodChain::indices
+    uint32_t indexCount;
+    float geometricError;       // estimated distance between this level and the source mesh, in object space units
+};
+
+struct MeshLodChain
+{
+    std::vector<uint32_t> indices;      // triangle lists of all the levels, indices into the vertices of the source mesh
+    std::vector<MeshLod> lods;          // lods[0] is the source mesh with a geometric error of 0
+};
+
+// Every level keeps about reductionRatio of the triangles of the previous one.
+// The chain holds fewer than lodCount levels when the mesh can not be simplified any further.
+// @param reductionRatio in (0, 1)
+extern auto BuildMeshLodChain(const MeshletSourceMesh& mesh, uint32_t lodCount, float reductionRatio) -> MeshLodChain;
+
+// @param projectionScale the cotangent of half the vertical field of view, i.e. m[1][1] of a perspective projection matrix
+// @return the height in pixels of an object space error at distance from the camera
+extern auto GetMeshLodScreenSpaceError(float geometricError, float distance, float projectionScale, float viewportHeight) -> float;
+
+// The coarsest level whose error covers at most maxPixelError pixels.
+// @param distance from the camera to the object, divided by the uniform scale of the instance
+// @return an index into chain.lods
+extern auto SelectMeshLod(const MeshLodChain& chain, float distance, float projectionScale, float viewportHeight, float maxPixelError) -> uint32_t;
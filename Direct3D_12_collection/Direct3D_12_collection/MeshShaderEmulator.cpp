@@ -0,0 +1,123 @@
+#include "MeshShaderEmulator.h"
+
+#include <algorithm>
+#include <atomic>
+
+auto SetMeshEmulatorOutputCounts(MeshEmulatorGroupOutput& output, uint32_t vertexCount, uint32_t primitiveCount) -> void
+{
+    output.vertexCount = vertexCount;
+    output.primitiveCount = primitiveCount;
+    output.vertices.assign(size_t(vertexCount) * output.vertexAttributeCount * 4U, 0.0f);
+    output.indices.assign(size_t(primitiveCount) * 3U, 0U);
+    output.primitiveAttributes.assign(size_t(primitiveCount) * output.primitiveAttributeCount, 0U);
+}
+
+static auto IsValidDispatchMeshArgs(const uint32_t args[3]) -> bool
+{
+    if (args[0] > MESH_EMULATOR_MAX_DISPATCH_COUNT_PER_DIMENSION || args[1] > MESH_EMULATOR_MAX_DISPATCH_COUNT_PER_DIMENSION ||
+        args[2] > MESH_EMULATOR_MAX_DISPATCH_COUNT_PER_DIMENSION) return false;
+
+    return uint64_t(args[0]) * args[1] * args[2] <= MESH_EMULATOR_MAX_DISPATCH_GROUP_COUNT;
+}
+
+static auto IsValidMeshGroupOutput(const MeshEmulatorGroupOutput& output) -> bool
+{
+    if (output.vertexCount > MESH_EMULATOR_MAX_VERTEX_COUNT || output.primitiveCount > MESH_EMULATOR_MAX_PRIMITIVE_COUNT) return false;
+
+    for (const uint32_t index : output.indices)
+    {
+        if (index >= output.vertexCount) return false;
+    }
+    return true;
+}
+
+auto EmulateDispatchMesh(const MeshEmulatorPipelineDesc& desc, ThreadPool* threadPool, uint32_t x, uint32_t y, uint32_t z) -> MeshEmulatorResult
+{
+    MeshEmulatorResult result{ };
+    std::atomic<uint32_t> errorCount = 0U;
+
+    const bool hasAmplificationShader = bool(desc.amplificationShader);
+    const uint32_t dispatchArgs[3] = { x, y, z };
+    if (!IsValidDispatchMeshArgs(dispatchArgs) || (hasAmplificationShader && desc.payloadSize > MESH_EMULATOR_MAX_PAYLOAD_SIZE))
+    {
+        result.errorCount = 1U;
+        return result;
+    }
+
+    // Amplification stage: one payload and one set of DispatchMesh() arguments per group.
+    // Without an amplification shader, a single virtual group dispatches the mesh groups directly.
+    result.amplificationGroupCount = hasAmplificationShader ? x * y * z : 1U;
+    const size_t payloadSize = hasAmplificationShader ? desc.payloadSize : 0U;
+
+    std::vector<uint8_t> payloads(payloadSize * result.amplificationGroupCount);
+    std::vector<uint32_t> meshGroupCounts(result.amplificationGroupCount);
+    std::vector<uint32_t> meshDispatchArgs(size_t(result.amplificationGroupCount) * 3U);
+
+    if (hasAmplificationShader)
+    {
+        ThreadPoolParallelFor(threadPool, result.amplificationGroupCount, [&](uint32_t groupIndex) {
+            const uint32_t groupID[3] = { groupIndex % x, groupIndex / x % y, groupIndex / (x * y) };
+            uint32_t* args = &meshDispatchArgs[size_t(groupIndex) * 3U];
+
+            desc.amplificationShader(groupID, &payloads[payloadSize * groupIndex], args);
+
+            if (!IsValidDispatchMeshArgs(args))
+            {
+                ++errorCount;
+                args[0] = args[1] = args[2] = 0U;
+            }
+            meshGroupCounts[groupIndex] = args[0] * args[1] * args[2];
+        });
+    }
+    else
+    {
+        std::copy(dispatchArgs, dispatchArgs + 3, meshDispatchArgs.begin());
+        meshGroupCounts[0] = x * y * z;
+    }
+
+    // Mesh group ranges of the amplification groups keep the rasterization order
+    std::vector<uint32_t> meshGroupOffsets(size_t(result.amplificationGroupCount) + 1U, 0U);
+    for (uint32_t i = 0U; i < result.amplificationGroupCount; ++i) {
+        meshGroupOffsets[i + 1U] = meshGroupOffsets[i] + meshGroupCounts[i];
+    }
+
+    const uint32_t meshGroupCount = meshGroupOffsets.back();
+    result.meshGroups.resize(meshGroupCount);
+    result.payloadBytes = uint64_t(payloadSize) * meshGroupCount;
+
+    // Mesh stage
+    ThreadPoolParallelFor(threadPool, meshGroupCount, [&](uint32_t meshGroupIndex) {
+        const uint32_t amplificationGroupIndex = uint32_t(std::upper_bound(meshGroupOffsets.begin(), meshGroupOffsets.end(), meshGroupIndex) - meshGroupOffsets.begin()) - 1U;
+        const uint32_t* args = &meshDispatchArgs[size_t(amplificationGroupIndex) * 3U];
+        const uint32_t localIndex = meshGroupIndex - meshGroupOffsets[amplificationGroupIndex];
+
+        MeshEmulatorGroupOutput& output = result.meshGroups[meshGroupIndex];
+        output.amplificationGroupIndex = amplificationGroupIndex;
+        output.groupID[0] = localIndex % args[0];
+        output.groupID[1] = localIndex / args[0] % args[1];
+        output.groupID[2] = localIndex / (args[0] * args[1]);
+        output.vertexAttributeCount = desc.vertexAttributeCount;
+        output.primitiveAttributeCount = desc.primitiveAttributeCount;
+
+        const void* payload = hasAmplificationShader ? &payloads[payloadSize * amplificationGroupIndex] : nullptr;
+        desc.meshShader(output.groupID, payload, output);
+
+        if (!IsValidMeshGroupOutput(output))
+        {
+            ++errorCount;
+            SetMeshEmulatorOutputCounts(output, 0U, 0U);
+        }
+    });
+
+    for (const MeshEmulatorGroupOutput& output : result.meshGroups)
+    {
+        result.vertexCount += output.vertexCount;
+        result.primitiveCount += output.primitiveCount;
+        result.vertexOutputBytes += output.vertices.size() * sizeof(float);
+        result.indexOutputBytes += output.indices.size() * sizeof(uint32_t);
+        result.primitiveOutputBytes += output.primitiveAttributes.size() * sizeof(uint32_t);
+    }
+
+    result.errorCount = errorCount;
+    return result;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "ThreadPool.h"
+
+// CPU execution model of the amplification shader -> payload -> mesh shader pipeline.
+// Shaders are C++ ports that run one whole thread group per call, so a port loops over SV_GroupThreadID itself
+// and places GroupMemoryBarrierWithGroupSync() between its loops. Amplification groups run in parallel,
+// then all mesh groups run in parallel, and the outputs are kept in the order in which the GPU rasterizes them.
+// The meshlet logic can be validated with it without mesh shader hardware.
+
+// Limits of the D3D12 mesh shader specification
+static constexpr uint32_t MESH_EMULATOR_MAX_VERTEX_COUNT = 256U;
+static constexpr uint32_t MESH_EMULATOR_MAX_PRIMITIVE_COUNT = 256U;
+static constexpr uint32_t MESH_EMULATOR_MAX_PAYLOAD_SIZE = 16384U;
+static constexpr uint32_t MESH_EMULATOR_MAX_DISPATCH_COUNT_PER_DIMENSION = 65535U;
+static constexpr uint32_t MESH_EMULATOR_MAX_DISPATCH_GROUP_COUNT = 1U << 22;
+
+// Output of one mesh shader group
+struct MeshEmulatorGroupOutput
+{
+    uint32_t amplificationGroupIndex;   // the amplification group that launched this group, 0 without an amplification shader
+    uint32_t groupID[3];                // SV_GroupID of the mesh shader
+
+    // Set by the emulator before the mesh shader runs
+    uint32_t vertexAttributeCount;      // float4 attributes per vertex, the first one is SV_Position
+    uint32_t primitiveAttributeCount;   // uint attributes per primitive, e.g. SV_ShadingRate, SV_CullPrimitive
+
+    // Set by SetMeshEmulatorOutputCounts
+    uint32_t vertexCount;
+    uint32_t primitiveCount;
+    std::vector<float> vertices;                // [vertexCount][vertexAttributeCount][4]
+    std::vector<uint32_t> indices;              // [primitiveCount][3], triangle topology
+    std::vector<uint32_t> primitiveAttributes;  // [primitiveCount][primitiveAttributeCount]
+};
+
+struct MeshEmulatorPipelineDesc
+{
+    uint32_t payloadSize;               // in bytes, not used without an amplification shader
+    uint32_t vertexAttributeCount;
+    uint32_t primitiveAttributeCount;
+
+    // One amplification shader group: fills the payload and stores the DispatchMesh() arguments.
+    // An empty function means that the pipeline has no amplification shader.
+    std::function<void(const uint32_t groupID[3], void* payload, uint32_t dispatchMeshArgs[3])> amplificationShader;
+
+    // One mesh shader group. payload is nullptr without an amplification shader.
+    std::function<void(const uint32_t groupID[3], const void* payload, MeshEmulatorGroupOutput& output)> meshShader;
+};
+
+struct MeshEmulatorResult
+{
+    uint32_t amplificationGroupCount;
+
+    // Mesh groups in rasterization order: amplification groups in linear group order,
+    // then the mesh groups of each DispatchMesh() in linear group order (x first)
+    std::vector<MeshEmulatorGroupOutput> meshGroups;
+
+    uint64_t payloadBytes;              // payloads passed from amplification groups to mesh groups
+    uint64_t vertexCount;
+    uint64_t primitiveCount;
+    uint64_t vertexOutputBytes;
+    uint64_t indexOutputBytes;
+    uint64_t primitiveOutputBytes;
+
+    // Violations of the limits above and out-of-range vertex indices. The offending groups produce no output.
+    uint32_t errorCount;
+};
+
+// The equivalent of SetMeshOutputCounts(). It must be called once per mesh group before writing the outputs.
+extern auto SetMeshEmulatorOutputCounts(MeshEmulatorGroupOutput& output, uint32_t vertexCount, uint32_t primitiveCount) -> void;
+
+// The equivalent of DispatchMesh(x, y, z) on the command list. x, y, z count amplification groups when the pipeline has
+// an amplification shader and mesh groups otherwise. threadPool may be nullptr to run everything on the calling thread.
+extern auto EmulateDispatchMesh(const MeshEmulatorPipelineDesc& desc, ThreadPool* threadPool, uint32_t x, uint32_t y, uint32_t z) -> MeshEmulatorResult;
+
+// C++ port of ms.amplification.hlsl and ms.mesh.hlsl (MeshShaderTest.cpp).
+// Vertex attributes: SV_Position, COLOR. Primitive attributes: SV_ShadingRate.
+extern auto CreateAmplificationMeshShaderPort() -> MeshEmulatorPipelineDesc;
+
+// C++ port of simple_ms.mesh.hlsl (MeshShaderNoRasterTest.cpp). It has no outputs but writes
+// 4 MyVertexType elements (float4 position, float4 color) per group into uavOutput.
+extern auto CreateSimpleMeshShaderPort(float* uavOutput) -> MeshEmulatorPipelineDesc;
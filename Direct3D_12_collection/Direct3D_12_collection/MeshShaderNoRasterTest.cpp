@@ -1,4 +1,8 @@
 #include "common.h"
+#include "MeshShaderEmulator.h"
+
+// Run the C++ ports of the mesh shader pipelines on the CPU and compare them with the GPU output
+#define VALIDATE_WITH_MESH_SHADER_EMULATOR  1
 
 struct MyVertexType
 {
@@ -246,6 +250,35 @@ static auto CreateUAVBuffer(ID3D12Device* d3d_device) -> std::tuple<ID3D12Resour
     return result;
 }
 
+#if VALIDATE_WITH_MESH_SHADER_EMULATOR
+// The simple_ms.mesh.hlsl port is compared with the GPU readback. The ms.amplification.hlsl and ms.mesh.hlsl port
+// only reports its payload and output sizes, since its outputs are consumed by the rasterizer on the GPU.
+static auto ValidateWithMeshShaderEmulator(const float* gpuOutput) -> void
+{
+    ThreadPool* threadPool = CreateThreadPool(0U);
+
+    // 4 groups write 16 elements, but the UAV only holds the first 4, so the GPU drops the other writes.
+    float emulatedOutput[16U * 8U]{ };
+    const MeshEmulatorResult simpleResult = EmulateDispatchMesh(CreateSimpleMeshShaderPort(emulatedOutput), threadPool, 4U, 1U, 1U);
+    const bool matched = simpleResult.errorCount == 0U && memcmp(emulatedOutput, gpuOutput, sizeof(MyVertexType) * 4U) == 0;
+    printf("Mesh shader emulator output %s the GPU output\n", matched ? "matches" : "DOES NOT match");
+
+    LARGE_INTEGER frequency{ }, beginTime{ }, endTime{ };
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&beginTime);
+    const MeshEmulatorResult result = EmulateDispatchMesh(CreateAmplificationMeshShaderPort(), threadPool, 1U, 1U, 1U);
+    QueryPerformanceCounter(&endTime);
+
+    printf("Emulated amplification and mesh shaders on %u threads in %.3f ms: %u amplification groups, %u mesh groups, %llu vertices, %llu primitives, %u errors\n",
+            GetThreadPoolThreadCount(threadPool), double(endTime.QuadPart - beginTime.QuadPart) * 1000.0 / double(frequency.QuadPart),
+            result.amplificationGroupCount, UINT(result.meshGroups.size()), result.vertexCount, result.primitiveCount, result.errorCount);
+    printf("    payload: %llu bytes, vertex output: %llu bytes, index output: %llu bytes, primitive output: %llu bytes\n",
+            result.payloadBytes, result.vertexOutputBytes, result.indexOutputBytes, result.primitiveOutputBytes);
+
+    DestroyThreadPool(threadPool);
+}
+#endif
+
 static auto PopulateMeshShaderCommandBundleList(ID3D12RootSignature *rootSignature, ID3D12CommandQueue *commandQueue,
                                             ID3D12GraphicsCommandList *commandList, ID3D12GraphicsCommandList6 *commandBundleList,
                                             ID3D12Resource* uavBuffer, ID3D12Resource* hostReadbackBuffer) -> bool
@@ -306,6 +339,10 @@ static auto PopulateMeshShaderCommandBundleList(ID3D12RootSignature *rootSignatu
             v0, v1, v2, v3, c0, c1, c2, c3);
     }
 
+#if VALIDATE_WITH_MESH_SHADER_EMULATOR
+    ValidateWithMeshShaderEmulator(hostMemPtr);
+#endif
+
     hostReadbackBuffer->Unmap(0, nullptr);
 
     return true;
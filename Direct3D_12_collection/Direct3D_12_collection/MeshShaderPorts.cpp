@@ -0,0 +1,198 @@
+#include "MeshShaderEmulator.h"
+
+#include <cmath>
+#include <algorithm>
+
+// C++ ports of the mesh shader pipelines in the shaders folder for MeshShaderEmulator.
+// Every port keeps the statements of its shader in the same order, with SV_GroupThreadID as the loop variable.
+
+static constexpr uint32_t MESH_SHADER_PORT_THREAD_COUNT = 128U;     // [numthreads(128, 1, 1)]
+
+// Row vector times row-major matrix, like mul(float4, float4x4) in HLSL
+static auto MultiplyVectorMatrix(const float v[4], const float m[4][4], float out[4]) -> void
+{
+    for (int column = 0; column < 4; ++column) {
+        out[column] = v[0] * m[0][column] + v[1] * m[1][column] + v[2] * m[2][column] + v[3] * m[3][column];
+    }
+}
+
+static auto MultiplyMatrices(const float a[4][4], const float b[4][4], float out[4][4]) -> void
+{
+    for (int row = 0; row < 4; ++row) {
+        MultiplyVectorMatrix(a[row], b, out[row]);
+    }
+}
+
+static auto HLSLFrac(float x) -> float
+{
+    return x - std::floor(x);
+}
+
+// The same layout as MyPayloadType in ms.amplification.hlsl and ms.mesh.hlsl
+struct MyPayloadType
+{
+    int data[1024];
+    uint32_t meshID;
+    uint32_t meshGroupSize;
+};
+
+// ms.amplification.hlsl. Only the active `if (true)` branch is ported.
+static auto AmplificationMain(const uint32_t groupID[3], void* payloadMemory, uint32_t dispatchMeshArgs[3]) -> void
+{
+    MyPayloadType& payload = *(MyPayloadType*)payloadMemory;
+    const int baseData = int(groupID[0] * groupID[1] * groupID[2]);
+
+    for (int i = 0; i < 1024; ++i) {
+        payload.data[i] = baseData + i;
+    }
+    payload.meshID = groupID[0];
+    payload.meshGroupSize = 4;      // launch 4 mesh shader groups
+
+    dispatchMeshArgs[0] = payload.meshGroupSize;
+    dispatchMeshArgs[1] = 1U;
+    dispatchMeshArgs[2] = 1U;
+}
+
+// ms.mesh.hlsl
+static auto MeshMain(const uint32_t groupID[3], const void* payloadMemory, MeshEmulatorGroupOutput& output) -> void
+{
+    const MyPayloadType& inPayload = *(const MyPayloadType*)payloadMemory;
+
+    // We're going to generate 256 vertices and 254 triangles (127 differential rectangles)
+    SetMeshEmulatorOutputCounts(output, 256U, 254U);
+
+    const float edgeLength = 0.5f;
+    const float baseCoord = edgeLength * 0.5f;
+    const float dx = edgeLength / 127.0f;
+
+    const float xOffsetList[4] = { -0.5f, 0.5f, -0.5f, 0.5f };
+    const float yOffsetList[4] = { 0.5f, 0.5f, -0.5f, -0.5f };
+
+    // glTranslate(xOffset, yOffset, -2.3, 1.0)
+    const float translateMatrix[4][4] = {
+        { 1.0f, 0.0f, 0.0f, 0.0f },     // row 0
+        { 0.0f, 1.0f, 0.0f, 0.0f },     // row 1
+        { 0.0f, 0.0f, 1.0f, 0.0f },     // row 2
+        { xOffsetList[groupID[0]], yOffsetList[groupID[0]], -2.3f, 1.0f }   // row 3
+    };
+
+    // glOrtho(-1.0, 1.0, -1.0, 1.0, 1.0, 3.0)
+    const float projectionMatrix[4][4] = {
+        { 1.0f, 0.0f, 0.0f, 0.0f },     // row 0
+        { 0.0f, 1.0f, 0.0f, 0.0f },     // row 1
+        { 0.0f, 0.0f, -1.0f, 0.0f },    // row 2
+        { 0.0f, 0.0f, -2.0f, 1.0f }     // row 3
+    };
+
+    float mvpMatrix[4][4];
+    MultiplyMatrices(translateMatrix, projectionMatrix, mvpMatrix);
+
+    // One vertex occupies 2 float4 attributes: SV_Position, COLOR
+    auto const vertexAttribute = [&output](uint32_t vertexIndex, uint32_t attributeIndex) -> float* {
+        return &output.vertices[(size_t(vertexIndex) * output.vertexAttributeCount + attributeIndex) * 4U];
+    };
+
+    for (uint32_t localTID = 0U; localTID < MESH_SHADER_PORT_THREAD_COUNT; ++localTID)
+    {
+        // podPattern == 0
+        const float x = -baseCoord + dx * float(localTID);
+
+        const float vert0[4] = { x, -baseCoord, 0.0f, 1.0f };
+        const float vert1[4] = { x, baseCoord, 0.0f, 1.0f };
+
+        // Each work item generates 2 vertices
+        MultiplyVectorMatrix(vert0, mvpMatrix, vertexAttribute(localTID * 2U + 0U, 0U));
+        MultiplyVectorMatrix(vert1, mvpMatrix, vertexAttribute(localTID * 2U + 1U, 0U));
+
+        float c0 = float(inPayload.data[groupID[0] * 256 + localTID]) / 256.0f;
+        float c1 = float(inPayload.data[groupID[0] * 256 + 128 + localTID]) / 256.0f;
+
+        c0 = HLSLFrac(c0);
+        float rc0 = 1.0f - c0;
+        c1 = HLSLFrac(c1);
+        float rc1 = 1.0f - c1;
+
+        c0 = std::clamp(c0, 0.1f, 0.9f);
+        rc0 = std::clamp(rc0, 0.1f, 0.9f);
+        c1 = std::clamp(c1, 0.1f, 0.9f);
+        rc1 = std::clamp(rc1, 0.1f, 0.9f);
+
+        float* color0 = vertexAttribute(localTID * 2U + 0U, 1U);
+        float* color1 = vertexAttribute(localTID * 2U + 1U, 1U);
+        color0[0] = c0; color0[1] = c0; color0[2] = rc0; color0[3] = 1.0f;
+        color1[0] = c1; color1[1] = c1; color1[2] = rc1; color1[3] = 1.0f;
+
+        // Assemble the primitive
+        if (localTID >= 127) continue;
+
+        // Each work item assembles 2 primitives (2 triangles compose 1 rectangle)
+        const uint32_t v0 = localTID * 2;
+        const uint32_t v1 = v0 + 1U;
+        const uint32_t v2 = v0 + 2U;
+        const uint32_t v3 = v0 + 3U;
+
+        uint32_t* primIndices = &output.indices[size_t(localTID) * 2U * 3U];
+        primIndices[0] = v0; primIndices[1] = v1; primIndices[2] = v2;
+        primIndices[3] = v2; primIndices[4] = v1; primIndices[5] = v3;
+
+        // D3D12_SHADING_RATE_1X1. Each vertex in a primitve should have the same shading rate size
+        output.primitiveAttributes[localTID * 2U + 0U] = 0U;
+        output.primitiveAttributes[localTID * 2U + 1U] = 0U;
+    }
+}
+
+auto CreateAmplificationMeshShaderPort() -> MeshEmulatorPipelineDesc
+{
+    return MeshEmulatorPipelineDesc{
+        .payloadSize = uint32_t(sizeof(MyPayloadType)),
+        .vertexAttributeCount = 2U,
+        .primitiveAttributeCount = 1U,
+        .amplificationShader = AmplificationMain,
+        .meshShader = MeshMain
+    };
+}
+
+// simple_ms.mesh.hlsl
+static auto SimpleMeshMain(const uint32_t groupID[3], float* uavOutput, MeshEmulatorGroupOutput& output) -> void
+{
+    // We're going to generate 4 vertices and 2 triangles
+    SetMeshEmulatorOutputCounts(output, 4U, 2U);
+
+    const float xOffsetList[4] = { -0.5f, 0.5f, -0.5f, 0.5f };
+    const float yOffsetList[4] = { 0.5f, 0.5f, -0.5f, -0.5f };
+
+    const float vertCoords[4][4] = {
+        { -0.5f + xOffsetList[groupID[0]], -0.5f + yOffsetList[groupID[0]], 0.0f, 1.0f },
+        { -0.5f + xOffsetList[groupID[0]], 0.5f + yOffsetList[groupID[0]], 0.0f, 1.0f },
+        { 0.5f + xOffsetList[groupID[0]], -0.5f + yOffsetList[groupID[0]], 0.0f, 1.0f },
+        { 0.5f + xOffsetList[groupID[0]], 0.5f + yOffsetList[groupID[0]], 0.0f, 1.0f }
+    };
+
+    const float colors[4][4] = {
+        { 1.0f, 0.0f, 0.0f, 1.0f },
+        { 0.0f, 1.0f, 0.0f, 1.0f },
+        { 0.0f, 0.0f, 1.0f, 1.0f },
+        { 1.0f, 1.0f, 0.0f, 1.0f }
+    };
+
+    // Every thread of the group writes the same values, so writing them once is equivalent
+    const uint32_t index = groupID[0] * 4U;
+    for (uint32_t i = 0U; i < 4U; ++i)
+    {
+        std::copy(vertCoords[i], vertCoords[i] + 4, &uavOutput[(index + i) * 8U + 0U]);
+        std::copy(colors[i], colors[i] + 4, &uavOutput[(index + i) * 8U + 4U]);
+    }
+}
+
+auto CreateSimpleMeshShaderPort(float* uavOutput) -> MeshEmulatorPipelineDesc
+{
+    return MeshEmulatorPipelineDesc{
+        .payloadSize = 0U,
+        .vertexAttributeCount = 0U,
+        .primitiveAttributeCount = 0U,
+        .amplificationShader = { },
+        .meshShader = [uavOutput](const uint32_t groupID[3], const void*, MeshEmulatorGroupOutput& output) {
+            SimpleMeshMain(groupID, uavOutput, output);
+        }
+    };
+}
@@ -1,4 +1,1724 @@
 #include "common.h"
+#include "Meshlet.h"
+#include "MeshLod.h"
+
+// Build the meshlets of the test meshes and report their vertex reuse
+#define BUILD_TEST_MESHLETS     1
+
+// Render a grid of meshlet meshes through the culling amplification shader (requires BUILD_TEST_MESHLETS)
+#define TEST_MESHLET_CULLING    1
+
+// Render one mesh through the input assembler, amplification + mesh shader and indirect DispatchMesh pipelines
+// and compare their GPU time, triangle throughput and CPU recording cost (requires TEST_MESHLET_CULLING)
+#define RUN_GEOMETRY_PIPELINE_BENCHMARK 1
+
+// Render a grid of tori reaching the far plane with one level of detail per instance, selected by its screen-space error,
+// and compare the GPU time with rendering every instance in full detail (requires RUN_GEOMETRY_PIPELINE_BENCHMARK)
+#define RUN_LOD_BENCHMARK       1
+
+// 64 vertices and 126 primitives keep the meshlets small enough for fine-grained culling,
+// well inside the 256 / 254 limits of ms.mesh.hlsl
+static constexpr uint32_t TEST_MESHLET_MAX_VERTEX_COUNT = 64U;
+static constexpr uint32_t TEST_MESHLET_MAX_PRIMITIVE_COUNT = 126U;
+
+// Must be the same as MESHLET_CULLING_GROUP_SIZE in meshlet_cull.amplification.hlsl and meshlet.mesh.hlsl
+static constexpr UINT MESHLET_CULLING_GROUP_SIZE = 32U;
+static constexpr UINT MESHLET_CULLING_TARGET_SIZE = WINDOW_WIDTH;
+static constexpr UINT MESHLET_CULLING_MESH_INDEX = 2U;         // the torus
+static constexpr UINT MESHLET_CULLING_GRID_SIZE = 8U;           // 8 x 8 instances
+static constexpr float MESHLET_CULLING_NEAR_PLANE = 0.5f;
+static constexpr float MESHLET_CULLING_FAR_PLANE = 50.0f;
+
+static constexpr UINT GEOMETRY_BENCHMARK_TRIANGLE_COUNT = 1U << 17;  // per instance, rounded up to a full grid
+static constexpr UINT GEOMETRY_BENCHMARK_INSTANCE_COUNT = 64U;
+static constexpr UINT GEOMETRY_BENCHMARK_ITERATION_COUNT = 16U;      // draws per pipeline
+
+static constexpr uint32_t LOD_BENCHMARK_LOD_COUNT = 6U;
+static constexpr float LOD_BENCHMARK_REDUCTION_RATIO = 0.25f;
+static constexpr float LOD_BENCHMARK_MAX_PIXEL_ERROR = 1.0f;
+static constexpr UINT LOD_BENCHMARK_GRID_SIZE = 16U;                // 16 x 16 instances
+static constexpr UINT LOD_BENCHMARK_ITERATION_COUNT = 16U;          // draws per pass
+
+struct MeshletTestMesh
+{
+    const char* name;
+    std::vector<float> positions;   // xyz
+    std::vector<uint32_t> indices;  // triangle list, outward normals
+};
+
+// The circle of ExecuteIndirectTest as a triangle fan, a UV sphere and a torus
+static auto CreateMeshletTestMeshes() -> std::vector<MeshletTestMesh>
+{
+    std::vector<MeshletTestMesh> meshes(3);
+
+    MeshletTestMesh& circle = meshes[0];
+    circle.name = "circle";
+    circle.positions = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 360; ++i)
+    {
+        const double angle = double(i) * M_PI / 180.0;
+        circle.positions.insert(circle.positions.end(), { 0.25f * (float)cos(angle), 0.25f * (float)sin(angle), 0.0f });
+    }
+    for (uint32_t i = 0U; i < 360U; ++i) {
+        circle.indices.insert(circle.indices.end(), { 0U, 1U + i, 1U + (i + 1U) % 360U });
+    }
+
+    constexpr uint32_t sphereSegments = 256U;
+    constexpr uint32_t sphereRings = 128U;
+    MeshletTestMesh& sphere = meshes[1];
+    sphere.name = "sphere";
+    for (uint32_t ring = 0U; ring <= sphereRings; ++ring)
+    {
+        for (uint32_t segment = 0U; segment <= sphereSegments; ++segment)
+        {
+            const double theta = M_PI * double(ring) / double(sphereRings);
+            const double phi = 2.0 * M_PI * double(segment) / double(sphereSegments);
+            sphere.positions.insert(sphere.positions.end(), { float(sin(theta) * cos(phi)), float(cos(theta)), float(sin(theta) * sin(phi)) });
+        }
+    }
+    for (uint32_t ring = 0U; ring < sphereRings; ++ring)
+    {
+        for (uint32_t segment = 0U; segment < sphereSegments; ++segment)
+        {
+            const uint32_t v0 = ring * (sphereSegments + 1U) + segment;
+            const uint32_t v1 = v0 + sphereSegments + 1U;
+            sphere.indices.insert(sphere.indices.end(), { v0, v0 + 1U, v1, v0 + 1U, v1 + 1U, v1 });
+        }
+    }
+
+    constexpr uint32_t torusSegments = 384U;
+    constexpr uint32_t torusSides = 96U;
+    MeshletTestMesh& torus = meshes[2];
+    torus.name = "torus";
+    for (uint32_t segment = 0U; segment < torusSegments; ++segment)
+    {
+        for (uint32_t side = 0U; side < torusSides; ++side)
+        {
+            const double u = 2.0 * M_PI * double(segment) / double(torusSegments);
+            const double v = 2.0 * M_PI * double(side) / double(torusSides);
+            const double r = 0.75 + 0.25 * cos(v);
+            torus.positions.insert(torus.positions.end(), { float(r * cos(u)), float(0.25 * sin(v)), float(r * sin(u)) });
+        }
+    }
+    for (uint32_t segment = 0U; segment < torusSegments; ++segment)
+    {
+        for (uint32_t side = 0U; side < torusSides; ++side)
+        {
+            const uint32_t v0 = segment * torusSides + side;
+            const uint32_t v1 = segment * torusSides + (side + 1U) % torusSides;
+            const uint32_t v2 = (segment + 1U) % torusSegments * torusSides + side;
+            const uint32_t v3 = (segment + 1U) % torusSegments * torusSides + (side + 1U) % torusSides;
+            torus.indices.insert(torus.indices.end(), { v0, v1, v2, v1, v3, v2 });
+        }
+    }
+
+    return meshes;
+}
+
+#if BUILD_TEST_MESHLETS
+static auto BuildTestMeshlets(const std::vector<MeshletTestMesh>& testMeshes) -> std::vector<MeshletMesh>
+{
+    std::vector<MeshletSourceMesh> sourceMeshes;
+    for (const MeshletTestMesh& mesh : testMeshes)
+    {
+        sourceMeshes.push_back(MeshletSourceMesh{
+            .positions = mesh.positions.data(),
+            .positionStride = uint32_t(sizeof(float) * 3U),
+            .vertexCount = uint32_t(mesh.positions.size() / 3U),
+            .indices = mesh.indices.data(),
+            .indexCount = uint32_t(mesh.indices.size())
+        });
+    }
+
+    ThreadPool* threadPool = CreateThreadPool(0U);
+
+    LARGE_INTEGER frequency{ }, beginTime{ }, endTime{ };
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&beginTime);
+    const std::vector<MeshletMesh> meshletMeshes = BuildMeshletMeshes(sourceMeshes, threadPool, TEST_MESHLET_MAX_VERTEX_COUNT, TEST_MESHLET_MAX_PRIMITIVE_COUNT);
+    QueryPerformanceCounter(&endTime);
+
+    printf("Built the meshlets of %zu meshes on %u threads in %.3f ms\n", meshletMeshes.size(), GetThreadPoolThreadCount(threadPool),
+            double(endTime.QuadPart - beginTime.QuadPart) * 1000.0 / double(frequency.QuadPart));
+
+    DestroyThreadPool(threadPool);
+
+    size_t totalPrimitiveCount = 0, totalVertexCount = 0;
+    for (size_t i = 0; i < meshletMeshes.size(); ++i)
+    {
+        const MeshletMesh& meshletMesh = meshletMeshes[i];
+        const std::vector<uint8_t> serialized = SerializeMeshletMesh(meshletMesh);
+
+        MeshletMesh deserialized{ };
+        const bool roundTrip = DeserializeMeshletMesh(serialized.data(), serialized.size(), deserialized) &&
+                                deserialized.vertexIndices == meshletMesh.vertexIndices && deserialized.primitives == meshletMesh.primitives;
+
+        printf("    %s: %zu triangles, %zu meshlets, %zu meshlet vertices for %u vertices, average vertex reuse: %.2f, serialized: %zu bytes%s\n",
+                testMeshes[i].name, meshletMesh.primitives.size(), meshletMesh.meshlets.size(), meshletMesh.vertexIndices.size(), sourceMeshes[i].vertexCount,
+                GetMeshletVertexReuse(meshletMesh), serialized.size(), roundTrip ? "" : " (round trip FAILED)");
+
+        totalPrimitiveCount += meshletMesh.primitives.size();
+        totalVertexCount += meshletMesh.vertexIndices.size();
+    }
+
+    printf("Average vertex reuse of all meshlets: %.2f\n", totalVertexCount == 0 ? 0.0 : double(totalPrimitiveCount * 3U) / double(totalVertexCount));
+
+    return meshletMeshes;
+}
+#endif
+
+#if BUILD_TEST_MESHLETS && TEST_MESHLET_CULLING
+// The same layout as CBMeshletCulling in meshlet_cull.amplification.hlsl and meshlet.mesh.hlsl
+struct MeshletCullingConstants
+{
+    float viewProjection[4][4];     // row-major, for row vectors
+    float frustumPlanes[6][4];      // inward normals
+    float cameraPosition[4];
+    uint32_t meshletCount;
+    uint32_t instanceCount;
+};
+
+// Per-pass counters in the UAV buffer
+enum MESHLET_CULLING_COUNTER_ID
+{
+    MESHLET_CULLING_VISIBLE_COUNTER,
+    MESHLET_CULLING_FRUSTUM_CULLED_COUNTER,
+    MESHLET_CULLING_BACK_FACE_CULLED_COUNTER,
+    MESHLET_CULLING_TRIANGLE_COUNTER,
+
+    MESHLET_CULLING_COUNTER_COUNT
+};
+
+// Camera at (0, 1.5, 2) looking down -z, 60 degrees vertical field of view, D3D depth range [0, 1]
+static auto CreateMeshletCullingConstants(uint32_t meshletCount, uint32_t instanceCount) -> MeshletCullingConstants
+{
+    const float cameraPosition[3] = { 0.0f, 1.5f, 2.0f };
+    const float f = 1.0f / (float)tan(30.0 * M_PI / 180.0);
+    const float depthScale = MESHLET_CULLING_FAR_PLANE / (MESHLET_CULLING_NEAR_PLANE - MESHLET_CULLING_FAR_PLANE);
+
+    MeshletCullingConstants constants{
+        .viewProjection {
+            { f, 0.0f, 0.0f, 0.0f },
+            { 0.0f, f, 0.0f, 0.0f },
+            { 0.0f, 0.0f, depthScale, -1.0f },
+            { 0.0f, 0.0f, depthScale * MESHLET_CULLING_NEAR_PLANE, 0.0f }
+        },
+        .frustumPlanes { },
+        .cameraPosition { cameraPosition[0], cameraPosition[1], cameraPosition[2], 1.0f },
+        .meshletCount = meshletCount,
+        .instanceCount = instanceCount
+    };
+
+    // view * projection, where the view matrix only translates by -cameraPosition
+    for (int column = 0; column < 4; ++column)
+    {
+        constants.viewProjection[3][column] -= cameraPosition[0] * constants.viewProjection[0][column] +
+                                                cameraPosition[1] * constants.viewProjection[1][column] +
+                                                cameraPosition[2] * constants.viewProjection[2][column];
+    }
+
+    // Gribb-Hartmann: clip = p * M, so every plane is a combination of the columns of M.
+    // left: w + x, right: w - x, bottom: w + y, top: w - y, near: z, far: w - z
+    const float wSigns[6] = { 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f };
+    const int columns[6] = { 0, 0, 1, 1, 2, 2 };
+    const float columnSigns[6] = { 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f };
+    for (int plane = 0; plane < 6; ++plane)
+    {
+        float* planeEquation = constants.frustumPlanes[plane];
+        for (int row = 0; row < 4; ++row) {
+            planeEquation[row] = wSigns[plane] * constants.viewProjection[row][3] + columnSigns[plane] * constants.viewProjection[row][columns[plane]];
+        }
+
+        const float length = std::sqrt(planeEquation[0] * planeEquation[0] + planeEquation[1] * planeEquation[1] + planeEquation[2] * planeEquation[2]);
+        for (int row = 0; row < 4; ++row) {
+            planeEquation[row] /= length;
+        }
+    }
+
+    return constants;
+}
+
+// A grid of tori on the ground plane, wider than the view frustum. xyz: translation, w: uniform scale
+static auto CreateMeshletCullingInstances() -> std::vector<std::array<float, 4>>
+{
+    std::vector<std::array<float, 4>> instances;
+    for (UINT row = 0; row < MESHLET_CULLING_GRID_SIZE; ++row)
+    {
+        for (UINT column = 0; column < MESHLET_CULLING_GRID_SIZE; ++column)
+        {
+            const float x = (float(column) - float(MESHLET_CULLING_GRID_SIZE - 1U) * 0.5f) * 3.0f;
+            const float z = -2.0f - float(row) * 3.0f;
+            instances.push_back({ x, 0.0f, z, 0.9f + 0.05f * float((row + column) % 3U) });
+        }
+    }
+    return instances;
+}
+
+// The same tests as meshlet_cull.amplification.hlsl on the CPU
+static auto CountVisibleMeshlets(const MeshletCullingConstants& constants, const MeshletMesh& meshletMesh, const std::vector<std::array<float, 4>>& instances) ->
+                                std::array<UINT, 3>
+{
+    std::array<UINT, 3> counts{ };   // visible, frustum culled, back-face culled
+
+    for (const std::array<float, 4>& instance : instances)
+    {
+        for (const MeshletDesc& meshlet : meshletMesh.meshlets)
+        {
+            const float center[3] = {
+                meshlet.boundingSphere[0] * instance[3] + instance[0],
+                meshlet.boundingSphere[1] * instance[3] + instance[1],
+                meshlet.boundingSphere[2] * instance[3] + instance[2]
+            };
+            const float radius = meshlet.boundingSphere[3] * instance[3];
+
+            bool insideFrustum = true;
+            for (const auto& plane : constants.frustumPlanes) {
+                insideFrustum = insideFrustum && plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3] >= -radius;
+            }
+            if (!insideFrustum)
+            {
+                ++counts[1];
+                continue;
+            }
+
+            float axis[3], cutoff;
+            DecodeMeshletNormalCone(meshlet.normalCone, axis, &cutoff);
+            if (cutoff < 1.0f)
+            {
+                const float view[3] = { center[0] - constants.cameraPosition[0], center[1] - constants.cameraPosition[1], center[2] - constants.cameraPosition[2] };
+                const float viewLength = std::sqrt(view[0] * view[0] + view[1] * view[1] + view[2] * view[2]);
+                if (view[0] * axis[0] + view[1] * axis[1] + view[2] * axis[2] >= cutoff * viewLength + radius)
+                {
+                    ++counts[2];
+                    continue;
+                }
+            }
+
+            ++counts[0];
+        }
+    }
+
+    return counts;
+}
+
+// @param allowInputAssembler also makes the root signature usable by the vertex shader path of the geometry pipeline benchmark
+static auto CreateRootSignatureForMeshletCulling(ID3D12Device* d3d_device, bool allowInputAssembler) -> ID3D12RootSignature*
+{
+    ID3D12RootSignature* rootSignature = nullptr;
+
+    auto const shaderResourceView = [](UINT shaderRegister) -> D3D12_ROOT_PARAMETER {
+        return D3D12_ROOT_PARAMETER{
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV,
+            .Descriptor { .ShaderRegister = shaderRegister, .RegisterSpace = 0 },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        };
+    };
+
+    const D3D12_ROOT_PARAMETER rootParameters[]{
+        // b0: culling constants
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV,
+            .Descriptor { .ShaderRegister = 0, .RegisterSpace = 0 },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        // b1: cullingEnabled, counterBase
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+            .Constants { .ShaderRegister = 1, .RegisterSpace = 0, .Num32BitValues = 2 },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        // t0 - t4: meshlets, vertex indices, primitives, positions, instances
+        shaderResourceView(0), shaderResourceView(1), shaderResourceView(2), shaderResourceView(3), shaderResourceView(4),
+        // u0: counters
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV,
+            .Descriptor { .ShaderRegister = 0, .RegisterSpace = 0 },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        }
+    };
+
+    const D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {
+        .NumParameters = UINT(std::size(rootParameters)),
+        .pParameters = rootParameters,
+        .NumStaticSamplers = 0,
+        .pStaticSamplers = nullptr,
+        .Flags = (allowInputAssembler ? D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT : D3D12_ROOT_SIGNATURE_FLAG_DENY_VERTEX_SHADER_ROOT_ACCESS) |
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS |
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS |
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS
+    };
+
+    ID3DBlob* signature = nullptr;
+    ID3DBlob* error = nullptr;
+    HRESULT hRes = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error);
+    do
+    {
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "D3D12SerializeRootSignature for meshlet culling failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateRootSignature for meshlet culling failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (signature != nullptr) {
+        signature->Release();
+    }
+    if (error != nullptr) {
+        error->Release();
+    }
+
+    if (FAILED(hRes)) return nullptr;
+
+    return rootSignature;
+}
+
+// @param amplificationShaderPath nullptr for a pipeline without an amplification shader
+static auto CreatePipelineStateForMeshletCulling(ID3D12Device2* d3d_device, ID3D12RootSignature* rootSignature, const char* amplificationShaderPath, const char* meshShaderPath) ->
+                                                ID3D12PipelineState*
+{
+    D3D12_SHADER_BYTECODE amplificationShaderObj{ };
+    if (amplificationShaderPath != nullptr) {
+        amplificationShaderObj = CreateCompiledShaderObjectFromPath(amplificationShaderPath);
+    }
+    D3D12_SHADER_BYTECODE meshShaderObj = CreateCompiledShaderObjectFromPath(meshShaderPath);
+    D3D12_SHADER_BYTECODE pixelShaderObj = CreateCompiledShaderObjectFromPath("cso/basic.frag.cso");
+
+    ID3D12PipelineState* pipelineState = nullptr;
+
+    do
+    {
+        if (amplificationShaderPath != nullptr && (amplificationShaderObj.pShaderBytecode == nullptr || amplificationShaderObj.BytecodeLength == 0)) break;
+        if (meshShaderObj.pShaderBytecode == nullptr || meshShaderObj.BytecodeLength == 0) break;
+        if (pixelShaderObj.pShaderBytecode == nullptr || pixelShaderObj.BytecodeLength == 0) break;
+
+        struct {
+            RootSignatureSubobject rootSignatureSubobject;
+            ShaderByteCodeSubobject asShaderSubobject;
+            ShaderByteCodeSubobject msShaderSubobject;
+            ShaderByteCodeSubobject psShaderSubobject;
+            BlendStateSubobject blendStateSubobject;
+            SampleMaskSubobject sampleMaskSubobject;
+            RasterizerStateSubobject raterizerStateSubobject;
+            DepthStencilSubobject depthStencilSubobject;
+            PrimitiveTopologyTypeSubobject primitiveTopologySubobject;
+            RenderTargetFormatsSubobject renderTargetFormatsSubobject;
+            DepthStencilViewFormat depthStencilViewFormatSubobject;
+            SampleDescSubobject sampleDescSubobject;
+            NodeMaskSubobject nodeMaskSubobject;
+            FlagsSubobject flagsSubobject;
+        } psoStream {
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_ROOT_SIGNATURE, rootSignature },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_AS, amplificationShaderObj },      // empty bytecode: no amplification shader
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_MS, meshShaderObj },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PS, pixelShaderObj },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_BLEND, {
+                    .AlphaToCoverageEnable = FALSE,
+                    .IndependentBlendEnable = FALSE,
+                    .RenderTarget {
+                        {
+                            .BlendEnable = FALSE,
+                            .LogicOpEnable = FALSE,
+                            .SrcBlend = D3D12_BLEND_ONE,
+                            .DestBlend = D3D12_BLEND_ZERO,
+                            .BlendOp = D3D12_BLEND_OP_ADD,
+                            .SrcBlendAlpha = D3D12_BLEND_ONE,
+                            .DestBlendAlpha = D3D12_BLEND_ZERO,
+                            .BlendOpAlpha = D3D12_BLEND_OP_ADD,
+                            .LogicOp = D3D12_LOGIC_OP_NOOP,
+                            .RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL
+                        }
+                    }
+                }
+            },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_MASK, UINT32_MAX },
+            // Meshlet normals are cross(p1 - p0, p2 - p0) in a right-handed space, so front faces are counter-clockwise
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RASTERIZER, {
+                        .FillMode = D3D12_FILL_MODE_SOLID,
+                        .CullMode = D3D12_CULL_MODE_BACK,
+                        .FrontCounterClockwise = TRUE,
+                        .DepthBias = 0,
+                        .DepthBiasClamp = 0.0f,
+                        .SlopeScaledDepthBias = 0.0f,
+                        .DepthClipEnable = TRUE,
+                        .MultisampleEnable = FALSE,
+                        .AntialiasedLineEnable = FALSE,
+                        .ForcedSampleCount = 0,
+                        .ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF
+                    }
+            },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL, {
+                        .DepthEnable = TRUE,
+                        .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL,
+                        .DepthFunc = D3D12_COMPARISON_FUNC_LESS,
+                        .StencilEnable = FALSE,
+                        .StencilReadMask = 0,
+                        .StencilWriteMask = 0,
+                        .FrontFace { },
+                        .BackFace { }
+                    }
+            },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PRIMITIVE_TOPOLOGY, D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RENDER_TARGET_FORMATS, {
+                    .RTFormats { RENDER_TARGET_BUFFER_FOMRAT },
+                    .NumRenderTargets = 1
+                }
+            },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL_FORMAT, DXGI_FORMAT_D32_FLOAT },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_DESC, { .Count = 1, .Quality = 0 } },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_NODE_MASK, 0 },
+            { D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_FLAGS, D3D12_PIPELINE_STATE_FLAG_NONE }
+        };
+
+        const D3D12_PIPELINE_STATE_STREAM_DESC streamDesc{
+            .SizeInBytes = sizeof(psoStream),
+            .pPipelineStateSubobjectStream = &psoStream
+        };
+
+        const HRESULT hRes = d3d_device->CreatePipelineState(&streamDesc, IID_PPV_ARGS(&pipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreatePipelineState for meshlet culling failed: %ld\n", hRes);
+            pipelineState = nullptr;
+            break;
+        }
+    }
+    while (false);
+
+    if (amplificationShaderObj.pShaderBytecode != nullptr) {
+        free((void*)amplificationShaderObj.pShaderBytecode);
+    }
+    if (meshShaderObj.pShaderBytecode != nullptr) {
+        free((void*)meshShaderObj.pShaderBytecode);
+    }
+    if (pixelShaderObj.pShaderBytecode != nullptr) {
+        free((void*)pixelShaderObj.pShaderBytecode);
+    }
+
+    return pipelineState;
+}
+
+// Renders the instances of the mesh twice through meshlet_cull.amplification.hlsl, without and with culling,
+// and reads back the per-pass meshlet and triangle counters from the UAV buffer
+static auto RunMeshletCullingTest(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator,
+                                const MeshletTestMesh& mesh, const MeshletMesh& meshletMesh) -> bool
+{
+    const std::vector<std::array<float, 4>> instances = CreateMeshletCullingInstances();
+    const MeshletCullingConstants constants = CreateMeshletCullingConstants(uint32_t(meshletMesh.meshlets.size()), uint32_t(instances.size()));
+    const UINT meshletInstanceCount = constants.meshletCount * constants.instanceCount;
+    const UINT amplificationGroupCount = (meshletInstanceCount + MESHLET_CULLING_GROUP_SIZE - 1U) / MESHLET_CULLING_GROUP_SIZE;
+
+    // Sections of the meshlet data buffer: meshlets, vertex indices, primitives, positions, instances
+    const size_t sectionSizes[5] = {
+        meshletMesh.meshlets.size() * sizeof(MeshletDesc),
+        meshletMesh.vertexIndices.size() * sizeof(uint32_t),
+        meshletMesh.primitives.size() * sizeof(uint32_t),
+        mesh.positions.size() * sizeof(float),
+        instances.size() * sizeof(instances[0])
+    };
+    const void* sectionData[5] = { meshletMesh.meshlets.data(), meshletMesh.vertexIndices.data(), meshletMesh.primitives.data(), mesh.positions.data(), instances.data() };
+    size_t sectionOffsets[5]{ };
+    size_t meshletDataSize = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        sectionOffsets[i] = meshletDataSize;
+        meshletDataSize += (sectionSizes[i] + CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U) & ~size_t(CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U);
+    }
+
+    // counters[pass * MESHLET_CULLING_COUNTER_COUNT + id], pass 0: without culling, pass 1: with culling
+    constexpr UINT counterBufferSize = 2U * MESHLET_CULLING_COUNTER_COUNT * sizeof(UINT);
+    constexpr UINT timestampCount = 4U;
+
+    // The upload buffer holds the constants, the meshlet data and the zero-initialized counters
+    const size_t constantBufferSize = (sizeof(MeshletCullingConstants) + CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U) & ~size_t(CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U);
+    const size_t uploadBufferSize = constantBufferSize + meshletDataSize + counterBufferSize;
+
+    ID3D12RootSignature* rootSignature = nullptr;
+    ID3D12PipelineState* pipelineState = nullptr;
+    ID3D12PipelineState* timedPipelineState = nullptr;     // the same shaders without the statistics counters
+    OffscreenBenchmarkTarget target{ };
+    ID3D12Resource* uploadDevHostBuffer = nullptr;
+    ID3D12Resource* meshletDataBuffer = nullptr;
+    ID3D12Resource* counterBuffer = nullptr;
+    ID3D12Resource* counterReadbackBuffer = nullptr;
+    bool success = false;
+
+    do
+    {
+        if (meshletInstanceCount == 0U) break;
+
+        rootSignature = CreateRootSignatureForMeshletCulling(d3d_device, false);
+        if (rootSignature == nullptr) break;
+
+        pipelineState = CreatePipelineStateForMeshletCulling((ID3D12Device2*)d3d_device, rootSignature, "cso/meshlet_cull.amplification.cso", "cso/meshlet.mesh.cso");
+        if (pipelineState == nullptr) break;
+
+        timedPipelineState = CreatePipelineStateForMeshletCulling((ID3D12Device2*)d3d_device, rootSignature, "cso/meshlet_cull_nostats.amplification.cso",
+                                                                "cso/meshlet_nostats.mesh.cso");
+        if (timedPipelineState == nullptr) break;
+
+        constexpr FLOAT clearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
+        if (!CreateOffscreenBenchmarkTarget(d3d_device, commandAllocator, pipelineState, MESHLET_CULLING_TARGET_SIZE, MESHLET_CULLING_TARGET_SIZE,
+                                            clearColor, timestampCount, "meshlet culling", target)) break;
+
+        ID3D12GraphicsCommandList* const commandList = target.commandList;
+
+        const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+            .Type = D3D12_HEAP_TYPE_DEFAULT,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
+
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = defaultHeapProperties;
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_HEAP_PROPERTIES readbackHeapProperties = defaultHeapProperties;
+        readbackHeapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+        D3D12_RESOURCE_DESC bufferDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0,
+            .Width = uploadBufferSize,
+            .Height = 1U,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {.Count = 1U, .Quality = 0 },
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE
+        };
+        HRESULT hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadDevHostBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for meshlet culling upload buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = meshletDataSize;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&meshletDataBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for meshlet data buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = counterBufferSize;
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&counterReadbackBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for meshlet culling counter read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&counterBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for meshlet culling counter buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        void* hostMemPtr = nullptr;
+        hRes = uploadDevHostBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map meshlet culling upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        memcpy(hostMemPtr, &constants, sizeof(constants));
+        for (int i = 0; i < 5; ++i) {
+            memcpy((void*)(uintptr_t(hostMemPtr) + constantBufferSize + sectionOffsets[i]), sectionData[i], sectionSizes[i]);
+        }
+        memset((void*)(uintptr_t(hostMemPtr) + constantBufferSize + meshletDataSize), 0, counterBufferSize);
+        uploadDevHostBuffer->Unmap(0, nullptr);
+
+        // Upload the meshlet data and clear the counters
+        WriteToDeviceResourceAndSync(commandList, meshletDataBuffer, uploadDevHostBuffer, 0U, constantBufferSize, meshletDataSize);
+        WriteToDeviceResourceAndSync(commandList, counterBuffer, uploadDevHostBuffer, 0U, constantBufferSize + meshletDataSize, counterBufferSize);
+
+        const D3D12_RESOURCE_BARRIER counterBarrier{
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .Transition {
+                .pResource = counterBuffer,
+                .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                .StateBefore = D3D12_RESOURCE_STATE_GENERIC_READ,
+                .StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+            }
+        };
+        commandList->ResourceBarrier(1U, &counterBarrier);
+
+        SetOffscreenBenchmarkTarget(target);
+
+        const D3D12_GPU_VIRTUAL_ADDRESS meshletDataAddress = meshletDataBuffer->GetGPUVirtualAddress();
+        commandList->SetGraphicsRootSignature(rootSignature);
+        commandList->SetGraphicsRootConstantBufferView(0, uploadDevHostBuffer->GetGPUVirtualAddress());    // rootParameters[0]
+        for (UINT i = 0; i < 5U; ++i) {
+            commandList->SetGraphicsRootShaderResourceView(2U + i, meshletDataAddress + sectionOffsets[i]);  // rootParameters[2...6]
+        }
+        commandList->SetGraphicsRootUnorderedAccessView(7, counterBuffer->GetGPUVirtualAddress());        // rootParameters[7]
+
+        // Pass 0: every meshlet, pass 1: with culling.
+        // The counters come from an untimed dispatch, the timed dispatch runs the same shaders without the counter atomics.
+        for (UINT pass = 0; pass < 2U; ++pass)
+        {
+            const UINT passConstants[2] = { pass, pass * MESHLET_CULLING_COUNTER_COUNT };
+            commandList->SetGraphicsRoot32BitConstants(1, 2, passConstants, 0);      // rootParameters[1]
+
+            commandList->ClearRenderTargetView(target.rtvHandle, clearColor, 0, nullptr);
+            commandList->ClearDepthStencilView(target.dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+            commandList->SetPipelineState(pipelineState);
+            ((ID3D12GraphicsCommandList6*)commandList)->DispatchMesh(amplificationGroupCount, 1U, 1U);
+
+            commandList->ClearRenderTargetView(target.rtvHandle, clearColor, 0, nullptr);
+            commandList->ClearDepthStencilView(target.dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+            commandList->SetPipelineState(timedPipelineState);
+            commandList->EndQuery(target.queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, pass * 2U);
+            ((ID3D12GraphicsCommandList6*)commandList)->DispatchMesh(amplificationGroupCount, 1U, 1U);
+            commandList->EndQuery(target.queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, pass * 2U + 1U);
+        }
+
+        SyncAndReadFromDeviceResource(commandList, counterBufferSize, counterReadbackBuffer, counterBuffer);
+
+        UINT64 timestampFrequency = 0;
+        if (!ExecuteOffscreenBenchmark(commandQueue, target, "meshlet culling", timestampFrequency)) break;
+
+        const UINT* counters = nullptr;
+        hRes = counterReadbackBuffer->Map(0, nullptr, (void**)&counters);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map meshlet culling counter read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        const UINT64* timestamps = nullptr;
+        hRes = target.timestampReadbackBuffer->Map(0, nullptr, (void**)&timestamps);
+        if (FAILED(hRes))
+        {
+            counterReadbackBuffer->Unmap(0, nullptr);
+            fprintf(stderr, "Map meshlet culling timestamp read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        const std::array<UINT, 3> cpuCounts = CountVisibleMeshlets(constants, meshletMesh, instances);
+
+        printf("Meshlet culling: %u instances of the %s, %u meshlets per instance, %u amplification groups, payload: %zu bytes\n",
+                constants.instanceCount, mesh.name, constants.meshletCount, amplificationGroupCount, sizeof(UINT) * MESHLET_CULLING_GROUP_SIZE);
+        for (UINT pass = 0; pass < 2U; ++pass)
+        {
+            const UINT* passCounters = &counters[pass * MESHLET_CULLING_COUNTER_COUNT];
+            printf("    %s culling: %u visible, %u frustum culled, %u back-face culled meshlets, %u triangles, %.3f ms\n",
+                    pass == 0U ? "without" : "with", passCounters[MESHLET_CULLING_VISIBLE_COUNTER], passCounters[MESHLET_CULLING_FRUSTUM_CULLED_COUNTER],
+                    passCounters[MESHLET_CULLING_BACK_FACE_CULLED_COUNTER], passCounters[MESHLET_CULLING_TRIANGLE_COUNTER],
+                    double(timestamps[pass * 2U + 1U] - timestamps[pass * 2U]) * 1000.0 / double(timestampFrequency));
+        }
+
+        // Pass 0 must draw every meshlet, pass 1 must cull the same meshlets as the CPU
+        const UINT* const culledPassCounters = &counters[MESHLET_CULLING_COUNTER_COUNT];
+        const bool countsMatch = counters[MESHLET_CULLING_VISIBLE_COUNTER] == meshletInstanceCount &&
+                                culledPassCounters[MESHLET_CULLING_VISIBLE_COUNTER] == cpuCounts[0] &&
+                                culledPassCounters[MESHLET_CULLING_FRUSTUM_CULLED_COUNTER] == cpuCounts[1] &&
+                                culledPassCounters[MESHLET_CULLING_BACK_FACE_CULLED_COUNTER] == cpuCounts[2];
+        printf("    CPU reference: %u visible, %u frustum culled, %u back-face culled meshlets, %s\n", cpuCounts[0], cpuCounts[1], cpuCounts[2],
+                countsMatch ? "matches the GPU counters" : "MISMATCH with the GPU counters!");
+
+        target.timestampReadbackBuffer->Unmap(0, nullptr);
+        counterReadbackBuffer->Unmap(0, nullptr);
+
+        success = countsMatch;
+    }
+    while (false);
+
+    if (rootSignature != nullptr) {
+        rootSignature->Release();
+    }
+    if (pipelineState != nullptr) {
+        pipelineState->Release();
+    }
+    if (timedPipelineState != nullptr) {
+        timedPipelineState->Release();
+    }
+    ReleaseOffscreenBenchmarkTarget(target);
+    if (uploadDevHostBuffer != nullptr) {
+        uploadDevHostBuffer->Release();
+    }
+    if (meshletDataBuffer != nullptr) {
+        meshletDataBuffer->Release();
+    }
+    if (counterBuffer != nullptr) {
+        counterBuffer->Release();
+    }
+    if (counterReadbackBuffer != nullptr) {
+        counterReadbackBuffer->Release();
+    }
+
+    return success;
+}
+
+#if RUN_GEOMETRY_PIPELINE_BENCHMARK
+// A flat grid patch of [-1, 1] x [-1, 1] in the xz plane facing +y, with at least triangleCount triangles
+static auto CreateGeometryBenchmarkMesh(UINT triangleCount) -> MeshletTestMesh
+{
+    const UINT cellCount = (triangleCount + 1U) / 2U;
+    const UINT columnCount = UINT(std::ceil(std::sqrt(double(cellCount))));
+    const UINT rowCount = (cellCount + columnCount - 1U) / columnCount;
+
+    MeshletTestMesh mesh{ .name = "grid patch" };
+    for (UINT row = 0; row <= rowCount; ++row)
+    {
+        for (UINT column = 0; column <= columnCount; ++column) {
+            mesh.positions.insert(mesh.positions.end(), { 2.0f * float(column) / float(columnCount) - 1.0f, 0.0f, 2.0f * float(row) / float(rowCount) - 1.0f });
+        }
+    }
+    for (UINT row = 0; row < rowCount; ++row)
+    {
+        for (UINT column = 0; column < columnCount; ++column)
+        {
+            const uint32_t v0 = row * (columnCount + 1U) + column;
+            const uint32_t v2 = v0 + columnCount + 1U;
+            mesh.indices.insert(mesh.indices.end(), { v0, v2, v0 + 1U, v0 + 1U, v2, v2 + 1U });
+        }
+    }
+
+    return mesh;
+}
+
+// Rows of patches in front of the camera of CreateMeshletCullingConstants. xyz: translation, w: uniform scale
+static auto CreateGeometryBenchmarkInstances(UINT instanceCount) -> std::vector<std::array<float, 4>>
+{
+    const UINT columnCount = UINT(std::ceil(std::sqrt(double(instanceCount))));
+
+    std::vector<std::array<float, 4>> instances;
+    for (UINT i = 0; i < instanceCount; ++i)
+    {
+        const float x = (float(i % columnCount) - float(columnCount - 1U) * 0.5f) * 2.2f;
+        const float z = -2.0f - float(i / columnCount) * 2.2f;
+        instances.push_back({ x, 0.0f, z, 1.0f });
+    }
+    return instances;
+}
+
+static auto CreatePipelineStateForGeometryBenchmarkVertexShader(ID3D12Device* d3d_device, ID3D12RootSignature* rootSignature) -> ID3D12PipelineState*
+{
+    D3D12_SHADER_BYTECODE vertexShaderObj = CreateCompiledShaderObjectFromPath("cso/geometry_benchmark.vert.cso");
+    D3D12_SHADER_BYTECODE pixelShaderObj = CreateCompiledShaderObjectFromPath("cso/basic.frag.cso");
+
+    ID3D12PipelineState* pipelineState = nullptr;
+
+    do
+    {
+        if (vertexShaderObj.pShaderBytecode == nullptr || vertexShaderObj.BytecodeLength == 0) break;
+        if (pixelShaderObj.pShaderBytecode == nullptr || pixelShaderObj.BytecodeLength == 0) break;
+
+        // Slot 0: positions, slot 1: instances
+        const D3D12_INPUT_ELEMENT_DESC inputElementDescs[]{
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "INSTANCE", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+        };
+
+        // The same states as CreatePipelineStateForMeshletCulling
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc{
+            .pRootSignature = rootSignature,
+            .VS = vertexShaderObj,
+            .PS = pixelShaderObj,
+            .BlendState {
+                .AlphaToCoverageEnable = FALSE,
+                .IndependentBlendEnable = FALSE,
+                .RenderTarget {
+                    // RenderTarget[0]
+                    {
+                        .BlendEnable = FALSE,
+                        .LogicOpEnable = FALSE,
+                        .SrcBlend = D3D12_BLEND_ONE,
+                        .DestBlend = D3D12_BLEND_ZERO,
+                        .BlendOp = D3D12_BLEND_OP_ADD,
+                        .SrcBlendAlpha = D3D12_BLEND_ONE,
+                        .DestBlendAlpha = D3D12_BLEND_ZERO,
+                        .BlendOpAlpha = D3D12_BLEND_OP_ADD,
+                        .LogicOp = D3D12_LOGIC_OP_NOOP,
+                        .RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL
+                    }
+                }
+            },
+            .SampleMask = UINT32_MAX,
+            .RasterizerState {
+                .FillMode = D3D12_FILL_MODE_SOLID,
+                .CullMode = D3D12_CULL_MODE_BACK,
+                .FrontCounterClockwise = TRUE,
+                .DepthBias = 0,
+                .DepthBiasClamp = 0.0f,
+                .SlopeScaledDepthBias = 0.0f,
+                .DepthClipEnable = TRUE,
+                .MultisampleEnable = FALSE,
+                .AntialiasedLineEnable = FALSE,
+                .ForcedSampleCount = 0,
+                .ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF
+            },
+            .DepthStencilState {
+                .DepthEnable = TRUE,
+                .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL,
+                .DepthFunc = D3D12_COMPARISON_FUNC_LESS,
+                .StencilEnable = FALSE,
+                .StencilReadMask = 0,
+                .StencilWriteMask = 0,
+                .FrontFace { },
+                .BackFace { }
+            },
+            .InputLayout {
+                .pInputElementDescs = inputElementDescs,
+                .NumElements = (UINT)std::size(inputElementDescs)
+            },
+            .IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED,
+            .PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+            .NumRenderTargets = 1,
+            .RTVFormats {
+                // RTVFormats[0]
+                { RENDER_TARGET_BUFFER_FOMRAT }
+            },
+            .DSVFormat = DXGI_FORMAT_D32_FLOAT,
+            .SampleDesc {
+                .Count = 1,
+                .Quality = 0
+            },
+            .NodeMask = 0,
+            .CachedPSO { },
+            .Flags = D3D12_PIPELINE_STATE_FLAG_NONE
+        };
+
+        const HRESULT hRes = d3d_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateGraphicsPipelineState for geometry benchmark failed: %ld\n", hRes);
+            pipelineState = nullptr;
+            break;
+        }
+    }
+    while (false);
+
+    if (vertexShaderObj.pShaderBytecode != nullptr) {
+        free((void*)vertexShaderObj.pShaderBytecode);
+    }
+    if (pixelShaderObj.pShaderBytecode != nullptr) {
+        free((void*)pixelShaderObj.pShaderBytecode);
+    }
+
+    return pipelineState;
+}
+
+// Renders GEOMETRY_BENCHMARK_INSTANCE_COUNT instances of a GEOMETRY_BENCHMARK_TRIANGLE_COUNT triangle mesh through
+// the input assembler + vertex shader, amplification + mesh shader and ExecuteIndirect() DispatchMesh pipelines,
+// GEOMETRY_BENCHMARK_ITERATION_COUNT times each, and reports GPU time, triangle throughput and CPU recording cost per pipeline.
+static auto RunGeometryPipelineBenchmark(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator) -> bool
+{
+    enum GEOMETRY_PIPELINE_ID
+    {
+        GEOMETRY_PIPELINE_INPUT_ASSEMBLER,
+        GEOMETRY_PIPELINE_AMPLIFICATION_MESH_SHADER,
+        GEOMETRY_PIPELINE_INDIRECT_DISPATCH_MESH,
+
+        GEOMETRY_PIPELINE_COUNT
+    };
+
+    const char* const pipelineNames[GEOMETRY_PIPELINE_COUNT] = { "IA + VS", "AS + MS", "ExecuteIndirect DispatchMesh" };
+
+    const MeshletTestMesh mesh = CreateGeometryBenchmarkMesh(GEOMETRY_BENCHMARK_TRIANGLE_COUNT);
+    const MeshletMesh meshletMesh = BuildMeshletMesh(MeshletSourceMesh{
+            .positions = mesh.positions.data(),
+            .positionStride = uint32_t(sizeof(float) * 3U),
+            .vertexCount = uint32_t(mesh.positions.size() / 3U),
+            .indices = mesh.indices.data(),
+            .indexCount = uint32_t(mesh.indices.size())
+        }, TEST_MESHLET_MAX_VERTEX_COUNT, TEST_MESHLET_MAX_PRIMITIVE_COUNT);
+
+    const std::vector<std::array<float, 4>> instances = CreateGeometryBenchmarkInstances(GEOMETRY_BENCHMARK_INSTANCE_COUNT);
+    const MeshletCullingConstants constants = CreateMeshletCullingConstants(uint32_t(meshletMesh.meshlets.size()), uint32_t(instances.size()));
+    const UINT meshletInstanceCount = constants.meshletCount * constants.instanceCount;
+    const UINT amplificationGroupCount = (meshletInstanceCount + MESHLET_CULLING_GROUP_SIZE - 1U) / MESHLET_CULLING_GROUP_SIZE;
+    const UINT64 triangleCount = UINT64(mesh.indices.size() / 3U) * constants.instanceCount;
+
+    // One mesh shader group per meshlet (x) and instance (y)
+    const D3D12_DISPATCH_MESH_ARGUMENTS dispatchMeshArguments{
+        .ThreadGroupCountX = constants.meshletCount,
+        .ThreadGroupCountY = constants.instanceCount,
+        .ThreadGroupCountZ = 1U
+    };
+
+    // Sections of the geometry data buffer: meshlets, vertex indices, primitives, positions, instances (t0 - t4 and vertex buffers),
+    // triangle indices (index buffer), DispatchMesh arguments (indirect argument buffer)
+    constexpr int sectionCount = 7;
+    const size_t sectionSizes[sectionCount] = {
+        meshletMesh.meshlets.size() * sizeof(MeshletDesc),
+        meshletMesh.vertexIndices.size() * sizeof(uint32_t),
+        meshletMesh.primitives.size() * sizeof(uint32_t),
+        mesh.positions.size() * sizeof(float),
+        instances.size() * sizeof(instances[0]),
+        mesh.indices.size() * sizeof(uint32_t),
+        sizeof(dispatchMeshArguments)
+    };
+    const void* sectionData[sectionCount] = {
+        meshletMesh.meshlets.data(), meshletMesh.vertexIndices.data(), meshletMesh.primitives.data(), mesh.positions.data(), instances.data(),
+        mesh.indices.data(), &dispatchMeshArguments
+    };
+    size_t sectionOffsets[sectionCount]{ };
+    size_t geometryDataSize = 0;
+    for (int i = 0; i < sectionCount; ++i)
+    {
+        sectionOffsets[i] = geometryDataSize;
+        geometryDataSize += (sectionSizes[i] + CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U) & ~size_t(CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U);
+    }
+
+    // counters[pipeline * MESHLET_CULLING_COUNTER_COUNT + id], only written by the untimed counting draws of the mesh shader pipelines
+    constexpr UINT counterBufferSize = GEOMETRY_PIPELINE_COUNT * MESHLET_CULLING_COUNTER_COUNT * sizeof(UINT);
+    constexpr UINT timestampCount = GEOMETRY_PIPELINE_COUNT * 2U;
+
+    const size_t constantBufferSize = (sizeof(MeshletCullingConstants) + CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U) & ~size_t(CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U);
+    const size_t uploadBufferSize = constantBufferSize + geometryDataSize + counterBufferSize;
+
+    ID3D12RootSignature* rootSignature = nullptr;
+    ID3D12PipelineState* pipelineStates[GEOMETRY_PIPELINE_COUNT]{ };            // timed, without the statistics counters
+    ID3D12PipelineState* countingPipelineStates[GEOMETRY_PIPELINE_COUNT]{ };    // with the statistics counters, nullptr for the input assembler
+    ID3D12CommandSignature* commandSignature = nullptr;
+    OffscreenBenchmarkTarget target{ };
+    ID3D12Resource* uploadDevHostBuffer = nullptr;
+    ID3D12Resource* geometryDataBuffer = nullptr;
+    ID3D12Resource* counterBuffer = nullptr;
+    ID3D12Resource* counterReadbackBuffer = nullptr;
+    bool success = false;
+
+    do
+    {
+        if (meshletInstanceCount == 0U || amplificationGroupCount > 65535U) break;
+
+        rootSignature = CreateRootSignatureForMeshletCulling(d3d_device, true);
+        if (rootSignature == nullptr) break;
+
+        pipelineStates[GEOMETRY_PIPELINE_INPUT_ASSEMBLER] = CreatePipelineStateForGeometryBenchmarkVertexShader(d3d_device, rootSignature);
+        if (pipelineStates[GEOMETRY_PIPELINE_INPUT_ASSEMBLER] == nullptr) break;
+
+        // The culling amplification shader with cullingEnabled = 0 only compacts the meshlet IDs into the payload
+        pipelineStates[GEOMETRY_PIPELINE_AMPLIFICATION_MESH_SHADER] = CreatePipelineStateForMeshletCulling((ID3D12Device2*)d3d_device, rootSignature,
+                                                                        "cso/meshlet_cull_nostats.amplification.cso", "cso/meshlet_nostats.mesh.cso");
+        if (pipelineStates[GEOMETRY_PIPELINE_AMPLIFICATION_MESH_SHADER] == nullptr) break;
+
+        pipelineStates[GEOMETRY_PIPELINE_INDIRECT_DISPATCH_MESH] = CreatePipelineStateForMeshletCulling((ID3D12Device2*)d3d_device, rootSignature,
+                                                                        nullptr, "cso/meshlet_direct_nostats.mesh.cso");
+        if (pipelineStates[GEOMETRY_PIPELINE_INDIRECT_DISPATCH_MESH] == nullptr) break;
+
+        countingPipelineStates[GEOMETRY_PIPELINE_AMPLIFICATION_MESH_SHADER] = CreatePipelineStateForMeshletCulling((ID3D12Device2*)d3d_device, rootSignature,
+                                                                        "cso/meshlet_cull.amplification.cso", "cso/meshlet.mesh.cso");
+        if (countingPipelineStates[GEOMETRY_PIPELINE_AMPLIFICATION_MESH_SHADER] == nullptr) break;
+
+        countingPipelineStates[GEOMETRY_PIPELINE_INDIRECT_DISPATCH_MESH] = CreatePipelineStateForMeshletCulling((ID3D12Device2*)d3d_device, rootSignature,
+                                                                        nullptr, "cso/meshlet_direct.mesh.cso");
+        if (countingPipelineStates[GEOMETRY_PIPELINE_INDIRECT_DISPATCH_MESH] == nullptr) break;
+
+        // The same command signature as the mesh shader path of ExecuteIndirectTest
+        const D3D12_INDIRECT_ARGUMENT_DESC argumentDescList[]{
+            {
+                .Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH_MESH
+            }
+        };
+
+        const D3D12_COMMAND_SIGNATURE_DESC commandSignatureDesc{
+            .ByteStride = (UINT)sizeof(D3D12_DISPATCH_MESH_ARGUMENTS),
+            .NumArgumentDescs = (UINT)std::size(argumentDescList),
+            .pArgumentDescs = argumentDescList,
+            .NodeMask = 0U
+        };
+
+        HRESULT hRes = d3d_device->CreateCommandSignature(&commandSignatureDesc, nullptr, IID_PPV_ARGS(&commandSignature));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommandSignature for geometry benchmark failed: %ld\n", hRes);
+            break;
+        }
+
+        constexpr FLOAT clearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
+        if (!CreateOffscreenBenchmarkTarget(d3d_device, commandAllocator, nullptr, MESHLET_CULLING_TARGET_SIZE, MESHLET_CULLING_TARGET_SIZE,
+                                            clearColor, timestampCount, "geometry benchmark", target)) break;
+
+        ID3D12GraphicsCommandList* const commandList = target.commandList;
+
+        const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+            .Type = D3D12_HEAP_TYPE_DEFAULT,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
+
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = defaultHeapProperties;
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_HEAP_PROPERTIES readbackHeapProperties = defaultHeapProperties;
+        readbackHeapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+        D3D12_RESOURCE_DESC bufferDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0,
+            .Width = uploadBufferSize,
+            .Height = 1U,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {.Count = 1U, .Quality = 0 },
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE
+        };
+        hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadDevHostBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for geometry benchmark upload buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = geometryDataSize;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&geometryDataBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for geometry benchmark data buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = counterBufferSize;
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&counterReadbackBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for geometry benchmark counter read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&counterBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for geometry benchmark counter buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        void* hostMemPtr = nullptr;
+        hRes = uploadDevHostBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map geometry benchmark upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        memcpy(hostMemPtr, &constants, sizeof(constants));
+        for (int i = 0; i < sectionCount; ++i) {
+            memcpy((void*)(uintptr_t(hostMemPtr) + constantBufferSize + sectionOffsets[i]), sectionData[i], sectionSizes[i]);
+        }
+        memset((void*)(uintptr_t(hostMemPtr) + constantBufferSize + geometryDataSize), 0, counterBufferSize);
+        uploadDevHostBuffer->Unmap(0, nullptr);
+
+        // GENERIC_READ covers the vertex, index, shader resource and indirect argument uses of the geometry data buffer
+        WriteToDeviceResourceAndSync(commandList, geometryDataBuffer, uploadDevHostBuffer, 0U, constantBufferSize, geometryDataSize);
+        WriteToDeviceResourceAndSync(commandList, counterBuffer, uploadDevHostBuffer, 0U, constantBufferSize + geometryDataSize, counterBufferSize);
+
+        const D3D12_RESOURCE_BARRIER counterBarrier{
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .Transition {
+                .pResource = counterBuffer,
+                .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                .StateBefore = D3D12_RESOURCE_STATE_GENERIC_READ,
+                .StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+            }
+        };
+        commandList->ResourceBarrier(1U, &counterBarrier);
+
+        SetOffscreenBenchmarkTarget(target);
+
+        const D3D12_GPU_VIRTUAL_ADDRESS geometryDataAddress = geometryDataBuffer->GetGPUVirtualAddress();
+        commandList->SetGraphicsRootSignature(rootSignature);
+        commandList->SetGraphicsRootConstantBufferView(0, uploadDevHostBuffer->GetGPUVirtualAddress());    // rootParameters[0]
+        for (UINT i = 0; i < 5U; ++i) {
+            commandList->SetGraphicsRootShaderResourceView(2U + i, geometryDataAddress + sectionOffsets[i]);  // rootParameters[2...6]
+        }
+        commandList->SetGraphicsRootUnorderedAccessView(7, counterBuffer->GetGPUVirtualAddress());        // rootParameters[7]
+
+        const D3D12_VERTEX_BUFFER_VIEW vertexBufferViews[]{
+            // positions
+            {
+                .BufferLocation = geometryDataAddress + sectionOffsets[3],
+                .SizeInBytes = UINT(sectionSizes[3]),
+                .StrideInBytes = UINT(sizeof(float) * 3U)
+            },
+            // instances
+            {
+                .BufferLocation = geometryDataAddress + sectionOffsets[4],
+                .SizeInBytes = UINT(sectionSizes[4]),
+                .StrideInBytes = UINT(sizeof(instances[0]))
+            }
+        };
+
+        const D3D12_INDEX_BUFFER_VIEW indexBufferView{
+            .BufferLocation = geometryDataAddress + sectionOffsets[5],
+            .SizeInBytes = UINT(sectionSizes[5]),
+            .Format = DXGI_FORMAT_R32_UINT
+        };
+
+        LARGE_INTEGER frequency{ };
+        QueryPerformanceFrequency(&frequency);
+        double recordingTimes[GEOMETRY_PIPELINE_COUNT]{ };
+
+        for (UINT pipeline = 0; pipeline < GEOMETRY_PIPELINE_COUNT; ++pipeline)
+        {
+            commandList->ClearRenderTargetView(target.rtvHandle, clearColor, 0, nullptr);
+            commandList->ClearDepthStencilView(target.dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+            commandList->EndQuery(target.queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, pipeline * 2U);
+
+            // Only the commands that submit the geometry are timed on the CPU
+            LARGE_INTEGER beginTime{ }, endTime{ };
+            QueryPerformanceCounter(&beginTime);
+
+            commandList->SetPipelineState(pipelineStates[pipeline]);
+
+            const UINT passConstants[2] = { 0U, pipeline * MESHLET_CULLING_COUNTER_COUNT };     // culling disabled
+            commandList->SetGraphicsRoot32BitConstants(1, 2, passConstants, 0);      // rootParameters[1]
+
+            if (pipeline == GEOMETRY_PIPELINE_INPUT_ASSEMBLER)
+            {
+                commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+                commandList->IASetVertexBuffers(0, (UINT)std::size(vertexBufferViews), vertexBufferViews);
+                commandList->IASetIndexBuffer(&indexBufferView);
+            }
+
+            for (UINT iteration = 0; iteration < GEOMETRY_BENCHMARK_ITERATION_COUNT; ++iteration)
+            {
+                if (pipeline == GEOMETRY_PIPELINE_INPUT_ASSEMBLER) {
+                    commandList->DrawIndexedInstanced(UINT(mesh.indices.size()), constants.instanceCount, 0, 0, 0);
+                }
+                else if (pipeline == GEOMETRY_PIPELINE_AMPLIFICATION_MESH_SHADER) {
+                    ((ID3D12GraphicsCommandList6*)commandList)->DispatchMesh(amplificationGroupCount, 1U, 1U);
+                }
+                else {
+                    commandList->ExecuteIndirect(commandSignature, 1U, geometryDataBuffer, sectionOffsets[6], nullptr, 0U);
+                }
+            }
+
+            QueryPerformanceCounter(&endTime);
+            recordingTimes[pipeline] = double(endTime.QuadPart - beginTime.QuadPart) * 1000000.0 / double(frequency.QuadPart);
+
+            commandList->EndQuery(target.queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, pipeline * 2U + 1U);
+
+            // One untimed draw through the shaders with the statistics counters checks the triangles that a timed draw emits
+            if (countingPipelineStates[pipeline] != nullptr)
+            {
+                commandList->SetPipelineState(countingPipelineStates[pipeline]);
+                if (pipeline == GEOMETRY_PIPELINE_AMPLIFICATION_MESH_SHADER) {
+                    ((ID3D12GraphicsCommandList6*)commandList)->DispatchMesh(amplificationGroupCount, 1U, 1U);
+                }
+                else {
+                    commandList->ExecuteIndirect(commandSignature, 1U, geometryDataBuffer, sectionOffsets[6], nullptr, 0U);
+                }
+            }
+        }
+
+        SyncAndReadFromDeviceResource(commandList, counterBufferSize, counterReadbackBuffer, counterBuffer);
+
+        UINT64 timestampFrequency = 0;
+        if (!ExecuteOffscreenBenchmark(commandQueue, target, "geometry benchmark", timestampFrequency)) break;
+
+        const UINT* counters = nullptr;
+        hRes = counterReadbackBuffer->Map(0, nullptr, (void**)&counters);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map geometry benchmark counter read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        const UINT64* timestamps = nullptr;
+        hRes = target.timestampReadbackBuffer->Map(0, nullptr, (void**)&timestamps);
+        if (FAILED(hRes))
+        {
+            counterReadbackBuffer->Unmap(0, nullptr);
+            fprintf(stderr, "Map geometry benchmark timestamp read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        printf("Geometry pipeline benchmark: %zu triangles x %u instances, %u meshlets per instance, %u iterations\n",
+                mesh.indices.size() / 3U, constants.instanceCount, constants.meshletCount, GEOMETRY_BENCHMARK_ITERATION_COUNT);
+        for (UINT pipeline = 0; pipeline < GEOMETRY_PIPELINE_COUNT; ++pipeline)
+        {
+            const double gpuTime = double(timestamps[pipeline * 2U + 1U] - timestamps[pipeline * 2U]) / double(timestampFrequency) / GEOMETRY_BENCHMARK_ITERATION_COUNT;
+            printf("    %-28s GPU: %.3f ms, %.1f M triangles/s, CPU recording: %.2f us per iteration",
+                    pipelineNames[pipeline], gpuTime * 1000.0, gpuTime > 0.0 ? double(triangleCount) / gpuTime / 1000000.0 : 0.0,
+                    recordingTimes[pipeline] / GEOMETRY_BENCHMARK_ITERATION_COUNT);
+
+            // The counting draw of the mesh shaders counts the triangles that they emit
+            if (countingPipelineStates[pipeline] != nullptr)
+            {
+                const UINT64 emittedTriangleCount = counters[pipeline * MESHLET_CULLING_COUNTER_COUNT + MESHLET_CULLING_TRIANGLE_COUNTER];
+                printf(", emitted triangles: %llu%s", emittedTriangleCount, emittedTriangleCount == triangleCount ? "" : " (MISMATCH)");
+            }
+            printf("\n");
+        }
+
+        target.timestampReadbackBuffer->Unmap(0, nullptr);
+        counterReadbackBuffer->Unmap(0, nullptr);
+
+        success = true;
+    }
+    while (false);
+
+    if (rootSignature != nullptr) {
+        rootSignature->Release();
+    }
+    for (ID3D12PipelineState* pipelineState : pipelineStates)
+    {
+        if (pipelineState != nullptr) {
+            pipelineState->Release();
+        }
+    }
+    for (ID3D12PipelineState* pipelineState : countingPipelineStates)
+    {
+        if (pipelineState != nullptr) {
+            pipelineState->Release();
+        }
+    }
+    if (commandSignature != nullptr) {
+        commandSignature->Release();
+    }
+    ReleaseOffscreenBenchmarkTarget(target);
+    if (uploadDevHostBuffer != nullptr) {
+        uploadDevHostBuffer->Release();
+    }
+    if (geometryDataBuffer != nullptr) {
+        geometryDataBuffer->Release();
+    }
+    if (counterBuffer != nullptr) {
+        counterBuffer->Release();
+    }
+    if (counterReadbackBuffer != nullptr) {
+        counterReadbackBuffer->Release();
+    }
+
+    return success;
+}
+
+#if RUN_LOD_BENCHMARK
+// Only b0 for the view projection that geometry_benchmark.vert.hlsl reads, everything else comes from the input assembler
+static auto CreateRootSignatureForLodBenchmark(ID3D12Device* d3d_device) -> ID3D12RootSignature*
+{
+    ID3D12RootSignature* rootSignature = nullptr;
+
+    const D3D12_ROOT_PARAMETER rootParameters[]{
+        // b0: culling constants
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV,
+            .Descriptor { .ShaderRegister = 0, .RegisterSpace = 0 },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX
+        }
+    };
+
+    const D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {
+        .NumParameters = UINT(std::size(rootParameters)),
+        .pParameters = rootParameters,
+        .NumStaticSamplers = 0,
+        .pStaticSamplers = nullptr,
+        .Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT |
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS |
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS |
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS |
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_PIXEL_SHADER_ROOT_ACCESS
+    };
+
+    ID3DBlob* signature = nullptr;
+    ID3DBlob* error = nullptr;
+    HRESULT hRes = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error);
+    do
+    {
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "D3D12SerializeRootSignature for LOD benchmark failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateRootSignature for LOD benchmark failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (signature != nullptr) {
+        signature->Release();
+    }
+    if (error != nullptr) {
+        error->Release();
+    }
+
+    if (FAILED(hRes)) return nullptr;
+
+    return rootSignature;
+}
+
+// Rows of instances from the camera of CreateMeshletCullingConstants to the far plane. xyz: translation, w: uniform scale
+static auto CreateLodBenchmarkInstances() -> std::vector<std::array<float, 4>>
+{
+    std::vector<std::array<float, 4>> instances;
+    for (UINT row = 0; row < LOD_BENCHMARK_GRID_SIZE; ++row)
+    {
+        for (UINT column = 0; column < LOD_BENCHMARK_GRID_SIZE; ++column)
+        {
+            const float x = (float(column) - float(LOD_BENCHMARK_GRID_SIZE - 1U) * 0.5f) * 2.5f;
+            const float z = -2.0f - float(row) * (MESHLET_CULLING_FAR_PLANE - 4.0f) / float(LOD_BENCHMARK_GRID_SIZE - 1U);
+            instances.push_back({ x, 0.0f, z, 1.0f });
+        }
+    }
+    return instances;
+}
+
+// Selects the level of detail of every instance from the distance between the camera and the bounding sphere of the mesh,
+// and sorts the instances by level, so that the instances of one level are drawn by one DrawIndexedInstanced().
+// @return the draw arguments of every level, with an InstanceCount of 0 for the unused ones
+static auto SelectLodBenchmarkLods(const MeshLodChain& chain, float meshRadius, const MeshletCullingConstants& constants,
+                                    const std::vector<std::array<float, 4>>& instances, std::vector<std::array<float, 4>>& sortedInstances) ->
+                                    std::vector<D3D12_DRAW_INDEXED_ARGUMENTS>
+{
+    // The view matrix of CreateMeshletCullingConstants only translates, so m[1][1] of the view projection is the one of the projection
+    const float projectionScale = constants.viewProjection[1][1];
+
+    std::vector<uint32_t> instanceLods(instances.size());
+    std::vector<D3D12_DRAW_INDEXED_ARGUMENTS> drawArguments(chain.lods.size());
+    for (size_t i = 0; i < instances.size(); ++i)
+    {
+        const std::array<float, 4>& instance = instances[i];
+        const float view[3] = { instance[0] - constants.cameraPosition[0], instance[1] - constants.cameraPosition[1], instance[2] - constants.cameraPosition[2] };
+        const float distance = (std::max)(std::sqrt(view[0] * view[0] + view[1] * view[1] + view[2] * view[2]) - meshRadius * instance[3], MESHLET_CULLING_NEAR_PLANE);
+
+        instanceLods[i] = SelectMeshLod(chain, distance / instance[3], projectionScale, float(MESHLET_CULLING_TARGET_SIZE), LOD_BENCHMARK_MAX_PIXEL_ERROR);
+        ++drawArguments[instanceLods[i]].InstanceCount;
+    }
+
+    UINT startInstance = 0;
+    for (size_t lod = 0; lod < chain.lods.size(); ++lod)
+    {
+        drawArguments[lod].IndexCountPerInstance = chain.lods[lod].indexCount;
+        drawArguments[lod].StartIndexLocation = chain.lods[lod].indexOffset;
+        drawArguments[lod].BaseVertexLocation = 0;
+        drawArguments[lod].StartInstanceLocation = startInstance;
+        startInstance += drawArguments[lod].InstanceCount;
+    }
+
+    sortedInstances.resize(instances.size());
+    std::vector<UINT> cursors(chain.lods.size());
+    for (size_t lod = 0; lod < chain.lods.size(); ++lod) {
+        cursors[lod] = drawArguments[lod].StartInstanceLocation;
+    }
+    for (size_t i = 0; i < instances.size(); ++i) {
+        sortedInstances[cursors[instanceLods[i]]++] = instances[i];
+    }
+
+    return drawArguments;
+}
+
+// Builds the levels of detail of the mesh and renders LOD_BENCHMARK_GRID_SIZE x LOD_BENCHMARK_GRID_SIZE instances of it
+// in full detail, with one DrawIndexedInstanced() per selected level and with one ExecuteIndirect() of the draw arguments of all levels,
+// LOD_BENCHMARK_ITERATION_COUNT times each, and reports the GPU time and the triangles submitted per pass.
+static auto RunLodBenchmark(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, const MeshletTestMesh& mesh) -> bool
+{
+    enum LOD_PASS_ID
+    {
+        LOD_PASS_FULL_DETAIL,
+        LOD_PASS_DRAW_PER_LOD,
+        LOD_PASS_EXECUTE_INDIRECT,
+
+        LOD_PASS_COUNT
+    };
+
+    const char* const passNames[LOD_PASS_COUNT] = { "Full detail", "DrawIndexedInstanced per LOD", "ExecuteIndirect" };
+
+    LARGE_INTEGER frequency{ };
+    QueryPerformanceFrequency(&frequency);
+    LARGE_INTEGER beginTime{ }, endTime{ };
+
+    QueryPerformanceCounter(&beginTime);
+    const MeshLodChain chain = BuildMeshLodChain(MeshletSourceMesh{
+            .positions = mesh.positions.data(),
+            .positionStride = uint32_t(sizeof(float) * 3U),
+            .vertexCount = uint32_t(mesh.positions.size() / 3U),
+            .indices = mesh.indices.data(),
+            .indexCount = uint32_t(mesh.indices.size())
+        }, LOD_BENCHMARK_LOD_COUNT, LOD_BENCHMARK_REDUCTION_RATIO);
+    QueryPerformanceCounter(&endTime);
+    const double buildTime = double(endTime.QuadPart - beginTime.QuadPart) * 1000.0 / double(frequency.QuadPart);
+
+    float meshRadius = 0.0f;
+    for (size_t i = 0; i + 2U < mesh.positions.size(); i += 3U) {
+        meshRadius = (std::max)(meshRadius, std::sqrt(mesh.positions[i] * mesh.positions[i] + mesh.positions[i + 1U] * mesh.positions[i + 1U] + mesh.positions[i + 2U] * mesh.positions[i + 2U]));
+    }
+
+    const std::vector<std::array<float, 4>> instances = CreateLodBenchmarkInstances();
+    const MeshletCullingConstants constants = CreateMeshletCullingConstants(0U, uint32_t(instances.size()));
+
+    std::vector<std::array<float, 4>> sortedInstances;
+    QueryPerformanceCounter(&beginTime);
+    const std::vector<D3D12_DRAW_INDEXED_ARGUMENTS> drawArguments = SelectLodBenchmarkLods(chain, meshRadius, constants, instances, sortedInstances);
+    QueryPerformanceCounter(&endTime);
+    const double selectionTime = double(endTime.QuadPart - beginTime.QuadPart) * 1000000.0 / double(frequency.QuadPart);
+
+    UINT64 triangleCounts[LOD_PASS_COUNT]{ };
+    triangleCounts[LOD_PASS_FULL_DETAIL] = UINT64(chain.lods.empty() ? 0U : chain.lods[0].indexCount / 3U) * instances.size();
+    for (const D3D12_DRAW_INDEXED_ARGUMENTS& arguments : drawArguments) {
+        triangleCounts[LOD_PASS_DRAW_PER_LOD] += UINT64(arguments.IndexCountPerInstance / 3U) * arguments.InstanceCount;
+    }
+    triangleCounts[LOD_PASS_EXECUTE_INDIRECT] = triangleCounts[LOD_PASS_DRAW_PER_LOD];
+
+    // Sections of the geometry data buffer: positions, instances sorted by level (vertex buffers), indices of all levels (index buffer),
+    // draw arguments of all levels (indirect argument buffer)
+    constexpr int sectionCount = 4;
+    const size_t sectionSizes[sectionCount] = {
+        mesh.positions.size() * sizeof(float),
+        sortedInstances.size() * sizeof(sortedInstances[0]),
+        chain.indices.size() * sizeof(uint32_t),
+        drawArguments.size() * sizeof(D3D12_DRAW_INDEXED_ARGUMENTS)
+    };
+    const void* sectionData[sectionCount] = { mesh.positions.data(), sortedInstances.data(), chain.indices.data(), drawArguments.data() };
+    size_t sectionOffsets[sectionCount]{ };
+    size_t geometryDataSize = 0;
+    for (int i = 0; i < sectionCount; ++i)
+    {
+        sectionOffsets[i] = geometryDataSize;
+        geometryDataSize += (sectionSizes[i] + CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U) & ~size_t(CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U);
+    }
+
+    constexpr UINT timestampCount = LOD_PASS_COUNT * 2U;
+
+    const size_t constantBufferSize = (sizeof(MeshletCullingConstants) + CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U) & ~size_t(CONSTANT_BUFFER_ALLOCATION_GRANULARITY - 1U);
+    const size_t uploadBufferSize = constantBufferSize + geometryDataSize;
+
+    ID3D12RootSignature* rootSignature = nullptr;
+    ID3D12PipelineState* pipelineState = nullptr;
+    ID3D12CommandSignature* commandSignature = nullptr;
+    OffscreenBenchmarkTarget target{ };
+    ID3D12Resource* uploadDevHostBuffer = nullptr;
+    ID3D12Resource* geometryDataBuffer = nullptr;
+    bool success = false;
+
+    do
+    {
+        if (chain.lods.empty() || instances.empty()) break;
+
+        rootSignature = CreateRootSignatureForLodBenchmark(d3d_device);
+        if (rootSignature == nullptr) break;
+
+        pipelineState = CreatePipelineStateForGeometryBenchmarkVertexShader(d3d_device, rootSignature);
+        if (pipelineState == nullptr) break;
+
+        const D3D12_INDIRECT_ARGUMENT_DESC argumentDescList[]{
+            {
+                .Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED
+            }
+        };
+
+        const D3D12_COMMAND_SIGNATURE_DESC commandSignatureDesc{
+            .ByteStride = (UINT)sizeof(D3D12_DRAW_INDEXED_ARGUMENTS),
+            .NumArgumentDescs = (UINT)std::size(argumentDescList),
+            .pArgumentDescs = argumentDescList,
+            .NodeMask = 0U
+        };
+
+        HRESULT hRes = d3d_device->CreateCommandSignature(&commandSignatureDesc, nullptr, IID_PPV_ARGS(&commandSignature));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommandSignature for LOD benchmark failed: %ld\n", hRes);
+            break;
+        }
+
+        constexpr FLOAT clearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
+        if (!CreateOffscreenBenchmarkTarget(d3d_device, commandAllocator, nullptr, MESHLET_CULLING_TARGET_SIZE, MESHLET_CULLING_TARGET_SIZE,
+                                            clearColor, timestampCount, "LOD benchmark", target)) break;
+
+        ID3D12GraphicsCommandList* const commandList = target.commandList;
+
+        const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+            .Type = D3D12_HEAP_TYPE_DEFAULT,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
+
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = defaultHeapProperties;
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_RESOURCE_DESC bufferDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0,
+            .Width = uploadBufferSize,
+            .Height = 1U,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {.Count = 1U, .Quality = 0 },
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE
+        };
+        hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadDevHostBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for LOD benchmark upload buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = geometryDataSize;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&geometryDataBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for LOD benchmark data buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        void* hostMemPtr = nullptr;
+        hRes = uploadDevHostBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map LOD benchmark upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        memcpy(hostMemPtr, &constants, sizeof(constants));
+        for (int i = 0; i < sectionCount; ++i) {
+            memcpy((void*)(uintptr_t(hostMemPtr) + constantBufferSize + sectionOffsets[i]), sectionData[i], sectionSizes[i]);
+        }
+        uploadDevHostBuffer->Unmap(0, nullptr);
+
+        // GENERIC_READ covers the vertex, index and indirect argument uses of the geometry data buffer
+        WriteToDeviceResourceAndSync(commandList, geometryDataBuffer, uploadDevHostBuffer, 0U, constantBufferSize, geometryDataSize);
+
+        SetOffscreenBenchmarkTarget(target);
+
+        const D3D12_GPU_VIRTUAL_ADDRESS geometryDataAddress = geometryDataBuffer->GetGPUVirtualAddress();
+        commandList->SetGraphicsRootSignature(rootSignature);
+        commandList->SetGraphicsRootConstantBufferView(0, uploadDevHostBuffer->GetGPUVirtualAddress());    // rootParameters[0]
+
+        const D3D12_VERTEX_BUFFER_VIEW vertexBufferViews[]{
+            // positions
+            {
+                .BufferLocation = geometryDataAddress + sectionOffsets[0],
+                .SizeInBytes = UINT(sectionSizes[0]),
+                .StrideInBytes = UINT(sizeof(float) * 3U)
+            },
+            // instances
+            {
+                .BufferLocation = geometryDataAddress + sectionOffsets[1],
+                .SizeInBytes = UINT(sectionSizes[1]),
+                .StrideInBytes = UINT(sizeof(sortedInstances[0]))
+            }
+        };
+
+        const D3D12_INDEX_BUFFER_VIEW indexBufferView{
+            .BufferLocation = geometryDataAddress + sectionOffsets[2],
+            .SizeInBytes = UINT(sectionSizes[2]),
+            .Format = DXGI_FORMAT_R32_UINT
+        };
+
+        commandList->SetPipelineState(pipelineState);
+        commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        commandList->IASetVertexBuffers(0, (UINT)std::size(vertexBufferViews), vertexBufferViews);
+        commandList->IASetIndexBuffer(&indexBufferView);
+
+        for (UINT pass = 0; pass < LOD_PASS_COUNT; ++pass)
+        {
+            commandList->ClearRenderTargetView(target.rtvHandle, clearColor, 0, nullptr);
+            commandList->ClearDepthStencilView(target.dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+            commandList->EndQuery(target.queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, pass * 2U);
+
+            for (UINT iteration = 0; iteration < LOD_BENCHMARK_ITERATION_COUNT; ++iteration)
+            {
+                if (pass == LOD_PASS_FULL_DETAIL) {
+                    commandList->DrawIndexedInstanced(chain.lods[0].indexCount, UINT(sortedInstances.size()), 0, 0, 0);
+                }
+                else if (pass == LOD_PASS_DRAW_PER_LOD)
+                {
+                    for (const D3D12_DRAW_INDEXED_ARGUMENTS& arguments : drawArguments)
+                    {
+                        if (arguments.InstanceCount == 0U) continue;
+                        commandList->DrawIndexedInstanced(arguments.IndexCountPerInstance, arguments.InstanceCount, arguments.StartIndexLocation,
+                                                        arguments.BaseVertexLocation, arguments.StartInstanceLocation);
+                    }
+                }
+                else {
+                    commandList->ExecuteIndirect(commandSignature, UINT(drawArguments.size()), geometryDataBuffer, sectionOffsets[3], nullptr, 0U);
+                }
+            }
+
+            commandList->EndQuery(target.queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, pass * 2U + 1U);
+        }
+
+        UINT64 timestampFrequency = 0;
+        if (!ExecuteOffscreenBenchmark(commandQueue, target, "LOD benchmark", timestampFrequency)) break;
+
+        const UINT64* timestamps = nullptr;
+        hRes = target.timestampReadbackBuffer->Map(0, nullptr, (void**)&timestamps);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map LOD benchmark timestamp read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        printf("LOD benchmark: %s with %zu levels built in %.2f ms, %zu instances, LOD selection: %.2f us, %u iterations\n",
+                mesh.name, chain.lods.size(), buildTime, instances.size(), selectionTime, LOD_BENCHMARK_ITERATION_COUNT);
+        for (size_t lod = 0; lod < chain.lods.size(); ++lod)
+        {
+            printf("    LOD %zu: %u triangles, geometric error: %.5f, instances: %u\n",
+                    lod, chain.lods[lod].indexCount / 3U, chain.lods[lod].geometricError, drawArguments[lod].InstanceCount);
+        }
+        for (UINT pass = 0; pass < LOD_PASS_COUNT; ++pass)
+        {
+            const double gpuTime = double(timestamps[pass * 2U + 1U] - timestamps[pass * 2U]) / double(timestampFrequency) / LOD_BENCHMARK_ITERATION_COUNT;
+            printf("    %-28s GPU: %.3f ms, triangles: %llu\n", passNames[pass], gpuTime * 1000.0, triangleCounts[pass]);
+        }
+
+        target.timestampReadbackBuffer->Unmap(0, nullptr);
+
+        success = true;
+    }
+    while (false);
+
+    if (rootSignature != nullptr) {
+        rootSignature->Release();
+    }
+    if (pipelineState != nullptr) {
+        pipelineState->Release();
+    }
+    if (commandSignature != nullptr) {
+        commandSignature->Release();
+    }
+    ReleaseOffscreenBenchmarkTarget(target);
+    if (uploadDevHostBuffer != nullptr) {
+        uploadDevHostBuffer->Release();
+    }
+    if (geometryDataBuffer != nullptr) {
+        geometryDataBuffer->Release();
+    }
+
+    return success;
+}
+#endif
+#endif
+#endif
 
 static auto CreateMeshShaderBasicRootSignature(MeshShaderExecMode execMode, ID3D12Device *d3d_device) -> ID3D12RootSignature*
 {
@@ -293,7 +2013,7 @@ static auto PopulateMeshShaderCommandBundleList(MeshShaderExecMode execMode, ID3
     return true;
 }
 
-auto CreateMeshShaderTestAssets(MeshShaderExecMode execMode, ID3D12Device* d3d_device, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
+auto CreateMeshShaderTestAssets(MeshShaderExecMode execMode, ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
                                 std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*>
 {
     ID3D12RootSignature* rootSignature = nullptr;
@@ -303,6 +2023,32 @@ auto CreateMeshShaderTestAssets(MeshShaderExecMode execMode, ID3D12Device* d3d_d
 
     std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*> result = std::make_tuple(rootSignature, pipelineState, commandList, commandBundleList);
 
+#if BUILD_TEST_MESHLETS
+    if (execMode == MeshShaderExecMode::BASIC_MODE)
+    {
+        const std::vector<MeshletTestMesh> testMeshes = CreateMeshletTestMeshes();
+        const std::vector<MeshletMesh> meshletMeshes = BuildTestMeshlets(testMeshes);
+
+#if TEST_MESHLET_CULLING
+        if (!RunMeshletCullingTest(d3d_device, commandQueue, commandAllocator, testMeshes[MESHLET_CULLING_MESH_INDEX], meshletMeshes[MESHLET_CULLING_MESH_INDEX])) {
+            fprintf(stderr, "Meshlet culling test failed!\n");
+        }
+#endif
+
+#if TEST_MESHLET_CULLING && RUN_GEOMETRY_PIPELINE_BENCHMARK
+        if (!RunGeometryPipelineBenchmark(d3d_device, commandQueue, commandAllocator)) {
+            fprintf(stderr, "Geometry pipeline benchmark failed!\n");
+        }
+#endif
+
+#if TEST_MESHLET_CULLING && RUN_GEOMETRY_PIPELINE_BENCHMARK && RUN_LOD_BENCHMARK
+        if (!RunLodBenchmark(d3d_device, commandQueue, commandAllocator, testMeshes[MESHLET_CULLING_MESH_INDEX])) {
+            fprintf(stderr, "LOD benchmark failed!\n");
+        }
+#endif
+    }
+#endif
+
     rootSignature = CreateMeshShaderBasicRootSignature(execMode, d3d_device);
     if (rootSignature == nullptr) return result;
 
@@ -0,0 +1,420 @@
+#include "Meshlet.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+// Number of triangles after the first unused one that are searched for the nearest seed
+// when a meshlet runs out of adjacent triangles (e.g. at the end of a disconnected part of the mesh)
+static constexpr uint32_t MESHLET_SEED_SEARCH_WINDOW = 1024U;
+
+// Below this cosine of the normal cone half angle, the meshlet is never back-face culled
+static constexpr float MESHLET_MIN_CONE_COSINE = 0.1f;
+
+static constexpr uint8_t MESHLET_SERIALIZATION_MAGIC[4] = { 'M', 'S', 'H', 'L' };
+
+static auto EncodeSnorm8(float value) -> uint32_t
+{
+    return uint32_t(uint8_t(int8_t(std::lround(std::clamp(value, -1.0f, 1.0f) * 127.0f))));
+}
+
+static auto DecodeSnorm8(uint32_t value) -> float
+{
+    return std::max(float(int8_t(uint8_t(value))) / 127.0f, -1.0f);
+}
+
+auto DecodeMeshletNormalCone(uint32_t normalCone, float axis[3], float* cutoff) -> void
+{
+    float x = DecodeSnorm8(normalCone & 0xffU);
+    float y = DecodeSnorm8((normalCone >> 8) & 0xffU);
+    float z = DecodeSnorm8((normalCone >> 16) & 0xffU);
+    const float length = std::sqrt(x * x + y * y + z * z);
+    if (length > 0.0f)
+    {
+        x /= length;
+        y /= length;
+        z /= length;
+    }
+
+    axis[0] = x;
+    axis[1] = y;
+    axis[2] = z;
+    *cutoff = DecodeSnorm8(normalCone >> 24);
+}
+
+// Ritter's bounding sphere
+static auto ComputeMeshletBoundingSphere(const MeshletSourceMesh& mesh, const uint32_t* vertices, uint32_t vertexCount, float sphere[4]) -> void
+{
+    auto const position = [&mesh](uint32_t vertex) -> const float* {
+        return (const float*)((const uint8_t*)mesh.positions + size_t(vertex) * mesh.positionStride);
+    };
+    auto const distanceSquared = [](const float* a, const float* b) -> float {
+        return (a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) + (a[2] - b[2]) * (a[2] - b[2]);
+    };
+    auto const farthest = [&](const float* from) -> const float* {
+        const float* result = from;
+        float maxDistance = 0.0f;
+        for (uint32_t i = 0U; i < vertexCount; ++i)
+        {
+            const float distance = distanceSquared(from, position(vertices[i]));
+            if (distance > maxDistance)
+            {
+                maxDistance = distance;
+                result = position(vertices[i]);
+            }
+        }
+        return result;
+    };
+
+    const float* p0 = farthest(position(vertices[0]));
+    const float* p1 = farthest(p0);
+
+    float center[3] = { (p0[0] + p1[0]) * 0.5f, (p0[1] + p1[1]) * 0.5f, (p0[2] + p1[2]) * 0.5f };
+    float radius = std::sqrt(distanceSquared(p0, p1)) * 0.5f;
+
+    for (uint32_t i = 0U; i < vertexCount; ++i)
+    {
+        const float* p = position(vertices[i]);
+        const float distance = std::sqrt(distanceSquared(center, p));
+        if (distance <= radius) continue;
+
+        // Grow the sphere just enough to contain p
+        const float newRadius = (radius + distance) * 0.5f;
+        const float k = (newRadius - radius) / distance;
+        for (int c = 0; c < 3; ++c) {
+            center[c] += (p[c] - center[c]) * k;
+        }
+        radius = newRadius;
+    }
+
+    sphere[0] = center[0];
+    sphere[1] = center[1];
+    sphere[2] = center[2];
+    sphere[3] = radius;
+}
+
+static auto ComputeMeshletNormalCone(const MeshletSourceMesh& mesh, const uint32_t* vertices, const uint32_t* primitives, uint32_t primitiveCount) -> uint32_t
+{
+    auto const position = [&mesh](uint32_t vertex) -> const float* {
+        return (const float*)((const uint8_t*)mesh.positions + size_t(vertex) * mesh.positionStride);
+    };
+
+    const uint32_t noCulling = EncodeSnorm8(1.0f) << 24;
+
+    std::vector<float> normals;
+    normals.reserve(size_t(primitiveCount) * 3U);
+    float axis[3] = { 0.0f, 0.0f, 0.0f };
+
+    for (uint32_t i = 0U; i < primitiveCount; ++i)
+    {
+        const float* p0 = position(vertices[primitives[i] & 0xffU]);
+        const float* p1 = position(vertices[(primitives[i] >> 8) & 0xffU]);
+        const float* p2 = position(vertices[(primitives[i] >> 16) & 0xffU]);
+
+        const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+        float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+
+        // Degenerate triangles are never rasterized, so they do not constrain the cone
+        const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length == 0.0f) continue;
+
+        for (int c = 0; c < 3; ++c)
+        {
+            n[c] /= length;
+            axis[c] += n[c];
+            normals.push_back(n[c]);
+        }
+    }
+
+    const float axisLength = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    if (normals.empty() || axisLength == 0.0f) return noCulling;
+
+    // Measure the spread of the normals against the quantized axis that the shaders will use
+    const uint32_t encodedAxis = EncodeSnorm8(axis[0] / axisLength) | (EncodeSnorm8(axis[1] / axisLength) << 8) | (EncodeSnorm8(axis[2] / axisLength) << 16);
+    float decodedAxis[3], unusedCutoff;
+    DecodeMeshletNormalCone(encodedAxis, decodedAxis, &unusedCutoff);
+
+    float minDot = 1.0f;
+    for (size_t i = 0; i < normals.size(); i += 3) {
+        minDot = std::min(minDot, normals[i + 0] * decodedAxis[0] + normals[i + 1] * decodedAxis[1] + normals[i + 2] * decodedAxis[2]);
+    }
+    if (minDot <= MESHLET_MIN_CONE_COSINE) return noCulling;
+
+    // The cone of view directions that see only back faces is the normal cone widened by 90 degrees,
+    // so its cutoff is cos(90 - angle) = sin(angle). Round up to stay conservative after quantization.
+    const float cutoff = std::sqrt(1.0f - minDot * minDot);
+    const uint32_t encodedCutoff = uint32_t(std::min(std::ceil(cutoff * 127.0f), 127.0f));
+
+    return encodedAxis | (encodedCutoff << 24);
+}
+
+auto BuildMeshletMesh(const MeshletSourceMesh& mesh, uint32_t maxVertexCount, uint32_t maxPrimitiveCount) -> MeshletMesh
+{
+    maxVertexCount = std::clamp(maxVertexCount, 3U, MESHLET_MAX_VERTEX_COUNT);
+    maxPrimitiveCount = std::clamp(maxPrimitiveCount, 1U, MESHLET_MAX_PRIMITIVE_COUNT);
+
+    MeshletMesh result{ };
+    const uint32_t triangleCount = mesh.indexCount / 3U;
+    if (triangleCount == 0U) return result;
+
+    auto const position = [&mesh](uint32_t vertex) -> const float* {
+        return (const float*)((const uint8_t*)mesh.positions + size_t(vertex) * mesh.positionStride);
+    };
+
+    // Vertex to triangle adjacency. The first liveTriangleCounts[v] entries of each list are the triangles
+    // that are not in any meshlet yet, so the neighbourhood search only visits the border of the meshlet.
+    std::vector<uint32_t> adjacencyOffsets(size_t(mesh.vertexCount) + 1U, 0U);
+    std::vector<uint32_t> liveTriangleCounts(mesh.vertexCount, 0U);
+    for (uint32_t i = 0U; i < triangleCount * 3U; ++i) {
+        ++liveTriangleCounts[mesh.indices[i]];
+    }
+    for (uint32_t v = 0U; v < mesh.vertexCount; ++v) {
+        adjacencyOffsets[v + 1U] = adjacencyOffsets[v] + liveTriangleCounts[v];
+    }
+
+    std::vector<uint32_t> adjacency(size_t(triangleCount) * 3U);
+    std::fill(liveTriangleCounts.begin(), liveTriangleCounts.end(), 0U);
+    for (uint32_t t = 0U; t < triangleCount; ++t)
+    {
+        for (uint32_t c = 0U; c < 3U; ++c)
+        {
+            const uint32_t v = mesh.indices[t * 3U + c];
+            adjacency[adjacencyOffsets[v] + liveTriangleCounts[v]++] = t;
+        }
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint16_t> localIndices(mesh.vertexCount, UINT16_MAX);   // UINT16_MAX: not in the current meshlet
+    std::vector<uint32_t> meshletVertices;
+    std::vector<uint32_t> meshletPrimitives;
+    float meshletCentroid[3] = { 0.0f, 0.0f, 0.0f };    // sum of the vertex positions
+    uint32_t seedCursor = 0U;                           // every triangle before it is emitted
+
+    meshletVertices.reserve(maxVertexCount);
+    meshletPrimitives.reserve(maxPrimitiveCount);
+
+    auto const newVertexCount = [&](uint32_t triangle) -> uint32_t {
+        const uint32_t* tri = &mesh.indices[triangle * 3U];
+        uint32_t count = 0U;
+        for (uint32_t c = 0U; c < 3U; ++c) {
+            // Repeated indices of a degenerate triangle count once
+            if (localIndices[tri[c]] == UINT16_MAX && (c < 1U || tri[c] != tri[0]) && (c < 2U || tri[c] != tri[1])) ++count;
+        }
+        return count;
+    };
+
+    auto const flushMeshlet = [&]() {
+        if (meshletPrimitives.empty()) return;
+
+        MeshletDesc desc{
+            .vertexOffset = uint32_t(result.vertexIndices.size()),
+            .vertexCount = uint32_t(meshletVertices.size()),
+            .primitiveOffset = uint32_t(result.primitives.size()),
+            .primitiveCount = uint32_t(meshletPrimitives.size()),
+            .boundingSphere { },
+            .normalCone = ComputeMeshletNormalCone(mesh, meshletVertices.data(), meshletPrimitives.data(), uint32_t(meshletPrimitives.size()))
+        };
+        ComputeMeshletBoundingSphere(mesh, meshletVertices.data(), uint32_t(meshletVertices.size()), desc.boundingSphere);
+
+        result.meshlets.push_back(desc);
+        result.vertexIndices.insert(result.vertexIndices.end(), meshletVertices.begin(), meshletVertices.end());
+        result.primitives.insert(result.primitives.end(), meshletPrimitives.begin(), meshletPrimitives.end());
+
+        for (const uint32_t v : meshletVertices) {
+            localIndices[v] = UINT16_MAX;
+        }
+        meshletVertices.clear();
+        meshletPrimitives.clear();
+        meshletCentroid[0] = meshletCentroid[1] = meshletCentroid[2] = 0.0f;
+    };
+
+    for (uint32_t emittedCount = 0U; emittedCount < triangleCount; ++emittedCount)
+    {
+        // Prefer the adjacent triangle that adds the fewest vertices, then the one whose vertices have the fewest
+        // remaining triangles, so that vertices are used up inside the meshlet instead of being duplicated into the next one.
+        uint32_t bestTriangle = UINT32_MAX;
+        uint32_t bestNewVertexCount = UINT32_MAX;
+        uint32_t bestLiveCount = UINT32_MAX;
+        for (const uint32_t v : meshletVertices)
+        {
+            for (uint32_t i = 0U; i < liveTriangleCounts[v]; ++i)
+            {
+                const uint32_t triangle = adjacency[adjacencyOffsets[v] + i];
+                const uint32_t* tri = &mesh.indices[triangle * 3U];
+                const uint32_t newCount = newVertexCount(triangle);
+                const uint32_t liveCount = liveTriangleCounts[tri[0]] + liveTriangleCounts[tri[1]] + liveTriangleCounts[tri[2]];
+                if (newCount < bestNewVertexCount || (newCount == bestNewVertexCount && liveCount < bestLiveCount))
+                {
+                    bestTriangle = triangle;
+                    bestNewVertexCount = newCount;
+                    bestLiveCount = liveCount;
+                }
+            }
+        }
+
+        if (bestTriangle == UINT32_MAX)
+        {
+            while (emitted[seedCursor]) ++seedCursor;
+            bestTriangle = seedCursor;
+
+            // Continue with the nearest triangle of another part of the mesh
+            if (!meshletVertices.empty())
+            {
+                const float scale = 1.0f / float(meshletVertices.size());
+                const float centroid[3] = { meshletCentroid[0] * scale, meshletCentroid[1] * scale, meshletCentroid[2] * scale };
+                float bestDistance = INFINITY;
+                const uint32_t searchEnd = std::min(seedCursor + MESHLET_SEED_SEARCH_WINDOW, triangleCount);
+                for (uint32_t triangle = seedCursor; triangle < searchEnd; ++triangle)
+                {
+                    if (emitted[triangle]) continue;
+
+                    const float* p = position(mesh.indices[triangle * 3U]);
+                    const float distance = (p[0] - centroid[0]) * (p[0] - centroid[0]) + (p[1] - centroid[1]) * (p[1] - centroid[1]) + (p[2] - centroid[2]) * (p[2] - centroid[2]);
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        bestTriangle = triangle;
+                    }
+                }
+            }
+            bestNewVertexCount = newVertexCount(bestTriangle);
+        }
+
+        if (meshletVertices.size() + bestNewVertexCount > maxVertexCount || meshletPrimitives.size() == maxPrimitiveCount) {
+            flushMeshlet();
+        }
+
+        // Append the triangle
+        const uint32_t* tri = &mesh.indices[bestTriangle * 3U];
+        uint32_t packedPrimitive = 0U;
+        for (uint32_t c = 0U; c < 3U; ++c)
+        {
+            const uint32_t v = tri[c];
+            if (localIndices[v] == UINT16_MAX)
+            {
+                localIndices[v] = uint16_t(meshletVertices.size());
+                meshletVertices.push_back(v);
+
+                const float* p = position(v);
+                meshletCentroid[0] += p[0];
+                meshletCentroid[1] += p[1];
+                meshletCentroid[2] += p[2];
+            }
+            packedPrimitive |= uint32_t(localIndices[v]) << (c * 8U);
+        }
+        meshletPrimitives.push_back(packedPrimitive);
+
+        // Remove the triangle from the live adjacency lists of its vertices
+        emitted[bestTriangle] = true;
+        for (uint32_t c = 0U; c < 3U; ++c)
+        {
+            const uint32_t v = tri[c];
+            uint32_t* list = &adjacency[adjacencyOffsets[v]];
+            for (uint32_t i = 0U; i < liveTriangleCounts[v]; ++i)
+            {
+                if (list[i] == bestTriangle)
+                {
+                    list[i] = list[--liveTriangleCounts[v]];
+                    break;
+                }
+            }
+        }
+    }
+
+    flushMeshlet();
+
+    return result;
+}
+
+auto BuildMeshletMeshes(const std::vector<MeshletSourceMesh>& meshes, ThreadPool* threadPool, uint32_t maxVertexCount, uint32_t maxPrimitiveCount) ->
+                        std::vector<MeshletMesh>
+{
+    std::vector<MeshletMesh> result(meshes.size());
+
+    ThreadPoolParallelFor(threadPool, uint32_t(meshes.size()), [&](uint32_t index) {
+        result[index] = BuildMeshletMesh(meshes[index], maxVertexCount, maxPrimitiveCount);
+    });
+
+    return result;
+}
+
+auto GetMeshletVertexReuse(const MeshletMesh& meshletMesh) -> float
+{
+    if (meshletMesh.vertexIndices.empty()) return 0.0f;
+
+    return float(meshletMesh.primitives.size() * 3U) / float(meshletMesh.vertexIndices.size());
+}
+
+auto SerializeMeshletMesh(const MeshletMesh& meshletMesh) -> std::vector<uint8_t>
+{
+    uint32_t header[4] = {
+        0U,
+        uint32_t(meshletMesh.meshlets.size()),
+        uint32_t(meshletMesh.vertexIndices.size()),
+        uint32_t(meshletMesh.primitives.size())
+    };
+
+    const size_t meshletsSize = meshletMesh.meshlets.size() * sizeof(MeshletDesc);
+    const size_t vertexIndicesSize = meshletMesh.vertexIndices.size() * sizeof(uint32_t);
+    const size_t primitivesSize = meshletMesh.primitives.size() * sizeof(uint32_t);
+
+    memcpy(&header[0], MESHLET_SERIALIZATION_MAGIC, sizeof(MESHLET_SERIALIZATION_MAGIC));
+
+    std::vector<uint8_t> data(sizeof(header) + meshletsSize + vertexIndicesSize + primitivesSize);
+    uint8_t* dst = data.data();
+
+    memcpy(dst, header, sizeof(header));
+    dst += sizeof(header);
+
+    if (meshletsSize > 0U) memcpy(dst, meshletMesh.meshlets.data(), meshletsSize);
+    dst += meshletsSize;
+    if (vertexIndicesSize > 0U) memcpy(dst, meshletMesh.vertexIndices.data(), vertexIndicesSize);
+    dst += vertexIndicesSize;
+    if (primitivesSize > 0U) memcpy(dst, meshletMesh.primitives.data(), primitivesSize);
+
+    return data;
+}
+
+auto DeserializeMeshletMesh(const uint8_t* data, size_t size, MeshletMesh& meshletMesh) -> bool
+{
+    uint32_t header[4];
+    if (data == nullptr || size < sizeof(header)) return false;
+    if (memcmp(data, MESHLET_SERIALIZATION_MAGIC, sizeof(MESHLET_SERIALIZATION_MAGIC)) != 0) return false;
+
+    memcpy(header, data, sizeof(header));
+    const size_t meshletsSize = size_t(header[1]) * sizeof(MeshletDesc);
+    const size_t vertexIndicesSize = size_t(header[2]) * sizeof(uint32_t);
+    const size_t primitivesSize = size_t(header[3]) * sizeof(uint32_t);
+    if (size != sizeof(header) + meshletsSize + vertexIndicesSize + primitivesSize) return false;
+
+    MeshletMesh result{ };
+    result.meshlets.resize(header[1]);
+    result.vertexIndices.resize(header[2]);
+    result.primitives.resize(header[3]);
+
+    const uint8_t* src = data + sizeof(header);
+    if (meshletsSize > 0U) memcpy(result.meshlets.data(), src, meshletsSize);
+    src += meshletsSize;
+    if (vertexIndicesSize > 0U) memcpy(result.vertexIndices.data(), src, vertexIndicesSize);
+    src += vertexIndicesSize;
+    if (primitivesSize > 0U) memcpy(result.primitives.data(), src, primitivesSize);
+
+    // Every meshlet must reference valid ranges and local indices
+    for (const MeshletDesc& meshlet : result.meshlets)
+    {
+        if (meshlet.vertexCount > MESHLET_MAX_VERTEX_COUNT || meshlet.primitiveCount > MESHLET_MAX_PRIMITIVE_COUNT) return false;
+        if (uint64_t(meshlet.vertexOffset) + meshlet.vertexCount > result.vertexIndices.size()) return false;
+        if (uint64_t(meshlet.primitiveOffset) + meshlet.primitiveCount > result.primitives.size()) return false;
+
+        for (uint32_t i = 0U; i < meshlet.primitiveCount; ++i)
+        {
+            const uint32_t primitive = result.primitives[meshlet.primitiveOffset + i];
+            if ((primitive & 0xffU) >= meshlet.vertexCount || ((primitive >> 8) & 0xffU) >= meshlet.vertexCount ||
+                ((primitive >> 16) & 0xffU) >= meshlet.vertexCount || (primitive >> 24) != 0U) return false;
+        }
+    }
+
+    meshletMesh = std::move(result);
+    return true;
+}
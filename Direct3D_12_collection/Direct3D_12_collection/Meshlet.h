@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ThreadPool.h"
+
+// Meshlet builder for indexed triangle meshes rendered by mesh shaders.
+// Triangles are grown into meshlets from a seed triangle by always taking the adjacent triangle that needs
+// the fewest new vertices, so the vertices of a meshlet are shared by as many of its triangles as possible.
+// Every meshlet carries a bounding sphere and a normal cone for amplification shader culling.
+
+// Limits of ms.mesh.hlsl: out vertices [256], out indices [254]
+static constexpr uint32_t MESHLET_MAX_VERTEX_COUNT = 256U;
+static constexpr uint32_t MESHLET_MAX_PRIMITIVE_COUNT = 254U;
+
+// The same layout as the meshlet structured buffer of the mesh shaders (36 bytes)
+struct MeshletDesc
+{
+    uint32_t vertexOffset;          // first element in MeshletMesh::vertexIndices
+    uint32_t vertexCount;
+    uint32_t primitiveOffset;       // first element in MeshletMesh::primitives
+    uint32_t primitiveCount;
+    float boundingSphere[4];        // center xyz, radius
+
+    // Normal cone as 4 snorm8 values: axis x, y, z in bits 0-23 and the cutoff in bits 24-31.
+    // The meshlet is back-facing when dot(center - cameraPosition, axis) >= cutoff * length(center - cameraPosition) + radius
+    // with the decoded and normalized axis. A cutoff of 1 means that the meshlet can never be back-face culled.
+    uint32_t normalCone;
+};
+
+struct MeshletMesh
+{
+    std::vector<MeshletDesc> meshlets;
+    std::vector<uint32_t> vertexIndices;    // indices into the vertices of the source mesh
+    std::vector<uint32_t> primitives;       // 8-bit meshlet-local vertex indices: i0 | i1 << 8 | i2 << 16
+};
+
+struct MeshletSourceMesh
+{
+    const float* positions;         // xyz of each vertex
+    uint32_t positionStride;        // in bytes
+    uint32_t vertexCount;
+    const uint32_t* indices;        // triangle list. Normals are cross(p1 - p0, p2 - p0), pointing to the front side.
+    uint32_t indexCount;
+};
+
+// @param maxVertexCount at most MESHLET_MAX_VERTEX_COUNT
+// @param maxPrimitiveCount at most MESHLET_MAX_PRIMITIVE_COUNT
+extern auto BuildMeshletMesh(const MeshletSourceMesh& mesh, uint32_t maxVertexCount, uint32_t maxPrimitiveCount) -> MeshletMesh;
+
+// Builds the meshlets of every mesh in a separate task. threadPool may be nullptr.
+extern auto BuildMeshletMeshes(const std::vector<MeshletSourceMesh>& meshes, ThreadPool* threadPool, uint32_t maxVertexCount, uint32_t maxPrimitiveCount) ->
+                                std::vector<MeshletMesh>;
+
+// @return the average number of triangles that use each vertex transformed by the mesh shaders (at most 6 for large regular meshes)
+extern auto GetMeshletVertexReuse(const MeshletMesh& meshletMesh) -> float;
+
+// Decodes MeshletDesc::normalCone into a normalized axis and the cutoff
+extern auto DecodeMeshletNormalCone(uint32_t normalCone, float axis[3], float* cutoff) -> void;
+
+// Serialized format: a 16-byte header (magic "MSHL", meshlet count, vertex index count, primitive count)
+// followed by the MeshletDesc array, the vertex index array and the primitive array, all little endian.
+extern auto SerializeMeshletMesh(const MeshletMesh& meshletMesh) -> std::vector<uint8_t>;
+
+// @return false if the data is not a complete serialized meshlet mesh
+extern auto DeserializeMeshletMesh(const uint8_t* data, size_t size, MeshletMesh& meshletMesh) -> bool;
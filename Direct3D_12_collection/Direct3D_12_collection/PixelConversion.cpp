@@ -0,0 +1,712 @@
+#include "PixelConversion.h"
+#include "CpuFeatures.h"
+
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+// MSVC accepts SSE4.1 and AVX2 intrinsics in any function, GCC and Clang only in functions compiled for those targets.
+// The CPU and the OS support are checked at run time either way.
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#define PIXEL_CONVERSION_USE_X86            1
+#define PIXEL_CONVERSION_SSE_TARGET
+#define PIXEL_CONVERSION_AVX2_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define PIXEL_CONVERSION_USE_X86            1
+#define PIXEL_CONVERSION_SSE_TARGET         __attribute__((target("sse4.1")))
+#define PIXEL_CONVERSION_AVX2_TARGET        __attribute__((target("avx2")))
+#else
+#define PIXEL_CONVERSION_USE_X86            0
+#endif
+
+#if defined(_M_ARM64) || defined(__aarch64__)
+#include <arm_neon.h>
+#define PIXEL_CONVERSION_USE_NEON           1
+#else
+#define PIXEL_CONVERSION_USE_NEON           0
+#endif
+
+// The sRGB encoding looks up the top 12 bits of a linear 16-bit value
+static constexpr uint32_t SRGB_TABLE_SIZE = 4096U;
+
+// Entry i is the 8-bit sRGB encoding of the center of the linear 16-bit range [i * 16, i * 16 + 15].
+// The entries are 32-bit so that the AVX2 kernel can gather them.
+static auto GetLinearToSRGBTable() -> const std::array<uint32_t, SRGB_TABLE_SIZE>&
+{
+    static const std::array<uint32_t, SRGB_TABLE_SIZE> table = [] {
+        std::array<uint32_t, SRGB_TABLE_SIZE> result{ };
+        for (uint32_t i = 0U; i < SRGB_TABLE_SIZE; ++i)
+        {
+            const double linear = (double(i) * 16.0 + 7.5) / 65535.0;
+            const double encoded = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+            result[i] = uint32_t(std::lround((std::min)(encoded, 1.0) * 255.0));
+        }
+        return result;
+    }();
+    return table;
+}
+
+static auto HasAlpha(PixelConversion conversion) -> bool
+{
+    return conversion != PixelConversion::BGR8ToRGBA8 && conversion != PixelConversion::BGRX8ToRGBA8;
+}
+
+// round(x / 255) for x in [0, 255 * 255]
+static inline auto DivideBy255(uint32_t x) -> uint32_t
+{
+    const uint32_t t = x + 128U;
+    return (t + (t >> 8)) >> 8;
+}
+
+// round(c * 255 / 65535). The SIMD kernels compute the same value as (u - (u >> 8)) >> 8 with u = min(c + 128, 65535).
+static inline auto Unorm16ToUnorm8(uint32_t c) -> uint32_t
+{
+    return (c * 255U + 32895U) >> 16;
+}
+
+static inline auto ReadU16(const uint8_t* p) -> uint32_t
+{
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8);
+}
+
+// The reference of every kernel, which also converts the pixels that do not fill a whole vector.
+// The premultiplication of RGBA16ToSRGBA8 is part of the table index: (c * (a + 1)) >> 20, or c >> 4 without premultiplication.
+static auto ConvertPixelsScalar(PixelConversion conversion, bool premultiplyAlpha, const uint8_t* source, uint8_t* destination, uint32_t begin, uint32_t end) -> void
+{
+    const std::array<uint32_t, SRGB_TABLE_SIZE>& srgbTable = GetLinearToSRGBTable();
+
+    for (uint32_t x = begin; x < end; ++x)
+    {
+        uint32_t r = 0U, g = 0U, b = 0U, a = 0xffU;
+        switch (conversion)
+        {
+        case PixelConversion::BGR8ToRGBA8:
+            r = source[x * 3U + 2U];
+            g = source[x * 3U + 1U];
+            b = source[x * 3U];
+            break;
+
+        case PixelConversion::BGRA8ToRGBA8:
+        case PixelConversion::BGRX8ToRGBA8:
+            r = source[x * 4U + 2U];
+            g = source[x * 4U + 1U];
+            b = source[x * 4U];
+            a = conversion == PixelConversion::BGRA8ToRGBA8 ? source[x * 4U + 3U] : 0xffU;
+            break;
+
+        case PixelConversion::RGBA8ToRGBA8:
+            r = source[x * 4U];
+            g = source[x * 4U + 1U];
+            b = source[x * 4U + 2U];
+            a = source[x * 4U + 3U];
+            break;
+
+        case PixelConversion::RGBA16ToRGBA8:
+            r = Unorm16ToUnorm8(ReadU16(source + x * 8U));
+            g = Unorm16ToUnorm8(ReadU16(source + x * 8U + 2U));
+            b = Unorm16ToUnorm8(ReadU16(source + x * 8U + 4U));
+            a = Unorm16ToUnorm8(ReadU16(source + x * 8U + 6U));
+            break;
+
+        case PixelConversion::RGBA16ToSRGBA8:
+        {
+            const uint32_t alpha = ReadU16(source + x * 8U + 6U);
+            const uint32_t multiplier = premultiplyAlpha ? alpha + 1U : 65536U;
+            r = srgbTable[(ReadU16(source + x * 8U) * multiplier) >> 20];
+            g = srgbTable[(ReadU16(source + x * 8U + 2U) * multiplier) >> 20];
+            b = srgbTable[(ReadU16(source + x * 8U + 4U) * multiplier) >> 20];
+            a = Unorm16ToUnorm8(alpha);
+            break;
+        }
+
+        default:
+            break;
+        }
+
+        if (premultiplyAlpha && conversion != PixelConversion::RGBA16ToSRGBA8)
+        {
+            r = DivideBy255(r * a);
+            g = DivideBy255(g * a);
+            b = DivideBy255(b * a);
+        }
+
+        // One 4-byte store per pixel, since byte stores are slow on write-combined memory
+        const uint32_t pixel = r | (g << 8) | (b << 16) | (a << 24);
+        memcpy(destination + size_t(x) * 4U, &pixel, sizeof(pixel));
+    }
+}
+
+static auto ConvertRowScalar(PixelConversion conversion, bool premultiplyAlpha, const uint8_t* source, uint8_t* destination, uint32_t width, bool streamingStores) -> void
+{
+    (void)streamingStores;
+    ConvertPixelsScalar(conversion, premultiplyAlpha, source, destination, 0U, width);
+}
+
+#if PIXEL_CONVERSION_USE_X86
+PIXEL_CONVERSION_SSE_TARGET
+static inline auto DivideBy255SSE(__m128i x) -> __m128i
+{
+    const __m128i t = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// 8 16-bit channels to 8-bit in the low 8 bytes
+PIXEL_CONVERSION_SSE_TARGET
+static inline auto Unorm16ToUnorm8SSE(__m128i c) -> __m128i
+{
+    const __m128i u = _mm_adds_epu16(c, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_sub_epi16(u, _mm_srli_epi16(u, 8)), 8);
+}
+
+// 4 RGBA8 pixels
+PIXEL_CONVERSION_SSE_TARGET
+static inline auto PremultiplySSE(__m128i pixels) -> __m128i
+{
+    // The alpha of each pixel in the 16-bit lanes of its color channels, and 255 in the lane of alpha itself
+    const __m128i alphaOne = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+    const __m128i alphaLow = _mm_or_si128(_mm_shuffle_epi8(pixels, _mm_setr_epi8(3, -1, 3, -1, 3, -1, -1, -1, 7, -1, 7, -1, 7, -1, -1, -1)), alphaOne);
+    const __m128i alphaHigh = _mm_or_si128(_mm_shuffle_epi8(pixels, _mm_setr_epi8(11, -1, 11, -1, 11, -1, -1, -1, 15, -1, 15, -1, 15, -1, -1, -1)), alphaOne);
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i low = DivideBy255SSE(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), alphaLow));
+    const __m128i high = DivideBy255SSE(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), alphaHigh));
+    return _mm_packus_epi16(low, high);
+}
+
+// The color channels of one RGBA16 pixel in the low 4 bytes of its 32-bit lanes, the alpha lane is undefined
+PIXEL_CONVERSION_SSE_TARGET
+static inline auto EncodeSRGBPixelSSE(__m128i pixel, bool premultiplyAlpha, const uint32_t* srgbTable) -> uint32_t
+{
+    const __m128i multiplier = premultiplyAlpha ? _mm_add_epi32(_mm_shuffle_epi32(pixel, _MM_SHUFFLE(3, 3, 3, 3)), _mm_set1_epi32(1)) : _mm_set1_epi32(65536);
+    const __m128i indices = _mm_srli_epi32(_mm_mullo_epi32(pixel, multiplier), 20);
+    return srgbTable[_mm_cvtsi128_si32(indices)] | (srgbTable[_mm_extract_epi32(indices, 1)] << 8) | (srgbTable[_mm_extract_epi32(indices, 2)] << 16);
+}
+
+template <bool STREAMING_STORES>
+PIXEL_CONVERSION_SSE_TARGET
+static inline auto StoreSSE(uint8_t* destination, __m128i pixels) -> void
+{
+    if constexpr (STREAMING_STORES) {
+        _mm_stream_si128((__m128i*)destination, pixels);
+    }
+    else {
+        _mm_storeu_si128((__m128i*)destination, pixels);
+    }
+}
+
+// 4 pixels per iteration
+template <bool STREAMING_STORES>
+PIXEL_CONVERSION_SSE_TARGET
+static auto ConvertPixelsSSE(PixelConversion conversion, bool premultiplyAlpha, const uint8_t* source, uint8_t* destination, uint32_t width) -> uint32_t
+{
+    const __m128i opaque = _mm_set1_epi32(int(0xff000000U));
+    const __m128i swapRedBlue = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    const __m128i expandBGR = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const uint32_t* srgbTable = GetLinearToSRGBTable().data();
+
+    uint32_t x = 0U;
+    switch (conversion)
+    {
+    case PixelConversion::BGR8ToRGBA8:
+        // A 16-byte load reads 4 bytes past the 4 pixels, which must still be inside the row
+        for (; x + 6U <= width; x += 4U) {
+            StoreSSE<STREAMING_STORES>(destination + size_t(x) * 4U, _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(source + size_t(x) * 3U)), expandBGR), opaque));
+        }
+        break;
+
+    case PixelConversion::BGRA8ToRGBA8:
+    case PixelConversion::BGRX8ToRGBA8:
+    case PixelConversion::RGBA8ToRGBA8:
+        for (; x + 4U <= width; x += 4U)
+        {
+            __m128i pixels = _mm_loadu_si128((const __m128i*)(source + size_t(x) * 4U));
+            if (conversion != PixelConversion::RGBA8ToRGBA8) {
+                pixels = _mm_shuffle_epi8(pixels, swapRedBlue);
+            }
+            if (conversion == PixelConversion::BGRX8ToRGBA8) {
+                pixels = _mm_or_si128(pixels, opaque);
+            }
+            if (premultiplyAlpha) {
+                pixels = PremultiplySSE(pixels);
+            }
+            StoreSSE<STREAMING_STORES>(destination + size_t(x) * 4U, pixels);
+        }
+        break;
+
+    case PixelConversion::RGBA16ToRGBA8:
+    case PixelConversion::RGBA16ToSRGBA8:
+        for (; x + 4U <= width; x += 4U)
+        {
+            const __m128i pixels01 = _mm_loadu_si128((const __m128i*)(source + size_t(x) * 8U));
+            const __m128i pixels23 = _mm_loadu_si128((const __m128i*)(source + size_t(x) * 8U + 16U));
+            __m128i pixels = _mm_packus_epi16(Unorm16ToUnorm8SSE(pixels01), Unorm16ToUnorm8SSE(pixels23));
+
+            if (conversion == PixelConversion::RGBA16ToSRGBA8)
+            {
+                // Keep the linear alpha
+                const __m128i colors = _mm_setr_epi32(int(EncodeSRGBPixelSSE(_mm_cvtepu16_epi32(pixels01), premultiplyAlpha, srgbTable)),
+                                                        int(EncodeSRGBPixelSSE(_mm_cvtepu16_epi32(_mm_srli_si128(pixels01, 8)), premultiplyAlpha, srgbTable)),
+                                                        int(EncodeSRGBPixelSSE(_mm_cvtepu16_epi32(pixels23), premultiplyAlpha, srgbTable)),
+                                                        int(EncodeSRGBPixelSSE(_mm_cvtepu16_epi32(_mm_srli_si128(pixels23, 8)), premultiplyAlpha, srgbTable)));
+                pixels = _mm_or_si128(_mm_and_si128(pixels, opaque), colors);
+            }
+            else if (premultiplyAlpha) {
+                pixels = PremultiplySSE(pixels);
+            }
+            StoreSSE<STREAMING_STORES>(destination + size_t(x) * 4U, pixels);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return x;
+}
+
+static auto ConvertRowSSE(PixelConversion conversion, bool premultiplyAlpha, const uint8_t* source, uint8_t* destination, uint32_t width, bool streamingStores) -> void
+{
+    const uint32_t vectorEnd = streamingStores && (uintptr_t(destination) & 15U) == 0U ?
+                                ConvertPixelsSSE<true>(conversion, premultiplyAlpha, source, destination, width) :
+                                ConvertPixelsSSE<false>(conversion, premultiplyAlpha, source, destination, width);
+    ConvertPixelsScalar(conversion, premultiplyAlpha, source, destination, vectorEnd, width);
+}
+
+PIXEL_CONVERSION_AVX2_TARGET
+static inline auto DivideBy255AVX2(__m256i x) -> __m256i
+{
+    const __m256i t = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+PIXEL_CONVERSION_AVX2_TARGET
+static inline auto Unorm16ToUnorm8AVX2(__m256i c) -> __m256i
+{
+    const __m256i u = _mm256_adds_epu16(c, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_sub_epi16(u, _mm256_srli_epi16(u, 8)), 8);
+}
+
+// 8 RGBA8 pixels. The shuffles, unpacks and packs all work within 128-bit lanes, so the pixel order is kept.
+PIXEL_CONVERSION_AVX2_TARGET
+static inline auto PremultiplyAVX2(__m256i pixels) -> __m256i
+{
+    const __m256i alphaOne = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255);
+    const __m256i alphaLow = _mm256_or_si256(_mm256_shuffle_epi8(pixels, _mm256_setr_epi8(3, -1, 3, -1, 3, -1, -1, -1, 7, -1, 7, -1, 7, -1, -1, -1,
+                                                                                            3, -1, 3, -1, 3, -1, -1, -1, 7, -1, 7, -1, 7, -1, -1, -1)), alphaOne);
+    const __m256i alphaHigh = _mm256_or_si256(_mm256_shuffle_epi8(pixels, _mm256_setr_epi8(11, -1, 11, -1, 11, -1, -1, -1, 15, -1, 15, -1, 15, -1, -1, -1,
+                                                                                            11, -1, 11, -1, 11, -1, -1, -1, 15, -1, 15, -1, 15, -1, -1, -1)), alphaOne);
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i low = DivideBy255AVX2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), alphaLow));
+    const __m256i high = DivideBy255AVX2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), alphaHigh));
+    return _mm256_packus_epi16(low, high);
+}
+
+// Pixels k and k + 1 of 8 RGBA16 pixels, as 32-bit sRGB table entries of each channel. The alpha lanes are undefined.
+PIXEL_CONVERSION_AVX2_TARGET
+static inline auto GatherSRGBPixelsAVX2(__m128i pixels, bool premultiplyAlpha, const uint32_t* srgbTable) -> __m256i
+{
+    const __m256i channels = _mm256_cvtepu16_epi32(pixels);
+    const __m256i multiplier = premultiplyAlpha ? _mm256_add_epi32(_mm256_shuffle_epi32(channels, _MM_SHUFFLE(3, 3, 3, 3)), _mm256_set1_epi32(1)) :
+                                                _mm256_set1_epi32(65536);
+    const __m256i indices = _mm256_srli_epi32(_mm256_mullo_epi32(channels, multiplier), 20);
+    return _mm256_i32gather_epi32((const int*)srgbTable, indices, 4);
+}
+
+template <bool STREAMING_STORES>
+PIXEL_CONVERSION_AVX2_TARGET
+static inline auto StoreAVX2(uint8_t* destination, __m256i pixels) -> void
+{
+    if constexpr (STREAMING_STORES) {
+        _mm256_stream_si256((__m256i*)destination, pixels);
+    }
+    else {
+        _mm256_storeu_si256((__m256i*)destination, pixels);
+    }
+}
+
+// 8 pixels per iteration
+template <bool STREAMING_STORES>
+PIXEL_CONVERSION_AVX2_TARGET
+static auto ConvertPixelsAVX2(PixelConversion conversion, bool premultiplyAlpha, const uint8_t* source, uint8_t* destination, uint32_t width) -> uint32_t
+{
+    const __m256i opaque = _mm256_set1_epi32(int(0xff000000U));
+    const __m256i swapRedBlue = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                                2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    const __m256i expandBGR = _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+                                                2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const uint32_t* srgbTable = GetLinearToSRGBTable().data();
+
+    uint32_t x = 0U;
+    switch (conversion)
+    {
+    case PixelConversion::BGR8ToRGBA8:
+        // Pixels 0 - 3 and 4 - 7 are loaded into the two 128-bit lanes. The second load reads 4 bytes past the 8 pixels.
+        for (; x + 10U <= width; x += 8U)
+        {
+            const uint8_t* pixelSource = source + size_t(x) * 3U;
+            const __m256i pixels = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)pixelSource)),
+                                                            _mm_loadu_si128((const __m128i*)(pixelSource + 12U)), 1);
+            StoreAVX2<STREAMING_STORES>(destination + size_t(x) * 4U, _mm256_or_si256(_mm256_shuffle_epi8(pixels, expandBGR), opaque));
+        }
+        break;
+
+    case PixelConversion::BGRA8ToRGBA8:
+    case PixelConversion::BGRX8ToRGBA8:
+    case PixelConversion::RGBA8ToRGBA8:
+        for (; x + 8U <= width; x += 8U)
+        {
+            __m256i pixels = _mm256_loadu_si256((const __m256i*)(source + size_t(x) * 4U));
+            if (conversion != PixelConversion::RGBA8ToRGBA8) {
+                pixels = _mm256_shuffle_epi8(pixels, swapRedBlue);
+            }
+            if (conversion == PixelConversion::BGRX8ToRGBA8) {
+                pixels = _mm256_or_si256(pixels, opaque);
+            }
+            if (premultiplyAlpha) {
+                pixels = PremultiplyAVX2(pixels);
+            }
+            StoreAVX2<STREAMING_STORES>(destination + size_t(x) * 4U, pixels);
+        }
+        break;
+
+    case PixelConversion::RGBA16ToRGBA8:
+    case PixelConversion::RGBA16ToSRGBA8:
+        for (; x + 8U <= width; x += 8U)
+        {
+            const __m256i pixels0123 = _mm256_loadu_si256((const __m256i*)(source + size_t(x) * 8U));
+            const __m256i pixels4567 = _mm256_loadu_si256((const __m256i*)(source + size_t(x) * 8U + 32U));
+
+            // The pack interleaves the 128-bit lanes: 0 1 4 5 2 3 6 7
+            __m256i pixels = _mm256_permute4x64_epi64(_mm256_packus_epi16(Unorm16ToUnorm8AVX2(pixels0123), Unorm16ToUnorm8AVX2(pixels4567)), _MM_SHUFFLE(3, 1, 2, 0));
+
+            if (conversion == PixelConversion::RGBA16ToSRGBA8)
+            {
+                const __m256i colors01 = GatherSRGBPixelsAVX2(_mm256_castsi256_si128(pixels0123), premultiplyAlpha, srgbTable);
+                const __m256i colors23 = GatherSRGBPixelsAVX2(_mm256_extracti128_si256(pixels0123, 1), premultiplyAlpha, srgbTable);
+                const __m256i colors45 = GatherSRGBPixelsAVX2(_mm256_castsi256_si128(pixels4567), premultiplyAlpha, srgbTable);
+                const __m256i colors67 = GatherSRGBPixelsAVX2(_mm256_extracti128_si256(pixels4567, 1), premultiplyAlpha, srgbTable);
+
+                // Packing the 32-bit entries down to bytes leaves the pixels in the order 0 2 4 6 | 1 3 5 7
+                const __m256i colors = _mm256_permutevar8x32_epi32(
+                    _mm256_packus_epi16(_mm256_packus_epi32(colors01, colors23), _mm256_packus_epi32(colors45, colors67)),
+                    _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+
+                // Keep the linear alpha
+                pixels = _mm256_blendv_epi8(colors, pixels, opaque);
+            }
+            else if (premultiplyAlpha) {
+                pixels = PremultiplyAVX2(pixels);
+            }
+            StoreAVX2<STREAMING_STORES>(destination + size_t(x) * 4U, pixels);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return x;
+}
+
+static auto ConvertRowAVX2(PixelConversion conversion, bool premultiplyAlpha, const uint8_t* source, uint8_t* destination, uint32_t width, bool streamingStores) -> void
+{
+    const uint32_t vectorEnd = streamingStores && (uintptr_t(destination) & 31U) == 0U ?
+                                ConvertPixelsAVX2<true>(conversion, premultiplyAlpha, source, destination, width) :
+                                ConvertPixelsAVX2<false>(conversion, premultiplyAlpha, source, destination, width);
+    ConvertPixelsScalar(conversion, premultiplyAlpha, source, destination, vectorEnd, width);
+}
+#endif
+
+#if PIXEL_CONVERSION_USE_NEON
+// round(c * a / 255) with vrshrq_n_u16(x, 8) = (x + 128) >> 8 and vraddhn_u16(x, y) = (x + y + 128) >> 8, as DivideBy255()
+static inline auto Premultiply8NEON(uint8x8_t color, uint8x8_t alpha) -> uint8x8_t
+{
+    const uint16x8_t x = vmull_u8(color, alpha);
+    return vraddhn_u16(x, vrshrq_n_u16(x, 8));
+}
+
+static inline auto Premultiply16NEON(uint8x16_t color, uint8x16_t alpha) -> uint8x16_t
+{
+    return vcombine_u8(Premultiply8NEON(vget_low_u8(color), vget_low_u8(alpha)), Premultiply8NEON(vget_high_u8(color), vget_high_u8(alpha)));
+}
+
+static inline auto Unorm16ToUnorm8NEON(uint16x8_t c) -> uint8x8_t
+{
+    const uint16x8_t u = vqaddq_u16(c, vdupq_n_u16(128));
+    return vshrn_n_u16(vsubq_u16(u, vshrq_n_u16(u, 8)), 8);
+}
+
+// One channel of 8 RGBA16 pixels
+static inline auto EncodeSRGBChannelNEON(uint16x8_t channel, uint32x4_t multiplierLow, uint32x4_t multiplierHigh, const uint32_t* srgbTable) -> uint8x8_t
+{
+    uint32_t indices[8];
+    vst1q_u32(indices, vshrq_n_u32(vmulq_u32(vmovl_u16(vget_low_u16(channel)), multiplierLow), 20));
+    vst1q_u32(indices + 4, vshrq_n_u32(vmulq_u32(vmovl_high_u16(channel), multiplierHigh), 20));
+
+    uint8_t encoded[8];
+    for (int i = 0; i < 8; ++i) {
+        encoded[i] = uint8_t(srgbTable[indices[i]]);
+    }
+    return vld1_u8(encoded);
+}
+
+// AArch64 has no non-temporal store intrinsic, so the NEON kernel always uses regular stores.
+// The structure loads and stores deinterleave and interleave the channels: 16 pixels per iteration for 8-bit sources, 8 for 16-bit ones.
+static auto ConvertRowNEON(PixelConversion conversion, bool premultiplyAlpha, const uint8_t* source, uint8_t* destination, uint32_t width, bool streamingStores) -> void
+{
+    (void)streamingStores;
+    const uint32_t* srgbTable = GetLinearToSRGBTable().data();
+
+    uint32_t x = 0U;
+    switch (conversion)
+    {
+    case PixelConversion::BGR8ToRGBA8:
+        for (; x + 16U <= width; x += 16U)
+        {
+            const uint8x16x3_t pixels = vld3q_u8(source + size_t(x) * 3U);
+            const uint8x16x4_t result{ { pixels.val[2], pixels.val[1], pixels.val[0], vdupq_n_u8(0xff) } };
+            vst4q_u8(destination + size_t(x) * 4U, result);
+        }
+        break;
+
+    case PixelConversion::BGRA8ToRGBA8:
+    case PixelConversion::BGRX8ToRGBA8:
+    case PixelConversion::RGBA8ToRGBA8:
+        for (; x + 16U <= width; x += 16U)
+        {
+            const uint8x16x4_t pixels = vld4q_u8(source + size_t(x) * 4U);
+            uint8x16x4_t result = pixels;
+            if (conversion != PixelConversion::RGBA8ToRGBA8)
+            {
+                result.val[0] = pixels.val[2];
+                result.val[2] = pixels.val[0];
+            }
+            if (conversion == PixelConversion::BGRX8ToRGBA8) {
+                result.val[3] = vdupq_n_u8(0xff);
+            }
+            if (premultiplyAlpha)
+            {
+                for (int c = 0; c < 3; ++c) {
+                    result.val[c] = Premultiply16NEON(result.val[c], result.val[3]);
+                }
+            }
+            vst4q_u8(destination + size_t(x) * 4U, result);
+        }
+        break;
+
+    case PixelConversion::RGBA16ToRGBA8:
+    case PixelConversion::RGBA16ToSRGBA8:
+        for (; x + 8U <= width; x += 8U)
+        {
+            const uint16x8x4_t pixels = vld4q_u16((const uint16_t*)(source + size_t(x) * 8U));
+            uint8x8x4_t result;
+            result.val[3] = Unorm16ToUnorm8NEON(pixels.val[3]);
+
+            if (conversion == PixelConversion::RGBA16ToSRGBA8)
+            {
+                const uint32x4_t multiplierLow = premultiplyAlpha ? vaddq_u32(vmovl_u16(vget_low_u16(pixels.val[3])), vdupq_n_u32(1)) : vdupq_n_u32(65536);
+                const uint32x4_t multiplierHigh = premultiplyAlpha ? vaddq_u32(vmovl_high_u16(pixels.val[3]), vdupq_n_u32(1)) : vdupq_n_u32(65536);
+                for (int c = 0; c < 3; ++c) {
+                    result.val[c] = EncodeSRGBChannelNEON(pixels.val[c], multiplierLow, multiplierHigh, srgbTable);
+                }
+            }
+            else
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    result.val[c] = Unorm16ToUnorm8NEON(pixels.val[c]);
+                    if (premultiplyAlpha) {
+                        result.val[c] = Premultiply8NEON(result.val[c], result.val[3]);
+                    }
+                }
+            }
+            vst4_u8(destination + size_t(x) * 4U, result);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    ConvertPixelsScalar(conversion, premultiplyAlpha, source, destination, x, width);
+}
+#endif
+
+auto IsPixelConversionKernelSupported(PixelConversionKernel kernel) -> bool
+{
+    switch (kernel)
+    {
+    case PixelConversionKernel::Scalar:
+        return true;
+
+    case PixelConversionKernel::SSE:
+        return PIXEL_CONVERSION_USE_X86 != 0 && IsSSE41SupportedByCPU();
+
+    case PixelConversionKernel::AVX2:
+        return PIXEL_CONVERSION_USE_X86 != 0 && IsAVX2SupportedByCPU();
+
+    case PixelConversionKernel::NEON:
+        return PIXEL_CONVERSION_USE_NEON != 0;
+
+    default:
+        return false;
+    }
+}
+
+auto GetFastestPixelConversionKernel() -> PixelConversionKernel
+{
+    for (PixelConversionKernel kernel : { PixelConversionKernel::AVX2, PixelConversionKernel::SSE, PixelConversionKernel::NEON })
+    {
+        if (IsPixelConversionKernelSupported(kernel)) return kernel;
+    }
+    return PixelConversionKernel::Scalar;
+}
+
+auto GetPixelConversionKernelName(PixelConversionKernel kernel) -> const char*
+{
+    switch (kernel)
+    {
+    case PixelConversionKernel::Scalar:
+        return "scalar";
+
+    case PixelConversionKernel::SSE:
+        return "SSE4.1";
+
+    case PixelConversionKernel::AVX2:
+        return "AVX2";
+
+    case PixelConversionKernel::NEON:
+        return "NEON";
+
+    default:
+        return "unknown";
+    }
+}
+
+auto GetPixelConversionName(PixelConversion conversion) -> const char*
+{
+    switch (conversion)
+    {
+    case PixelConversion::BGR8ToRGBA8:
+        return "BGR8 to RGBA8";
+
+    case PixelConversion::BGRA8ToRGBA8:
+        return "BGRA8 to RGBA8";
+
+    case PixelConversion::BGRX8ToRGBA8:
+        return "BGRX8 to RGBA8";
+
+    case PixelConversion::RGBA8ToRGBA8:
+        return "RGBA8 to RGBA8";
+
+    case PixelConversion::RGBA16ToRGBA8:
+        return "RGBA16 to RGBA8";
+
+    case PixelConversion::RGBA16ToSRGBA8:
+        return "RGBA16 to sRGB RGBA8";
+
+    default:
+        return "unknown";
+    }
+}
+
+auto GetPixelConversionSourcePixelSize(PixelConversion conversion) -> uint32_t
+{
+    switch (conversion)
+    {
+    case PixelConversion::BGR8ToRGBA8:
+        return 3U;
+
+    case PixelConversion::RGBA16ToRGBA8:
+    case PixelConversion::RGBA16ToSRGBA8:
+        return 8U;
+
+    case PixelConversion::BGRA8ToRGBA8:
+    case PixelConversion::BGRX8ToRGBA8:
+    case PixelConversion::RGBA8ToRGBA8:
+    default:
+        return 4U;
+    }
+}
+
+auto ConvertPixelRows(PixelConversion conversion, const PixelConversionOptions& options, const uint8_t* firstSourceRow, ptrdiff_t sourceRowStride,
+                        void* destination, size_t destinationRowPitch, uint32_t width, uint32_t rowCount) -> void
+{
+    const PixelConversionKernel kernel = IsPixelConversionKernelSupported(options.kernel) ? options.kernel : PixelConversionKernel::Scalar;
+
+    auto convertRow = &ConvertRowScalar;
+    switch (kernel)
+    {
+#if PIXEL_CONVERSION_USE_X86
+    case PixelConversionKernel::SSE:
+        convertRow = &ConvertRowSSE;
+        break;
+
+    case PixelConversionKernel::AVX2:
+        convertRow = &ConvertRowAVX2;
+        break;
+#endif
+
+#if PIXEL_CONVERSION_USE_NEON
+    case PixelConversionKernel::NEON:
+        convertRow = &ConvertRowNEON;
+        break;
+#endif
+
+    case PixelConversionKernel::Scalar:
+    default:
+        break;
+    }
+
+    // Premultiplying by an alpha of 255 changes nothing
+    const bool premultiplyAlpha = options.premultiplyAlpha && HasAlpha(conversion);
+
+    uint8_t* const destinationRows = (uint8_t*)destination;
+    for (uint32_t row = 0U; row < rowCount; ++row) {
+        convertRow(conversion, premultiplyAlpha, firstSourceRow + sourceRowStride * ptrdiff_t(row), destinationRows + destinationRowPitch * row, width, options.streamingStores);
+    }
+
+#if PIXEL_CONVERSION_USE_X86
+    // Non-temporal stores are weakly ordered, so they must be complete before another thread, e.g. the one that submits the copy, can rely on them
+    if (options.streamingStores && kernel != PixelConversionKernel::Scalar) {
+        _mm_sfence();
+    }
+#endif
+}
+
+auto MeasurePixelConversionThroughput(PixelConversion conversion, const PixelConversionOptions& options, uint32_t width, uint32_t height,
+                                        uint32_t iterationCount) -> double
+{
+    const size_t sourceRowSize = size_t(width) * GetPixelConversionSourcePixelSize(conversion);
+    const size_t destinationRowPitch = size_t(width) * 4U;
+    if (width == 0U || height == 0U || iterationCount == 0U) return 0.0;
+
+    std::vector<uint8_t> source(sourceRowSize * height);
+    uint32_t seed = 0x12345678U;
+    for (uint8_t& byte : source)
+    {
+        seed = seed * 1664525U + 1013904223U;
+        byte = uint8_t(seed >> 24);
+    }
+
+    // 32-byte aligned rows, so that the streaming stores are used
+    std::vector<uint8_t> destination(destinationRowPitch * height + 32U);
+    uint8_t* destinationRows = destination.data() + ((32U - (uintptr_t(destination.data()) & 31U)) & 31U);
+
+    // Bottom-up, like BMP files
+    const uint8_t* firstSourceRow = source.data() + sourceRowSize * (height - 1U);
+
+    const auto beginTime = std::chrono::steady_clock::now();
+    for (uint32_t iteration = 0U; iteration < iterationCount; ++iteration) {
+        ConvertPixelRows(conversion, options, firstSourceRow, -ptrdiff_t(sourceRowSize), destinationRows, destinationRowPitch, width, height);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - beginTime).count();
+
+    return seconds > 0.0 ? double(destinationRowPitch) * double(height) * double(iterationCount) / seconds / 1000000.0 : 0.0;
+}
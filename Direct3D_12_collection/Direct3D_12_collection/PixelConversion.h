@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Conversion of rows of 8-bit and 16-bit per channel pixels into R8G8B8A8, written straight into their final location,
+// e.g. the placed footprint of a subresource in a mapped upload heap.
+// The rows are read through a signed stride, so bottom-up images are flipped in the same pass, and the channel swizzle,
+// the 16-bit to 8-bit conversion, the sRGB encoding and the alpha premultiplication all happen on the pixels while they are in registers.
+// Upload heaps are write-combined memory, so the SSE and AVX2 kernels can write the rows with non-temporal stores that bypass the cache.
+
+enum class PixelConversionKernel
+{
+    Scalar,
+    SSE,        // SSE4.1
+    AVX2,
+    NEON
+};
+
+enum class PixelConversion
+{
+    BGR8ToRGBA8,        // alpha is 255
+    BGRA8ToRGBA8,
+    BGRX8ToRGBA8,       // the fourth byte is ignored, alpha is 255
+    RGBA8ToRGBA8,       // a copy, or only the premultiplication
+    RGBA16ToRGBA8,
+    RGBA16ToSRGBA8      // the color channels are encoded with the sRGB transfer function, alpha stays linear
+};
+
+struct PixelConversionOptions
+{
+    PixelConversionKernel kernel;
+
+    // Multiply the color channels by alpha. RGBA16ToSRGBA8 premultiplies the linear 16-bit values before the sRGB encoding,
+    // the other conversions premultiply the 8-bit results.
+    bool premultiplyAlpha;
+
+    // Non-temporal stores for rows whose destination is aligned to the vector size. Only useful for memory that is not read back soon.
+    bool streamingStores;
+};
+
+// The SSE and AVX2 kernels are only supported when both the compiler and the CPU support them, the NEON kernel on ARM64
+extern auto IsPixelConversionKernelSupported(PixelConversionKernel kernel) -> bool;
+
+// AVX2, SSE, NEON or scalar, whichever is supported first
+extern auto GetFastestPixelConversionKernel() -> PixelConversionKernel;
+
+extern auto GetPixelConversionKernelName(PixelConversionKernel kernel) -> const char*;
+
+extern auto GetPixelConversionName(PixelConversion conversion) -> const char*;
+
+// @return the size of one source pixel in bytes
+extern auto GetPixelConversionSourcePixelSize(PixelConversion conversion) -> uint32_t;
+
+// Converts rowCount rows of width pixels. Every kernel writes the same bytes. An unsupported kernel falls back to the scalar one.
+// @param sourceRowStride in bytes, negative to flip the rows
+// @param destinationRowPitch at least width * 4 bytes
+extern auto ConvertPixelRows(PixelConversion conversion, const PixelConversionOptions& options, const uint8_t* firstSourceRow, ptrdiff_t sourceRowStride,
+                                void* destination, size_t destinationRowPitch, uint32_t width, uint32_t rowCount) -> void;
+
+// Converts a width x height image iterationCount times
+// @return written megabytes (10^6 bytes) of R8G8B8A8 pixels per second
+extern auto MeasurePixelConversionThroughput(PixelConversion conversion, const PixelConversionOptions& options, uint32_t width, uint32_t height,
+                                                uint32_t iterationCount) -> double;
@@ -1,5 +1,16 @@
 #include "common.h"
+#include "MatrixMath.h"
+#include "FrustumCulling.h"
+#include "BoundingVolumeHierarchy.h"
 
+// Use the glOrtho projection instead of the glFrustum perspective projection
+#define USE_ORTHO_PROJECTION    0
+
+// Cull a large set of boxes against the view volume of the initial transform with every supported kernel once at startup
+#define RUN_FRUSTUM_CULLING_BENCHMARK   1
+
+// Build a bounding volume hierarchy over the same boxes and measure its build, refit, culling and ray picking once at startup
+#define RUN_BVH_BENCHMARK   1
 
 constexpr UINT UAV_BUFFER_SIZE = 16U;
 
@@ -8,6 +19,22 @@ static float s_currY = 0.0f;
 static float s_currZ = -6.0f;   // For orthogonal projection, the proper range is [-6, -8], and [-3, -9] for frustum perspective projection 
 static float s_currAngle = 0.0f;
 
+// The model-view-projection matrix of the current translations, the layout of CBTransform in proj_test.vs.hlsl
+static auto GetMVPMatrix() -> Matrix4x4
+{
+    const float rotateAxis[3] = { 1.0f, 0.0f, 0.0f };
+    const Matrix4x4 rotateMatrix = GetRotationMatrix(GetQuaternionFromAxisAngle(rotateAxis, s_currAngle));
+    const Matrix4x4 translateMatrix = GetTranslationMatrix(s_currX, s_currY, s_currZ);
+
+#if USE_ORTHO_PROJECTION
+    const Matrix4x4 projectionMatrix = GetOrthoMatrix(-1.0f, 1.0f, -1.0f, 1.0f, 1.0f, 9.0f);
+#else
+    const Matrix4x4 projectionMatrix = GetFrustumMatrix(-1.0f, 1.0f, -1.0f, 1.0f, 1.0f, 9.0f);
+#endif
+
+    return MultiplyMatrix4x4(rotateMatrix, MultiplyMatrix4x4(translateMatrix, projectionMatrix));
+}
+
 static auto CreateRootSignature(ID3D12Device* d3d_device) -> ID3D12RootSignature*
 {
     ID3D12RootSignature* rootSignature = nullptr;
@@ -318,13 +345,8 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
         return result;
     }
 
-    // Set translations
-    struct { float rotAngle; float xOffset; float yOffset; float zOffset; } *pTranslations;
-    pTranslations = (decltype(pTranslations))hostMemPtr;
-    pTranslations->rotAngle = s_currAngle;
-    pTranslations->xOffset = s_currX;
-    pTranslations->yOffset = s_currY;
-    pTranslations->zOffset = s_currZ;
+    // Set the initial transform
+    ProjectionTestWriteConstantBuffer(hostMemPtr);
 
     constantBuffer->Unmap(0, nullptr);
 
@@ -364,6 +386,139 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
     return std::make_tuple(uploadDevHostBuffer, vertexBuffer, constantBuffer);
 }
 
+#if RUN_FRUSTUM_CULLING_BENCHMARK || RUN_BVH_BENCHMARK
+static constexpr uint32_t CULLING_BENCHMARK_OBJECT_COUNT = 256U * 1024U;
+
+// CULLING_BENCHMARK_OBJECT_COUNT random boxes in the object space of the triangle
+static auto CreateCullingBenchmarkObjects() -> FrustumCullingObjects
+{
+    uint32_t randomSeed = 0x12345678U;
+    auto const nextRandom = [&randomSeed]() -> float {
+        randomSeed = randomSeed * 1664525U + 1013904223U;
+        return float(randomSeed >> 8) / float(1U << 24);
+    };
+
+    // Boxes in a cube twice the size of the view volume around the triangle
+    FrustumCullingObjects objects;
+    for (uint32_t i = 0U; i < CULLING_BENCHMARK_OBJECT_COUNT; ++i)
+    {
+        const float center[3] = { -8.0f + 16.0f * nextRandom(), -8.0f + 16.0f * nextRandom(), -8.0f + 16.0f * nextRandom() };
+        const float halfSize = 0.02f + 0.1f * nextRandom();
+        const float boundsMin[3] = { center[0] - halfSize, center[1] - halfSize, center[2] - halfSize };
+        const float boundsMax[3] = { center[0] + halfSize, center[1] + halfSize, center[2] + halfSize };
+        AddFrustumCullingObject(objects, boundsMin, boundsMax);
+    }
+
+    return objects;
+}
+#endif
+
+#if RUN_FRUSTUM_CULLING_BENCHMARK
+static constexpr uint32_t FRUSTUM_CULLING_BENCHMARK_ITERATION_COUNT = 32U;
+
+// Culls the benchmark boxes against the view volume, checks that every kernel finds the same visible objects
+// as the scalar one and reports the throughput.
+static auto RunFrustumCullingBenchmark() -> bool
+{
+    const FrustumCullingObjects objects = CreateCullingBenchmarkObjects();
+    const FrustumPlanes planes = GetFrustumPlanes(GetMVPMatrix(), false);
+
+    std::vector<uint32_t> scalarVisibleIndices;
+    CullFrustumObjects(FrustumCullingKernel::Scalar, planes, objects, nullptr, scalarVisibleIndices);
+
+    ThreadPool* threadPool = CreateThreadPool(0U);
+
+    bool success = true;
+    for (const FrustumCullingKernel kernel : { FrustumCullingKernel::Scalar, FrustumCullingKernel::SSE, FrustumCullingKernel::AVX2 })
+    {
+        if (!IsFrustumCullingKernelSupported(kernel))
+        {
+            printf("Frustum culling %s kernel: not supported\n", GetFrustumCullingKernelName(kernel));
+            continue;
+        }
+
+        for (ThreadPool* const pool : { (ThreadPool*)nullptr, threadPool })
+        {
+            std::vector<uint32_t> visibleIndices;
+            CullFrustumObjects(kernel, planes, objects, pool, visibleIndices);
+            const bool identical = visibleIndices == scalarVisibleIndices;
+            success = success && identical;
+
+            const double objectsPerMillisecond = MeasureFrustumCullingThroughput(kernel, planes, objects, pool, FRUSTUM_CULLING_BENCHMARK_ITERATION_COUNT);
+            printf("Frustum culling %s kernel, %u thread(s): %.0f objects/ms, %zu of %u visible, %s\n", GetFrustumCullingKernelName(kernel),
+                    pool == nullptr ? 1U : GetThreadPoolThreadCount(pool), objectsPerMillisecond, visibleIndices.size(), CULLING_BENCHMARK_OBJECT_COUNT,
+                    identical ? "same as scalar" : "DIFFERS from scalar");
+        }
+    }
+
+    DestroyThreadPool(threadPool);
+
+    return success;
+}
+#endif
+
+#if RUN_BVH_BENCHMARK
+static constexpr uint32_t BVH_BENCHMARK_ITERATION_COUNT = 8U;
+static constexpr uint32_t BVH_BENCHMARK_RAY_COUNT = 64U * 1024U;
+
+// Culls the benchmark boxes through a bounding volume hierarchy, checks the result against the linear culling
+// and measures the hierarchy with rays from the camera through the near plane.
+static auto RunBvhBenchmark() -> bool
+{
+    const FrustumCullingObjects objects = CreateCullingBenchmarkObjects();
+    const FrustumPlanes planes = GetFrustumPlanes(GetMVPMatrix(), false);
+
+    ThreadPool* threadPool = CreateThreadPool(0U);
+
+    const Bvh bvh = BuildBvh(objects, threadPool);
+
+    std::vector<uint32_t> linearVisibleIndices;
+    std::vector<uint32_t> bvhVisibleIndices;
+    CullFrustumObjects(FrustumCullingKernel::Scalar, planes, objects, nullptr, linearVisibleIndices);
+    CullBvhFrustum(bvh, objects, planes, bvhVisibleIndices);
+    std::sort(bvhVisibleIndices.begin(), bvhVisibleIndices.end());
+
+    const bool identical = bvhVisibleIndices == linearVisibleIndices;
+    printf("BVH of %u objects: %zu nodes, %zu visible, %s\n", CULLING_BENCHMARK_OBJECT_COUNT, bvh.nodes.size(), bvhVisibleIndices.size(),
+            identical ? "same as linear culling" : "DIFFERS from linear culling");
+
+    // The camera sits at the origin of the view space, which the inverse of rotate * translate brings to the object space
+    const float rotateAxis[3] = { 1.0f, 0.0f, 0.0f };
+    const Matrix4x4 inverseRotateMatrix = TransposeMatrix4x4(GetRotationMatrix(GetQuaternionFromAxisAngle(rotateAxis, s_currAngle)));
+    float eye[4] = { -s_currX, -s_currY, -s_currZ, 1.0f };
+    TransformVector(eye, inverseRotateMatrix, eye);
+
+    // One ray through each cell of a 256 x 256 grid on the near plane of glFrustum(-1.0, 1.0, -1.0, 1.0, 1.0, 9.0)
+    std::vector<BvhRay> rays(BVH_BENCHMARK_RAY_COUNT);
+    uint32_t hitCount = 0U;
+    for (uint32_t i = 0U; i < BVH_BENCHMARK_RAY_COUNT; ++i)
+    {
+        float direction[4] = { -1.0f + (float(i % 256U) + 0.5f) / 128.0f, -1.0f + (float(i / 256U % 256U) + 0.5f) / 128.0f, -1.0f, 0.0f };
+        TransformVector(direction, inverseRotateMatrix, direction);
+
+        rays[i] = BvhRay{
+            .origin { eye[0], eye[1], eye[2] },
+            .direction { direction[0], direction[1], direction[2] },
+            .maxDistance = 9.0f
+        };
+        hitCount += IntersectBvhRay(bvh, objects, rays[i]).objectIndex != UINT32_MAX ? 1U : 0U;
+    }
+    printf("BVH ray picking: %u of %u rays hit a box\n", hitCount, BVH_BENCHMARK_RAY_COUNT);
+
+    for (ThreadPool* const pool : { (ThreadPool*)nullptr, threadPool })
+    {
+        const BvhThroughput throughput = MeasureBvhThroughput(objects, planes, rays, pool, BVH_BENCHMARK_ITERATION_COUNT);
+        printf("BVH %u thread(s): build %.0f objects/ms, refit %.0f objects/ms, frustum culling %.0f objects/ms, %.0f rays/ms\n",
+                pool == nullptr ? 1U : GetThreadPoolThreadCount(pool), throughput.buildObjectsPerMillisecond, throughput.refitObjectsPerMillisecond,
+                throughput.cullObjectsPerMillisecond, throughput.raysPerMillisecond);
+    }
+
+    DestroyThreadPool(threadPool);
+
+    return identical;
+}
+#endif
+
 auto CreateProjectionTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue *commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
                                     std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, bool>
 {
@@ -401,6 +556,18 @@ auto CreateProjectionTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue *co
     }
     while (false);
 
+#if RUN_FRUSTUM_CULLING_BENCHMARK
+    if (success && !RunFrustumCullingBenchmark()) {
+        fprintf(stderr, "Frustum culling benchmark failed!\n");
+    }
+#endif
+
+#if RUN_BVH_BENCHMARK
+    if (success && !RunBvhBenchmark()) {
+        fprintf(stderr, "BVH benchmark failed!\n");
+    }
+#endif
+
     return std::make_tuple(rootSignature, pipelineState, commandList, commandBundle, uploadDevHostBuffer, vertexBuffer, constantBuffer, success);
 }
 
@@ -459,3 +626,9 @@ auto ProjectionTestFetchTranslationSet() -> CommonTranslationSet
     };
 }
 
+// The matrix is computed once per frame on the CPU instead of once per vertex in proj_test.vs.hlsl
+auto ProjectionTestWriteConstantBuffer(void* hostMemPtr) -> void
+{
+    *(Matrix4x4*)hostMemPtr = GetMVPMatrix();
+}
+
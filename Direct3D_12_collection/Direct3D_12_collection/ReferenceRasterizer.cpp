@@ -0,0 +1,541 @@
+#include "ReferenceRasterizer.h"
+
+#include <cmath>
+#include <climits>
+#include <algorithm>
+#include <bit>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define REFERENCE_RASTER_USE_SSE2   1
+#else
+#define REFERENCE_RASTER_USE_SSE2   0
+#endif
+
+static constexpr int64_t SUBPIXEL_ONE = int64_t(1) << REFERENCE_RASTER_SUBPIXEL_BITS;
+static constexpr int64_t SUBPIXEL_HALF = SUBPIXEL_ONE / 2;
+
+// Standard sample patterns (D3D12_STANDARD_MULTISAMPLE_PATTERN) in 1/16 pixel units
+static constexpr int8_t s_samplePattern1[1][2] { { 0, 0 } };
+static constexpr int8_t s_samplePattern2[2][2] { { 4, 4 }, { -4, -4 } };
+static constexpr int8_t s_samplePattern4[4][2] { { -2, -6 }, { 6, -2 }, { -6, 2 }, { 2, 6 } };
+static constexpr int8_t s_samplePattern8[8][2] {
+    { 1, -3 }, { -1, 3 }, { 5, 1 }, { -3, -5 }, { -5, 5 }, { -7, -1 }, { 3, 7 }, { 7, -7 }
+};
+
+struct EdgeEquation
+{
+    int64_t a;      // coefficient of x
+    int64_t b;      // coefficient of y
+    int64_t c;      // constant term, with the fill rule bias folded in
+};
+
+struct SnappedVertex
+{
+    int64_t x;
+    int64_t y;
+    float z;        // normalized device z
+};
+
+auto GetReferenceRasterSamplePositions(uint32_t sampleCount) -> const int8_t(*)[2]
+{
+    switch (sampleCount)
+    {
+    case 2U:
+        return s_samplePattern2;
+    case 4U:
+        return s_samplePattern4;
+    case 8U:
+        return s_samplePattern8;
+    case 1U:
+    default:
+        return s_samplePattern1;
+    }
+}
+
+auto CreateReferenceRasterTarget(uint32_t width, uint32_t height, uint32_t sampleCount, float clearDepth) -> ReferenceRasterTarget
+{
+    if (sampleCount != 2U && sampleCount != 4U && sampleCount != 8U) {
+        sampleCount = 1U;
+    }
+
+    ReferenceRasterTarget target{
+        .width = width,
+        .height = height,
+        .sampleCount = sampleCount,
+        .depth = std::vector<float>(size_t(width) * height * sampleCount, clearDepth),
+        .primitiveIDs = std::vector<int32_t>(size_t(width) * height * sampleCount, -1),
+        .coverageCount = std::vector<uint32_t>(size_t(width) * height, 0U),
+        .invocationCount = 0U
+    };
+    return target;
+}
+
+// Round to nearest even, as required when converting to the 16.8 fixed-point format
+static inline auto SnapToSubpixel(float value) -> int64_t
+{
+    return int64_t(std::nearbyint(double(value) * double(SUBPIXEL_ONE)));
+}
+
+// For a clockwise (in screen space) triangle, E(p) = (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x)
+// is positive inside. Top edges are horizontal and go to the right, left edges go up.
+static inline auto SetupEdge(const SnappedVertex& va, const SnappedVertex& vb) -> EdgeEquation
+{
+    const int64_t dx = vb.x - va.x;
+    const int64_t dy = vb.y - va.y;
+    const bool isTopLeft = (dy == 0 && dx > 0) || dy < 0;
+
+    return EdgeEquation{
+        .a = -dy,
+        .b = dx,
+        // top-left edges include the samples lying exactly on them: E >= 0 <=> E + 1 > 0
+        .c = dy * va.x - dx * va.y + (isTopLeft ? 1 : 0)
+    };
+}
+
+static inline auto EvaluateEdge(const EdgeEquation& edge, int64_t x, int64_t y) -> int64_t
+{
+    return edge.a * x + edge.b * y + edge.c;
+}
+
+static inline auto FitsInInt32(int64_t value) -> bool
+{
+    return value > int64_t(INT32_MIN) && value < int64_t(INT32_MAX);
+}
+
+// Evaluates the coverage of one sample over an 8x8 pixel block.
+// (sampleX, sampleY) is the sample position of the top-left pixel of the block in the subpixel unit.
+// Bit (row * 8 + col) is set if the sample of that pixel lies inside the triangle.
+static auto EvaluateBlockCoverage(const EdgeEquation edges[3], int64_t sampleX, int64_t sampleY) -> uint64_t
+{
+    constexpr int64_t blockSpan = (REFERENCE_RASTER_BLOCK_SIZE - 1) * SUBPIXEL_ONE;
+
+    const EdgeEquation* partialEdges[3]{ };
+    int64_t originValues[3]{ };
+    int partialCount = 0;
+    bool fitsInInt32 = true;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const EdgeEquation& edge = edges[i];
+        const int64_t e00 = EvaluateEdge(edge, sampleX, sampleY);
+        const int64_t e10 = e00 + edge.a * blockSpan;
+        const int64_t e01 = e00 + edge.b * blockSpan;
+        const int64_t e11 = e10 + edge.b * blockSpan;
+
+        const int64_t minValue = std::min(std::min(e00, e10), std::min(e01, e11));
+        const int64_t maxValue = std::max(std::max(e00, e10), std::max(e01, e11));
+
+        // The whole block is outside this edge
+        if (maxValue <= 0) return 0U;
+        // The whole block is inside this edge
+        if (minValue > 0) continue;
+
+        fitsInInt32 = fitsInInt32 && FitsInInt32(minValue) && FitsInInt32(maxValue);
+        partialEdges[partialCount] = &edge;
+        originValues[partialCount] = e00;
+        ++partialCount;
+    }
+
+    if (partialCount == 0) return UINT64_MAX;
+
+    uint64_t mask = 0U;
+
+#if REFERENCE_RASTER_USE_SSE2
+    if (fitsInInt32)
+    {
+        // Every edge value inside the block lies between the corner values, so 32-bit lanes cannot overflow.
+        __m128i rowValues[3][2];
+        __m128i rowSteps[3];
+        for (int i = 0; i < partialCount; ++i)
+        {
+            const int32_t stepX = int32_t(partialEdges[i]->a * SUBPIXEL_ONE);
+            const int32_t stepY = int32_t(partialEdges[i]->b * SUBPIXEL_ONE);
+            const int32_t origin = int32_t(originValues[i]);
+            rowValues[i][0] = _mm_setr_epi32(origin, origin + stepX, origin + stepX * 2, origin + stepX * 3);
+            rowValues[i][1] = _mm_add_epi32(rowValues[i][0], _mm_set1_epi32(stepX * 4));
+            rowSteps[i] = _mm_set1_epi32(stepY);
+        }
+
+        const __m128i zero = _mm_setzero_si128();
+        for (int row = 0; row < REFERENCE_RASTER_BLOCK_SIZE; ++row)
+        {
+            __m128i inside0 = _mm_cmpgt_epi32(rowValues[0][0], zero);
+            __m128i inside1 = _mm_cmpgt_epi32(rowValues[0][1], zero);
+            for (int i = 1; i < partialCount; ++i)
+            {
+                inside0 = _mm_and_si128(inside0, _mm_cmpgt_epi32(rowValues[i][0], zero));
+                inside1 = _mm_and_si128(inside1, _mm_cmpgt_epi32(rowValues[i][1], zero));
+            }
+
+            const uint64_t rowMask = uint64_t(_mm_movemask_ps(_mm_castsi128_ps(inside0))) |
+                                    (uint64_t(_mm_movemask_ps(_mm_castsi128_ps(inside1))) << 4);
+            mask |= rowMask << (row * REFERENCE_RASTER_BLOCK_SIZE);
+
+            for (int i = 0; i < partialCount; ++i)
+            {
+                rowValues[i][0] = _mm_add_epi32(rowValues[i][0], rowSteps[i]);
+                rowValues[i][1] = _mm_add_epi32(rowValues[i][1], rowSteps[i]);
+            }
+        }
+
+        return mask;
+    }
+#endif
+
+    // Scalar fallback with 64-bit edge values
+    for (int row = 0; row < REFERENCE_RASTER_BLOCK_SIZE; ++row)
+    {
+        for (int col = 0; col < REFERENCE_RASTER_BLOCK_SIZE; ++col)
+        {
+            bool inside = true;
+            for (int i = 0; i < partialCount && inside; ++i) {
+                inside = originValues[i] + partialEdges[i]->a * col * SUBPIXEL_ONE + partialEdges[i]->b * row * SUBPIXEL_ONE > 0;
+            }
+            if (inside) {
+                mask |= uint64_t(1) << (row * REFERENCE_RASTER_BLOCK_SIZE + col);
+            }
+        }
+    }
+
+    return mask;
+}
+
+auto ReferenceRasterDrawTriangleList(ReferenceRasterTarget& target, const ReferenceRasterViewport& viewport, const ReferenceRasterState& state,
+                                    const float* positions, size_t vertexStride, uint32_t vertexCount, int32_t basePrimitiveID) -> uint64_t
+{
+    const uint32_t sampleCount = target.sampleCount;
+    const int8_t(*samplePositions)[2] = GetReferenceRasterSamplePositions(sampleCount);
+
+    // Pixels outside of the viewport are never touched, as if the primitive was clipped by the guard band.
+    const int viewportLeft = std::max(0, int(std::floor(viewport.topLeftX)));
+    const int viewportTop = std::max(0, int(std::floor(viewport.topLeftY)));
+    const int viewportRight = std::min(int(target.width), int(std::ceil(viewport.topLeftX + viewport.width)));
+    const int viewportBottom = std::min(int(target.height), int(std::ceil(viewport.topLeftY + viewport.height)));
+    if (viewportLeft >= viewportRight || viewportTop >= viewportBottom) return 0U;
+
+    const float depthRange = viewport.maxDepth - viewport.minDepth;
+    const float depthMin = std::min(viewport.minDepth, viewport.maxDepth);
+    const float depthMax = std::max(viewport.minDepth, viewport.maxDepth);
+
+    uint64_t invocationCount = 0U;
+    uint8_t blockSampleMasks[REFERENCE_RASTER_BLOCK_SIZE * REFERENCE_RASTER_BLOCK_SIZE];
+
+    for (uint32_t primIndex = 0U; primIndex + 3U <= vertexCount; primIndex += 3U)
+    {
+        SnappedVertex verts[3];
+        bool isValid = true;
+        for (uint32_t i = 0U; i < 3U; ++i)
+        {
+            const float* pos = (const float*)((const uint8_t*)positions + vertexStride * (primIndex + i));
+            if (!(pos[3] > 0.0f))
+            {
+                isValid = false;
+                break;
+            }
+
+            const float invW = 1.0f / pos[3];
+            const float screenX = viewport.topLeftX + (pos[0] * invW + 1.0f) * 0.5f * viewport.width;
+            const float screenY = viewport.topLeftY + (1.0f - pos[1] * invW) * 0.5f * viewport.height;
+            verts[i] = SnappedVertex{ .x = SnapToSubpixel(screenX), .y = SnapToSubpixel(screenY), .z = pos[2] * invW };
+        }
+        if (!isValid) continue;
+
+        // Twice the signed area in the subpixel unit; make the triangle clockwise since the culling mode is irrelevant here.
+        int64_t area = (verts[1].x - verts[0].x) * (verts[2].y - verts[0].y) - (verts[1].y - verts[0].y) * (verts[2].x - verts[0].x);
+        if (area == 0) continue;
+        if (area < 0)
+        {
+            std::swap(verts[1], verts[2]);
+            area = -area;
+        }
+
+        // edges[i] is the edge opposite to verts[i]
+        const EdgeEquation edges[3]{
+            SetupEdge(verts[1], verts[2]),
+            SetupEdge(verts[2], verts[0]),
+            SetupEdge(verts[0], verts[1])
+        };
+
+        // Depth plane relative to verts[0]: z = z0 + zdx * (x - x0) + zdy * (y - y0), using the unbiased edge gradients
+        const double invArea = 1.0 / double(area);
+        const double dz1 = double(verts[1].z) - double(verts[0].z);
+        const double dz2 = double(verts[2].z) - double(verts[0].z);
+        const double zdx = (dz1 * double(edges[1].a) + dz2 * double(edges[2].a)) * invArea;
+        const double zdy = (dz1 * double(edges[1].b) + dz2 * double(edges[2].b)) * invArea;
+
+        // Pixel bounding box, extended by one pixel to take every sample offset into account
+        const int64_t minX = std::min({ verts[0].x, verts[1].x, verts[2].x });
+        const int64_t maxX = std::max({ verts[0].x, verts[1].x, verts[2].x });
+        const int64_t minY = std::min({ verts[0].y, verts[1].y, verts[2].y });
+        const int64_t maxY = std::max({ verts[0].y, verts[1].y, verts[2].y });
+
+        const int boxLeft = int(std::max<int64_t>(viewportLeft, (minX >> REFERENCE_RASTER_SUBPIXEL_BITS) - 1));
+        const int boxTop = int(std::max<int64_t>(viewportTop, (minY >> REFERENCE_RASTER_SUBPIXEL_BITS) - 1));
+        const int boxRight = int(std::min<int64_t>(viewportRight, (maxX >> REFERENCE_RASTER_SUBPIXEL_BITS) + 2));
+        const int boxBottom = int(std::min<int64_t>(viewportBottom, (maxY >> REFERENCE_RASTER_SUBPIXEL_BITS) + 2));
+        if (boxLeft >= boxRight || boxTop >= boxBottom) continue;
+
+        const int32_t primitiveID = basePrimitiveID + int32_t(primIndex / 3U);
+
+        // Walk the 8x8 blocks aligned to the render target origin
+        const int blockLeft = boxLeft & ~(REFERENCE_RASTER_BLOCK_SIZE - 1);
+        const int blockTop = boxTop & ~(REFERENCE_RASTER_BLOCK_SIZE - 1);
+        for (int by = blockTop; by < boxBottom; by += REFERENCE_RASTER_BLOCK_SIZE)
+        {
+            for (int bx = blockLeft; bx < boxRight; bx += REFERENCE_RASTER_BLOCK_SIZE)
+            {
+                // Mask out the pixels of this block that lie outside of the bounding box
+                uint64_t boundMask = 0U;
+                for (int row = 0; row < REFERENCE_RASTER_BLOCK_SIZE; ++row)
+                {
+                    const int y = by + row;
+                    if (y < boxTop || y >= boxBottom) continue;
+
+                    const int colBegin = std::max(0, boxLeft - bx);
+                    const int colEnd = std::min(REFERENCE_RASTER_BLOCK_SIZE, boxRight - bx);
+                    for (int col = colBegin; col < colEnd; ++col) {
+                        boundMask |= uint64_t(1) << (row * REFERENCE_RASTER_BLOCK_SIZE + col);
+                    }
+                }
+
+                bool anyCovered = false;
+                std::fill(std::begin(blockSampleMasks), std::end(blockSampleMasks), uint8_t(0));
+
+                for (uint32_t s = 0U; s < sampleCount; ++s)
+                {
+                    const int64_t sampleX = int64_t(bx) * SUBPIXEL_ONE + SUBPIXEL_HALF + samplePositions[s][0] * (SUBPIXEL_ONE / 16);
+                    const int64_t sampleY = int64_t(by) * SUBPIXEL_ONE + SUBPIXEL_HALF + samplePositions[s][1] * (SUBPIXEL_ONE / 16);
+
+                    uint64_t mask = EvaluateBlockCoverage(edges, sampleX, sampleY) & boundMask;
+                    if (mask == 0U) continue;
+
+                    anyCovered = true;
+                    while (mask != 0U)
+                    {
+                        const int bit = std::countr_zero(mask);
+                        mask &= mask - 1U;
+                        blockSampleMasks[bit] |= uint8_t(1U << s);
+                    }
+                }
+
+                if (!anyCovered) continue;
+
+                for (int bit = 0; bit < REFERENCE_RASTER_BLOCK_SIZE * REFERENCE_RASTER_BLOCK_SIZE; ++bit)
+                {
+                    uint32_t sampleMask = blockSampleMasks[bit];
+                    if (sampleMask == 0U) continue;
+
+                    const int x = bx + (bit % REFERENCE_RASTER_BLOCK_SIZE);
+                    const int y = by + (bit / REFERENCE_RASTER_BLOCK_SIZE);
+                    const size_t pixelIndex = size_t(y) * target.width + size_t(x);
+
+                    bool isCovered = false;
+                    bool isPassed = false;
+                    for (uint32_t s = 0U; s < sampleCount; ++s)
+                    {
+                        if ((sampleMask & (1U << s)) == 0U) continue;
+
+                        const int64_t sx = int64_t(x) * SUBPIXEL_ONE + SUBPIXEL_HALF + samplePositions[s][0] * (SUBPIXEL_ONE / 16);
+                        const int64_t sy = int64_t(y) * SUBPIXEL_ONE + SUBPIXEL_HALF + samplePositions[s][1] * (SUBPIXEL_ONE / 16);
+                        const double ndcZ = double(verts[0].z) + zdx * double(sx - verts[0].x) + zdy * double(sy - verts[0].y);
+
+                        // Depth clipping removes the sample from the primitive coverage
+                        if (state.depthClipEnable && (ndcZ < 0.0 || ndcZ > 1.0)) continue;
+                        isCovered = true;
+
+                        const float depth = std::clamp(float(viewport.minDepth + ndcZ * depthRange), depthMin, depthMax);
+                        const size_t sampleIndex = pixelIndex * sampleCount + s;
+                        if (state.depthEnable && !(depth < target.depth[sampleIndex])) continue;
+
+                        isPassed = true;
+                        if (state.depthEnable && state.depthWriteEnable) {
+                            target.depth[sampleIndex] = depth;
+                        }
+                        target.primitiveIDs[sampleIndex] = primitiveID;
+                    }
+
+                    if (isCovered) {
+                        ++target.coverageCount[pixelIndex];
+                    }
+                    if (isPassed) {
+                        ++invocationCount;
+                    }
+                }
+            }
+        }
+    }
+
+    target.invocationCount += invocationCount;
+    return invocationCount;
+}
+
+// Tests whether the axis-aligned square [x0, x1] x [y0, y1] (in the subpixel unit) overlaps the half plane E > 0,
+// or E >= 0 when `inclusive` is set. The corner that maximizes the edge function decides it.
+static inline auto SquareOverlapsEdge(const EdgeEquation& edge, int64_t x0, int64_t y0, int64_t x1, int64_t y1, bool inclusive) -> bool
+{
+    const int64_t value = EvaluateEdge(edge, edge.a > 0 ? x1 : x0, edge.b > 0 ? y1 : y0);
+    return inclusive ? value >= 0 : value > 0;
+}
+
+// Tests whether the whole square lies in the half plane E >= 0. The corner that minimizes the edge function decides it.
+static inline auto SquareInsideEdge(const EdgeEquation& edge, int64_t x0, int64_t y0, int64_t x1, int64_t y1) -> bool
+{
+    return EvaluateEdge(edge, edge.a > 0 ? x0 : x1, edge.b > 0 ? y0 : y1) >= 0;
+}
+
+auto ReferenceRasterConservativeTriangleList(uint32_t width, uint32_t height, const ReferenceRasterViewport& viewport, uint32_t tier,
+                                            const float* positions, size_t vertexStride, uint32_t vertexCount) -> ReferenceConservativeRasterResult
+{
+    const int64_t uncertainty = tier <= 1U ? SUBPIXEL_HALF : 1;
+
+    ReferenceConservativeRasterResult result{
+        .width = width,
+        .height = height,
+        .uncertaintyInSubpixels = uint32_t(uncertainty),
+        .coverageCount = std::vector<uint32_t>(size_t(width) * height, 0U),
+        .uncertainCount = std::vector<uint32_t>(size_t(width) * height, 0U),
+        .innerCoverageCount = std::vector<uint32_t>(size_t(width) * height, 0U),
+        .minInvocationCount = 0U,
+        .maxInvocationCount = 0U,
+        .innerInvocationCount = 0U
+    };
+
+    const int viewportLeft = std::max(0, int(std::floor(viewport.topLeftX)));
+    const int viewportTop = std::max(0, int(std::floor(viewport.topLeftY)));
+    const int viewportRight = std::min(int(width), int(std::ceil(viewport.topLeftX + viewport.width)));
+    const int viewportBottom = std::min(int(height), int(std::ceil(viewport.topLeftY + viewport.height)));
+    if (viewportLeft >= viewportRight || viewportTop >= viewportBottom) return result;
+
+    for (uint32_t primIndex = 0U; primIndex + 3U <= vertexCount; primIndex += 3U)
+    {
+        SnappedVertex verts[3];
+        bool isValid = true;
+        for (uint32_t i = 0U; i < 3U; ++i)
+        {
+            const float* pos = (const float*)((const uint8_t*)positions + vertexStride * (primIndex + i));
+            if (!(pos[3] > 0.0f))
+            {
+                isValid = false;
+                break;
+            }
+
+            const float invW = 1.0f / pos[3];
+            const float screenX = viewport.topLeftX + (pos[0] * invW + 1.0f) * 0.5f * viewport.width;
+            const float screenY = viewport.topLeftY + (1.0f - pos[1] * invW) * 0.5f * viewport.height;
+            verts[i] = SnappedVertex{ .x = SnapToSubpixel(screenX), .y = SnapToSubpixel(screenY), .z = pos[2] * invW };
+        }
+        if (!isValid) continue;
+
+        int64_t area = (verts[1].x - verts[0].x) * (verts[2].y - verts[0].y) - (verts[1].y - verts[0].y) * (verts[2].x - verts[0].x);
+        const bool isDegenerate = area == 0;
+        if (isDegenerate && tier <= 1U) continue;
+        if (area < 0)
+        {
+            std::swap(verts[1], verts[2]);
+            area = -area;
+        }
+
+        EdgeEquation edges[3]{ };
+        int edgeCount = 0;
+        if (!isDegenerate)
+        {
+            const int indices[3][2]{ { 1, 2 }, { 2, 0 }, { 0, 1 } };
+            for (const auto& index : indices)
+            {
+                const int64_t dx = verts[index[1]].x - verts[index[0]].x;
+                const int64_t dy = verts[index[1]].y - verts[index[0]].y;
+                edges[edgeCount++] = EdgeEquation{ .a = -dy, .b = dx, .c = dy * verts[index[0]].x - dx * verts[index[0]].y };
+            }
+        }
+        else
+        {
+            // A degenerate triangle is the segment between its two farthest vertices (or a single point).
+            // Both sides of the segment line are tested, so that the square must straddle or touch the line.
+            int p = 0, q = 1;
+            int64_t maxDistance = -1;
+            for (int i = 0; i < 3; ++i)
+            {
+                for (int j = i + 1; j < 3; ++j)
+                {
+                    const int64_t distance = std::abs(verts[j].x - verts[i].x) + std::abs(verts[j].y - verts[i].y);
+                    if (distance > maxDistance)
+                    {
+                        maxDistance = distance;
+                        p = i;
+                        q = j;
+                    }
+                }
+            }
+
+            if (maxDistance > 0)
+            {
+                const int64_t dx = verts[q].x - verts[p].x;
+                const int64_t dy = verts[q].y - verts[p].y;
+                edges[edgeCount++] = EdgeEquation{ .a = -dy, .b = dx, .c = dy * verts[p].x - dx * verts[p].y };
+                edges[edgeCount++] = EdgeEquation{ .a = dy, .b = -dx, .c = -(dy * verts[p].x - dx * verts[p].y) };
+            }
+        }
+
+        const int64_t minX = std::min({ verts[0].x, verts[1].x, verts[2].x });
+        const int64_t maxX = std::max({ verts[0].x, verts[1].x, verts[2].x });
+        const int64_t minY = std::min({ verts[0].y, verts[1].y, verts[2].y });
+        const int64_t maxY = std::max({ verts[0].y, verts[1].y, verts[2].y });
+
+        const int boxLeft = int(std::max<int64_t>(viewportLeft, (minX - uncertainty) >> REFERENCE_RASTER_SUBPIXEL_BITS));
+        const int boxTop = int(std::max<int64_t>(viewportTop, (minY - uncertainty) >> REFERENCE_RASTER_SUBPIXEL_BITS));
+        const int boxRight = int(std::min<int64_t>(viewportRight, ((maxX + uncertainty) >> REFERENCE_RASTER_SUBPIXEL_BITS) + 1));
+        const int boxBottom = int(std::min<int64_t>(viewportBottom, ((maxY + uncertainty) >> REFERENCE_RASTER_SUBPIXEL_BITS) + 1));
+
+        // Separating axis test between the pixel square and the triangle: the bounding box axes and the edge normals
+        const auto overlaps = [&](int64_t x0, int64_t y0, int64_t x1, int64_t y1) -> bool {
+            if (isDegenerate)
+            {
+                if (x0 > maxX || x1 < minX || y0 > maxY || y1 < minY) return false;
+            }
+            else if (x0 >= maxX || x1 <= minX || y0 >= maxY || y1 <= minY) return false;
+
+            for (int i = 0; i < edgeCount; ++i)
+            {
+                if (!SquareOverlapsEdge(edges[i], x0, y0, x1, y1, isDegenerate)) return false;
+            }
+            return true;
+        };
+
+        for (int y = boxTop; y < boxBottom; ++y)
+        {
+            for (int x = boxLeft; x < boxRight; ++x)
+            {
+                const int64_t x0 = int64_t(x) * SUBPIXEL_ONE;
+                const int64_t y0 = int64_t(y) * SUBPIXEL_ONE;
+                const int64_t x1 = x0 + SUBPIXEL_ONE;
+                const int64_t y1 = y0 + SUBPIXEL_ONE;
+                const size_t pixelIndex = size_t(y) * width + size_t(x);
+
+                if (overlaps(x0, y0, x1, y1))
+                {
+                    ++result.coverageCount[pixelIndex];
+                    ++result.minInvocationCount;
+                    ++result.maxInvocationCount;
+
+                    bool isInner = !isDegenerate;
+                    for (int i = 0; i < edgeCount && isInner; ++i) {
+                        isInner = SquareInsideEdge(edges[i], x0, y0, x1, y1);
+                    }
+                    if (isInner)
+                    {
+                        ++result.innerCoverageCount[pixelIndex];
+                        ++result.innerInvocationCount;
+                    }
+                }
+                else if (overlaps(x0 - uncertainty, y0 - uncertainty, x1 + uncertainty, y1 + uncertainty))
+                {
+                    ++result.uncertainCount[pixelIndex];
+                    ++result.maxInvocationCount;
+                }
+            }
+        }
+    }
+
+    return result;
+}
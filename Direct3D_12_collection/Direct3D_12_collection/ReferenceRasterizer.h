@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// CPU reference rasterizer following the Direct3D 12 rasterization rules:
+// 16.8 fixed-point vertex snapping, the top-left fill rule, standard sample pattern coverage
+// and per-sample depth interpolation.
+
+static constexpr int REFERENCE_RASTER_SUBPIXEL_BITS = 8;
+static constexpr int REFERENCE_RASTER_BLOCK_SIZE = 8;
+static constexpr uint32_t REFERENCE_RASTER_MAX_SAMPLE_COUNT = 8U;
+
+struct ReferenceRasterViewport
+{
+    float topLeftX;
+    float topLeftY;
+    float width;
+    float height;
+    float minDepth;
+    float maxDepth;
+};
+
+struct ReferenceRasterState
+{
+    uint32_t sampleCount;       // 1, 2, 4 or 8 with the D3D12 standard sample patterns
+    bool depthClipEnable;
+    bool depthEnable;           // depth test with D3D12_COMPARISON_FUNC_LESS, [earlydepthstencil] semantics
+    bool depthWriteEnable;
+};
+
+struct ReferenceRasterTarget
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t sampleCount;
+
+    // Per-sample buffers, indexed with (y * width + x) * sampleCount + sampleIndex
+    std::vector<float> depth;
+    std::vector<int32_t> primitiveIDs;      // -1 means the sample is not covered by any primitive
+
+    // Per-pixel buffer: the number of primitives that covered at least one sample of the pixel
+    std::vector<uint32_t> coverageCount;
+
+    // Total pixel shader invocations (one per pixel per primitive that survives the early depth test)
+    uint64_t invocationCount;
+};
+
+extern auto CreateReferenceRasterTarget(uint32_t width, uint32_t height, uint32_t sampleCount, float clearDepth) -> ReferenceRasterTarget;
+
+// positions point to the first clip-space float4 position. Consecutive vertices are `vertexStride` bytes apart.
+// Every 3 vertices compose a triangle (triangle list topology). Triangles with any w <= 0 are skipped.
+// @return the number of pixel shader invocations produced by this draw
+extern auto ReferenceRasterDrawTriangleList(ReferenceRasterTarget& target, const ReferenceRasterViewport& viewport, const ReferenceRasterState& state,
+                                            const float* positions, size_t vertexStride, uint32_t vertexCount, int32_t basePrimitiveID) -> uint64_t;
+
+// Sample offsets in 1/16 pixel units, relative to the pixel center
+extern auto GetReferenceRasterSamplePositions(uint32_t sampleCount) -> const int8_t(*)[2];
+
+// Conservative rasterization model. The tier values match D3D12_CONSERVATIVE_RASTERIZATION_TIER:
+// tier 1 has a 1/2 pixel uncertainty region and culls degenerate triangles after snapping,
+// tier 2 reduces the uncertainty region to 1/256 pixel and keeps degenerate triangles,
+// tier 3 additionally exposes SV_InnerCoverage.
+struct ReferenceConservativeRasterResult
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t uncertaintyInSubpixels;
+
+    // Per-pixel buffers, indexed with (y * width + x)
+    std::vector<uint32_t> coverageCount;        // primitives whose area certainly overlaps the pixel
+    std::vector<uint32_t> uncertainCount;       // primitives that only overlap the pixel within the uncertainty region
+    std::vector<uint32_t> innerCoverageCount;   // primitives that fully cover the pixel (SV_InnerCoverage is nonzero)
+
+    // Pixel shader invocations: the hardware may produce any count between the minimum and the maximum
+    uint64_t minInvocationCount;
+    uint64_t maxInvocationCount;
+    uint64_t innerInvocationCount;
+};
+
+extern auto ReferenceRasterConservativeTriangleList(uint32_t width, uint32_t height, const ReferenceRasterViewport& viewport, uint32_t tier,
+                                                    const float* positions, size_t vertexStride, uint32_t vertexCount) -> ReferenceConservativeRasterResult;
@@ -1,5 +1,8 @@
 #include "common.h"
+#include "VectorPath.h"
 
+// Fill vector paths with target independent rasterization and compare them with an MSAA stencil-then-cover baseline
+#define TEST_PATH_RENDERING     1
 
 static constexpr UINT TEXTURE_SIZE = WINDOW_WIDTH / 8U;
 static constexpr UINT TEXTURE_SAMPLE_COUNT = 1U;
@@ -8,6 +11,17 @@ static constexpr UINT FORCE_SAMPLE_COUNT = 4U;
 static constexpr UINT GRAPHICS_PIPELINE_SAMPLE_MASK = UINT32_MAX * 1U;
 static constexpr UINT uavBufferSize = 64U;
 
+#if TEST_PATH_RENDERING
+static constexpr UINT PATH_TARGET_SIZE = WINDOW_WIDTH;
+static constexpr UINT PATH_FORCED_SAMPLE_COUNT = 16U;           // 8 or 16
+static constexpr UINT PATH_BASELINE_SAMPLE_COUNT = 8U;
+static constexpr UINT PATH_COUNT = 3000U;
+static constexpr UINT PATH_MAX_BATCH_PATH_COUNT = 256U;
+static constexpr UINT PATH_BENCHMARK_ITERATION_COUNT = 16U;
+static constexpr float PATH_FLATTEN_TOLERANCE = 0.25f;          // in pixels
+static constexpr PathFillRule PATH_FILL_RULE = PATH_FILL_RULE_NON_ZERO;
+#endif
+
 enum CBV_SRV_UAV_SLOT_ID
 {
     SRV_DEPTH_TEXTURE_SLOT,
@@ -1049,6 +1063,937 @@ static auto PopulateCommandList(ID3D12GraphicsCommandList* commandBundle, ID3D12
     return true;
 }
 
+#if TEST_PATH_RENDERING
+static auto CreateRootSignatureForPathRendering(ID3D12Device* d3d_device) -> ID3D12RootSignature*
+{
+    ID3D12RootSignature* rootSignature = nullptr;
+
+    // u0 (for winding counters or coverage masks)
+    const D3D12_DESCRIPTOR_RANGE descRange{
+        .RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV,
+        .NumDescriptors = 1,
+        .BaseShaderRegister = 0,
+        .RegisterSpace = 0,
+        .OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND
+    };
+
+    const D3D12_ROOT_PARAMETER rootParameters[]{
+        // u0
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE,
+            .DescriptorTable {
+                .NumDescriptorRanges = 1,
+                .pDescriptorRanges = &descRange
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL
+        },
+        // b0 (for target size, sample count and fill rule)
+        {
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+            .Constants {
+                .ShaderRegister = 0,
+                .RegisterSpace = 0,
+                .Num32BitValues = 4
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        }
+    };
+
+    // Create a root signature.
+    const D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc{
+        .NumParameters = (UINT)std::size(rootParameters),
+        .pParameters = rootParameters,
+        .NumStaticSamplers = 0,
+        .pStaticSamplers = nullptr,
+        .Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_AMPLIFICATION_SHADER_ROOT_ACCESS | D3D12_ROOT_SIGNATURE_FLAG_DENY_MESH_SHADER_ROOT_ACCESS
+    };
+
+    ID3DBlob* signature = nullptr;
+    ID3DBlob* error = nullptr;
+    HRESULT hRes = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error);
+    do
+    {
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "D3D12SerializeRootSignature for path rendering failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateRootSignature for path rendering failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (signature != nullptr) {
+        signature->Release();
+    }
+    if (error != nullptr) {
+        error->Release();
+    }
+
+    if (FAILED(hRes)) return nullptr;
+
+    return rootSignature;
+}
+
+// @return [coveragePipelineState, resolvePipelineState, baselineStencilPipelineState, baselineCoverPipelineState]
+static auto CreatePipelineStatesForPathRendering(ID3D12Device* d3d_device, ID3D12RootSignature* rootSignature) ->
+                                                std::tuple<ID3D12PipelineState*, ID3D12PipelineState*, ID3D12PipelineState*, ID3D12PipelineState*>
+{
+    ID3D12PipelineState* coveragePipelineState = nullptr;
+    ID3D12PipelineState* resolvePipelineState = nullptr;
+    ID3D12PipelineState* baselineStencilPipelineState = nullptr;
+    ID3D12PipelineState* baselineCoverPipelineState = nullptr;
+
+    D3D12_SHADER_BYTECODE vertexShaderObj = CreateCompiledShaderObjectFromPath("cso/tir_path.vert.cso");
+    D3D12_SHADER_BYTECODE coveragePixelShaderObj = CreateCompiledShaderObjectFromPath("cso/tir_path_coverage.frag.cso");
+    D3D12_SHADER_BYTECODE resolvePixelShaderObj = CreateCompiledShaderObjectFromPath("cso/tir_path_resolve.frag.cso");
+    D3D12_SHADER_BYTECODE colorPixelShaderObj = CreateCompiledShaderObjectFromPath("cso/tir_path_color.frag.cso");
+
+    do
+    {
+        if (vertexShaderObj.pShaderBytecode == nullptr || vertexShaderObj.BytecodeLength == 0) break;
+        if (coveragePixelShaderObj.pShaderBytecode == nullptr || coveragePixelShaderObj.BytecodeLength == 0) break;
+        if (resolvePixelShaderObj.pShaderBytecode == nullptr || resolvePixelShaderObj.BytecodeLength == 0) break;
+        if (colorPixelShaderObj.pShaderBytecode == nullptr || colorPixelShaderObj.BytecodeLength == 0) break;
+
+        // The same layout as PathVertex
+        const D3D12_INPUT_ELEMENT_DESC inputElementDescs[]{
+            { "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        // Premultiplied alpha blending
+        const D3D12_BLEND_DESC coverBlendDesc{
+            .AlphaToCoverageEnable = FALSE,
+            .IndependentBlendEnable = FALSE,
+            .RenderTarget {
+                // RenderTarget[0]
+                {
+                    .BlendEnable = TRUE,
+                    .LogicOpEnable = FALSE,
+                    .SrcBlend = D3D12_BLEND_ONE,
+                    .DestBlend = D3D12_BLEND_INV_SRC_ALPHA,
+                    .BlendOp = D3D12_BLEND_OP_ADD,
+                    .SrcBlendAlpha = D3D12_BLEND_ONE,
+                    .DestBlendAlpha = D3D12_BLEND_INV_SRC_ALPHA,
+                    .BlendOpAlpha = D3D12_BLEND_OP_ADD,
+                    .LogicOp = D3D12_LOGIC_OP_NOOP,
+                    .RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL
+                }
+            }
+        };
+
+        // Fan triangles have both windings, so nothing is culled
+        const D3D12_RASTERIZER_DESC rasterizerDesc{
+            .FillMode = D3D12_FILL_MODE_SOLID,
+            .CullMode = D3D12_CULL_MODE_NONE,
+            .FrontCounterClockwise = FALSE,
+            .DepthBias = 0,
+            .DepthBiasClamp = 0.0f,
+            .SlopeScaledDepthBias = 0.0f,
+            .DepthClipEnable = TRUE,
+            .MultisampleEnable = FALSE,
+            .AntialiasedLineEnable = FALSE,
+            .ForcedSampleCount = 0,
+            .ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF
+        };
+
+        const D3D12_DEPTH_STENCIL_DESC noDepthStencilDesc{
+            .DepthEnable = FALSE,
+            .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO,
+            .DepthFunc = D3D12_COMPARISON_FUNC_NEVER,
+            .StencilEnable = FALSE,
+            .StencilReadMask = 0,
+            .StencilWriteMask = 0,
+            .FrontFace { },
+            .BackFace { }
+        };
+
+        // TIR coverage pass: UAV-only rendering, so no render target and no depth stencil view is bound
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc{
+            .pRootSignature = rootSignature,
+            .VS = vertexShaderObj,
+            .PS = coveragePixelShaderObj,
+            .BlendState = coverBlendDesc,
+            .SampleMask = UINT32_MAX,
+            .RasterizerState = rasterizerDesc,
+            .DepthStencilState = noDepthStencilDesc,
+            .InputLayout {
+                .pInputElementDescs = inputElementDescs,
+                .NumElements = (UINT)std::size(inputElementDescs)
+            },
+            .IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED,
+            .PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+            .NumRenderTargets = 0,
+            .RTVFormats { },
+            .DSVFormat = DXGI_FORMAT_UNKNOWN,   // ATTENTION!! When ForcedSampleCount is not 0, DSVFormat MUST BE DXGI_FORMAT_UNKNOWN to indicate that the DepthStencilView is not bound.
+            .SampleDesc {
+                .Count = 1,
+                .Quality = 0
+            },
+            .NodeMask = 0,
+            .CachedPSO { },
+            .Flags = D3D12_PIPELINE_STATE_FLAG_NONE
+        };
+        psoDesc.RasterizerState.ForcedSampleCount = PATH_FORCED_SAMPLE_COUNT;
+
+        HRESULT hRes = d3d_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&coveragePipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateGraphicsPipelineState for path coverage PSO failed: %ld\n", hRes);
+            break;
+        }
+
+        // TIR cover pass: the single-sample render target
+        psoDesc.PS = resolvePixelShaderObj;
+        psoDesc.RasterizerState.ForcedSampleCount = 0;
+        psoDesc.NumRenderTargets = 1;
+        psoDesc.RTVFormats[0] = RENDER_TARGET_BUFFER_FOMRAT;
+
+        hRes = d3d_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&resolvePipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateGraphicsPipelineState for path resolve PSO failed: %ld\n", hRes);
+            break;
+        }
+
+        // Baseline stencil pass: the fan triangles update the stencil values of the MSAA samples without color writes
+        const bool evenOdd = PATH_FILL_RULE == PATH_FILL_RULE_EVEN_ODD;
+        psoDesc.PS = { };
+        psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = 0;
+        psoDesc.RasterizerState.MultisampleEnable = TRUE;
+        psoDesc.DepthStencilState.StencilEnable = TRUE;
+        psoDesc.DepthStencilState.StencilReadMask = D3D12_DEFAULT_STENCIL_READ_MASK;
+        psoDesc.DepthStencilState.StencilWriteMask = D3D12_DEFAULT_STENCIL_WRITE_MASK;
+        psoDesc.DepthStencilState.FrontFace = {
+            .StencilFailOp = D3D12_STENCIL_OP_KEEP,
+            .StencilDepthFailOp = D3D12_STENCIL_OP_KEEP,
+            .StencilPassOp = evenOdd ? D3D12_STENCIL_OP_INVERT : D3D12_STENCIL_OP_INCR,
+            .StencilFunc = D3D12_COMPARISON_FUNC_ALWAYS
+        };
+        psoDesc.DepthStencilState.BackFace = psoDesc.DepthStencilState.FrontFace;
+        psoDesc.DepthStencilState.BackFace.StencilPassOp = evenOdd ? D3D12_STENCIL_OP_INVERT : D3D12_STENCIL_OP_DECR;
+        psoDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+        psoDesc.SampleDesc.Count = PATH_BASELINE_SAMPLE_COUNT;
+
+        hRes = d3d_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&baselineStencilPipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateGraphicsPipelineState for path baseline stencil PSO failed: %ld\n", hRes);
+            break;
+        }
+
+        // Baseline cover pass: colors the samples with a non-zero stencil value (or an odd one) and resets them
+        psoDesc.PS = colorPixelShaderObj;
+        psoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+        psoDesc.DepthStencilState.StencilReadMask = evenOdd ? 0x01 : D3D12_DEFAULT_STENCIL_READ_MASK;
+        psoDesc.DepthStencilState.FrontFace = {
+            .StencilFailOp = D3D12_STENCIL_OP_KEEP,
+            .StencilDepthFailOp = D3D12_STENCIL_OP_KEEP,
+            .StencilPassOp = D3D12_STENCIL_OP_ZERO,
+            .StencilFunc = D3D12_COMPARISON_FUNC_NOT_EQUAL
+        };
+        psoDesc.DepthStencilState.BackFace = psoDesc.DepthStencilState.FrontFace;
+
+        hRes = d3d_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&baselineCoverPipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateGraphicsPipelineState for path baseline cover PSO failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (vertexShaderObj.pShaderBytecode != nullptr) {
+        free((void*)vertexShaderObj.pShaderBytecode);
+    }
+    if (coveragePixelShaderObj.pShaderBytecode != nullptr) {
+        free((void*)coveragePixelShaderObj.pShaderBytecode);
+    }
+    if (resolvePixelShaderObj.pShaderBytecode != nullptr) {
+        free((void*)resolvePixelShaderObj.pShaderBytecode);
+    }
+    if (colorPixelShaderObj.pShaderBytecode != nullptr) {
+        free((void*)colorPixelShaderObj.pShaderBytecode);
+    }
+
+    return std::make_tuple(coveragePipelineState, resolvePipelineState, baselineStencilPipelineState, baselineCoverPipelineState);
+}
+
+// Random self-intersecting stars, circles and rounded rectangles
+static auto CreatePathRenderingTestPaths() -> std::vector<VectorPath>
+{
+    std::vector<VectorPath> paths(PATH_COUNT);
+
+    uint32_t randomSeed = 0x2468aceU;
+    auto const nextRandom = [&randomSeed]() -> float {
+        randomSeed = randomSeed * 1664525U + 1013904223U;
+        return float(randomSeed >> 8) / float(1U << 24);
+    };
+
+    constexpr float pi = 3.14159265358979f;
+    // Control point distance of the cubic Bezier approximation of a quarter circle
+    constexpr float kappa = 0.5522847f;
+
+    for (UINT i = 0; i < PATH_COUNT; ++i)
+    {
+        VectorPath& path = paths[i];
+        const float centerX = nextRandom() * float(PATH_TARGET_SIZE);
+        const float centerY = nextRandom() * float(PATH_TARGET_SIZE);
+        const float radius = 4.0f + 28.0f * nextRandom();
+        path.color[0] = nextRandom();
+        path.color[1] = nextRandom();
+        path.color[2] = nextRandom();
+        path.color[3] = 0.5f + 0.5f * nextRandom();
+
+        switch (i % 3U)
+        {
+        case 0:
+        {
+            // {n/k} star polygon, e.g. {5/2}, {7/3}, {9/4}
+            const UINT pointCount = 5U + 2U * (i / 3U % 3U);
+            const UINT step = pointCount / 2U;
+            const float rotation = nextRandom() * 2.0f * pi;
+            for (UINT p = 0; p < pointCount; ++p)
+            {
+                const float angle = rotation + 2.0f * pi * float(p * step % pointCount) / float(pointCount);
+                path.verbs.push_back(p == 0 ? PATH_VERB_MOVE_TO : PATH_VERB_LINE_TO);
+                path.points.push_back({ centerX + radius * std::cos(angle), centerY + radius * std::sin(angle) });
+            }
+            path.verbs.push_back(PATH_VERB_CLOSE);
+            break;
+        }
+
+        case 1:
+        {
+            // A circle from 4 cubic curves
+            const float k = kappa * radius;
+            path.verbs = { PATH_VERB_MOVE_TO, PATH_VERB_CUBIC_TO, PATH_VERB_CUBIC_TO, PATH_VERB_CUBIC_TO, PATH_VERB_CUBIC_TO, PATH_VERB_CLOSE };
+            path.points = {
+                { centerX + radius, centerY },
+                { centerX + radius, centerY + k }, { centerX + k, centerY + radius }, { centerX, centerY + radius },
+                { centerX - k, centerY + radius }, { centerX - radius, centerY + k }, { centerX - radius, centerY },
+                { centerX - radius, centerY - k }, { centerX - k, centerY - radius }, { centerX, centerY - radius },
+                { centerX + k, centerY - radius }, { centerX + radius, centerY - k }, { centerX + radius, centerY }
+            };
+            break;
+        }
+
+        case 2:
+        default:
+        {
+            // A rounded rectangle with quadratic corners
+            const float halfWidth = radius;
+            const float halfHeight = radius * (0.4f + 0.6f * nextRandom());
+            const float corner = 0.4f * halfHeight;
+            const float left = centerX - halfWidth, right = centerX + halfWidth;
+            const float top = centerY - halfHeight, bottom = centerY + halfHeight;
+            path.verbs = {
+                PATH_VERB_MOVE_TO, PATH_VERB_LINE_TO, PATH_VERB_QUAD_TO, PATH_VERB_LINE_TO, PATH_VERB_QUAD_TO,
+                PATH_VERB_LINE_TO, PATH_VERB_QUAD_TO, PATH_VERB_LINE_TO, PATH_VERB_QUAD_TO, PATH_VERB_CLOSE
+            };
+            path.points = {
+                { left + corner, top }, { right - corner, top }, { right, top }, { right, top + corner },
+                { right, bottom - corner }, { right, bottom }, { right - corner, bottom },
+                { left + corner, bottom }, { left, bottom }, { left, bottom - corner },
+                { left, top + corner }, { left, top }, { left + corner, top }
+            };
+            break;
+        }
+        }
+    }
+
+    return paths;
+}
+
+// Fills the test paths with target independent rasterization (TIR) and with an MSAA stencil-then-cover baseline,
+// and compares paths per second and the difference of the two images.
+// TIR rasterizes the fan triangles of each batch with PATH_FORCED_SAMPLE_COUNT samples per pixel into a UAV without any render target,
+// then the cover pass converts the per-sample winding numbers to coverage and blends into the single-sample render target.
+static auto RunPathRenderingBenchmark(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator) -> bool
+{
+    const std::vector<VectorPath> paths = CreatePathRenderingTestPaths();
+
+    LARGE_INTEGER performanceFrequency{ }, flattenBeginTime{ }, flattenEndTime{ };
+    QueryPerformanceFrequency(&performanceFrequency);
+    QueryPerformanceCounter(&flattenBeginTime);
+    const PathGeometry geometry = BuildPathGeometry(paths, PATH_TARGET_SIZE, PATH_TARGET_SIZE, PATH_FLATTEN_TOLERANCE, PATH_MAX_BATCH_PATH_COUNT);
+    QueryPerformanceCounter(&flattenEndTime);
+
+    const UINT vertexBufferSize = UINT(geometry.vertices.size() * sizeof(PathVertex));
+    const UINT coverageElementCount = PATH_TARGET_SIZE * PATH_TARGET_SIZE * (PATH_FILL_RULE == PATH_FILL_RULE_EVEN_ODD ? 1U : PATH_FORCED_SAMPLE_COUNT);
+    const UINT imageRowPitch = PATH_TARGET_SIZE * 4U;   // already aligned to D3D12_TEXTURE_DATA_PITCH_ALIGNMENT
+    const UINT imageSize = imageRowPitch * PATH_TARGET_SIZE;
+    constexpr UINT timestampCount = 4U;
+
+    ID3D12RootSignature* rootSignature = nullptr;
+    ID3D12PipelineState* coveragePipelineState = nullptr;
+    ID3D12PipelineState* resolvePipelineState = nullptr;
+    ID3D12PipelineState* baselineStencilPipelineState = nullptr;
+    ID3D12PipelineState* baselineCoverPipelineState = nullptr;
+    ID3D12GraphicsCommandList* commandList = nullptr;
+    ID3D12DescriptorHeap* rtvDescriptorHeap = nullptr;
+    ID3D12DescriptorHeap* dsvDescriptorHeap = nullptr;
+    ID3D12DescriptorHeap* uavDescriptorHeap = nullptr;
+    ID3D12QueryHeap* queryHeap = nullptr;
+    ID3D12Resource* rtTexture = nullptr;
+    ID3D12Resource* baselineRTTexture = nullptr;
+    ID3D12Resource* baselineDSTexture = nullptr;
+    ID3D12Resource* baselineResolvedTexture = nullptr;
+    ID3D12Resource* coverageBuffer = nullptr;
+    ID3D12Resource* uploadDevHostBuffer = nullptr;
+    ID3D12Resource* vertexBuffer = nullptr;
+    ID3D12Resource* readbackDevHostBuffer = nullptr;
+    bool success = false;
+
+    do
+    {
+        if (geometry.batches.empty()) break;
+
+        D3D12_FEATURE_DATA_MULTISAMPLE_QUALITY_LEVELS qualityLevels{
+            .Format = RENDER_TARGET_BUFFER_FOMRAT,
+            .SampleCount = PATH_BASELINE_SAMPLE_COUNT,
+            .Flags = D3D12_MULTISAMPLE_QUALITY_LEVELS_FLAG_NONE,
+            .NumQualityLevels = 0
+        };
+        HRESULT hRes = d3d_device->CheckFeatureSupport(D3D12_FEATURE_MULTISAMPLE_QUALITY_LEVELS, &qualityLevels, sizeof(qualityLevels));
+        if (FAILED(hRes) || qualityLevels.NumQualityLevels == 0)
+        {
+            fprintf(stderr, "%u x MSAA is not supported for the path rendering baseline!\n", PATH_BASELINE_SAMPLE_COUNT);
+            break;
+        }
+
+        rootSignature = CreateRootSignatureForPathRendering(d3d_device);
+        if (rootSignature == nullptr) break;
+
+        auto const pipelineResult = CreatePipelineStatesForPathRendering(d3d_device, rootSignature);
+        coveragePipelineState = std::get<0>(pipelineResult);
+        resolvePipelineState = std::get<1>(pipelineResult);
+        baselineStencilPipelineState = std::get<2>(pipelineResult);
+        baselineCoverPipelineState = std::get<3>(pipelineResult);
+        if (coveragePipelineState == nullptr || resolvePipelineState == nullptr ||
+            baselineStencilPipelineState == nullptr || baselineCoverPipelineState == nullptr) break;
+
+        hRes = commandAllocator->Reset();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Reset command allocator for path rendering failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator, coveragePipelineState, IID_PPV_ARGS(&commandList));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommandList for path rendering failed: %ld\n", hRes);
+            break;
+        }
+
+        // RTVs: the TIR render target, the MSAA baseline render target
+        const D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc{
+            .Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV,
+            .NumDescriptors = 2,
+            .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
+            .NodeMask = 0
+        };
+        hRes = d3d_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&rtvDescriptorHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateDescriptorHeap for path rendering render target views failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc{
+            .Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV,
+            .NumDescriptors = 1,
+            .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
+            .NodeMask = 0
+        };
+        hRes = d3d_device->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&dsvDescriptorHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateDescriptorHeap for path rendering depth stencil view failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_DESCRIPTOR_HEAP_DESC uavHeapDesc{
+            .Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+            .NumDescriptors = 1,
+            .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE,
+            .NodeMask = 0
+        };
+        hRes = d3d_device->CreateDescriptorHeap(&uavHeapDesc, IID_PPV_ARGS(&uavDescriptorHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateDescriptorHeap for path rendering unordered access view failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_QUERY_HEAP_DESC queryHeapDesc{
+            .Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP,
+            .Count = timestampCount,
+            .NodeMask = 0U
+        };
+        hRes = d3d_device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&queryHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateQueryHeap for path rendering failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+            .Type = D3D12_HEAP_TYPE_DEFAULT,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
+
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = defaultHeapProperties;
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_HEAP_PROPERTIES readbackHeapProperties = defaultHeapProperties;
+        readbackHeapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+        D3D12_RESOURCE_DESC textureDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
+            .Alignment = 0,
+            .Width = PATH_TARGET_SIZE,
+            .Height = PATH_TARGET_SIZE,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = RENDER_TARGET_BUFFER_FOMRAT,
+            .SampleDesc {.Count = 1U, .Quality = 0U },
+            .Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN,
+            .Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET
+        };
+
+        const D3D12_CLEAR_VALUE rtClearValue{
+            .Format = RENDER_TARGET_BUFFER_FOMRAT,
+            .Color { 1.0f, 1.0f, 1.0f, 1.0f }
+        };
+
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, D3D12_RESOURCE_STATE_RENDER_TARGET,
+                                                &rtClearValue, IID_PPV_ARGS(&rtTexture));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for path render target failed: %ld\n", hRes);
+            break;
+        }
+
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, D3D12_RESOURCE_STATE_RESOLVE_DEST,
+                                                nullptr, IID_PPV_ARGS(&baselineResolvedTexture));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for path baseline resolved texture failed: %ld\n", hRes);
+            break;
+        }
+
+        textureDesc.SampleDesc.Count = PATH_BASELINE_SAMPLE_COUNT;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, D3D12_RESOURCE_STATE_RENDER_TARGET,
+                                                &rtClearValue, IID_PPV_ARGS(&baselineRTTexture));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for path baseline render target failed: %ld\n", hRes);
+            break;
+        }
+
+        textureDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+        textureDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL | D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
+        const D3D12_CLEAR_VALUE dsClearValue{
+            .Format = DXGI_FORMAT_D24_UNORM_S8_UINT,
+            .DepthStencil { .Depth = 1.0f, .Stencil = 0U }
+        };
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, D3D12_RESOURCE_STATE_DEPTH_WRITE,
+                                                &dsClearValue, IID_PPV_ARGS(&baselineDSTexture));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for path baseline depth stencil texture failed: %ld\n", hRes);
+            break;
+        }
+
+        D3D12_RESOURCE_DESC bufferDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0,
+            .Width = coverageElementCount * sizeof(UINT),
+            .Height = 1U,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {.Count = 1U, .Quality = 0 },
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS
+        };
+
+        // Committed resources are zero-initialized, and the cover pass clears the counters it has consumed,
+        // so the coverage buffer never needs an explicit clear.
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&coverageBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for path coverage buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = vertexBufferSize;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&vertexBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for path vertex buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadDevHostBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for path upload buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        // The TIR image, the baseline image, then the timestamps
+        bufferDesc.Width = imageSize * 2U + timestampCount * sizeof(UINT64);
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&readbackDevHostBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for path read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        void* hostMemPtr = nullptr;
+        hRes = uploadDevHostBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map path upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        memcpy(hostMemPtr, geometry.vertices.data(), vertexBufferSize);
+        uploadDevHostBuffer->Unmap(0, nullptr);
+
+        // Create the views
+        const UINT rtvDescriptorSize = d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandles[2]{ rtvDescriptorHeap->GetCPUDescriptorHandleForHeapStart() };
+        rtvHandles[1].ptr = rtvHandles[0].ptr + rtvDescriptorSize;
+        d3d_device->CreateRenderTargetView(rtTexture, nullptr, rtvHandles[0]);
+        d3d_device->CreateRenderTargetView(baselineRTTexture, nullptr, rtvHandles[1]);
+
+        const D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle = dsvDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
+        d3d_device->CreateDepthStencilView(baselineDSTexture, nullptr, dsvHandle);
+
+        const D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc{
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .ViewDimension = D3D12_UAV_DIMENSION_BUFFER,
+            .Buffer {
+                .FirstElement = 0,
+                .NumElements = coverageElementCount,
+                .StructureByteStride = UINT(sizeof(UINT)),
+                .CounterOffsetInBytes = 0,
+                .Flags = D3D12_BUFFER_UAV_FLAG_NONE
+            }
+        };
+        d3d_device->CreateUnorderedAccessView(coverageBuffer, nullptr, &uavDesc, uavDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
+
+        WriteToDeviceResourceAndSync(commandList, vertexBuffer, uploadDevHostBuffer, 0U, 0U, vertexBufferSize);
+
+        const D3D12_RESOURCE_BARRIER coverageBarrier{
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .Transition {
+                .pResource = coverageBuffer,
+                .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                .StateBefore = D3D12_RESOURCE_STATE_COMMON,
+                .StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+            }
+        };
+        commandList->ResourceBarrier(1U, &coverageBarrier);
+
+        const D3D12_VIEWPORT viewPort{
+            .TopLeftX = 0.0f,
+            .TopLeftY = 0.0f,
+            .Width = FLOAT(PATH_TARGET_SIZE),
+            .Height = FLOAT(PATH_TARGET_SIZE),
+            .MinDepth = 0.0f,
+            .MaxDepth = 1.0f
+        };
+        commandList->RSSetViewports(1, &viewPort);
+
+        const D3D12_RECT scissorRect{
+            .left = 0,
+            .top = 0,
+            .right = LONG(PATH_TARGET_SIZE),
+            .bottom = LONG(PATH_TARGET_SIZE)
+        };
+        commandList->RSSetScissorRects(1, &scissorRect);
+
+        ID3D12DescriptorHeap* const descHeaps[]{ uavDescriptorHeap };
+        commandList->SetDescriptorHeaps(UINT(std::size(descHeaps)), descHeaps);
+        commandList->SetGraphicsRootSignature(rootSignature);
+        commandList->SetGraphicsRootDescriptorTable(0, uavDescriptorHeap->GetGPUDescriptorHandleForHeapStart());     // rootParameters[0]
+
+        const UINT pathConstants[]{ PATH_TARGET_SIZE, PATH_TARGET_SIZE, PATH_FORCED_SAMPLE_COUNT, UINT(PATH_FILL_RULE) };
+        commandList->SetGraphicsRoot32BitConstants(1, UINT(std::size(pathConstants)), pathConstants, 0);      // rootParameters[1]
+
+        const D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
+            .BufferLocation = vertexBuffer->GetGPUVirtualAddress(),
+            .SizeInBytes = vertexBufferSize,
+            .StrideInBytes = UINT(sizeof(PathVertex))
+        };
+        commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+
+        const D3D12_RESOURCE_BARRIER uavBarrier{
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_UAV,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .UAV { .pResource = coverageBuffer }
+        };
+
+        // TIR: coverage pass then cover pass for each batch
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0U);
+        for (UINT iteration = 0; iteration < PATH_BENCHMARK_ITERATION_COUNT; ++iteration)
+        {
+            commandList->ClearRenderTargetView(rtvHandles[0], rtClearValue.Color, 0, nullptr);
+
+            for (const PathBatch& batch : geometry.batches)
+            {
+                commandList->SetPipelineState(coveragePipelineState);
+                commandList->OMSetRenderTargets(0, nullptr, FALSE, nullptr);
+                commandList->DrawInstanced(batch.fanVertexCount, 1U, batch.firstFanVertex, 0U);
+                commandList->ResourceBarrier(1U, &uavBarrier);
+
+                commandList->SetPipelineState(resolvePipelineState);
+                commandList->OMSetRenderTargets(1, &rtvHandles[0], FALSE, nullptr);
+                commandList->DrawInstanced(batch.coverVertexCount, 1U, batch.firstCoverVertex, 0U);
+                commandList->ResourceBarrier(1U, &uavBarrier);
+            }
+        }
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 1U);
+
+        // MSAA baseline: stencil pass then cover pass for each batch, then resolve
+        D3D12_RESOURCE_BARRIER resolveBarrier{
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .Transition {
+                .pResource = baselineRTTexture,
+                .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                .StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET,
+                .StateAfter = D3D12_RESOURCE_STATE_RESOLVE_SOURCE
+            }
+        };
+
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 2U);
+        for (UINT iteration = 0; iteration < PATH_BENCHMARK_ITERATION_COUNT; ++iteration)
+        {
+            commandList->OMSetRenderTargets(1, &rtvHandles[1], FALSE, &dsvHandle);
+            commandList->ClearRenderTargetView(rtvHandles[1], rtClearValue.Color, 0, nullptr);
+            commandList->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
+            commandList->OMSetStencilRef(0);
+
+            for (const PathBatch& batch : geometry.batches)
+            {
+                commandList->SetPipelineState(baselineStencilPipelineState);
+                commandList->DrawInstanced(batch.fanVertexCount, 1U, batch.firstFanVertex, 0U);
+
+                commandList->SetPipelineState(baselineCoverPipelineState);
+                commandList->DrawInstanced(batch.coverVertexCount, 1U, batch.firstCoverVertex, 0U);
+            }
+
+            resolveBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+            resolveBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_RESOLVE_SOURCE;
+            commandList->ResourceBarrier(1U, &resolveBarrier);
+
+            commandList->ResolveSubresource(baselineResolvedTexture, 0, baselineRTTexture, 0, RENDER_TARGET_BUFFER_FOMRAT);
+
+            resolveBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RESOLVE_SOURCE;
+            resolveBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+            commandList->ResourceBarrier(1U, &resolveBarrier);
+        }
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 3U);
+
+        // Read back both images and the timestamps
+        const D3D12_RESOURCE_BARRIER copyBarriers[]{
+            {
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = rtTexture,
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET,
+                    .StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE
+                }
+            },
+            {
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = baselineResolvedTexture,
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_RESOLVE_DEST,
+                    .StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE
+                }
+            }
+        };
+        commandList->ResourceBarrier(UINT(std::size(copyBarriers)), copyBarriers);
+
+        ID3D12Resource* const srcTextures[]{ rtTexture, baselineResolvedTexture };
+        for (UINT i = 0; i < UINT(std::size(srcTextures)); ++i)
+        {
+            const D3D12_TEXTURE_COPY_LOCATION dstLocation{
+                .pResource = readbackDevHostBuffer,
+                .Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+                .PlacedFootprint {
+                    .Offset = UINT64(i) * imageSize,
+                    .Footprint {
+                        .Format = RENDER_TARGET_BUFFER_FOMRAT,
+                        .Width = PATH_TARGET_SIZE,
+                        .Height = PATH_TARGET_SIZE,
+                        .Depth = 1,
+                        .RowPitch = imageRowPitch
+                    }
+                }
+            };
+            const D3D12_TEXTURE_COPY_LOCATION srcLocation{
+                .pResource = srcTextures[i],
+                .Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+                .SubresourceIndex = 0
+            };
+            commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+        }
+
+        commandList->ResolveQueryData(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0U, timestampCount, readbackDevHostBuffer, imageSize * 2U);
+
+        hRes = commandList->Close();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Close path rendering command list failed: %ld\n", hRes);
+            break;
+        }
+
+        ID3D12CommandList* const ppCommandLists[] = { (ID3D12CommandList*)commandList };
+        commandQueue->ExecuteCommandLists((UINT)std::size(ppCommandLists), ppCommandLists);
+
+        if (!WaitForPreviousFrame(commandQueue)) break;
+
+        UINT64 timestampFrequency = 0;
+        hRes = commandQueue->GetTimestampFrequency(&timestampFrequency);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "GetTimestampFrequency failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = readbackDevHostBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map path read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        const uint8_t* tirImage = (const uint8_t*)hostMemPtr;
+        const uint8_t* baselineImage = tirImage + imageSize;
+        const UINT64* timestamps = (const UINT64*)(uintptr_t(hostMemPtr) + imageSize * 2U);
+
+        // Both images sample the paths differently, so they only differ slightly at the path edges
+        UINT64 totalDifference = 0;
+        int maxDifference = 0;
+        for (UINT i = 0; i < imageSize; ++i)
+        {
+            const int difference = std::abs(int(tirImage[i]) - int(baselineImage[i]));
+            totalDifference += UINT64(difference);
+            maxDifference = (std::max)(maxDifference, difference);
+        }
+
+        readbackDevHostBuffer->Unmap(0, nullptr);
+
+        const double flattenTime = double(flattenEndTime.QuadPart - flattenBeginTime.QuadPart) * 1000.0 / double(performanceFrequency.QuadPart);
+        const double tirTime = double(timestamps[1] - timestamps[0]) / double(timestampFrequency);
+        const double baselineTime = double(timestamps[3] - timestamps[2]) / double(timestampFrequency);
+        const double renderedPathCount = double(geometry.pathCount) * PATH_BENCHMARK_ITERATION_COUNT;
+
+        printf("Path rendering: %u paths, %u batches, %u fan triangles, flattened and batched in %.3f ms, %s fill rule\n",
+                geometry.pathCount, UINT(geometry.batches.size()), geometry.fanTriangleCount, flattenTime,
+                PATH_FILL_RULE == PATH_FILL_RULE_EVEN_ODD ? "even-odd" : "non-zero");
+        printf("    TIR with %u forced samples: %.3f ms per frame, %.0f paths per second\n",
+                PATH_FORCED_SAMPLE_COUNT, tirTime * 1000.0 / PATH_BENCHMARK_ITERATION_COUNT, renderedPathCount / tirTime);
+        printf("    %u x MSAA stencil-then-cover: %.3f ms per frame, %.0f paths per second\n",
+                PATH_BASELINE_SAMPLE_COUNT, baselineTime * 1000.0 / PATH_BENCHMARK_ITERATION_COUNT, renderedPathCount / baselineTime);
+        printf("    image difference: mean %.3f, max %d\n", double(totalDifference) / double(imageSize), maxDifference);
+
+        success = true;
+    }
+    while (false);
+
+    if (rootSignature != nullptr) {
+        rootSignature->Release();
+    }
+    if (coveragePipelineState != nullptr) {
+        coveragePipelineState->Release();
+    }
+    if (resolvePipelineState != nullptr) {
+        resolvePipelineState->Release();
+    }
+    if (baselineStencilPipelineState != nullptr) {
+        baselineStencilPipelineState->Release();
+    }
+    if (baselineCoverPipelineState != nullptr) {
+        baselineCoverPipelineState->Release();
+    }
+    if (commandList != nullptr) {
+        commandList->Release();
+    }
+    if (rtvDescriptorHeap != nullptr) {
+        rtvDescriptorHeap->Release();
+    }
+    if (dsvDescriptorHeap != nullptr) {
+        dsvDescriptorHeap->Release();
+    }
+    if (uavDescriptorHeap != nullptr) {
+        uavDescriptorHeap->Release();
+    }
+    if (queryHeap != nullptr) {
+        queryHeap->Release();
+    }
+    if (rtTexture != nullptr) {
+        rtTexture->Release();
+    }
+    if (baselineRTTexture != nullptr) {
+        baselineRTTexture->Release();
+    }
+    if (baselineDSTexture != nullptr) {
+        baselineDSTexture->Release();
+    }
+    if (baselineResolvedTexture != nullptr) {
+        baselineResolvedTexture->Release();
+    }
+    if (coverageBuffer != nullptr) {
+        coverageBuffer->Release();
+    }
+    if (uploadDevHostBuffer != nullptr) {
+        uploadDevHostBuffer->Release();
+    }
+    if (vertexBuffer != nullptr) {
+        vertexBuffer->Release();
+    }
+    if (readbackDevHostBuffer != nullptr) {
+        readbackDevHostBuffer->Release();
+    }
+
+    return success;
+}
+#endif
+
 auto CreateTargetIndependentTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue *commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
                                     std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12DescriptorHeap*, ID3D12DescriptorHeap*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, bool>
 {
@@ -1138,6 +2083,12 @@ auto CreateTargetIndependentTestAssets(ID3D12Device* d3d_device, ID3D12CommandQu
 
         readbackDevHostBuffer->Unmap(0, nullptr);
 
+#if TEST_PATH_RENDERING
+        if (!RunPathRenderingBenchmark(d3d_device, commandQueue, commandAllocator)) {
+            fprintf(stderr, "Path rendering benchmark failed!\n");
+        }
+#endif
+
         success = true;
     }
     while (false);
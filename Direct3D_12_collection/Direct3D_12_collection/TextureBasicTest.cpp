@@ -1,5 +1,22 @@
 #include "common.h"
+#include "ImageDecoder.h"
 
+#include <vector>
+
+// Decode the texture image repeatedly at startup and print the decoder throughput
+#define RUN_IMAGE_DECODE_BENCHMARK      1
+
+// Convert 8-bit BGR(A) and 16-bit per channel images to R8G8B8A8 while they are written to the upload buffer,
+// flipping bottom-up images in the same pass. 16-bit per channel images are encoded to sRGB.
+#define CONVERT_TEXTURE_TO_RGBA8        1
+
+// Premultiply the color channels of the converted texture by alpha
+#define PREMULTIPLY_TEXTURE_ALPHA       0
+
+// A BMP, TGA or DDS file
+static constexpr const char* TEXTURE_IMAGE_PATH = "images/geom.bmp";
+
+static constexpr uint32_t IMAGE_DECODE_BENCHMARK_ITERATION_COUNT = 64U;
 
 static auto CreateRootSignature(ID3D12Device* d3d_device) -> ID3D12RootSignature*
 {
@@ -234,27 +251,105 @@ static auto CreatePipelineStateObject(ID3D12Device* d3d_device, ID3D12CommandAll
     return std::make_tuple(pipelineState, commandList, commandBundleList);;
 }
 
-static HBITMAP LoadBMPFile(BITMAP *outBitmapInfo)
+struct MappedImageFile
+{
+    HANDLE file;
+    HANDLE mapping;
+    const uint8_t* data;
+    size_t size;
+};
+
+// The image is parsed and decoded straight from a read-only view of the file, without reading it into an intermediate buffer.
+// mappedFile must be released by UnmapImageFile() even if mapping fails.
+static auto MapImageFile(const char* path, MappedImageFile& mappedFile) -> bool
 {
-    HBITMAP hBmp = (HBITMAP)LoadImageA(nullptr, "images/geom.bmp", IMAGE_BITMAP, 0, 0, LR_LOADFROMFILE | LR_CREATEDIBSECTION);
-    if (hBmp == nullptr)
+    mappedFile = MappedImageFile{ .file = INVALID_HANDLE_VALUE, .mapping = nullptr, .data = nullptr, .size = 0U };
+
+    mappedFile.file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (mappedFile.file == INVALID_HANDLE_VALUE)
+    {
+        fprintf(stderr, "Open image file %s failed: %lu\n", path, GetLastError());
+        return false;
+    }
+
+    LARGE_INTEGER fileSize{ };
+    if (!GetFileSizeEx(mappedFile.file, &fileSize) || fileSize.QuadPart <= 0)
+    {
+        fprintf(stderr, "Image file %s is empty!\n", path);
+        return false;
+    }
+
+    mappedFile.mapping = CreateFileMappingA(mappedFile.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappedFile.mapping == nullptr)
     {
-        fprintf(stderr, "Load image file failed!\n");
-        return nullptr;
+        fprintf(stderr, "CreateFileMapping for image file failed: %lu\n", GetLastError());
+        return false;
     }
 
-    BITMAP bitmap;
-    if (GetObjectA(hBmp, sizeof(bitmap), &bitmap) == 0)
+    mappedFile.data = (const uint8_t*)MapViewOfFile(mappedFile.mapping, FILE_MAP_READ, 0, 0, 0);
+    if (mappedFile.data == nullptr)
     {
-        fprintf(stderr, "Bitmap get failed!\n");
-        return nullptr;
+        fprintf(stderr, "MapViewOfFile for image file failed: %lu\n", GetLastError());
+        return false;
     }
 
-    if (outBitmapInfo != nullptr) {
-        *outBitmapInfo = bitmap;
+    mappedFile.size = size_t(fileSize.QuadPart);
+    return true;
+}
+
+static auto UnmapImageFile(MappedImageFile& mappedFile) -> void
+{
+    if (mappedFile.data != nullptr) {
+        UnmapViewOfFile(mappedFile.data);
+    }
+    if (mappedFile.mapping != nullptr) {
+        CloseHandle(mappedFile.mapping);
+    }
+    if (mappedFile.file != INVALID_HANDLE_VALUE) {
+        CloseHandle(mappedFile.file);
     }
 
-    return hBmp;
+    mappedFile = MappedImageFile{ .file = INVALID_HANDLE_VALUE, .mapping = nullptr, .data = nullptr, .size = 0U };
+}
+
+static auto GetTextureFormat(const ImageInfo& imageInfo) -> DXGI_FORMAT
+{
+    switch (imageInfo.pixelFormat)
+    {
+    case ImagePixelFormat::R8:
+        return DXGI_FORMAT_R8_UNORM;
+    case ImagePixelFormat::R8G8B8A8:
+        return imageInfo.sRGB ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+    case ImagePixelFormat::B8G8R8A8:
+        return imageInfo.sRGB ? DXGI_FORMAT_B8G8R8A8_UNORM_SRGB : DXGI_FORMAT_B8G8R8A8_UNORM;
+    case ImagePixelFormat::B8G8R8X8:
+        return imageInfo.sRGB ? DXGI_FORMAT_B8G8R8X8_UNORM_SRGB : DXGI_FORMAT_B8G8R8X8_UNORM;
+    case ImagePixelFormat::R16G16B16A16:
+        return DXGI_FORMAT_R16G16B16A16_UNORM;
+    case ImagePixelFormat::R16G16B16A16Float:
+        return DXGI_FORMAT_R16G16B16A16_FLOAT;
+    case ImagePixelFormat::R32G32B32A32Float:
+        return DXGI_FORMAT_R32G32B32A32_FLOAT;
+    case ImagePixelFormat::BC1:
+        return imageInfo.sRGB ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+    case ImagePixelFormat::BC2:
+        return imageInfo.sRGB ? DXGI_FORMAT_BC2_UNORM_SRGB : DXGI_FORMAT_BC2_UNORM;
+    case ImagePixelFormat::BC3:
+        return imageInfo.sRGB ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+    case ImagePixelFormat::BC4:
+        return DXGI_FORMAT_BC4_UNORM;
+    case ImagePixelFormat::BC5:
+        return DXGI_FORMAT_BC5_UNORM;
+    case ImagePixelFormat::BC6HUnsignedFloat:
+        return DXGI_FORMAT_BC6H_UF16;
+    case ImagePixelFormat::BC6HSignedFloat:
+        return DXGI_FORMAT_BC6H_SF16;
+    case ImagePixelFormat::BC7:
+        return imageInfo.sRGB ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+    case ImagePixelFormat::Unknown:
+    default:
+        return DXGI_FORMAT_UNKNOWN;
+    }
 }
 
 // @return [cbv_srvDescriptorHeap, samplerDescriptorHeap, texture]
@@ -299,16 +394,53 @@ static auto CreateTextureAndSampler(ID3D12Device* d3d_device, ID3D12CommandQueue
     const UINT cbv_srvDescriptorSize = d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
     const UINT samplerDescriptorSize = d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
 
-    HBITMAP hBmp = nullptr;
+    MappedImageFile imageFile{ .file = INVALID_HANDLE_VALUE, .mapping = nullptr, .data = nullptr, .size = 0U };
     ID3D12Resource* uploadDevHostBuffer = nullptr;
     bool done = false;
 
     // Create frame resources
     do
     {
-        // Load BMP File
-        BITMAP bitmap;
-        hBmp = LoadBMPFile(&bitmap);
+        // Map and parse the image file
+        if (!MapImageFile(TEXTURE_IMAGE_PATH, imageFile)) break;
+
+        ImageInfo imageInfo;
+        if (!ParseImageHeader(imageFile.data, imageFile.size, imageInfo))
+        {
+            fprintf(stderr, "%s is not a supported BMP, TGA or DDS image!\n", TEXTURE_IMAGE_PATH);
+            break;
+        }
+
+#if RUN_IMAGE_DECODE_BENCHMARK
+        printf("Image decoder: %s, %ux%u %s, %u mip levels, %u array slices, %s: %.1f MB/s\n",
+                TEXTURE_IMAGE_PATH, imageInfo.width, imageInfo.height, GetImagePixelFormatName(imageInfo.pixelFormat), imageInfo.mipLevelCount, imageInfo.arraySize,
+                imageInfo.encoding == ImageEncoding::Direct ? "copied in place" : "decoded",
+                MeasureImageDecodeThroughput(imageInfo, imageFile.data, IMAGE_DECODE_BENCHMARK_ITERATION_COUNT));
+#endif
+
+        PixelConversion pixelConversion = PixelConversion::RGBA8ToRGBA8;
+        const bool convertPixels = CONVERT_TEXTURE_TO_RGBA8 != 0 && GetImageRGBA8Conversion(imageInfo, true, pixelConversion);
+
+        // Upload heaps are write-combined, so the rows are written with non-temporal stores
+        const PixelConversionOptions pixelConversionOptions{
+            .kernel = GetFastestPixelConversionKernel(),
+            .premultiplyAlpha = PREMULTIPLY_TEXTURE_ALPHA != 0,
+            .streamingStores = true
+        };
+
+#if RUN_IMAGE_DECODE_BENCHMARK
+        if (convertPixels)
+        {
+            for (PixelConversionKernel kernel : { PixelConversionKernel::Scalar, PixelConversionKernel::SSE, PixelConversionKernel::AVX2, PixelConversionKernel::NEON })
+            {
+                if (!IsPixelConversionKernelSupported(kernel)) continue;
+
+                const PixelConversionOptions options{ .kernel = kernel, .premultiplyAlpha = pixelConversionOptions.premultiplyAlpha, .streamingStores = true };
+                printf("Pixel conversion %s with %s: %.1f MB/s\n", GetPixelConversionName(pixelConversion), GetPixelConversionKernelName(kernel),
+                        MeasurePixelConversionThroughput(pixelConversion, options, imageInfo.width, imageInfo.height, IMAGE_DECODE_BENCHMARK_ITERATION_COUNT));
+            }
+        }
+#endif
 
         const D3D12_HEAP_PROPERTIES defaultHeapProperties{
            .Type = D3D12_HEAP_TYPE_DEFAULT,
@@ -318,26 +450,38 @@ static auto CreateTextureAndSampler(ID3D12Device* d3d_device, ID3D12CommandQueue
            .VisibleNodeMask = 1
         };
 
-        constexpr DXGI_FORMAT textureFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+        DXGI_FORMAT textureFormat = GetTextureFormat(imageInfo);
+        if (convertPixels) {
+            textureFormat = imageInfo.sRGB || pixelConversion == PixelConversion::RGBA16ToSRGBA8 ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+        }
 
         const D3D12_RESOURCE_DESC textureResourceDesc{
             .Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
             .Alignment = 0,
-            .Width = UINT64(bitmap.bmWidth),
-            .Height = UINT64(bitmap.bmHeight),
-            .DepthOrArraySize = 1,
-            .MipLevels = 1,
+            .Width = UINT64(imageInfo.width),
+            .Height = UINT(imageInfo.height),
+            .DepthOrArraySize = UINT16(imageInfo.arraySize),
+            .MipLevels = UINT16(imageInfo.mipLevelCount),
             .Format = textureFormat,
             .SampleDesc {.Count = 1, .Quality = 0U },
             .Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN,
             .Flags = D3D12_RESOURCE_FLAG_NONE
         };
 
+        // The pixel shader samples the first array slice with all its mip levels.
+        // A TEXTURE2D view may only cover a single-slice resource, so array and cube textures are viewed as a one-slice array.
         const D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{
             .Format = textureFormat,
-            .ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D,
+            .ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY,
             .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-            .Texture2D {.MostDetailedMip = 0U, .MipLevels = 1U, .PlaneSlice = 0U, .ResourceMinLODClamp = 0.0f }
+            .Texture2DArray {
+                .MostDetailedMip = 0U,
+                .MipLevels = imageInfo.mipLevelCount,
+                .FirstArraySlice = 0U,
+                .ArraySize = 1U,
+                .PlaneSlice = 0U,
+                .ResourceMinLODClamp = 0.0f
+            }
         };
 
         // Create the texture
@@ -355,6 +499,15 @@ static auto CreateTextureAndSampler(ID3D12Device* d3d_device, ID3D12CommandQueue
 
         d3d_device->CreateShaderResourceView(texture, &srvDesc, srvHandle);
 
+        // Every mip level of every array slice is placed in one upload buffer, with the offsets and 256-byte aligned row pitches
+        // that CopyTextureRegion() requires
+        const UINT subresourceCount = imageInfo.mipLevelCount * imageInfo.arraySize;
+        std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints(subresourceCount);
+        std::vector<UINT> footprintRowCounts(subresourceCount);
+        std::vector<UINT64> footprintRowSizes(subresourceCount);
+        UINT64 uploadBufferSize = 0U;
+        d3d_device->GetCopyableFootprints(&textureResourceDesc, 0U, subresourceCount, 0U, footprints.data(), footprintRowCounts.data(), footprintRowSizes.data(), &uploadBufferSize);
+
         // Upload image data to the texture
         const D3D12_HEAP_PROPERTIES uploadHeapProperties{
            .Type = D3D12_HEAP_TYPE_UPLOAD,     // for host visible memory which is used to upload data from host to device
@@ -367,7 +520,7 @@ static auto CreateTextureAndSampler(ID3D12Device* d3d_device, ID3D12CommandQueue
         const D3D12_RESOURCE_DESC texUploadResourceDesc{
             .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
             .Alignment = 0,
-            .Width = UINT(bitmap.bmWidthBytes * bitmap.bmHeight),
+            .Width = uploadBufferSize,
             .Height = 1U,
             .DepthOrArraySize = 1U,
             .MipLevels = 1,
@@ -394,11 +547,43 @@ static auto CreateTextureAndSampler(ID3D12Device* d3d_device, ID3D12CommandQueue
             fprintf(stderr, "Map vertex buffer failed: %ld\n", hRes);
             break;
         }
-        memcpy(hostMemPtr, bitmap.bmBits, size_t(bitmap.bmWidthBytes * bitmap.bmHeight));
+
+        // Rows that already have the layout of the texture are copied from the mapped file, the others are decoded into the upload buffer.
+        // Converted pixels are read from the mapped file, swizzled, flipped and written to the upload buffer in one pass.
+        // Subresource index = mipLevel + arraySlice * mipLevelCount
+        bool decoded = true;
+        for (UINT arraySlice = 0; arraySlice < imageInfo.arraySize && decoded; ++arraySlice)
+        {
+            for (UINT mipLevel = 0; mipLevel < imageInfo.mipLevelCount; ++mipLevel)
+            {
+                const UINT subresource = mipLevel + arraySlice * imageInfo.mipLevelCount;
+                const ImageSubresourceLayout imageLayout = GetImageSubresourceLayout(imageInfo, mipLevel);
+                const size_t textureRowSize = convertPixels ? size_t(imageLayout.width) * 4U : imageLayout.rowSize;
+                if (imageLayout.rowCount != footprintRowCounts[subresource] || textureRowSize != footprintRowSizes[subresource])
+                {
+                    fprintf(stderr, "Image subresource %u does not match its copyable footprint!\n", subresource);
+                    decoded = false;
+                    break;
+                }
+
+                const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint = footprints[subresource];
+                uint8_t* const subresourceData = (uint8_t*)hostMemPtr + footprint.Offset;
+                const bool subresourceDecoded = convertPixels ?
+                    ConvertImageSubresource(imageInfo, imageFile.data, mipLevel, arraySlice, pixelConversion, pixelConversionOptions, subresourceData, footprint.Footprint.RowPitch) :
+                    DecodeImageSubresource(imageInfo, imageFile.data, mipLevel, arraySlice, subresourceData, footprint.Footprint.RowPitch);
+                if (!subresourceDecoded)
+                {
+                    fprintf(stderr, "Decode image subresource %u failed!\n", subresource);
+                    decoded = false;
+                    break;
+                }
+            }
+        }
         uploadDevHostBuffer->Unmap(0, nullptr);
+        if (!decoded) break;
 
         // Do texture upload
-        WriteToDeviceTextureAndSync(commandList, texture, uploadDevHostBuffer, 0U, 0U, 0U, 0U, textureFormat, UINT(bitmap.bmWidth), UINT(bitmap.bmHeight), 1U, UINT(bitmap.bmWidthBytes));
+        WriteToDeviceTextureSubresourcesAndSync(commandList, texture, uploadDevHostBuffer, 0U, subresourceCount, footprints.data());
 
         hRes = commandList->Close();
         if (FAILED(hRes))
@@ -425,7 +610,7 @@ static auto CreateTextureAndSampler(ID3D12Device* d3d_device, ID3D12CommandQueue
             .ComparisonFunc = D3D12_COMPARISON_FUNC_ALWAYS,
             .BorderColor { 0.0f, 0.0f, 0.0f, 0.0f },
             .MinLOD = 0.0f,
-            .MaxLOD = 1.0f
+            .MaxLOD = D3D12_FLOAT32_MAX
         };
 
         D3D12_CPU_DESCRIPTOR_HANDLE samplerHandle = samplerDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
@@ -436,9 +621,7 @@ static auto CreateTextureAndSampler(ID3D12Device* d3d_device, ID3D12CommandQueue
     }
     while (false);
 
-    if (hBmp != nullptr) {
-        DeleteObject(hBmp);
-    }
+    UnmapImageFile(imageFile);
     if (uploadDevHostBuffer != nullptr) {
         uploadDevHostBuffer->Release();
     }
@@ -478,11 +661,11 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
         float texCoords[2];
     } squareVertices[]{
         // Direct3D是以左手作为前面背面顶点排列的依据
-        // 由于BMP文件格式是从图像底部到顶部，因此需要将纹理坐标Y方向进行反转
-        {.position { -0.75f, 0.75f, 0.0f, 1.0f }, .texCoords { 0.0f, 1.0f } },  // top left
-        {.position { 0.75f, 0.75f, 0.0f, 1.0f }, .texCoords { 1.0f, 1.0f } },   // top right
-        {.position { -0.75f, -0.75f, 0.0f, 1.0f }, .texCoords { 0.0f, 0.0f } }, // bottom left
-        {.position { 0.75f, -0.75f, 0.0f, 1.0f }, .texCoords { 1.0f, 0.0f } }   // bottom right
+        // The image decoder writes the top row of the image first, so v = 0 is the top of the texture
+        {.position { -0.75f, 0.75f, 0.0f, 1.0f }, .texCoords { 0.0f, 0.0f } },  // top left
+        {.position { 0.75f, 0.75f, 0.0f, 1.0f }, .texCoords { 1.0f, 0.0f } },   // top right
+        {.position { -0.75f, -0.75f, 0.0f, 1.0f }, .texCoords { 0.0f, 1.0f } }, // bottom left
+        {.position { 0.75f, -0.75f, 0.0f, 1.0f }, .texCoords { 1.0f, 1.0f } }   // bottom right
     };
 
     const D3D12_HEAP_PROPERTIES defaultHeapProperties{
@@ -616,12 +799,14 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
         // Fetch CBV and UAV CPU descriptor handles
         // Create the texture shader resource view
         const D3D12_SHADER_RESOURCE_VIEW_DESC textureSRVDesc{
-            .Format = RENDER_TARGET_BUFFER_FOMRAT,
-            .ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D,
+            .Format = texture->GetDesc().Format,
+            .ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY,
             .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-            .Texture2D {
+            .Texture2DArray {
                 .MostDetailedMip = 0,
-                .MipLevels = 1,
+                .MipLevels = texture->GetDesc().MipLevels,
+                .FirstArraySlice = 0,
+                .ArraySize = 1,
                 .PlaneSlice = 0,
                 .ResourceMinLODClamp = 0.0f
             }
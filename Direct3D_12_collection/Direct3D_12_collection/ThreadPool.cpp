@@ -0,0 +1,135 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct ThreadPool
+{
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable workCondition;
+    std::condition_variable doneCondition;
+
+    // The current job, protected by `mutex` except for the atomic index
+    const std::function<void(uint32_t)>* task;
+    uint32_t taskCount;
+    std::atomic<uint32_t> nextTaskIndex;
+    uint32_t jobGeneration;
+    uint32_t finishedWorkerCount;
+    bool quit;
+};
+
+static auto RunThreadPoolTasks(ThreadPool* threadPool, const std::function<void(uint32_t)>& task, uint32_t taskCount) -> void
+{
+    for (uint32_t index = threadPool->nextTaskIndex.fetch_add(1U); index < taskCount; index = threadPool->nextTaskIndex.fetch_add(1U)) {
+        task(index);
+    }
+}
+
+static auto ThreadPoolWorkerMain(ThreadPool* threadPool) -> void
+{
+    uint32_t lastGeneration = 0U;
+
+    while (true)
+    {
+        const std::function<void(uint32_t)>* task = nullptr;
+        uint32_t taskCount = 0U;
+        {
+            std::unique_lock<std::mutex> lock(threadPool->mutex);
+            threadPool->workCondition.wait(lock, [threadPool, lastGeneration] { return threadPool->quit || threadPool->jobGeneration != lastGeneration; });
+            if (threadPool->quit) return;
+
+            lastGeneration = threadPool->jobGeneration;
+            task = threadPool->task;
+            taskCount = threadPool->taskCount;
+        }
+
+        RunThreadPoolTasks(threadPool, *task, taskCount);
+
+        {
+            std::lock_guard<std::mutex> lock(threadPool->mutex);
+            if (++threadPool->finishedWorkerCount == uint32_t(threadPool->workers.size())) {
+                threadPool->doneCondition.notify_all();
+            }
+        }
+    }
+}
+
+auto CreateThreadPool(uint32_t threadCount) -> ThreadPool*
+{
+    if (threadCount == 0U) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    ThreadPool* threadPool = new ThreadPool{ };
+    threadPool->task = nullptr;
+    threadPool->taskCount = 0U;
+    threadPool->nextTaskIndex = 0U;
+    threadPool->jobGeneration = 0U;
+    threadPool->finishedWorkerCount = 0U;
+    threadPool->quit = false;
+
+    // The calling thread also runs tasks, so one worker less is needed
+    for (uint32_t i = 1U; i < threadCount; ++i) {
+        threadPool->workers.emplace_back(ThreadPoolWorkerMain, threadPool);
+    }
+
+    return threadPool;
+}
+
+auto DestroyThreadPool(ThreadPool* threadPool) -> void
+{
+    if (threadPool == nullptr) return;
+
+    {
+        std::lock_guard<std::mutex> lock(threadPool->mutex);
+        threadPool->quit = true;
+    }
+    threadPool->workCondition.notify_all();
+
+    for (std::thread& worker : threadPool->workers) {
+        worker.join();
+    }
+
+    delete threadPool;
+}
+
+auto GetThreadPoolThreadCount(const ThreadPool* threadPool) -> uint32_t
+{
+    return uint32_t(threadPool->workers.size()) + 1U;
+}
+
+auto ThreadPoolParallelFor(ThreadPool* threadPool, uint32_t taskCount, const std::function<void(uint32_t)>& task) -> void
+{
+    if (taskCount == 0U) return;
+
+    // Small jobs and pools without workers run on the calling thread only
+    if (threadPool == nullptr || threadPool->workers.empty() || taskCount == 1U)
+    {
+        for (uint32_t index = 0U; index < taskCount; ++index) {
+            task(index);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(threadPool->mutex);
+        threadPool->task = &task;
+        threadPool->taskCount = taskCount;
+        threadPool->nextTaskIndex = 0U;
+        threadPool->finishedWorkerCount = 0U;
+        ++threadPool->jobGeneration;
+    }
+    threadPool->workCondition.notify_all();
+
+    RunThreadPoolTasks(threadPool, task, taskCount);
+
+    // Every worker takes part in every job, even when no task index is left for it. Waiting for all of them
+    // keeps `task` alive until the last worker is done with it and keeps late workers out of the next job.
+    std::unique_lock<std::mutex> lock(threadPool->mutex);
+    threadPool->doneCondition.wait(lock, [threadPool] { return threadPool->finishedWorkerCount == uint32_t(threadPool->workers.size()); });
+}
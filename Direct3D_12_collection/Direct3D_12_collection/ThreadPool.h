@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// A fixed-size pool of worker threads for the CPU emulation and reference code.
+
+struct ThreadPool;
+
+// @param threadCount the number of worker threads, 0 means std::thread::hardware_concurrency()
+extern auto CreateThreadPool(uint32_t threadCount) -> ThreadPool*;
+
+extern auto DestroyThreadPool(ThreadPool* threadPool) -> void;
+
+extern auto GetThreadPoolThreadCount(const ThreadPool* threadPool) -> uint32_t;
+
+// Calls task(index) for every index in [0, taskCount) on the worker threads and the calling thread,
+// and returns when all of them have finished. Tasks are handed out one index at a time.
+// Only one thread may call this at a time for the same pool.
+extern auto ThreadPoolParallelFor(ThreadPool* threadPool, uint32_t taskCount, const std::function<void(uint32_t)>& task) -> void;
@@ -0,0 +1,370 @@
+#include "TransformFeedbackReference.h"
+#include "CpuFeatures.h"
+
+#include <cmath>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <bit>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#include <emmintrin.h>
+#define TFB_REFERENCE_USE_SSE   1
+#else
+#define TFB_REFERENCE_USE_SSE   0
+#endif
+
+// MSVC accepts AVX intrinsics in any function, GCC and Clang only in functions compiled for the AVX target.
+// The CPU and the OS support are checked at run time either way.
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#define TFB_REFERENCE_USE_AVX   1
+#define TFB_REFERENCE_AVX_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define TFB_REFERENCE_USE_AVX   1
+#define TFB_REFERENCE_AVX_TARGET    __attribute__((target("avx")))
+#else
+#define TFB_REFERENCE_USE_AVX   0
+#endif
+
+// Row-major, mul(a, b) of HLSL
+static auto MultiplyMatrices(const float a[4][4], const float b[4][4], float out[4][4]) -> void
+{
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column) {
+            out[row][column] = a[row][0] * b[0][column] + a[row][1] * b[1][column] + a[row][2] * b[2][column] + a[row][3] * b[3][column];
+        }
+    }
+}
+
+// mul(rotateMatrix, mul(translateMatrix, projectionMatrix)) of tfb_basic.vert.hlsl
+static auto GetTfbReferenceMatrix(float rotAngle, float out[4][4]) -> void
+{
+    // glTranslate(0.0, 0.0, -2.3, 1.0)
+    const float translateMatrix[4][4] = {
+        { 1.0f, 0.0f, 0.0f, 0.0f },     // row 0
+        { 0.0f, 1.0f, 0.0f, 0.0f },     // row 1
+        { 0.0f, 0.0f, 1.0f, 0.0f },     // row 2
+        { 0.0f, 0.0f, -2.3f, 1.0f }     // row 3
+    };
+
+    // radians()
+    const float rotRadian = rotAngle * (3.14159265358979323846f / 180.0f);
+
+    // glRotate(u_angle, 0.0, 0.0, 1.0)
+    const float rotateMatrix[4][4] = {
+        { std::cos(rotRadian), std::sin(rotRadian), 0.0f, 0.0f },   // row 0
+        { -std::sin(rotRadian), std::cos(rotRadian), 0.0f, 0.0f },  // row 1
+        { 0.0f, 0.0f, 1.0f, 0.0f },                                 // row 2
+        { 0.0f, 0.0f, 0.0f, 1.0f }                                  // row 3
+    };
+
+    // glOrtho(-1.0, 1.0, -1.0, 1.0, 1.0, 3.0)
+    const float projectionMatrix[4][4] = {
+        { 1.0f, 0.0f, 0.0f, 0.0f },     // row 0
+        { 0.0f, 1.0f, 0.0f, 0.0f },     // row 1
+        { 0.0f, 0.0f, -1.0f, 0.0f },    // row 2
+        { 0.0f, 0.0f, -2.0f, 1.0f }     // row 3
+    };
+
+    float translateProjectionMatrix[4][4];
+    MultiplyMatrices(translateMatrix, projectionMatrix, translateProjectionMatrix);
+    MultiplyMatrices(rotateMatrix, translateProjectionMatrix, out);
+}
+
+// Every kernel computes ((x * m[0][c] + y * m[1][c]) + z * m[2][c]) + w * m[3][c] for the output component c
+static auto TransformBlocksScalar(const float m[4][4], const TfbReferenceVertexBlock* src, TfbReferenceVertexBlock* dst, size_t blockCount) -> void
+{
+    for (size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+    {
+        const TfbReferenceVertexBlock& in = src[blockIndex];
+        TfbReferenceVertexBlock& out = dst[blockIndex];
+
+        for (uint32_t lane = 0U; lane < TFB_REFERENCE_BLOCK_SIZE; ++lane)
+        {
+            const float x = in.position[0][lane];
+            const float y = in.position[1][lane];
+            const float z = in.position[2][lane];
+            const float w = in.position[3][lane];
+            for (int c = 0; c < 4; ++c)
+            {
+                out.position[c][lane] = x * m[0][c] + y * m[1][c] + z * m[2][c] + w * m[3][c];
+                out.color[c][lane] = in.color[c][lane];
+            }
+        }
+    }
+}
+
+#if TFB_REFERENCE_USE_SSE
+static auto TransformBlocksSSE(const float m[4][4], const TfbReferenceVertexBlock* src, TfbReferenceVertexBlock* dst, size_t blockCount) -> void
+{
+    __m128 matrix[4][4];
+    for (int r = 0; r < 4; ++r)
+    {
+        for (int c = 0; c < 4; ++c) {
+            matrix[r][c] = _mm_set1_ps(m[r][c]);
+        }
+    }
+
+    for (size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+    {
+        const TfbReferenceVertexBlock& in = src[blockIndex];
+        TfbReferenceVertexBlock& out = dst[blockIndex];
+
+        for (uint32_t lane = 0U; lane < TFB_REFERENCE_BLOCK_SIZE; lane += 4U)
+        {
+            const __m128 x = _mm_load_ps(&in.position[0][lane]);
+            const __m128 y = _mm_load_ps(&in.position[1][lane]);
+            const __m128 z = _mm_load_ps(&in.position[2][lane]);
+            const __m128 w = _mm_load_ps(&in.position[3][lane]);
+            for (int c = 0; c < 4; ++c)
+            {
+                __m128 result = _mm_add_ps(_mm_mul_ps(x, matrix[0][c]), _mm_mul_ps(y, matrix[1][c]));
+                result = _mm_add_ps(result, _mm_mul_ps(z, matrix[2][c]));
+                result = _mm_add_ps(result, _mm_mul_ps(w, matrix[3][c]));
+                _mm_store_ps(&out.position[c][lane], result);
+                _mm_store_ps(&out.color[c][lane], _mm_load_ps(&in.color[c][lane]));
+            }
+        }
+    }
+}
+#endif
+
+#if TFB_REFERENCE_USE_AVX
+TFB_REFERENCE_AVX_TARGET
+static auto TransformBlocksAVX(const float m[4][4], const TfbReferenceVertexBlock* src, TfbReferenceVertexBlock* dst, size_t blockCount) -> void
+{
+    static_assert(TFB_REFERENCE_BLOCK_SIZE == 8U, "One block is one AVX register per component");
+
+    __m256 matrix[4][4];
+    for (int r = 0; r < 4; ++r)
+    {
+        for (int c = 0; c < 4; ++c) {
+            matrix[r][c] = _mm256_set1_ps(m[r][c]);
+        }
+    }
+
+    for (size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+    {
+        const TfbReferenceVertexBlock& in = src[blockIndex];
+        TfbReferenceVertexBlock& out = dst[blockIndex];
+
+        const __m256 x = _mm256_load_ps(in.position[0]);
+        const __m256 y = _mm256_load_ps(in.position[1]);
+        const __m256 z = _mm256_load_ps(in.position[2]);
+        const __m256 w = _mm256_load_ps(in.position[3]);
+        for (int c = 0; c < 4; ++c)
+        {
+            __m256 result = _mm256_add_ps(_mm256_mul_ps(x, matrix[0][c]), _mm256_mul_ps(y, matrix[1][c]));
+            result = _mm256_add_ps(result, _mm256_mul_ps(z, matrix[2][c]));
+            result = _mm256_add_ps(result, _mm256_mul_ps(w, matrix[3][c]));
+            _mm256_store_ps(out.position[c], result);
+            _mm256_store_ps(out.color[c], _mm256_load_ps(in.color[c]));
+        }
+    }
+}
+#endif
+
+auto IsTfbReferenceKernelSupported(TfbReferenceKernel kernel) -> bool
+{
+    switch (kernel)
+    {
+    case TfbReferenceKernel::Scalar:
+        return true;
+
+    case TfbReferenceKernel::SSE:
+        return TFB_REFERENCE_USE_SSE != 0;
+
+    case TfbReferenceKernel::AVX:
+        return TFB_REFERENCE_USE_AVX != 0 && IsAVXSupportedByCPU();
+
+    default:
+        return false;
+    }
+}
+
+auto GetTfbReferenceKernelName(TfbReferenceKernel kernel) -> const char*
+{
+    switch (kernel)
+    {
+    case TfbReferenceKernel::Scalar:
+        return "scalar";
+
+    case TfbReferenceKernel::SSE:
+        return "SSE";
+
+    case TfbReferenceKernel::AVX:
+        return "AVX";
+
+    default:
+        return "unknown";
+    }
+}
+
+auto PackTfbReferenceVertices(const TfbReferenceVertex* vertices, size_t vertexCount) -> std::vector<TfbReferenceVertexBlock>
+{
+    std::vector<TfbReferenceVertexBlock> blocks((vertexCount + TFB_REFERENCE_BLOCK_SIZE - 1U) / TFB_REFERENCE_BLOCK_SIZE, TfbReferenceVertexBlock{ });
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        TfbReferenceVertexBlock& block = blocks[i / TFB_REFERENCE_BLOCK_SIZE];
+        const size_t lane = i % TFB_REFERENCE_BLOCK_SIZE;
+        for (int c = 0; c < 4; ++c)
+        {
+            block.position[c][lane] = vertices[i].position[c];
+            block.color[c][lane] = vertices[i].color[c];
+        }
+    }
+    return blocks;
+}
+
+auto UnpackTfbReferenceVertices(const std::vector<TfbReferenceVertexBlock>& blocks, size_t vertexCount) -> std::vector<TfbReferenceVertex>
+{
+    vertexCount = std::min(vertexCount, blocks.size() * TFB_REFERENCE_BLOCK_SIZE);
+
+    std::vector<TfbReferenceVertex> vertices(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        const TfbReferenceVertexBlock& block = blocks[i / TFB_REFERENCE_BLOCK_SIZE];
+        const size_t lane = i % TFB_REFERENCE_BLOCK_SIZE;
+        for (int c = 0; c < 4; ++c)
+        {
+            vertices[i].position[c] = block.position[c][lane];
+            vertices[i].color[c] = block.color[c][lane];
+        }
+    }
+    return vertices;
+}
+
+auto TransformTfbReferenceVertices(TfbReferenceKernel kernel, float rotAngle, const TfbReferenceVertexBlock* src,
+                                    TfbReferenceVertexBlock* dst, size_t blockCount) -> void
+{
+    float matrix[4][4];
+    GetTfbReferenceMatrix(rotAngle, matrix);
+
+    if (!IsTfbReferenceKernelSupported(kernel)) {
+        kernel = TfbReferenceKernel::Scalar;
+    }
+
+    switch (kernel)
+    {
+#if TFB_REFERENCE_USE_SSE
+    case TfbReferenceKernel::SSE:
+        TransformBlocksSSE(matrix, src, dst, blockCount);
+        break;
+#endif
+
+#if TFB_REFERENCE_USE_AVX
+    case TfbReferenceKernel::AVX:
+        TransformBlocksAVX(matrix, src, dst, blockCount);
+        break;
+#endif
+
+    case TfbReferenceKernel::Scalar:
+    default:
+        TransformBlocksScalar(matrix, src, dst, blockCount);
+        break;
+    }
+}
+
+auto GetTfbReferenceOutput(const TfbReferenceVertex* vertices, size_t vertexCount, float rotAngle) -> std::vector<TfbReferenceVertex>
+{
+    const std::vector<TfbReferenceVertexBlock> src = PackTfbReferenceVertices(vertices, vertexCount);
+    std::vector<TfbReferenceVertexBlock> dst(src.size());
+    TransformTfbReferenceVertices(TfbReferenceKernel::Scalar, rotAngle, src.data(), dst.data(), src.size());
+    return UnpackTfbReferenceVertices(dst, vertexCount);
+}
+
+// Distance in units in the last place. Floats are mapped to a monotonic integer line, so -0 and +0 are 0 ULP apart.
+static auto GetUlpDifference(float a, float b) -> uint32_t
+{
+    auto const toOrdered = [](float value) -> int64_t {
+        const int32_t bits = std::bit_cast<int32_t>(value);
+        return bits < 0 ? -int64_t(bits & 0x7fffffff) : int64_t(bits);
+    };
+
+    const int64_t difference = toOrdered(a) - toOrdered(b);
+    return uint32_t(std::min<int64_t>(difference < 0 ? -difference : difference, UINT32_MAX));
+}
+
+// @return true if the vertex is within the tolerance. result keeps the largest differences.
+static auto CompareVertex(const TfbReferenceVertex& expected, const TfbReferenceVertex& actual, uint32_t maxUlp, float maxAbsDifference,
+                        TfbReferenceCompareResult& result) -> bool
+{
+    bool match = true;
+    for (int c = 0; c < 8; ++c)
+    {
+        const float e = c < 4 ? expected.position[c] : expected.color[c - 4];
+        const float a = c < 4 ? actual.position[c] : actual.color[c - 4];
+
+        const uint32_t ulp = GetUlpDifference(e, a);
+        const float absDifference = std::fabs(e - a);
+        result.maxUlpDifference = std::max(result.maxUlpDifference, ulp);
+        if (absDifference > result.maxAbsDifference || std::isnan(absDifference)) {
+            result.maxAbsDifference = absDifference;
+        }
+
+        if (ulp > maxUlp && !(absDifference <= maxAbsDifference)) {
+            match = false;
+        }
+    }
+    return match;
+}
+
+auto CompareTfbReferenceVertices(const TfbReferenceVertex* expected, const TfbReferenceVertex* actual, size_t vertexCount,
+                                uint32_t maxUlp, float maxAbsDifference) -> TfbReferenceCompareResult
+{
+    TfbReferenceCompareResult result{ .mismatchCount = 0U, .unmatchedCount = 0U, .maxUlpDifference = 0U, .maxAbsDifference = 0.0f, .firstMismatchIndex = SIZE_MAX };
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        if (CompareVertex(expected[i], actual[i], maxUlp, maxAbsDifference, result)) continue;
+
+        if (result.mismatchCount++ == 0U) {
+            result.firstMismatchIndex = i;
+        }
+    }
+    return result;
+}
+
+auto CompareTfbReferenceRecordsByColor(const TfbReferenceVertex* expected, size_t expectedCount, const TfbReferenceVertex* records, size_t recordCount,
+                                        uint32_t maxUlp, float maxAbsDifference) -> TfbReferenceCompareResult
+{
+    TfbReferenceCompareResult result{ .mismatchCount = 0U, .unmatchedCount = 0U, .maxUlpDifference = 0U, .maxAbsDifference = 0.0f, .firstMismatchIndex = SIZE_MAX };
+    for (size_t i = 0; i < recordCount; ++i)
+    {
+        const TfbReferenceVertex* const match = std::find_if(expected, expected + expectedCount, [&records, i](const TfbReferenceVertex& vertex) {
+            return std::memcmp(vertex.color, records[i].color, sizeof(vertex.color)) == 0;
+        });
+
+        bool valid = match != expected + expectedCount;
+        if (!valid) {
+            ++result.unmatchedCount;
+        }
+        else {
+            valid = CompareVertex(*match, records[i], maxUlp, maxAbsDifference, result);
+        }
+
+        if (!valid && result.mismatchCount++ == 0U) {
+            result.firstMismatchIndex = i;
+        }
+    }
+    return result;
+}
+
+auto MeasureTfbReferenceThroughput(TfbReferenceKernel kernel, const TfbReferenceVertex* vertices, size_t vertexCount, uint32_t iterationCount) -> double
+{
+    const std::vector<TfbReferenceVertexBlock> src = PackTfbReferenceVertices(vertices, vertexCount);
+    std::vector<TfbReferenceVertexBlock> dst(src.size());
+
+    // Warm up the caches and the page mapping of dst
+    TransformTfbReferenceVertices(kernel, 0.0f, src.data(), dst.data(), src.size());
+
+    const auto beginTime = std::chrono::steady_clock::now();
+    for (uint32_t i = 0U; i < iterationCount; ++i) {
+        TransformTfbReferenceVertices(kernel, float(i % 360U), src.data(), dst.data(), src.size());
+    }
+    const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - beginTime;
+
+    return seconds.count() > 0.0 ? double(vertexCount) * iterationCount / seconds.count() : 0.0;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// C++ port of tfb_basic.vert.hlsl for validating the transform feedback output on the CPU.
+// Vertices are transformed in an AoSoA layout of 8-vertex blocks, so the SSE and AVX kernels load one component of 4 or 8 vertices
+// with a single aligned load. Every kernel evaluates the same operations in the same order, so their results are bit-identical.
+
+static constexpr uint32_t TFB_REFERENCE_BLOCK_SIZE = 8U;
+
+// The Vertex of TransformFeedbackTest.cpp and the PSInput of tfb_basic.vert.hlsl, i.e. one stream output record
+struct TfbReferenceVertex
+{
+    float position[4];
+    float color[4];
+};
+
+// TFB_REFERENCE_BLOCK_SIZE vertices, component-major
+struct alignas(32) TfbReferenceVertexBlock
+{
+    float position[4][TFB_REFERENCE_BLOCK_SIZE];
+    float color[4][TFB_REFERENCE_BLOCK_SIZE];
+};
+
+enum class TfbReferenceKernel
+{
+    Scalar,
+    SSE,
+    AVX
+};
+
+// The AVX kernel is only supported when both the compiler and the CPU support AVX
+extern auto IsTfbReferenceKernelSupported(TfbReferenceKernel kernel) -> bool;
+
+extern auto GetTfbReferenceKernelName(TfbReferenceKernel kernel) -> const char*;
+
+// The padding vertices of the last block are zero
+extern auto PackTfbReferenceVertices(const TfbReferenceVertex* vertices, size_t vertexCount) -> std::vector<TfbReferenceVertexBlock>;
+
+extern auto UnpackTfbReferenceVertices(const std::vector<TfbReferenceVertexBlock>& blocks, size_t vertexCount) -> std::vector<TfbReferenceVertex>;
+
+// The vertex shader with cbRotationAngle.rotAngle == rotAngle (in degrees). An unsupported kernel falls back to the scalar one.
+extern auto TransformTfbReferenceVertices(TfbReferenceKernel kernel, float rotAngle, const TfbReferenceVertexBlock* src,
+                                        TfbReferenceVertexBlock* dst, size_t blockCount) -> void;
+
+// Convenience wrapper around PackTfbReferenceVertices, TransformTfbReferenceVertices and UnpackTfbReferenceVertices
+extern auto GetTfbReferenceOutput(const TfbReferenceVertex* vertices, size_t vertexCount, float rotAngle) -> std::vector<TfbReferenceVertex>;
+
+struct TfbReferenceCompareResult
+{
+    uint32_t mismatchCount;         // records with at least one component out of tolerance
+    uint32_t unmatchedCount;        // records whose color matches no expected vertex (CompareTfbReferenceRecordsByColor only)
+    uint32_t maxUlpDifference;
+    float maxAbsDifference;
+    size_t firstMismatchIndex;      // SIZE_MAX if every record matches
+};
+
+// Two components match when they are at most maxUlp units in the last place or at most maxAbsDifference apart.
+// The absolute tolerance covers results near zero and the low precision of sin() and cos() on the GPU.
+extern auto CompareTfbReferenceVertices(const TfbReferenceVertex* expected, const TfbReferenceVertex* actual, size_t vertexCount,
+                                        uint32_t maxUlp, float maxAbsDifference) -> TfbReferenceCompareResult;
+
+// Stream output expands strips into lists, so the records are matched with the expected vertex of the same color,
+// which the vertex shader passes through unchanged. The expected vertices must have distinct colors.
+extern auto CompareTfbReferenceRecordsByColor(const TfbReferenceVertex* expected, size_t expectedCount, const TfbReferenceVertex* records, size_t recordCount,
+                                            uint32_t maxUlp, float maxAbsDifference) -> TfbReferenceCompareResult;
+
+// Transforms vertexCount vertices iterationCount times with one kernel
+// @return vertices per second
+extern auto MeasureTfbReferenceThroughput(TfbReferenceKernel kernel, const TfbReferenceVertex* vertices, size_t vertexCount, uint32_t iterationCount) -> double;
@@ -1,7 +1,67 @@
 #include "common.h"
+#include "CaptureFileWriter.h"
+#include "TransformFeedbackReference.h"
+
+#include <atomic>
+
+// Stream the vertex shader output into a capture file through a ring of stream output buffers once at startup.
+// This writes about 720 MB to STREAM_OUTPUT_CAPTURE_PATH, which is kept for inspection.
+#define RUN_STREAM_OUTPUT_CAPTURE   1
+
+// Delete the capture file after the measurement, for runs that are only after the write throughput
+#define STREAM_OUTPUT_CAPTURE_THROUGHPUT_ONLY   0
+
+// Relative to the working directory. Define it on the compiler command line to capture somewhere else.
+#ifndef STREAM_OUTPUT_CAPTURE_PATH
+#define STREAM_OUTPUT_CAPTURE_PATH  "so_capture.bin"
+#endif
+
+// Chain stream output passes on the GPU once at startup: the filled size of each pass is turned into
+// the indirect draw arguments of the next pass without a CPU read back
+#define RUN_STREAM_OUTPUT_DRAW_AUTO 1
+
+// Simulate particles with two stream output buffers that swap roles every frame once at startup
+#define RUN_STREAM_OUTPUT_PARTICLES 1
+
+// Measure the CPU port of tfb_basic.vert.hlsl with every supported kernel once at startup
+#define RUN_TFB_REFERENCE_BENCHMARK 1
+
+static constexpr UINT STREAM_OUTPUT_VERTEX_STRIDE = 32U;               // float4 SV_POSITION, float4 COLOR
+static constexpr UINT STREAM_OUTPUT_COUNTER_SIZE = 16U;                // BufferFilledSizeLocation, padded for the vertices that follow it
+static constexpr UINT STREAM_OUTPUT_SQUARE_VERTEX_COUNT = 4U;          // the triangle strip of the square
+static constexpr UINT STREAM_OUTPUT_SQUARE_OUTPUT_VERTEX_COUNT = 6U;   // stream output writes triangle lists
+
+static constexpr UINT STREAM_OUTPUT_CAPTURE_RING_SIZE = 3U;
+static constexpr UINT STREAM_OUTPUT_CAPTURE_FRAME_COUNT = 240U;
+static constexpr UINT STREAM_OUTPUT_CAPTURE_INSTANCE_COUNT = 16U * 1024U;
+
+static constexpr UINT STREAM_OUTPUT_DRAW_AUTO_PASS_COUNT = 8U;
+static constexpr UINT STREAM_OUTPUT_DRAW_AUTO_INSTANCE_COUNT = 4U * 1024U;
+
+// Every emitter spawns one particle per frame, so about 2M particles are alive from the 120th frame on
+static constexpr UINT STREAM_OUTPUT_PARTICLE_EMITTER_COUNT = 16U * 1024U;
+static constexpr UINT STREAM_OUTPUT_PARTICLE_LIFETIME_FRAME_COUNT = 120U;
+static constexpr UINT STREAM_OUTPUT_PARTICLE_FRAME_COUNT = 240U;
+static constexpr float STREAM_OUTPUT_PARTICLE_DELTA_TIME = 1.0f / 60.0f;
+
+static constexpr size_t TFB_REFERENCE_BENCHMARK_VERTEX_COUNT = 1024U * 1024U;
+static constexpr uint32_t TFB_REFERENCE_BENCHMARK_ITERATION_COUNT = 32U;
+
+// Tolerances of the GPU output against TransformFeedbackReference. The absolute tolerance covers sin() and cos() of the GPU.
+static constexpr uint32_t TFB_REFERENCE_MAX_ULP = 4U;
+static constexpr float TFB_REFERENCE_MAX_ABS_DIFFERENCE = 2.0e-3f;
+
+// Direct3D是以左手作为前面背面顶点排列的依据
+static constexpr TfbReferenceVertex s_squareVertices[]{
+    {.position { -0.75f, 0.75f, 0.0f, 1.0f }, .color { 0.9f, 0.1f, 0.1f, 1.0f } },     // top left
+    {.position { 0.75f, 0.75f, 0.0f, 1.0f }, .color { 0.9f, 0.9f, 0.1f, 1.0f } },      // top right
+    {.position { -0.75f, -0.75f, 0.0f, 1.0f }, .color { 0.1f, 0.9f, 0.1f, 1.0f } },    // bottom left
+    {.position { 0.75f, -0.75f, 0.0f, 1.0f }, .color { 0.1f, 0.1f, 0.9f, 1.0f } }      // bottom right
+};
 
 // Only used in RenderPostProcessForTransformFeedback
 static ID3D12Resource* s_readbackBuffer = nullptr;
+static ID3D12Resource* s_constantBuffer = nullptr;
 
 static auto CreateRootSignature(ID3D12Device* d3d_device) -> ID3D12RootSignature*
 {
@@ -53,7 +113,7 @@ static auto CreateRootSignature(ID3D12Device* d3d_device) -> ID3D12RootSignature
         .pParameters = rootParameters,
         .NumStaticSamplers = 0,
         .pStaticSamplers = nullptr,
-        .Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT |
+        .Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT | D3D12_ROOT_SIGNATURE_FLAG_ALLOW_STREAM_OUTPUT |
                     D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS |
                     D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS |
                     D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS |
@@ -239,18 +299,6 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
                                 ID3D12GraphicsCommandList* commandList, ID3D12GraphicsCommandList* commandBundleList, ID3D12DescriptorHeap *descriptorHeap) ->
                                 std::tuple<ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*>
 {
-    const struct Vertex
-    {
-        float position[4];
-        float color[4];
-    } squareVertices[]{
-        // Direct3D是以左手作为前面背面顶点排列的依据
-        {.position { -0.75f, 0.75f, 0.0f, 1.0f }, .color { 0.9f, 0.1f, 0.1f, 1.0f } },     // top left
-        {.position { 0.75f, 0.75f, 0.0f, 1.0f }, .color { 0.9f, 0.9f, 0.1f, 1.0f } },      // top right
-        {.position { -0.75f, -0.75f, 0.0f, 1.0f }, .color { 0.1f, 0.9f, 0.1f, 1.0f } },    // bottom left
-        {.position { 0.75f, -0.75f, 0.0f, 1.0f }, .color { 0.1f, 0.1f, 0.9f, 1.0f } }      // bottom right
-    };
-
     const D3D12_HEAP_PROPERTIES defaultHeapProperties{
         .Type = D3D12_HEAP_TYPE_DEFAULT,    // default heap type for device visible memory
         .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
@@ -277,7 +325,7 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
     const D3D12_RESOURCE_DESC vbResourceDesc{
         .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
         .Alignment = 0,
-        .Width = sizeof(squareVertices),
+        .Width = sizeof(s_squareVertices),
         .Height = 1U,
         .DepthOrArraySize = 1,
         .MipLevels = 1,
@@ -289,7 +337,7 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
     const D3D12_RESOURCE_DESC uavResourceDesc{
         .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
         .Alignment = 0,
-        .Width = sizeof(squareVertices),
+        .Width = sizeof(s_squareVertices),
         .Height = 1U,
         .DepthOrArraySize = 1,
         .MipLevels = 1,
@@ -352,10 +400,10 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
         return result;
     }
 
-    memcpy(hostMemPtr, squareVertices, sizeof(squareVertices));
+    memcpy(hostMemPtr, s_squareVertices, sizeof(s_squareVertices));
     uploadDevHostBuffer->Unmap(0, nullptr);
 
-    WriteToDeviceResourceAndSync(commandList, vertexBuffer, uploadDevHostBuffer, 0U, 0U, sizeof(squareVertices));
+    WriteToDeviceResourceAndSync(commandList, vertexBuffer, uploadDevHostBuffer, 0U, 0U, sizeof(s_squareVertices));
 
     hRes = commandList->Close();
     if (FAILED(hRes))
@@ -371,8 +419,8 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
     // Initialize the vertex buffer view.
     D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
         .BufferLocation = vertexBuffer->GetGPUVirtualAddress(),
-        .SizeInBytes = (uint32_t)sizeof(squareVertices),
-        .StrideInBytes = sizeof(squareVertices[0])
+        .SizeInBytes = (uint32_t)sizeof(s_squareVertices),
+        .StrideInBytes = sizeof(s_squareVertices[0])
     };
 
     const D3D12_RESOURCE_DESC cbResourceDesc{
@@ -427,8 +475,8 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
         .ViewDimension = D3D12_UAV_DIMENSION_BUFFER,
         .Buffer {
             .FirstElement = 0,
-            .NumElements = UINT(std::size(squareVertices)),
-            .StructureByteStride = sizeof(Vertex),
+            .NumElements = UINT(std::size(s_squareVertices)),
+            .StructureByteStride = sizeof(TfbReferenceVertex),
             .CounterOffsetInBytes = 0,
             .Flags = D3D12_BUFFER_UAV_FLAG_NONE
         }
@@ -449,7 +497,7 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
     commandBundleList->SetGraphicsRootDescriptorTable(1, uavDescHandle);        // rootParameters[1]
     commandBundleList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
     commandBundleList->IASetVertexBuffers(0, 1, &vertexBufferView);
-    commandBundleList->DrawInstanced((UINT)std::size(squareVertices), 1, 0, 0);
+    commandBundleList->DrawInstanced((UINT)std::size(s_squareVertices), 1, 0, 0);
 
     // End of the record
     hRes = commandBundleList->Close();
@@ -468,57 +516,1695 @@ static auto CreateVertexBuffer(ID3D12Device* d3d_device, ID3D12RootSignature* ro
     return result;
 }
 
-auto CreateTransformFeedbackTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue *commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
-                                    std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12DescriptorHeap*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*>
+#if RUN_STREAM_OUTPUT_CAPTURE || RUN_STREAM_OUTPUT_DRAW_AUTO
+// Streams out the PSInput of a vertex shader without rasterization. The input layout is the Vertex of CreateVertexBuffer,
+// which is also the layout of the stream output, so the output of one pass can be the vertex buffer of the next one.
+static auto CreatePipelineStateObjectForStreamOutput(ID3D12Device* d3d_device, ID3D12RootSignature* rootSignature, const char* vertexShaderPath) -> ID3D12PipelineState*
 {
-    ID3D12RootSignature* rootSignature = nullptr;
+    D3D12_SHADER_BYTECODE vertexShaderObj = CreateCompiledShaderObjectFromPath(vertexShaderPath);
+    if (vertexShaderObj.pShaderBytecode == nullptr || vertexShaderObj.BytecodeLength == 0) return nullptr;
+
+    const D3D12_INPUT_ELEMENT_DESC inputElementDescs[]{
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+    };
+
+    // PSInput: SV_POSITION, COLOR
+    const D3D12_SO_DECLARATION_ENTRY soDeclaration[]{
+        {.Stream = 0U, .SemanticName = "SV_POSITION", .SemanticIndex = 0U, .StartComponent = 0, .ComponentCount = 4, .OutputSlot = 0 },
+        {.Stream = 0U, .SemanticName = "COLOR", .SemanticIndex = 0U, .StartComponent = 0, .ComponentCount = 4, .OutputSlot = 0 }
+    };
+    const UINT soBufferStrides[]{ STREAM_OUTPUT_VERTEX_STRIDE };
+
+    const D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc{
+        .pRootSignature = rootSignature,
+        .VS = vertexShaderObj,
+        .StreamOutput {
+            .pSODeclaration = soDeclaration,
+            .NumEntries = UINT(std::size(soDeclaration)),
+            .pBufferStrides = soBufferStrides,
+            .NumStrides = UINT(std::size(soBufferStrides)),
+            .RasterizedStream = D3D12_SO_NO_RASTERIZED_STREAM
+        },
+        .BlendState {
+            .AlphaToCoverageEnable = FALSE,
+            .IndependentBlendEnable = FALSE,
+            .RenderTarget { }
+        },
+        .SampleMask = UINT32_MAX,
+        .RasterizerState {
+            .FillMode = D3D12_FILL_MODE_SOLID,
+            .CullMode = D3D12_CULL_MODE_NONE,
+            .FrontCounterClockwise = FALSE,
+            .DepthBias = 0,
+            .DepthBiasClamp = 0.0f,
+            .SlopeScaledDepthBias = 0.0f,
+            .DepthClipEnable = TRUE,
+            .MultisampleEnable = FALSE,
+            .AntialiasedLineEnable = FALSE,
+            .ForcedSampleCount = 0,
+            .ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF
+        },
+        .DepthStencilState {
+            .DepthEnable = FALSE,
+            .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO,
+            .DepthFunc = D3D12_COMPARISON_FUNC_NEVER,
+            .StencilEnable = FALSE,
+            .StencilReadMask = 0,
+            .StencilWriteMask = 0,
+            .FrontFace { },
+            .BackFace { }
+        },
+        .InputLayout {
+            .pInputElementDescs = inputElementDescs,
+            .NumElements = (UINT)std::size(inputElementDescs)
+        },
+        .IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED,
+        .PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+        .NumRenderTargets = 0,
+        .RTVFormats { },
+        .DSVFormat = DXGI_FORMAT_UNKNOWN,
+        .SampleDesc {
+            .Count = 1,
+            .Quality = 0
+        },
+        .NodeMask = 0,
+        .CachedPSO { },
+        .Flags = D3D12_PIPELINE_STATE_FLAG_NONE
+    };
+
     ID3D12PipelineState* pipelineState = nullptr;
-    ID3D12GraphicsCommandList* commandList = nullptr;
-    ID3D12GraphicsCommandList* commandBundleList = nullptr;
-    ID3D12DescriptorHeap* descriptorHeap = nullptr;
-    ID3D12Resource* uploadDevHostBuffer = nullptr;
-    ID3D12Resource* readbackDevHostBuffer = nullptr;
-    ID3D12Resource* vertexBuffer = nullptr;
-    ID3D12Resource* uavBuffer = nullptr;
-    ID3D12Resource* constantBuffer = nullptr;
+    const HRESULT hRes = d3d_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState));
+    free((void*)vertexShaderObj.pShaderBytecode);
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CreateGraphicsPipelineState for stream output with %s failed: %ld\n", vertexShaderPath, hRes);
+        return nullptr;
+    }
 
-    auto result = std::make_tuple(rootSignature, pipelineState, commandList, commandBundleList, descriptorHeap, uploadDevHostBuffer, readbackDevHostBuffer, vertexBuffer, uavBuffer, constantBuffer);
+    return pipelineState;
+}
+#endif
 
-    rootSignature = CreateRootSignature(d3d_device);
-    if (rootSignature == nullptr) return result;
+#if RUN_STREAM_OUTPUT_CAPTURE
 
-    auto pipelineResult = CreatePipelineStateObject(d3d_device, commandAllocator, commandBundleAllocator, rootSignature);
-    pipelineState = std::get<0>(pipelineResult);
-    commandList = std::get<1>(pipelineResult);
-    commandBundleList = std::get<2>(pipelineResult);
-    descriptorHeap = std::get<3>(pipelineResult);
-    if (pipelineState == nullptr || commandList == nullptr || commandBundleList == nullptr || descriptorHeap == nullptr) return result;
+// Capture file: a StreamOutputCaptureFileHeader, then a StreamOutputCaptureBlockHeader and byteSize bytes of vertices per frame
+struct StreamOutputCaptureFileHeader
+{
+    char magic[4];              // "SOCP"
+    uint32_t version;
+    uint32_t vertexStride;
+    uint32_t frameCount;
+};
 
-    auto vertexBufferResult = CreateVertexBuffer(d3d_device, rootSignature, commandQueue, commandList, commandBundleList, descriptorHeap);
-    uploadDevHostBuffer = std::get<0>(vertexBufferResult);
-    readbackDevHostBuffer = std::get<1>(vertexBufferResult);
-    vertexBuffer = std::get<2>(vertexBufferResult);
-    uavBuffer = std::get<3>(vertexBufferResult);
-    constantBuffer = std::get<4>(vertexBufferResult);
-    if (uploadDevHostBuffer == nullptr || readbackDevHostBuffer == nullptr || vertexBuffer == nullptr || uavBuffer == nullptr || constantBuffer == nullptr) return result;
+struct StreamOutputCaptureBlockHeader
+{
+    uint32_t frameIndex;
+    uint32_t byteSize;
+};
 
-    s_readbackBuffer = readbackDevHostBuffer;
-    result = std::make_tuple(rootSignature, pipelineState, commandList, commandBundleList, descriptorHeap, uploadDevHostBuffer, readbackDevHostBuffer, vertexBuffer, uavBuffer, constantBuffer);
-    return result;
+struct StreamOutputCaptureSlot
+{
+    ID3D12CommandAllocator* commandAllocator;
+    ID3D12GraphicsCommandList* commandList;
+    ID3D12Resource* soBuffer;           // [filled size counter][vertices]
+    ID3D12Resource* readbackBuffer;     // the same layout as soBuffer, persistently mapped
+    const uint8_t* readbackData;
+    UINT64 fenceValue;
+    StreamOutputCaptureBlockHeader blockHeader;
+
+    // Set while the writer thread still reads readbackData
+    std::atomic<bool> writing;
+};
+
+// Streams STREAM_OUTPUT_CAPTURE_FRAME_COUNT frames of stream output through a ring of SO buffers. Every frame resets the
+// filled size counter of its SO buffer, draws, and copies the buffer into the read back buffer of its slot. Completed slots
+// are handed to a CaptureFileWriter that writes the filled bytes straight from the mapped read back memory, and a slot is
+// only recorded again after both the GPU and the writer thread are done with it.
+static auto RunStreamOutputCapture(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12RootSignature* rootSignature,
+                                    ID3D12DescriptorHeap* descriptorHeap, ID3D12Resource* vertexBuffer) -> bool
+{
+    constexpr UINT soBufferCapacity = STREAM_OUTPUT_CAPTURE_INSTANCE_COUNT * STREAM_OUTPUT_SQUARE_OUTPUT_VERTEX_COUNT * STREAM_OUTPUT_VERTEX_STRIDE;
+    constexpr UINT soBufferSize = STREAM_OUTPUT_COUNTER_SIZE + soBufferCapacity;
+
+    StreamOutputCaptureSlot slots[STREAM_OUTPUT_CAPTURE_RING_SIZE]{ };
+    ID3D12PipelineState* pipelineState = nullptr;
+    ID3D12Resource* zeroUploadBuffer = nullptr;
+    ID3D12Fence* fence = nullptr;
+    HANDLE hFenceEvent = nullptr;
+    CaptureFileWriter* writer = nullptr;
+    bool success = false;
+
+    const StreamOutputCaptureFileHeader fileHeader{
+        .magic { 'S', 'O', 'C', 'P' },
+        .version = 1U,
+        .vertexStride = STREAM_OUTPUT_VERTEX_STRIDE,
+        .frameCount = STREAM_OUTPUT_CAPTURE_FRAME_COUNT
+    };
+
+    do
+    {
+        pipelineState = CreatePipelineStateObjectForStreamOutput(d3d_device, rootSignature, "cso/tfb_basic.vert.cso");
+        if (pipelineState == nullptr) break;
+
+        HRESULT hRes = d3d_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateFence for stream output capture failed: %ld\n", hRes);
+            break;
+        }
+
+        hFenceEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+        if (hFenceEvent == nullptr)
+        {
+            fprintf(stderr, "CreateEvent for stream output capture failed: %lu\n", GetLastError());
+            break;
+        }
+
+        const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+            .Type = D3D12_HEAP_TYPE_DEFAULT,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
+
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = defaultHeapProperties;
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_HEAP_PROPERTIES readbackHeapProperties = defaultHeapProperties;
+        readbackHeapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+        D3D12_RESOURCE_DESC bufferDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0,
+            .Width = STREAM_OUTPUT_COUNTER_SIZE,
+            .Height = 1U,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {.Count = 1U, .Quality = 0 },
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE
+        };
+        hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&zeroUploadBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for stream output counter upload buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        void* hostMemPtr = nullptr;
+        hRes = zeroUploadBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map stream output counter upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        memset(hostMemPtr, 0, STREAM_OUTPUT_COUNTER_SIZE);
+        zeroUploadBuffer->Unmap(0, nullptr);
+
+        bufferDesc.Width = soBufferSize;
+        for (StreamOutputCaptureSlot& slot : slots)
+        {
+            hRes = d3d_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&slot.commandAllocator));
+            if (FAILED(hRes))
+            {
+                fprintf(stderr, "CreateCommandAllocator for stream output capture failed: %ld\n", hRes);
+                break;
+            }
+
+            hRes = d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, slot.commandAllocator, pipelineState, IID_PPV_ARGS(&slot.commandList));
+            if (FAILED(hRes))
+            {
+                fprintf(stderr, "CreateCommandList for stream output capture failed: %ld\n", hRes);
+                break;
+            }
+            slot.commandList->Close();
+
+            hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                    D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&slot.soBuffer));
+            if (FAILED(hRes))
+            {
+                fprintf(stderr, "CreateCommittedResource for stream output buffer failed: %ld\n", hRes);
+                break;
+            }
+
+            hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                    D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&slot.readbackBuffer));
+            if (FAILED(hRes))
+            {
+                fprintf(stderr, "CreateCommittedResource for stream output read back buffer failed: %ld\n", hRes);
+                break;
+            }
+
+            hRes = slot.readbackBuffer->Map(0, nullptr, (void**)&slot.readbackData);
+            if (FAILED(hRes))
+            {
+                fprintf(stderr, "Map stream output read back buffer failed: %ld\n", hRes);
+                break;
+            }
+        }
+        if (FAILED(hRes)) break;
+
+        writer = CreateCaptureFileWriter(STREAM_OUTPUT_CAPTURE_PATH);
+        if (writer == nullptr)
+        {
+            fprintf(stderr, "Create capture file %s failed!\n", STREAM_OUTPUT_CAPTURE_PATH);
+            break;
+        }
+        CaptureFileWriterAppend(writer, &fileHeader, sizeof(fileHeader), { });
+
+        const D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
+            .BufferLocation = vertexBuffer->GetGPUVirtualAddress(),
+            .SizeInBytes = UINT(vertexBuffer->GetDesc().Width),
+            .StrideInBytes = STREAM_OUTPUT_VERTEX_STRIDE
+        };
+
+        auto const descHandleIncrSize = d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        const D3D12_GPU_DESCRIPTOR_HANDLE cbvDescHandle = descriptorHeap->GetGPUDescriptorHandleForHeapStart();
+        D3D12_GPU_DESCRIPTOR_HANDLE uavDescHandle = cbvDescHandle;
+        uavDescHandle.ptr += 1U * descHandleIncrSize;
+
+        UINT64 fenceValue = 0U;
+        UINT nextCollectFrame = 0U;
+        UINT gpuWaitCount = 0U;
+        UINT writerWaitCount = 0U;
+        UINT unexpectedSizeCount = 0U;
+        TfbReferenceCompareResult referenceResult{ };
+
+        // cbRotationAngle is still 0 from CreateVertexBuffer
+        const std::vector<TfbReferenceVertex> expectedVertices = GetTfbReferenceOutput(s_squareVertices, std::size(s_squareVertices), 0.0f);
+
+        // Hands the completed frames in [nextCollectFrame, endFrame) to the writer in frame order.
+        // Without wait, it stops at the first frame that the GPU has not completed yet.
+        auto const collectFrames = [&](UINT endFrame, bool wait) {
+            for (; nextCollectFrame < endFrame; ++nextCollectFrame)
+            {
+                StreamOutputCaptureSlot& slot = slots[nextCollectFrame % STREAM_OUTPUT_CAPTURE_RING_SIZE];
+                if (fence->GetCompletedValue() < slot.fenceValue)
+                {
+                    if (!wait) break;
+
+                    ++gpuWaitCount;
+                    fence->SetEventOnCompletion(slot.fenceValue, hFenceEvent);
+                    WaitForSingleObject(hFenceEvent, INFINITE);
+                }
+
+                UINT filledSize = 0U;
+                memcpy(&filledSize, slot.readbackData, sizeof(filledSize));
+                if (filledSize != soBufferCapacity) {
+                    ++unexpectedSizeCount;
+                }
+
+                slot.blockHeader = StreamOutputCaptureBlockHeader{
+                    .frameIndex = nextCollectFrame,
+                    .byteSize = (std::min)(filledSize, soBufferCapacity)
+                };
+
+                // Every frame streams out the same records, so the first one is checked against the CPU reference
+                if (nextCollectFrame == 0U)
+                {
+                    referenceResult = CompareTfbReferenceRecordsByColor(expectedVertices.data(), expectedVertices.size(),
+                                                                        (const TfbReferenceVertex*)(slot.readbackData + STREAM_OUTPUT_COUNTER_SIZE),
+                                                                        slot.blockHeader.byteSize / STREAM_OUTPUT_VERTEX_STRIDE,
+                                                                        TFB_REFERENCE_MAX_ULP, TFB_REFERENCE_MAX_ABS_DIFFERENCE);
+                }
+                slot.writing = true;
+                CaptureFileWriterAppend(writer, &slot.blockHeader, sizeof(slot.blockHeader), { });
+                CaptureFileWriterAppend(writer, slot.readbackData + STREAM_OUTPUT_COUNTER_SIZE, slot.blockHeader.byteSize, [&slot] {
+                    slot.writing = false;
+                    slot.writing.notify_one();
+                });
+            }
+        };
+
+        LARGE_INTEGER frequency{ }, beginTime{ }, endTime{ };
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&beginTime);
+
+        for (UINT frame = 0U; frame < STREAM_OUTPUT_CAPTURE_FRAME_COUNT; ++frame)
+        {
+            collectFrames(frame, false);
+
+            // The slot of this frame must be released by the GPU and then by the writer thread
+            if (frame >= STREAM_OUTPUT_CAPTURE_RING_SIZE) {
+                collectFrames(frame - STREAM_OUTPUT_CAPTURE_RING_SIZE + 1U, true);
+            }
+
+            StreamOutputCaptureSlot& slot = slots[frame % STREAM_OUTPUT_CAPTURE_RING_SIZE];
+            if (slot.writing)
+            {
+                ++writerWaitCount;
+                slot.writing.wait(true);
+            }
+
+            ID3D12GraphicsCommandList* commandList = slot.commandList;
+            slot.commandAllocator->Reset();
+            commandList->Reset(slot.commandAllocator, pipelineState);
+
+            commandList->SetGraphicsRootSignature(rootSignature);
+            ID3D12DescriptorHeap* const descHeaps[]{ descriptorHeap };
+            commandList->SetDescriptorHeaps(UINT(std::size(descHeaps)), descHeaps);
+            commandList->SetGraphicsRootDescriptorTable(0, cbvDescHandle);
+            commandList->SetGraphicsRootDescriptorTable(1, uavDescHandle);
+
+            // The SO buffer has decayed to the common state at the end of the previous frame,
+            // so the counter reset promotes it to the copy destination state.
+            commandList->CopyBufferRegion(slot.soBuffer, 0U, zeroUploadBuffer, 0U, STREAM_OUTPUT_COUNTER_SIZE);
+
+            D3D12_RESOURCE_BARRIER barrier{
+                .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+                .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+                .Transition {
+                    .pResource = slot.soBuffer,
+                    .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                    .StateBefore = D3D12_RESOURCE_STATE_COPY_DEST,
+                    .StateAfter = D3D12_RESOURCE_STATE_STREAM_OUT
+                }
+            };
+            commandList->ResourceBarrier(1U, &barrier);
+
+            const D3D12_GPU_VIRTUAL_ADDRESS soBufferAddress = slot.soBuffer->GetGPUVirtualAddress();
+            const D3D12_STREAM_OUTPUT_BUFFER_VIEW soBufferView{
+                .BufferLocation = soBufferAddress + STREAM_OUTPUT_COUNTER_SIZE,
+                .SizeInBytes = soBufferCapacity,
+                .BufferFilledSizeLocation = soBufferAddress
+            };
+            commandList->SOSetTargets(0U, 1U, &soBufferView);
+
+            commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+            commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+            commandList->DrawInstanced(STREAM_OUTPUT_SQUARE_VERTEX_COUNT, STREAM_OUTPUT_CAPTURE_INSTANCE_COUNT, 0, 0);
+
+            commandList->SOSetTargets(0U, 1U, nullptr);
+
+            barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_STREAM_OUT;
+            barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+            commandList->ResourceBarrier(1U, &barrier);
+
+            commandList->CopyBufferRegion(slot.readbackBuffer, 0U, slot.soBuffer, 0U, soBufferSize);
+
+            hRes = commandList->Close();
+            if (FAILED(hRes))
+            {
+                fprintf(stderr, "Close stream output capture command list failed: %ld\n", hRes);
+                break;
+            }
+
+            ID3D12CommandList* const ppCommandLists[] = { (ID3D12CommandList*)commandList };
+            commandQueue->ExecuteCommandLists((UINT)std::size(ppCommandLists), ppCommandLists);
+
+            slot.fenceValue = ++fenceValue;
+            hRes = commandQueue->Signal(fence, fenceValue);
+            if (FAILED(hRes))
+            {
+                fprintf(stderr, "Signal stream output capture fence failed: %ld\n", hRes);
+                break;
+            }
+        }
+        if (FAILED(hRes)) break;
+
+        collectFrames(STREAM_OUTPUT_CAPTURE_FRAME_COUNT, true);
+
+        const CaptureFileWriterStats stats = DestroyCaptureFileWriter(writer);
+        writer = nullptr;
+
+        QueryPerformanceCounter(&endTime);
+        const double seconds = double(endTime.QuadPart - beginTime.QuadPart) / double(frequency.QuadPart);
+
+        const double megabytes = double(stats.byteCount) / (1024.0 * 1024.0);
+        printf("Stream output capture: %u frames, %.2f MB written to %s in %.3f s, %.1f MB/s sustained\n",
+                STREAM_OUTPUT_CAPTURE_FRAME_COUNT, megabytes, STREAM_OUTPUT_CAPTURE_PATH, seconds, megabytes / seconds);
+        printf("    writer thread busy %.1f%%, %u GPU waits, %u writer waits, %u frames with an unexpected filled size, %u write errors\n",
+                stats.busySeconds * 100.0 / seconds, gpuWaitCount, writerWaitCount, unexpectedSizeCount, stats.errorCount);
+        printf("    first frame against the CPU reference: %u mismatched records, %u unknown records, max %u ULP, max abs difference %g\n",
+                referenceResult.mismatchCount, referenceResult.unmatchedCount, referenceResult.maxUlpDifference, referenceResult.maxAbsDifference);
+
+        success = stats.errorCount == 0U && unexpectedSizeCount == 0U && referenceResult.mismatchCount == 0U;
+    }
+    while (false);
+
+    // The GPU may still copy into the read back buffers and the writer thread may still read them
+    WaitForPreviousFrame(commandQueue);
+    if (writer != nullptr) {
+        DestroyCaptureFileWriter(writer);
+    }
+
+#if STREAM_OUTPUT_CAPTURE_THROUGHPUT_ONLY
+    remove(STREAM_OUTPUT_CAPTURE_PATH);
+#endif
+
+    for (StreamOutputCaptureSlot& slot : slots)
+    {
+        if (slot.readbackData != nullptr) {
+            slot.readbackBuffer->Unmap(0, nullptr);
+        }
+        if (slot.readbackBuffer != nullptr) {
+            slot.readbackBuffer->Release();
+        }
+        if (slot.soBuffer != nullptr) {
+            slot.soBuffer->Release();
+        }
+        if (slot.commandList != nullptr) {
+            slot.commandList->Release();
+        }
+        if (slot.commandAllocator != nullptr) {
+            slot.commandAllocator->Release();
+        }
+    }
+    if (hFenceEvent != nullptr) {
+        CloseHandle(hFenceEvent);
+    }
+    if (fence != nullptr) {
+        fence->Release();
+    }
+    if (zeroUploadBuffer != nullptr) {
+        zeroUploadBuffer->Release();
+    }
+    if (pipelineState != nullptr) {
+        pipelineState->Release();
+    }
+
+    return success;
 }
+#endif
 
-auto RenderPostProcessForTransformFeedback() -> void
+#if RUN_STREAM_OUTPUT_DRAW_AUTO || RUN_STREAM_OUTPUT_PARTICLES
+// The same layout as CBDrawAuto in so_draw_args.comp.hlsl
+struct StreamOutputDrawAutoConstants
 {
-    float* hostMemPtr = nullptr;
-    const D3D12_RANGE readRange{ 0, 0 };
-    HRESULT hRes = s_readbackBuffer->Map(0, &readRange, (void**)&hostMemPtr);
+    UINT vertexStride;
+    UINT argumentOffset;
+};
+
+static auto CreateRootSignatureForDrawAuto(ID3D12Device* d3d_device) -> ID3D12RootSignature*
+{
+    ID3D12RootSignature* rootSignature = nullptr;
+
+    const D3D12_ROOT_PARAMETER rootParameters[]{
+        {
+            // b0 (draw auto constants)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+            .Constants {
+                .ShaderRegister = 0U,
+                .RegisterSpace = 0U,
+                .Num32BitValues = UINT(sizeof(StreamOutputDrawAutoConstants) / sizeof(UINT))
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        {
+            // t0 (filled size counter)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV,
+            .Descriptor {.ShaderRegister = 0U, .RegisterSpace = 0U },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        },
+        {
+            // u0 (draw arguments)
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV,
+            .Descriptor {.ShaderRegister = 0U, .RegisterSpace = 0U },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        }
+    };
+
+    const D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {
+        .NumParameters = UINT(std::size(rootParameters)),
+        .pParameters = rootParameters,
+        .NumStaticSamplers = 0,
+        .pStaticSamplers = nullptr,
+        .Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE
+    };
+
+    ID3DBlob* signature = nullptr;
+    ID3DBlob* error = nullptr;
+    HRESULT hRes = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error);
+    do
+    {
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "D3D12SerializeRootSignature for draw auto failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateRootSignature for draw auto failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (signature != nullptr) {
+        signature->Release();
+    }
+    if (error != nullptr) {
+        error->Release();
+    }
+
+    if (FAILED(hRes)) return nullptr;
+
+    return rootSignature;
+}
+
+// so_draw_args.comp.hlsl
+static auto CreatePipelineStateObjectForDrawAuto(ID3D12Device* d3d_device, ID3D12RootSignature* computeRootSignature) -> ID3D12PipelineState*
+{
+    D3D12_SHADER_BYTECODE computeShaderObj = CreateCompiledShaderObjectFromPath("cso/so_draw_args.comp.cso");
+    if (computeShaderObj.pShaderBytecode == nullptr || computeShaderObj.BytecodeLength == 0) return nullptr;
+
+    const D3D12_COMPUTE_PIPELINE_STATE_DESC computePipelineStateDesc{
+        .pRootSignature = computeRootSignature,
+        .CS = computeShaderObj,
+        .NodeMask = 0,
+        .CachedPSO { },
+        .Flags = D3D12_PIPELINE_STATE_FLAG_NONE
+    };
+
+    ID3D12PipelineState* pipelineState = nullptr;
+    const HRESULT hRes = d3d_device->CreateComputePipelineState(&computePipelineStateDesc, IID_PPV_ARGS(&pipelineState));
+    free((void*)computeShaderObj.pShaderBytecode);
     if (FAILED(hRes))
     {
-        fprintf(stderr, "Map read back buffer failed: %ld\n", hRes);
-        return;
+        fprintf(stderr, "CreateComputePipelineState for draw auto failed: %ld\n", hRes);
+        return nullptr;
     }
 
-    printf("v[0].x = %f, v[0].y = %f, v[0].z = %f, v[0].w = %f\n", hostMemPtr[0], hostMemPtr[1], hostMemPtr[2], hostMemPtr[3]);
+    return pipelineState;
+}
+
+// Only the draw arguments change per command, so the command signature needs no root signature
+static auto CreateCommandSignatureForDrawAuto(ID3D12Device* d3d_device) -> ID3D12CommandSignature*
+{
+    const D3D12_INDIRECT_ARGUMENT_DESC argumentDescs[]{
+        {.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW }
+    };
+    const D3D12_COMMAND_SIGNATURE_DESC commandSignatureDesc{
+        .ByteStride = UINT(sizeof(D3D12_DRAW_ARGUMENTS)),
+        .NumArgumentDescs = UINT(std::size(argumentDescs)),
+        .pArgumentDescs = argumentDescs,
+        .NodeMask = 0
+    };
+
+    ID3D12CommandSignature* commandSignature = nullptr;
+    const HRESULT hRes = d3d_device->CreateCommandSignature(&commandSignatureDesc, nullptr, IID_PPV_ARGS(&commandSignature));
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "CreateCommandSignature for draw auto failed: %ld\n", hRes);
+        return nullptr;
+    }
+
+    return commandSignature;
+}
+
+// Records the draw arguments of the stream output buffer srcBuffer ([filled size counter][vertices]) at argumentOffset.
+// The compute root signature and pipeline state stay bound.
+static auto RecordDrawAutoArguments(ID3D12GraphicsCommandList* commandList, ID3D12RootSignature* computeRootSignature, ID3D12PipelineState* drawArgsPipelineState,
+                                    ID3D12Resource* srcBuffer, ID3D12Resource* drawArgumentsBuffer, UINT argumentOffset) -> void
+{
+    const StreamOutputDrawAutoConstants constants{
+        .vertexStride = STREAM_OUTPUT_VERTEX_STRIDE,
+        .argumentOffset = argumentOffset
+    };
+    commandList->SetPipelineState(drawArgsPipelineState);
+    commandList->SetComputeRootSignature(computeRootSignature);
+    commandList->SetComputeRoot32BitConstants(0U, UINT(sizeof(constants) / sizeof(UINT)), &constants, 0U);
+    commandList->SetComputeRootShaderResourceView(1U, srcBuffer->GetGPUVirtualAddress());
+    commandList->SetComputeRootUnorderedAccessView(2U, drawArgumentsBuffer->GetGPUVirtualAddress());
+    commandList->Dispatch(1U, 1U, 1U);
+}
+
+// Issues a transition barrier when the tracked state of the resource differs from newState
+static auto TransitionStreamOutputResource(ID3D12GraphicsCommandList* commandList, ID3D12Resource* resource, D3D12_RESOURCE_STATES& state,
+                                            D3D12_RESOURCE_STATES newState) -> void
+{
+    if (state == newState) return;
+
+    const D3D12_RESOURCE_BARRIER barrier{
+        .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+        .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+        .Transition {
+            .pResource = resource,
+            .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+            .StateBefore = state,
+            .StateAfter = newState
+        }
+    };
+    commandList->ResourceBarrier(1U, &barrier);
+    state = newState;
+}
+#endif
+
+#if RUN_STREAM_OUTPUT_DRAW_AUTO
+// Pass 0 streams out the instanced square of tfb_basic.vert.hlsl. Every following pass converts the filled size of the
+// previous stream output buffer into D3D12_DRAW_ARGUMENTS with so_draw_args.comp.hlsl and draws that buffer through
+// so_passthrough.vert.hlsl into the other stream output buffer with ExecuteIndirect(), so the vertex count never leaves
+// the GPU timeline. The whole chain is a single command list; the CPU only reads the counters back afterwards to validate them.
+static auto RunStreamOutputDrawAutoChain(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12RootSignature* rootSignature,
+                                        ID3D12DescriptorHeap* descriptorHeap, ID3D12Resource* vertexBuffer) -> bool
+{
+    constexpr UINT expectedVertexCount = STREAM_OUTPUT_DRAW_AUTO_INSTANCE_COUNT * STREAM_OUTPUT_SQUARE_OUTPUT_VERTEX_COUNT;
+    constexpr UINT soBufferCapacity = expectedVertexCount * STREAM_OUTPUT_VERTEX_STRIDE;
+    constexpr UINT soBufferSize = STREAM_OUTPUT_COUNTER_SIZE + soBufferCapacity;
+    constexpr UINT drawArgumentsSize = (STREAM_OUTPUT_DRAW_AUTO_PASS_COUNT - 1U) * UINT(sizeof(D3D12_DRAW_ARGUMENTS));
+
+    // Read back layout: 2 timestamps, the filled size counter of the last pass, the draw arguments of every chained pass
+    constexpr UINT timestampCount = 2U;
+    constexpr UINT readbackCounterOffset = timestampCount * UINT(sizeof(UINT64));
+    constexpr UINT readbackDrawArgumentsOffset = readbackCounterOffset + STREAM_OUTPUT_COUNTER_SIZE;
+    constexpr UINT readbackBufferSize = readbackDrawArgumentsOffset + drawArgumentsSize;
+
+    ID3D12RootSignature* computeRootSignature = nullptr;
+    ID3D12PipelineState* basicPipelineState = nullptr;
+    ID3D12PipelineState* passthroughPipelineState = nullptr;
+    ID3D12PipelineState* drawArgsPipelineState = nullptr;
+    ID3D12CommandSignature* commandSignature = nullptr;
+    ID3D12CommandAllocator* commandAllocator = nullptr;
+    ID3D12GraphicsCommandList* commandList = nullptr;
+    ID3D12QueryHeap* queryHeap = nullptr;
+    ID3D12Resource* soBuffers[2]{ };
+    ID3D12Resource* drawArgumentsBuffer = nullptr;
+    ID3D12Resource* zeroUploadBuffer = nullptr;
+    ID3D12Resource* readbackBuffer = nullptr;
+    bool success = false;
+
+    do
+    {
+        computeRootSignature = CreateRootSignatureForDrawAuto(d3d_device);
+        if (computeRootSignature == nullptr) break;
+
+        basicPipelineState = CreatePipelineStateObjectForStreamOutput(d3d_device, rootSignature, "cso/tfb_basic.vert.cso");
+        if (basicPipelineState == nullptr) break;
+
+        passthroughPipelineState = CreatePipelineStateObjectForStreamOutput(d3d_device, rootSignature, "cso/so_passthrough.vert.cso");
+        if (passthroughPipelineState == nullptr) break;
+
+        drawArgsPipelineState = CreatePipelineStateObjectForDrawAuto(d3d_device, computeRootSignature);
+        if (drawArgsPipelineState == nullptr) break;
+
+        commandSignature = CreateCommandSignatureForDrawAuto(d3d_device);
+        if (commandSignature == nullptr) break;
+
+        HRESULT hRes = d3d_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommandAllocator for draw auto failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator, basicPipelineState, IID_PPV_ARGS(&commandList));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommandList for draw auto failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_QUERY_HEAP_DESC queryHeapDesc{
+            .Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP,
+            .Count = timestampCount,
+            .NodeMask = 0
+        };
+        hRes = d3d_device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&queryHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateQueryHeap for draw auto failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+            .Type = D3D12_HEAP_TYPE_DEFAULT,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
+
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = defaultHeapProperties;
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_HEAP_PROPERTIES readbackHeapProperties = defaultHeapProperties;
+        readbackHeapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+        D3D12_RESOURCE_DESC bufferDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0,
+            .Width = soBufferSize,
+            .Height = 1U,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {.Count = 1U, .Quality = 0 },
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE
+        };
+        for (ID3D12Resource*& soBuffer : soBuffers)
+        {
+            hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                    D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&soBuffer));
+            if (FAILED(hRes))
+            {
+                fprintf(stderr, "CreateCommittedResource for draw auto stream output buffer failed: %ld\n", hRes);
+                break;
+            }
+        }
+        if (FAILED(hRes)) break;
+
+        bufferDesc.Width = drawArgumentsSize;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&drawArgumentsBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for draw auto arguments buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        bufferDesc.Width = STREAM_OUTPUT_COUNTER_SIZE;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&zeroUploadBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for draw auto counter upload buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        void* hostMemPtr = nullptr;
+        hRes = zeroUploadBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map draw auto counter upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        memset(hostMemPtr, 0, STREAM_OUTPUT_COUNTER_SIZE);
+        zeroUploadBuffer->Unmap(0, nullptr);
+
+        bufferDesc.Width = readbackBufferSize;
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&readbackBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for draw auto read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        // Both stream output buffers start in the common state and are promoted by their first counter reset.
+        // The draw arguments buffer is promoted by the first dispatch.
+        D3D12_RESOURCE_STATES soBufferStates[2]{ D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COPY_DEST };
+        D3D12_RESOURCE_STATES drawArgumentsState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+        auto const transition = [commandList](ID3D12Resource* resource, D3D12_RESOURCE_STATES& state, D3D12_RESOURCE_STATES newState) {
+            TransitionStreamOutputResource(commandList, resource, state, newState);
+        };
+
+        auto const descHandleIncrSize = d3d_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        const D3D12_GPU_DESCRIPTOR_HANDLE cbvDescHandle = descriptorHeap->GetGPUDescriptorHandleForHeapStart();
+        D3D12_GPU_DESCRIPTOR_HANDLE uavDescHandle = cbvDescHandle;
+        uavDescHandle.ptr += 1U * descHandleIncrSize;
+
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0U);
+
+        for (UINT pass = 0U; pass < STREAM_OUTPUT_DRAW_AUTO_PASS_COUNT; ++pass)
+        {
+            ID3D12Resource* const dstBuffer = soBuffers[pass % 2U];
+            D3D12_RESOURCE_STATES& dstState = soBufferStates[pass % 2U];
+
+            if (pass > 0U)
+            {
+                ID3D12Resource* const srcBuffer = soBuffers[(pass - 1U) % 2U];
+                D3D12_RESOURCE_STATES& srcState = soBufferStates[(pass - 1U) % 2U];
+                const UINT argumentOffset = (pass - 1U) * UINT(sizeof(D3D12_DRAW_ARGUMENTS));
+
+                // Filled size of the previous pass -> draw arguments of this pass
+                transition(srcBuffer, srcState, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+                transition(drawArgumentsBuffer, drawArgumentsState, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+                RecordDrawAutoArguments(commandList, computeRootSignature, drawArgsPipelineState, srcBuffer, drawArgumentsBuffer, argumentOffset);
+
+                transition(drawArgumentsBuffer, drawArgumentsState, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+
+                // Reset the counter of this pass before binding it, the previous pass's output is the vertex buffer
+                commandList->CopyBufferRegion(dstBuffer, 0U, zeroUploadBuffer, 0U, STREAM_OUTPUT_COUNTER_SIZE);
+                transition(dstBuffer, dstState, D3D12_RESOURCE_STATE_STREAM_OUT);
+
+                const D3D12_STREAM_OUTPUT_BUFFER_VIEW soBufferView{
+                    .BufferLocation = dstBuffer->GetGPUVirtualAddress() + STREAM_OUTPUT_COUNTER_SIZE,
+                    .SizeInBytes = soBufferCapacity,
+                    .BufferFilledSizeLocation = dstBuffer->GetGPUVirtualAddress()
+                };
+                const D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
+                    .BufferLocation = srcBuffer->GetGPUVirtualAddress() + STREAM_OUTPUT_COUNTER_SIZE,
+                    .SizeInBytes = soBufferCapacity,
+                    .StrideInBytes = STREAM_OUTPUT_VERTEX_STRIDE
+                };
+
+                commandList->SetPipelineState(passthroughPipelineState);
+                commandList->SetGraphicsRootSignature(rootSignature);
+                commandList->SOSetTargets(0U, 1U, &soBufferView);
+                commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+                commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+                commandList->ExecuteIndirect(commandSignature, 1U, drawArgumentsBuffer, argumentOffset, nullptr, 0U);
+            }
+            else
+            {
+                commandList->CopyBufferRegion(dstBuffer, 0U, zeroUploadBuffer, 0U, STREAM_OUTPUT_COUNTER_SIZE);
+                transition(dstBuffer, dstState, D3D12_RESOURCE_STATE_STREAM_OUT);
+
+                const D3D12_STREAM_OUTPUT_BUFFER_VIEW soBufferView{
+                    .BufferLocation = dstBuffer->GetGPUVirtualAddress() + STREAM_OUTPUT_COUNTER_SIZE,
+                    .SizeInBytes = soBufferCapacity,
+                    .BufferFilledSizeLocation = dstBuffer->GetGPUVirtualAddress()
+                };
+                const D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
+                    .BufferLocation = vertexBuffer->GetGPUVirtualAddress(),
+                    .SizeInBytes = UINT(vertexBuffer->GetDesc().Width),
+                    .StrideInBytes = STREAM_OUTPUT_VERTEX_STRIDE
+                };
+
+                commandList->SetGraphicsRootSignature(rootSignature);
+                ID3D12DescriptorHeap* const descHeaps[]{ descriptorHeap };
+                commandList->SetDescriptorHeaps(UINT(std::size(descHeaps)), descHeaps);
+                commandList->SetGraphicsRootDescriptorTable(0, cbvDescHandle);
+                commandList->SetGraphicsRootDescriptorTable(1, uavDescHandle);
+                commandList->SOSetTargets(0U, 1U, &soBufferView);
+                commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+                commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+                commandList->DrawInstanced(STREAM_OUTPUT_SQUARE_VERTEX_COUNT, STREAM_OUTPUT_DRAW_AUTO_INSTANCE_COUNT, 0, 0);
+            }
+
+            commandList->SOSetTargets(0U, 1U, nullptr);
+
+            // The next pass overwrites the buffer that this pass has read
+            if (pass > 0U) {
+                transition(soBuffers[(pass - 1U) % 2U], soBufferStates[(pass - 1U) % 2U], D3D12_RESOURCE_STATE_COPY_DEST);
+            }
+        }
+
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 1U);
+
+        ID3D12Resource* const lastBuffer = soBuffers[(STREAM_OUTPUT_DRAW_AUTO_PASS_COUNT - 1U) % 2U];
+        transition(lastBuffer, soBufferStates[(STREAM_OUTPUT_DRAW_AUTO_PASS_COUNT - 1U) % 2U], D3D12_RESOURCE_STATE_COPY_SOURCE);
+        transition(drawArgumentsBuffer, drawArgumentsState, D3D12_RESOURCE_STATE_COPY_SOURCE);
+
+        commandList->ResolveQueryData(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0U, timestampCount, readbackBuffer, 0U);
+        commandList->CopyBufferRegion(readbackBuffer, readbackCounterOffset, lastBuffer, 0U, STREAM_OUTPUT_COUNTER_SIZE);
+        commandList->CopyBufferRegion(readbackBuffer, readbackDrawArgumentsOffset, drawArgumentsBuffer, 0U, drawArgumentsSize);
+
+        hRes = commandList->Close();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Close draw auto command list failed: %ld\n", hRes);
+            break;
+        }
+
+        ID3D12CommandList* const ppCommandLists[] = { (ID3D12CommandList*)commandList };
+        commandQueue->ExecuteCommandLists((UINT)std::size(ppCommandLists), ppCommandLists);
+        WaitForPreviousFrame(commandQueue);
+
+        UINT64 timestampFrequency = 0U;
+        hRes = commandQueue->GetTimestampFrequency(&timestampFrequency);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "GetTimestampFrequency failed: %ld\n", hRes);
+            break;
+        }
+
+        const uint8_t* readbackData = nullptr;
+        const D3D12_RANGE readRange{ 0, readbackBufferSize };
+        hRes = readbackBuffer->Map(0, &readRange, (void**)&readbackData);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map draw auto read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        UINT64 timestamps[timestampCount]{ };
+        UINT lastFilledSize = 0U;
+        D3D12_DRAW_ARGUMENTS drawArguments[STREAM_OUTPUT_DRAW_AUTO_PASS_COUNT - 1U]{ };
+        memcpy(timestamps, readbackData, sizeof(timestamps));
+        memcpy(&lastFilledSize, readbackData + readbackCounterOffset, sizeof(lastFilledSize));
+        memcpy(drawArguments, readbackData + readbackDrawArgumentsOffset, sizeof(drawArguments));
+        readbackBuffer->Unmap(0, nullptr);
+
+        UINT mismatchCount = lastFilledSize == soBufferCapacity ? 0U : 1U;
+        for (const D3D12_DRAW_ARGUMENTS& arguments : drawArguments)
+        {
+            if (arguments.VertexCountPerInstance != expectedVertexCount || arguments.InstanceCount != 1U) {
+                ++mismatchCount;
+            }
+        }
+
+        const double gpuMilliseconds = double(timestamps[1] - timestamps[0]) * 1000.0 / double(timestampFrequency);
+        printf("Stream output draw auto: %u chained passes of %u vertices in %.3f ms GPU time, last pass vertex count %u, %u mismatches\n",
+                STREAM_OUTPUT_DRAW_AUTO_PASS_COUNT, expectedVertexCount, gpuMilliseconds, lastFilledSize / STREAM_OUTPUT_VERTEX_STRIDE, mismatchCount);
+
+        success = mismatchCount == 0U;
+    }
+    while (false);
+
+    if (readbackBuffer != nullptr) {
+        readbackBuffer->Release();
+    }
+    if (zeroUploadBuffer != nullptr) {
+        zeroUploadBuffer->Release();
+    }
+    if (drawArgumentsBuffer != nullptr) {
+        drawArgumentsBuffer->Release();
+    }
+    for (ID3D12Resource* soBuffer : soBuffers)
+    {
+        if (soBuffer != nullptr) {
+            soBuffer->Release();
+        }
+    }
+    if (queryHeap != nullptr) {
+        queryHeap->Release();
+    }
+    if (commandList != nullptr) {
+        commandList->Release();
+    }
+    if (commandAllocator != nullptr) {
+        commandAllocator->Release();
+    }
+    if (commandSignature != nullptr) {
+        commandSignature->Release();
+    }
+    if (drawArgsPipelineState != nullptr) {
+        drawArgsPipelineState->Release();
+    }
+    if (passthroughPipelineState != nullptr) {
+        passthroughPipelineState->Release();
+    }
+    if (basicPipelineState != nullptr) {
+        basicPipelineState->Release();
+    }
+    if (computeRootSignature != nullptr) {
+        computeRootSignature->Release();
+    }
+
+    return success;
+}
+#endif
+
+#if RUN_STREAM_OUTPUT_PARTICLES
+static constexpr UINT STREAM_OUTPUT_PARTICLE_EMITTER_FLAG = 0x80000000U;
+
+// The same layout as Particle in so_particles.vert.hlsl and so_particles.gs.hlsl
+struct StreamOutputParticle
+{
+    float position[4];      // xyz, w: age in seconds
+    float velocity[3];
+    UINT seed;              // STREAM_OUTPUT_PARTICLE_EMITTER_FLAG is set for emitters
+};
+static_assert(sizeof(StreamOutputParticle) == STREAM_OUTPUT_VERTEX_STRIDE, "so_draw_args.comp.hlsl converts the filled size with STREAM_OUTPUT_VERTEX_STRIDE");
+
+// The same layout as CBParticle in so_particles.vert.hlsl and so_particles.gs.hlsl
+struct StreamOutputParticleConstants
+{
+    UINT frameIndex;
+    float deltaTime;
+    float lifetime;
+    float gravity;
+};
+
+static auto CreateRootSignatureForParticles(ID3D12Device* d3d_device) -> ID3D12RootSignature*
+{
+    ID3D12RootSignature* rootSignature = nullptr;
+
+    const D3D12_ROOT_PARAMETER rootParameters[]{
+        {
+            // b0 (particle constants), used by the vertex shader and the geometry shader
+            .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+            .Constants {
+                .ShaderRegister = 0U,
+                .RegisterSpace = 0U,
+                .Num32BitValues = UINT(sizeof(StreamOutputParticleConstants) / sizeof(UINT))
+            },
+            .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL
+        }
+    };
+
+    const D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {
+        .NumParameters = UINT(std::size(rootParameters)),
+        .pParameters = rootParameters,
+        .NumStaticSamplers = 0,
+        .pStaticSamplers = nullptr,
+        .Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT | D3D12_ROOT_SIGNATURE_FLAG_ALLOW_STREAM_OUTPUT |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_PIXEL_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS |
+                    D3D12_ROOT_SIGNATURE_FLAG_DENY_AMPLIFICATION_SHADER_ROOT_ACCESS | D3D12_ROOT_SIGNATURE_FLAG_DENY_MESH_SHADER_ROOT_ACCESS
+    };
+
+    ID3DBlob* signature = nullptr;
+    ID3DBlob* error = nullptr;
+    HRESULT hRes = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error);
+    do
+    {
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "D3D12SerializeRootSignature for particles failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateRootSignature for particles failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (signature != nullptr) {
+        signature->Release();
+    }
+    if (error != nullptr) {
+        error->Release();
+    }
+
+    if (FAILED(hRes)) return nullptr;
+
+    return rootSignature;
+}
+
+// so_particles.vert.hlsl integrates, so_particles.gs.hlsl spawns and kills, and the surviving points are streamed out without rasterization
+static auto CreatePipelineStateObjectForParticles(ID3D12Device* d3d_device, ID3D12RootSignature* rootSignature) -> ID3D12PipelineState*
+{
+    ID3D12PipelineState* pipelineState = nullptr;
+
+    D3D12_SHADER_BYTECODE vertexShaderObj = CreateCompiledShaderObjectFromPath("cso/so_particles.vert.cso");
+    D3D12_SHADER_BYTECODE geometryShaderObj = CreateCompiledShaderObjectFromPath("cso/so_particles.gs.cso");
+
+    do
+    {
+        if (vertexShaderObj.pShaderBytecode == nullptr || vertexShaderObj.BytecodeLength == 0) break;
+        if (geometryShaderObj.pShaderBytecode == nullptr || geometryShaderObj.BytecodeLength == 0) break;
+
+        const D3D12_INPUT_ELEMENT_DESC inputElementDescs[]{
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "VELOCITY", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "SEED", 0, DXGI_FORMAT_R32_UINT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+
+        const D3D12_SO_DECLARATION_ENTRY soDeclaration[]{
+            {.Stream = 0U, .SemanticName = "POSITION", .SemanticIndex = 0U, .StartComponent = 0, .ComponentCount = 4, .OutputSlot = 0 },
+            {.Stream = 0U, .SemanticName = "VELOCITY", .SemanticIndex = 0U, .StartComponent = 0, .ComponentCount = 3, .OutputSlot = 0 },
+            {.Stream = 0U, .SemanticName = "SEED", .SemanticIndex = 0U, .StartComponent = 0, .ComponentCount = 1, .OutputSlot = 0 }
+        };
+        const UINT soBufferStrides[]{ UINT(sizeof(StreamOutputParticle)) };
+
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc{
+            .pRootSignature = rootSignature,
+            .VS = vertexShaderObj,
+            .GS = geometryShaderObj,
+            .StreamOutput {
+                .pSODeclaration = soDeclaration,
+                .NumEntries = UINT(std::size(soDeclaration)),
+                .pBufferStrides = soBufferStrides,
+                .NumStrides = UINT(std::size(soBufferStrides)),
+                .RasterizedStream = D3D12_SO_NO_RASTERIZED_STREAM
+            },
+            .BlendState {
+                .AlphaToCoverageEnable = FALSE,
+                .IndependentBlendEnable = FALSE,
+                .RenderTarget { }
+            },
+            .SampleMask = UINT32_MAX,
+            .RasterizerState {
+                .FillMode = D3D12_FILL_MODE_SOLID,
+                .CullMode = D3D12_CULL_MODE_NONE,
+                .FrontCounterClockwise = FALSE,
+                .DepthBias = 0,
+                .DepthBiasClamp = 0.0f,
+                .SlopeScaledDepthBias = 0.0f,
+                .DepthClipEnable = TRUE,
+                .MultisampleEnable = FALSE,
+                .AntialiasedLineEnable = FALSE,
+                .ForcedSampleCount = 0,
+                .ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF
+            },
+            .DepthStencilState {
+                .DepthEnable = FALSE,
+                .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO,
+                .DepthFunc = D3D12_COMPARISON_FUNC_NEVER,
+                .StencilEnable = FALSE,
+                .StencilReadMask = 0,
+                .StencilWriteMask = 0,
+                .FrontFace { },
+                .BackFace { }
+            },
+            .InputLayout {
+                .pInputElementDescs = inputElementDescs,
+                .NumElements = (UINT)std::size(inputElementDescs)
+            },
+            .IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED,
+            .PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_POINT,
+            .NumRenderTargets = 0,
+            .RTVFormats { },
+            .DSVFormat = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {
+                .Count = 1,
+                .Quality = 0
+            },
+            .NodeMask = 0,
+            .CachedPSO { },
+            .Flags = D3D12_PIPELINE_STATE_FLAG_NONE
+        };
+
+        const HRESULT hRes = d3d_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateGraphicsPipelineState for particles failed: %ld\n", hRes);
+            break;
+        }
+    }
+    while (false);
+
+    if (vertexShaderObj.pShaderBytecode != nullptr) {
+        free((void*)vertexShaderObj.pShaderBytecode);
+    }
+    if (geometryShaderObj.pShaderBytecode != nullptr) {
+        free((void*)geometryShaderObj.pShaderBytecode);
+    }
+
+    return pipelineState;
+}
+
+// Live particles after simulating frame frameIndex. A particle spawned in frame s is kept in the frames s to s + lifetime frames - 1.
+static auto GetExpectedStreamOutputParticleCount(UINT frameIndex) -> UINT
+{
+    const UINT spawnFrameCount = (std::min)(frameIndex + 1U, STREAM_OUTPUT_PARTICLE_LIFETIME_FRAME_COUNT);
+    return STREAM_OUTPUT_PARTICLE_EMITTER_COUNT * (1U + spawnFrameCount);
+}
+
+// Simulates STREAM_OUTPUT_PARTICLE_FRAME_COUNT frames in one command list. Two stream output buffers swap roles every frame:
+// the particles streamed out by one frame are the vertex buffer of the next one, drawn with ExecuteIndirect() through the
+// draw arguments that so_draw_args.comp.hlsl derives from the filled size counter. The particle count per frame is validated
+// against the emitter count and the lifetime, and particles per second and bytes moved per frame are reported.
+static auto RunStreamOutputParticleSimulation(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue) -> bool
+{
+    constexpr UINT particleStride = UINT(sizeof(StreamOutputParticle));
+    constexpr UINT soBufferCapacity = STREAM_OUTPUT_PARTICLE_EMITTER_COUNT * (STREAM_OUTPUT_PARTICLE_LIFETIME_FRAME_COUNT + 2U) * particleStride;
+    constexpr UINT soBufferSize = STREAM_OUTPUT_COUNTER_SIZE + soBufferCapacity;
+    constexpr UINT emitterBufferSize = STREAM_OUTPUT_PARTICLE_EMITTER_COUNT * particleStride;
+    constexpr UINT drawArgumentsSize = STREAM_OUTPUT_PARTICLE_FRAME_COUNT * UINT(sizeof(D3D12_DRAW_ARGUMENTS));
+
+    // Read back layout: a timestamp before every frame and after the last one, then the draw arguments of every frame's output
+    constexpr UINT timestampCount = STREAM_OUTPUT_PARTICLE_FRAME_COUNT + 1U;
+    constexpr UINT readbackDrawArgumentsOffset = timestampCount * UINT(sizeof(UINT64));
+    constexpr UINT readbackBufferSize = readbackDrawArgumentsOffset + drawArgumentsSize;
+
+    ID3D12RootSignature* particleRootSignature = nullptr;
+    ID3D12RootSignature* computeRootSignature = nullptr;
+    ID3D12PipelineState* particlePipelineState = nullptr;
+    ID3D12PipelineState* drawArgsPipelineState = nullptr;
+    ID3D12CommandSignature* commandSignature = nullptr;
+    ID3D12CommandAllocator* commandAllocator = nullptr;
+    ID3D12GraphicsCommandList* commandList = nullptr;
+    ID3D12QueryHeap* queryHeap = nullptr;
+    ID3D12Resource* soBuffers[2]{ };
+    ID3D12Resource* emitterBuffer = nullptr;
+    ID3D12Resource* drawArgumentsBuffer = nullptr;
+    ID3D12Resource* zeroUploadBuffer = nullptr;
+    ID3D12Resource* readbackBuffer = nullptr;
+    bool success = false;
+
+    do
+    {
+        particleRootSignature = CreateRootSignatureForParticles(d3d_device);
+        if (particleRootSignature == nullptr) break;
+
+        computeRootSignature = CreateRootSignatureForDrawAuto(d3d_device);
+        if (computeRootSignature == nullptr) break;
+
+        particlePipelineState = CreatePipelineStateObjectForParticles(d3d_device, particleRootSignature);
+        if (particlePipelineState == nullptr) break;
+
+        drawArgsPipelineState = CreatePipelineStateObjectForDrawAuto(d3d_device, computeRootSignature);
+        if (drawArgsPipelineState == nullptr) break;
+
+        commandSignature = CreateCommandSignatureForDrawAuto(d3d_device);
+        if (commandSignature == nullptr) break;
+
+        HRESULT hRes = d3d_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommandAllocator for particles failed: %ld\n", hRes);
+            break;
+        }
+
+        hRes = d3d_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator, particlePipelineState, IID_PPV_ARGS(&commandList));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommandList for particles failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_QUERY_HEAP_DESC queryHeapDesc{
+            .Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP,
+            .Count = timestampCount,
+            .NodeMask = 0
+        };
+        hRes = d3d_device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&queryHeap));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateQueryHeap for particles failed: %ld\n", hRes);
+            break;
+        }
+
+        const D3D12_HEAP_PROPERTIES defaultHeapProperties{
+            .Type = D3D12_HEAP_TYPE_DEFAULT,
+            .CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+            .MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN,
+            .CreationNodeMask = 1,
+            .VisibleNodeMask = 1
+        };
+
+        D3D12_HEAP_PROPERTIES uploadHeapProperties = defaultHeapProperties;
+        uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+        D3D12_HEAP_PROPERTIES readbackHeapProperties = defaultHeapProperties;
+        readbackHeapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+
+        D3D12_RESOURCE_DESC bufferDesc{
+            .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
+            .Alignment = 0,
+            .Width = soBufferSize,
+            .Height = 1U,
+            .DepthOrArraySize = 1,
+            .MipLevels = 1,
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .SampleDesc {.Count = 1U, .Quality = 0 },
+            .Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+            .Flags = D3D12_RESOURCE_FLAG_NONE
+        };
+        for (ID3D12Resource*& soBuffer : soBuffers)
+        {
+            hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                    D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&soBuffer));
+            if (FAILED(hRes))
+            {
+                fprintf(stderr, "CreateCommittedResource for particle stream output buffer failed: %ld\n", hRes);
+                break;
+            }
+        }
+        if (FAILED(hRes)) break;
+
+        bufferDesc.Width = drawArgumentsSize;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        hRes = d3d_device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&drawArgumentsBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for particle draw arguments buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        // The emitters are only read by the first frame, so they stay in the upload heap
+        bufferDesc.Width = emitterBufferSize;
+        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&emitterBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for particle emitter buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        StreamOutputParticle* emitters = nullptr;
+        hRes = emitterBuffer->Map(0, nullptr, (void**)&emitters);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map particle emitter buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        // A square grid of emitters on the ground plane
+        constexpr UINT emitterGridSize = 128U;
+        for (UINT i = 0U; i < STREAM_OUTPUT_PARTICLE_EMITTER_COUNT; ++i)
+        {
+            emitters[i] = StreamOutputParticle{
+                .position { float(i % emitterGridSize) * (2.0f / emitterGridSize) - 1.0f, -1.0f,
+                            float(i / emitterGridSize % emitterGridSize) * (2.0f / emitterGridSize) - 1.0f, 0.0f },
+                .velocity { 0.0f, 0.0f, 0.0f },
+                .seed = i | STREAM_OUTPUT_PARTICLE_EMITTER_FLAG
+            };
+        }
+        emitterBuffer->Unmap(0, nullptr);
+
+        bufferDesc.Width = STREAM_OUTPUT_COUNTER_SIZE;
+        hRes = d3d_device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&zeroUploadBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for particle counter upload buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        void* hostMemPtr = nullptr;
+        hRes = zeroUploadBuffer->Map(0, nullptr, &hostMemPtr);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map particle counter upload buffer failed: %ld\n", hRes);
+            break;
+        }
+        memset(hostMemPtr, 0, STREAM_OUTPUT_COUNTER_SIZE);
+        zeroUploadBuffer->Unmap(0, nullptr);
+
+        bufferDesc.Width = readbackBufferSize;
+        hRes = d3d_device->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                                D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&readbackBuffer));
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "CreateCommittedResource for particle read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        // Both stream output buffers are promoted by their first counter reset, the draw arguments buffer by the first dispatch
+        D3D12_RESOURCE_STATES soBufferStates[2]{ D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COPY_DEST };
+        D3D12_RESOURCE_STATES drawArgumentsState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+        commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0U);
+
+        for (UINT frame = 0U; frame < STREAM_OUTPUT_PARTICLE_FRAME_COUNT; ++frame)
+        {
+            ID3D12Resource* const dstBuffer = soBuffers[frame % 2U];
+            ID3D12Resource* const srcBuffer = frame > 0U ? soBuffers[(frame - 1U) % 2U] : nullptr;
+            const UINT argumentOffset = (frame - 1U) * UINT(sizeof(D3D12_DRAW_ARGUMENTS));
+
+            if (frame > 0U)
+            {
+                TransitionStreamOutputResource(commandList, srcBuffer, soBufferStates[(frame - 1U) % 2U],
+                                                D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+                TransitionStreamOutputResource(commandList, drawArgumentsBuffer, drawArgumentsState, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+                RecordDrawAutoArguments(commandList, computeRootSignature, drawArgsPipelineState, srcBuffer, drawArgumentsBuffer, argumentOffset);
+                TransitionStreamOutputResource(commandList, drawArgumentsBuffer, drawArgumentsState, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+            }
+
+            commandList->CopyBufferRegion(dstBuffer, 0U, zeroUploadBuffer, 0U, STREAM_OUTPUT_COUNTER_SIZE);
+            TransitionStreamOutputResource(commandList, dstBuffer, soBufferStates[frame % 2U], D3D12_RESOURCE_STATE_STREAM_OUT);
+
+            const StreamOutputParticleConstants constants{
+                .frameIndex = frame,
+                .deltaTime = STREAM_OUTPUT_PARTICLE_DELTA_TIME,
+                // Half a frame of margin against the rounding of the accumulated age
+                .lifetime = (float(STREAM_OUTPUT_PARTICLE_LIFETIME_FRAME_COUNT) - 0.5f) * STREAM_OUTPUT_PARTICLE_DELTA_TIME,
+                .gravity = 1.5f
+            };
+
+            const D3D12_STREAM_OUTPUT_BUFFER_VIEW soBufferView{
+                .BufferLocation = dstBuffer->GetGPUVirtualAddress() + STREAM_OUTPUT_COUNTER_SIZE,
+                .SizeInBytes = soBufferCapacity,
+                .BufferFilledSizeLocation = dstBuffer->GetGPUVirtualAddress()
+            };
+            const D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
+                .BufferLocation = frame > 0U ? srcBuffer->GetGPUVirtualAddress() + STREAM_OUTPUT_COUNTER_SIZE : emitterBuffer->GetGPUVirtualAddress(),
+                .SizeInBytes = frame > 0U ? soBufferCapacity : emitterBufferSize,
+                .StrideInBytes = particleStride
+            };
+
+            commandList->SetPipelineState(particlePipelineState);
+            commandList->SetGraphicsRootSignature(particleRootSignature);
+            commandList->SetGraphicsRoot32BitConstants(0U, UINT(sizeof(constants) / sizeof(UINT)), &constants, 0U);
+            commandList->SOSetTargets(0U, 1U, &soBufferView);
+            commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_POINTLIST);
+            commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+
+            if (frame > 0U) {
+                commandList->ExecuteIndirect(commandSignature, 1U, drawArgumentsBuffer, argumentOffset, nullptr, 0U);
+            }
+            else {
+                commandList->DrawInstanced(STREAM_OUTPUT_PARTICLE_EMITTER_COUNT, 1U, 0, 0);
+            }
+
+            commandList->SOSetTargets(0U, 1U, nullptr);
+
+            // The next frame overwrites the particles that this frame has read
+            if (frame > 0U) {
+                TransitionStreamOutputResource(commandList, srcBuffer, soBufferStates[(frame - 1U) % 2U], D3D12_RESOURCE_STATE_COPY_DEST);
+            }
+
+            commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, frame + 1U);
+        }
+
+        // The particle count of the last frame is only needed for the report
+        constexpr UINT lastFrame = STREAM_OUTPUT_PARTICLE_FRAME_COUNT - 1U;
+        TransitionStreamOutputResource(commandList, soBuffers[lastFrame % 2U], soBufferStates[lastFrame % 2U], D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        TransitionStreamOutputResource(commandList, drawArgumentsBuffer, drawArgumentsState, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        RecordDrawAutoArguments(commandList, computeRootSignature, drawArgsPipelineState, soBuffers[lastFrame % 2U], drawArgumentsBuffer,
+                                lastFrame * UINT(sizeof(D3D12_DRAW_ARGUMENTS)));
+        TransitionStreamOutputResource(commandList, drawArgumentsBuffer, drawArgumentsState, D3D12_RESOURCE_STATE_COPY_SOURCE);
+
+        commandList->ResolveQueryData(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 0U, timestampCount, readbackBuffer, 0U);
+        commandList->CopyBufferRegion(readbackBuffer, readbackDrawArgumentsOffset, drawArgumentsBuffer, 0U, drawArgumentsSize);
+
+        hRes = commandList->Close();
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Close particle command list failed: %ld\n", hRes);
+            break;
+        }
+
+        ID3D12CommandList* const ppCommandLists[] = { (ID3D12CommandList*)commandList };
+        commandQueue->ExecuteCommandLists((UINT)std::size(ppCommandLists), ppCommandLists);
+        WaitForPreviousFrame(commandQueue);
+
+        UINT64 timestampFrequency = 0U;
+        hRes = commandQueue->GetTimestampFrequency(&timestampFrequency);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "GetTimestampFrequency failed: %ld\n", hRes);
+            break;
+        }
+
+        const uint8_t* readbackData = nullptr;
+        const D3D12_RANGE readRange{ 0, readbackBufferSize };
+        hRes = readbackBuffer->Map(0, &readRange, (void**)&readbackData);
+        if (FAILED(hRes))
+        {
+            fprintf(stderr, "Map particle read back buffer failed: %ld\n", hRes);
+            break;
+        }
+
+        UINT64 timestamps[timestampCount]{ };
+        D3D12_DRAW_ARGUMENTS drawArguments[STREAM_OUTPUT_PARTICLE_FRAME_COUNT]{ };
+        memcpy(timestamps, readbackData, sizeof(timestamps));
+        memcpy(drawArguments, readbackData + readbackDrawArgumentsOffset, sizeof(drawArguments));
+        readbackBuffer->Unmap(0, nullptr);
+
+        // Every frame reads the particles of the previous frame and writes the survivors and the spawned particles
+        UINT mismatchCount = 0U;
+        uint64_t simulatedParticleCount = 0U;
+        uint64_t movedByteCount = 0U;
+        for (UINT frame = 0U; frame < STREAM_OUTPUT_PARTICLE_FRAME_COUNT; ++frame)
+        {
+            const UINT inputCount = frame > 0U ? drawArguments[frame - 1U].VertexCountPerInstance : STREAM_OUTPUT_PARTICLE_EMITTER_COUNT;
+            const UINT outputCount = drawArguments[frame].VertexCountPerInstance;
+            if (outputCount != GetExpectedStreamOutputParticleCount(frame)) {
+                ++mismatchCount;
+            }
+
+            simulatedParticleCount += inputCount;
+            movedByteCount += uint64_t(inputCount + outputCount) * particleStride;
+        }
+
+        const UINT steadyCount = drawArguments[lastFrame].VertexCountPerInstance;
+        const double gpuSeconds = double(timestamps[timestampCount - 1U] - timestamps[0]) / double(timestampFrequency);
+        const double lastFrameMilliseconds = double(timestamps[timestampCount - 1U] - timestamps[timestampCount - 2U]) * 1000.0 / double(timestampFrequency);
+        const double steadyFrameMegabytes = double(uint64_t(drawArguments[lastFrame - 1U].VertexCountPerInstance + steadyCount) * particleStride) / (1024.0 * 1024.0);
+
+        printf("Stream output particles: %u frames, %u emitters, %u particles in the last frame (%.3f ms), %.1f M particles/s over %.3f ms GPU time\n",
+                STREAM_OUTPUT_PARTICLE_FRAME_COUNT, STREAM_OUTPUT_PARTICLE_EMITTER_COUNT, steadyCount, lastFrameMilliseconds,
+                double(simulatedParticleCount) / gpuSeconds / 1.0e6, gpuSeconds * 1000.0);
+        printf("    %.2f MB moved in the last frame, %.1f GB/s on average, %u frames with an unexpected particle count\n",
+                steadyFrameMegabytes, double(movedByteCount) / gpuSeconds / (1024.0 * 1024.0 * 1024.0), mismatchCount);
+
+        success = mismatchCount == 0U;
+    }
+    while (false);
+
+    if (readbackBuffer != nullptr) {
+        readbackBuffer->Release();
+    }
+    if (zeroUploadBuffer != nullptr) {
+        zeroUploadBuffer->Release();
+    }
+    if (drawArgumentsBuffer != nullptr) {
+        drawArgumentsBuffer->Release();
+    }
+    if (emitterBuffer != nullptr) {
+        emitterBuffer->Release();
+    }
+    for (ID3D12Resource* soBuffer : soBuffers)
+    {
+        if (soBuffer != nullptr) {
+            soBuffer->Release();
+        }
+    }
+    if (queryHeap != nullptr) {
+        queryHeap->Release();
+    }
+    if (commandList != nullptr) {
+        commandList->Release();
+    }
+    if (commandAllocator != nullptr) {
+        commandAllocator->Release();
+    }
+    if (commandSignature != nullptr) {
+        commandSignature->Release();
+    }
+    if (drawArgsPipelineState != nullptr) {
+        drawArgsPipelineState->Release();
+    }
+    if (particlePipelineState != nullptr) {
+        particlePipelineState->Release();
+    }
+    if (computeRootSignature != nullptr) {
+        computeRootSignature->Release();
+    }
+    if (particleRootSignature != nullptr) {
+        particleRootSignature->Release();
+    }
+
+    return success;
+}
+#endif
+
+#if RUN_TFB_REFERENCE_BENCHMARK
+// Transforms TFB_REFERENCE_BENCHMARK_VERTEX_COUNT copies of the square with every supported kernel of TransformFeedbackReference,
+// checks that the SIMD kernels are bit-identical to the scalar one and reports the vertex throughput.
+static auto RunTfbReferenceBenchmark() -> bool
+{
+    std::vector<TfbReferenceVertex> vertices(TFB_REFERENCE_BENCHMARK_VERTEX_COUNT);
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        vertices[i] = s_squareVertices[i % std::size(s_squareVertices)];
+        vertices[i].position[2] = float(i % 1024U) * (1.0f / 1024.0f);
+    }
+
+    const std::vector<TfbReferenceVertexBlock> src = PackTfbReferenceVertices(vertices.data(), vertices.size());
+    std::vector<TfbReferenceVertexBlock> scalarOutput(src.size());
+    std::vector<TfbReferenceVertexBlock> simdOutput(src.size());
+    TransformTfbReferenceVertices(TfbReferenceKernel::Scalar, 30.0f, src.data(), scalarOutput.data(), src.size());
+
+    bool success = true;
+    for (const TfbReferenceKernel kernel : { TfbReferenceKernel::Scalar, TfbReferenceKernel::SSE, TfbReferenceKernel::AVX })
+    {
+        if (!IsTfbReferenceKernelSupported(kernel))
+        {
+            printf("Transform feedback CPU reference %s kernel: not supported\n", GetTfbReferenceKernelName(kernel));
+            continue;
+        }
+
+        TransformTfbReferenceVertices(kernel, 30.0f, src.data(), simdOutput.data(), src.size());
+        const bool identical = memcmp(simdOutput.data(), scalarOutput.data(), src.size() * sizeof(TfbReferenceVertexBlock)) == 0;
+        success = success && identical;
+
+        const double verticesPerSecond = MeasureTfbReferenceThroughput(kernel, vertices.data(), vertices.size(), TFB_REFERENCE_BENCHMARK_ITERATION_COUNT);
+        printf("Transform feedback CPU reference %s kernel: %.1f M vertices/s, %.2f GB/s, %s\n", GetTfbReferenceKernelName(kernel),
+                verticesPerSecond / 1.0e6, verticesPerSecond * 2.0 * sizeof(TfbReferenceVertex) / (1024.0 * 1024.0 * 1024.0),
+                identical ? "bit-identical to scalar" : "DIFFERS from scalar");
+    }
+
+    return success;
+}
+#endif
+
+auto CreateTransformFeedbackTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue *commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
+                                    std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12DescriptorHeap*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*>
+{
+    ID3D12RootSignature* rootSignature = nullptr;
+    ID3D12PipelineState* pipelineState = nullptr;
+    ID3D12GraphicsCommandList* commandList = nullptr;
+    ID3D12GraphicsCommandList* commandBundleList = nullptr;
+    ID3D12DescriptorHeap* descriptorHeap = nullptr;
+    ID3D12Resource* uploadDevHostBuffer = nullptr;
+    ID3D12Resource* readbackDevHostBuffer = nullptr;
+    ID3D12Resource* vertexBuffer = nullptr;
+    ID3D12Resource* uavBuffer = nullptr;
+    ID3D12Resource* constantBuffer = nullptr;
+
+    auto result = std::make_tuple(rootSignature, pipelineState, commandList, commandBundleList, descriptorHeap, uploadDevHostBuffer, readbackDevHostBuffer, vertexBuffer, uavBuffer, constantBuffer);
+
+    rootSignature = CreateRootSignature(d3d_device);
+    if (rootSignature == nullptr) return result;
+
+    auto pipelineResult = CreatePipelineStateObject(d3d_device, commandAllocator, commandBundleAllocator, rootSignature);
+    pipelineState = std::get<0>(pipelineResult);
+    commandList = std::get<1>(pipelineResult);
+    commandBundleList = std::get<2>(pipelineResult);
+    descriptorHeap = std::get<3>(pipelineResult);
+    if (pipelineState == nullptr || commandList == nullptr || commandBundleList == nullptr || descriptorHeap == nullptr) return result;
+
+    auto vertexBufferResult = CreateVertexBuffer(d3d_device, rootSignature, commandQueue, commandList, commandBundleList, descriptorHeap);
+    uploadDevHostBuffer = std::get<0>(vertexBufferResult);
+    readbackDevHostBuffer = std::get<1>(vertexBufferResult);
+    vertexBuffer = std::get<2>(vertexBufferResult);
+    uavBuffer = std::get<3>(vertexBufferResult);
+    constantBuffer = std::get<4>(vertexBufferResult);
+    if (uploadDevHostBuffer == nullptr || readbackDevHostBuffer == nullptr || vertexBuffer == nullptr || uavBuffer == nullptr || constantBuffer == nullptr) return result;
+
+#if RUN_STREAM_OUTPUT_CAPTURE
+    RunStreamOutputCapture(d3d_device, commandQueue, rootSignature, descriptorHeap, vertexBuffer);
+#endif
+
+#if RUN_STREAM_OUTPUT_DRAW_AUTO
+    RunStreamOutputDrawAutoChain(d3d_device, commandQueue, rootSignature, descriptorHeap, vertexBuffer);
+#endif
+
+#if RUN_STREAM_OUTPUT_PARTICLES
+    RunStreamOutputParticleSimulation(d3d_device, commandQueue);
+#endif
+
+#if RUN_TFB_REFERENCE_BENCHMARK
+    RunTfbReferenceBenchmark();
+#endif
+
+    s_readbackBuffer = readbackDevHostBuffer;
+    s_constantBuffer = constantBuffer;
+    result = std::make_tuple(rootSignature, pipelineState, commandList, commandBundleList, descriptorHeap, uploadDevHostBuffer, readbackDevHostBuffer, vertexBuffer, uavBuffer, constantBuffer);
+    return result;
+}
+
+auto RenderPostProcessForTransformFeedback() -> void
+{
+    // The rotation angle that the frame has been drawn with
+    float rotAngle = 0.0f;
+    const D3D12_RANGE cbReadRange{ 0, sizeof(rotAngle) };
+    float* cbHostMemPtr = nullptr;
+    HRESULT hRes = s_constantBuffer->Map(0, &cbReadRange, (void**)&cbHostMemPtr);
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "Map constant buffer failed: %ld\n", hRes);
+        return;
+    }
+    rotAngle = *cbHostMemPtr;
+
+    const D3D12_RANGE writtenRange{ 0, 0 };
+    s_constantBuffer->Unmap(0, &writtenRange);
+
+    float* hostMemPtr = nullptr;
+    const D3D12_RANGE readRange{ 0, sizeof(s_squareVertices) };
+    hRes = s_readbackBuffer->Map(0, &readRange, (void**)&hostMemPtr);
+    if (FAILED(hRes))
+    {
+        fprintf(stderr, "Map read back buffer failed: %ld\n", hRes);
+        return;
+    }
+
+    printf("v[0].x = %f, v[0].y = %f, v[0].z = %f, v[0].w = %f\n", hostMemPtr[0], hostMemPtr[1], hostMemPtr[2], hostMemPtr[3]);
+
+    // uavOutput[vertexID] holds the same records as the stream output
+    const std::vector<TfbReferenceVertex> expectedVertices = GetTfbReferenceOutput(s_squareVertices, std::size(s_squareVertices), rotAngle);
+    const TfbReferenceCompareResult result = CompareTfbReferenceVertices(expectedVertices.data(), (const TfbReferenceVertex*)hostMemPtr, expectedVertices.size(),
+                                                                        TFB_REFERENCE_MAX_ULP, TFB_REFERENCE_MAX_ABS_DIFFERENCE);
+    if (result.mismatchCount > 0U)
+    {
+        printf("%u of %zu vertices differ from the CPU reference at %.1f degrees (first: v[%zu], max %u ULP, max abs difference %g)\n",
+                result.mismatchCount, expectedVertices.size(), rotAngle, result.firstMismatchIndex, result.maxUlpDifference, result.maxAbsDifference);
+    }
 
     s_readbackBuffer->Unmap(0, nullptr);
 }
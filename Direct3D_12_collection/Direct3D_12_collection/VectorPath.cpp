@@ -0,0 +1,225 @@
+#include "VectorPath.h"
+
+#include <cmath>
+#include <algorithm>
+
+// Number of line segments for a curve whose second differences of control points have the maximum length `dd`.
+// Wang's formula: a Bezier curve of degree n flattened to m uniform segments deviates at most n * (n - 1) * dd / (8 * m^2).
+static auto GetCurveSegmentCount(float dd, float degreeFactor, float tolerance) -> uint32_t
+{
+    const float count = std::ceil(std::sqrt(degreeFactor * dd / (8.0f * tolerance)));
+    return uint32_t(std::clamp(count, 1.0f, 256.0f));
+}
+
+static auto GetSecondDifferenceLength(const PathPoint& p0, const PathPoint& p1, const PathPoint& p2) -> float
+{
+    return std::hypot(p0.x - 2.0f * p1.x + p2.x, p0.y - 2.0f * p1.y + p2.y);
+}
+
+auto FlattenVectorPath(const VectorPath& path, float tolerance) -> std::vector<std::vector<PathPoint>>
+{
+    std::vector<std::vector<PathPoint>> contours;
+    std::vector<PathPoint> contour;
+
+    auto const closeContour = [&contours, &contour]() {
+        // A contour with less than 3 points does not cover any area
+        if (contour.size() >= 3U) {
+            contours.push_back(std::move(contour));
+        }
+        contour.clear();
+    };
+
+    size_t pointIndex = 0;
+    for (const PathVerb verb : path.verbs)
+    {
+        switch (verb)
+        {
+        case PATH_VERB_MOVE_TO:
+            closeContour();
+            contour.push_back(path.points[pointIndex++]);
+            break;
+
+        case PATH_VERB_LINE_TO:
+            contour.push_back(path.points[pointIndex++]);
+            break;
+
+        case PATH_VERB_QUAD_TO:
+        {
+            const PathPoint p0 = contour.empty() ? path.points[pointIndex] : contour.back();
+            const PathPoint p1 = path.points[pointIndex++];
+            const PathPoint p2 = path.points[pointIndex++];
+
+            const uint32_t segmentCount = GetCurveSegmentCount(GetSecondDifferenceLength(p0, p1, p2), 2.0f, tolerance);
+            for (uint32_t i = 1U; i <= segmentCount; ++i)
+            {
+                const float t = float(i) / float(segmentCount);
+                const float s = 1.0f - t;
+                contour.push_back({
+                    .x = s * s * p0.x + 2.0f * s * t * p1.x + t * t * p2.x,
+                    .y = s * s * p0.y + 2.0f * s * t * p1.y + t * t * p2.y
+                });
+            }
+            break;
+        }
+
+        case PATH_VERB_CUBIC_TO:
+        {
+            const PathPoint p0 = contour.empty() ? path.points[pointIndex] : contour.back();
+            const PathPoint p1 = path.points[pointIndex++];
+            const PathPoint p2 = path.points[pointIndex++];
+            const PathPoint p3 = path.points[pointIndex++];
+
+            const float dd = std::max(GetSecondDifferenceLength(p0, p1, p2), GetSecondDifferenceLength(p1, p2, p3));
+            const uint32_t segmentCount = GetCurveSegmentCount(dd, 6.0f, tolerance);
+            for (uint32_t i = 1U; i <= segmentCount; ++i)
+            {
+                const float t = float(i) / float(segmentCount);
+                const float s = 1.0f - t;
+                const float c0 = s * s * s;
+                const float c1 = 3.0f * s * s * t;
+                const float c2 = 3.0f * s * t * t;
+                const float c3 = t * t * t;
+                contour.push_back({
+                    .x = c0 * p0.x + c1 * p1.x + c2 * p2.x + c3 * p3.x,
+                    .y = c0 * p0.y + c1 * p1.y + c2 * p2.y + c3 * p3.y
+                });
+            }
+            break;
+        }
+
+        case PATH_VERB_CLOSE:
+        default:
+            closeContour();
+            break;
+        }
+    }
+
+    // Every contour is implicitly closed for filling
+    closeContour();
+
+    return contours;
+}
+
+auto BuildPathGeometry(const std::vector<VectorPath>& paths, uint32_t width, uint32_t height, float tolerance, uint32_t maxBatchPathCount) -> PathGeometry
+{
+    struct PixelRect
+    {
+        int left, top, right, bottom;   // [left, right) x [top, bottom)
+    };
+
+    struct FlattenedPath
+    {
+        std::vector<std::vector<PathPoint>> contours;
+        PixelRect rect;
+        const float* color;
+    };
+
+    PathGeometry geometry{ };
+
+    // Flatten the paths and compute their pixel-aligned bounding rectangles, so that every pixel with any covered sample
+    // has its center inside the cover rectangle of its path.
+    std::vector<FlattenedPath> flattenedPaths;
+    flattenedPaths.reserve(paths.size());
+    for (const VectorPath& path : paths)
+    {
+        FlattenedPath flattened{ .contours = FlattenVectorPath(path, tolerance), .rect { }, .color = path.color };
+        if (flattened.contours.empty()) continue;
+
+        float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+        for (const auto& contour : flattened.contours)
+        {
+            for (const PathPoint& point : contour)
+            {
+                minX = std::min(minX, point.x);
+                minY = std::min(minY, point.y);
+                maxX = std::max(maxX, point.x);
+                maxY = std::max(maxY, point.y);
+            }
+        }
+
+        flattened.rect = {
+            .left = std::max(int(std::floor(minX)), 0),
+            .top = std::max(int(std::floor(minY)), 0),
+            .right = std::min(int(std::ceil(maxX)), int(width)),
+            .bottom = std::min(int(std::ceil(maxY)), int(height))
+        };
+        if (flattened.rect.left >= flattened.rect.right || flattened.rect.top >= flattened.rect.bottom) continue;
+
+        flattenedPaths.push_back(std::move(flattened));
+    }
+
+    geometry.pathCount = uint32_t(flattenedPaths.size());
+
+    // Greedy batching in painter's order: a path starts a new batch when its rectangle overlaps a rectangle of the current batch.
+    std::vector<std::vector<const FlattenedPath*>> batches;
+    std::vector<PixelRect> batchRects;
+    for (const FlattenedPath& path : flattenedPaths)
+    {
+        bool overlapped = batches.empty() || batches.back().size() >= maxBatchPathCount;
+        for (size_t i = 0; i < batchRects.size() && !overlapped; ++i)
+        {
+            const PixelRect& rect = batchRects[i];
+            overlapped = path.rect.left < rect.right && rect.left < path.rect.right && path.rect.top < rect.bottom && rect.top < path.rect.bottom;
+        }
+
+        if (overlapped)
+        {
+            batches.emplace_back();
+            batchRects.clear();
+        }
+
+        batches.back().push_back(&path);
+        batchRects.push_back(path.rect);
+    }
+
+    for (const auto& batch : batches)
+    {
+        PathBatch pathBatch{
+            .firstFanVertex = uint32_t(geometry.vertices.size()),
+            .fanVertexCount = 0U,
+            .firstCoverVertex = 0U,
+            .coverVertexCount = 0U,
+            .pathCount = uint32_t(batch.size())
+        };
+
+        // Fan triangles of all contours; the color is not used by the coverage pass
+        for (const FlattenedPath* path : batch)
+        {
+            for (const auto& contour : path->contours)
+            {
+                const PathPoint& anchor = contour[0];
+                for (size_t i = 1; i + 1 < contour.size(); ++i)
+                {
+                    geometry.vertices.push_back({ .position { anchor.x, anchor.y }, .color { } });
+                    geometry.vertices.push_back({ .position { contour[i].x, contour[i].y }, .color { } });
+                    geometry.vertices.push_back({ .position { contour[i + 1].x, contour[i + 1].y }, .color { } });
+                }
+            }
+        }
+
+        pathBatch.fanVertexCount = uint32_t(geometry.vertices.size()) - pathBatch.firstFanVertex;
+        pathBatch.firstCoverVertex = uint32_t(geometry.vertices.size());
+
+        // Cover rectangles
+        for (const FlattenedPath* path : batch)
+        {
+            const float left = float(path->rect.left);
+            const float top = float(path->rect.top);
+            const float right = float(path->rect.right);
+            const float bottom = float(path->rect.bottom);
+            const float* color = path->color;
+
+            const PathPoint corners[] = { { left, top }, { right, top }, { left, bottom }, { left, bottom }, { right, top }, { right, bottom } };
+            for (const PathPoint& corner : corners) {
+                geometry.vertices.push_back({ .position { corner.x, corner.y }, .color { color[0], color[1], color[2], color[3] } });
+            }
+        }
+
+        pathBatch.coverVertexCount = uint32_t(geometry.vertices.size()) - pathBatch.firstCoverVertex;
+
+        geometry.fanTriangleCount += pathBatch.fanVertexCount / 3U;
+        geometry.batches.push_back(pathBatch);
+    }
+
+    return geometry;
+}
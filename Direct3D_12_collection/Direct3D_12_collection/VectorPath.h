@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 2D vector paths for the target independent rasterization (TIR) path rendering in TargetIndependentTest.cpp.
+// Curves are flattened to polylines on the CPU, and every closed contour is turned into a triangle fan
+// around its first point. Rasterizing the fans with the facing as the winding sign yields the winding number
+// of every sample, so paths with any number of edges and self-intersections can be filled without triangulation.
+// All coordinates are in pixels with the origin at the top-left corner of the render target.
+
+enum PathFillRule
+{
+    PATH_FILL_RULE_NON_ZERO,
+    PATH_FILL_RULE_EVEN_ODD
+};
+
+enum PathVerb : uint8_t
+{
+    PATH_VERB_MOVE_TO,      // 1 point
+    PATH_VERB_LINE_TO,      // 1 point
+    PATH_VERB_QUAD_TO,      // 2 points: control point, end point
+    PATH_VERB_CUBIC_TO,     // 3 points: control point 1, control point 2, end point
+    PATH_VERB_CLOSE         // 0 point
+};
+
+struct PathPoint
+{
+    float x;
+    float y;
+};
+
+struct VectorPath
+{
+    std::vector<PathVerb> verbs;
+    std::vector<PathPoint> points;
+    float color[4];         // straight (not premultiplied) RGBA
+};
+
+// The same layout as the vertex input of tir_path.vert.hlsl
+struct PathVertex
+{
+    float position[2];
+    float color[4];
+};
+
+// Paths of one batch have disjoint pixel-aligned bounding rectangles, so one coverage pass and one cover pass
+// render all of them. Batches must be rendered in order to keep the painter's order of overlapping paths.
+struct PathBatch
+{
+    uint32_t firstFanVertex;
+    uint32_t fanVertexCount;        // triangle list
+    uint32_t firstCoverVertex;
+    uint32_t coverVertexCount;      // triangle list, 2 triangles per path
+    uint32_t pathCount;
+};
+
+struct PathGeometry
+{
+    std::vector<PathVertex> vertices;
+    std::vector<PathBatch> batches;
+    uint32_t pathCount;             // paths inside the render target
+    uint32_t fanTriangleCount;
+};
+
+// @return the closed polylines of the path. The maximum distance between a curve and its polyline is `tolerance` in pixels.
+extern auto FlattenVectorPath(const VectorPath& path, float tolerance) -> std::vector<std::vector<PathPoint>>;
+
+// Flattens all paths and groups them into batches of at most maxBatchPathCount paths.
+// Paths completely outside of the width x height render target are dropped.
+extern auto BuildPathGeometry(const std::vector<VectorPath>& paths, uint32_t width, uint32_t height, float tolerance, uint32_t maxBatchPathCount) -> PathGeometry;
@@ -59,6 +59,12 @@ struct alignas(sizeof(void*)) DepthStencilSubobject
     D3D12_DEPTH_STENCIL_DESC depthStencilState;
 };
 
+struct alignas(sizeof(void*)) DepthStencil1Subobject
+{
+    D3D12_PIPELINE_STATE_SUBOBJECT_TYPE depthStencilSubType;
+    D3D12_DEPTH_STENCIL_DESC1 depthStencilState;
+};
+
 struct alignas(sizeof(void*)) IBStripCutValueSubobject
 {
     D3D12_PIPELINE_STATE_SUBOBJECT_TYPE ibStripCutValueSubType;
@@ -180,12 +186,56 @@ extern auto WriteToDeviceTextureAndSync(
     UINT depth,
     UINT rowPitch) -> void;
 
+// Copies subresources [firstSubresource, firstSubresource + subresourceCount) of a texture from pIntermediate in one batch.
+// footprints are the placed footprints returned by ID3D12Device::GetCopyableFootprints() for the same subresource range.
+extern auto WriteToDeviceTextureSubresourcesAndSync(
+    _In_ ID3D12GraphicsCommandList* pCmdList,
+    _In_ ID3D12Resource* pDestinationResource,
+    _In_ ID3D12Resource* pIntermediate,
+    UINT firstSubresource,
+    UINT subresourceCount,
+    _In_reads_(subresourceCount) const D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprints[]) -> void;
+
 extern auto SyncAndReadFromDeviceResource(
     _In_ ID3D12GraphicsCommandList* pCmdList,
     size_t dataSize,
     _In_ ID3D12Resource* pDestinationHostBuffer,
     _In_ ID3D12Resource* pSourceUAVBuffer) -> void;
 
+// The render target, depth buffer and timestamp queries of a benchmark that renders offscreen with its own command list
+struct OffscreenBenchmarkTarget
+{
+    ID3D12GraphicsCommandList* commandList;
+    ID3D12DescriptorHeap* rtvDescriptorHeap;
+    ID3D12DescriptorHeap* dsvDescriptorHeap;
+    ID3D12QueryHeap* queryHeap;
+    ID3D12Resource* renderTargetTexture;
+    ID3D12Resource* depthTexture;
+    ID3D12Resource* timestampReadbackBuffer;
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle;
+    D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle;
+    UINT width;
+    UINT height;
+    UINT timestampCount;
+};
+
+// Resets commandAllocator and creates a command list on it, a width x height RENDER_TARGET_BUFFER_FOMRAT render target in the RENDER_TARGET state,
+// a D32 depth buffer in the DEPTH_WRITE state and timestampCount timestamp queries with their read back buffer.
+// @param benchmarkName used in the error messages
+// @return false on failure. The target must be released with ReleaseOffscreenBenchmarkTarget() in either case.
+extern auto CreateOffscreenBenchmarkTarget(ID3D12Device* d3d_device, ID3D12CommandAllocator* commandAllocator, ID3D12PipelineState* initialPipelineState,
+                                            UINT width, UINT height, const FLOAT clearColor[4], UINT timestampCount, const char* benchmarkName,
+                                            OffscreenBenchmarkTarget& target) -> bool;
+
+// Sets one viewport and scissor rectangle covering the whole target and binds the render target and the depth buffer
+extern auto SetOffscreenBenchmarkTarget(const OffscreenBenchmarkTarget& target) -> void;
+
+// Resolves all the timestamps into timestampReadbackBuffer, then closes and executes the command list and waits for it
+// @param timestampFrequency receives the timestamp ticks per second
+extern auto ExecuteOffscreenBenchmark(ID3D12CommandQueue* commandQueue, const OffscreenBenchmarkTarget& target, const char* benchmarkName, UINT64& timestampFrequency) -> bool;
+
+extern auto ReleaseOffscreenBenchmarkTarget(OffscreenBenchmarkTarget& target) -> void;
+
 extern auto CreateTextureBasicTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
                                         std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12DescriptorHeap*, ID3D12DescriptorHeap*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, bool>;
 
@@ -195,10 +245,11 @@ extern auto CreateTransformFeedbackTestAssets(ID3D12Device* d3d_device, ID3D12Co
 
 extern auto ProjectionTestTranslateProcess(const TranslationType& transType) -> void;
 extern auto ProjectionTestFetchTranslationSet() -> CommonTranslationSet;
+extern auto ProjectionTestWriteConstantBuffer(void* hostMemPtr) -> void;
 extern auto CreateProjectionTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
                                         std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, bool>;
 
-extern auto CreateMeshShaderTestAssets(MeshShaderExecMode execMode, ID3D12Device* d3d_device, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
+extern auto CreateMeshShaderTestAssets(MeshShaderExecMode execMode, ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
                                         std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*>;
 
 extern auto CreateMeshShaderNoRasterTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
@@ -218,14 +269,16 @@ extern auto ExecuteIndirectCallbackHandler(ID3D12GraphicsCommandList* commandLis
 extern auto CreatePSWritePrimIDTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
                                         std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, bool>;
 
-extern auto CreateDepthBoundTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
+extern auto CreateDepthBoundTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator, bool supportDepthBounds) ->
                                         std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12DescriptorHeap*, ID3D12DescriptorHeap*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, bool>;
 
 extern auto CreateTargetIndependentTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
                                         std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12DescriptorHeap*, ID3D12DescriptorHeap*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, bool>;
 
-extern auto CreateGeometryShaderTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
-                                        std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12Resource*, ID3D12Resource*, bool>;
+extern auto CreateGeometryShaderTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator,
+                                        bool supportMeshShader) ->
+                                        std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12Resource*, ID3D12Resource*,
+                                                    ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, bool>;
 
 extern auto CreateGeneralRasterizationTestAssets(ID3D12Device* d3d_device, ID3D12CommandQueue* commandQueue, ID3D12CommandAllocator* commandAllocator, ID3D12CommandAllocator* commandBundleAllocator) ->
                                         std::tuple<ID3D12RootSignature*, ID3D12PipelineState*, ID3D12GraphicsCommandList*, ID3D12GraphicsCommandList*, ID3D12DescriptorHeap*, ID3D12DescriptorHeap*, ID3D12Resource*, ID3D12Resource*, ID3D12Resource*, bool>;
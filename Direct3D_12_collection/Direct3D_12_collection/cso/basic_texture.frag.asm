@@ -1,954 +0,0 @@
-//
-// Generated by Microsoft (R) HLSL Shader Compiler 10.1
-//
-//
-// Resource Bindings:
-//
-// Name                                 Type  Format         Dim      ID      HLSL Bind  Count
-// ------------------------------ ---------- ------- ----------- ------- -------------- ------
-// texSampler                        sampler      NA          NA      S0             s0      1 
-// texObj                            texture  float4          2d      T0             t0      1 
-//
-//
-//
-// Input signature:
-//
-// Name                 Index   Mask Register SysValue  Format   Used
-// -------------------- ----- ------ -------- -------- ------- ------
-// SV_POSITION              0   xyzw        0      POS   float       
-// TEXCOORD                 0   xy          1     NONE   float   xy  
-//
-//
-// Output signature:
-//
-// Name                 Index   Mask Register SysValue  Format   Used
-// -------------------- ----- ------ -------- -------- ------- ------
-// SV_TARGET                0   xyzw        0   TARGET   float   xyzw
-//
-ps_5_1
-dcl_globalFlags refactoringAllowed | skipOptimization
-dcl_sampler S0[0:0], mode_default, space=0
-dcl_resource_texture2d (float,float,float,float) T0[0:0], space=0
-dcl_input_ps linear v1.xy
-dcl_output o0.xyzw
-//
-// Initial variable locations:
-//   v0.x <- input.position.x; v0.y <- input.position.y; v0.z <- input.position.z; v0.w <- input.position.w; 
-//   v1.x <- input.texCoords.x; v1.y <- input.texCoords.y; 
-//   o0.x <- <PSMain return value>.x; o0.y <- <PSMain return value>.y; o0.z <- <PSMain return value>.z; o0.w <- <PSMain return value>.w
-//
-#line 12 "C:\my-programs\vc-projects\Direct3D_12_collection\Direct3D_12_collection\shaders\basic_texture.frag.hlsl"
-sample o0.xyzw, v1.xyxx, T0[0].xyzw, S0[0]
-ret 
-// Approximately 2 instruction slots used
-
-
-// 0000:  43425844  918f53f0  6a1861d0  4a56e86f  DXBC.S...a.jo.VJ
-// 0010:  0eaa7c91  00000001  000038c8  00000006  .|...___.8__.___
-// 0020:  00000038  00000108  00000160  00000194  8___..__`.__..__
-// 0030:  00000224  000002c0  46454452  000000c8  $.__..__RDEF.___
-// 0040:  00000000  00000000  00000002  0000003c  ________.___<___
-// 0050:  ffff0501  00000505  0000009e  25441313  ......__.___..D%
-// 0060:  0000003c  00000018  00000028  00000028  <___.___(___(___
-// 0070:  00000024  0000000c  00000000  0000008c  $___._______.___
-// 0080:  00000003  00000000  00000000  00000000  ._______________
-// 0090:  00000000  00000001  00000000  00000000  ____.___________
-// 00a0:  00000000  00000097  00000002  00000005  ____.___.___.___
-// 00b0:  00000004  ffffffff  00000000  00000001  .___....____.___
-// 00c0:  0000000c  00000000  00000000  53786574  .___________texS
-// 00d0:  6c706d61  74007265  624f7865  694d006a  ampler_texObj_Mi
-// 00e0:  736f7263  2074666f  20295228  4c534c48  crosoft (R) HLSL
-// 00f0:  61685320  20726564  706d6f43  72656c69   Shader Compiler
-// 0100:  2e303120  abab0031  4e475349  00000050   10.1_..ISGNP___
-// 0110:  00000002  00000008  00000038  00000000  .___.___8_______
-// 0120:  00000001  00000003  00000000  0000000f  .___._______.___
-// 0130:  00000044  00000000  00000000  00000003  D___________.___
-// 0140:  00000001  00000303  505f5653  5449534f  .___..__SV_POSIT
-// 0150:  004e4f49  43584554  44524f4f  ababab00  ION_TEXCOORD_...
-// 0160:  4e47534f  0000002c  00000001  00000008  OSGN,___.___.___
-// 0170:  00000020  00000000  00000000  00000003   ___________.___
-// 0180:  00000000  0000000f  545f5653  45475241  ____.___SV_TARGE
-// 0190:  abab0054  58454853  00000088  00000051  T_..SHEX.___Q___
-// 01a0:  00000022  0100886a  0600005a  00306e46  "___j._.Z__.Fn0_
-// 01b0:  00000000  00000000  00000000  00000000  ________________
-// 01c0:  07001858  00307e46  00000000  00000000  X._.F~0_________
-// 01d0:  00000000  00005555  00000000  03001062  ____UU______b._.
-// 01e0:  00101032  00000001  03000065  001020f2  2.._.___e__.. ._
-// 01f0:  00000000  0b000045  001020f2  00000000  ____E__.. ._____
-// 0200:  00101046  00000001  00207e46  00000000  F.._.___F~ _____
-// 0210:  00000000  00206000  00000000  00000000  _____` _________
-// 0220:  0100003e  54415453  00000094  00000002  >__.STAT.___.___
-// 0230:  00000000  00000000  00000002  00000000  ________._______
-// 0240:  00000000  00000000  00000001  00000000  ________._______
-// 0250:  00000000  00000000  00000000  00000000  ________________
-// 0260:  00000000  00000001  00000000  00000000  ____.___________
-// 0270:  00000000  00000000  00000000  00000000  ________________
-// 0280:  00000000  00000000  00000000  00000000  ________________
-// 0290:  00000000  00000000  00000000  00000000  ________________
-// 02a0:  00000000  00000000  00000000  00000000  ________________
-// 02b0:  00000000  00000000  00000000  00000000  ________________
-// 02c0:  42445053  00003600  7263694d  666f736f  SPDB_6__Microsof
-// 02d0:  2f432074  202b2b43  2046534d  30302e37  t C/C++ MSF 7.00
-// 02e0:  441a0a0d  00000053  00000200  00000002  ...DS____.__.___
-// 02f0:  0000001b  00000088  00000000  00000017  .___._______.___
-// 0300:  00000000  00000000  00000000  00000000  ________________
-// 0310:  00000000  00000000  00000000  00000000  ________________
-// 0320:  00000000  00000000  00000000  00000000  ________________
-// 0330:  00000000  00000000  00000000  00000000  ________________
-// 0340:  00000000  00000000  00000000  00000000  ________________
-// 0350:  00000000  00000000  00000000  00000000  ________________
-// 0360:  00000000  00000000  00000000  00000000  ________________
-// 0370:  00000000  00000000  00000000  00000000  ________________
-// 0380:  00000000  00000000  00000000  00000000  ________________
-// 0390:  00000000  00000000  00000000  00000000  ________________
-// 03a0:  00000000  00000000  00000000  00000000  ________________
-// 03b0:  00000000  00000000  00000000  00000000  ________________
-// 03c0:  00000000  00000000  00000000  00000000  ________________
-// 03d0:  00000000  00000000  00000000  00000000  ________________
-// 03e0:  00000000  00000000  00000000  00000000  ________________
-// 03f0:  00000000  00000000  00000000  00000000  ________________
-// 0400:  00000000  00000000  00000000  00000000  ________________
-// 0410:  00000000  00000000  00000000  00000000  ________________
-// 0420:  00000000  00000000  00000000  00000000  ________________
-// 0430:  00000000  00000000  00000000  00000000  ________________
-// 0440:  00000000  00000000  00000000  00000000  ________________
-// 0450:  00000000  00000000  00000000  00000000  ________________
-// 0460:  00000000  00000000  00000000  00000000  ________________
-// 0470:  00000000  00000000  00000000  00000000  ________________
-// 0480:  00000000  00000000  00000000  00000000  ________________
-// 0490:  00000000  00000000  00000000  00000000  ________________
-// 04a0:  00000000  00000000  00000000  00000000  ________________
-// 04b0:  00000000  00000000  00000000  00000000  ________________
-// 04c0:  00000000  00000000  ffffffc0  ffffffff  ________........
-// 04d0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 04e0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 04f0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0500:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0510:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0520:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0530:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0540:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0550:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0560:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0570:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0580:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0590:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 05a0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 05b0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 05c0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 05d0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 05e0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 05f0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0600:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0610:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0620:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0630:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0640:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0650:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0660:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0670:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0680:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0690:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 06a0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 06b0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 06c0:  ffffffff  ffffffff  ff000038  ffffffff  ........8__.....
-// 06d0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 06e0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 06f0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0700:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0710:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0720:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0730:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0740:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0750:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0760:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0770:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0780:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0790:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 07a0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 07b0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 07c0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 07d0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 07e0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 07f0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0800:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0810:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0820:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0830:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0840:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0850:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0860:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0870:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0880:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 0890:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 08a0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 08b0:  ffffffff  ffffffff  ffffffff  ffffffff  ................
-// 08c0:  ffffffff  ffffffff  00000005  00000020  .........___ ___
-// 08d0:  0000003c  00000000  ffffffff  00000000  <_______....____
-// 08e0:  00000006  00000005  00000000  00000000  .___.___________
-// 08f0:  00000000  00000000  00000000  00000000  ________________
-// 0900:  00000000  00000000  00000000  00000000  ________________
-// 0910:  00000000  00000000  00000000  00000000  ________________
-// 0920:  00000000  00000000  00000000  00000000  ________________
-// 0930:  00000000  00000000  00000000  00000000  ________________
-// 0940:  00000000  00000000  00000000  00000000  ________________
-// 0950:  00000000  00000000  00000000  00000000  ________________
-// 0960:  00000000  00000000  00000000  00000000  ________________
-// 0970:  00000000  00000000  00000000  00000000  ________________
-// 0980:  00000000  00000000  00000000  00000000  ________________
-// 0990:  00000000  00000000  00000000  00000000  ________________
-// 09a0:  00000000  00000000  00000000  00000000  ________________
-// 09b0:  00000000  00000000  00000000  00000000  ________________
-// 09c0:  00000000  00000000  00000000  00000000  ________________
-// 09d0:  00000000  00000000  00000000  00000000  ________________
-// 09e0:  00000000  00000000  00000000  00000000  ________________
-// 09f0:  00000000  00000000  00000000  00000000  ________________
-// 0a00:  00000000  00000000  00000000  00000000  ________________
-// 0a10:  00000000  00000000  00000000  00000000  ________________
-// 0a20:  00000000  00000000  00000000  00000000  ________________
-// 0a30:  00000000  00000000  00000000  00000000  ________________
-// 0a40:  00000000  00000000  00000000  00000000  ________________
-// 0a50:  00000000  00000000  00000000  00000000  ________________
-// 0a60:  00000000  00000000  00000000  00000000  ________________
-// 0a70:  00000000  00000000  00000000  00000000  ________________
-// 0a80:  00000000  00000000  00000000  00000000  ________________
-// 0a90:  00000000  00000000  00000000  00000000  ________________
-// 0aa0:  00000000  00000000  00000000  00000000  ________________
-// 0ab0:  00000000  00000000  00000000  00000000  ________________
-// 0ac0:  00000000  00000000  00000003  00000000  ________._______
-// 0ad0:  00000000  00000000  00000000  00000000  ________________
-// 0ae0:  00000000  00000000  00000000  00000000  ________________
-// 0af0:  00000000  00000000  00000000  00000000  ________________
-// 0b00:  00000000  00000000  00000000  00000000  ________________
-// 0b10:  00000000  00000000  00000000  00000000  ________________
-// 0b20:  00000000  00000000  00000000  00000000  ________________
-// 0b30:  00000000  00000000  00000000  00000000  ________________
-// 0b40:  00000000  00000000  00000000  00000000  ________________
-// 0b50:  00000000  00000000  00000000  00000000  ________________
-// 0b60:  00000000  00000000  00000000  00000000  ________________
-// 0b70:  00000000  00000000  00000000  00000000  ________________
-// 0b80:  00000000  00000000  00000000  00000000  ________________
-// 0b90:  00000000  00000000  00000000  00000000  ________________
-// 0ba0:  00000000  00000000  00000000  00000000  ________________
-// 0bb0:  00000000  00000000  00000000  00000000  ________________
-// 0bc0:  00000000  00000000  00000000  00000000  ________________
-// 0bd0:  00000000  00000000  00000000  00000000  ________________
-// 0be0:  00000000  00000000  00000000  00000000  ________________
-// 0bf0:  00000000  00000000  00000000  00000000  ________________
-// 0c00:  00000000  00000000  00000000  00000000  ________________
-// 0c10:  00000000  00000000  00000000  00000000  ________________
-// 0c20:  00000000  00000000  00000000  00000000  ________________
-// 0c30:  00000000  00000000  00000000  00000000  ________________
-// 0c40:  00000000  00000000  00000000  00000000  ________________
-// 0c50:  00000000  00000000  00000000  00000000  ________________
-// 0c60:  00000000  00000000  00000000  00000000  ________________
-// 0c70:  00000000  00000000  00000000  00000000  ________________
-// 0c80:  00000000  00000000  00000000  00000000  ________________
-// 0c90:  00000000  00000000  00000000  00000000  ________________
-// 0ca0:  00000000  00000000  00000000  00000000  ________________
-// 0cb0:  00000000  00000000  00000000  00000000  ________________
-// 0cc0:  00000000  00000000  01312e94  66afcbef  ________..1....f
-// 0cd0:  00000001  6fd67a30  42264ca5  1115eb9c  .___0z.o.L&B....
-// 0ce0:  d22b2438  00000000  00000000  00000001  8$+.________.___
-// 0cf0:  00000001  00000000  00000000  00000000  ._______________
-// 0d00:  013351dc  00000000  00000000  00000000  .Q3.____________
-// 0d10:  00000000  00000000  00000000  00000000  ________________
-// 0d20:  00000000  00000000  00000000  00000000  ________________
-// 0d30:  00000000  00000000  00000000  00000000  ________________
-// 0d40:  00000000  00000000  00000000  00000000  ________________
-// 0d50:  00000000  00000000  00000000  00000000  ________________
-// 0d60:  00000000  00000000  00000000  00000000  ________________
-// 0d70:  00000000  00000000  00000000  00000000  ________________
-// 0d80:  00000000  00000000  00000000  00000000  ________________
-// 0d90:  00000000  00000000  00000000  00000000  ________________
-// 0da0:  00000000  00000000  00000000  00000000  ________________
-// 0db0:  00000000  00000000  00000000  00000000  ________________
-// 0dc0:  00000000  00000000  00000000  00000000  ________________
-// 0dd0:  00000000  00000000  00000000  00000000  ________________
-// 0de0:  00000000  00000000  00000000  00000000  ________________
-// 0df0:  00000000  00000000  00000000  00000000  ________________
-// 0e00:  00000000  00000000  00000000  00000000  ________________
-// 0e10:  00000000  00000000  00000000  00000000  ________________
-// 0e20:  00000000  00000000  00000000  00000000  ________________
-// 0e30:  00000000  00000000  00000000  00000000  ________________
-// 0e40:  00000000  00000000  00000000  00000000  ________________
-// 0e50:  00000000  00000000  00000000  00000000  ________________
-// 0e60:  00000000  00000000  00000000  00000000  ________________
-// 0e70:  00000000  00000000  00000000  00000000  ________________
-// 0e80:  00000000  00000000  00000000  00000000  ________________
-// 0e90:  00000000  00000000  00000000  00000000  ________________
-// 0ea0:  00000000  00000000  00000000  00000000  ________________
-// 0eb0:  00000000  00000000  00000000  00000000  ________________
-// 0ec0:  00000000  00000000  00000700  00006b00  _________.___k__
-// 0ed0:  00006a00  00000000  0000d400  00000000  _j_______.______
-// 0ee0:  00000000  00000100  00000400  5c737400  _____.___.___ts\
-// 0ef0:  65726944  44337463  5f32315f  6c6c6f63  Direct3D_12_coll
-// 0f00:  69746365  445c6e6f  63657269  5f443374  ection\Direct3D_
-// 0f10:  635f3231  656c6c6f  6f697463  68735c6e  12_collection\sh
-// 0f20:  72656461  61625c73  5f636973  74786574  aders\basic_text
-// 0f30:  2e657275  67617266  736c682e  6300006c  ure.frag.hlsl__c
-// 0f40:  796d5c3a  6f72702d  6d617267  63765c73  :\my-programs\vc
-// 0f50:  6f72702d  7463656a  69645c73  74636572  -projects\direct
-// 0f60:  315f6433  6f635f32  63656c6c  6e6f6974  3d_12_collection
-// 0f70:  7269645c  33746365  32315f64  6c6f635f  \direct3d_12_col
-// 0f80:  7463656c  5c6e6f69  64616873  5c737265  lection\shaders\
-// 0f90:  69736162  65745f63  72757478  72662e65  basic_texture.fr
-// 0fa0:  682e6761  006c736c  00000004  0000006a  ag.hlsl_.___j___
-// 0fb0:  00000001  0000006b  00000000  00000003  .___k_______.___
-// 0fc0:  00000000  00000000  00000000  00000000  ________________
-// 0fd0:  00000000  00000000  00000000  00000000  ________________
-// 0fe0:  00000000  00000000  00000000  00000000  ________________
-// 0ff0:  00000000  00000000  00000000  00000000  ________________
-// 1000:  00000000  00000000  00000000  00000000  ________________
-// 1010:  00000000  00000000  00000000  00000000  ________________
-// 1020:  00000000  00000000  00000000  00000000  ________________
-// 1030:  00000000  00000000  00000000  00000000  ________________
-// 1040:  00000000  00000000  00000000  00000000  ________________
-// 1050:  00000000  00000000  00000000  00000000  ________________
-// 1060:  00000000  00000000  00000000  00000000  ________________
-// 1070:  00000000  00000000  00000000  00000000  ________________
-// 1080:  00000000  00000000  00000000  00000000  ________________
-// 1090:  00000000  00000000  00000000  00000000  ________________
-// 10a0:  00000000  00000000  00000000  00000000  ________________
-// 10b0:  00000000  00000000  00000000  00000000  ________________
-// 10c0:  00000000  00000000  00005ac6  00018375  ________.Z__u.._
-// 10d0:  0003c8b8  0000a0cd  0002f726  00012441  ..._..__&.._A$._
-// 10e0:  00035227  000300a6  00022ad9  0000e615  'R._._._.*._..__
-// 10f0:  00030edc  00011449  0003bd99  00001000  ..._I.._...__.__
-// 1100:  00000000  00000000  00000000  00000000  ________________
-// 1110:  00000000  00000000  00000000  00000000  ________________
-// 1120:  00000000  00000000  00000000  00000000  ________________
-// 1130:  00000000  00000000  00000000  00000000  ________________
-// 1140:  00000000  00000000  00000000  00000000  ________________
-// 1150:  00000000  00000000  00000000  00000000  ________________
-// 1160:  00000000  00000000  00000000  00000000  ________________
-// 1170:  00000000  00000000  00000000  00000000  ________________
-// 1180:  00000000  00000000  00000000  00000000  ________________
-// 1190:  00000000  00000000  00000000  00000000  ________________
-// 11a0:  00000000  00000000  00000000  00000000  ________________
-// 11b0:  00000000  00000000  00000000  00000000  ________________
-// 11c0:  00000000  00000000  00000000  00000000  ________________
-// 11d0:  00000000  00000000  00000000  00000000  ________________
-// 11e0:  00000000  00000000  00000000  00000000  ________________
-// 11f0:  00000000  00000000  00000000  00000000  ________________
-// 1200:  00000000  00000000  00000000  00000000  ________________
-// 1210:  00000000  00000000  00000000  00000000  ________________
-// 1220:  00000000  00000000  00000000  00000000  ________________
-// 1230:  00000000  00000000  00000000  00000000  ________________
-// 1240:  00000000  00000000  00000000  00000000  ________________
-// 1250:  00000000  00000000  00000000  00000000  ________________
-// 1260:  00000000  00000000  00000000  00000000  ________________
-// 1270:  00000000  00000000  00000000  00000000  ________________
-// 1280:  00000000  00000000  00000000  00000000  ________________
-// 1290:  00000000  00000000  00000000  00000000  ________________
-// 12a0:  00000000  00000000  00000000  00000000  ________________
-// 12b0:  00000000  00000000  00000000  00000000  ________________
-// 12c0:  00000000  00000000  75727473  50207463  ________struct P
-// 12d0:  706e4953  7b0a7475  2020200a  6f6c6620  SInput.{.    flo
-// 12e0:  20347461  69736f70  6e6f6974  53203a20  at4 position : S
-// 12f0:  4f505f56  49544953  0a3b4e4f  20202020  V_POSITION;.    
-// 1300:  616f6c66  74203274  6f437865  7364726f  float2 texCoords
-// 1310:  54203a20  4f435845  3b44524f  0a3b7d0a   : TEXCOORD;.};.
-// 1320:  7865540a  65727574  663c4432  74616f6c  .Texture2D<float
-// 1330:  74203e34  624f7865  203a206a  69676572  4> texObj : regi
-// 1340:  72657473  2c307428  61707320  29306563  ster(t0, space0)
-// 1350:  61530a3b  656c706d  61745372  74206574  ;.SamplerState t
-// 1360:  61537865  656c706d  203a2072  69676572  exSampler : regi
-// 1370:  72657473  2c307328  61707320  29306563  ster(s0, space0)
-// 1380:  660a0a3b  74616f6c  53502034  6e69614d  ;..float4 PSMain
-// 1390:  49535028  7475706e  706e6920  20297475  (PSInput input) 
-// 13a0:  5653203a  5241545f  0a544547  20200a7b  : SV_TARGET.{.  
-// 13b0:  65722020  6e727574  78657420  2e6a624f    return texObj.
-// 13c0:  706d6153  7428656c  61537865  656c706d  Sample(texSample
-// 13d0:  69202c72  7475706e  7865742e  726f6f43  r, input.texCoor
-// 13e0:  3b297364  0a0a7d0a  00000000  00000000  ds);.}..________
-// 13f0:  00000000  00000000  00000000  00000000  ________________
-// 1400:  00000000  00000000  00000000  00000000  ________________
-// 1410:  00000000  00000000  00000000  00000000  ________________
-// 1420:  00000000  00000000  00000000  00000000  ________________
-// 1430:  00000000  00000000  00000000  00000000  ________________
-// 1440:  00000000  00000000  00000000  00000000  ________________
-// 1450:  00000000  00000000  00000000  00000000  ________________
-// 1460:  00000000  00000000  00000000  00000000  ________________
-// 1470:  00000000  00000000  00000000  00000000  ________________
-// 1480:  00000000  00000000  00000000  00000000  ________________
-// 1490:  00000000  00000000  00000000  00000000  ________________
-// 14a0:  00000000  00000000  00000000  00000000  ________________
-// 14b0:  00000000  00000000  00000000  00000000  ________________
-// 14c0:  00000000  00000000  effeeffe  00000001  ________.....___
-// 14d0:  000001f5  5c3a4300  702d796d  72676f72  ..___C:\my-progr
-// 14e0:  5c736d61  702d6376  656a6f72  5c737463  ams\vc-projects\
-// 14f0:  65726944  44337463  5f32315f  6c6c6f63  Direct3D_12_coll
-// 1500:  69746365  445c6e6f  63657269  5f443374  ection\Direct3D_
-// 1510:  635f3231  656c6c6f  6f697463  68735c6e  12_collection\sh
-// 1520:  72656461  61625c73  5f636973  74786574  aders\basic_text
-// 1530:  2e657275  67617266  736c682e  6300006c  ure.frag.hlsl__c
-// 1540:  796d5c3a  6f72702d  6d617267  63765c73  :\my-programs\vc
-// 1550:  6f72702d  7463656a  69645c73  74636572  -projects\direct
-// 1560:  315f6433  6f635f32  63656c6c  6e6f6974  3d_12_collection
-// 1570:  7269645c  33746365  32315f64  6c6f635f  \direct3d_12_col
-// 1580:  7463656c  5c6e6f69  64616873  5c737265  lection\shaders\
-// 1590:  69736162  65745f63  72757478  72662e65  basic_texture.fr
-// 15a0:  682e6761  006c736c  75727473  50207463  ag.hlsl_struct P
-// 15b0:  706e4953  7b0a7475  2020200a  6f6c6620  SInput.{.    flo
-// 15c0:  20347461  69736f70  6e6f6974  53203a20  at4 position : S
-// 15d0:  4f505f56  49544953  0a3b4e4f  20202020  V_POSITION;.    
-// 15e0:  616f6c66  74203274  6f437865  7364726f  float2 texCoords
-// 15f0:  54203a20  4f435845  3b44524f  0a3b7d0a   : TEXCOORD;.};.
-// 1600:  7865540a  65727574  663c4432  74616f6c  .Texture2D<float
-// 1610:  74203e34  624f7865  203a206a  69676572  4> texObj : regi
-// 1620:  72657473  2c307428  61707320  29306563  ster(t0, space0)
-// 1630:  61530a3b  656c706d  61745372  74206574  ;.SamplerState t
-// 1640:  61537865  656c706d  203a2072  69676572  exSampler : regi
-// 1650:  72657473  2c307328  61707320  29306563  ster(s0, space0)
-// 1660:  660a0a3b  74616f6c  53502034  6e69614d  ;..float4 PSMain
-// 1670:  49535028  7475706e  706e6920  20297475  (PSInput input) 
-// 1680:  5653203a  5241545f  0a544547  20200a7b  : SV_TARGET.{.  
-// 1690:  65722020  6e727574  78657420  2e6a624f    return texObj.
-// 16a0:  706d6153  7428656c  61537865  656c706d  Sample(texSample
-// 16b0:  69202c72  7475706e  7865742e  726f6f43  r, input.texCoor
-// 16c0:  3b297364  0a0a7d0a  0130e21b  00000080  ds);.}....0..___
-// 16d0:  44b9396c  01dae69e  00000001  00000000  l9.D....._______
-// 16e0:  00000000  00000000  00000000  00000000  ________________
-// 16f0:  00000000  00000000  00000000  00000000  ________________
-// 1700:  00000000  00000000  00000001  00000002  ________.___.___
-// 1710:  00000001  00000002  00000000  0000006b  .___._______k___
-// 1720:  00000028  0130e21b  adbb94a5  00000120  (___..0..... .__
-// 1730:  00000001  0000006a  0000006b  00000000  .___j___k_______
-// 1740:  00000000  00000000  00000000  00000000  ________________
-// 1750:  00000000  00000000  00000000  00000000  ________________
-// 1760:  00000000  00000000  00000000  00000000  ________________
-// 1770:  00000000  00000000  00000000  00000000  ________________
-// 1780:  00000000  00000000  00000000  00000000  ________________
-// 1790:  00000000  00000000  00000000  00000000  ________________
-// 17a0:  00000000  00000000  00000000  00000000  ________________
-// 17b0:  00000000  00000000  00000000  00000000  ________________
-// 17c0:  00000000  00000000  00000000  00000000  ________________
-// 17d0:  00000000  00000000  00000000  00000000  ________________
-// 17e0:  00000000  00000000  00000000  00000000  ________________
-// 17f0:  00000000  00000000  00000000  00000000  ________________
-// 1800:  00000000  00000000  00000000  00000000  ________________
-// 1810:  00000000  00000000  00000000  00000000  ________________
-// 1820:  00000000  00000000  00000000  00000000  ________________
-// 1830:  00000000  00000000  00000000  00000000  ________________
-// 1840:  00000000  00000000  00000000  00000000  ________________
-// 1850:  00000000  00000000  00000000  00000000  ________________
-// 1860:  00000000  00000000  00000000  00000000  ________________
-// 1870:  00000000  00000000  00000000  00000000  ________________
-// 1880:  00000000  00000000  00000000  00000000  ________________
-// 1890:  00000000  00000000  00000000  00000000  ________________
-// 18a0:  00000000  00000000  00000000  00000000  ________________
-// 18b0:  00000000  00000000  00000000  00000000  ________________
-// 18c0:  00000000  00000000  00000004  113c0042  ________.___B_<.
-// 18d0:  00000110  000a0100  0ca10001  000a585d  ..___.._._..]X._
-// 18e0:  0ca10001  694d585d  736f7263  2074666f  ._..]XMicrosoft 
-// 18f0:  20295228  4c534c48  61685320  20726564  (R) HLSL Shader 
-// 1900:  706d6f43  72656c69  2e303120  00000031  Compiler 10.1___
-// 1910:  113d0036  736c6801  616c466c  30007367  6_=..hlslFlags_0
-// 1920:  68003578  546c736c  65677261  73700074  x5_hlslTarget_ps
-// 1930:  315f355f  736c6800  746e456c  50007972  _5_1_hlslEntry_P
-// 1940:  69614d53  0000006e  1110002e  00000000  SMain___._..____
-// 1950:  00000210  00000000  00000030  00000000  ..______0_______
-// 1960:  00000030  00001006  00000058  50a00001  0___..__X___._.P
-// 1970:  69614d53  0000006e  113e002e  00001003  SMain___._>...__
-// 1980:  6e690009  00747570  00000000  00000000  ._input_________
-// 1990:  00000000  00000000  00000000  00000000  ________________
-// 19a0:  00000000  00000000  11500016  00050001  ________._P.._._
-// 19b0:  00040000  00000058  00300001  00000000  __._X___._0_____
-// 19c0:  11500016  00050001  00040004  00000058  ._P.._._._._X___
-// 19d0:  00300001  00000004  11500016  00050001  ._0_.___._P.._._
-// 19e0:  00040008  00000058  00300001  00000008  ._._X___._0_.___
-// 19f0:  11500016  00050001  0004000c  00000058  ._P.._._._._X___
-// 1a00:  00300001  0000000c  11500016  00050001  ._0_.___._P.._._
-// 1a10:  00040010  00000058  00300001  00000010  ._._X___._0_.___
-// 1a20:  11500016  00050001  00040014  00000058  ._P.._._._._X___
-// 1a30:  00300001  00000014  113e003e  00001005  ._0_.___>_>...__
-// 1a40:  503c0088  69614d53  6572206e  6e727574  ._<PSMain return
-// 1a50:  6c617620  003e6575  00000000  00000000   value>_________
-// 1a60:  00000000  00000000  00000000  00000000  ________________
-// 1a70:  00000000  00000000  11500016  00050002  ________._P.._._
-// 1a80:  00040000  00000058  00300001  00000000  __._X___._0_____
-// 1a90:  11500016  00050002  00040004  00000058  ._P.._._._._X___
-// 1aa0:  00300001  00000004  11500016  00050002  ._0_.___._P.._._
-// 1ab0:  00040008  00000058  00300001  00000008  ._._X___._0_.___
-// 1ac0:  11500016  00050002  0004000c  00000058  ._P.._._._._X___
-// 1ad0:  00300001  0000000c  00060002  000000f4  ._0_.___._._.___
-// 1ae0:  00000018  00000001  aa420110  1d29a3c1  .___.___..B...).
-// 1af0:  b34ec034  f3fc9296  0000afc7  000000f2  4.N.......__.___
-// 1b00:  00000048  00000000  00010001  00000088  H_______._._.___
-// 1b10:  00000000  00000004  0000003c  00000058  ____.___<___X___
-// 1b20:  8000000c  00000058  0000000c  00000084  .__.X___.___.___
-// 1b30:  8000000c  00000084  0000000c  00360005  .__..___.___._6_
-// 1b40:  0035000c  00360005  00360005  000000f6  ._5_._6_._6_.___
-// 1b50:  00000004  00000000  0000000c  00000000  ._______._______
-// 1b60:  00000018  0000003c  00000000  00000000  .___<___________
-// 1b70:  00000000  00000000  00000000  00000000  ________________
-// 1b80:  00000000  00000000  00000000  00000000  ________________
-// 1b90:  00000000  00000000  00000000  00000000  ________________
-// 1ba0:  00000000  00000000  00000000  00000000  ________________
-// 1bb0:  00000000  00000000  00000000  00000000  ________________
-// 1bc0:  00000000  00000000  00000000  00000000  ________________
-// 1bd0:  00000000  00000000  00000000  00000000  ________________
-// 1be0:  00000000  00000000  00000000  00000000  ________________
-// 1bf0:  00000000  00000000  00000000  00000000  ________________
-// 1c00:  00000000  00000000  00000000  00000000  ________________
-// 1c10:  00000000  00000000  00000000  00000000  ________________
-// 1c20:  00000000  00000000  00000000  00000000  ________________
-// 1c30:  00000000  00000000  00000000  00000000  ________________
-// 1c40:  00000000  00000000  00000000  00000000  ________________
-// 1c50:  00000000  00000000  00000000  00000000  ________________
-// 1c60:  00000000  00000000  00000000  00000000  ________________
-// 1c70:  00000000  00000000  00000000  00000000  ________________
-// 1c80:  00000000  00000000  00000000  00000000  ________________
-// 1c90:  00000000  00000000  00000000  00000000  ________________
-// 1ca0:  00000000  00000000  00000000  00000000  ________________
-// 1cb0:  00000000  00000000  00000000  00000000  ________________
-// 1cc0:  00000000  00000000  0131ca0b  00000038  ________..1.8___
-// 1cd0:  00001000  0000100d  000000f4  ffff000a  _.__..__.___._..
-// 1ce0:  00000004  0003ffff  00000000  00000034  .___..._____4___
-// 1cf0:  00000034  00000008  0000003c  00000000  4___.___<_______
-// 1d00:  151b0016  00000040  00000004  6c660010  ._..@___.___._fl
-// 1d10:  3474616f  f1f2f300  151b0016  00000040  oat4_...._..@___
-// 1d20:  00000002  6c660008  3274616f  f1f2f300  .___._float2_...
-// 1d30:  1203002a  0003150d  00001000  6f700000  *_.....__.____po
-// 1d40:  69746973  f1006e6f  0003150d  00001001  sition_...._..__
-// 1d50:  65740010  6f6f4378  00736472  1505001e  ._texCoords_._..
-// 1d60:  00000002  00001002  00000000  00000000  .___..__________
-// 1d70:  53500018  75706e49  f1f20074  1201000a  ._PSInput_..._..
-// 1d80:  00000001  00001003  1518000a  00001000  .___..__._.._.__
-// 1d90:  00010001  1008000e  00001005  00010017  ._._._....__._._
-// 1da0:  00001004  1517000e  00001000  49100203  ..__._.._.__...I
-// 1db0:  f1f20000  1518000a  00001007  00010001  __..._....__._._
-// 1dc0:  1518000a  00001008  02000001  1517000e  ._....__.__.._..
-// 1dd0:  00000000  4910020a  f1f20000  1518000a  ____...I__..._..
-// 1de0:  0000100a  00010001  1518000a  0000100b  ..__._._._....__
-// 1df0:  02000001  00000000  00000000  00000000  .__.____________
-// 1e00:  00000000  00000000  00000000  00000000  ________________
-// 1e10:  00000000  00000000  00000000  00000000  ________________
-// 1e20:  00000000  00000000  00000000  00000000  ________________
-// 1e30:  00000000  00000000  00000000  00000000  ________________
-// 1e40:  00000000  00000000  00000000  00000000  ________________
-// 1e50:  00000000  00000000  00000000  00000000  ________________
-// 1e60:  00000000  00000000  00000000  00000000  ________________
-// 1e70:  00000000  00000000  00000000  00000000  ________________
-// 1e80:  00000000  00000000  00000000  00000000  ________________
-// 1e90:  00000000  00000000  00000000  00000000  ________________
-// 1ea0:  00000000  00000000  00000000  00000000  ________________
-// 1eb0:  00000000  00000000  00000000  00000000  ________________
-// 1ec0:  00000000  00000000  0131ca0b  00000038  ________..1.8___
-// 1ed0:  00001000  00001000  00000000  ffff000b  _.___.______._..
-// 1ee0:  00000004  0003ffff  00000000  00000000  .___..._________
-// 1ef0:  00000000  00000000  00000000  00000000  ________________
-// 1f00:  00000000  00000000  00000000  00000000  ________________
-// 1f10:  00000000  00000000  00000000  00000000  ________________
-// 1f20:  00000000  00000000  00000000  00000000  ________________
-// 1f30:  00000000  00000000  00000000  00000000  ________________
-// 1f40:  00000000  00000000  00000000  00000000  ________________
-// 1f50:  00000000  00000000  00000000  00000000  ________________
-// 1f60:  00000000  00000000  00000000  00000000  ________________
-// 1f70:  00000000  00000000  00000000  00000000  ________________
-// 1f80:  00000000  00000000  00000000  00000000  ________________
-// 1f90:  00000000  00000000  00000000  00000000  ________________
-// 1fa0:  00000000  00000000  00000000  00000000  ________________
-// 1fb0:  00000000  00000000  00000000  00000000  ________________
-// 1fc0:  00000000  00000000  00000000  00000000  ________________
-// 1fd0:  00000000  00000000  00000000  00000000  ________________
-// 1fe0:  00000000  00000000  00000000  00000000  ________________
-// 1ff0:  00000000  00000000  00000000  00000000  ________________
-// 2000:  00000000  00000000  00000000  00000000  ________________
-// 2010:  00000000  00000000  00000000  00000000  ________________
-// 2020:  00000000  00000000  00000000  00000000  ________________
-// 2030:  00000000  00000000  00000000  00000000  ________________
-// 2040:  00000000  00000000  00000000  00000000  ________________
-// 2050:  00000000  00000000  00000000  00000000  ________________
-// 2060:  00000000  00000000  00000000  00000000  ________________
-// 2070:  00000000  00000000  00000000  00000000  ________________
-// 2080:  00000000  00000000  00000000  00000000  ________________
-// 2090:  00000000  00000000  00000000  00000000  ________________
-// 20a0:  00000000  00000000  00000000  00000000  ________________
-// 20b0:  00000000  00000000  00000000  00000000  ________________
-// 20c0:  00000000  00000000  53443344  00524448  ________D3DSHDR_
-// 20d0:  00000088  00000000  00000000  00000000  ._______________
-// 20e0:  00000000  00000000  00000000  60000020  ____________ __`
-// 20f0:  00000000  00000000  00000000  00000000  ________________
-// 2100:  00000000  00000000  00000000  00000000  ________________
-// 2110:  00000000  00000000  00000000  00000000  ________________
-// 2120:  00000000  00000000  00000000  00000000  ________________
-// 2130:  00000000  00000000  00000000  00000000  ________________
-// 2140:  00000000  00000000  00000000  00000000  ________________
-// 2150:  00000000  00000000  00000000  00000000  ________________
-// 2160:  00000000  00000000  00000000  00000000  ________________
-// 2170:  00000000  00000000  00000000  00000000  ________________
-// 2180:  00000000  00000000  00000000  00000000  ________________
-// 2190:  00000000  00000000  00000000  00000000  ________________
-// 21a0:  00000000  00000000  00000000  00000000  ________________
-// 21b0:  00000000  00000000  00000000  00000000  ________________
-// 21c0:  00000000  00000000  00000000  00000000  ________________
-// 21d0:  00000000  00000000  00000000  00000000  ________________
-// 21e0:  00000000  00000000  00000000  00000000  ________________
-// 21f0:  00000000  00000000  00000000  00000000  ________________
-// 2200:  00000000  00000000  00000000  00000000  ________________
-// 2210:  00000000  00000000  00000000  00000000  ________________
-// 2220:  00000000  00000000  00000000  00000000  ________________
-// 2230:  00000000  00000000  00000000  00000000  ________________
-// 2240:  00000000  00000000  00000000  00000000  ________________
-// 2250:  00000000  00000000  00000000  00000000  ________________
-// 2260:  00000000  00000000  00000000  00000000  ________________
-// 2270:  00000000  00000000  00000000  00000000  ________________
-// 2280:  00000000  00000000  00000000  00000000  ________________
-// 2290:  00000000  00000000  00000000  00000000  ________________
-// 22a0:  00000000  00000000  00000000  00000000  ________________
-// 22b0:  00000000  00000000  00000000  00000000  ________________
-// 22c0:  00000000  00000000  ffffffff  f12f091a  ________....../.
-// 22d0:  00000018  00000210  0000003d  00000001  .___..__=___.___
-// 22e0:  00000001  00000001  00000019  00000001  .___.___.___.___
-// 22f0:  00000000  00000000  00010000  00000000  __________._____
-// 2300:  00000000  00000000  00000000  00000000  ________________
-// 2310:  00000000  00000000  00000000  00000000  ________________
-// 2320:  00000000  00000000  00000000  80000000  _______________.
-// 2330:  00000000  00000000  00000000  00000000  ________________
-// 2340:  00000000  00000000  00000000  00000000  ________________
-// 2350:  00000000  00000000  00000000  00000000  ________________
-// 2360:  00000000  00000000  00000000  00000000  ________________
-// 2370:  00000000  00000000  00000000  00000000  ________________
-// 2380:  00000000  00000000  00000000  00000000  ________________
-// 2390:  00000000  00000000  00000000  00000000  ________________
-// 23a0:  00000000  00000000  00000000  00000000  ________________
-// 23b0:  00000000  00000000  00000000  00000000  ________________
-// 23c0:  00000000  00000000  00000000  00000000  ________________
-// 23d0:  00000000  00000000  00000000  00000000  ________________
-// 23e0:  00000000  00000000  00000000  00000000  ________________
-// 23f0:  00000000  00000000  00000000  00000000  ________________
-// 2400:  00000000  00000000  00000000  00000000  ________________
-// 2410:  00000000  00000000  00000000  00000000  ________________
-// 2420:  00000000  00000000  00000000  00000000  ________________
-// 2430:  00000000  00000000  00000000  00000000  ________________
-// 2440:  00000000  00000000  00000000  00000000  ________________
-// 2450:  00000000  00000000  00000000  00000000  ________________
-// 2460:  00000000  00000000  00000000  00000000  ________________
-// 2470:  00000000  00000000  00000000  00000000  ________________
-// 2480:  00000000  00000000  00000000  00000000  ________________
-// 2490:  00000000  00000000  00000000  00000000  ________________
-// 24a0:  00000000  00000000  00000000  00000000  ________________
-// 24b0:  00000000  00000000  00000000  00000000  ________________
-// 24c0:  00000000  00000000  00000000  00000000  ________________
-// 24d0:  00000000  00000000  00000040  00000000  ________@_______
-// 24e0:  00000000  00000000  00000000  00000000  ________________
-// 24f0:  00000000  00000000  0000000c  00000018  ________.___.___
-// 2500:  00000000  00000000  00000000  00000000  ________________
-// 2510:  00000000  00000000  00000000  00000000  ________________
-// 2520:  00000000  00000000  00000000  00000000  ________________
-// 2530:  00000000  00000000  00000000  00000000  ________________
-// 2540:  00000000  00000000  00000000  00000000  ________________
-// 2550:  00000000  00000000  00000000  00000000  ________________
-// 2560:  00000000  00000000  00000000  00000000  ________________
-// 2570:  00000000  00000000  00000000  00000000  ________________
-// 2580:  00000000  00000000  00000000  00000000  ________________
-// 2590:  00000000  00000000  00000000  00000000  ________________
-// 25a0:  00000000  00000000  00000000  00000000  ________________
-// 25b0:  00000000  00000000  00000000  00000000  ________________
-// 25c0:  00000000  00000000  00000000  00000000  ________________
-// 25d0:  00000000  00000000  00000000  00000000  ________________
-// 25e0:  00000000  00000000  00000000  00000000  ________________
-// 25f0:  00000000  00000000  00000000  00000000  ________________
-// 2600:  00000000  00000000  00000000  00000000  ________________
-// 2610:  00000000  00000000  00000000  00000000  ________________
-// 2620:  00000000  00000000  00000000  00000000  ________________
-// 2630:  00000000  00000000  00000000  00000000  ________________
-// 2640:  00000000  00000000  00000000  00000000  ________________
-// 2650:  00000000  00000000  00000000  00000000  ________________
-// 2660:  00000000  00000000  00000000  00000000  ________________
-// 2670:  00000000  00000000  00000000  00000000  ________________
-// 2680:  00000000  00000000  00000000  00000000  ________________
-// 2690:  00000000  00000000  00000000  00000000  ________________
-// 26a0:  00000000  00000000  00000000  00000000  ________________
-// 26b0:  00000000  00000000  00000000  00000000  ________________
-// 26c0:  00000000  00000000  11250016  00000000  ________._%.____
-// 26d0:  00000080  53500001  6e69614d  00000000  .___._PSMain____
-// 26e0:  11640022  00001009  00000000  00000000  "_d...__________
-// 26f0:  00000000  00000000  65740007  6a624f78  ________._texObj
-// 2700:  00000000  11640026  0000100c  00000000  ____&_d...______
-// 2710:  00000000  00000000  00000000  65740006  ____________._te
-// 2720:  6d615378  72656c70  00000000  00000000  xSampler________
-// 2730:  00000000  00000000  00000000  00000000  ________________
-// 2740:  00000000  00000000  00000000  00000000  ________________
-// 2750:  00000000  00000000  00000000  00000000  ________________
-// 2760:  00000000  00000000  00000000  00000000  ________________
-// 2770:  00000000  00000000  00000000  00000000  ________________
-// 2780:  00000000  00000000  00000000  00000000  ________________
-// 2790:  00000000  00000000  00000000  00000000  ________________
-// 27a0:  00000000  00000000  00000000  00000000  ________________
-// 27b0:  00000000  00000000  00000000  00000000  ________________
-// 27c0:  00000000  00000000  00000000  00000000  ________________
-// 27d0:  00000000  00000000  00000000  00000000  ________________
-// 27e0:  00000000  00000000  00000000  00000000  ________________
-// 27f0:  00000000  00000000  00000000  00000000  ________________
-// 2800:  00000000  00000000  00000000  00000000  ________________
-// 2810:  00000000  00000000  00000000  00000000  ________________
-// 2820:  00000000  00000000  00000000  00000000  ________________
-// 2830:  00000000  00000000  00000000  00000000  ________________
-// 2840:  00000000  00000000  00000000  00000000  ________________
-// 2850:  00000000  00000000  00000000  00000000  ________________
-// 2860:  00000000  00000000  00000000  00000000  ________________
-// 2870:  00000000  00000000  00000000  00000000  ________________
-// 2880:  00000000  00000000  00000000  00000000  ________________
-// 2890:  00000000  00000000  00000000  00000000  ________________
-// 28a0:  00000000  00000000  00000000  00000000  ________________
-// 28b0:  00000000  00000000  00000000  00000000  ________________
-// 28c0:  00000000  00000000  00000010  00000000  ________._______
-// 28d0:  00000000  00000000  00000000  00000000  ________________
-// 28e0:  00000000  ffffffff  f12f091a  00000000  ____....../.____
-// 28f0:  00000000  00000000  00000000  00000000  ________________
-// 2900:  00000000  00000000  00000000  00000000  ________________
-// 2910:  00000000  00000000  00000000  00000000  ________________
-// 2920:  00000000  00000000  00000000  00000000  ________________
-// 2930:  00000000  00000000  00000000  00000000  ________________
-// 2940:  00000000  00000000  00000000  00000000  ________________
-// 2950:  00000000  00000000  00000000  00000000  ________________
-// 2960:  00000000  00000000  00000000  00000000  ________________
-// 2970:  00000000  00000000  00000000  00000000  ________________
-// 2980:  00000000  00000000  00000000  00000000  ________________
-// 2990:  00000000  00000000  00000000  00000000  ________________
-// 29a0:  00000000  00000000  00000000  00000000  ________________
-// 29b0:  00000000  00000000  00000000  00000000  ________________
-// 29c0:  00000000  00000000  00000000  00000000  ________________
-// 29d0:  00000000  00000000  00000000  00000000  ________________
-// 29e0:  00000000  00000000  00000000  00000000  ________________
-// 29f0:  00000000  00000000  00000000  00000000  ________________
-// 2a00:  00000000  00000000  00000000  00000000  ________________
-// 2a10:  00000000  00000000  00000000  00000000  ________________
-// 2a20:  00000000  00000000  00000000  00000000  ________________
-// 2a30:  00000000  00000000  00000000  00000000  ________________
-// 2a40:  00000000  00000000  00000000  00000000  ________________
-// 2a50:  00000000  00000000  00000000  00000000  ________________
-// 2a60:  00000000  00000000  00000000  00000000  ________________
-// 2a70:  00000000  00000000  00000000  00000000  ________________
-// 2a80:  00000000  00000000  00000000  00000000  ________________
-// 2a90:  00000000  00000000  00000000  00000000  ________________
-// 2aa0:  00000000  00000000  00000000  00000000  ________________
-// 2ab0:  00000000  00000000  00000000  00000000  ________________
-// 2ac0:  00000000  00000000  ffffffff  01310977  ________....w.1.
-// 2ad0:  00000001  8e14000d  6b14000e  0001000f  .___._..._.k._._
-// 2ae0:  0000004c  00000020  0000002c  00000078  L___ ___,___x___
-// 2af0:  00000000  00000000  00000016  00000019  ________.___.___
-// 2b00:  00000000  00000000  00000000  00000001  ____________.___
-// 2b10:  00000000  00000088  60000020  00000000  ____.___ __`____
-// 2b20:  00000000  00000000  00090002  00000214  ________._._..__
-// 2b30:  00000000  0000007c  00000001  00000000  ____|___._______
-// 2b40:  00000000  00000000  614d5350  6e006e69  ________PSMain_n
-// 2b50:  00656e6f  f12eba2d  00000001  00000000  one_-...._______
-// 2b60:  00000088  60000020  00000000  00000000  .___ __`________
-// 2b70:  00000000  00020002  00000007  00010000  ____._._._____._
-// 2b80:  ffffffff  00000000  00000088  00000208  ....____.___..__
-// 2b90:  00000000  ffffffff  00000000  ffffffff  ____....____....
-// 2ba0:  00010001  00010000  00000000  6d5c3a43  ._.___._____C:\m
-// 2bb0:  72702d79  6172676f  765c736d  72702d63  y-programs\vc-pr
-// 2bc0:  63656a6f  445c7374  63657269  5f443374  ojects\Direct3D_
-// 2bd0:  635f3231  656c6c6f  6f697463  69445c6e  12_collection\Di
-// 2be0:  74636572  315f4433  6f635f32  63656c6c  rect3D_12_collec
-// 2bf0:  6e6f6974  6168735c  73726564  7361625c  tion\shaders\bas
-// 2c00:  745f6369  75747865  662e6572  2e676172  ic_texture.frag.
-// 2c10:  6c736c68  00000000  effeeffe  00000001  hlsl____.....___
-// 2c20:  00000001  00000100  00000000  00000000  .____.__________
-// 2c30:  ffffff00  ffffffff  0cffffff  ffffff00  _..........._...
-// 2c40:  ffffffff  00ffffff  00000000  00000000  ......._________
-// 2c50:  00000000  00000000  00000000  00000000  ________________
-// 2c60:  00000000  00000000  00000000  00000000  ________________
-// 2c70:  00000000  00000000  00000000  00000000  ________________
-// 2c80:  00000000  00000000  00000000  00000000  ________________
-// 2c90:  00000000  00000000  00000000  00000000  ________________
-// 2ca0:  00000000  00000000  00000000  00000000  ________________
-// 2cb0:  00000000  00000000  00000000  00000000  ________________
-// 2cc0:  00000000  00000000  01312e94  66afcbef  ________..1....f
-// 2cd0:  00000001  6fd67a30  42264ca5  1115eb9c  .___0z.o.L&B....
-// 2ce0:  d22b2438  00000096  6e694c2f  666e496b  8$+..___/LinkInf
-// 2cf0:  6e2f006f  73656d61  72732f00  65682f63  o_/names_/src/he
-// 2d00:  72656461  636f6c62  732f006b  662f6372  aderblock_/src/f
-// 2d10:  73656c69  5c3a632f  702d796d  72676f72  iles/c:\my-progr
-// 2d20:  5c736d61  702d6376  656a6f72  5c737463  ams\vc-projects\
-// 2d30:  65726964  64337463  5f32315f  6c6c6f63  direct3d_12_coll
-// 2d40:  69746365  645c6e6f  63657269  5f643374  ection\direct3d_
-// 2d50:  635f3231  656c6c6f  6f697463  68735c6e  12_collection\sh
-// 2d60:  72656461  61625c73  5f636973  74786574  aders\basic_text
-// 2d70:  2e657275  67617266  736c682e  0004006c  ure.frag.hlsl_._
-// 2d80:  00060000  00010000  001e0000  00000000  __.___.___._____
-// 2d90:  00110000  00070000  00220000  00080000  __.___.___"___._
-// 2da0:  000a0000  00060000  00000000  00050000  __.___._______._
-// 2db0:  00000000  51dc0000  00000133  00000000  ______.Q3.______
-// 2dc0:  00000000  00000000  00000000  00000000  ________________
-// 2dd0:  00000000  00000000  00000000  00000000  ________________
-// 2de0:  00000000  00000000  00000000  00000000  ________________
-// 2df0:  00000000  00000000  00000000  00000000  ________________
-// 2e00:  00000000  00000000  00000000  00000000  ________________
-// 2e10:  00000000  00000000  00000000  00000000  ________________
-// 2e20:  00000000  00000000  00000000  00000000  ________________
-// 2e30:  00000000  00000000  00000000  00000000  ________________
-// 2e40:  00000000  00000000  00000000  00000000  ________________
-// 2e50:  00000000  00000000  00000000  00000000  ________________
-// 2e60:  00000000  00000000  00000000  00000000  ________________
-// 2e70:  00000000  00000000  00000000  00000000  ________________
-// 2e80:  00000000  00000000  00000000  00000000  ________________
-// 2e90:  00000000  00000000  00000000  00000000  ________________
-// 2ea0:  00000000  00000000  00000000  00000000  ________________
-// 2eb0:  00000000  00000000  00000000  00000000  ________________
-// 2ec0:  00000000  00000000  00000010  00000020  ________.___ ___
-// 2ed0:  000000f2  0000012c  0000017f  00000038  .___,.__.__8___
-// 2ee0:  00000000  00000225  00000080  00000120  ____%.__.___ .__
-// 2ef0:  000002a0  0000003c  00000000  00000028  ..__<_______(___
-// 2f00:  00000238  0000002c  00000064  00000003  8.__,___d___.___
-// 2f10:  00000015  0000000d  00000014  0000000e  .___.___.___.___
-// 2f20:  00000009  00000006  0000000a  00000008  .___.___.___.___
-// 2f30:  0000000b  0000000c  00000007  0000000f  .___.___.___.___
-// 2f40:  00000010  00000011  00000013  00000012  .___.___.___.___
-// 2f50:  00000000  00000000  00000000  00000000  ________________
-// 2f60:  00000000  00000000  00000000  00000000  ________________
-// 2f70:  00000000  00000000  00000000  00000000  ________________
-// 2f80:  00000000  00000000  00000000  00000000  ________________
-// 2f90:  00000000  00000000  00000000  00000000  ________________
-// 2fa0:  00000000  00000000  00000000  00000000  ________________
-// 2fb0:  00000000  00000000  00000000  00000000  ________________
-// 2fc0:  00000000  00000000  00000000  00000000  ________________
-// 2fd0:  00000000  00000000  00000000  00000000  ________________
-// 2fe0:  00000000  00000000  00000000  00000000  ________________
-// 2ff0:  00000000  00000000  00000000  00000000  ________________
-// 3000:  00000000  00000000  00000000  00000000  ________________
-// 3010:  00000000  00000000  00000000  00000000  ________________
-// 3020:  00000000  00000000  00000000  00000000  ________________
-// 3030:  00000000  00000000  00000000  00000000  ________________
-// 3040:  00000000  00000000  00000000  00000000  ________________
-// 3050:  00000000  00000000  00000000  00000000  ________________
-// 3060:  00000000  00000000  00000000  00000000  ________________
-// 3070:  00000000  00000000  00000000  00000000  ________________
-// 3080:  00000000  00000000  00000000  00000000  ________________
-// 3090:  00000000  00000000  00000000  00000000  ________________
-// 30a0:  00000000  00000000  00000000  00000000  ________________
-// 30b0:  00000000  00000000  00000000  00000000  ________________
-// 30c0:  00000000  00000000  00000016  00000000  ________._______
-// 30d0:  00000000  00000000  00000000  00000000  ________________
-// 30e0:  00000000  00000000  00000000  00000000  ________________
-// 30f0:  00000000  00000000  00000000  00000000  ________________
-// 3100:  00000000  00000000  00000000  00000000  ________________
-// 3110:  00000000  00000000  00000000  00000000  ________________
-// 3120:  00000000  00000000  00000000  00000000  ________________
-// 3130:  00000000  00000000  00000000  00000000  ________________
-// 3140:  00000000  00000000  00000000  00000000  ________________
-// 3150:  00000000  00000000  00000000  00000000  ________________
-// 3160:  00000000  00000000  00000000  00000000  ________________
-// 3170:  00000000  00000000  00000000  00000000  ________________
-// 3180:  00000000  00000000  00000000  00000000  ________________
-// 3190:  00000000  00000000  00000000  00000000  ________________
-// 31a0:  00000000  00000000  00000000  00000000  ________________
-// 31b0:  00000000  00000000  00000000  00000000  ________________
-// 31c0:  00000000  00000000  00000000  00000000  ________________
-// 31d0:  00000000  00000000  00000000  00000000  ________________
-// 31e0:  00000000  00000000  00000000  00000000  ________________
-// 31f0:  00000000  00000000  00000000  00000000  ________________
-// 3200:  00000000  00000000  00000000  00000000  ________________
-// 3210:  00000000  00000000  00000000  00000000  ________________
-// 3220:  00000000  00000000  00000000  00000000  ________________
-// 3230:  00000000  00000000  00000000  00000000  ________________
-// 3240:  00000000  00000000  00000000  00000000  ________________
-// 3250:  00000000  00000000  00000000  00000000  ________________
-// 3260:  00000000  00000000  00000000  00000000  ________________
-// 3270:  00000000  00000000  00000000  00000000  ________________
-// 3280:  00000000  00000000  00000000  00000000  ________________
-// 3290:  00000000  00000000  00000000  00000000  ________________
-// 32a0:  00000000  00000000  00000000  00000000  ________________
-// 32b0:  00000000  00000000  00000000  00000000  ________________
-// 32c0:  00000000  00000000  00000000  00000000  ________________
-// 32d0:  00000000  00000000  00000000  00000000  ________________
-// 32e0:  00000000  00000000  00000000  00000000  ________________
-// 32f0:  00000000  00000000  00000000  00000000  ________________
-// 3300:  00000000  00000000  00000000  00000000  ________________
-// 3310:  00000000  00000000  00000000  00000000  ________________
-// 3320:  00000000  00000000  00000000  00000000  ________________
-// 3330:  00000000  00000000  00000000  00000000  ________________
-// 3340:  00000000  00000000  00000000  00000000  ________________
-// 3350:  00000000  00000000  00000000  00000000  ________________
-// 3360:  00000000  00000000  00000000  00000000  ________________
-// 3370:  00000000  00000000  00000000  00000000  ________________
-// 3380:  00000000  00000000  00000000  00000000  ________________
-// 3390:  00000000  00000000  00000000  00000000  ________________
-// 33a0:  00000000  00000000  00000000  00000000  ________________
-// 33b0:  00000000  00000000  00000000  00000000  ________________
-// 33c0:  00000000  00000000  00000000  00000000  ________________
-// 33d0:  00000000  00000000  00000000  00000000  ________________
-// 33e0:  00000000  00000000  00000000  00000000  ________________
-// 33f0:  00000000  00000000  00000000  00000000  ________________
-// 3400:  00000000  00000000  00000000  00000000  ________________
-// 3410:  00000000  00000000  00000000  00000000  ________________
-// 3420:  00000000  00000000  00000000  00000000  ________________
-// 3430:  00000000  00000000  00000000  00000000  ________________
-// 3440:  00000000  00000000  00000000  00000000  ________________
-// 3450:  00000000  00000000  00000000  00000000  ________________
-// 3460:  00000000  00000000  00000000  00000000  ________________
-// 3470:  00000000  00000000  00000000  00000000  ________________
-// 3480:  00000000  00000000  00000000  00000000  ________________
-// 3490:  00000000  00000000  00000000  00000000  ________________
-// 34a0:  00000000  00000000  00000000  00000000  ________________
-// 34b0:  00000000  00000000  00000000  00000000  ________________
-// 34c0:  00000000  00000000  00000000  00000000  ________________
-// 34d0:  00000000  00000000  00000000  00000000  ________________
-// 34e0:  00000000  00000000  00000000  00000000  ________________
-// 34f0:  00000000  00000000  00000000  00000000  ________________
-// 3500:  00000000  00000000  00000000  00000000  ________________
-// 3510:  00000000  00000000  00000000  00000000  ________________
-// 3520:  00000000  00000000  00000000  00000000  ________________
-// 3530:  00000000  00000000  00000000  00000000  ________________
-// 3540:  00000000  00000000  00000000  00000000  ________________
-// 3550:  00000000  00000000  00000000  00000000  ________________
-// 3560:  00000000  00000000  00000000  00000000  ________________
-// 3570:  00000000  00000000  00000000  00000000  ________________
-// 3580:  00000000  00000000  00000000  00000000  ________________
-// 3590:  00000000  00000000  00000000  00000000  ________________
-// 35a0:  00000000  00000000  00000000  00000000  ________________
-// 35b0:  00000000  00000000  00000000  00000000  ________________
-// 35c0:  00000000  00000000  00000000  00000000  ________________
-// 35d0:  00000000  00000000  00000000  00000000  ________________
-// 35e0:  00000000  00000000  00000000  00000000  ________________
-// 35f0:  00000000  00000000  00000000  00000000  ________________
-// 3600:  00000000  00000000  00000000  00000000  ________________
-// 3610:  00000000  00000000  00000000  00000000  ________________
-// 3620:  00000000  00000000  00000000  00000000  ________________
-// 3630:  00000000  00000000  00000000  00000000  ________________
-// 3640:  00000000  00000000  00000000  00000000  ________________
-// 3650:  00000000  00000000  00000000  00000000  ________________
-// 3660:  00000000  00000000  00000000  00000000  ________________
-// 3670:  00000000  00000000  00000000  00000000  ________________
-// 3680:  00000000  00000000  00000000  00000000  ________________
-// 3690:  00000000  00000000  00000000  00000000  ________________
-// 36a0:  00000000  00000000  00000000  00000000  ________________
-// 36b0:  00000000  00000000  00000000  00000000  ________________
-// 36c0:  00000000  00000000  00000000  00000000  ________________
-// 36d0:  00000000  00000000  00000000  00000000  ________________
-// 36e0:  00000000  00000000  00000000  00000000  ________________
-// 36f0:  00000000  00000000  00000000  00000000  ________________
-// 3700:  00000000  00000000  00000000  00000000  ________________
-// 3710:  00000000  00000000  00000000  00000000  ________________
-// 3720:  00000000  00000000  00000000  00000000  ________________
-// 3730:  00000000  00000000  00000000  00000000  ________________
-// 3740:  00000000  00000000  00000000  00000000  ________________
-// 3750:  00000000  00000000  00000000  00000000  ________________
-// 3760:  00000000  00000000  00000000  00000000  ________________
-// 3770:  00000000  00000000  00000000  00000000  ________________
-// 3780:  00000000  00000000  00000000  00000000  ________________
-// 3790:  00000000  00000000  00000000  00000000  ________________
-// 37a0:  00000000  00000000  00000000  00000000  ________________
-// 37b0:  00000000  00000000  00000000  00000000  ________________
-// 37c0:  00000000  00000000  00000000  00000000  ________________
-// 37d0:  00000000  00000000  00000000  00000000  ________________
-// 37e0:  00000000  00000000  00000000  00000000  ________________
-// 37f0:  00000000  00000000  00000000  00000000  ________________
-// 3800:  00000000  00000000  00000000  00000000  ________________
-// 3810:  00000000  00000000  00000000  00000000  ________________
-// 3820:  00000000  00000000  00000000  00000000  ________________
-// 3830:  00000000  00000000  00000000  00000000  ________________
-// 3840:  00000000  00000000  00000000  00000000  ________________
-// 3850:  00000000  00000000  00000000  00000000  ________________
-// 3860:  00000000  00000000  00000000  00000000  ________________
-// 3870:  00000000  00000000  00000000  00000000  ________________
-// 3880:  00000000  00000000  00000000  00000000  ________________
-// 3890:  00000000  00000000  00000000  00000000  ________________
-// 38a0:  00000000  00000000  00000000  00000000  ________________
-// 38b0:  00000000  00000000  00000000  00000000  ________________
-// 38c0:  00000000  00000000                      ________
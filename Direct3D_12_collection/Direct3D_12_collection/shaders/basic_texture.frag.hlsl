@@ -4,11 +4,12 @@ struct PSInput
     float2 texCoords : TEXCOORD;
 };
 
-Texture2D<float4> texObj : register(t0, space0);
+// Only the first array slice is sampled, which is the +X face of a cube map
+Texture2DArray<float4> texObj : register(t0, space0);
 SamplerState texSampler : register(s0, space0);
 
 float4 PSMain(PSInput input) : SV_TARGET
 {
-    return texObj.Sample(texSampler, input.texCoords);
+    return texObj.Sample(texSampler, float3(input.texCoords, 0.0f));
 }
 
@@ -88,6 +88,8 @@ float4 PSMain(PSInput input, //out float outDepth : SV_Depth,
 
 #if ENABLE_CONSERVATIVE_RASTERIZATION_MODE
     if (innerCoverage != 0U) {
+        // Count the fully covered pixels for the comparison with the CPU conservative rasterization model
+        InterlockedAdd(uavOutput[1], 1U);
         inputColor = float4(0.9f, 0.9f, 0.9f, 1.0f);
     }
 #else
@@ -0,0 +1,21 @@
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float4 normal : NORMAL;
+    float4 color : COLOR;
+};
+
+struct PSOutput
+{
+    float4 albedo : SV_TARGET0;
+    float4 normal : SV_TARGET1;     // view-space normal
+};
+
+PSOutput PSMain(PSInput input)
+{
+    PSOutput output;
+    output.albedo = input.color;
+    output.normal = float4(normalize(input.normal.xyz), 0.0f);
+
+    return output;
+}
@@ -0,0 +1,33 @@
+/** D3D perspective projection matrix for a right-handed view space (depth range [0, 1]) *
+ * [ 2n/(r-l)       0             0             0
+     0             2n/(t-b)       0             0
+    (r+l)/(r-l)   (t+b)/(t-b)   f/(n-f)        -1
+     0              0           nf/(n-f)        0
+ * ]
+*/
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float4 normal : NORMAL;
+    float4 color : COLOR;
+};
+
+// The scene vertices are already in view space
+PSInput VSMain(float4 position : POSITION, float4 normal : NORMAL, float4 color : COLOR)
+{
+    // frustum(-1.0, 1.0, -1.0, 1.0, 1.0, 9.0), keep consistent with DEFERRED_NEAR_PLANE and DEFERRED_FAR_PLANE in DepthBoundTest.cpp
+    const float4x4 projectionMatrix = {
+        1.0f, 0.0f, 0.0f, 0.0f,         // row 0
+        0.0f, 1.0f, 0.0f, 0.0f,         // row 1
+        0.0f, 0.0f, -1.125f, -1.0f,     // row 2
+        0.0f, 0.0f, -1.125f, 0.0f       // row 3
+    };
+
+    PSInput result;
+    result.position = mul(position, projectionMatrix);
+    result.normal = normal;
+    result.color = color;
+
+    return result;
+}
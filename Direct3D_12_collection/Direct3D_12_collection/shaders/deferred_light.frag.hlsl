@@ -0,0 +1,61 @@
+// Shades one point light from the G-buffer.
+// Pixels whose G-buffer depth is outside the light's depth range are rejected by the depth bounds test before this shader runs.
+
+struct LightInfo
+{
+    float3 position;    // view-space position
+    float radius;
+    float3 color;
+    float paddings;
+    float4 rect;        // NDC bounding rectangle [minX, minY, maxX, maxY]
+};
+
+struct CBLightIndex
+{
+    uint lightIndex;
+    uint counterIndex;
+};
+
+Texture2D<float4> albedoTexture : register(t0, space0);
+Texture2D<float4> normalTexture : register(t1, space0);
+Texture2D<float> depthTexture : register(t2, space0);
+StructuredBuffer<LightInfo> lights : register(t3, space0);
+
+// Intel HD Graphics and Iris Pro Graphics DO NOT support RWBuffer.
+RWStructuredBuffer<uint> uavOutput : register(u0, space0);
+
+ConstantBuffer<CBLightIndex> cbLightIndex : register(b0, space0);
+
+// frustum(-1.0, 1.0, -1.0, 1.0, 1.0, 9.0) used in deferred_gbuffer.vert.hlsl
+static const float nearPlane = 1.0f;
+static const float farPlane = 9.0f;
+
+// Early depth stencil keeps the invocation counter from disabling the depth bounds rejection
+[earlydepthstencil]
+float4 PSMain(float4 position : SV_POSITION) : SV_TARGET
+{
+    InterlockedAdd(uavOutput[cbLightIndex.counterIndex], 1U);
+
+    const int3 texel = int3(position.xy, 0);
+    const float depth = depthTexture.Load(texel);
+
+    uint width, height;
+    depthTexture.GetDimensions(width, height);
+
+    // Reconstruct the view-space position: depth = f / (f - n) * (1 + n / z)
+    const float viewZ = nearPlane / (depth * (farPlane - nearPlane) / farPlane - 1.0f);
+    const float2 ndc = float2(position.x / float(width) * 2.0f - 1.0f, 1.0f - position.y / float(height) * 2.0f);
+    const float3 viewPosition = float3(ndc * -viewZ, viewZ);
+
+    const LightInfo light = lights[cbLightIndex.lightIndex];
+    const float3 toLight = light.position - viewPosition;
+    const float distanceSquare = dot(toLight, toLight);
+
+    // Windowed falloff, so the light has no contribution outside its radius
+    const float falloff = saturate(1.0f - distanceSquare / (light.radius * light.radius));
+    const float3 normal = normalTexture.Load(texel).xyz;
+    const float nDotL = saturate(dot(normal, toLight * rsqrt(max(distanceSquare, 1e-8f))));
+
+    const float3 albedo = albedoTexture.Load(texel).rgb;
+    return float4(albedo * light.color * (nDotL * falloff * falloff), 1.0f);
+}
@@ -0,0 +1,29 @@
+// Expands the screen-space bounding rectangle of the current light into a 4-vertex triangle strip
+
+struct LightInfo
+{
+    float3 position;    // view-space position
+    float radius;
+    float3 color;
+    float paddings;
+    float4 rect;        // NDC bounding rectangle [minX, minY, maxX, maxY]
+};
+
+struct CBLightIndex
+{
+    uint lightIndex;
+    uint counterIndex;
+};
+
+StructuredBuffer<LightInfo> lights : register(t3, space0);
+
+ConstantBuffer<CBLightIndex> cbLightIndex : register(b0, space0);
+
+float4 VSMain(uint vertexIndex : SV_VertexID) : SV_POSITION
+{
+    const float4 rect = lights[cbLightIndex.lightIndex].rect;
+    const float x = (vertexIndex & 1U) != 0U ? rect.z : rect.x;
+    const float y = (vertexIndex & 2U) != 0U ? rect.y : rect.w;
+
+    return float4(x, y, 0.0f, 1.0f);
+}
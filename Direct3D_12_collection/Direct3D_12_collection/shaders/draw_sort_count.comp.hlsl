@@ -0,0 +1,61 @@
+
+// Pass 1 of one 4-bit radix sort pass over the 64-bit draw keys: per-group digit histograms.
+// The first pass also counts the draws of every state bucket.
+
+#define SORT_GROUP_SIZE         256U
+#define SORT_DIGIT_COUNT        16U
+#define SORT_SIGNATURE_COUNT    2U
+
+// The same layout as DrawSortConstants in ExecuteIndirectTest.cpp
+struct CBSort
+{
+    uint drawCount;
+    uint blockCount;            // number of SORT_GROUP_SIZE element blocks
+    uint shift;                 // bit offset of the digit in the key
+    uint bucketRegionSize;      // in bytes
+    uint2 commandStrides;       // in bytes, per command signature
+};
+
+ConstantBuffer<CBSort> cbSort : register(b0, space0);
+
+// Sort elements: key low, key high, draw index, source argument offset in bytes
+RWStructuredBuffer<uint4> uavSourceElements : register(u0, space0);
+
+// [SORT_DIGIT_COUNT][blockCount]
+RWStructuredBuffer<uint> uavBlockHistograms : register(u2, space0);
+
+// One command count per bucket. It must be cleared before the first pass.
+RWStructuredBuffer<uint> uavBucketCounts : register(u3, space0);
+
+groupshared uint digitCounts[SORT_DIGIT_COUNT];
+
+// Key high bits 12-15: pipeline, bits 8-11: command signature
+uint GetBucket(uint keyHigh)
+{
+    return ((keyHigh >> 12) & 0xfU) * SORT_SIGNATURE_COUNT + ((keyHigh >> 8) & 0xfU);
+}
+
+[numthreads(SORT_GROUP_SIZE, 1, 1)]
+void CSMain(in uint3 threadID : SV_DispatchThreadID, in uint3 groupID : SV_GroupID, in uint groupIndex : SV_GroupIndex)
+{
+    if (groupIndex < SORT_DIGIT_COUNT) {
+        digitCounts[groupIndex] = 0U;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (threadID.x < cbSort.drawCount)
+    {
+        const uint4 element = uavSourceElements[threadID.x];
+        const uint digit = (cbSort.shift < 32U ? element.x >> cbSort.shift : element.y >> (cbSort.shift - 32U)) & (SORT_DIGIT_COUNT - 1U);
+        InterlockedAdd(digitCounts[digit], 1U);
+
+        if (cbSort.shift == 0U) {
+            InterlockedAdd(uavBucketCounts[GetBucket(element.y)], 1U);
+        }
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (groupIndex < SORT_DIGIT_COUNT) {
+        uavBlockHistograms[groupIndex * cbSort.blockCount + groupID.x] = digitCounts[groupIndex];
+    }
+}
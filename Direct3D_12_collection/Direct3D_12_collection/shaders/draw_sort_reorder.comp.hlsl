@@ -0,0 +1,53 @@
+
+// Copies the argument of every sorted draw into the region of its state bucket, so each bucket is one ExecuteIndirect()
+// with the bucket count in the count buffer. Buckets follow each other in key order, so the first sorted index
+// of a bucket is the sum of the counts of the buckets before it.
+
+#define SORT_GROUP_SIZE         256U
+#define SORT_SIGNATURE_COUNT    2U
+
+// The same layout as DrawSortConstants in ExecuteIndirectTest.cpp
+struct CBSort
+{
+    uint drawCount;
+    uint blockCount;
+    uint shift;
+    uint bucketRegionSize;
+    uint2 commandStrides;
+};
+
+ConstantBuffer<CBSort> cbSort : register(b0, space0);
+
+RWStructuredBuffer<uint4> uavSourceElements : register(u0, space0);
+RWStructuredBuffer<uint> uavBucketCounts : register(u3, space0);
+
+// The commands of every draw in the format of its command signature
+ByteAddressBuffer sourceArguments : register(t0, space0);
+
+// Region bucket starts at byte bucket * bucketRegionSize
+RWByteAddressBuffer uavSortedArguments : register(u4, space0);
+
+uint GetBucket(uint keyHigh)
+{
+    return ((keyHigh >> 12) & 0xfU) * SORT_SIGNATURE_COUNT + ((keyHigh >> 8) & 0xfU);
+}
+
+[numthreads(SORT_GROUP_SIZE, 1, 1)]
+void CSMain(in uint3 threadID : SV_DispatchThreadID)
+{
+    if (threadID.x >= cbSort.drawCount) return;
+
+    const uint4 element = uavSourceElements[threadID.x];
+    const uint bucket = GetBucket(element.y);
+
+    uint bucketBegin = 0U;
+    for (uint i = 0U; i < bucket; ++i) {
+        bucketBegin += uavBucketCounts[i];
+    }
+
+    const uint stride = (bucket % SORT_SIGNATURE_COUNT) == 0U ? cbSort.commandStrides.x : cbSort.commandStrides.y;
+    const uint destination = bucket * cbSort.bucketRegionSize + (threadID.x - bucketBegin) * stride;
+    for (uint offset = 0U; offset < stride; offset += 4U) {
+        uavSortedArguments.Store(destination + offset, sourceArguments.Load(element.w + offset));
+    }
+}
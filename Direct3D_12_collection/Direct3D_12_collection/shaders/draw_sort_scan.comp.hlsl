@@ -0,0 +1,58 @@
+
+// Pass 2 of one 4-bit radix sort pass: an exclusive prefix sum over all digit histograms in a single group.
+// The histograms are stored digit by digit, so the result is the first destination index of every digit in every block.
+
+#define SCAN_GROUP_SIZE         1024U
+#define SORT_DIGIT_COUNT        16U
+
+// The same layout as DrawSortConstants in ExecuteIndirectTest.cpp
+struct CBSort
+{
+    uint drawCount;
+    uint blockCount;
+    uint shift;
+    uint bucketRegionSize;
+    uint2 commandStrides;
+};
+
+ConstantBuffer<CBSort> cbSort : register(b0, space0);
+
+// [SORT_DIGIT_COUNT][blockCount], scanned in place
+RWStructuredBuffer<uint> uavBlockHistograms : register(u2, space0);
+
+groupshared uint waveSums[SCAN_GROUP_SIZE / 4U];
+
+[numthreads(SCAN_GROUP_SIZE, 1, 1)]
+void CSMain(in uint groupIndex : SV_GroupIndex)
+{
+    // Every thread scans a consecutive range of the histograms
+    const uint histogramCount = SORT_DIGIT_COUNT * cbSort.blockCount;
+    const uint rangeSize = (histogramCount + SCAN_GROUP_SIZE - 1U) / SCAN_GROUP_SIZE;
+    const uint rangeBegin = min(groupIndex * rangeSize, histogramCount);
+    const uint rangeEnd = min(rangeBegin + rangeSize, histogramCount);
+
+    uint rangeSum = 0U;
+    for (uint i = rangeBegin; i < rangeEnd; ++i) {
+        rangeSum += uavBlockHistograms[i];
+    }
+
+    // Waves are formed from consecutive SV_GroupIndex values
+    const uint waveIndex = groupIndex / WaveGetLaneCount();
+
+    uint offset = WavePrefixSum(rangeSum);
+    if (WaveGetLaneIndex() == WaveGetLaneCount() - 1U) {
+        waveSums[waveIndex] = offset + rangeSum;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    for (uint wave = 0U; wave < waveIndex; ++wave) {
+        offset += waveSums[wave];
+    }
+
+    for (uint j = rangeBegin; j < rangeEnd; ++j)
+    {
+        const uint count = uavBlockHistograms[j];
+        uavBlockHistograms[j] = offset;
+        offset += count;
+    }
+}
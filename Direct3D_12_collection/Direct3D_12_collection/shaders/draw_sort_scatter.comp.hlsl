@@ -0,0 +1,62 @@
+
+// Pass 3 of one 4-bit radix sort pass: the stable scatter of every block into the destination elements.
+// The rank of an element among the elements of the same digit before it in the block comes from a block-wide prefix sum
+// of 16 8-bit counters packed into a uint4. An exclusive count never exceeds SORT_GROUP_SIZE - 1, so no counter overflows.
+
+#define SORT_GROUP_SIZE         256U
+#define SORT_DIGIT_COUNT        16U
+
+// The same layout as DrawSortConstants in ExecuteIndirectTest.cpp
+struct CBSort
+{
+    uint drawCount;
+    uint blockCount;
+    uint shift;
+    uint bucketRegionSize;
+    uint2 commandStrides;
+};
+
+ConstantBuffer<CBSort> cbSort : register(b0, space0);
+
+RWStructuredBuffer<uint4> uavSourceElements : register(u0, space0);
+RWStructuredBuffer<uint4> uavDestinationElements : register(u1, space0);
+
+// Scanned [SORT_DIGIT_COUNT][blockCount]
+RWStructuredBuffer<uint> uavBlockHistograms : register(u2, space0);
+
+groupshared uint4 waveDigitCounts[SORT_GROUP_SIZE / 4U];
+
+[numthreads(SORT_GROUP_SIZE, 1, 1)]
+void CSMain(in uint3 threadID : SV_DispatchThreadID, in uint3 groupID : SV_GroupID, in uint groupIndex : SV_GroupIndex)
+{
+    const bool valid = threadID.x < cbSort.drawCount;
+
+    uint4 element = uint4(0U, 0U, 0U, 0U);
+    uint digit = 0U;
+    uint4 counter = uint4(0U, 0U, 0U, 0U);
+    if (valid)
+    {
+        element = uavSourceElements[threadID.x];
+        digit = (cbSort.shift < 32U ? element.x >> cbSort.shift : element.y >> (cbSort.shift - 32U)) & (SORT_DIGIT_COUNT - 1U);
+        counter[digit >> 2] = 1U << ((digit & 3U) * 8U);
+    }
+
+    // Waves are formed from consecutive SV_GroupIndex values
+    const uint waveIndex = groupIndex / WaveGetLaneCount();
+
+    uint4 packedRanks = WavePrefixSum(counter);
+    if (WaveGetLaneIndex() == WaveGetLaneCount() - 1U) {
+        waveDigitCounts[waveIndex] = packedRanks + counter;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    for (uint wave = 0U; wave < waveIndex; ++wave) {
+        packedRanks += waveDigitCounts[wave];
+    }
+
+    if (valid)
+    {
+        const uint rank = (packedRanks[digit >> 2] >> ((digit & 3U) * 8U)) & 0xffU;
+        uavDestinationElements[uavBlockHistograms[digit * cbSort.blockCount + groupID.x] + rank] = element;
+    }
+}
@@ -11,53 +11,81 @@ struct IndirectArgumentBufferType
     uint paddings[3];
 };
 
+// Command types, also the indices of the argument buffer regions and of the count buffer elements
+#define COMMAND_TYPE_DRAW               0U
+#define COMMAND_TYPE_DRAW_INDEXED       1U
+#define COMMAND_TYPE_DISPATCH_MESH      2U
+#define COMMAND_TYPE_COUNT              3U
+
+// The same layout as ExecuteIndirectObject in ExecuteIndirectTest.cpp (48 bytes)
+struct ExecuteIndirectObject
+{
+    float4 boundingSphere;      // view space center xyz, radius
+    uint commandType;
+    uint arguments[5];          // the leading members of IndirectArgumentBufferType
+    uint paddings[2];
+};
+
+struct CBCulling
+{
+    float4 frustumPlanes[6];    // inward normals: dot(plane.xyz, p) + plane.w >= 0 inside
+    uint objectCount;
+    uint maxCommandCount;       // capacity of each command type region in uavIndirectArgBuffer
+};
+
+// Region COMMAND_TYPE_X starts at element COMMAND_TYPE_X * maxCommandCount
 RWStructuredBuffer<IndirectArgumentBufferType> uavIndirectArgBuffer : register(u0, space0);
 
 //RWBuffer<uint> uavCountBuffer : register(u1, space0);
 // Intel HD Graphics and Iris Pro Graphics DO NOT support RWBuffer.
+// One command count per command type. It must be cleared before the dispatch.
 RWStructuredBuffer<uint> uavCountBuffer : register(u1, space0);
 
+StructuredBuffer<ExecuteIndirectObject> objects : register(t0, space0);
+
+ConstantBuffer<CBCulling> cbCulling : register(b1, space0);
+
+// One object per thread: frustum-cull it and compact the surviving commands of each type with a wave prefix sum,
+// so that each wave issues one atomic per command type.
 [numthreads(128, 1, 1)]
 void CSMain(in uint3 threaID : SV_DispatchThreadID)
 {
     const uint index = threaID.x;
-    if (index != 0U) return;
 
-    // 4 draw commands
-    for (uint i = 0U; i < 4U; ++i)
+    ExecuteIndirectObject object = (ExecuteIndirectObject)0;
+    bool visible = index < cbCulling.objectCount;
+    if (visible)
     {
-        // vertex count per instance
-        uavIndirectArgBuffer[i].VertexCountPerInstance_IndexCountPerInstance_ThreadGroupX = 4U;
-        // instance count
-        uavIndirectArgBuffer[i].InstanceCount_ThreadGroupCountY = 1U;
-        // start vertex location
-        uavIndirectArgBuffer[i].StartVertexLocation_StartIndexLocation_ThreadGroupCountZ = i * 4U;
-        // start instance location
-        uavIndirectArgBuffer[i].StartInstanceLocation_BaseVertexLocation = 0U;
+        object = objects[index];
+        for (uint i = 0U; i < 6U; ++i) {
+            visible = visible && dot(cbCulling.frustumPlanes[i].xyz, object.boundingSphere.xyz) + cbCulling.frustumPlanes[i].w >= -object.boundingSphere.w;
+        }
     }
 
-    // 1 draw index command
-    // index count per instance
-    uavIndirectArgBuffer[4].VertexCountPerInstance_IndexCountPerInstance_ThreadGroupX = 360 * 2U;
-    // instance count
-    uavIndirectArgBuffer[4].InstanceCount_ThreadGroupCountY = 1U;
-    // start index location
-    uavIndirectArgBuffer[4].StartVertexLocation_StartIndexLocation_ThreadGroupCountZ = 0U;
-    // base vertex location
-    uavIndirectArgBuffer[4].StartInstanceLocation_BaseVertexLocation = 0U;
-    // start instance location
-    uavIndirectArgBuffer[4].StartInstanceLocation = 0U;
-
-    // 1 dispatch mesh command
-    // thread group X
-    uavIndirectArgBuffer[5].VertexCountPerInstance_IndexCountPerInstance_ThreadGroupX = 1U;
-    // thread group Y
-    uavIndirectArgBuffer[5].InstanceCount_ThreadGroupCountY = 1U;
-    // thread group Z
-    uavIndirectArgBuffer[5].StartVertexLocation_StartIndexLocation_ThreadGroupCountZ = 1U;
-
-    uavCountBuffer[0] = 4U;
-    uavCountBuffer[1] = 1U;
-    uavCountBuffer[2] = 1U;
-}
+    for (uint commandType = 0U; commandType < COMMAND_TYPE_COUNT; ++commandType)
+    {
+        const bool emit = visible && object.commandType == commandType;
+
+        const uint waveCommandCount = WaveActiveCountBits(emit);
+        if (waveCommandCount == 0U) continue;
 
+        uint waveOffset = 0U;
+        if (WaveIsFirstLane()) {
+            InterlockedAdd(uavCountBuffer[commandType], waveCommandCount, waveOffset);
+        }
+        waveOffset = WaveReadLaneFirst(waveOffset);
+
+        const uint commandIndex = waveOffset + WavePrefixCountBits(emit);
+        if (emit && commandIndex < cbCulling.maxCommandCount)
+        {
+            IndirectArgumentBufferType arguments = (IndirectArgumentBufferType)0;
+            arguments.VertexCountPerInstance_IndexCountPerInstance_ThreadGroupX = object.arguments[0];
+            arguments.InstanceCount_ThreadGroupCountY = object.arguments[1];
+            arguments.StartVertexLocation_StartIndexLocation_ThreadGroupCountZ = object.arguments[2];
+            arguments.StartInstanceLocation_BaseVertexLocation = object.arguments[3];
+            arguments.StartInstanceLocation = object.arguments[4];
+
+            uavIndirectArgBuffer[commandType * cbCulling.maxCommandCount + commandIndex] = arguments;
+        }
+    }
+}
@@ -0,0 +1,36 @@
+// The input assembler path of the geometry pipeline benchmark: the same mesh and instances as meshlet.mesh.hlsl,
+// fetched as an indexed vertex buffer and a per-instance vertex buffer
+
+struct CBMeshletCulling
+{
+    row_major float4x4 viewProjection;
+    float4 frustumPlanes[6];
+    float4 cameraPosition;
+    uint meshletCount;
+    uint instanceCount;
+};
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+};
+
+ConstantBuffer<CBMeshletCulling> cbCulling : register(b0, space0);
+
+// A distinct color for every instance
+float3 GetInstanceColor(uint instanceID)
+{
+    const uint hash = instanceID * 2654435761U;
+    return float3(hash & 0xffU, (hash >> 8) & 0xffU, (hash >> 16) & 0xffU) * (0.7f / 255.0f) + 0.3f;
+}
+
+// instance xyz: translation, w: uniform scale
+PSInput VSMain(float3 position : POSITION, float4 instance : INSTANCE, uint instanceID : SV_InstanceID)
+{
+    PSInput result;
+    result.position = mul(float4(position * instance.w + instance.xyz, 1.0f), cbCulling.viewProjection);
+    result.color = float4(GetInstanceColor(instanceID), 1.0f);
+
+    return result;
+}
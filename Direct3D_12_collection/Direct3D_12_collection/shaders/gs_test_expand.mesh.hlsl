@@ -0,0 +1,119 @@
+// The mesh shader replacement of gs_test.vs.hlsl + gs_test.gs.hlsl.
+// Every group expands POINTS_PER_GROUP points into 4 squares each, which fills the 256-vertex output limit:
+// 16 points x 4 squares x 4 vertices = 256 vertices and 16 x 4 x 2 = 128 triangles.
+// The square colors and the viewport index are per-primitive attributes.
+
+// Must be the same as GS_TEST_MESH_POINTS_PER_GROUP in GeometryShaderTest.cpp
+#define POINTS_PER_GROUP    16U
+#define SQUARES_PER_POINT   4U
+
+struct PointVertex
+{
+    float4 position;
+    float4 color;
+};
+
+struct CBExpansion
+{
+    uint pointCount;
+};
+
+struct MeshOutputVertex
+{
+    float4 position : SV_POSITION;
+};
+
+struct MeshOutputPrimitive
+{
+    nointerpolation float4 color : COLOR;
+    uint viewportIndex : SV_ViewportArrayIndex;
+};
+
+ConstantBuffer<CBExpansion> cbExpansion : register(b0, space0);
+
+StructuredBuffer<PointVertex> points : register(t0, space0);
+
+// The same colors as colorList in gs_test.gs.hlsl
+float4 GetSquareColor(float4 baseColor, uint pointIndex, uint squareIndex)
+{
+    if (squareIndex == 0U) return baseColor;
+
+    const float4 invR = float4(1.0f - baseColor.r, baseColor.g, baseColor.b, baseColor.a);
+    const float4 invG = float4(baseColor.r, 1.0f - baseColor.g, baseColor.b, baseColor.a);
+    const float4 invRG = float4(1.0f - baseColor.r, 1.0f - baseColor.g, baseColor.b, baseColor.a);
+    const float4 invRB = float4(1.0f - baseColor.r, baseColor.g, 1.0f - baseColor.b, baseColor.a);
+    const float4 invGB = float4(baseColor.r, 1.0f - baseColor.g, 1.0f - baseColor.b, baseColor.a);
+
+    switch (pointIndex)
+    {
+    case 0U:
+    default:
+        return squareIndex == 1U ? invRG : (squareIndex == 2U ? invRB : invG);
+
+    case 1U:
+        return squareIndex == 1U ? invRG : (squareIndex == 2U ? invGB : invR);
+
+    case 2U:
+        return squareIndex == 1U ? invRB : (squareIndex == 2U ? invGB : invR);
+
+    case 3U:
+        return squareIndex == 1U ? invR : (squareIndex == 2U ? invG : invRB);
+    }
+}
+
+[outputtopology("triangle")]
+[numthreads(128, 1, 1)]
+void MeshMain(in uint groupID : SV_GroupID, in uint localTID : SV_GroupThreadID,
+            out vertices MeshOutputVertex outVertices[256], out indices uint3 outPrimIndices[128], out primitives MeshOutputPrimitive outPrims[128])
+{
+    // glTranslate(offset, offset, -2.2, 1.0)
+    const float4x4 translateMatrix = {
+        1.0f, 0.0f, 0.0f, 0.0f,     // row 0
+        0.0f, 1.0f, 0.0f, 0.0f,     // row 1
+        0.0f, 0.0f, 1.0f, 0.0f,     // row 2
+        0.0f, 0.0f, -2.2f, 1.0f     // row 3
+    };
+
+    // glOrtho(-1.0, 1.0, -1.0, 1.0, 1.0, 3.0)
+    const float4x4 projectionMatrix = {
+        1.0f, 0.0f, 0.0f, 0.0f,     // row 0
+        0.0f, 1.0f, 0.0f, 0.0f,     // row 1
+        0.0f, 0.0f, -1.0f, 0.0f,    // row 2
+        0.0f, 0.0f, -2.0f, 1.0f     // row 3
+    };
+
+    // top-left, top-right, bottom-left, bottom-right square
+    const float2 squareOrigins[4] = { float2(-0.8f, 0.1f), float2(0.1f, 0.1f), float2(-0.8f, -0.8f), float2(0.1f, -0.8f) };
+    const float width = 0.7f;
+
+    const uint firstPoint = groupID * POINTS_PER_GROUP;
+    const uint pointCount = min(cbExpansion.pointCount - firstPoint, POINTS_PER_GROUP);
+
+    SetMeshOutputCounts(pointCount * SQUARES_PER_POINT * 4U, pointCount * SQUARES_PER_POINT * 2U);
+
+    // Each work item generates 2 vertices. Vertex order of a square: bottom-left, top-left, bottom-right, top-right
+    for (uint vertexIndex = localTID; vertexIndex < pointCount * SQUARES_PER_POINT * 4U; vertexIndex += 128U)
+    {
+        const uint squareIndex = (vertexIndex / 4U) % SQUARES_PER_POINT;
+        const float4 pointPosition = mul(points[firstPoint + vertexIndex / (SQUARES_PER_POINT * 4U)].position, mul(translateMatrix, projectionMatrix));
+        const float2 corner = float2(float((vertexIndex >> 1) & 1U), float(vertexIndex & 1U));
+
+        outVertices[vertexIndex].position = float4(squareOrigins[squareIndex] + corner * width, pointPosition.z, pointPosition.w);
+    }
+
+    // Each work item assembles 1 primitive (2 triangles compose 1 square)
+    if (localTID < pointCount * SQUARES_PER_POINT * 2U)
+    {
+        const uint pointIndex = firstPoint + localTID / (SQUARES_PER_POINT * 2U);
+        const uint squareIndex = (localTID / 2U) % SQUARES_PER_POINT;
+        const uint v0 = localTID / 2U * 4U;
+
+        // The same triangles as the strip of the geometry shader
+        outPrimIndices[localTID] = (localTID & 1U) == 0U ? uint3(v0, v0 + 1U, v0 + 2U) : uint3(v0 + 1U, v0 + 3U, v0 + 2U);
+
+        // The point index in its copy of the 4 test points plays the role of SV_PrimitiveID in the geometry shader
+        outPrims[localTID].color = GetSquareColor(points[pointIndex].color, pointIndex % 4U, squareIndex);
+        outPrims[localTID].viewportIndex = pointIndex % 4U;
+    }
+}
+
@@ -0,0 +1,81 @@
+// The instanced replacement of gs_test.vs.hlsl + gs_test.gs.hlsl.
+// Every input point is bound as per-instance data with a step rate of 4, so each point is fetched by 4 instances,
+// one for each square, and each instance draws the 4 vertices of one triangle strip.
+// The vertex shader writes SV_ViewportArrayIndex directly, which requires
+// D3D12_FEATURE_DATA_D3D12_OPTIONS::VPAndRTArrayIndexFromAnyShaderFeedingRasterizerSupportedWithoutGSEmulation.
+
+struct VSOut
+{
+    float4 position : SV_POSITION;
+    nointerpolation float4 color : COLOR;
+    uint viewportIndex : SV_ViewportArrayIndex;
+};
+
+// The same colors as colorList in gs_test.gs.hlsl
+float4 GetSquareColor(float4 baseColor, uint pointIndex, uint squareIndex)
+{
+    if (squareIndex == 0U) return baseColor;
+
+    const float4 invR = float4(1.0f - baseColor.r, baseColor.g, baseColor.b, baseColor.a);
+    const float4 invG = float4(baseColor.r, 1.0f - baseColor.g, baseColor.b, baseColor.a);
+    const float4 invRG = float4(1.0f - baseColor.r, 1.0f - baseColor.g, baseColor.b, baseColor.a);
+    const float4 invRB = float4(1.0f - baseColor.r, baseColor.g, 1.0f - baseColor.b, baseColor.a);
+    const float4 invGB = float4(baseColor.r, 1.0f - baseColor.g, 1.0f - baseColor.b, baseColor.a);
+
+    switch (pointIndex)
+    {
+    case 0U:
+    default:
+        return squareIndex == 1U ? invRG : (squareIndex == 2U ? invRB : invG);
+
+    case 1U:
+        return squareIndex == 1U ? invRG : (squareIndex == 2U ? invGB : invR);
+
+    case 2U:
+        return squareIndex == 1U ? invRB : (squareIndex == 2U ? invGB : invR);
+
+    case 3U:
+        return squareIndex == 1U ? invR : (squareIndex == 2U ? invG : invRB);
+    }
+}
+
+VSOut VSMain(float4 position : POSITION, float4 color : COLOR, uint vertexID : SV_VertexID, uint instanceID : SV_InstanceID)
+{
+    // glTranslate(offset, offset, -2.2, 1.0)
+    const float4x4 translateMatrix = {
+        1.0f, 0.0f, 0.0f, 0.0f,     // row 0
+        0.0f, 1.0f, 0.0f, 0.0f,     // row 1
+        0.0f, 0.0f, 1.0f, 0.0f,     // row 2
+        0.0f, 0.0f, -2.2f, 1.0f     // row 3
+    };
+
+    // glOrtho(-1.0, 1.0, -1.0, 1.0, 1.0, 3.0)
+    const float4x4 projectionMatrix = {
+        1.0f, 0.0f, 0.0f, 0.0f,     // row 0
+        0.0f, 1.0f, 0.0f, 0.0f,     // row 1
+        0.0f, 0.0f, -1.0f, 0.0f,    // row 2
+        0.0f, 0.0f, -2.0f, 1.0f     // row 3
+    };
+
+    // top-left, top-right, bottom-left, bottom-right square
+    const float2 squareOrigins[4] = { float2(-0.8f, 0.1f), float2(0.1f, 0.1f), float2(-0.8f, -0.8f), float2(0.1f, -0.8f) };
+    const float width = 0.7f;
+
+    // The point index plays the role of SV_PrimitiveID in the geometry shader.
+    // The modulo keeps scenes of several copies of the 4 points (the viewport array benchmark) on the same 4 viewports.
+    const uint squareIndex = instanceID % 4U;
+    const uint pointIndex = (instanceID / 4U) % 4U;
+
+    const float4 pointPosition = mul(position, mul(translateMatrix, projectionMatrix));
+
+    // Strip order: bottom-left, top-left, bottom-right, top-right
+    const float2 corner = float2(float(vertexID >> 1), float(vertexID & 1U));
+
+    VSOut result;
+    result.position = float4(squareOrigins[squareIndex] + corner * width, pointPosition.z, pointPosition.w);
+    result.color = GetSquareColor(color, pointIndex, squareIndex);
+    result.viewportIndex = pointIndex;
+
+    return result;
+}
+
@@ -0,0 +1,81 @@
+// Builds one level of the hierarchical depth (Hi-Z) pyramid per dispatch.
+// Level 0 copies the depth texture, and every other level reduces the previous level to (min, max) depth pairs.
+// The pyramid layout is described in HiZPyramid.h.
+
+#define USE_MSAA                0
+
+#if USE_MSAA
+Texture2DMS<float> depthTextureMS : register(t0, space0);
+#else
+Texture2D<float> depthTexture : register(t0, space0);
+#endif
+
+// Intel HD Graphics and Iris Pro Graphics DO NOT support RWBuffer.
+RWStructuredBuffer<float2> hiZPyramid : register(u0, space0);
+
+struct CBHiZLevel
+{
+    uint level;
+    uint srcOffset;
+    uint srcWidth;
+    uint srcHeight;
+    uint dstOffset;
+    uint dstWidth;
+    uint dstHeight;
+    uint paddings;
+};
+
+ConstantBuffer<CBHiZLevel> cbHiZLevel : register(b0, space0);
+
+// Source texel range of the destination texel on one axis. The last destination texel also covers the odd remainder.
+uint2 GetSourceRange(uint dst, uint dstSize, uint srcSize)
+{
+    const uint first = min(dst * 2U, srcSize - 1U);
+    const uint last = dst == dstSize - 1U ? srcSize - 1U : min(dst * 2U + 1U, srcSize - 1U);
+    return uint2(first, last);
+}
+
+[numthreads(8, 8, 1)]
+void CSMain(in uint3 threaID : SV_DispatchThreadID)
+{
+    const uint x = threaID.x;
+    const uint y = threaID.y;
+    if (x >= cbHiZLevel.dstWidth || y >= cbHiZLevel.dstHeight) return;
+
+    const uint dstIndex = cbHiZLevel.dstOffset + y * cbHiZLevel.dstWidth + x;
+
+    if (cbHiZLevel.level == 0U)
+    {
+#if USE_MSAA
+        uint width, height, sampleCount;
+        depthTextureMS.GetDimensions(width, height, sampleCount);
+
+        float2 minMaxDepth = float2(1.0f, 0.0f);
+        for (uint sampleIndex = 0U; sampleIndex < sampleCount; ++sampleIndex)
+        {
+            const float depthValue = depthTextureMS.Load(int2(x, y), sampleIndex);
+            minMaxDepth = float2(min(minMaxDepth.x, depthValue), max(minMaxDepth.y, depthValue));
+        }
+        hiZPyramid[dstIndex] = minMaxDepth;
+#else
+        const float depthValue = depthTexture.Load(int3(x, y, 0));
+        hiZPyramid[dstIndex] = float2(depthValue, depthValue);
+#endif
+        return;
+    }
+
+    const uint2 srcRangeX = GetSourceRange(x, cbHiZLevel.dstWidth, cbHiZLevel.srcWidth);
+    const uint2 srcRangeY = GetSourceRange(y, cbHiZLevel.dstHeight, cbHiZLevel.srcHeight);
+
+    float2 minMaxDepth = hiZPyramid[cbHiZLevel.srcOffset + srcRangeY.x * cbHiZLevel.srcWidth + srcRangeX.x];
+    for (uint sy = srcRangeY.x; sy <= srcRangeY.y; ++sy)
+    {
+        for (uint sx = srcRangeX.x; sx <= srcRangeX.y; ++sx)
+        {
+            const float2 texel = hiZPyramid[cbHiZLevel.srcOffset + sy * cbHiZLevel.srcWidth + sx];
+            minMaxDepth = float2(min(minMaxDepth.x, texel.x), max(minMaxDepth.y, texel.y));
+        }
+    }
+
+    hiZPyramid[dstIndex] = minMaxDepth;
+}
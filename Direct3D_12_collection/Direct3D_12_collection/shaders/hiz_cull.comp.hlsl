@@ -0,0 +1,87 @@
+// Tests the screen-space bounding rectangle of each object against the hierarchical depth (Hi-Z) pyramid.
+// The pyramid layout and the output layout are described in HiZPyramid.h, and HiZCullObject is the CPU reference.
+
+#define VISIBILITY_BITS_INDEX   2U
+
+struct ObjectBounds
+{
+    float4 rect;        // [minX, minY, maxX, maxY) in pixels
+    float minDepth;
+    float maxDepth;
+    float2 paddings;
+};
+
+StructuredBuffer<ObjectBounds> objectBounds : register(t1, space0);
+
+// Intel HD Graphics and Iris Pro Graphics DO NOT support RWBuffer.
+RWStructuredBuffer<float2> hiZPyramid : register(u0, space0);
+
+// [0]: visible object count, [1]: unoccluded object count, [2, 2 + bitWords): visibility bits, then the compacted visible object indices
+RWStructuredBuffer<uint> cullOutput : register(u1, space0);
+
+struct CBHiZCull
+{
+    uint objectCount;
+    uint levelCount;
+    uint baseWidth;
+    uint baseHeight;
+};
+
+ConstantBuffer<CBHiZCull> cbHiZCull : register(b0, space0);
+
+[numthreads(64, 1, 1)]
+void CSMain(in uint3 threaID : SV_DispatchThreadID)
+{
+    const uint objectIndex = threaID.x;
+    if (objectIndex >= cbHiZCull.objectCount) return;
+
+    const ObjectBounds bounds = objectBounds[objectIndex];
+
+    // Pixels whose centers may be touched by the rectangle, clamped to the depth buffer
+    const int pixelX0 = max(int(floor(bounds.rect.x)), 0);
+    const int pixelY0 = max(int(floor(bounds.rect.y)), 0);
+    const int pixelX1 = min(int(ceil(bounds.rect.z)) - 1, int(cbHiZCull.baseWidth) - 1);
+    const int pixelY1 = min(int(ceil(bounds.rect.w)) - 1, int(cbHiZCull.baseHeight) - 1);
+    if (pixelX1 < pixelX0 || pixelY1 < pixelY0) return;
+
+    // Select the level on which the rectangle spans at most 2 x 2 texels
+    const uint extent = uint(max(pixelX1 - pixelX0, pixelY1 - pixelY0) + 1);
+    const uint level = min(extent > 1U ? firstbithigh(extent - 1U) + 1U : 0U, cbHiZCull.levelCount - 1U);
+
+    uint levelOffset = 0U;
+    for (uint i = 0U; i < level; ++i) {
+        levelOffset += max(1U, cbHiZCull.baseWidth >> i) * max(1U, cbHiZCull.baseHeight >> i);
+    }
+    const uint levelWidth = max(1U, cbHiZCull.baseWidth >> level);
+    const uint levelHeight = max(1U, cbHiZCull.baseHeight >> level);
+
+    const uint texelX0 = min(uint(pixelX0) >> level, levelWidth - 1U);
+    const uint texelY0 = min(uint(pixelY0) >> level, levelHeight - 1U);
+    const uint texelX1 = min(uint(pixelX1) >> level, levelWidth - 1U);
+    const uint texelY1 = min(uint(pixelY1) >> level, levelHeight - 1U);
+
+    float2 occluderMinMaxDepth = hiZPyramid[levelOffset + texelY0 * levelWidth + texelX0];
+    for (uint y = texelY0; y <= texelY1; ++y)
+    {
+        for (uint x = texelX0; x <= texelX1; ++x)
+        {
+            const float2 texel = hiZPyramid[levelOffset + y * levelWidth + x];
+            occluderMinMaxDepth = float2(min(occluderMinMaxDepth.x, texel.x), max(occluderMinMaxDepth.y, texel.y));
+        }
+    }
+
+    // D3D12_COMPARISON_FUNC_LESS: the object is hidden when it is behind the farthest occluder in its footprint
+    if (bounds.minDepth > occluderMinMaxDepth.y) return;
+
+    if (bounds.maxDepth < occluderMinMaxDepth.x) {
+        InterlockedAdd(cullOutput[1], 1U);
+    }
+
+    InterlockedOr(cullOutput[VISIBILITY_BITS_INDEX + objectIndex / 32U], 1U << (objectIndex % 32U));
+
+    uint slot;
+    InterlockedAdd(cullOutput[0], 1U, slot);
+
+    const uint bitWordCount = (cbHiZCull.objectCount + 31U) / 32U;
+    cullOutput[VISIBILITY_BITS_INDEX + bitWordCount + slot] = objectIndex;
+}
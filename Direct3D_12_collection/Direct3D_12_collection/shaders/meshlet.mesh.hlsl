@@ -0,0 +1,99 @@
+// Renders one meshlet per group from the payload of meshlet_cull.amplification.hlsl
+
+// Must be the same as MESHLET_CULLING_GROUP_SIZE and TEST_MESHLET_MAX_*_COUNT in MeshShaderTest.cpp
+#define MESHLET_CULLING_GROUP_SIZE  32
+#define MESHLET_MAX_VERTEX_COUNT    64
+#define MESHLET_MAX_PRIMITIVE_COUNT 126
+
+// 0 compiles the statistics counters out, for the timed passes (see the *_nostats wrappers)
+#ifndef MESHLET_STATISTICS
+#define MESHLET_STATISTICS  1
+#endif
+
+// The same layout as MeshletDesc in Meshlet.h
+struct MeshletDesc
+{
+    uint vertexOffset;
+    uint vertexCount;
+    uint primitiveOffset;
+    uint primitiveCount;
+    float4 boundingSphere;
+    uint normalCone;
+};
+
+struct CBMeshletCulling
+{
+    row_major float4x4 viewProjection;
+    float4 frustumPlanes[6];
+    float4 cameraPosition;
+    uint meshletCount;
+    uint instanceCount;
+};
+
+struct CBMeshletCullingPass
+{
+    uint cullingEnabled;
+    uint counterBase;
+};
+
+struct MeshletPayload
+{
+    uint meshletIDs[MESHLET_CULLING_GROUP_SIZE];
+};
+
+struct MeshletVertex
+{
+    float4 position : SV_Position;
+    float4 color : COLOR;
+};
+
+ConstantBuffer<CBMeshletCulling> cbCulling : register(b0, space0);
+ConstantBuffer<CBMeshletCullingPass> cbPass : register(b1, space0);
+
+StructuredBuffer<MeshletDesc> meshlets : register(t0, space0);
+StructuredBuffer<uint> vertexIndices : register(t1, space0);
+StructuredBuffer<uint> primitives : register(t2, space0);      // i0 | i1 << 8 | i2 << 16
+StructuredBuffer<float3> positions : register(t3, space0);
+StructuredBuffer<float4> instances : register(t4, space0);
+
+// [counterBase + 3]: rendered triangles
+RWStructuredBuffer<uint> counters : register(u0, space0);
+
+// A distinct color for every meshlet
+float3 GetMeshletColor(uint meshletIndex)
+{
+    const uint hash = meshletIndex * 2654435761U;
+    return float3(hash & 0xffU, (hash >> 8) & 0xffU, (hash >> 16) & 0xffU) * (0.7f / 255.0f) + 0.3f;
+}
+
+[outputtopology("triangle")]
+[numthreads(128, 1, 1)]
+void MeshMain(in uint groupID : SV_GroupID, in uint localTID : SV_GroupThreadID, in payload MeshletPayload inPayload,
+            out vertices MeshletVertex outVertices[MESHLET_MAX_VERTEX_COUNT], out indices uint3 outPrimIndices[MESHLET_MAX_PRIMITIVE_COUNT])
+{
+    const uint meshletID = inPayload.meshletIDs[groupID];
+    const uint meshletIndex = meshletID % cbCulling.meshletCount;
+    const MeshletDesc meshlet = meshlets[meshletIndex];
+    const float4 instance = instances[meshletID / cbCulling.meshletCount];
+
+    SetMeshOutputCounts(meshlet.vertexCount, meshlet.primitiveCount);
+
+    if (localTID < meshlet.vertexCount)
+    {
+        const float3 position = positions[vertexIndices[meshlet.vertexOffset + localTID]] * instance.w + instance.xyz;
+        outVertices[localTID].position = mul(float4(position, 1.0f), cbCulling.viewProjection);
+        outVertices[localTID].color = float4(GetMeshletColor(meshletIndex), 1.0f);
+    }
+
+    if (localTID < meshlet.primitiveCount)
+    {
+        const uint primitive = primitives[meshlet.primitiveOffset + localTID];
+        outPrimIndices[localTID] = uint3(primitive & 0xffU, (primitive >> 8) & 0xffU, (primitive >> 16) & 0xffU);
+    }
+
+#if MESHLET_STATISTICS
+    if (localTID == 0) {
+        InterlockedAdd(counters[cbPass.counterBase + 3], meshlet.primitiveCount);
+    }
+#endif
+}
@@ -0,0 +1,125 @@
+// Tests each meshlet of each instance against the view frustum and its normal cone against the view direction,
+// compacts the surviving meshlet IDs into a 128-byte payload and launches one mesh shader group per survivor.
+
+// Must be the same as MESHLET_CULLING_GROUP_SIZE in MeshShaderTest.cpp
+#define MESHLET_CULLING_GROUP_SIZE  32
+
+// 0 compiles the statistics counters out, for the timed passes (see the *_nostats wrappers)
+#ifndef MESHLET_STATISTICS
+#define MESHLET_STATISTICS  1
+#endif
+
+// The same layout as MeshletDesc in Meshlet.h
+struct MeshletDesc
+{
+    uint vertexOffset;
+    uint vertexCount;
+    uint primitiveOffset;
+    uint primitiveCount;
+    float4 boundingSphere;      // center xyz, radius
+    uint normalCone;            // snorm8 x 4: axis xyz, cutoff
+};
+
+struct CBMeshletCulling
+{
+    row_major float4x4 viewProjection;
+    float4 frustumPlanes[6];    // inward normals: dot(plane.xyz, p) + plane.w >= 0 inside
+    float4 cameraPosition;
+    uint meshletCount;          // meshlets per instance
+    uint instanceCount;
+};
+
+struct CBMeshletCullingPass
+{
+    uint cullingEnabled;
+    uint counterBase;
+};
+
+struct MeshletPayload
+{
+    uint meshletIDs[MESHLET_CULLING_GROUP_SIZE];    // instanceIndex * meshletCount + meshletIndex
+};
+
+ConstantBuffer<CBMeshletCulling> cbCulling : register(b0, space0);
+ConstantBuffer<CBMeshletCullingPass> cbPass : register(b1, space0);
+
+StructuredBuffer<MeshletDesc> meshlets : register(t0, space0);
+StructuredBuffer<float4> instances : register(t4, space0);     // xyz: translation, w: uniform scale
+
+// [counterBase + 0]: visible meshlets, [counterBase + 1]: frustum culled, [counterBase + 2]: back-face culled
+RWStructuredBuffer<uint> counters : register(u0, space0);
+
+groupshared MeshletPayload sharedPayload;
+groupshared uint sharedVisibleCount;
+
+// @return the normalized axis and the cutoff
+float4 DecodeNormalCone(uint normalCone)
+{
+    const int4 values = int4(normalCone << 24, normalCone << 16, normalCone << 8, normalCone) >> 24;
+    const float4 cone = max(float4(values) / 127.0f, -1.0f);
+    return float4(cone.w < 1.0f ? normalize(cone.xyz) : cone.xyz, cone.w);
+}
+
+[numthreads(MESHLET_CULLING_GROUP_SIZE, 1, 1)]
+void AmplificationMain(in uint globalTID : SV_DispatchThreadID, in uint localTID : SV_GroupThreadID)
+{
+    if (localTID == 0) {
+        sharedVisibleCount = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint meshletCount = cbCulling.meshletCount;
+    const bool valid = globalTID < meshletCount * cbCulling.instanceCount;
+
+    bool insideFrustum = valid;
+    bool frontFacing = valid;
+    if (valid && cbPass.cullingEnabled != 0)
+    {
+        const MeshletDesc meshlet = meshlets[globalTID % meshletCount];
+        const float4 instance = instances[globalTID / meshletCount];
+        const float3 center = meshlet.boundingSphere.xyz * instance.w + instance.xyz;
+        const float radius = meshlet.boundingSphere.w * instance.w;
+
+        for (uint i = 0; i < 6; ++i) {
+            insideFrustum = insideFrustum && dot(cbCulling.frustumPlanes[i].xyz, center) + cbCulling.frustumPlanes[i].w >= -radius;
+        }
+
+        // Every triangle of the meshlet faces away from the camera when the view direction lies inside the back-facing cone
+        const float4 cone = DecodeNormalCone(meshlet.normalCone);
+        if (insideFrustum && cone.w < 1.0f)
+        {
+            const float3 viewDirection = center - cbCulling.cameraPosition.xyz;
+            frontFacing = dot(viewDirection, cone.xyz) < cone.w * length(viewDirection) + radius;
+        }
+    }
+
+    const bool visible = insideFrustum && frontFacing;
+
+    // Compact the visible meshlet IDs: one groupshared atomic per wave, so it works for any wave size
+    const uint waveVisibleCount = WaveActiveCountBits(visible);
+    uint waveOffset = 0;
+    if (WaveIsFirstLane()) {
+        InterlockedAdd(sharedVisibleCount, waveVisibleCount, waveOffset);
+    }
+    waveOffset = WaveReadLaneFirst(waveOffset);
+
+    if (visible) {
+        sharedPayload.meshletIDs[waveOffset + WavePrefixCountBits(visible)] = globalTID;
+    }
+
+#if MESHLET_STATISTICS
+    // Statistics: one device atomic per wave and counter
+    const uint waveFrustumCulledCount = WaveActiveCountBits(valid && !insideFrustum);
+    const uint waveBackFaceCulledCount = WaveActiveCountBits(insideFrustum && !frontFacing);
+    if (WaveIsFirstLane())
+    {
+        InterlockedAdd(counters[cbPass.counterBase + 0], waveVisibleCount);
+        InterlockedAdd(counters[cbPass.counterBase + 1], waveFrustumCulledCount);
+        InterlockedAdd(counters[cbPass.counterBase + 2], waveBackFaceCulledCount);
+    }
+#endif
+
+    GroupMemoryBarrierWithGroupSync();
+
+    DispatchMesh(sharedVisibleCount, 1, 1, sharedPayload);
+}
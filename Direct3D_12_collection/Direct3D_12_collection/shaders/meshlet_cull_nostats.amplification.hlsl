@@ -0,0 +1,4 @@
+// meshlet_cull.amplification.hlsl without the statistics counters, for the timed passes
+
+#define MESHLET_STATISTICS  0
+#include "meshlet_cull.amplification.hlsl"
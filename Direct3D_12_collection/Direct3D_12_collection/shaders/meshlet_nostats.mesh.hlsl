@@ -0,0 +1,4 @@
+// meshlet.mesh.hlsl without the statistics counters, for the timed passes
+
+#define MESHLET_STATISTICS  0
+#include "meshlet.mesh.hlsl"
@@ -0,0 +1,26 @@
+// Per-object vertex shader of the multi-draw indirect benchmark.
+// The object constants are set per command, either by the CONSTANT argument of the command signature or by SetGraphicsRoot32BitConstants.
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+};
+
+struct CBObject
+{
+    float2 offset;
+    float scale;
+    uint color;         // RGBA8
+};
+
+ConstantBuffer<CBObject> cbObject : register(b0, space0);
+
+PSInput VSMain(float2 position : POSITION)
+{
+    PSInput result;
+    result.position = float4(position * cbObject.scale + cbObject.offset, 0.5f, 1.0f);
+    result.color = float4(cbObject.color & 0xffU, (cbObject.color >> 8) & 0xffU, (cbObject.color >> 16) & 0xffU, cbObject.color >> 24) / 255.0f;
+
+    return result;
+}
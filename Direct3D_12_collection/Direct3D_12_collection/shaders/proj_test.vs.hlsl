@@ -38,62 +38,20 @@ struct PSInput
 };
 
 // Old declaration
-// cbuffer CBTranslations : register(b0)
+// cbuffer CBTransform : register(b0)
 // In Shader Model 5.1, we can use
-struct CBTranslations
+struct CBTransform
 {
-    float rotAngle;
-    float xOffset;
-    float yOffset;
-    float zOffset;
-    
-    int paddings[64 - 4];
+    // rotate * translate * projection, computed by ProjectionTest.cpp once per frame
+    row_major float4x4 mvpMatrix;
 };
 
-ConstantBuffer<CBTranslations> cbTranslations : register(b0, space0);
+ConstantBuffer<CBTransform> cbTransform : register(b0, space0);
 
-// vertexIndex is a system-value input parameter and
-// shadingRate is a system-value output parameter
 PSInput VSMain(float4 position : POSITION, float4 color : COLOR)
 {
-    // glTranslate(xOffset, yOffset, zOffset, 1.0)
-    const float4x4 translateMatrix = {
-        1.0f, 0.0f, 0.0f, 0.0f,                                                         // row 0
-        0.0f, 1.0f, 0.0f, 0.0f,                                                         // row 1
-        0.0f, 0.0f, 1.0f, 0.0f,                                                         // row 2
-        cbTranslations.xOffset, cbTranslations.yOffset, cbTranslations.zOffset, 1.0f    // row 3
-    };
-
-#if 0
-    // glOrtho(-1.0, 1.0, -1.0, 1.0, 1.0, 9.0)
-    const float4x4 projectionMatrix = {
-        1.0f, 0.0f, 0.0f, 0.0f,         // row 0
-        0.0f, 1.0f, 0.0f, 0.0f,         // row 1
-        0.0f, 0.0f, -0.25f, 0.0f,       // row 2
-        0.0f, 0.0f, -1.25f, 1.0f        // row 3
-    };
-#else
-    // glFrustum(-1.0, 1.0, -1.0, 1.0, 1.0, 9.0)
-    const float4x4 projectionMatrix = {
-        1.0f, 0.0f, 0.0f, 0.0f,         // row 0
-        0.0f, 1.0f, 0.0f, 0.0f,         // row 1
-        0.0f, 0.0f, -1.25f, -1.0f,      // row 2
-        0.0f, 0.0f, -2.25f, 0.0f        // row 3
-    };
-#endif
-
-    const float rotRadian = radians(cbTranslations.rotAngle);
-
-    // glRotate(radian, 1.0, 0.0, 0.0)
-    const float4x4 rotateMatrix = {
-        1.0f, 0.0f, 0.0f, 0.0f,
-        0.0f, cos(rotRadian), sin(rotRadian), 0.0f,
-        0.0f, -sin(rotRadian), cos(rotRadian), 0.0f,
-        0.0f, 0.0f, 0.0f, 1.0f
-    };
-
     PSInput result;
-    result.position = mul(position, mul(rotateMatrix, mul(translateMatrix, projectionMatrix)));
+    result.position = mul(position, cbTransform.mvpMatrix);
     result.color = color;
 
     return result;
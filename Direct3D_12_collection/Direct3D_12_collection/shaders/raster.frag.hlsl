@@ -8,6 +8,10 @@ struct PSInput
     //sample float4 color : COLOR;
 };
 
+// uavOutput[0] is the total invocation count. The per-pixel invocation counts of the 64x64 render target start from PER_PIXEL_COUNT_OFFSET.
+#define PER_PIXEL_COUNT_OFFSET                  16U
+#define RENDER_TARGET_WIDTH                     64U
+
 //RWBuffer<uint> uavOutput : register(u0, space0);
 // Intel HD Graphics and Iris Pro Graphics DO NOT support RWBuffer.
 RWStructuredBuffer<uint> uavOutput : register(u0, space0);
@@ -23,6 +27,9 @@ float4 PSMain(PSInput input //, out float outDepth : SV_Depth,
 
     InterlockedAdd(uavOutput[0], 1U);
 
+    const uint2 pixelCoord = uint2(input.position.xy);
+    InterlockedAdd(uavOutput[PER_PIXEL_COUNT_OFFSET + pixelCoord.y * RENDER_TARGET_WIDTH + pixelCoord.x], 1U);
+
 #if ENABLE_SAMPLE_INTERPOLATION
     switch (sampleIndex)
     {
@@ -0,0 +1,25 @@
+// Converts the filled size counter of a stream output buffer into the D3D12_DRAW_ARGUMENTS of the pass that
+// draws the buffer again, the equivalent of DrawAuto() in Direct3D 11.
+
+// The same layout as StreamOutputDrawAutoConstants in TransformFeedbackTest.cpp
+struct CBDrawAuto
+{
+    uint vertexStride;
+    uint argumentOffset;    // byte offset of the D3D12_DRAW_ARGUMENTS in uavDrawArguments
+};
+
+ConstantBuffer<CBDrawAuto> cbDrawAuto : register(b0, space0);
+
+// BufferFilledSizeLocation of the stream output buffer
+ByteAddressBuffer filledSize : register(t0, space0);
+
+RWByteAddressBuffer uavDrawArguments : register(u0, space0);
+
+[numthreads(1, 1, 1)]
+void CSMain()
+{
+    const uint vertexCount = filledSize.Load(0) / cbDrawAuto.vertexStride;
+
+    // VertexCountPerInstance, InstanceCount, StartVertexLocation, StartInstanceLocation
+    uavDrawArguments.Store4(cbDrawAuto.argumentOffset, uint4(vertexCount, 1, 0, 0));
+}
@@ -0,0 +1,65 @@
+// Keeps the live particles of the stream output particle simulation, drops the expired ones,
+// and lets every emitter spawn one new particle per frame.
+
+#define PARTICLE_EMITTER_FLAG   0x80000000U
+
+// The same layout as StreamOutputParticle in TransformFeedbackTest.cpp (32 bytes)
+struct Particle
+{
+    float4 position : POSITION;     // xyz, w: age in seconds
+    float3 velocity : VELOCITY;
+    uint seed : SEED;               // PARTICLE_EMITTER_FLAG is set for emitters
+};
+
+// The same layout as StreamOutputParticleConstants in TransformFeedbackTest.cpp
+struct CBParticle
+{
+    uint frameIndex;
+    float deltaTime;
+    float lifetime;
+    float gravity;
+};
+
+ConstantBuffer<CBParticle> cbParticle : register(b0, space0);
+
+// PCG hash
+uint Hash(uint value)
+{
+    const uint state = value * 747796405U + 2891336453U;
+    const uint word = ((state >> ((state >> 28U) + 4U)) ^ state) * 277803737U;
+    return (word >> 22U) ^ word;
+}
+
+// [0, 1)
+float Random(inout uint seed)
+{
+    seed = Hash(seed);
+    return float(seed >> 8U) * (1.0f / 16777216.0f);
+}
+
+[maxvertexcount(2)]
+void GSMain(in point Particle gsIn[1], inout PointStream<Particle> gsOutStream)
+{
+    const Particle particle = gsIn[0];
+
+    if ((particle.seed & PARTICLE_EMITTER_FLAG) == 0U)
+    {
+        if (particle.position.w < cbParticle.lifetime) {
+            gsOutStream.Append(particle);
+        }
+        return;
+    }
+
+    // Emitters live forever
+    gsOutStream.Append(particle);
+
+    uint seed = particle.seed ^ (cbParticle.frameIndex * 0x9E3779B9U);
+
+    Particle spawned;
+    spawned.position = float4(particle.position.xyz, 0.0f);
+    spawned.velocity.x = Random(seed) * 0.5f - 0.25f;
+    spawned.velocity.y = Random(seed) * 1.5f + 1.0f;
+    spawned.velocity.z = Random(seed) * 0.5f - 0.25f;
+    spawned.seed = seed & ~PARTICLE_EMITTER_FLAG;
+    gsOutStream.Append(spawned);
+}
@@ -0,0 +1,42 @@
+// Integrates one particle of the stream output particle simulation.
+// Emitters only pass through; so_particles.gs.hlsl spawns and kills the particles.
+
+#define PARTICLE_EMITTER_FLAG   0x80000000U
+
+// The same layout as StreamOutputParticle in TransformFeedbackTest.cpp (32 bytes)
+struct Particle
+{
+    float4 position : POSITION;     // xyz, w: age in seconds
+    float3 velocity : VELOCITY;
+    uint seed : SEED;               // PARTICLE_EMITTER_FLAG is set for emitters
+};
+
+// The same layout as StreamOutputParticleConstants in TransformFeedbackTest.cpp
+struct CBParticle
+{
+    uint frameIndex;
+    float deltaTime;
+    float lifetime;
+    float gravity;
+};
+
+ConstantBuffer<CBParticle> cbParticle : register(b0, space0);
+
+Particle VSMain(Particle input)
+{
+    Particle output = input;
+    if ((input.seed & PARTICLE_EMITTER_FLAG) != 0U) return output;
+
+    output.velocity.y -= cbParticle.gravity * cbParticle.deltaTime;
+    output.position.xyz += output.velocity * cbParticle.deltaTime;
+    output.position.w += cbParticle.deltaTime;
+
+    // Bounce on the ground plane
+    if (output.position.y < -1.0f)
+    {
+        output.position.y = -1.0f;
+        output.velocity.y *= -0.5f;
+    }
+
+    return output;
+}
@@ -0,0 +1,22 @@
+// Streams the vertices captured by a previous stream output pass out again,
+// so stream output passes can be chained on the GPU timeline.
+
+struct VSInput
+{
+    float4 position : POSITION;
+    float4 color : COLOR;
+};
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+};
+
+PSInput VSMain(VSInput input)
+{
+    PSInput result;
+    result.position = input.position;
+    result.color = input.color;
+    return result;
+}
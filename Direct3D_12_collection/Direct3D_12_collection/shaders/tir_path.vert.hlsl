@@ -0,0 +1,29 @@
+// Shared by all passes of the path rendering in TargetIndependentTest.cpp.
+// Path vertices are in pixels with the origin at the top-left corner of the render target.
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+};
+
+struct CBPathRendering
+{
+    uint targetWidth;
+    uint targetHeight;
+    uint sampleCount;
+    uint fillRule;      // 0: non-zero, 1: even-odd
+};
+
+ConstantBuffer<CBPathRendering> cbPathRendering : register(b0, space0);
+
+PSInput VSMain(float2 position : POSITION, float4 color : COLOR)
+{
+    const float2 ndc = position / float2(cbPathRendering.targetWidth, cbPathRendering.targetHeight) * float2(2.0f, -2.0f) + float2(-1.0f, 1.0f);
+
+    PSInput result;
+    result.position = float4(ndc, 0.0f, 1.0f);
+    result.color = color;
+
+    return result;
+}
@@ -0,0 +1,13 @@
+// Cover pass of the MSAA stencil-then-cover baseline. The stencil test selects the covered samples.
+// The output is premultiplied by alpha.
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+};
+
+float4 PSMain(PSInput input) : SV_TARGET
+{
+    return float4(input.color.rgb * input.color.a, input.color.a);
+}
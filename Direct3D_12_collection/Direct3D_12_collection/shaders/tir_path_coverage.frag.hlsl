@@ -0,0 +1,45 @@
+// Coverage pass of the path rendering: UAV-only rendering with a forced sample count and no render target.
+// Every fan triangle adds its facing as the winding sign to each covered sample.
+// Non-zero: one signed winding counter per sample. Even-odd: one coverage mask per pixel toggled by XOR.
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+};
+
+struct CBPathRendering
+{
+    uint targetWidth;
+    uint targetHeight;
+    uint sampleCount;
+    uint fillRule;      // 0: non-zero, 1: even-odd
+};
+
+ConstantBuffer<CBPathRendering> cbPathRendering : register(b0, space0);
+
+// Intel HD Graphics and Iris Pro Graphics DO NOT support RWBuffer.
+RWStructuredBuffer<uint> coverageBuffer : register(u0, space0);
+
+void PSMain(PSInput input, in uint inputCoverage : SV_Coverage, in bool isFrontFace : SV_IsFrontFace)
+{
+    const uint2 pixel = uint2(input.position.xy);
+    const uint pixelIndex = pixel.y * cbPathRendering.targetWidth + pixel.x;
+
+    if (cbPathRendering.fillRule != 0U)
+    {
+        InterlockedXor(coverageBuffer[pixelIndex], inputCoverage);
+        return;
+    }
+
+    const uint baseIndex = pixelIndex * cbPathRendering.sampleCount;
+    const uint winding = isFrontFace ? 1U : 0xffffffffU;
+
+    uint mask = inputCoverage;
+    while (mask != 0U)
+    {
+        const uint sampleIndex = firstbitlow(mask);
+        mask &= mask - 1U;
+        InterlockedAdd(coverageBuffer[baseIndex + sampleIndex], winding);
+    }
+}
@@ -0,0 +1,52 @@
+// Cover pass of the path rendering: draws the bounding rectangle of each path, converts the winding numbers
+// of the pixel's samples to the anti-aliased coverage, and clears them for the next batch.
+// The output is premultiplied by alpha.
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+};
+
+struct CBPathRendering
+{
+    uint targetWidth;
+    uint targetHeight;
+    uint sampleCount;
+    uint fillRule;      // 0: non-zero, 1: even-odd
+};
+
+ConstantBuffer<CBPathRendering> cbPathRendering : register(b0, space0);
+
+// Intel HD Graphics and Iris Pro Graphics DO NOT support RWBuffer.
+RWStructuredBuffer<uint> coverageBuffer : register(u0, space0);
+
+float4 PSMain(PSInput input) : SV_TARGET
+{
+    const uint2 pixel = uint2(input.position.xy);
+    const uint pixelIndex = pixel.y * cbPathRendering.targetWidth + pixel.x;
+
+    uint coveredSampleCount = 0U;
+    if (cbPathRendering.fillRule != 0U)
+    {
+        coveredSampleCount = countbits(coverageBuffer[pixelIndex]);
+        coverageBuffer[pixelIndex] = 0U;
+    }
+    else
+    {
+        const uint baseIndex = pixelIndex * cbPathRendering.sampleCount;
+        for (uint sampleIndex = 0U; sampleIndex < cbPathRendering.sampleCount; ++sampleIndex)
+        {
+            if (coverageBuffer[baseIndex + sampleIndex] != 0U)
+            {
+                ++coveredSampleCount;
+                coverageBuffer[baseIndex + sampleIndex] = 0U;
+            }
+        }
+    }
+
+    if (coveredSampleCount == 0U) discard;
+
+    const float alpha = input.color.a * float(coveredSampleCount) / float(cbPathRendering.sampleCount);
+    return float4(input.color.rgb * alpha, alpha);
+}